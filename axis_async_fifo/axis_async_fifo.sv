@@ -0,0 +1,56 @@
+`default_nettype none
+
+// AXI4-Stream wrapper of util/async_fifo for the block design.
+// Carries tuser and tlast with tdata. Inputs left unconnected in the block design are tied to 0.
+module axis_async_fifo #(
+    parameter int TDATA_BITS = 8,
+    parameter int DEPTH_BITS = 5,
+    parameter int SYNC_STAGES = 2,                  // Flip-flops of the pointer synchronizers (2 or more)
+    parameter string RAM_STYLE = "distributed",     // "distributed" or "block"
+    parameter int ALMOST_FULL_LEVEL = 2**DEPTH_BITS - 1
+) (
+    input wire s_clock,
+    input wire s_aresetn,
+
+    input  wire [TDATA_BITS-1:0] saxis_tdata,
+    input  wire                  saxis_tvalid,
+    output wire                  saxis_tready,
+    input  wire                  saxis_tuser,
+    input  wire                  saxis_tlast,
+
+    output wire [DEPTH_BITS:0]   s_level,
+    output wire                  almost_full,       // s_clock domain
+
+    input wire m_clock,
+    input wire m_aresetn,
+
+    output wire [TDATA_BITS-1:0] maxis_tdata,
+    output wire                  maxis_tvalid,
+    input  wire                  maxis_tready,
+    output wire                  maxis_tuser,
+    output wire                  maxis_tlast
+);
+
+async_fifo #(
+    .DATA_BITS(TDATA_BITS + 2),
+    .DEPTH_BITS(DEPTH_BITS),
+    .SYNC_STAGES(SYNC_STAGES),
+    .RAM_STYLE(RAM_STYLE),
+    .ALMOST_FULL_LEVEL(ALMOST_FULL_LEVEL)
+) async_fifo_inst (
+    .s_clock(s_clock),
+    .s_aresetn(s_aresetn),
+    .saxis_tdata({saxis_tuser, saxis_tlast, saxis_tdata}),
+    .saxis_tvalid(saxis_tvalid),
+    .saxis_tready(saxis_tready),
+    .s_level(s_level),
+    .almost_full(almost_full),
+    .m_clock(m_clock),
+    .m_aresetn(m_aresetn),
+    .maxis_tdata({maxis_tuser, maxis_tlast, maxis_tdata}),
+    .maxis_tvalid(maxis_tvalid),
+    .maxis_tready(maxis_tready));
+
+endmodule
+
+`default_nettype wire
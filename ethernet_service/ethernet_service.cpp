@@ -11,17 +11,32 @@ static int compare_array(const std::array<Element, N>& lhs, const std::array<Ele
 		if( l < r ) {
 			return -1;
 		}
-		else if( r > l ) {
+		else if( l > r ) {
 			return 1;
 		}
 	}
 	return 0;
 }
 
+// 802.1Q/802.1ad tags in the order they appear in the frame.
+struct VLANTags
+{
+	static constexpr const std::size_t MAX_TAGS = 2;
+	std::uint8_t count;
+	std::array<std::uint16_t, MAX_TAGS> tpid;
+	std::array<std::uint16_t, MAX_TAGS> tci;
+
+	VLANTags() : count(0) {}
+	std::size_t length() const { return this->count * 4; }
+	std::uint16_t vlan_id(std::size_t index) const { return this->tci[index] & 0x0fff; }
+	std::uint16_t inner_vlan_id() const { return this->vlan_id(this->count - 1); }
+};
+
 struct EthernetHeader
 {
 	HardwareAddress destination;
 	HardwareAddress source;
+	VLANTags vlan;
 	std::uint16_t protocol;
 };
 
@@ -39,11 +54,11 @@ static inline void write16be(Array& a, std::size_t offset, std::uint16_t value)
 }
 
 template<typename Array>
-static inline std::uint16_t read32be(const Array& a, std::size_t offset) {
-	return (a[offset + 0] << 24)  | (a[offset + 1] << 16)  | (a[offset + 2] << 8) | (a[offset + 3]);
+static inline std::uint32_t read32be(const Array& a, std::size_t offset) {
+	return (static_cast<std::uint32_t>(a[offset + 0]) << 24)  | (a[offset + 1] << 16)  | (a[offset + 2] << 8) | (a[offset + 3]);
 }
 template<typename Array>
-static inline void write32be(Array& a, std::size_t offset, std::uint16_t value) {
+static inline void write32be(Array& a, std::size_t offset, std::uint32_t value) {
 	a[offset + 0] = value >> 24;
 	a[offset + 1] = (value >> 16) & 0xff;
 	a[offset + 2] = (value >> 8) & 0xff;
@@ -83,6 +98,15 @@ template<typename Array>
 static inline void write_ipaddr(Array& a, std::size_t offset, const IPAddress& address) {
 	write_array(a, offset, address);
 }
+template<typename Array>
+static inline IPv6Address read_ipv6addr(const Array& a, std::size_t offset) {
+	IPv6Address address;
+	return read_array(a, offset, address);
+}
+template<typename Array>
+static inline void write_ipv6addr(Array& a, std::size_t offset, const IPv6Address& address) {
+	write_array(a, offset, address);
+}
 
 struct ARP
 {
@@ -119,7 +143,7 @@ static std::uint16_t calculate_internet_checksum(const std::array<std::uint8_t,
 		checksum += read16be(a, i*2);
 	}
 	if( (length & 1) != 0 ) {
-		checksum += static_cast<std::uint16_t>(a[length/2]) << 8;
+		checksum += static_cast<std::uint16_t>(a[length - 1]) << 8;
 	}
 	checksum = (checksum & 0xffff) + (checksum >> 16);
 	checksum = (checksum & 0xffff) + (checksum >> 16);
@@ -140,6 +164,20 @@ static std::uint16_t calculate_internet_checksum(const std::uint16_t* a, const s
 	return checksum & 0xffff;
 }
 
+static std::uint16_t calculate_pseudo_header_checksum(const IPAddress& source, const IPAddress& destination, std::uint8_t protocol, std::uint16_t length)
+{
+	std::uint32_t checksum = 0;
+	checksum += read16be(source, 0);
+	checksum += read16be(source, 2);
+	checksum += read16be(destination, 0);
+	checksum += read16be(destination, 2);
+	checksum += protocol;
+	checksum += length;
+	checksum = (checksum & 0xffff) + (checksum >> 16);
+	checksum = (checksum & 0xffff) + (checksum >> 16);
+	return checksum & 0xffff;
+}
+
 struct IPv4
 {
 	static constexpr const std::size_t SIZE = 20;
@@ -202,6 +240,140 @@ struct ICMP
 	}
 };
 
+struct TCP
+{
+	static constexpr const std::size_t SIZE = 20;
+	static constexpr const std::size_t MAX_OPTIONS_SIZE = 40;
+	static constexpr const std::uint8_t FIN = 0x01;
+	static constexpr const std::uint8_t SYN = 0x02;
+	static constexpr const std::uint8_t RST = 0x04;
+	static constexpr const std::uint8_t PSH = 0x08;
+	static constexpr const std::uint8_t ACK = 0x10;
+
+	std::array<std::uint8_t, SIZE> raw;
+	std::uint16_t source_port() const               { return read16be(this->raw, 0); }
+	std::uint16_t destination_port() const          { return read16be(this->raw, 2); }
+	std::uint32_t sequence_number() const           { return read32be(this->raw, 4); }
+	std::uint32_t acknowledgement_number() const    { return read32be(this->raw, 8); }
+	std::uint8_t data_offset() const                { return this->raw[12] >> 4; }
+	std::uint8_t flags() const                      { return this->raw[13]; }
+	std::uint16_t window() const                    { return read16be(this->raw, 14); }
+	std::uint16_t checksum() const                  { return read16be(this->raw, 16); }
+	std::uint16_t urgent_pointer() const            { return read16be(this->raw, 18); }
+
+	void source_port(std::uint16_t value)               { write16be(this->raw, 0, value); }
+	void destination_port(std::uint16_t value)          { write16be(this->raw, 2, value); }
+	void sequence_number(std::uint32_t value)           { write32be(this->raw, 4, value); }
+	void acknowledgement_number(std::uint32_t value)    { write32be(this->raw, 8, value); }
+	void data_offset(std::uint8_t value)                { this->raw[12] = value << 4; }
+	void flags(std::uint8_t value)                      { this->raw[13] = value; }
+	void window(std::uint16_t value)                    { write16be(this->raw, 14, value); }
+	void checksum(std::uint16_t value)                  { write16be(this->raw, 16, value); }
+	void urgent_pointer(std::uint16_t value)            { write16be(this->raw, 18, value); }
+
+	std::size_t header_length() const { return this->data_offset() * 4; }
+};
+
+struct UDP
+{
+	static constexpr const std::size_t SIZE = 8;
+	std::array<std::uint8_t, SIZE> raw;
+	std::uint16_t source_port() const       { return read16be(this->raw, 0); }
+	std::uint16_t destination_port() const  { return read16be(this->raw, 2); }
+	std::uint16_t length() const            { return read16be(this->raw, 4); }
+	std::uint16_t checksum() const          { return read16be(this->raw, 6); }
+
+	void source_port(std::uint16_t value)       { write16be(this->raw, 0, value); }
+	void destination_port(std::uint16_t value)  { write16be(this->raw, 2, value); }
+	void length(std::uint16_t value)            { write16be(this->raw, 4, value); }
+	void checksum(std::uint16_t value)          { write16be(this->raw, 6, value); }
+};
+
+struct NTP
+{
+	static constexpr const std::size_t SIZE = 48;
+	static constexpr const std::uint16_t PORT = 123;
+	static constexpr const std::uint8_t MODE_CLIENT = 3;
+	static constexpr const std::uint8_t MODE_SERVER = 4;
+	static constexpr const std::uint8_t LEAP_NONE = 0;
+	static constexpr const std::uint8_t LEAP_UNSYNCHRONIZED = 3;
+	static constexpr const std::uint8_t STRATUM_UNSYNCHRONIZED = 16;
+	static constexpr const std::size_t TRANSMIT_TIMESTAMP_OFFSET = 40;
+
+	std::array<std::uint8_t, SIZE> raw;
+	std::uint8_t leap() const               { return this->raw[0] >> 6; }
+	std::uint8_t version() const            { return (this->raw[0] >> 3) & 0x07; }
+	std::uint8_t mode() const               { return this->raw[0] & 0x07; }
+	std::uint8_t stratum() const            { return this->raw[1]; }
+	std::uint8_t poll() const               { return this->raw[2]; }
+	std::uint8_t precision() const          { return this->raw[3]; }
+	std::uint64_t transmit_timestamp() const { return (static_cast<std::uint64_t>(read32be(this->raw, 40)) << 32) | read32be(this->raw, 44); }
+
+	void leap_version_mode(std::uint8_t leap, std::uint8_t version, std::uint8_t mode) { this->raw[0] = (leap << 6) | ((version & 0x07) << 3) | (mode & 0x07); }
+	void stratum(std::uint8_t value)            { this->raw[1] = value; }
+	void poll(std::uint8_t value)               { this->raw[2] = value; }
+	void precision(std::int8_t value)           { this->raw[3] = static_cast<std::uint8_t>(value); }
+	void root_delay(std::uint32_t value)        { write32be(this->raw, 4, value); }
+	void root_dispersion(std::uint32_t value)   { write32be(this->raw, 8, value); }
+	void reference_id(std::uint32_t value)      { write32be(this->raw, 12, value); }
+	void reference_timestamp(std::uint64_t value) { write_ntp_timestamp(16, value); }
+	void origin_timestamp(std::uint64_t value)  { write_ntp_timestamp(24, value); }
+	void receive_timestamp(std::uint64_t value) { write_ntp_timestamp(32, value); }
+	void transmit_timestamp(std::uint64_t value) { write_ntp_timestamp(TRANSMIT_TIMESTAMP_OFFSET, value); }
+
+private:
+	void write_ntp_timestamp(std::size_t offset, std::uint64_t value)
+	{
+		write32be(this->raw, offset, static_cast<std::uint32_t>(value >> 32));
+		write32be(this->raw, offset + 4, static_cast<std::uint32_t>(value));
+	}
+};
+
+static std::uint16_t calculate_ipv6_pseudo_header_checksum(const IPv6Address& source, const IPv6Address& destination, std::uint8_t next_header, std::uint32_t length)
+{
+	std::uint32_t checksum = 0;
+	for(std::size_t i = 0; i < 8; i++) {
+#pragma HLS UNROLL
+		checksum += read16be(source, i*2);
+		checksum += read16be(destination, i*2);
+	}
+	checksum += length >> 16;
+	checksum += length & 0xffff;
+	checksum += next_header;
+	checksum = (checksum & 0xffff) + (checksum >> 16);
+	checksum = (checksum & 0xffff) + (checksum >> 16);
+	return checksum & 0xffff;
+}
+
+struct IPv6
+{
+	static constexpr const std::size_t SIZE = 40;
+	static constexpr const std::uint8_t NEXT_HEADER_ICMPV6 = 58;
+	std::array<std::uint8_t, SIZE> raw;
+
+	std::uint8_t version() const            { return this->raw[0] >> 4; }
+	std::uint16_t payload_length() const    { return read16be(this->raw, 4); }
+	std::uint8_t next_header() const        { return this->raw[6]; }
+	std::uint8_t hop_limit() const          { return this->raw[7]; }
+	IPv6Address source() const              { return read_ipv6addr(this->raw, 8); }
+	IPv6Address destination() const         { return read_ipv6addr(this->raw, 24); }
+
+	void payload_length(std::uint16_t value)        { write16be(this->raw, 4, value); }
+	void next_header(std::uint8_t value)            { this->raw[6] = value; }
+	void hop_limit(std::uint8_t value)              { this->raw[7] = value; }
+	void source(const IPv6Address& value)           { write_ipv6addr(this->raw, 8, value); }
+	void destination(const IPv6Address& value)      { write_ipv6addr(this->raw, 24, value); }
+};
+
+struct ICMPv6
+{
+	static constexpr const std::size_t SIZE = 8;
+	static constexpr const std::uint8_t ECHO_REQUEST = 128;
+	static constexpr const std::uint8_t ECHO_REPLY = 129;
+	static constexpr const std::uint8_t NEIGHBOR_SOLICITATION = 135;
+	static constexpr const std::uint8_t NEIGHBOR_ADVERTISEMENT = 136;
+};
+
 
 enum class ReadExactResult
 {
@@ -258,6 +430,21 @@ static optional<EthernetHeader> read_header(hls::stream<mac_data_axis>& in)
 	std::array<std::uint8_t, 2> protocol;
 	if( read_exact(in, protocol) != ReadExactResult::Remaining ) return {};
 	header.protocol = (protocol[0] << 8) | protocol[1];
+
+	// VLAN tags (802.1Q C-tag: 0x8100, 802.1ad S-tag: 0x88a8)
+	// A priority tag (VLAN ID 0) does not select a VLAN, so it is not kept and the frame is handled as if it had no such tag.
+	for(std::size_t i = 0; i < VLANTags::MAX_TAGS; i++) {
+		if( header.protocol != 0x8100 && header.protocol != 0x88a8 ) break;
+		std::array<std::uint8_t, 4> tag;
+		if( read_exact(in, tag) != ReadExactResult::Remaining ) return {};
+		std::uint16_t tci = read16be(tag, 0);
+		if( (tci & 0x0fff) != 0 ) {
+			header.vlan.tpid[header.vlan.count] = header.protocol;
+			header.vlan.tci[header.vlan.count] = tci;
+			header.vlan.count++;
+		}
+		header.protocol = read16be(tag, 2);
+	}
 	
 	return header;
 }
@@ -284,18 +471,122 @@ static inline std::size_t read_payload(hls::stream<mac_data_axis>& in, std::uint
 	return 0;
 }
 
-static inline void ensure_frame_minimum_length(hls::stream<mac_data_axis>& out, std::size_t length)
+static inline void write_ethernet_header(hls::stream<mac_data_axis>& out, const EthernetServiceConfig& config, const VLANTags& vlan, const HardwareAddress& destination, std::uint16_t protocol)
 {
-	if( length < 64 ) {
-		std::size_t padding_count = 64 - length;
-		for(std::size_t i = 0; i < padding_count; i++) {
-#pragma HLS PIPELINE II=1
-			out.write(MACData(0, i == padding_count - 1)); // Fill zero to ensure frame length is at least 64 octets.
+	std::array<std::uint8_t, 2> protocol_raw;
+	write_all(out, destination, false);
+	write_all(out, config.get_hardware_address(), false);
+	// Tag the frame with the same tags as the request.
+	for(std::size_t i = 0; i < vlan.count; i++) {
+		std::array<std::uint8_t, 4> tag;
+		write16be(tag, 0, vlan.tpid[i]);
+		write16be(tag, 2, vlan.tci[i]);
+		write_all(out, tag, false);
+	}
+	write16be(protocol_raw, 0, protocol);
+	write_all(out, protocol_raw, false);
+}
+
+// ARP cache of the untagged network.
+// Entries are learned from ARP frames and IPv4 packets addressed to the service, and expire ARP_CACHE_TIMEOUT after the last update.
+// The entries are kept in registers, so transmit engines can look up the hardware address in one cycle.
+
+static constexpr const std::size_t ARP_CACHE_ENTRIES = 8;
+static constexpr const std::uint32_t ARP_CACHE_TIMEOUT = TIMER_HZ * 60;	// 60[s]
+
+struct ARPCacheEntry
+{
+	bool valid;
+	ap_uint<8*4> ip_address;
+	ap_uint<8*6> hardware_address;
+	std::uint32_t updated;		// Timer value when the entry was learned or refreshed.
+
+	ARPCacheEntry() : valid(false) {}
+};
+
+static ARPCacheEntry arp_cache[ARP_CACHE_ENTRIES];
+static std::uint8_t arp_cache_victim = 0;	// Entry replaced when the cache is full.
+
+static inline ap_uint<8*4> from_ip_address(const IPAddress& address)
+{
+	return (ap_uint<8*4>(address[0]) << 24) | (ap_uint<8*4>(address[1]) << 16) | (ap_uint<8*4>(address[2]) << 8) | ap_uint<8*4>(address[3]);
+}
+
+static inline ap_uint<8*6> from_hardware_address(const HardwareAddress& address)
+{
+	ap_uint<8*6> value = 0;
+	for(std::size_t i = 0; i < 6; i++) {
+#pragma HLS UNROLL
+		value = (value << 8) | ap_uint<8*6>(address[i]);
+	}
+	return value;
+}
+
+static optional<HardwareAddress> arp_cache_lookup(const IPAddress& ip_address)
+{
+#pragma HLS ARRAY_PARTITION variable=arp_cache complete
+	auto key = from_ip_address(ip_address);
+	ap_uint<8*6> hardware_address = 0;
+	bool found = false;
+	for(std::size_t i = 0; i < ARP_CACHE_ENTRIES; i++) {
+#pragma HLS UNROLL
+		if( arp_cache[i].valid && arp_cache[i].ip_address == key ) {
+			hardware_address = arp_cache[i].hardware_address;
+			found = true;
+		}
+	}
+	if( !found ) return {};
+	return to_hardware_address(hardware_address);
+}
+
+// Refresh the entry of ip_address. A new entry is created only if create is set, as RFC 826 does for ARP frames addressed to us.
+static void arp_cache_update(ap_uint<32> timer, const IPAddress& ip_address, const HardwareAddress& hardware_address, bool create)
+{
+#pragma HLS ARRAY_PARTITION variable=arp_cache complete
+	auto key = from_ip_address(ip_address);
+	if( key == 0 || (hardware_address[0] & 0x01) != 0 ) {
+		return;	// Probe or multicast sender.
+	}
+	bool found = false;
+	std::uint8_t free_index = ARP_CACHE_ENTRIES;
+	for(std::size_t i = 0; i < ARP_CACHE_ENTRIES; i++) {
+#pragma HLS UNROLL
+		if( arp_cache[i].valid && arp_cache[i].ip_address == key ) {
+			arp_cache[i].hardware_address = from_hardware_address(hardware_address);
+			arp_cache[i].updated = timer;
+			found = true;
+		}
+		if( !arp_cache[i].valid && free_index == ARP_CACHE_ENTRIES ) {
+			free_index = i;
+		}
+	}
+	if( found || !create ) {
+		return;
+	}
+	std::uint8_t index = free_index;
+	if( index == ARP_CACHE_ENTRIES ) {
+		index = arp_cache_victim;
+		arp_cache_victim = (arp_cache_victim + 1) % ARP_CACHE_ENTRIES;
+	}
+	arp_cache[index].valid = true;
+	arp_cache[index].ip_address = key;
+	arp_cache[index].hardware_address = from_hardware_address(hardware_address);
+	arp_cache[index].updated = timer;
+}
+
+// Must be called frequently enough so that the timer does not wrap around before the entries expire.
+static void arp_cache_age(ap_uint<32> timer)
+{
+#pragma HLS ARRAY_PARTITION variable=arp_cache complete
+	for(std::size_t i = 0; i < ARP_CACHE_ENTRIES; i++) {
+#pragma HLS UNROLL
+		if( arp_cache[i].valid && static_cast<std::uint32_t>(timer - arp_cache[i].updated) >= ARP_CACHE_TIMEOUT ) {
+			arp_cache[i].valid = false;
 		}
 	}
 }
 
-static void arp(const EthernetServiceConfig& config, const EthernetHeader& header, hls::stream<mac_data_axis>& in, hls::stream<mac_data_axis>& out)
+static void arp(const EthernetServiceConfig& config, ap_uint<32> timer, const EthernetHeader& header, hls::stream<mac_data_axis>& in, hls::stream<mac_data_axis>& out)
 {
 	ARP arp;
 	{
@@ -307,7 +598,11 @@ static void arp(const EthernetServiceConfig& config, const EthernetHeader& heade
 			return;
 		}
 	}
-	
+
+	if( header.vlan.count == 0 && arp.hardware_type() == 0x0001 && arp.protocol_type() == 0x0800 ) {
+		arp_cache_update(timer, arp.spa(), arp.sha(), compare_array(arp.tpa(), config.get_ip_address()) == 0);
+	}
+
 	if( arp.operation() != 0x0001 ) {
 		return;
 	}
@@ -320,36 +615,16 @@ static void arp(const EthernetServiceConfig& config, const EthernetHeader& heade
 	arp.spa(config.get_ip_address());
 
 	// Send Ethernet header
-	std::array<std::uint8_t, 2> protocol;
-	write_all(out, header.source, false);
-	write_all(out, config.get_hardware_address(), false);
-	write16be(protocol, 0, 0x0806);
-	write_all(out, protocol, false);
-	
-	// Send ARP payload
-	write_all(out, arp.raw, false);
+	write_ethernet_header(out, config, header.vlan, header.source, 0x0806);
 
-	std::size_t total_frame_length = (14 + ARP::SIZE + 4);	// Ethernet header + payload + FCS
-	ensure_frame_minimum_length(out, total_frame_length);
+	// Send ARP payload
+	write_all(out, arp.raw, true);
 }
 
 
 template<std::size_t MAX_PAYLOAD_LENGTH=1500>
-static void icmp_reply(const EthernetServiceConfig& config, const EthernetHeader& header, hls::stream<mac_data_axis>& in, hls::stream<mac_data_axis>& out)
+static void icmp_reply(const EthernetServiceConfig& config, const EthernetHeader& header, IPv4& ip, hls::stream<mac_data_axis>& in, hls::stream<mac_data_axis>& out)
 {
-	IPv4 ip;
-	{
-		auto result =  read_exact(in, ip.raw);
-		if( result != ReadExactResult::Remaining ) {
-			return;
-		}
-	}
-
-	if( compare_array(ip.destination(), config.get_ip_address()) != 0 || ip.protocol() != 0x01 ) {
-		consume_remaining(in);
-		return;
-	}
-
 	ICMP icmp;
 	std::array<std::uint16_t, MAX_PAYLOAD_LENGTH/2> payload;
 //#pragma HLS BIND_STORAGE variable=payload type=ram_2p
@@ -364,12 +639,12 @@ static void icmp_reply(const EthernetServiceConfig& config, const EthernetHeader
 		}
 	}
 	assert(payload_length <= MAX_PAYLOAD_LENGTH);
-	
+
 	// accept only ICMP echo request.
 	if( icmp.type() != 8 ) {
 		return;
 	}
-	
+
 	// Construct IP header.
 	ip.destination(ip.source());
 	ip.source(config.get_ip_address());
@@ -380,49 +655,1255 @@ static void icmp_reply(const EthernetServiceConfig& config, const EthernetHeader
 	icmp.fill_checksum(payload.data(), payload_length);
 
 	// Send Ethernet header
-	std::array<std::uint8_t, 2> protocol;
-	write_all(out, header.source, false);
-	write_all(out, config.get_hardware_address(), false);
-	write16be(protocol, 0, 0x0800);
-	write_all(out, protocol, false);
-	
+	write_ethernet_header(out, config, header.vlan, header.source, 0x0800);
+
 	// Send IP header
 	write_all(out, ip.raw, false);
 
 	// Send ICMP packet
-	write_all(out, icmp.raw, false);
+	write_all(out, icmp.raw, payload_length == 0);
 
 	// Send payload
-	std::size_t total_frame_length = (14 + (ip.length() - IPv4::SIZE) + 4);	// Ethernet header + payload + FCS
-	write_all(out, reinterpret_cast<std::uint8_t*>(payload.data()), total_frame_length >= 64, payload_length);
-	ensure_frame_minimum_length(out, total_frame_length);
+	write_all(out, reinterpret_cast<std::uint8_t*>(payload.data()), true, payload_length);
+}
+
+// TCP engine for a single passive connection.
+// Received in-order payload is stored in the RX buffer and streamed to tcp_rx from there (tlast marks the end of each segment),
+// bytes from tcp_tx are buffered until they are acknowledged by the peer.
+// The advertised window is the free space of the RX buffer, and a segment which does not fit is dropped,
+// so that a full tcp_rx never blocks the service.
+
+static constexpr const std::uint32_t TCP_TX_BUFFER_SIZE = 16384;	// Must be power of 2.
+static constexpr const std::uint32_t TCP_RX_BUFFER_SIZE = 16384;	// Must be power of 2, and fit in the window field.
+static constexpr const std::uint16_t TCP_MSS = 1460;
+static constexpr const std::uint32_t TCP_RETRANSMIT_TIMEOUT = TIMER_HZ / 1000 * 200;	// 200[ms]
+static constexpr const std::uint8_t TCP_MAX_RETRANSMISSIONS = 8;
+
+enum class TCPState
+{
+	Listen,
+	SynReceived,
+	Established,
+	LastAck,
+};
+
+struct TCPEndpoint
+{
+	HardwareAddress hardware_address;
+	IPAddress ip_address;
+	std::uint16_t port;
+	VLANTags vlan;
+};
+
+struct TCPConnection
+{
+	TCPState state;
+	TCPEndpoint remote;
+	ap_uint<8*6> local_hardware_address;	// Identity which accepted the connection.
+	ap_uint<8*4> local_ip_address;
+	std::uint32_t rcv_nxt;		// Next sequence number expected from the peer.
+	std::uint32_t snd_una;		// Oldest unacknowledged sequence number.
+	std::uint32_t snd_nxt;		// Next sequence number to send.
+	std::uint32_t snd_end;		// Sequence number of the byte next to the last byte stored in the TX buffer.
+	std::uint16_t snd_wnd;		// Window advertised by the peer.
+	std::uint16_t snd_mss;		// MSS advertised by the peer.
+	std::uint32_t timer_start;
+	bool timer_running;
+	bool probe;					// Send at least 1 byte even if the peer window is closed.
+	std::uint8_t retransmissions;
+	std::uint32_t rcv_adv;		// Right edge of the window advertised to the peer.
+	std::uint32_t rx_begin;		// Index of the oldest byte in the RX buffer which is not sent to tcp_rx yet.
+	std::uint32_t rx_end;		// Index next to the last byte stored in the RX buffer.
+
+	TCPConnection() : state(TCPState::Listen), timer_running(false), probe(false), retransmissions(0), rx_begin(0), rx_end(0) {}
+};
+
+static TCPConnection tcp_connection;
+static std::array<std::uint8_t, TCP_TX_BUFFER_SIZE> tcp_tx_buffer;
+static std::array<std::uint8_t, TCP_RX_BUFFER_SIZE> tcp_rx_buffer;
+static std::array<bool, TCP_RX_BUFFER_SIZE> tcp_rx_buffer_last;
+static std::uint16_t ip_identification = 0;
+
+template<typename T>
+static inline bool tcp_seq_lt(T lhs, T rhs) { return static_cast<std::int32_t>(lhs - rhs) < 0; }
+template<typename T>
+static inline bool tcp_seq_le(T lhs, T rhs) { return static_cast<std::int32_t>(lhs - rhs) <= 0; }
+
+static inline std::uint16_t tcp_tx_buffer_checksum(std::uint16_t initial, std::uint32_t sequence_number, std::uint16_t length)
+{
+	std::uint32_t checksum = initial;
+	for(std::uint16_t i = 0; i < length; i++) {
+#pragma HLS PIPELINE II=1
+		std::uint8_t value = tcp_tx_buffer[(sequence_number + i) & (TCP_TX_BUFFER_SIZE - 1)];
+		checksum += (i & 1) == 0 ? static_cast<std::uint16_t>(value << 8) : value;
+	}
+	checksum = (checksum & 0xffff) + (checksum >> 16);
+	checksum = (checksum & 0xffff) + (checksum >> 16);
+	return checksum & 0xffff;
 }
 
-void ethernet_service(const EthernetServiceConfig& config, hls::stream<mac_data_axis>& in, hls::stream<mac_data_axis>& out)
+static inline std::uint16_t tcp_receive_window()
 {
-#pragma HLS interface ap_ctrl_none port=return
-#pragma HLS INTERFACE ap_stable register port=config
-#pragma HLS interface axis port=in
-#pragma HLS interface axis port=out
+	return TCP_RX_BUFFER_SIZE - (tcp_connection.rx_end - tcp_connection.rx_begin);
+}
 
-	auto header = read_header(in);
-	if( !header ) return;
+static void tcp_send_segment(const EthernetServiceConfig& config, hls::stream<mac_data_axis>& out, const TCPEndpoint& remote, std::uint8_t flags, std::uint32_t sequence_number, std::uint32_t acknowledgement_number, std::uint16_t payload_length)
+{
+	bool has_mss_option = (flags & TCP::SYN) != 0;
+	std::array<std::uint8_t, 4> mss_option = {0x02, 0x04, TCP_MSS >> 8, TCP_MSS & 0xff};
+	std::uint16_t tcp_length = TCP::SIZE + (has_mss_option ? 4 : 0) + payload_length;
 
-	// Check destination
-	if( compare_array(header.get().destination, config.get_hardware_address()) != 0 && compare_array(header.get().destination, HardwareAddress({0xff, 0xff, 0xff, 0xff, 0xff, 0xff})) != 0 ) {
-		consume_remaining(in);
+	IPv4 ip;
+	ip.version(0x45);
+	ip.type(0);
+	ip.length(IPv4::SIZE + tcp_length);
+	ip.identification(ip_identification++);
+	ip.flags_and_offset(0x4000);	// Don't fragment
+	ip.time_to_live(64);
+	ip.protocol(0x06);
+	ip.source(config.get_ip_address());
+	ip.destination(remote.ip_address);
+	ip.fill_checksum();
+
+	TCP tcp;
+	tcp.source_port(config.tcp_port);
+	tcp.destination_port(remote.port);
+	tcp.sequence_number(sequence_number);
+	tcp.acknowledgement_number(acknowledgement_number);
+	tcp.data_offset(has_mss_option ? 6 : 5);
+	tcp.flags(flags);
+	auto window = tcp_receive_window();
+	tcp.window(window);
+	tcp.checksum(0);
+	tcp.urgent_pointer(0);
+
+	auto checksum = calculate_pseudo_header_checksum(ip.source(), ip.destination(), 0x06, tcp_length);
+	checksum = calculate_internet_checksum(tcp.raw, checksum);
+	if( has_mss_option ) {
+		checksum = calculate_internet_checksum(mss_option, checksum);
+	}
+	checksum = tcp_tx_buffer_checksum(checksum, sequence_number, payload_length);
+	tcp.checksum(~checksum);
+	// Only RSTs are sent outside of the connection.
+	if( (flags & TCP::RST) == 0 ) {
+		tcp_connection.rcv_adv = acknowledgement_number + window;
+	}
+
+	write_ethernet_header(out, config, remote.vlan, remote.hardware_address, 0x0800);
+	write_all(out, ip.raw, false);
+	write_all(out, tcp.raw, !has_mss_option && payload_length == 0);
+	if( has_mss_option ) {
+		write_all(out, mss_option, payload_length == 0);
+	}
+
+	for(std::uint16_t i = 0; i < payload_length; i++) {
+#pragma HLS PIPELINE II=1
+		std::uint8_t value = tcp_tx_buffer[(sequence_number + i) & (TCP_TX_BUFFER_SIZE - 1)];
+		out.write(MACData(value, i == payload_length - 1));
+	}
+}
+
+static inline void tcp_send_ack(const EthernetServiceConfig& config, hls::stream<mac_data_axis>& out)
+{
+	auto& connection = tcp_connection;
+	tcp_send_segment(config, out, connection.remote, TCP::ACK, connection.snd_nxt, connection.rcv_nxt, 0);
+}
+
+static inline void tcp_restart_timer(ap_uint<32> timer)
+{
+	tcp_connection.timer_start = timer;
+	tcp_connection.timer_running = true;
+	tcp_connection.retransmissions = 0;
+}
+
+template<std::size_t MAX_PAYLOAD_LENGTH=TCP_MSS>
+static void tcp(const EthernetServiceConfig& config, ap_uint<32> timer, const EthernetHeader& header, const IPv4& ip, hls::stream<mac_data_axis>& in, hls::stream<mac_data_axis>& out)
+{
+	auto& connection = tcp_connection;
+
+	TCP tcp;
+	std::array<std::uint8_t, TCP::MAX_OPTIONS_SIZE> options;
+	std::array<std::uint8_t, MAX_PAYLOAD_LENGTH> payload;
+	std::size_t options_length = 0;
+	std::size_t payload_length = 0;
+	{
+		auto result = read_exact(in, tcp.raw);
+		if( result == ReadExactResult::NotEnough ) {
+			return;
+		}
+		if( result == ReadExactResult::Exact ) {
+			if( tcp.header_length() != TCP::SIZE ) return;
+		}
+		else {
+			options_length = tcp.header_length() > TCP::SIZE ? tcp.header_length() - TCP::SIZE : 0;
+			bool last = false;
+			for(std::size_t i = 0; i < options_length; i++) {
+#pragma HLS PIPELINE II=1
+				auto d = in.read();
+				options[i] = d.data;
+				last = d.last;
+				if( last ) {
+					// A segment without payload, like a SYN with options, ends with the options.
+					if( i + 1 < options_length ) return;
+					break;
+				}
+			}
+			if( !last ) {
+				payload_length = read_payload(in, payload.data(), MAX_PAYLOAD_LENGTH);
+			}
+		}
+	}
+	if( config.tcp_port == 0 || tcp.destination_port() != config.tcp_port || tcp.header_length() < TCP::SIZE ) {
+		return;
+	}
+	// The frame may contain padding after the IP packet.
+	std::size_t segment_length = ip.length() - IPv4::SIZE;
+	if( segment_length < tcp.header_length() || segment_length - tcp.header_length() > payload_length ) {
 		return;
 	}
+	payload_length = segment_length - tcp.header_length();
 
-	switch( header.get().protocol ) {
-	case 0x0800:	// IP
-		icmp_reply(config, header.get(), in, out);
-		break;
-	case 0x0806:	// ARP
-		arp(config, header.get(), in, out);
-		break;
-	default:
-		consume_remaining(in);
-		break;
+	// Verify checksum
+	{
+		auto checksum = calculate_pseudo_header_checksum(ip.source(), ip.destination(), 0x06, segment_length);
+		checksum = calculate_internet_checksum(tcp.raw, checksum);
+		checksum = calculate_internet_checksum(options, checksum, options_length);
+		checksum = calculate_internet_checksum(payload, checksum, payload_length);
+		if( checksum != 0xffff ) {
+			return;
+		}
+	}
+
+	TCPEndpoint remote;
+	remote.hardware_address = header.source;
+	remote.ip_address = ip.source();
+	remote.port = tcp.source_port();
+	remote.vlan = header.vlan;
+
+	auto flags = tcp.flags();
+	auto sequence_number = tcp.sequence_number();
+	auto acknowledgement_number = tcp.acknowledgement_number();
+
+	bool is_connection = connection.state != TCPState::Listen
+		&& connection.local_ip_address == config.ip_address
+		&& compare_array(remote.ip_address, connection.remote.ip_address) == 0
+		&& remote.port == connection.remote.port;
+
+	if( !is_connection ) {
+		if( (flags & TCP::RST) != 0 ) {
+			return;
+		}
+		if( connection.state == TCPState::Listen && (flags & (TCP::SYN | TCP::ACK)) == TCP::SYN ) {
+			// Passive open
+			std::uint32_t iss = timer;
+			connection.remote = remote;
+			connection.local_hardware_address = config.hardware_address;
+			connection.local_ip_address = config.ip_address;
+			connection.rcv_nxt = sequence_number + 1;
+			connection.snd_una = iss;
+			connection.snd_nxt = iss + 1;
+			connection.snd_end = iss + 1;
+			connection.snd_wnd = tcp.window();
+			connection.snd_mss = 536;
+			for(std::size_t i = 0; i + 3 < options_length; ) {
+				if( options[i] == 0 ) break;	// End of option list
+				if( options[i] == 1 ) { i++; continue; }	// No-Operation
+				if( options[i] == 2 && options[i + 1] == 4 ) {
+					connection.snd_mss = read16be(options, i + 2);
+				}
+				if( options[i + 1] < 2 ) break;
+				i += options[i + 1];
+			}
+			if( connection.snd_mss > TCP_MSS ) connection.snd_mss = TCP_MSS;
+			connection.state = TCPState::SynReceived;
+			tcp_send_segment(config, out, remote, TCP::SYN | TCP::ACK, iss, connection.rcv_nxt, 0);
+			tcp_restart_timer(timer);
+		}
+		else if( (flags & TCP::ACK) != 0 ) {
+			tcp_send_segment(config, out, remote, TCP::RST, acknowledgement_number, 0, 0);
+		}
+		else {
+			std::uint32_t length = payload_length + ((flags & TCP::SYN) != 0 ? 1 : 0) + ((flags & TCP::FIN) != 0 ? 1 : 0);
+			tcp_send_segment(config, out, remote, TCP::RST | TCP::ACK, 0, sequence_number + length, 0);
+		}
+		return;
+	}
+
+	if( (flags & TCP::RST) != 0 ) {
+		connection.state = TCPState::Listen;
+		connection.timer_running = false;
+		return;
+	}
+	if( (flags & TCP::SYN) != 0 ) {
+		// Our SYN-ACK has been lost. Send it again.
+		if( connection.state == TCPState::SynReceived ) {
+			tcp_send_segment(config, out, connection.remote, TCP::SYN | TCP::ACK, connection.snd_una, connection.rcv_nxt, 0);
+		}
+		return;
+	}
+	if( (flags & TCP::ACK) == 0 ) {
+		return;
+	}
+
+	// Process acknowledgement
+	if( tcp_seq_lt(connection.snd_una, acknowledgement_number) && tcp_seq_le(acknowledgement_number, connection.snd_nxt) ) {
+		if( connection.state == TCPState::SynReceived ) {
+			connection.state = TCPState::Established;
+		}
+		else if( connection.state == TCPState::LastAck && acknowledgement_number == connection.snd_nxt ) {
+			connection.state = TCPState::Listen;
+		}
+		connection.snd_una = acknowledgement_number;
+		connection.probe = false;
+		if( connection.snd_una == connection.snd_nxt ) {
+			connection.timer_running = false;
+		}
+		else {
+			tcp_restart_timer(timer);
+		}
+	}
+	if( tcp_seq_le(connection.snd_una, acknowledgement_number) ) {
+		connection.snd_wnd = tcp.window();
+	}
+	if( connection.state == TCPState::Listen || connection.state == TCPState::SynReceived ) {
+		return;
+	}
+
+	// Process received data. Out of order segments are dropped and the peer is notified by the duplicate ACK.
+	// Segments which do not fit in the RX buffer are dropped as well, and the ACK tells the current window to the peer.
+	bool send_ack = payload_length > 0;
+	if( sequence_number == connection.rcv_nxt && payload_length <= tcp_receive_window() ) {
+		if( payload_length > 0 && connection.state == TCPState::Established ) {
+			for(std::size_t i = 0; i < payload_length; i++) {
+#pragma HLS PIPELINE II=1
+				auto index = (connection.rx_end + i) & (TCP_RX_BUFFER_SIZE - 1);
+				tcp_rx_buffer[index] = payload[i];
+				tcp_rx_buffer_last[index] = i == payload_length - 1;
+			}
+			connection.rx_end += payload_length;
+			connection.rcv_nxt += payload_length;
+		}
+		if( (flags & TCP::FIN) != 0 && connection.state == TCPState::Established ) {
+			// Passive close. Our side does not have a way to keep the half-closed connection, so close it immediately.
+			connection.rcv_nxt += 1;
+			connection.snd_end = connection.snd_nxt;
+			connection.state = TCPState::LastAck;
+			tcp_send_segment(config, out, connection.remote, TCP::FIN | TCP::ACK, connection.snd_nxt, connection.rcv_nxt, 0);
+			connection.snd_nxt += 1;
+			tcp_restart_timer(timer);
+			send_ack = false;
+		}
+	}
+	if( send_ack ) {
+		tcp_send_ack(config, out);
+	}
+}
+
+// The following two move up to MSS bytes between the buffers and the streams without blocking.
+// They run whether or not a frame is being received, so that a consumer of tcp_rx which waits for tcp_tx, like a loopback, cannot stall the service.
+static void tcp_fill_tx_buffer(hls::stream<mac_data_axis>& tcp_tx)
+{
+	auto& connection = tcp_connection;
+
+	if( connection.state == TCPState::Established ) {
+		for(std::uint16_t i = 0; i < TCP_MSS; i++) {
+#pragma HLS PIPELINE II=1
+			if( connection.snd_end - connection.snd_una >= TCP_TX_BUFFER_SIZE ) break;
+			mac_data_axis data;
+			if( !tcp_tx.read_nb(data) ) break;
+			tcp_tx_buffer[connection.snd_end & (TCP_TX_BUFFER_SIZE - 1)] = data.data;
+			connection.snd_end++;
+		}
+	}
+}
+
+static void tcp_drain_rx_buffer(hls::stream<mac_data_axis>& tcp_rx)
+{
+	auto& connection = tcp_connection;
+
+	// Payload which has been acknowledged is delivered even after the connection is closed.
+	for(std::uint16_t i = 0; i < TCP_MSS; i++) {
+#pragma HLS PIPELINE II=1
+		if( connection.rx_begin == connection.rx_end ) break;
+		auto index = connection.rx_begin & (TCP_RX_BUFFER_SIZE - 1);
+		if( !tcp_rx.write_nb(MACData(tcp_rx_buffer[index], tcp_rx_buffer_last[index])) ) break;
+		connection.rx_begin++;
+	}
+}
+
+static void tcp_transmit(const EthernetServiceConfig& service_config, ap_uint<32> timer, hls::stream<mac_data_axis>& out)
+{
+	auto& connection = tcp_connection;
+
+	if( connection.state == TCPState::Listen ) {
+		return;
+	}
+	// Send segments with the identity which accepted the connection.
+	auto config = service_config;
+	config.hardware_address = connection.local_hardware_address;
+	config.ip_address = connection.local_ip_address;
+
+	// Tell the peer that the window has opened again, if the window it knows is too small to send a full segment.
+	if( connection.state == TCPState::Established
+	 && static_cast<std::uint32_t>(connection.rcv_adv - connection.rcv_nxt) < TCP_MSS && tcp_receive_window() >= TCP_MSS ) {
+		tcp_send_ack(config, out);
+	}
+
+	// Retransmission timer
+	if( connection.timer_running && static_cast<std::uint32_t>(timer - connection.timer_start) >= TCP_RETRANSMIT_TIMEOUT ) {
+		if( connection.retransmissions >= TCP_MAX_RETRANSMISSIONS ) {
+			tcp_send_segment(config, out, connection.remote, TCP::RST, connection.snd_nxt, 0, 0);
+			connection.state = TCPState::Listen;
+			connection.timer_running = false;
+			return;
+		}
+		auto retransmissions = connection.retransmissions + 1;
+		tcp_restart_timer(timer);
+		connection.retransmissions = retransmissions;
+		switch( connection.state ) {
+		case TCPState::SynReceived:
+			tcp_send_segment(config, out, connection.remote, TCP::SYN | TCP::ACK, connection.snd_una, connection.rcv_nxt, 0);
+			return;
+		case TCPState::LastAck:
+			tcp_send_segment(config, out, connection.remote, TCP::FIN | TCP::ACK, connection.snd_nxt - 1, connection.rcv_nxt, 0);
+			return;
+		default:
+			// Go back to the oldest unacknowledged byte.
+			connection.snd_nxt = connection.snd_una;
+			connection.probe = true;
+			break;
+		}
+	}
+
+	if( connection.state != TCPState::Established || connection.snd_nxt == connection.snd_end ) {
+		return;
+	}
+
+	std::uint32_t in_flight = connection.snd_nxt - connection.snd_una;
+	std::uint32_t window = connection.snd_wnd > in_flight ? connection.snd_wnd - in_flight
+	                     : connection.probe && in_flight == 0 ? 1
+	                     : 0;
+	if( window == 0 ) {
+		// Wait for the window update, or probe the window when the timer expires.
+		if( !connection.timer_running ) {
+			tcp_restart_timer(timer);
+		}
+		return;
+	}
+	std::uint32_t length = connection.snd_end - connection.snd_nxt;
+	if( length > window ) length = window;
+	if( length > connection.snd_mss ) length = connection.snd_mss;
+
+	tcp_send_segment(config, out, connection.remote, TCP::ACK | TCP::PSH, connection.snd_nxt, connection.rcv_nxt, length);
+	connection.snd_nxt += length;
+	if( !connection.timer_running ) {
+		tcp_restart_timer(timer);
+	}
+}
+
+// NTPv4 server.
+// The receive timestamp is the SFD time of the request captured by the MAC.
+// The transmit timestamp is written with the receive timestamp here and overwritten with the SFD time of the reply by the MAC while the reply is transmitted,
+// so the UDP checksum of the reply is left zero.
+
+static constexpr const std::uint32_t NTP_UNIX_EPOCH_OFFSET = 2208988800UL;	// Seconds from 1900-01-01 to 1970-01-01
+static constexpr const std::int8_t NTP_PRECISION = -24;	// log2 of the resolution of the time base (40[ns])
+
+static inline std::uint64_t to_ntp_timestamp(const Timestamp& timestamp)
+{
+	// fraction = nanoseconds * 2^32 / 10^9 = nanoseconds * 4 + nanoseconds * 0.294967296
+	std::uint32_t nanoseconds = timestamp.nanoseconds;
+	std::uint32_t fraction = (nanoseconds << 2) + static_cast<std::uint32_t>((static_cast<std::uint64_t>(nanoseconds) * 1266874890ULL) >> 32);
+	std::uint32_t seconds = static_cast<std::uint32_t>(timestamp.seconds(31, 0)) + NTP_UNIX_EPOCH_OFFSET;
+	return (static_cast<std::uint64_t>(seconds) << 32) | fraction;
+}
+
+static void ntp(const EthernetServiceConfig& config, const EthernetHeader& header, const IPv4& ip, const UDP& udp, const Timestamp& rx_time, hls::stream<mac_data_axis>& in, hls::stream<mac_data_axis>& out)
+{
+	NTP request;
+	{
+		auto result =  read_exact(in, request.raw);
+		if( result != ReadExactResult::Exact ) {
+			consume_remaining(in);
+		}
+		if( result == ReadExactResult::NotEnough ) {
+			return;
+		}
+	}
+
+	if( request.mode() != NTP::MODE_CLIENT || request.version() < 1 || request.version() > 4 ) {
+		return;
+	}
+
+	auto receive_timestamp = to_ntp_timestamp(rx_time);
+
+	NTP reply;
+	reply.leap_version_mode(rx_time.locked ? NTP::LEAP_NONE : NTP::LEAP_UNSYNCHRONIZED, request.version(), NTP::MODE_SERVER);
+	reply.stratum(rx_time.locked ? static_cast<std::uint8_t>(config.ntp_stratum) : NTP::STRATUM_UNSYNCHRONIZED);
+	reply.poll(request.poll());
+	reply.precision(NTP_PRECISION);
+	reply.root_delay(0);
+	reply.root_dispersion(0);
+	reply.reference_id(rx_time.locked ? static_cast<std::uint32_t>(config.ntp_reference_id) : 0);
+	reply.reference_timestamp(receive_timestamp & 0xffffffff00000000ULL);
+	reply.origin_timestamp(request.transmit_timestamp());
+	reply.receive_timestamp(receive_timestamp);
+	reply.transmit_timestamp(receive_timestamp);	// Overwritten by the MAC.
+
+	UDP udp_reply;
+	udp_reply.source_port(NTP::PORT);
+	udp_reply.destination_port(udp.source_port());
+	udp_reply.length(UDP::SIZE + NTP::SIZE);
+	udp_reply.checksum(0);
+
+	IPv4 ip_reply;
+	ip_reply.version(0x45);
+	ip_reply.type(ip.type());
+	ip_reply.length(IPv4::SIZE + UDP::SIZE + NTP::SIZE);
+	ip_reply.identification(ip_identification++);
+	ip_reply.flags_and_offset(0x4000);	// Don't fragment
+	ip_reply.time_to_live(64);
+	ip_reply.protocol(0x11);
+	ip_reply.source(config.get_ip_address());
+	ip_reply.destination(ip.source());
+	ip_reply.fill_checksum();
+
+	write_ethernet_header(out, config, header.vlan, header.source, 0x0800);
+	write_all(out, ip_reply.raw, false);
+	write_all(out, udp_reply.raw, false);
+
+	write_all(out, reply.raw, true);
+}
+
+// IPv4 multicast reception with IGMP on the untagged network.
+// The groups in config.multicast_groups are joined with unsolicited reports and reported again on queries.
+// Datagrams to a group with udp_port are sent to multicast_rx in the following format:
+//   group address (4), source address (4), source port (2), destination port (2), UDP payload
+// A datagram is dropped if multicast_rx is not ready at its start, so that the service does not stall
+// when nothing consumes multicast_rx.
+// The other groups are left to the PS. The MAC passes only the multicast frames whose hash is set in multicast_hash to the PS.
+
+static constexpr const std::uint8_t IGMP_PROTOCOL = 0x02;
+static constexpr const std::uint8_t IGMP_MEMBERSHIP_QUERY = 0x11;
+static constexpr const std::uint8_t IGMP_V2_MEMBERSHIP_REPORT = 0x16;
+static constexpr const std::uint8_t IGMP_V3_MEMBERSHIP_REPORT = 0x22;
+static constexpr const std::uint8_t IGMP_MODE_IS_EXCLUDE = 2;
+static constexpr const std::uint8_t IGMP_CHANGE_TO_EXCLUDE_MODE = 4;
+static constexpr const std::uint8_t IGMP_ROBUSTNESS = 2;
+static constexpr const std::uint32_t IGMP_UNSOLICITED_REPORT_INTERVAL = TIMER_HZ;	// 1[s]
+static constexpr const std::uint32_t IGMP_OLDER_VERSION_QUERIER_TIMEOUT = 260;	// [s] Robustness * Query Interval + Query Response Interval, counted in seconds as it is longer than the timer wraps around.
+static constexpr const std::uint32_t IGMP_MAX_RESPONSE_CODE = 600;	// Longer response time is limited to 60[s] to keep the timer comparison in range.
+// The report times are compared as signed differences of the timer.
+static_assert(static_cast<std::uint64_t>(IGMP_UNSOLICITED_REPORT_INTERVAL) < (1ULL << 31), "unsolicited report interval must fit in the timer range");
+static_assert(static_cast<std::uint64_t>(IGMP_MAX_RESPONSE_CODE) * (TIMER_HZ / 10) < (1ULL << 31), "max response time must fit in the timer range");
+static_assert(static_cast<std::uint64_t>(TIMER_HZ) < (1ULL << 31), "a second must fit in the timer range");
+static constexpr const std::size_t IGMP_IP_HEADER_SIZE = IPv4::SIZE + 4;	// With the Router Alert option
+static constexpr const std::size_t IGMP_QUERY_SIZE = 12;
+
+struct IGMPGroupState
+{
+	bool joined;
+	bool report_pending;
+	std::uint32_t report_time;			// Timer value when the pending report is sent.
+	std::uint8_t unsolicited_reports;	// Remaining reports of the join.
+
+	IGMPGroupState() : joined(false), report_pending(false), unsolicited_reports(0) {}
+};
+
+static IGMPGroupState igmp_groups[NUMBER_OF_MULTICAST_GROUPS];
+static bool igmp_v2_querier_present = false;
+static std::uint16_t igmp_v2_querier_age;		// Seconds since the last IGMPv2 query.
+static std::uint32_t igmp_second_start;		// Timer value when the current second of igmp_v2_querier_age started.
+static std::uint16_t igmp_random = 0xace1;
+
+static const IPAddress IGMP_ALL_SYSTEMS = {224, 0, 0, 1};
+static const IPAddress IGMP_V3_ROUTERS = {224, 0, 0, 22};
+
+static inline HardwareAddress to_multicast_hardware_address(const IPAddress& group)
+{
+	return HardwareAddress({0x01, 0x00, 0x5e, static_cast<std::uint8_t>(group[1] & 0x7f), group[2], group[3]});
+}
+
+// Index of the group in the hash table of the multicast filter of the MAC. This must match mii_multicast_filter.
+static inline std::uint8_t multicast_hash_index(std::uint32_t group)
+{
+	std::uint32_t value = group & 0x7fffff;
+	return (value ^ (value >> 6) ^ (value >> 12) ^ (value >> 18)) & 0x3f;
+}
+
+// Hash table of the groups left to the PS. All multicast frames are passed to the PS if no group is configured.
+static ap_uint<64> calculate_multicast_hash(const EthernetServiceConfig& config)
+{
+	ap_uint<64> hash = 0;
+	bool has_group = false;
+	for(std::size_t i = 0; i < NUMBER_OF_MULTICAST_GROUPS; i++) {
+#pragma HLS UNROLL
+		const auto& entry = config.multicast_groups[i];
+		if( entry.group_address != 0 ) {
+			has_group = true;
+			if( entry.udp_port == 0 ) {
+				hash[multicast_hash_index(entry.group_address)] = 1;
+			}
+		}
+	}
+	return has_group ? hash : ap_uint<64>(-1);
+}
+
+// Index of the group in config.multicast_groups, or NUMBER_OF_MULTICAST_GROUPS if the group is not configured.
+static std::size_t find_multicast_group(const EthernetServiceConfig& config, const IPAddress& group)
+{
+	std::size_t index = NUMBER_OF_MULTICAST_GROUPS;
+	for(std::size_t i = 0; i < NUMBER_OF_MULTICAST_GROUPS; i++) {
+#pragma HLS UNROLL
+		const auto& entry = config.multicast_groups[i];
+		if( entry.group_address != 0 && compare_array(entry.get_group_address(), group) == 0 ) {
+			index = i;
+		}
+	}
+	return index;
+}
+
+// Check if the destination hardware address is a multicast address we have to receive. (01:00:5e:00:00:01 or the address of a group)
+static bool is_ipv4_multicast_destination(const EthernetServiceConfig& config, const HardwareAddress& destination)
+{
+	if( compare_array(destination, to_multicast_hardware_address(IGMP_ALL_SYSTEMS)) == 0 ) return true;
+	bool result = false;
+	for(std::size_t i = 0; i < NUMBER_OF_MULTICAST_GROUPS; i++) {
+#pragma HLS UNROLL
+		const auto& entry = config.multicast_groups[i];
+		if( entry.group_address != 0 && compare_array(to_multicast_hardware_address(entry.get_group_address()), destination) == 0 ) {
+			result = true;
+		}
+	}
+	return result;
+}
+
+static void igmp_send_report(const EthernetServiceConfig& config, const IPAddress& group, bool unsolicited, hls::stream<mac_data_axis>& out)
+{
+	// IGMPv3 reports are sent unless an IGMPv2 querier is present.
+	bool is_v3 = config.igmp_version >= 3 && !igmp_v2_querier_present;
+	std::size_t igmp_length = is_v3 ? 16 : 8;
+	const IPAddress& destination = is_v3 ? IGMP_V3_ROUTERS : group;
+
+	std::array<std::uint8_t, IGMP_IP_HEADER_SIZE> ip;
+	ip[0] = 0x46;
+	ip[1] = 0xc0;	// Internetwork control
+	write16be(ip, 2, IGMP_IP_HEADER_SIZE + igmp_length);
+	write16be(ip, 4, ip_identification++);
+	write16be(ip, 6, 0);
+	ip[8] = 1;		// TTL
+	ip[9] = IGMP_PROTOCOL;
+	write16be(ip, 10, 0);
+	write_ipaddr(ip, 12, config.get_ip_address());
+	write_ipaddr(ip, 16, destination);
+	write32be(ip, 20, 0x94040000);	// Router Alert
+	write16be(ip, 10, ~calculate_internet_checksum(ip));
+
+	std::array<std::uint8_t, 16> igmp;
+	for(std::size_t i = 0; i < igmp.size(); i++) {
+#pragma HLS UNROLL
+		igmp[i] = 0;
+	}
+	if( is_v3 ) {
+		igmp[0] = IGMP_V3_MEMBERSHIP_REPORT;
+		write16be(igmp, 6, 1);	// Number of group records
+		igmp[8] = unsolicited ? IGMP_CHANGE_TO_EXCLUDE_MODE : IGMP_MODE_IS_EXCLUDE;
+		write_ipaddr(igmp, 12, group);
+	}
+	else {
+		igmp[0] = IGMP_V2_MEMBERSHIP_REPORT;
+		write_ipaddr(igmp, 4, group);
+	}
+	write16be(igmp, 2, ~calculate_internet_checksum(igmp, 0, igmp_length));
+
+	write_ethernet_header(out, config, VLANTags(), to_multicast_hardware_address(destination), 0x0800);
+	write_all(out, ip, false);
+	write_all(out, igmp, true, igmp_length);
+}
+
+static inline std::uint32_t igmp_random_delay(std::uint32_t max_delay)
+{
+	// 16bit Galois LFSR
+	igmp_random = (igmp_random >> 1) ^ ((igmp_random & 1) != 0 ? 0xb400 : 0);
+	return static_cast<std::uint32_t>((static_cast<std::uint64_t>(igmp_random) * max_delay) >> 16);
+}
+
+// Send the reports which are due. At most one report is sent at a time to keep the receive path responsive.
+static void igmp_transmit(const EthernetServiceConfig& config, ap_uint<32> timer, hls::stream<mac_data_axis>& out)
+{
+	if( config.igmp_version == 0 ) {
+		return;
+	}
+	// Count seconds, catching up one second per call if the service has been busy.
+	if( static_cast<std::uint32_t>(timer - igmp_second_start) >= TIMER_HZ ) {
+		igmp_second_start += TIMER_HZ;
+		if( igmp_v2_querier_present && ++igmp_v2_querier_age >= IGMP_OLDER_VERSION_QUERIER_TIMEOUT ) {
+			igmp_v2_querier_present = false;
+		}
+	}
+	for(std::size_t i = 0; i < NUMBER_OF_MULTICAST_GROUPS; i++) {
+		const auto& entry = config.multicast_groups[i];
+		auto& state = igmp_groups[i];
+		if( entry.group_address == 0 ) {
+			continue;
+		}
+		if( !state.joined ) {
+			state.joined = true;
+			state.report_pending = true;
+			state.report_time = timer;
+			state.unsolicited_reports = IGMP_ROBUSTNESS;
+		}
+		if( state.report_pending && static_cast<std::int32_t>(timer - state.report_time) >= 0 ) {
+			bool unsolicited = state.unsolicited_reports > 0;
+			igmp_send_report(config, entry.get_group_address(), unsolicited, out);
+			if( unsolicited ) {
+				state.unsolicited_reports--;
+			}
+			if( state.unsolicited_reports > 0 ) {
+				state.report_time = timer + IGMP_UNSOLICITED_REPORT_INTERVAL;
+			}
+			else {
+				state.report_pending = false;
+			}
+			return;
+		}
+	}
+}
+
+// Schedule reports for a membership query.
+static void igmp(const EthernetServiceConfig& config, ap_uint<32> timer, const IPv4& ip, std::size_t ip_header_length, hls::stream<mac_data_axis>& in)
+{
+	std::array<std::uint8_t, IGMP_QUERY_SIZE> message;
+	std::size_t igmp_length = ip.length() > ip_header_length ? ip.length() - ip_header_length : 0;
+	std::uint32_t checksum = 0;
+	for(std::size_t i = 0;; i++) {
+#pragma HLS PIPELINE II=1
+		auto d = in.read();
+		if( i < IGMP_QUERY_SIZE ) {
+			message[i] = d.data;
+		}
+		// The frame may contain padding after the IP packet.
+		if( i < igmp_length ) {
+			checksum += (i & 1) == 0 ? static_cast<std::uint16_t>(static_cast<std::uint16_t>(d.data) << 8) : static_cast<std::uint16_t>(d.data);
+		}
+		if( d.last ) {
+			if( i + 1 < igmp_length ) return;
+			break;
+		}
+	}
+	checksum = (checksum & 0xffff) + (checksum >> 16);
+	checksum = (checksum & 0xffff) + (checksum >> 16);
+	if( config.igmp_version == 0 || igmp_length < 8 || checksum != 0xffff || message[0] != IGMP_MEMBERSHIP_QUERY ) {
+		return;
+	}
+
+	std::uint32_t response_code = message[1];
+	if( igmp_length < IGMP_QUERY_SIZE ) {
+		// IGMPv1 or IGMPv2 query. IGMPv1 queries do not have the maximum response time. (10[s])
+		if( response_code == 0 ) response_code = 100;
+		igmp_v2_querier_present = true;
+		igmp_v2_querier_age = 0;
+		igmp_second_start = timer;
+	}
+	else if( response_code >= 128 ) {
+		// Floating point representation of IGMPv3.
+		response_code = ((response_code & 0x0f) | 0x10) << (((response_code >> 4) & 0x07) + 3);
+	}
+	if( response_code > IGMP_MAX_RESPONSE_CODE ) response_code = IGMP_MAX_RESPONSE_CODE;
+	std::uint32_t max_response_time = response_code * (TIMER_HZ / 10);
+
+	IPAddress group;
+	read_array(message, 4, group);
+	bool is_general = group[0] == 0 && group[1] == 0 && group[2] == 0 && group[3] == 0;
+	for(std::size_t i = 0; i < NUMBER_OF_MULTICAST_GROUPS; i++) {
+		const auto& entry = config.multicast_groups[i];
+		auto& state = igmp_groups[i];
+		if( entry.group_address == 0 || !state.joined || !(is_general || compare_array(entry.get_group_address(), group) == 0) ) {
+			continue;
+		}
+		// Reply after a random delay, unless an earlier report is pending.
+		std::uint32_t report_time = timer + igmp_random_delay(max_response_time);
+		if( !state.report_pending || static_cast<std::int32_t>(state.report_time - report_time) > 0 ) {
+			state.report_pending = true;
+			state.report_time = report_time;
+		}
+	}
+}
+
+static void multicast_udp(const EthernetServiceConfig& config, const IPv4& ip, const UDP& udp, hls::stream<mac_data_axis>& in, hls::stream<mac_data_axis>& multicast_rx)
+{
+	auto index = find_multicast_group(config, ip.destination());
+	if( index == NUMBER_OF_MULTICAST_GROUPS || config.multicast_groups[index].udp_port == 0 || udp.destination_port() != config.multicast_groups[index].udp_port
+	 || udp.length() < UDP::SIZE || udp.length() > ip.length() - IPv4::SIZE || multicast_rx.full() ) {
+		consume_remaining(in);
+		return;
+	}
+
+	std::array<std::uint8_t, 12> header;
+	write_ipaddr(header, 0, ip.destination());
+	write_ipaddr(header, 4, ip.source());
+	write16be(header, 8, udp.source_port());
+	write16be(header, 10, udp.destination_port());
+	std::size_t payload_length = udp.length() - UDP::SIZE;
+	write_all(multicast_rx, header, payload_length == 0);
+
+	// The UDP checksum is not verified since the payload is forwarded as it arrives. The FCS has been checked by the MAC.
+	bool last = false;
+	for(std::size_t i = 0; i < payload_length; i++) {
+#pragma HLS PIPELINE II=1
+		auto d = in.read();
+		last = d.last;
+		multicast_rx.write(MACData(d.data, last || i == payload_length - 1));
+		if( last ) break;
+	}
+	if( !last ) {
+		consume_remaining(in);
+	}
+}
+
+static void udp(const EthernetServiceConfig& config, const EthernetHeader& header, const IPv4& ip, bool is_multicast, const Timestamp& rx_time, hls::stream<mac_data_axis>& in, hls::stream<mac_data_axis>& out, hls::stream<mac_data_axis>& multicast_rx)
+{
+	UDP udp;
+	{
+		auto result =  read_exact(in, udp.raw);
+		if( result != ReadExactResult::Remaining ) {
+			return;
+		}
+	}
+
+	if( is_multicast ) {
+		multicast_udp(config, ip, udp, in, multicast_rx);
+	}
+	else if( udp.destination_port() == NTP::PORT && config.ntp_stratum != 0 ) {
+		ntp(config, header, ip, udp, rx_time, in, out);
+	}
+	else {
+		consume_remaining(in);
+	}
+}
+
+static void ipv4(const EthernetServiceConfig& config, ap_uint<32> timer, const Timestamp& rx_time, const EthernetHeader& header, hls::stream<mac_data_axis>& in, hls::stream<mac_data_axis>& out, hls::stream<mac_data_axis>& multicast_rx)
+{
+	IPv4 ip;
+	{
+		auto result =  read_exact(in, ip.raw);
+		if( result != ReadExactResult::Remaining ) {
+			return;
+		}
+	}
+
+	auto destination = ip.destination();
+	bool is_unicast = compare_array(destination, config.get_ip_address()) == 0;
+	bool is_multicast = header.vlan.count == 0
+		&& (compare_array(destination, IGMP_ALL_SYSTEMS) == 0 || find_multicast_group(config, destination) != NUMBER_OF_MULTICAST_GROUPS);
+	std::size_t header_length = (ip.version() & 0x0f) * 4;
+
+	// Accept only IPv4 packets without options, except IGMP messages which have the Router Alert option.
+	if( !(is_unicast || is_multicast) || (ip.version() & 0xf0) != 0x40 || header_length < IPv4::SIZE
+	 || (header_length != IPv4::SIZE && ip.protocol() != IGMP_PROTOCOL) ) {
+		consume_remaining(in);
+		return;
+	}
+	if( is_unicast && header.vlan.count == 0 ) {
+		arp_cache_update(timer, ip.source(), header.source, true);
+	}
+	for(std::size_t i = IPv4::SIZE; i < header_length; i++) {
+#pragma HLS PIPELINE II=1
+		if( in.read().last ) return;
+	}
+
+	switch( ip.protocol() ) {
+	case 0x01:	// ICMP
+		if( is_unicast ) {
+			icmp_reply(config, header, ip, in, out);
+		}
+		else {
+			consume_remaining(in);
+		}
+		break;
+	case IGMP_PROTOCOL:
+		igmp(config, timer, ip, header_length, in);
+		break;
+	case 0x06:	// TCP
+		if( is_unicast ) {
+			tcp(config, timer, header, ip, in, out);
+		}
+		else {
+			consume_remaining(in);
+		}
+		break;
+	case 0x11:	// UDP
+		udp(config, header, ip, is_multicast, rx_time, in, out, multicast_rx);
+		break;
+	default:
+		consume_remaining(in);
+		break;
+	}
+}
+
+// Transmission of IPv4 packets originated in the PL.
+// Each packet on ip_tx is a complete IPv4 packet (header checksum included) terminated by tlast.
+// It is sent untagged to the next hop resolved by the ARP cache. On a miss, the packet is held
+// until the ARP reply arrives, and dropped if no reply arrives after ARP_MAX_REQUESTS requests.
+
+static constexpr const std::size_t IP_TX_MAX_PACKET_LENGTH = 1500;
+static constexpr const std::uint32_t ARP_REQUEST_INTERVAL = TIMER_HZ;	// 1[s]
+static constexpr const std::uint8_t ARP_MAX_REQUESTS = 3;
+
+struct PendingPacket
+{
+	bool valid;
+	IPAddress next_hop;
+	std::uint16_t length;
+	std::uint32_t requested;	// Timer value when the last ARP request was sent.
+	std::uint8_t requests;
+
+	PendingPacket() : valid(false) {}
+};
+
+static PendingPacket ip_tx_pending;
+static std::array<std::uint8_t, IP_TX_MAX_PACKET_LENGTH> ip_tx_buffer;
+
+static void send_arp_request(const EthernetServiceConfig& config, const IPAddress& target, hls::stream<mac_data_axis>& out)
+{
+	ARP arp;
+	arp.hardware_type(0x0001);
+	arp.protocol_type(0x0800);
+	arp.hlen(6);
+	arp.plen(4);
+	arp.operation(0x0001);
+	arp.sha(config.get_hardware_address());
+	arp.spa(config.get_ip_address());
+	arp.tha(HardwareAddress({0, 0, 0, 0, 0, 0}));
+	arp.tpa(target);
+
+	write_ethernet_header(out, config, VLANTags(), HardwareAddress({0xff, 0xff, 0xff, 0xff, 0xff, 0xff}), 0x0806);
+	write_all(out, arp.raw, true);
+}
+
+static void send_ip_tx_packet(const EthernetServiceConfig& config, const HardwareAddress& destination, hls::stream<mac_data_axis>& out)
+{
+	auto& pending = ip_tx_pending;
+	write_ethernet_header(out, config, VLANTags(), destination, 0x0800);
+	write_all(out, ip_tx_buffer, true, pending.length);
+	pending.valid = false;
+}
+
+static void ip_transmit(const EthernetServiceConfig& config, ap_uint<32> timer, hls::stream<mac_data_axis>& ip_tx, hls::stream<mac_data_axis>& out)
+{
+	auto& pending = ip_tx_pending;
+
+	if( !pending.valid ) {
+		if( ip_tx.empty() ) {
+			return;
+		}
+		std::size_t length = 0;
+		bool too_long = false;
+		for(std::size_t i = 0;; i++) {
+#pragma HLS PIPELINE II=1
+			auto d = ip_tx.read();
+			if( i < IP_TX_MAX_PACKET_LENGTH ) {
+				ip_tx_buffer[i] = d.data;
+			}
+			else {
+				too_long = true;
+			}
+			if( d.last ) {
+				length = i + 1;
+				break;
+			}
+		}
+		if( too_long || length < IPv4::SIZE ) {
+			return;
+		}
+
+		// Packets to other networks are sent to the gateway.
+		auto destination = read_ipaddr(ip_tx_buffer, 16);
+		auto destination_value = from_ip_address(destination);
+		bool is_local = ((destination_value ^ config.ip_address) & config.ip_netmask) == 0;
+		if( destination_value == 0xffffffff ) {
+			pending.length = length;
+			send_ip_tx_packet(config, HardwareAddress({0xff, 0xff, 0xff, 0xff, 0xff, 0xff}), out);
+			return;
+		}
+		if( !is_local && config.gateway_address == 0 ) {
+			return;	// No route
+		}
+		pending.valid = true;
+		pending.next_hop = is_local ? destination : config.get_gateway_address();
+		pending.length = length;
+		pending.requests = 0;
+	}
+
+	auto hardware_address = arp_cache_lookup(pending.next_hop);
+	if( hardware_address ) {
+		send_ip_tx_packet(config, hardware_address.get(), out);
+		return;
+	}
+	if( pending.requests == 0 || static_cast<std::uint32_t>(timer - pending.requested) >= ARP_REQUEST_INTERVAL ) {
+		if( pending.requests >= ARP_MAX_REQUESTS ) {
+			pending.valid = false;	// The next hop is unreachable.
+			return;
+		}
+		send_arp_request(config, pending.next_hop, out);
+		pending.requested = timer;
+		pending.requests++;
+	}
+}
+
+// IPv6 neighbor discovery and ICMPv6 echo for the link-local address and the configured global address.
+
+static inline bool is_unspecified_ipv6_address(const IPv6Address& address)
+{
+	bool result = true;
+	for(std::size_t i = 0; i < 16; i++) {
+#pragma HLS UNROLL
+		result = result && address[i] == 0;
+	}
+	return result;
+}
+
+// Check if the address is the solicited-node multicast address (ff02::1:ffXX:XXXX) of the target address.
+static inline bool is_solicited_node_address(const IPv6Address& address, const IPv6Address& target)
+{
+	static const IPv6Address prefix = {0xff, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xff, 0x00, 0x00, 0x00};
+	bool result = true;
+	for(std::size_t i = 0; i < 13; i++) {
+#pragma HLS UNROLL
+		result = result && address[i] == prefix[i];
+	}
+	return result && address[13] == target[13] && address[14] == target[14] && address[15] == target[15];
+}
+
+struct IPv6Addresses
+{
+	IPv6Address link_local;
+	IPv6Address global;
+	bool has_global;
+
+	IPv6Addresses(const EthernetServiceConfig& config)
+		: link_local(config.get_link_local_address()), global(config.get_ipv6_address()), has_global(config.ipv6_address != 0) {}
+
+	bool is_unicast(const IPv6Address& address) const
+	{
+		return compare_array(address, this->link_local) == 0 || (this->has_global && compare_array(address, this->global) == 0);
+	}
+	bool is_solicited_node(const IPv6Address& address) const
+	{
+		return is_solicited_node_address(address, this->link_local) || (this->has_global && is_solicited_node_address(address, this->global));
+	}
+};
+
+// Check if the destination hardware address is a multicast address we have to receive. (33:33:00:00:00:01 or 33:33:ff:XX:XX:XX)
+static bool is_ipv6_multicast_destination(const EthernetServiceConfig& config, const HardwareAddress& destination)
+{
+	if( destination[0] != 0x33 || destination[1] != 0x33 ) return false;
+	if( destination[2] == 0x00 && destination[3] == 0x00 && destination[4] == 0x00 && destination[5] == 0x01 ) return true;
+	if( destination[2] != 0xff ) return false;
+	IPv6Addresses addresses(config);
+	auto matches = [&destination](const IPv6Address& address) {
+		return destination[3] == address[13] && destination[4] == address[14] && destination[5] == address[15];
+	};
+	return matches(addresses.link_local) || (addresses.has_global && matches(addresses.global));
+}
+
+template<std::size_t MAX_PAYLOAD_LENGTH=1500 - IPv6::SIZE>
+static void ipv6(const EthernetServiceConfig& config, const EthernetHeader& header, hls::stream<mac_data_axis>& in, hls::stream<mac_data_axis>& out)
+{
+	IPv6 ip;
+	{
+		auto result =  read_exact(in, ip.raw);
+		if( result != ReadExactResult::Remaining ) {
+			return;
+		}
+	}
+
+	IPv6Addresses addresses(config);
+	auto destination = ip.destination();
+	bool is_unicast = addresses.is_unicast(destination);
+	if( ip.version() != 6 || ip.next_header() != IPv6::NEXT_HEADER_ICMPV6 || !(is_unicast || addresses.is_solicited_node(destination)) ) {
+		consume_remaining(in);
+		return;
+	}
+
+	std::array<std::uint8_t, MAX_PAYLOAD_LENGTH> payload;
+	std::size_t payload_length = read_payload(in, payload.data(), MAX_PAYLOAD_LENGTH);
+	// The frame may contain padding after the IPv6 packet.
+	if( ip.payload_length() > payload_length || ip.payload_length() < ICMPv6::SIZE ) {
+		return;
+	}
+	payload_length = ip.payload_length();
+
+	// Verify checksum
+	{
+		auto checksum = calculate_ipv6_pseudo_header_checksum(ip.source(), destination, IPv6::NEXT_HEADER_ICMPV6, payload_length);
+		checksum = calculate_internet_checksum(payload, checksum, payload_length);
+		if( checksum != 0xffff ) {
+			return;
+		}
+	}
+
+	auto type = payload[0];
+	auto code = payload[1];
+	std::size_t reply_length = 0;
+	IPv6Address reply_source;
+	IPv6Address reply_destination;
+	HardwareAddress reply_hardware_destination = header.source;
+
+	if( type == ICMPv6::NEIGHBOR_SOLICITATION && code == 0 && ip.hop_limit() == 255 && payload_length >= 24 ) {
+		IPv6Address target;
+		read_array(payload, 8, target);
+		if( !addresses.is_unicast(target) ) {
+			return;
+		}
+		// Reply Neighbor Advertisement with the target link-layer address option.
+		// Unsolicited advertisement is sent to all-nodes if the solicitation comes from the unspecified address (DAD).
+		bool is_dad = is_unspecified_ipv6_address(ip.source());
+		payload[0] = ICMPv6::NEIGHBOR_ADVERTISEMENT;
+		payload[4] = is_dad ? 0x20 : 0x60;	// Solicited (if not DAD) and Override
+		payload[5] = 0;
+		payload[6] = 0;
+		payload[7] = 0;
+		payload[24] = 2;	// Target Link-Layer Address
+		payload[25] = 1;	// 8 octets
+		write_hwaddr(payload, 26, config.get_hardware_address());
+		reply_length = 32;
+		reply_source = target;
+		if( is_dad ) {
+			reply_destination = IPv6Address({0xff, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01});
+			reply_hardware_destination = HardwareAddress({0x33, 0x33, 0x00, 0x00, 0x00, 0x01});
+		}
+		else {
+			reply_destination = ip.source();
+		}
+		ip.hop_limit(255);
+	}
+	else if( type == ICMPv6::ECHO_REQUEST && code == 0 && is_unicast ) {
+		// Just changing type field is enough.
+		payload[0] = ICMPv6::ECHO_REPLY;
+		reply_length = payload_length;
+		reply_source = destination;
+		reply_destination = ip.source();
+		ip.hop_limit(64);
+	}
+	else {
+		return;
+	}
+
+	// Construct IPv6 header. Traffic class and flow label are cleared.
+	write32be(ip.raw, 0, 0x60000000);
+	ip.payload_length(reply_length);
+	ip.source(reply_source);
+	ip.destination(reply_destination);
+
+	// Fill ICMPv6 checksum
+	payload[2] = 0;
+	payload[3] = 0;
+	{
+		auto checksum = calculate_ipv6_pseudo_header_checksum(reply_source, reply_destination, IPv6::NEXT_HEADER_ICMPV6, reply_length);
+		checksum = calculate_internet_checksum(payload, checksum, reply_length);
+		write16be(payload, 2, ~checksum);
+	}
+
+	// Send Ethernet header
+	write_ethernet_header(out, config, header.vlan, reply_hardware_destination, 0x86dd);
+
+	// Send IPv6 header
+	write_all(out, ip.raw, false);
+
+	// Send ICMPv6 message
+	write_all(out, payload, true, reply_length);
+}
+
+// Select the identity of the service for the VLAN tags of the received frame.
+static optional<EthernetServiceConfig> resolve_identity(const EthernetServiceConfig& config, const VLANTags& vlan)
+{
+	if( vlan.count == 0 ) {
+		return config;
+	}
+	EthernetServiceConfig identity = config;
+	identity.ipv6_address = 0;	// Only the link-local address is available on VLANs.
+	bool found = false;
+	for(std::size_t i = 0; i < NUMBER_OF_VLAN_IDENTITIES; i++) {
+#pragma HLS UNROLL
+		const auto& entry = config.vlan_identities[i];
+		bool outer_matches = vlan.count == 1 ? entry.outer_vlan_id == 0 : entry.outer_vlan_id == vlan.vlan_id(0);
+		if( !found && entry.vlan_id != 0 && entry.vlan_id == vlan.inner_vlan_id() && outer_matches ) {
+			identity.hardware_address = entry.hardware_address;
+			identity.ip_address = entry.ip_address;
+			found = true;
+		}
+	}
+	if( !found ) return {};
+	return identity;
+}
+
+static void receive_frame(const EthernetServiceConfig& config, ap_uint<32> timer, hls::stream<timestamp_axis>& rx_timestamp, hls::stream<mac_data_axis>& in, hls::stream<mac_data_axis>& out, hls::stream<mac_data_axis>& multicast_rx)
+{
+	// The MAC sends the SFD time of each frame on rx_timestamp when the frame starts.
+	Timestamp rx_time = rx_timestamp.read();
+
+	auto header = read_header(in);
+	if( !header ) return;
+
+	auto identity = resolve_identity(config, header.get().vlan);
+	if( !identity ) {
+		consume_remaining(in);
+		return;
+	}
+	const auto& identity_config = identity.get();
+
+	// Check destination
+	if( compare_array(header.get().destination, identity_config.get_hardware_address()) != 0 && compare_array(header.get().destination, HardwareAddress({0xff, 0xff, 0xff, 0xff, 0xff, 0xff})) != 0
+	 && !(header.get().protocol == 0x86dd && is_ipv6_multicast_destination(identity_config, header.get().destination))
+	 && !(header.get().protocol == 0x0800 && header.get().vlan.count == 0 && is_ipv4_multicast_destination(identity_config, header.get().destination)) ) {
+		consume_remaining(in);
+		return;
+	}
+
+	switch( header.get().protocol ) {
+	case 0x0800:	// IP
+		ipv4(identity_config, timer, rx_time, header.get(), in, out, multicast_rx);
+		break;
+	case 0x0806:	// ARP
+		arp(identity_config, timer, header.get(), in, out);
+		break;
+	case 0x86dd:	// IPv6
+		ipv6(identity_config, header.get(), in, out);
+		break;
+	default:
+		consume_remaining(in);
+		break;
+	}
+}
+
+void ethernet_service(const EthernetServiceConfig& config, ap_uint<32> timer, hls::stream<timestamp_axis>& rx_timestamp, hls::stream<mac_data_axis>& in, hls::stream<mac_data_axis>& out, hls::stream<mac_data_axis>& tcp_rx, hls::stream<mac_data_axis>& tcp_tx, hls::stream<mac_data_axis>& ip_tx, hls::stream<mac_data_axis>& multicast_rx, ap_uint<64>& multicast_hash)
+{
+#pragma HLS interface ap_ctrl_none port=return
+#pragma HLS INTERFACE ap_stable register port=config
+#pragma HLS INTERFACE ap_none port=timer
+#pragma HLS interface axis port=rx_timestamp
+#pragma HLS interface axis port=in
+#pragma HLS interface axis port=out
+#pragma HLS interface axis port=tcp_rx
+#pragma HLS interface axis port=tcp_tx
+#pragma HLS interface axis port=ip_tx
+#pragma HLS interface axis port=multicast_rx
+#pragma HLS interface ap_none port=multicast_hash
+
+	multicast_hash = calculate_multicast_hash(config);
+
+	tcp_fill_tx_buffer(tcp_tx);
+
+	// Transmit packets originated in the PL, IGMP reports and TCP segments while there are no frames to process.
+	if( in.empty() ) {
+		arp_cache_age(timer);
+		ip_transmit(config, timer, ip_tx, out);
+		igmp_transmit(config, timer, out);
+		tcp_transmit(config, timer, out);
+	}
+	else {
+		receive_frame(config, timer, rx_timestamp, in, out, multicast_rx);
 	}
+	tcp_drain_rx_buffer(tcp_rx);
 }
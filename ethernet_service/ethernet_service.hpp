@@ -9,6 +9,7 @@
 #include <cstdint>
 
 typedef ap_axiu<8, 0, 0, 0> mac_data_axis;
+typedef ap_axiu<96, 0, 0, 0> timestamp_axis;
 
 template<typename T>
 struct optional
@@ -56,9 +57,32 @@ struct MACData {
 	}
 };
 
+// Time of the PL time base captured by the MAC at the SFD of a frame.
+// The seconds and nanoseconds are counted from the UNIX epoch like PTP. locked is set while the PS keeps the time base disciplined.
+struct Timestamp {
+	ap_uint<48> seconds;
+	std::uint32_t nanoseconds;
+	bool locked;
+	Timestamp() {}
+	Timestamp(const Timestamp&) = default;
+	Timestamp(const timestamp_axis& axis) : seconds(axis.data(79, 32)), nanoseconds(axis.data(31, 0)), locked(axis.data[80]) {}
+
+	operator timestamp_axis() const {
+		timestamp_axis axis;
+		axis.data = 0;
+		axis.data(31, 0) = this->nanoseconds;
+		axis.data(79, 32) = this->seconds;
+		axis.data(80, 80) = this->locked ? 1 : 0;
+		axis.keep = -1;
+		axis.last = 1;
+		return axis;
+	}
+};
+
 
 typedef std::array<std::uint8_t, 6> HardwareAddress;
 typedef std::array<std::uint8_t, 4> IPAddress;
+typedef std::array<std::uint8_t, 16> IPv6Address;
 
 static HardwareAddress to_hardware_address(const ap_uint<8*6>& value)
 {
@@ -80,15 +104,76 @@ static IPAddress to_ip_address(const ap_uint<8*4>& value)
 	result[0] = value(31, 24);
 	return result;
 }
+static IPv6Address to_ipv6_address(const ap_uint<8*16>& value)
+{
+	IPv6Address result;
+	for(std::size_t i = 0; i < 16; i++) {
+#pragma HLS UNROLL
+		result[15 - i] = value(i*8 + 7, i*8);
+	}
+	return result;
+}
+// Link-local address with the interface identifier generated from the hardware address by modified EUI-64.
+static IPv6Address to_link_local_address(const HardwareAddress& hardware_address)
+{
+	return IPv6Address({
+		0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		static_cast<std::uint8_t>(hardware_address[0] ^ 0x02), hardware_address[1], hardware_address[2], 0xff,
+		0xfe, hardware_address[3], hardware_address[4], hardware_address[5],
+	});
+}
+
+// Frequency of ap_clk.
+static constexpr const std::uint32_t SERVICE_CLOCK_HZ = 100000000;
+
+// Frequency of the timer passed to ethernet_service, prescaled from ap_clk so that the timeouts fit in 32 bits.
+static constexpr const std::uint32_t TIMER_HZ = SERVICE_CLOCK_HZ / 4;
+
+// Identity of the service on a VLAN.
+// Frames tagged with vlan_id (and outer_vlan_id, if the frame is double tagged) are served with this hardware address and IP address.
+struct VLANIdentityConfig
+{
+	ap_uint<8*6> hardware_address;
+	ap_uint<8*4> ip_address;
+	ap_uint<8*2> vlan_id;		// VLAN ID of the innermost tag. 0 disables this entry.
+	ap_uint<8*2> outer_vlan_id;	// VLAN ID of the outer tag of double tagged frames. 0 matches only single tagged frames.
+
+	HardwareAddress get_hardware_address() const { return to_hardware_address(this->hardware_address); }
+	IPAddress get_ip_address() const { return to_ip_address(this->ip_address); }
+};
+
+static constexpr const std::size_t NUMBER_OF_VLAN_IDENTITIES = 4;
+
+// Multicast group received on the untagged network.
+struct MulticastGroupConfig
+{
+	ap_uint<8*4> group_address;	// 0 disables this entry.
+	ap_uint<8*2> udp_port;	// Datagrams to this port are sent to multicast_rx. 0 passes the group to the PS instead.
+
+	IPAddress get_group_address() const { return to_ip_address(this->group_address); }
+};
 
+static constexpr const std::size_t NUMBER_OF_MULTICAST_GROUPS = 4;
 
 struct EthernetServiceConfig
 {
 	ap_uint<8*6> hardware_address;
 	ap_uint<8*4> ip_address;
+	ap_uint<8*2> tcp_port;	// Local port of the passive TCP connection. 0 disables TCP.
+	ap_uint<8*16> ipv6_address;	// Global IPv6 address in addition to the link-local address. 0 disables it.
+	VLANIdentityConfig vlan_identities[NUMBER_OF_VLAN_IDENTITIES];	// Identities for tagged frames. Untagged frames use the addresses above.
+	ap_uint<8*4> ntp_reference_id;	// Reference ID of the NTP server. (e.g. "PPS" for a PPS disciplined time base)
+	ap_uint<8> ntp_stratum;	// Stratum of the NTP server while the time base is locked. 0 disables NTP.
+	ap_uint<8*4> ip_netmask;	// Netmask of ip_address. Packets on ip_tx to other networks are sent to gateway_address.
+	ap_uint<8*4> gateway_address;	// 0 drops packets on ip_tx to other networks.
+	MulticastGroupConfig multicast_groups[NUMBER_OF_MULTICAST_GROUPS];
+	ap_uint<8> igmp_version;	// Version of IGMP reports for multicast_groups (2 or 3). 0 disables IGMP.
 
 	HardwareAddress get_hardware_address() const { return to_hardware_address(this->hardware_address); }
 	IPAddress get_ip_address() const { return to_ip_address(this->ip_address); }
+	IPAddress get_gateway_address() const { return to_ip_address(this->gateway_address); }
+	IPv6Address get_ipv6_address() const { return to_ipv6_address(this->ipv6_address); }
+	IPv6Address get_link_local_address() const { return to_link_local_address(this->get_hardware_address()); }
 };
 
-void ethernet_service(const EthernetServiceConfig& config, hls::stream<mac_data_axis>& in, hls::stream<mac_data_axis>& out);
+void ethernet_service(const EthernetServiceConfig& config, ap_uint<32> timer, hls::stream<timestamp_axis>& rx_timestamp, hls::stream<mac_data_axis>& in, hls::stream<mac_data_axis>& out, hls::stream<mac_data_axis>& tcp_rx, hls::stream<mac_data_axis>& tcp_tx, hls::stream<mac_data_axis>& ip_tx, hls::stream<mac_data_axis>& multicast_rx, ap_uint<64>& multicast_hash);
@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <cstdio>
 #include <cassert>
+#include <algorithm>
 
 static std::vector<std::uint8_t> read_all(const char* path)
 {
@@ -31,14 +32,52 @@ static void write_array(hls::stream<mac_data_axis>& stream, const std::vector<st
 	}
 }
 
+static Timestamp make_timestamp(std::uint64_t seconds, std::uint32_t nanoseconds, bool locked)
+{
+	Timestamp timestamp;
+	timestamp.seconds = seconds;
+	timestamp.nanoseconds = nanoseconds;
+	timestamp.locked = locked;
+	return timestamp;
+}
+
+// Write a frame with the SFD timestamp the MAC sends along with it.
+static void write_frame(hls::stream<mac_data_axis>& stream, hls::stream<timestamp_axis>& rx_timestamp, const std::vector<std::uint8_t>& data, const Timestamp& timestamp = make_timestamp(0, 0, false))
+{
+	rx_timestamp.write(timestamp);
+	write_array(stream, data);
+}
+
+static std::vector<std::uint8_t> read_frame(hls::stream<mac_data_axis>& stream)
+{
+	std::vector<std::uint8_t> frame;
+	while( !stream.empty() ) {
+		auto value = stream.read();
+		frame.push_back(value.data);
+		if( value.last ) break;
+	}
+	return frame;
+}
+
+// Pad a frame like the MAC (append_crc) does before the FCS: 60 bytes, or 64 bytes with a VLAN tag.
+static std::vector<std::uint8_t> pad_frame(std::vector<std::uint8_t> frame)
+{
+	bool tagged = frame.size() >= 14 && ((frame[12] == 0x81 && frame[13] == 0x00) || (frame[12] == 0x88 && frame[13] == 0xa8));
+	frame.resize(std::max<std::size_t>(frame.size(), tagged ? 64 : 60), 0);
+	return frame;
+}
+
 bool run_test(const char* test_data_name)
 {
+	hls::stream<timestamp_axis> rx_timestamp;
 	hls::stream<mac_data_axis> in;
 	hls::stream<mac_data_axis> out;
 
 	EthernetServiceConfig config = {
 		"0xaabbccddeeff",	// hwaddr
 		"0xc0a80402",		// ipaddr
+		5001,				// tcp_port
+		"0xfd000000000000040000000000000002",	// ipv6addr
 	};
 
 	std::stringstream input_path;
@@ -55,32 +94,902 @@ bool run_test(const char* test_data_name)
 	std::cout << "input : " << input.size() << std::endl;
 	std::cout << "output: " << output.size() << std::endl;
 
-	write_array(in, input);
+	write_frame(in, rx_timestamp, input);
 
-	ethernet_service(config, in, out);
+	hls::stream<mac_data_axis> tcp_rx;
+	hls::stream<mac_data_axis> tcp_tx;
+	hls::stream<mac_data_axis> ip_tx;
+	hls::stream<mac_data_axis> multicast_rx;
+	ap_uint<64> multicast_hash;
+	ethernet_service(config, 0, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
 
 	bool result = true;
 
-	std::size_t bytes_output;
-	for(bytes_output = 0; bytes_output < output.size() && !out.empty(); bytes_output++ ) {
-		auto value = out.read();
-		if( value.data != output[bytes_output] ) {
-			std::printf("mismatch at %04ld expected %02x actual %02lx\n", bytes_output, output[bytes_output], value.data.to_uint64());
+	// The expected frames are as sent on the wire without the FCS.
+	std::vector<std::uint8_t> actual;
+	while( !out.empty() ) {
+		auto frame = pad_frame(read_frame(out));
+		actual.insert(actual.end(), frame.begin(), frame.end());
+	}
+	for(std::size_t i = 0; i < output.size() && i < actual.size(); i++ ) {
+		if( actual[i] != output[i] ) {
+			std::printf("mismatch at %04ld expected %02x actual %02x\n", i, output[i], actual[i]);
 			result = false;
 		}
 	}
-	if( bytes_output != output.size() ) {
-		std::printf("mismatch output length expected %ld actual %ld\n", output.size(), bytes_output);
+	if( actual.size() != output.size() ) {
+		std::printf("mismatch output length expected %ld actual %ld\n", output.size(), actual.size());
 		result = false;
 	}
 
 	return result;
 }
 
+static std::uint16_t checksum16(const std::vector<std::uint8_t>& data, std::size_t offset, std::size_t length, std::uint32_t initial = 0)
+{
+	std::uint32_t checksum = initial;
+	for(std::size_t i = 0; i < length; i++) {
+		checksum += (i & 1) == 0 ? data[offset + i] << 8 : data[offset + i];
+	}
+	while( checksum >> 16 ) checksum = (checksum & 0xffff) + (checksum >> 16);
+	return checksum;
+}
+
+static std::vector<std::uint8_t> build_tcp_frame(std::uint32_t seq, std::uint32_t ack, std::uint8_t flags, const std::vector<std::uint8_t>& payload, const std::vector<std::uint8_t>& options = {})
+{
+	std::vector<std::uint8_t> frame = {
+		0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,	// destination
+		0x02, 0x00, 0x00, 0x00, 0x00, 0x01,	// source
+		0x08, 0x00,
+		// IPv4
+		0x45, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x40, 0x06, 0x00, 0x00,
+		0xc0, 0xa8, 0x04, 0x01,
+		0xc0, 0xa8, 0x04, 0x02,
+		// TCP
+		0xc0, 0x00, 0x13, 0x89,
+		static_cast<std::uint8_t>(seq >> 24), static_cast<std::uint8_t>(seq >> 16), static_cast<std::uint8_t>(seq >> 8), static_cast<std::uint8_t>(seq),
+		static_cast<std::uint8_t>(ack >> 24), static_cast<std::uint8_t>(ack >> 16), static_cast<std::uint8_t>(ack >> 8), static_cast<std::uint8_t>(ack),
+		static_cast<std::uint8_t>((5 + options.size() / 4) << 4), flags, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00,
+	};
+	frame.insert(frame.end(), options.begin(), options.end());
+	frame.insert(frame.end(), payload.begin(), payload.end());
+	std::size_t ip_length = frame.size() - 14;
+	frame[16] = ip_length >> 8;
+	frame[17] = ip_length & 0xff;
+	auto ip_checksum = ~checksum16(frame, 14, 20);
+	frame[24] = ip_checksum >> 8;
+	frame[25] = ip_checksum & 0xff;
+	std::uint32_t pseudo = checksum16(frame, 26, 8) + 0x06 + (ip_length - 20);
+	auto tcp_checksum = ~checksum16(frame, 34, ip_length - 20, pseudo);
+	frame[50] = tcp_checksum >> 8;
+	frame[51] = tcp_checksum & 0xff;
+	while( frame.size() < 60 ) frame.push_back(0);
+	return frame;
+}
+
+bool run_tcp_test()
+{
+	hls::stream<timestamp_axis> rx_timestamp;
+	hls::stream<mac_data_axis> in;
+	hls::stream<mac_data_axis> out;
+	hls::stream<mac_data_axis> tcp_rx;
+	hls::stream<mac_data_axis> tcp_tx;
+	hls::stream<mac_data_axis> ip_tx;
+	hls::stream<mac_data_axis> multicast_rx;
+	ap_uint<64> multicast_hash;
+
+	EthernetServiceConfig config = {
+		"0xaabbccddeeff",	// hwaddr
+		"0xc0a80402",		// ipaddr
+		5001,				// tcp_port
+		"0xfd000000000000040000000000000002",	// ipv6addr
+	};
+
+	// SYN -> SYN-ACK
+	// The options of the SYN from Linux (MSS, SACK permitted, timestamps, window scale) run to the end of the frame.
+	write_frame(in, rx_timestamp, build_tcp_frame(1000, 0, 0x02, {}, {
+		0x02, 0x04, 0x05, 0xb4, 0x04, 0x02, 0x08, 0x0a, 0x00, 0x01, 0x02, 0x03, 0x00, 0x00, 0x00, 0x00, 0x01, 0x03, 0x03, 0x07,
+	}));
+	ethernet_service(config, 0x12345678, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	auto syn_ack = read_frame(out);
+	if( syn_ack.size() != 58 || syn_ack[47] != 0x12 || (syn_ack[46] >> 4) != 6 ) {
+		std::printf("unexpected SYN-ACK\n");
+		return false;
+	}
+	std::uint32_t seq = (syn_ack[38] << 24) | (syn_ack[39] << 16) | (syn_ack[40] << 8) | syn_ack[41];
+	std::uint32_t ack = (syn_ack[42] << 24) | (syn_ack[43] << 16) | (syn_ack[44] << 8) | syn_ack[45];
+	if( ack != 1001 || checksum16(syn_ack, 34, 24, checksum16(syn_ack, 26, 8) + 0x06 + 24) != 0xffff ) {
+		std::printf("invalid SYN-ACK ack=%u\n", ack);
+		return false;
+	}
+
+	// ACK + data -> payload on tcp_rx, ACK
+	write_frame(in, rx_timestamp, build_tcp_frame(1001, seq + 1, 0x18, {'h', 'e', 'l', 'l', 'o'}));
+	ethernet_service(config, 0x12345680, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	std::vector<std::uint8_t> expected_payload = {'h', 'e', 'l', 'l', 'o'};
+	if( read_frame(tcp_rx) != expected_payload ) {
+		std::printf("unexpected TCP payload\n");
+		return false;
+	}
+	auto data_ack = read_frame(out);
+	ack = (data_ack[42] << 24) | (data_ack[43] << 16) | (data_ack[44] << 8) | data_ack[45];
+	if( data_ack.size() != 54 || ack != 1006 ) {
+		std::printf("unexpected ACK for data ack=%u\n", ack);
+		return false;
+	}
+
+	// Data from tcp_tx is sent while no frame is received.
+	write_array(tcp_tx, {'w', 'o', 'r', 'l', 'd', '!'});
+	ethernet_service(config, 0x12345690, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	auto data = read_frame(out);
+	if( data.size() != 60 || data[47] != 0x18 || std::vector<std::uint8_t>(data.begin() + 54, data.end()) != std::vector<std::uint8_t>({'w', 'o', 'r', 'l', 'd', '!'})
+	 || checksum16(data, 34, 26, checksum16(data, 26, 8) + 0x06 + 26) != 0xffff ) {
+		std::printf("unexpected data segment\n");
+		return false;
+	}
+
+	// No ACK from the peer, the segment is retransmitted.
+	ethernet_service(config, 0x12345690 + TIMER_HZ, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	ethernet_service(config, 0x12345690 + TIMER_HZ, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	auto retransmitted = read_frame(out);
+	if( retransmitted.size() != data.size() || !std::equal(data.begin() + 34, data.end(), retransmitted.begin() + 34) ) {
+		std::printf("segment is not retransmitted\n");
+		return false;
+	}
+
+	// FIN -> FIN-ACK
+	write_frame(in, rx_timestamp, build_tcp_frame(1006, seq + 7, 0x11, {}));
+	ethernet_service(config, 0x12345700 + TIMER_HZ, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	auto fin_ack = read_frame(out);
+	if( fin_ack.size() != 54 || fin_ack[47] != 0x11 ) {
+		std::printf("unexpected FIN-ACK\n");
+		return false;
+	}
+	return out.empty() && tcp_rx.empty();
+}
+
+// Full segments arrive back-to-back while tcp_rx is looped back to tcp_tx.
+// tcp_tx must be drained while frames are still arriving, and the window must reflect the RX buffer.
+bool run_tcp_loopback_test()
+{
+	hls::stream<timestamp_axis> rx_timestamp;
+	hls::stream<mac_data_axis> in;
+	hls::stream<mac_data_axis> out;
+	hls::stream<mac_data_axis> tcp_rx;
+	hls::stream<mac_data_axis> tcp_tx;
+	hls::stream<mac_data_axis> ip_tx;
+	hls::stream<mac_data_axis> multicast_rx;
+	ap_uint<64> multicast_hash;
+
+	EthernetServiceConfig config = {
+		"0xaabbccddeeff",	// hwaddr
+		"0xc0a80402",		// ipaddr
+		5001,				// tcp_port
+		"0xfd000000000000040000000000000002",	// ipv6addr
+	};
+	const std::size_t segments = 4;
+	const std::size_t mss = 1460;
+
+	// Reset the connection left by the previous test, then SYN -> SYN-ACK
+	write_frame(in, rx_timestamp, build_tcp_frame(0, 0, 0x04, {}));
+	write_frame(in, rx_timestamp, build_tcp_frame(5000, 0, 0x02, {}, {0x02, 0x04, 0x05, 0xb4}));
+	ethernet_service(config, 0, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	ethernet_service(config, 0, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	auto syn_ack = read_frame(out);
+	if( syn_ack.size() != 58 || syn_ack[47] != 0x12 ) {
+		std::printf("unexpected SYN-ACK\n");
+		return false;
+	}
+	std::uint32_t seq = ((syn_ack[38] << 24) | (syn_ack[39] << 16) | (syn_ack[40] << 8) | syn_ack[41]) + 1;
+	std::uint32_t right_edge = 5001 + ((syn_ack[48] << 8) | syn_ack[49]);
+
+	std::vector<std::uint8_t> sent;
+	for(std::size_t i = 0; i < segments; i++) {
+		std::vector<std::uint8_t> payload(mss);
+		for(std::size_t j = 0; j < mss; j++) payload[j] = static_cast<std::uint8_t>(i * 7 + j);
+		write_frame(in, rx_timestamp, build_tcp_frame(5001 + i * mss, seq, 0x18, payload));
+		sent.insert(sent.end(), payload.begin(), payload.end());
+	}
+
+	std::vector<std::uint8_t> received;
+	for(std::size_t i = 0; i < segments; i++) {
+		ethernet_service(config, 1, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+		if( !tcp_tx.empty() ) {
+			std::printf("tcp_tx is not drained while frames are received\n");
+			return false;
+		}
+		auto ack_frame = read_frame(out);
+		std::uint32_t ack = (ack_frame[42] << 24) | (ack_frame[43] << 16) | (ack_frame[44] << 8) | ack_frame[45];
+		std::uint16_t window = (ack_frame[48] << 8) | ack_frame[49];
+		if( ack_frame.size() != 54 || ack != 5001 + (i + 1) * mss || window < mss || static_cast<std::int32_t>(ack + window - right_edge) < 0 ) {
+			std::printf("unexpected ACK for segment %ld ack=%u window=%u\n", i, ack, window);
+			return false;
+		}
+		right_edge = ack + window;
+		// Each segment is delivered as one frame and looped back.
+		auto segment = read_frame(tcp_rx);
+		if( segment.size() != mss ) {
+			std::printf("unexpected segment length %ld on tcp_rx\n", segment.size());
+			return false;
+		}
+		received.insert(received.end(), segment.begin(), segment.end());
+		write_array(tcp_tx, segment);
+	}
+	if( received != sent || !in.empty() ) {
+		std::printf("unexpected payload on tcp_rx\n");
+		return false;
+	}
+
+	// The looped back bytes are sent back in full segments.
+	std::vector<std::uint8_t> echoed;
+	for(std::size_t i = 0; i < segments; i++) {
+		ethernet_service(config, 2, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+		auto data = read_frame(out);
+		if( data.size() != 54 + mss || data[47] != 0x18 ) {
+			std::printf("unexpected echoed segment %ld\n", i);
+			return false;
+		}
+		echoed.insert(echoed.end(), data.begin() + 54, data.end());
+	}
+	if( echoed != sent ) {
+		std::printf("unexpected echoed payload\n");
+		return false;
+	}
+
+	write_frame(in, rx_timestamp, build_tcp_frame(5001 + segments * mss, seq, 0x04, {}));
+	ethernet_service(config, 3, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	return out.empty() && tcp_rx.empty() && tcp_tx.empty();
+}
+
+static std::vector<std::uint8_t> build_icmpv6_frame(const std::vector<std::uint8_t>& destination_hwaddr, const std::vector<std::uint8_t>& source, const std::vector<std::uint8_t>& destination, std::uint8_t hop_limit, const std::vector<std::uint8_t>& message)
+{
+	std::vector<std::uint8_t> frame = destination_hwaddr;
+	frame.insert(frame.end(), {0x02, 0x00, 0x00, 0x00, 0x00, 0x01, 0x86, 0xdd});
+	frame.insert(frame.end(), {0x60, 0x00, 0x00, 0x00, static_cast<std::uint8_t>(message.size() >> 8), static_cast<std::uint8_t>(message.size()), 58, hop_limit});
+	frame.insert(frame.end(), source.begin(), source.end());
+	frame.insert(frame.end(), destination.begin(), destination.end());
+	frame.insert(frame.end(), message.begin(), message.end());
+	auto checksum = ~checksum16(frame, 54, message.size(), checksum16(frame, 22, 32) + 58 + message.size());
+	frame[56] = checksum >> 8;
+	frame[57] = checksum & 0xff;
+	return frame;
+}
+
+static bool verify_icmpv6_checksum(const std::vector<std::uint8_t>& frame)
+{
+	std::size_t length = (frame[18] << 8) | frame[19];
+	return frame.size() >= 54 + length && checksum16(frame, 54, length, checksum16(frame, 22, 32) + 58 + length) == 0xffff;
+}
+
+bool run_ipv6_test()
+{
+	hls::stream<timestamp_axis> rx_timestamp;
+	hls::stream<mac_data_axis> in;
+	hls::stream<mac_data_axis> out;
+	hls::stream<mac_data_axis> tcp_rx;
+	hls::stream<mac_data_axis> tcp_tx;
+	hls::stream<mac_data_axis> ip_tx;
+	hls::stream<mac_data_axis> multicast_rx;
+	ap_uint<64> multicast_hash;
+
+	EthernetServiceConfig config = {
+		"0xaabbccddeeff",	// hwaddr
+		"0xc0a80402",		// ipaddr
+		5001,				// tcp_port
+		"0xfd000000000000040000000000000002",	// ipv6addr
+	};
+	std::vector<std::uint8_t> peer = {0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0x00, 0x00, 0x00, 0xff, 0xfe, 0x00, 0x00, 0x01};
+	std::vector<std::uint8_t> link_local = {0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0xa8, 0xbb, 0xcc, 0xff, 0xfe, 0xdd, 0xee, 0xff};
+	std::vector<std::uint8_t> global = {0xfd, 0x00, 0, 0, 0, 0, 0, 0x04, 0, 0, 0, 0, 0, 0, 0, 0x02};
+
+	// Neighbor Solicitation to the solicited-node multicast address of the global address.
+	{
+		std::vector<std::uint8_t> message = {135, 0, 0, 0, 0, 0, 0, 0};
+		message.insert(message.end(), global.begin(), global.end());
+		message.insert(message.end(), {1, 1, 0x02, 0x00, 0x00, 0x00, 0x00, 0x01});
+		write_frame(in, rx_timestamp, build_icmpv6_frame({0x33, 0x33, 0xff, 0x00, 0x00, 0x02}, peer, {0xff, 0x02, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01, 0xff, 0x00, 0x00, 0x02}, 255, message));
+		ethernet_service(config, 0, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+		auto advertisement = read_frame(out);
+		if( advertisement.size() != 86 || advertisement[54] != 136 || advertisement[58] != 0x60
+		 || !std::equal(global.begin(), global.end(), advertisement.begin() + 22)
+		 || !std::equal(global.begin(), global.end(), advertisement.begin() + 62)
+		 || advertisement[78] != 2 || advertisement[80] != 0xaa || advertisement[85] != 0xff
+		 || !verify_icmpv6_checksum(advertisement) ) {
+			std::printf("unexpected neighbor advertisement\n");
+			return false;
+		}
+	}
+	// Neighbor Solicitation for other address is ignored.
+	{
+		std::vector<std::uint8_t> message = {135, 0, 0, 0, 0, 0, 0, 0};
+		message.insert(message.end(), peer.begin(), peer.end());
+		write_frame(in, rx_timestamp, build_icmpv6_frame({0x33, 0x33, 0xff, 0x00, 0x00, 0x01}, peer, {0xff, 0x02, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01, 0xff, 0x00, 0x00, 0x01}, 255, message));
+		ethernet_service(config, 0, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+		if( !out.empty() || !in.empty() ) {
+			std::printf("neighbor solicitation for other address is not ignored\n");
+			return false;
+		}
+	}
+	// Echo request to the link-local address.
+	{
+		std::vector<std::uint8_t> message = {128, 0, 0, 0, 0x12, 0x34, 0x00, 0x01, 'p', 'i', 'n', 'g', '6'};
+		write_frame(in, rx_timestamp, build_icmpv6_frame({0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff}, peer, link_local, 64, message));
+		ethernet_service(config, 0, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+		auto reply = read_frame(out);
+		if( reply.size() != 54 + message.size() || reply[54] != 129
+		 || !std::equal(link_local.begin(), link_local.end(), reply.begin() + 22)
+		 || !std::equal(peer.begin(), peer.end(), reply.begin() + 38)
+		 || !std::equal(message.begin() + 4, message.end(), reply.begin() + 58)
+		 || !verify_icmpv6_checksum(reply) ) {
+			std::printf("unexpected echo reply\n");
+			return false;
+		}
+	}
+	return out.empty();
+}
+
+static std::vector<std::uint8_t> build_arp_request(const std::vector<std::uint8_t>& tags, const std::vector<std::uint8_t>& target)
+{
+	std::vector<std::uint8_t> frame = {
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff,	// destination
+		0x02, 0x00, 0x00, 0x00, 0x00, 0x01,	// source
+	};
+	frame.insert(frame.end(), tags.begin(), tags.end());
+	frame.insert(frame.end(), {
+		0x08, 0x06,
+		0x00, 0x01, 0x08, 0x00, 0x06, 0x04, 0x00, 0x01,
+		0x02, 0x00, 0x00, 0x00, 0x00, 0x01, 0xc0, 0xa8, 0x0a, 0x01,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	});
+	frame.insert(frame.end(), target.begin(), target.end());
+	return frame;
+}
+
+bool run_vlan_test()
+{
+	hls::stream<timestamp_axis> rx_timestamp;
+	hls::stream<mac_data_axis> in;
+	hls::stream<mac_data_axis> out;
+	hls::stream<mac_data_axis> tcp_rx;
+	hls::stream<mac_data_axis> tcp_tx;
+	hls::stream<mac_data_axis> ip_tx;
+	hls::stream<mac_data_axis> multicast_rx;
+	ap_uint<64> multicast_hash;
+
+	EthernetServiceConfig config = {
+		"0xaabbccddeeff",	// hwaddr
+		"0xc0a80402",		// ipaddr
+		5001,				// tcp_port
+		"0xfd000000000000040000000000000002",	// ipv6addr
+		{
+			{"0x02000000000a", "0xc0a80a02", 10, 0},	// VLAN 10
+			{"0x020000000014", "0xc0a81402", 20, 100},	// VLAN 100/20
+		},
+	};
+
+	// Single tagged ARP request is answered with the identity of VLAN 10.
+	write_frame(in, rx_timestamp, build_arp_request({0x81, 0x00, 0x20, 0x0a}, {0xc0, 0xa8, 0x0a, 0x02}));
+	ethernet_service(config, 0, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	auto reply = read_frame(out);
+	std::vector<std::uint8_t> expected_header = {
+		0x02, 0x00, 0x00, 0x00, 0x00, 0x01,
+		0x02, 0x00, 0x00, 0x00, 0x00, 0x0a,
+		0x81, 0x00, 0x20, 0x0a,
+		0x08, 0x06,
+	};
+	if( reply.size() != 46 || !std::equal(expected_header.begin(), expected_header.end(), reply.begin()) || reply[31] != 0x0a || reply[34] != 0x0a ) {
+		std::printf("unexpected ARP reply on VLAN 10\n");
+		return false;
+	}
+
+	// Double tagged ARP request is answered with both tags.
+	write_frame(in, rx_timestamp, build_arp_request({0x88, 0xa8, 0x00, 0x64, 0x81, 0x00, 0x00, 0x14}, {0xc0, 0xa8, 0x14, 0x02}));
+	ethernet_service(config, 0, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	reply = read_frame(out);
+	expected_header = {
+		0x02, 0x00, 0x00, 0x00, 0x00, 0x01,
+		0x02, 0x00, 0x00, 0x00, 0x00, 0x14,
+		0x88, 0xa8, 0x00, 0x64, 0x81, 0x00, 0x00, 0x14,
+		0x08, 0x06,
+	};
+	if( reply.size() != 50 || !std::equal(expected_header.begin(), expected_header.end(), reply.begin()) ) {
+		std::printf("unexpected ARP reply on VLAN 100/20\n");
+		return false;
+	}
+
+	// Priority tagged (VLAN ID 0) ARP request is answered as untagged.
+	write_frame(in, rx_timestamp, build_arp_request({0x81, 0x00, 0xa0, 0x00}, {0xc0, 0xa8, 0x04, 0x02}));
+	ethernet_service(config, 0, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	reply = read_frame(out);
+	expected_header = {
+		0x02, 0x00, 0x00, 0x00, 0x00, 0x01,
+		0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+		0x08, 0x06,
+	};
+	if( reply.size() != 42 || !std::equal(expected_header.begin(), expected_header.end(), reply.begin()) || reply[31] != 0x02 ) {
+		std::printf("unexpected ARP reply to priority tagged request\n");
+		return false;
+	}
+
+	// Frames on unknown VLANs are ignored.
+	write_frame(in, rx_timestamp, build_arp_request({0x81, 0x00, 0x00, 0x14}, {0xc0, 0xa8, 0x14, 0x02}));
+	ethernet_service(config, 0, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	if( !out.empty() || !in.empty() ) {
+		std::printf("frame on unknown VLAN is not ignored\n");
+		return false;
+	}
+	return true;
+}
+
+static std::vector<std::uint8_t> build_ntp_request(std::uint8_t version, std::uint64_t transmit_timestamp)
+{
+	std::vector<std::uint8_t> frame = {
+		0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,	// destination
+		0x02, 0x00, 0x00, 0x00, 0x00, 0x01,	// source
+		0x08, 0x00,
+		// IPv4
+		0x45, 0x00, 0x00, 0x4c, 0x00, 0x00, 0x40, 0x00, 0x40, 0x11, 0x00, 0x00,
+		0xc0, 0xa8, 0x04, 0x01,
+		0xc0, 0xa8, 0x04, 0x02,
+		// UDP
+		0xd4, 0x31, 0x00, 0x7b, 0x00, 0x38, 0x00, 0x00,
+		// NTP
+		static_cast<std::uint8_t>((version << 3) | 3), 0x00, 0x06, 0xec,
+	};
+	frame.resize(frame.size() + 36, 0);
+	for(std::size_t i = 0; i < 8; i++) {
+		frame.push_back(static_cast<std::uint8_t>(transmit_timestamp >> (56 - i*8)));
+	}
+	auto ip_checksum = ~checksum16(frame, 14, 20);
+	frame[24] = ip_checksum >> 8;
+	frame[25] = ip_checksum & 0xff;
+	return frame;
+}
+
+static std::uint64_t read64be(const std::vector<std::uint8_t>& data, std::size_t offset)
+{
+	std::uint64_t value = 0;
+	for(std::size_t i = 0; i < 8; i++) {
+		value = (value << 8) | data[offset + i];
+	}
+	return value;
+}
+
+bool run_ntp_test()
+{
+	hls::stream<timestamp_axis> rx_timestamp;
+	hls::stream<mac_data_axis> in;
+	hls::stream<mac_data_axis> out;
+	hls::stream<mac_data_axis> tcp_rx;
+	hls::stream<mac_data_axis> tcp_tx;
+	hls::stream<mac_data_axis> ip_tx;
+	hls::stream<mac_data_axis> multicast_rx;
+	ap_uint<64> multicast_hash;
+
+	EthernetServiceConfig config = {
+		"0xaabbccddeeff",	// hwaddr
+		"0xc0a80402",		// ipaddr
+		5001,				// tcp_port
+		"0xfd000000000000040000000000000002",	// ipv6addr
+		{},
+		0x50505300,			// ntp_reference_id ("PPS")
+		1,					// ntp_stratum
+	};
+
+	// 2021-01-01T00:00:00.5Z
+	write_frame(in, rx_timestamp, build_ntp_request(4, 0x0123456789abcdefULL), make_timestamp(1609459200, 500000000, true));
+	ethernet_service(config, 0, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	auto reply = read_frame(out);
+	if( reply.size() != 90 || reply[23] != 0x11 || reply[30] != 0xc0 || reply[33] != 0x01 ) {
+		std::printf("unexpected NTP reply IP header\n");
+		return false;
+	}
+	if( checksum16(reply, 14, 20) != 0xffff ) {
+		std::printf("invalid IP checksum of NTP reply\n");
+		return false;
+	}
+	if( reply[34] != 0x00 || reply[35] != 0x7b || reply[36] != 0xd4 || reply[37] != 0x31 || reply[38] != 0x00 || reply[39] != 0x38 || reply[40] != 0x00 || reply[41] != 0x00 ) {
+		std::printf("unexpected NTP reply UDP header\n");
+		return false;
+	}
+	const std::size_t ntp = 42;
+	std::uint64_t expected_receive = (static_cast<std::uint64_t>(1609459200UL + 2208988800UL) << 32) | 0x80000000UL;
+	if( reply[ntp + 0] != 0x24 || reply[ntp + 1] != 1 || reply[ntp + 2] != 0x06 || reply[ntp + 3] != 0xe8
+	 || reply[ntp + 12] != 'P' || reply[ntp + 13] != 'P' || reply[ntp + 14] != 'S' || reply[ntp + 15] != 0 ) {
+		std::printf("unexpected NTP reply header\n");
+		return false;
+	}
+	if( read64be(reply, ntp + 24) != 0x0123456789abcdefULL ) {
+		std::printf("origin timestamp of NTP reply is not the transmit timestamp of the request\n");
+		return false;
+	}
+	if( read64be(reply, ntp + 32) != expected_receive || read64be(reply, ntp + 40) != expected_receive ) {
+		std::printf("unexpected receive timestamp %016llx\n", static_cast<unsigned long long>(read64be(reply, ntp + 32)));
+		return false;
+	}
+
+	// The reply tells the client that the server is not synchronized while the time base is not locked.
+	write_frame(in, rx_timestamp, build_ntp_request(3, 0), make_timestamp(1609459200, 0, false));
+	ethernet_service(config, 0, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	reply = read_frame(out);
+	if( reply.size() != 90 || reply[ntp + 0] != 0xdc || reply[ntp + 1] != 16 ) {
+		std::printf("unexpected NTP reply while unlocked\n");
+		return false;
+	}
+
+	// Broadcast mode packets are ignored.
+	auto broadcast = build_ntp_request(4, 0);
+	broadcast[ntp] = 0x25;
+	write_frame(in, rx_timestamp, broadcast, make_timestamp(1609459200, 0, true));
+	ethernet_service(config, 0, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	if( !out.empty() || !in.empty() || !rx_timestamp.empty() ) {
+		std::printf("NTP broadcast packet is not ignored\n");
+		return false;
+	}
+	return true;
+}
+
+static std::vector<std::uint8_t> build_udp_packet(const std::vector<std::uint8_t>& destination)
+{
+	std::vector<std::uint8_t> packet = {
+		// IPv4
+		0x45, 0x00, 0x00, 0x20, 0x00, 0x00, 0x40, 0x00, 0x40, 0x11, 0x00, 0x00,
+		0xc0, 0xa8, 0x04, 0x02,
+	};
+	packet.insert(packet.end(), destination.begin(), destination.end());
+	// UDP
+	packet.insert(packet.end(), {0x30, 0x39, 0x30, 0x39, 0x00, 0x0c, 0x00, 0x00, 'p', 'l', 't', 'x'});
+	auto ip_checksum = ~checksum16(packet, 0, 20);
+	packet[10] = ip_checksum >> 8;
+	packet[11] = ip_checksum & 0xff;
+	return packet;
+}
+
+static std::vector<std::uint8_t> build_arp_reply(const std::vector<std::uint8_t>& sender_hwaddr, const std::vector<std::uint8_t>& sender)
+{
+	std::vector<std::uint8_t> frame = {0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+	frame.insert(frame.end(), sender_hwaddr.begin(), sender_hwaddr.end());
+	frame.insert(frame.end(), {0x08, 0x06, 0x00, 0x01, 0x08, 0x00, 0x06, 0x04, 0x00, 0x02});
+	frame.insert(frame.end(), sender_hwaddr.begin(), sender_hwaddr.end());
+	frame.insert(frame.end(), sender.begin(), sender.end());
+	frame.insert(frame.end(), {0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0xc0, 0xa8, 0x04, 0x02});
+	frame.resize(60, 0);
+	return frame;
+}
+
+static bool is_arp_request_for(const std::vector<std::uint8_t>& frame, const std::vector<std::uint8_t>& target)
+{
+	std::vector<std::uint8_t> expected = {
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+		0x08, 0x06, 0x00, 0x01, 0x08, 0x00, 0x06, 0x04, 0x00, 0x01,
+		0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0xc0, 0xa8, 0x04, 0x02,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	};
+	expected.insert(expected.end(), target.begin(), target.end());
+	return frame.size() == 42 && std::equal(expected.begin(), expected.end(), frame.begin());
+}
+
+bool run_arp_cache_test()
+{
+	hls::stream<timestamp_axis> rx_timestamp;
+	hls::stream<mac_data_axis> in;
+	hls::stream<mac_data_axis> out;
+	hls::stream<mac_data_axis> tcp_rx;
+	hls::stream<mac_data_axis> tcp_tx;
+	hls::stream<mac_data_axis> ip_tx;
+	hls::stream<mac_data_axis> multicast_rx;
+	ap_uint<64> multicast_hash;
+
+	EthernetServiceConfig config = {
+		"0xaabbccddeeff",	// hwaddr
+		"0xc0a80402",		// ipaddr
+		0,					// tcp_port
+		0,					// ipv6addr
+		{},
+		0,					// ntp_reference_id
+		0,					// ntp_stratum
+		"0xffffff00",		// ip_netmask
+		"0xc0a80401",		// gateway_address
+	};
+	std::vector<std::uint8_t> peer = {0xc0, 0xa8, 0x04, 0x0a};
+	std::vector<std::uint8_t> peer_hwaddr = {0x02, 0x00, 0x00, 0x00, 0x00, 0x0a};
+	std::vector<std::uint8_t> gateway = {0xc0, 0xa8, 0x04, 0x01};
+	std::vector<std::uint8_t> gateway_hwaddr = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+	std::uint32_t timer = 0x80000000;
+
+	// Expire the entries learned by the other tests, and let the TCP connection left by them time out.
+	for(std::size_t i = 0; i < 16; i++) {
+		ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+		while( !out.empty() ) read_frame(out);
+		timer += TIMER_HZ;
+	}
+
+	// A packet to an unknown host on the local network is held and the host is resolved.
+	auto packet = build_udp_packet(peer);
+	write_array(ip_tx, packet);
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	if( !is_arp_request_for(read_frame(out), peer) ) {
+		std::printf("ARP request for the local host is not sent\n");
+		return false;
+	}
+	ethernet_service(config, timer + 1, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	if( !out.empty() ) {
+		std::printf("ARP request is sent again before the interval\n");
+		return false;
+	}
+	write_frame(in, rx_timestamp, build_arp_reply(peer_hwaddr, peer));
+	ethernet_service(config, timer + 2, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	ethernet_service(config, timer + 3, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	auto frame = read_frame(out);
+	std::vector<std::uint8_t> expected_header = peer_hwaddr;
+	expected_header.insert(expected_header.end(), {0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0x08, 0x00});
+	if( frame.size() != 14 + packet.size() || !std::equal(expected_header.begin(), expected_header.end(), frame.begin()) || !std::equal(packet.begin(), packet.end(), frame.begin() + 14) ) {
+		std::printf("held packet is not sent to the resolved host\n");
+		return false;
+	}
+
+	// The gateway is learned from an IP packet and packets to other networks are sent to it.
+	write_frame(in, rx_timestamp, build_ntp_request(4, 0));
+	ethernet_service(config, timer + 4, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	packet = build_udp_packet({0x08, 0x08, 0x08, 0x08});
+	write_array(ip_tx, packet);
+	ethernet_service(config, timer + 5, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	frame = read_frame(out);
+	if( frame.size() != 14 + packet.size() || !std::equal(gateway_hwaddr.begin(), gateway_hwaddr.end(), frame.begin()) || !std::equal(packet.begin(), packet.end(), frame.begin() + 14) ) {
+		std::printf("packet to other network is not sent to the gateway\n");
+		return false;
+	}
+
+	// Entries expire and the host is resolved again.
+	timer += 61 * TIMER_HZ;
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	write_array(ip_tx, build_udp_packet(gateway));
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	if( !is_arp_request_for(read_frame(out), gateway) ) {
+		std::printf("ARP request for the expired entry is not sent\n");
+		return false;
+	}
+
+	// The request is repeated every second and the packet is dropped after 3 requests.
+	for(std::uint32_t i = 1; i < 3; i++) {
+		ethernet_service(config, timer + i * TIMER_HZ, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+		if( !is_arp_request_for(read_frame(out), gateway) ) {
+			std::printf("ARP request is not repeated\n");
+			return false;
+		}
+	}
+	ethernet_service(config, timer + 3 * TIMER_HZ, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	write_frame(in, rx_timestamp, build_arp_reply(gateway_hwaddr, gateway));
+	ethernet_service(config, timer + 3 * TIMER_HZ, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	ethernet_service(config, timer + 3 * TIMER_HZ, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	if( !out.empty() ) {
+		std::printf("packet to the unreachable host is not dropped\n");
+		return false;
+	}
+	return in.empty() && ip_tx.empty();
+}
+
+static std::vector<std::uint8_t> build_multicast_udp_frame(const std::vector<std::uint8_t>& group, std::uint16_t port, const std::vector<std::uint8_t>& payload)
+{
+	std::vector<std::uint8_t> frame = {
+		0x01, 0x00, 0x5e, static_cast<std::uint8_t>(group[1] & 0x7f), group[2], group[3],	// destination
+		0x02, 0x00, 0x00, 0x00, 0x00, 0x01,	// source
+		0x08, 0x00,
+		// IPv4
+		0x45, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x01, 0x11, 0x00, 0x00,
+		0xc0, 0xa8, 0x04, 0x01,
+	};
+	frame.insert(frame.end(), group.begin(), group.end());
+	std::size_t udp_length = 8 + payload.size();
+	frame.insert(frame.end(), {0x12, 0x34, static_cast<std::uint8_t>(port >> 8), static_cast<std::uint8_t>(port), static_cast<std::uint8_t>(udp_length >> 8), static_cast<std::uint8_t>(udp_length), 0x00, 0x00});
+	frame.insert(frame.end(), payload.begin(), payload.end());
+	std::size_t ip_length = 20 + udp_length;
+	frame[16] = ip_length >> 8;
+	frame[17] = ip_length & 0xff;
+	auto ip_checksum = ~checksum16(frame, 14, 20);
+	frame[24] = ip_checksum >> 8;
+	frame[25] = ip_checksum & 0xff;
+	while( frame.size() < 60 ) frame.push_back(0);
+	return frame;
+}
+
+// IGMPv2 (8 octets) or IGMPv3 (12 octets) membership query with the Router Alert option.
+static std::vector<std::uint8_t> build_igmp_query(bool v3, const std::vector<std::uint8_t>& group, std::uint8_t max_response_code)
+{
+	std::vector<std::uint8_t> destination = group[0] == 0 ? std::vector<std::uint8_t>({224, 0, 0, 1}) : group;
+	std::vector<std::uint8_t> frame = {
+		0x01, 0x00, 0x5e, static_cast<std::uint8_t>(destination[1] & 0x7f), destination[2], destination[3],
+		0x02, 0x00, 0x00, 0x00, 0x00, 0x01,
+		0x08, 0x00,
+		0x46, 0xc0, 0x00, static_cast<std::uint8_t>(v3 ? 36 : 32), 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x00, 0x00,
+		0xc0, 0xa8, 0x04, 0x01,
+	};
+	frame.insert(frame.end(), destination.begin(), destination.end());
+	frame.insert(frame.end(), {0x94, 0x04, 0x00, 0x00});
+	frame.insert(frame.end(), {0x11, max_response_code, 0x00, 0x00});
+	frame.insert(frame.end(), group.begin(), group.end());
+	if( v3 ) {
+		frame.insert(frame.end(), {0x02, 125, 0x00, 0x00});
+	}
+	auto ip_checksum = ~checksum16(frame, 14, 24);
+	frame[24] = ip_checksum >> 8;
+	frame[25] = ip_checksum & 0xff;
+	auto igmp_checksum = ~checksum16(frame, 38, v3 ? 12 : 8);
+	frame[40] = igmp_checksum >> 8;
+	frame[41] = igmp_checksum & 0xff;
+	while( frame.size() < 60 ) frame.push_back(0);
+	return frame;
+}
+
+// Check an IGMP report. v3 reports have a single group record.
+static bool is_igmp_report(const std::vector<std::uint8_t>& frame, bool v3, const std::vector<std::uint8_t>& group, std::uint8_t record_type = 0)
+{
+	std::vector<std::uint8_t> destination = v3 ? std::vector<std::uint8_t>({224, 0, 0, 22}) : group;
+	std::size_t igmp_length = v3 ? 16 : 8;
+	std::vector<std::uint8_t> expected_header = {
+		0x01, 0x00, 0x5e, static_cast<std::uint8_t>(destination[1] & 0x7f), destination[2], destination[3],
+		0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+		0x08, 0x00, 0x46,
+	};
+	if( frame.size() != 14 + 24 + igmp_length || !std::equal(expected_header.begin(), expected_header.end(), frame.begin())
+	 || frame[22] != 1 || frame[23] != 0x02 || !std::equal(destination.begin(), destination.end(), frame.begin() + 30)
+	 || frame[34] != 0x94 || frame[35] != 0x04 || checksum16(frame, 14, 24) != 0xffff || checksum16(frame, 38, igmp_length) != 0xffff ) {
+		return false;
+	}
+	if( v3 ) {
+		return frame[38] == 0x22 && frame[45] == 1 && frame[46] == record_type && std::equal(group.begin(), group.end(), frame.begin() + 50);
+	}
+	return frame[38] == 0x16 && std::equal(group.begin(), group.end(), frame.begin() + 42);
+}
+
+bool run_multicast_test()
+{
+	hls::stream<timestamp_axis> rx_timestamp;
+	hls::stream<mac_data_axis> in;
+	hls::stream<mac_data_axis> out;
+	hls::stream<mac_data_axis> tcp_rx;
+	hls::stream<mac_data_axis> tcp_tx;
+	hls::stream<mac_data_axis> ip_tx;
+	hls::stream<mac_data_axis> multicast_rx;
+	ap_uint<64> multicast_hash;
+
+	EthernetServiceConfig config = {
+		"0xaabbccddeeff",	// hwaddr
+		"0xc0a80402",		// ipaddr
+		0,					// tcp_port
+		0,					// ipv6addr
+		{},
+		0,					// ntp_reference_id
+		0,					// ntp_stratum
+		"0xffffff00",		// ip_netmask
+		0,					// gateway_address
+		{
+			{"0xef010101", 5000},	// 239.1.1.1 to multicast_rx
+			{"0xef020202", 0},		// 239.2.2.2 to the PS
+		},
+		3,					// igmp_version
+	};
+	std::vector<std::uint8_t> pl_group = {239, 1, 1, 1};
+	std::vector<std::uint8_t> ps_group = {239, 2, 2, 2};
+	std::uint32_t timer = 0x10000000;
+
+	// Only the group of the PS is passed by the filter of the MAC.
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	std::uint32_t ps_group_value = 0x020202;
+	std::uint32_t hash_index = (ps_group_value ^ (ps_group_value >> 6) ^ (ps_group_value >> 12) ^ (ps_group_value >> 18)) & 0x3f;
+	if( multicast_hash != (ap_uint<64>(1) << hash_index) ) {
+		std::printf("unexpected multicast hash table\n");
+		return false;
+	}
+
+	// Groups are joined with 2 unsolicited reports.
+	if( !is_igmp_report(read_frame(out), true, pl_group, 4) ) {
+		std::printf("unexpected IGMPv3 report of the first group\n");
+		return false;
+	}
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	if( !is_igmp_report(read_frame(out), true, ps_group, 4) ) {
+		std::printf("unexpected IGMPv3 report of the second group\n");
+		return false;
+	}
+	ethernet_service(config, timer + 1, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	if( !out.empty() ) {
+		std::printf("IGMP report is repeated before the interval\n");
+		return false;
+	}
+	timer += TIMER_HZ;
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	if( !is_igmp_report(read_frame(out), true, pl_group, 4) || !is_igmp_report(read_frame(out), true, ps_group, 4) || !out.empty() ) {
+		std::printf("unexpected repeated IGMPv3 reports\n");
+		return false;
+	}
+
+	// IGMPv3 group specific query is answered within the maximum response time (1[s]).
+	write_frame(in, rx_timestamp, build_igmp_query(true, ps_group, 10));
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	timer += TIMER_HZ;
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	if( !is_igmp_report(read_frame(out), true, ps_group, 2) || !out.empty() ) {
+		std::printf("unexpected report for IGMPv3 query\n");
+		return false;
+	}
+
+	// IGMPv2 general query switches the reports to IGMPv2.
+	write_frame(in, rx_timestamp, build_igmp_query(false, {0, 0, 0, 0}, 10));
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	timer += TIMER_HZ;
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	if( !is_igmp_report(read_frame(out), false, pl_group) || !is_igmp_report(read_frame(out), false, ps_group) || !out.empty() ) {
+		std::printf("unexpected reports for IGMPv2 query\n");
+		return false;
+	}
+
+	// Datagrams to the port of the group are sent to multicast_rx.
+	write_frame(in, rx_timestamp, build_multicast_udp_frame(pl_group, 5000, {'t', 'i', 'c', 'k'}));
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	std::vector<std::uint8_t> expected = {239, 1, 1, 1, 192, 168, 4, 1, 0x12, 0x34, 0x13, 0x88, 't', 'i', 'c', 'k'};
+	if( read_frame(multicast_rx) != expected ) {
+		std::printf("unexpected datagram on multicast_rx\n");
+		return false;
+	}
+
+	// Other ports, groups of the PS and unknown groups are dropped.
+	write_frame(in, rx_timestamp, build_multicast_udp_frame(pl_group, 5001, {'x'}));
+	write_frame(in, rx_timestamp, build_multicast_udp_frame(ps_group, 5000, {'x'}));
+	write_frame(in, rx_timestamp, build_multicast_udp_frame({239, 3, 3, 3}, 5000, {'x'}));
+	for(std::size_t i = 0; i < 3; i++) {
+		ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	}
+	if( !multicast_rx.empty() || !out.empty() || !in.empty() ) {
+		std::printf("unexpected multicast datagram is not dropped\n");
+		return false;
+	}
+
+	// The IGMPv2 querier is considered present for 260[s], longer than the timer wraps around.
+	for(std::size_t i = 0; i < 257; i++) {
+		timer += TIMER_HZ;
+		ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	}
+	write_frame(in, rx_timestamp, build_igmp_query(true, {0, 0, 0, 0}, 10));
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	timer += TIMER_HZ;
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	if( !is_igmp_report(read_frame(out), false, pl_group) || !is_igmp_report(read_frame(out), false, ps_group) || !out.empty() ) {
+		std::printf("IGMPv2 querier expires early\n");
+		return false;
+	}
+	timer += TIMER_HZ;
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	write_frame(in, rx_timestamp, build_igmp_query(true, {0, 0, 0, 0}, 10));
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	timer += TIMER_HZ;
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	ethernet_service(config, timer, rx_timestamp, in, out, tcp_rx, tcp_tx, ip_tx, multicast_rx, multicast_hash);
+	if( !is_igmp_report(read_frame(out), true, pl_group, 2) || !is_igmp_report(read_frame(out), true, ps_group, 2) || !out.empty() ) {
+		std::printf("unexpected reports after the IGMPv2 querier expires\n");
+		return false;
+	}
+	return true;
+}
+
 int main(int argc, char* argv[])
 {
 	return run_test("arp")
 		//&& run_test("icmp")
 		&& run_test("icmp_dump")
+		&& run_tcp_test()
+		&& run_tcp_loopback_test()
+		&& run_ipv6_test()
+		&& run_vlan_test()
+		&& run_ntp_test()
+		&& run_arp_cache_test()
+		&& run_multicast_test()
 		? 0 : 1;
 }
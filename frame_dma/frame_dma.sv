@@ -0,0 +1,675 @@
+`default_nettype none
+
+// Descriptor ring DMA between frames in the DDR and byte streams, through a 32bit AXI4 master (an HP port of the PS).
+// There is a TX ring read to tx_maxis and an RX ring written from rx_saxis. Each descriptor is 16 bytes:
+//   +0x0 BUFFER   address of the buffer (4 byte aligned)
+//   +0x4 LENGTH   bit15-0: TX: bytes of the frame, RX: bytes of the buffer
+//   +0x8 STATUS   written by the DMA when the descriptor is done.
+//                 bit31: done, bit30: truncated (RX), bit29: error, bit15-0: bytes of the frame
+//   +0xc          not used by the DMA
+// The DMA owns the descriptors from HEAD to TAIL - 1 of a ring. The software fills descriptors and writes TAIL
+// once for all of them, and polls the done bits of the STATUS words or waits for the interrupt.
+// The DMA moves a frame at a time, preferring the RX ring, with up to 16 beats per burst.
+// A TX frame is read only when the TX FIFO has room for all of it, and is output without gaps.
+// An RX frame is stored in the RX FIFO before it is written, and frames with tuser or longer than MAX_FRAME_BYTES
+// are dropped there. A frame longer than the buffer is truncated. While there is no RX descriptor, the frames
+// wait in the RX FIFO and rx_saxis is stalled when it is full. While RX is disabled, the frames are dropped.
+//
+// Registers (32bit access only)
+//   0x00 CONTROL          RW  bit0: TX enable, bit1: RX enable. HEAD of a disabled ring is reset to 0 after its frame is done.
+//   0x04 STATUS           RW  bit0: TX done, bit1: RX done (write 1 to clear), bit8: TX busy, bit9: RX busy
+//   0x08 IRQ_ENABLE       RW  bit0: TX done, bit1: RX done
+//   0x10 TX_BASE          RW  address of the TX ring (16 byte aligned)
+//   0x14 TX_SIZE          RW  descriptors in the TX ring (write while disabled)
+//   0x18 TX_HEAD          R   next descriptor done by the DMA
+//   0x1c TX_TAIL          RW  descriptor after the last one given to the DMA
+//   0x20-0x2c             RX_BASE, RX_SIZE, RX_HEAD, RX_TAIL
+//   0x30 TX_FRAMES        R   TX descriptors done
+//   0x34 RX_FRAMES        R   RX descriptors done
+//   0x38 RX_DROPS         R   frames dropped by tuser, length or RX disabled
+//   0x3c BUS_ERRORS       R   error responses on the AXI4 master
+module frame_dma #(
+    parameter int FIFO_DEPTH_BITS = 9,          // 32bit words in each of the TX and RX FIFOs
+    parameter int MAX_FRAME_BYTES = 1522,       // Up to 4 * (2**FIFO_DEPTH_BITS - 1)
+    parameter int ADDR_BITS = 8
+) (
+    input wire clock,
+    input wire aresetn,
+
+    // Frames read from the TX ring
+    output wire [7:0] tx_maxis_tdata,
+    output wire       tx_maxis_tvalid,
+    input  wire       tx_maxis_tready,
+    output wire       tx_maxis_tlast,
+
+    // Frames written to the RX ring
+    input  wire [7:0] rx_saxis_tdata,
+    input  wire       rx_saxis_tvalid,
+    output wire       rx_saxis_tready,
+    input  wire       rx_saxis_tuser,
+    input  wire       rx_saxis_tlast,
+
+    output wire       interrupt,
+
+    output wire [31:0] m_axi_awaddr,
+    output wire  [7:0] m_axi_awlen,
+    output wire  [2:0] m_axi_awsize,
+    output wire  [1:0] m_axi_awburst,
+    output wire  [3:0] m_axi_awcache,
+    output wire  [2:0] m_axi_awprot,
+    output wire        m_axi_awvalid,
+    input  wire        m_axi_awready,
+    output wire [31:0] m_axi_wdata,
+    output wire  [3:0] m_axi_wstrb,
+    output wire        m_axi_wlast,
+    output wire        m_axi_wvalid,
+    input  wire        m_axi_wready,
+    input  wire  [1:0] m_axi_bresp,
+    input  wire        m_axi_bvalid,
+    output wire        m_axi_bready,
+    output wire [31:0] m_axi_araddr,
+    output wire  [7:0] m_axi_arlen,
+    output wire  [2:0] m_axi_arsize,
+    output wire  [1:0] m_axi_arburst,
+    output wire  [3:0] m_axi_arcache,
+    output wire  [2:0] m_axi_arprot,
+    output wire        m_axi_arvalid,
+    input  wire        m_axi_arready,
+    input  wire [31:0] m_axi_rdata,
+    input  wire  [1:0] m_axi_rresp,
+    input  wire        m_axi_rlast,
+    input  wire        m_axi_rvalid,
+    output wire        m_axi_rready,
+
+    input  wire  [ADDR_BITS-1:0] s_axi_awaddr,
+    input  wire                  s_axi_awvalid,
+    output logic                 s_axi_awready,
+    input  wire  [31:0]          s_axi_wdata,
+    input  wire  [3:0]           s_axi_wstrb,
+    input  wire                  s_axi_wvalid,
+    output logic                 s_axi_wready,
+    output logic [1:0]           s_axi_bresp,
+    output logic                 s_axi_bvalid,
+    input  wire                  s_axi_bready,
+    input  wire  [ADDR_BITS-1:0] s_axi_araddr,
+    input  wire                  s_axi_arvalid,
+    output logic                 s_axi_arready,
+    output logic [31:0]          s_axi_rdata,
+    output logic [1:0]           s_axi_rresp,
+    output logic                 s_axi_rvalid,
+    input  wire                  s_axi_rready
+);
+
+localparam int TX = 0;
+localparam int RX = 1;
+localparam int MAX_BURST_BEATS = 16;
+
+localparam int REG_CONTROL = 0;
+localparam int REG_STATUS = 1;
+localparam int REG_IRQ_ENABLE = 2;
+localparam int REG_TX_BASE = 4;
+localparam int REG_TX_SIZE = 5;
+localparam int REG_TX_HEAD = 6;
+localparam int REG_TX_TAIL = 7;
+localparam int REG_RX_BASE = 8;
+localparam int REG_RX_SIZE = 9;
+localparam int REG_RX_HEAD = 10;
+localparam int REG_RX_TAIL = 11;
+localparam int REG_TX_FRAMES = 12;
+localparam int REG_RX_FRAMES = 13;
+localparam int REG_RX_DROPS = 14;
+localparam int REG_BUS_ERRORS = 15;
+
+logic [1:0]  enable;
+logic [1:0]  irq_status;
+logic [1:0]  irq_enable;
+logic [1:0]  busy;
+logic [31:0] ring_base[2];
+logic [15:0] ring_size[2];
+logic [15:0] ring_head[2];
+logic [15:0] ring_tail[2];
+logic [31:0] tx_frame_count;
+logic [31:0] rx_frame_count;
+logic [31:0] rx_drop_count;
+logic [31:0] bus_error_count;
+
+assign interrupt = |(irq_status & irq_enable);
+
+// AXI4-Lite write
+logic write_enable;
+logic [ADDR_BITS-3:0] write_index;
+assign write_enable = s_axi_awvalid && s_axi_wvalid && !s_axi_bvalid;
+assign write_index = s_axi_awaddr[ADDR_BITS-1:2];
+assign s_axi_awready = write_enable;
+assign s_axi_wready = write_enable;
+assign s_axi_bresp = 2'b00;
+
+// STATUS is cleared by the transfer side.
+wire [1:0] irq_clear = write_enable && write_index == REG_STATUS ? s_axi_wdata[1:0] : 2'b00;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        s_axi_bvalid <= 0;
+        enable <= 0;
+        irq_enable <= 0;
+        for(int i = 0; i < 2; i++) begin
+            ring_base[i] <= 0;
+            ring_size[i] <= 1;
+            ring_tail[i] <= 0;
+        end
+    end
+    else begin
+        if( s_axi_bvalid && s_axi_bready ) begin
+            s_axi_bvalid <= 0;
+        end
+        if( write_enable ) begin
+            s_axi_bvalid <= 1;
+            case(write_index)
+            REG_CONTROL: enable <= s_axi_wdata[1:0];
+            REG_IRQ_ENABLE: irq_enable <= s_axi_wdata[1:0];
+            REG_TX_BASE: ring_base[TX] <= {s_axi_wdata[31:4], 4'b0};
+            REG_TX_SIZE: ring_size[TX] <= s_axi_wdata[15:0] != 0 ? s_axi_wdata[15:0] : 16'd1;
+            REG_TX_TAIL: ring_tail[TX] <= s_axi_wdata[15:0];
+            REG_RX_BASE: ring_base[RX] <= {s_axi_wdata[31:4], 4'b0};
+            REG_RX_SIZE: ring_size[RX] <= s_axi_wdata[15:0] != 0 ? s_axi_wdata[15:0] : 16'd1;
+            REG_RX_TAIL: ring_tail[RX] <= s_axi_wdata[15:0];
+            default: ;
+            endcase
+        end
+    end
+end
+
+// AXI4-Lite read
+logic [ADDR_BITS-3:0] read_index;
+assign read_index = s_axi_araddr[ADDR_BITS-1:2];
+assign s_axi_arready = !s_axi_rvalid;
+assign s_axi_rresp = 2'b00;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        s_axi_rvalid <= 0;
+        s_axi_rdata <= 0;
+    end
+    else begin
+        if( s_axi_rvalid && s_axi_rready ) begin
+            s_axi_rvalid <= 0;
+        end
+        if( s_axi_arvalid && s_axi_arready ) begin
+            s_axi_rvalid <= 1;
+            case(read_index)
+            REG_CONTROL: s_axi_rdata <= {30'b0, enable};
+            REG_STATUS: s_axi_rdata <= {22'b0, busy, 6'b0, irq_status};
+            REG_IRQ_ENABLE: s_axi_rdata <= {30'b0, irq_enable};
+            REG_TX_BASE: s_axi_rdata <= ring_base[TX];
+            REG_TX_SIZE: s_axi_rdata <= {16'b0, ring_size[TX]};
+            REG_TX_HEAD: s_axi_rdata <= {16'b0, ring_head[TX]};
+            REG_TX_TAIL: s_axi_rdata <= {16'b0, ring_tail[TX]};
+            REG_RX_BASE: s_axi_rdata <= ring_base[RX];
+            REG_RX_SIZE: s_axi_rdata <= {16'b0, ring_size[RX]};
+            REG_RX_HEAD: s_axi_rdata <= {16'b0, ring_head[RX]};
+            REG_RX_TAIL: s_axi_rdata <= {16'b0, ring_tail[RX]};
+            REG_TX_FRAMES: s_axi_rdata <= tx_frame_count;
+            REG_RX_FRAMES: s_axi_rdata <= rx_frame_count;
+            REG_RX_DROPS: s_axi_rdata <= rx_drop_count;
+            REG_BUS_ERRORS: s_axi_rdata <= bus_error_count;
+            default: s_axi_rdata <= 0;
+            endcase
+        end
+    end
+end
+
+// TX FIFO of {bytes in the word - 1, word}. A frame is output after all of it is read.
+logic [33:0]              tx_fifo_in_tdata;
+logic                     tx_fifo_in_tvalid;
+logic                     tx_fifo_in_tready;
+logic                     tx_fifo_in_tuser;
+logic                     tx_fifo_in_tlast;
+logic [33:0]              tx_fifo_out_tdata;
+logic                     tx_fifo_out_tvalid;
+logic                     tx_fifo_out_tready;
+logic                     tx_fifo_out_tlast;
+logic [FIFO_DEPTH_BITS:0] tx_fifo_level;
+
+packet_fifo #(
+    .DATA_BITS(34),
+    .DEPTH_BITS(FIFO_DEPTH_BITS),
+    .PACKET_MODE(1)
+) tx_fifo_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .saxis_tdata(tx_fifo_in_tdata),
+    .saxis_tvalid(tx_fifo_in_tvalid),
+    .saxis_tready(tx_fifo_in_tready),
+    .saxis_tuser(tx_fifo_in_tuser),
+    .saxis_tlast(tx_fifo_in_tlast),
+    .maxis_tdata(tx_fifo_out_tdata),
+    .maxis_tvalid(tx_fifo_out_tvalid),
+    .maxis_tready(tx_fifo_out_tready),
+    .maxis_tuser(),
+    .maxis_tlast(tx_fifo_out_tlast),
+    .level(tx_fifo_level),
+    .packet_count(),
+    .almost_full(),
+    .almost_empty());
+
+// Words to bytes, the first byte from the LSB.
+logic [1:0] tx_byte_index;
+wire  [1:0] tx_last_index = tx_fifo_out_tlast ? tx_fifo_out_tdata[33:32] : 2'd3;
+
+assign tx_maxis_tdata = tx_fifo_out_tdata[8*tx_byte_index +: 8];
+assign tx_maxis_tvalid = tx_fifo_out_tvalid;
+assign tx_maxis_tlast = tx_fifo_out_tlast && tx_byte_index == tx_last_index;
+assign tx_fifo_out_tready = tx_maxis_tready && tx_byte_index == tx_last_index;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        tx_byte_index <= 0;
+    end
+    else if( tx_maxis_tvalid && tx_maxis_tready ) begin
+        tx_byte_index <= tx_byte_index == tx_last_index ? 2'd0 : tx_byte_index + 2'd1;
+    end
+end
+
+// Bytes to words. The frames with tuser or longer than MAX_FRAME_BYTES are rolled back in the RX FIFO,
+// and the lengths of the stored frames are queued.
+logic [23:0] rx_pack_data;          // Bytes of the word before the current one
+logic [1:0]  rx_pack_count;
+logic [15:0] rx_length;             // Bytes of the frame before the current one, saturated at MAX_FRAME_BYTES
+logic [31:0] rx_word;
+logic        rx_fifo_in_tready;
+logic        rx_length_in_tready;
+
+wire rx_accepted = rx_saxis_tvalid && rx_saxis_tready;
+wire rx_overlong = rx_length >= MAX_FRAME_BYTES;
+wire rx_reject = rx_saxis_tuser || rx_overlong;
+wire rx_fifo_in_tvalid = rx_accepted && (rx_saxis_tlast || rx_pack_count == 3 && !rx_overlong);
+wire rx_frame_stored = rx_accepted && rx_saxis_tlast && !rx_reject;
+wire rx_frame_rejected = rx_accepted && rx_saxis_tlast && rx_reject;
+
+assign rx_saxis_tready = rx_fifo_in_tready && rx_length_in_tready;
+
+always_comb begin
+    rx_word = {8'h00, rx_pack_data};
+    rx_word[8*rx_pack_count +: 8] = rx_saxis_tdata;
+end
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        rx_pack_data <= 0;
+        rx_pack_count <= 0;
+        rx_length <= 0;
+    end
+    else if( rx_accepted ) begin
+        if( rx_saxis_tlast || rx_pack_count == 3 ) begin
+            rx_pack_data <= 0;
+        end
+        else begin
+            rx_pack_data <= rx_word[23:0];
+        end
+        rx_pack_count <= rx_saxis_tlast ? 2'd0 : rx_pack_count + 2'd1;
+        rx_length <= rx_saxis_tlast ? 16'd0 : rx_overlong ? rx_length : rx_length + 16'd1;
+    end
+end
+
+logic [33:0] rx_fifo_out_tdata;
+logic        rx_fifo_out_tvalid;
+logic        rx_fifo_out_tready;
+logic        rx_fifo_out_tlast;
+logic [15:0] rx_length_out_tdata;
+logic        rx_length_out_tvalid;
+logic        rx_length_out_tready;
+
+packet_fifo #(
+    .DATA_BITS(34),
+    .DEPTH_BITS(FIFO_DEPTH_BITS),
+    .PACKET_MODE(1)
+) rx_fifo_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .saxis_tdata({rx_pack_count, rx_word}),
+    .saxis_tvalid(rx_fifo_in_tvalid),
+    .saxis_tready(rx_fifo_in_tready),
+    .saxis_tuser(rx_saxis_tlast && rx_reject),
+    .saxis_tlast(rx_saxis_tlast),
+    .maxis_tdata(rx_fifo_out_tdata),
+    .maxis_tvalid(rx_fifo_out_tvalid),
+    .maxis_tready(rx_fifo_out_tready),
+    .maxis_tuser(),
+    .maxis_tlast(rx_fifo_out_tlast),
+    .level(),
+    .packet_count(),
+    .almost_full(),
+    .almost_empty());
+
+// Frames of 13 bytes or more take 4 words or more. Shorter ones may stall rx_saxis while the queue is full.
+simple_fifo #(
+    .DATA_BITS(16),
+    .DEPTH_BITS(FIFO_DEPTH_BITS - 2)
+) rx_length_fifo_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .saxis_tdata(rx_length + 16'd1),
+    .saxis_tvalid(rx_frame_stored),
+    .saxis_tready(rx_length_in_tready),
+    .maxis_tdata(rx_length_out_tdata),
+    .maxis_tvalid(rx_length_out_tvalid),
+    .maxis_tready(rx_length_out_tready));
+
+// Transfers
+typedef enum logic [3:0] {
+    S_IDLE,
+    S_DESCRIPTOR,       // Reads BUFFER and LENGTH of the descriptor
+    S_BURST,            // Starts a burst on the buffer
+    S_TX_READ,
+    S_RX_WRITE,
+    S_RX_RESPONSE,
+    S_RX_DISCARD,       // Discards the rest of the frame which is truncated, or dropped while RX is disabled
+    S_STATUS,           // Writes STATUS of the descriptor
+    S_STATUS_RESPONSE
+} state_t;
+
+state_t      state;
+logic        ring;                  // TX or RX
+logic [31:0] descriptor_address;
+logic [31:0] buffer_address;
+logic [31:0] burst_address;
+logic [15:0] frame_bytes;
+logic [15:0] transfer_bytes;        // Bytes from buffer_address to the end of the transfer
+logic [4:0]  burst_beats;
+logic [4:0]  beat;
+logic        address_pending;       // AR or AW of the transaction is not accepted yet.
+logic        data_pending;          // W of the status is not accepted yet.
+logic        truncated;
+logic        error;
+logic        dropping;              // The RX frame is dropped.
+logic        rx_last_read;          // The last word of the RX frame is read from the FIFO.
+logic        tx_ready;              // The TX descriptor is read and the frame waits for room in the TX FIFO.
+logic [31:0] tx_descriptor_address;
+logic [31:0] tx_buffer_address;
+logic [15:0] tx_frame_bytes;
+
+function automatic logic [15:0] next_index(input logic [15:0] index, input logic [15:0] size);
+    return index + 16'd1 == size ? 16'd0 : index + 16'd1;
+endfunction
+
+// Beats of the next burst, which does not cross a 4KB boundary.
+function automatic logic [4:0] burst_length(input logic [31:0] address, input logic [15:0] bytes);
+    logic [16:0] words;
+    logic [10:0] boundary_words;
+    words = (17'(bytes) + 17'd3) >> 2;
+    boundary_words = (13'h1000 - 13'(address[11:0])) >> 2;
+    if( words > MAX_BURST_BEATS && boundary_words > MAX_BURST_BEATS ) return 5'(MAX_BURST_BEATS);
+    return words < 17'(boundary_words) ? 5'(words) : 5'(boundary_words);
+endfunction
+
+wire [16:0] tx_frame_words = (17'(tx_frame_bytes) + 17'd3) >> 2;
+wire tx_room = 17'(tx_fifo_level) + tx_frame_words <= 17'(2**FIFO_DEPTH_BITS);
+wire transfer_last = transfer_bytes <= 4;           // The word is the last one of the transfer.
+wire [31:0] status_word = {1'b1, truncated, error, 13'b0, frame_bytes};
+
+wire read_data = m_axi_rvalid && m_axi_rready;
+wire write_data = m_axi_wvalid && m_axi_wready;
+
+assign m_axi_araddr = state == S_DESCRIPTOR ? descriptor_address : burst_address;
+assign m_axi_arlen = state == S_DESCRIPTOR ? 8'd1 : 8'(burst_beats - 5'd1);
+assign m_axi_arsize = 3'b010;
+assign m_axi_arburst = 2'b01;
+assign m_axi_arcache = 4'b0011;
+assign m_axi_arprot = 3'b000;
+assign m_axi_arvalid = (state == S_DESCRIPTOR || state == S_TX_READ) && address_pending;
+assign m_axi_rready = state == S_DESCRIPTOR || state == S_TX_READ && tx_fifo_in_tready;
+
+assign m_axi_awaddr = state == S_STATUS ? descriptor_address + 32'd8 : burst_address;
+assign m_axi_awlen = state == S_STATUS ? 8'd0 : 8'(burst_beats - 5'd1);
+assign m_axi_awsize = 3'b010;
+assign m_axi_awburst = 2'b01;
+assign m_axi_awcache = 4'b0011;
+assign m_axi_awprot = 3'b000;
+assign m_axi_awvalid = (state == S_STATUS || state == S_RX_WRITE) && address_pending;
+assign m_axi_wdata = state == S_STATUS ? status_word : rx_fifo_out_tdata[31:0];
+assign m_axi_wstrb = state == S_STATUS || !transfer_last ? 4'b1111 : 4'b1111 >> (3'd4 - 3'(transfer_bytes));
+assign m_axi_wlast = state == S_STATUS || beat == burst_beats - 5'd1;
+assign m_axi_wvalid = state == S_STATUS ? data_pending : state == S_RX_WRITE && beat != burst_beats && rx_fifo_out_tvalid;
+assign m_axi_bready = state == S_STATUS_RESPONSE || state == S_RX_RESPONSE;
+
+assign tx_fifo_in_tdata = {transfer_bytes[1:0] - 2'd1, m_axi_rdata};
+assign tx_fifo_in_tvalid = state == S_TX_READ && read_data;
+assign tx_fifo_in_tlast = transfer_last;
+assign tx_fifo_in_tuser = transfer_last && (error || m_axi_rresp != 2'b00);
+
+assign rx_fifo_out_tready = state == S_RX_WRITE && write_data || state == S_RX_DISCARD && !rx_last_read;
+assign rx_length_out_tready = ring == RX && (state == S_STATUS_RESPONSE && m_axi_bvalid || state == S_RX_DISCARD && dropping && rx_last_read);
+
+assign busy[TX] = tx_ready || state != S_IDLE && ring == TX;
+assign busy[RX] = state != S_IDLE && ring == RX;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        state <= S_IDLE;
+        ring <= TX;
+        descriptor_address <= 0;
+        buffer_address <= 0;
+        burst_address <= 0;
+        frame_bytes <= 0;
+        transfer_bytes <= 0;
+        burst_beats <= 0;
+        beat <= 0;
+        address_pending <= 0;
+        data_pending <= 0;
+        truncated <= 0;
+        error <= 0;
+        dropping <= 0;
+        rx_last_read <= 0;
+        tx_ready <= 0;
+        tx_descriptor_address <= 0;
+        tx_buffer_address <= 0;
+        tx_frame_bytes <= 0;
+        irq_status <= 0;
+        ring_head[TX] <= 0;
+        ring_head[RX] <= 0;
+        tx_frame_count <= 0;
+        rx_frame_count <= 0;
+        rx_drop_count <= 0;
+        bus_error_count <= 0;
+    end
+    else begin
+        irq_status <= irq_status & ~irq_clear;
+        rx_drop_count <= rx_drop_count + rx_frame_rejected + (state == S_RX_DISCARD && dropping && rx_last_read);
+        bus_error_count <= bus_error_count + (read_data && m_axi_rresp != 2'b00) + (m_axi_bvalid && m_axi_bready && m_axi_bresp != 2'b00);
+        for(int i = 0; i < 2; i++) begin
+            if( !enable[i] && !busy[i] ) begin
+                ring_head[i] <= 0;
+            end
+        end
+        if( rx_fifo_out_tvalid && rx_fifo_out_tready && rx_fifo_out_tlast ) begin
+            rx_last_read <= 1;
+        end
+
+        case(state)
+        S_IDLE: begin
+            truncated <= 0;
+            dropping <= 0;
+            rx_last_read <= 0;
+            beat <= 0;
+            if( rx_length_out_tvalid && !enable[RX] ) begin
+                ring <= RX;
+                error <= 0;
+                dropping <= 1;
+                state <= S_RX_DISCARD;
+            end
+            else if( rx_length_out_tvalid && ring_head[RX] != ring_tail[RX] ) begin
+                ring <= RX;
+                error <= 0;
+                frame_bytes <= rx_length_out_tdata;
+                descriptor_address <= ring_base[RX] + {ring_head[RX], 4'b0};
+                address_pending <= 1;
+                state <= S_DESCRIPTOR;
+            end
+            else if( tx_ready ) begin
+                if( !enable[TX] ) begin
+                    tx_ready <= 0;
+                end
+                else if( tx_room ) begin
+                    ring <= TX;
+                    error <= 0;
+                    descriptor_address <= tx_descriptor_address;
+                    buffer_address <= tx_buffer_address;
+                    frame_bytes <= tx_frame_bytes;
+                    transfer_bytes <= tx_frame_bytes;
+                    tx_ready <= 0;
+                    state <= S_BURST;
+                end
+            end
+            else if( enable[TX] && ring_head[TX] != ring_tail[TX] ) begin
+                ring <= TX;
+                error <= 0;
+                descriptor_address <= ring_base[TX] + {ring_head[TX], 4'b0};
+                address_pending <= 1;
+                state <= S_DESCRIPTOR;
+            end
+        end
+        S_DESCRIPTOR: begin
+            if( m_axi_arready ) begin
+                address_pending <= 0;
+            end
+            if( read_data ) begin
+                beat <= beat + 5'd1;
+                if( m_axi_rresp != 2'b00 ) begin
+                    error <= 1;
+                end
+                // The TX descriptor is kept aside, so that RX frames can be written while it waits.
+                if( beat == 0 ) begin
+                    buffer_address <= {m_axi_rdata[31:2], 2'b00};
+                    tx_buffer_address <= {m_axi_rdata[31:2], 2'b00};
+                end
+                else if( ring == RX ) begin
+                    truncated <= frame_bytes > m_axi_rdata[15:0];
+                    transfer_bytes <= frame_bytes > m_axi_rdata[15:0] ? m_axi_rdata[15:0] : frame_bytes;
+                end
+                else begin
+                    frame_bytes <= m_axi_rdata[15:0];
+                    tx_frame_bytes <= m_axi_rdata[15:0];
+                    tx_descriptor_address <= descriptor_address;
+                end
+                if( m_axi_rlast ) begin
+                    if( ring == RX ) begin
+                        // The frame is discarded after a bus error, or written in bursts.
+                        state <= error || m_axi_rresp != 2'b00 || m_axi_rdata[15:0] == 0 ? S_RX_DISCARD : S_BURST;
+                    end
+                    else if( error || m_axi_rresp != 2'b00 || m_axi_rdata[15:0] == 0 || m_axi_rdata[15:0] > MAX_FRAME_BYTES ) begin
+                        error <= 1;
+                        address_pending <= 1;
+                        data_pending <= 1;
+                        state <= S_STATUS;
+                    end
+                    else begin
+                        tx_ready <= 1;
+                        state <= S_IDLE;
+                    end
+                end
+            end
+        end
+        S_BURST: begin
+            burst_address <= buffer_address;
+            burst_beats <= burst_length(buffer_address, transfer_bytes);
+            beat <= 0;
+            address_pending <= 1;
+            state <= ring == RX ? S_RX_WRITE : S_TX_READ;
+        end
+        S_TX_READ: begin
+            if( m_axi_arready ) begin
+                address_pending <= 0;
+            end
+            if( read_data ) begin
+                if( m_axi_rresp != 2'b00 ) begin
+                    error <= 1;
+                end
+                buffer_address <= buffer_address + 32'd4;
+                transfer_bytes <= transfer_last ? 16'd0 : transfer_bytes - 16'd4;
+                if( m_axi_rlast ) begin
+                    if( transfer_last ) begin
+                        address_pending <= 1;
+                        data_pending <= 1;
+                        state <= S_STATUS;
+                    end
+                    else begin
+                        state <= S_BURST;
+                    end
+                end
+            end
+        end
+        S_RX_WRITE: begin
+            if( m_axi_awready ) begin
+                address_pending <= 0;
+            end
+            if( write_data ) begin
+                beat <= beat + 5'd1;
+                buffer_address <= buffer_address + 32'd4;
+                transfer_bytes <= transfer_last ? 16'd0 : transfer_bytes - 16'd4;
+            end
+            if( (!address_pending || m_axi_awready) && (beat == burst_beats || write_data && m_axi_wlast) ) begin
+                state <= S_RX_RESPONSE;
+            end
+        end
+        S_RX_RESPONSE: begin
+            if( m_axi_bvalid ) begin
+                if( m_axi_bresp != 2'b00 ) begin
+                    error <= 1;
+                end
+                if( transfer_bytes != 0 ) begin
+                    state <= S_BURST;
+                end
+                else if( rx_last_read ) begin
+                    address_pending <= 1;
+                    data_pending <= 1;
+                    state <= S_STATUS;
+                end
+                else begin
+                    state <= S_RX_DISCARD;
+                end
+            end
+        end
+        S_RX_DISCARD: begin
+            if( rx_last_read ) begin
+                if( dropping ) begin
+                    state <= S_IDLE;
+                end
+                else begin
+                    address_pending <= 1;
+                    data_pending <= 1;
+                    state <= S_STATUS;
+                end
+            end
+        end
+        S_STATUS: begin
+            if( m_axi_awready ) begin
+                address_pending <= 0;
+            end
+            if( m_axi_wready ) begin
+                data_pending <= 0;
+            end
+            if( (!address_pending || m_axi_awready) && (!data_pending || m_axi_wready) ) begin
+                state <= S_STATUS_RESPONSE;
+            end
+        end
+        S_STATUS_RESPONSE: begin
+            if( m_axi_bvalid ) begin
+                ring_head[ring] <= next_index(ring_head[ring], ring_size[ring]);
+                irq_status[ring] <= 1;
+                if( ring == RX ) begin
+                    rx_frame_count <= rx_frame_count + 1;
+                end
+                else begin
+                    tx_frame_count <= tx_frame_count + 1;
+                end
+                state <= S_IDLE;
+            end
+        end
+        default: state <= S_IDLE;
+        endcase
+    end
+end
+
+endmodule
+
+`default_nettype wire
@@ -0,0 +1,325 @@
+#include "frame_dma.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace frame_dma {
+
+// Orders the accesses to the DMA memory and the registers as seen by the DMA.
+// The DMA memory is uncached, so ARM needs a DSB for the descriptors to be written before the TAIL register.
+static inline void dma_barrier()
+{
+#if defined(__arm__) || defined(__aarch64__)
+	asm volatile("dsb sy" ::: "memory");
+#else
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+}
+
+static std::size_t align(std::size_t value, std::size_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+static std::uint64_t read_sysfs(const std::string& path)
+{
+	std::ifstream ifs(path);
+	std::uint64_t value;
+	if( !(ifs >> std::hex >> value) ) {
+		throw std::system_error(ENOENT, std::generic_category(), "failed to read " + path);
+	}
+	return value;
+}
+
+
+UioBackend::UioBackend(const std::string& device)
+{
+	auto name = device.substr(device.find_last_of('/') + 1);
+	auto maps = "/sys/class/uio/" + name + "/maps/";
+	this->registers_size = read_sysfs(maps + "map0/size");
+	this->dma_memory_size = read_sysfs(maps + "map1/size");
+	this->dma_memory_address = static_cast<std::uint32_t>(read_sysfs(maps + "map1/addr"));
+
+	this->fd = open(device.c_str(), O_RDWR | O_SYNC);
+	if( this->fd < 0 ) {
+		throw std::system_error(errno, std::generic_category(), "failed to open " + device);
+	}
+	// The map N of a UIO device is mapped at the offset of N pages.
+	auto page_size = static_cast<off_t>(sysconf(_SC_PAGESIZE));
+	auto registers = mmap(nullptr, this->registers_size, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+	auto dma_memory = mmap(nullptr, this->dma_memory_size, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, page_size);
+	if( registers == MAP_FAILED || dma_memory == MAP_FAILED ) {
+		auto error = errno;
+		if( registers != MAP_FAILED ) munmap(registers, this->registers_size);
+		if( dma_memory != MAP_FAILED ) munmap(dma_memory, this->dma_memory_size);
+		close(this->fd);
+		throw std::system_error(error, std::generic_category(), "failed to map " + device);
+	}
+	this->registers = static_cast<volatile std::uint32_t*>(registers);
+	this->dma_memory = static_cast<std::uint8_t*>(dma_memory);
+}
+
+UioBackend::~UioBackend()
+{
+	munmap(const_cast<std::uint32_t*>(this->registers), this->registers_size);
+	munmap(this->dma_memory, this->dma_memory_size);
+	close(this->fd);
+}
+
+std::uint32_t UioBackend::read_register(std::uint32_t offset)
+{
+	return this->registers[offset / 4];
+}
+
+void UioBackend::write_register(std::uint32_t offset, std::uint32_t value)
+{
+	this->registers[offset / 4] = value;
+}
+
+bool UioBackend::wait_interrupt(int timeout_ms)
+{
+	// uio_pdrv_genirq masks the interrupt when it fires, and unmasks it by writing 1.
+	std::int32_t value = 1;
+	if( write(this->fd, &value, sizeof(value)) != sizeof(value) ) {
+		throw std::system_error(errno, std::generic_category(), "failed to unmask the interrupt");
+	}
+	struct pollfd pfd = { this->fd, POLLIN, 0 };
+	auto result = poll(&pfd, 1, timeout_ms);
+	if( result < 0 ) {
+		if( errno == EINTR ) return false;
+		throw std::system_error(errno, std::generic_category(), "failed to wait for the interrupt");
+	}
+	if( result == 0 ) {
+		return false;
+	}
+	std::int32_t count;
+	return read(this->fd, &count, sizeof(count)) == sizeof(count);
+}
+
+
+std::size_t FrameDma::memory_bytes(const Config& config)
+{
+	return align(config.tx_ring_size * sizeof(Descriptor), 64)
+	     + align(config.rx_ring_size * sizeof(Descriptor), 64)
+	     + (config.tx_ring_size + config.rx_ring_size) * config.buffer_size;
+}
+
+FrameDma::FrameDma(Backend& backend, const Config& config) : backend(backend), config(config)
+{
+	if( config.tx_ring_size < 2 || config.rx_ring_size < 2 ) {
+		throw std::invalid_argument("a ring needs at least 2 descriptors");
+	}
+	if( config.buffer_size == 0 || config.buffer_size % 64 != 0 || config.buffer_size > DESCRIPTOR_LENGTH_MASK ) {
+		throw std::invalid_argument("buffer_size must be a multiple of 64 up to 65535");
+	}
+	if( memory_bytes(config) > backend.memory_size() ) {
+		throw std::invalid_argument("the rings do not fit in the DMA memory");
+	}
+
+	// Stop the DMA left running by a previous user. The HEADs are reset to 0 once the frames in progress are done.
+	this->backend.write_register(REG_CONTROL, 0);
+	while( this->backend.read_register(REG_STATUS) & (STATUS_TX_BUSY | STATUS_RX_BUSY) ) {
+		std::this_thread::yield();
+	}
+
+	auto memory = backend.memory();
+	auto address = backend.memory_address();
+	std::size_t offset = 0;
+	auto tx_ring_offset = offset;
+	offset += align(config.tx_ring_size * sizeof(Descriptor), 64);
+	auto rx_ring_offset = offset;
+	offset += align(config.rx_ring_size * sizeof(Descriptor), 64);
+	auto tx_buffers_offset = offset;
+	offset += config.tx_ring_size * config.buffer_size;
+	auto rx_buffers_offset = offset;
+
+	this->tx_ring = reinterpret_cast<volatile Descriptor*>(memory + tx_ring_offset);
+	this->rx_ring = reinterpret_cast<volatile Descriptor*>(memory + rx_ring_offset);
+	this->tx_buffers = memory + tx_buffers_offset;
+	this->rx_buffers = memory + rx_buffers_offset;
+	this->tx_buffers_address = address + tx_buffers_offset;
+	this->rx_buffers_address = address + rx_buffers_offset;
+
+	for(std::size_t i = 0; i < config.tx_ring_size; i++) {
+		auto& descriptor = this->tx_ring[i];
+		descriptor.buffer = this->tx_buffers_address + i * config.buffer_size;
+		descriptor.length = 0;
+		descriptor.status = 0;
+	}
+	// All the RX descriptors but one are given to the DMA.
+	this->rx_tail = config.rx_ring_size - 1;
+	for(std::size_t i = 0; i < this->rx_tail; i++) {
+		this->arm_rx(i);
+	}
+	dma_barrier();
+
+	this->backend.write_register(REG_TX_BASE, address + tx_ring_offset);
+	this->backend.write_register(REG_TX_SIZE, config.tx_ring_size);
+	this->backend.write_register(REG_TX_TAIL, 0);
+	this->backend.write_register(REG_RX_BASE, address + rx_ring_offset);
+	this->backend.write_register(REG_RX_SIZE, config.rx_ring_size);
+	this->backend.write_register(REG_RX_TAIL, this->rx_tail);
+	this->backend.write_register(REG_IRQ_ENABLE, 0);
+	this->backend.write_register(REG_STATUS, STATUS_TX_DONE | STATUS_RX_DONE);
+	this->backend.write_register(REG_CONTROL, CONTROL_TX_ENABLE | CONTROL_RX_ENABLE);
+}
+
+FrameDma::~FrameDma()
+{
+	this->backend.write_register(REG_CONTROL, 0);
+	this->backend.write_register(REG_IRQ_ENABLE, 0);
+}
+
+void FrameDma::arm_rx(std::size_t index)
+{
+	auto& descriptor = this->rx_ring[index];
+	descriptor.buffer = this->rx_buffers_address + index * this->config.buffer_size;
+	descriptor.length = this->config.buffer_size;
+	descriptor.status = 0;
+}
+
+std::size_t FrameDma::tx_pending() const
+{
+	return (this->tx_tail + this->config.tx_ring_size - this->tx_head) % this->config.tx_ring_size;
+}
+
+std::size_t FrameDma::tx_available() const
+{
+	return this->config.tx_ring_size - 1 - this->tx_pending();
+}
+
+std::uint8_t* FrameDma::tx_buffer(std::size_t index)
+{
+	auto slot = (this->tx_tail + index) % this->config.tx_ring_size;
+	return this->tx_buffers + slot * this->config.buffer_size;
+}
+
+void FrameDma::tx_submit(const std::size_t* lengths, std::size_t count)
+{
+	if( count > this->tx_available() ) {
+		throw std::invalid_argument("more frames than the available TX descriptors");
+	}
+	for(std::size_t i = 0; i < count; i++) {
+		if( lengths[i] == 0 || lengths[i] > this->config.buffer_size ) {
+			throw std::invalid_argument("TX frame length out of range");
+		}
+	}
+	if( count == 0 ) {
+		return;
+	}
+	for(std::size_t i = 0; i < count; i++) {
+		auto& descriptor = this->tx_ring[(this->tx_tail + i) % this->config.tx_ring_size];
+		descriptor.length = lengths[i];
+		descriptor.status = 0;
+	}
+	this->tx_tail = (this->tx_tail + count) % this->config.tx_ring_size;
+	// The frames and the descriptors must be in the memory before the DMA sees the new TAIL.
+	dma_barrier();
+	this->backend.write_register(REG_TX_TAIL, this->tx_tail);
+}
+
+bool FrameDma::tx_done() const
+{
+	return this->tx_head != this->tx_tail && (this->tx_ring[this->tx_head].status & DESCRIPTOR_DONE);
+}
+
+std::size_t FrameDma::tx_complete()
+{
+	std::size_t count = 0;
+	while( this->tx_done() ) {
+		if( this->tx_ring[this->tx_head].status & DESCRIPTOR_ERROR ) {
+			this->tx_error_count++;
+		}
+		this->tx_head = (this->tx_head + 1) % this->config.tx_ring_size;
+		count++;
+	}
+	return count;
+}
+
+bool FrameDma::rx_done() const
+{
+	return this->rx_next != this->rx_tail && (this->rx_ring[this->rx_next].status & DESCRIPTOR_DONE);
+}
+
+std::size_t FrameDma::rx_poll(Frame* frames, std::size_t max)
+{
+	std::size_t count = 0;
+	while( count < max && this->rx_done() ) {
+		// The frame is read after its done bit.
+		dma_barrier();
+		std::uint32_t status = this->rx_ring[this->rx_next].status;
+		auto& frame = frames[count];
+		frame.data = this->rx_buffers + this->rx_next * this->config.buffer_size;
+		frame.frame_bytes = status & DESCRIPTOR_LENGTH_MASK;
+		frame.length = std::min(frame.frame_bytes, this->config.buffer_size);
+		frame.truncated = (status & DESCRIPTOR_TRUNCATED) != 0;
+		frame.error = (status & DESCRIPTOR_ERROR) != 0;
+		this->rx_next = (this->rx_next + 1) % this->config.rx_ring_size;
+		count++;
+	}
+	return count;
+}
+
+void FrameDma::rx_release(std::size_t count)
+{
+	auto polled = (this->rx_next + this->config.rx_ring_size - this->rx_head) % this->config.rx_ring_size;
+	if( count > polled ) {
+		throw std::invalid_argument("releasing more frames than polled");
+	}
+	if( count == 0 ) {
+		return;
+	}
+	this->rx_head = (this->rx_head + count) % this->config.rx_ring_size;
+	// The descriptors between TAIL and the oldest one held by the software are free. Give them all but one to the DMA.
+	auto last = (this->rx_head + this->config.rx_ring_size - 1) % this->config.rx_ring_size;
+	while( this->rx_tail != last ) {
+		this->arm_rx(this->rx_tail);
+		this->rx_tail = (this->rx_tail + 1) % this->config.rx_ring_size;
+	}
+	dma_barrier();
+	this->backend.write_register(REG_RX_TAIL, this->rx_tail);
+}
+
+bool FrameDma::wait(int timeout_ms, bool tx)
+{
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+	std::uint32_t mask = STATUS_RX_DONE | (tx ? STATUS_TX_DONE : 0);
+	if( this->config.interrupt ) {
+		this->backend.write_register(REG_IRQ_ENABLE, mask);
+	}
+	while( true ) {
+		// Clear the done bits before looking at the rings, so that a frame done after the look raises the interrupt.
+		if( this->config.interrupt ) {
+			this->backend.write_register(REG_STATUS, mask);
+			dma_barrier();
+		}
+		if( this->rx_done() || (tx && this->tx_done()) ) {
+			return true;
+		}
+		int remaining = -1;
+		if( timeout_ms >= 0 ) {
+			auto now = std::chrono::steady_clock::now();
+			if( now >= deadline ) {
+				return false;
+			}
+			remaining = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count());
+		}
+		if( this->config.interrupt ) {
+			this->backend.wait_interrupt(remaining);
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+}
+
+}
@@ -0,0 +1,214 @@
+// Userspace driver of the frame_dma IP.
+// The descriptor rings and the frame buffers are placed in a DMA memory mapped to the process, so that frames are
+// filled and read in place. Frames are submitted and released in batches with one TAIL write for each batch, and
+// completions are found by polling the done bits of the descriptors or by waiting for the interrupt.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace frame_dma {
+
+// Registers of the IP
+enum Register : std::uint32_t {
+	REG_CONTROL = 0x00,
+	REG_STATUS = 0x04,
+	REG_IRQ_ENABLE = 0x08,
+	REG_TX_BASE = 0x10,
+	REG_TX_SIZE = 0x14,
+	REG_TX_HEAD = 0x18,
+	REG_TX_TAIL = 0x1c,
+	REG_RX_BASE = 0x20,
+	REG_RX_SIZE = 0x24,
+	REG_RX_HEAD = 0x28,
+	REG_RX_TAIL = 0x2c,
+	REG_TX_FRAMES = 0x30,
+	REG_RX_FRAMES = 0x34,
+	REG_RX_DROPS = 0x38,
+	REG_BUS_ERRORS = 0x3c,
+};
+
+static constexpr const std::uint32_t CONTROL_TX_ENABLE = 1u << 0;
+static constexpr const std::uint32_t CONTROL_RX_ENABLE = 1u << 1;
+static constexpr const std::uint32_t STATUS_TX_DONE = 1u << 0;
+static constexpr const std::uint32_t STATUS_RX_DONE = 1u << 1;
+static constexpr const std::uint32_t STATUS_TX_BUSY = 1u << 8;
+static constexpr const std::uint32_t STATUS_RX_BUSY = 1u << 9;
+
+static constexpr const std::uint32_t DESCRIPTOR_DONE = 1u << 31;
+static constexpr const std::uint32_t DESCRIPTOR_TRUNCATED = 1u << 30;
+static constexpr const std::uint32_t DESCRIPTOR_ERROR = 1u << 29;
+static constexpr const std::uint32_t DESCRIPTOR_LENGTH_MASK = 0xffff;
+
+// Descriptor in a ring, as read and written by the DMA.
+struct Descriptor {
+	std::uint32_t buffer;	// Bus address of the buffer
+	std::uint32_t length;	// TX: bytes of the frame, RX: bytes of the buffer
+	std::uint32_t status;	// Written by the DMA
+	std::uint32_t reserved;
+};
+static_assert(sizeof(Descriptor) == 16, "descriptor must be 16 bytes");
+
+// Access to the registers, the DMA memory and the interrupt of a frame_dma.
+class Backend
+{
+public:
+	virtual ~Backend() {}
+	virtual std::uint32_t read_register(std::uint32_t offset) = 0;
+	virtual void write_register(std::uint32_t offset, std::uint32_t value) = 0;
+	// DMA memory mapped to the process, at memory_address() on the bus of the DMA.
+	virtual std::uint8_t* memory() = 0;
+	virtual std::uint32_t memory_address() const = 0;
+	virtual std::size_t memory_size() const = 0;
+	// Unmasks the interrupt and waits for it. Returns false on timeout. A negative timeout waits forever.
+	virtual bool wait_interrupt(int timeout_ms) = 0;
+};
+
+// frame_dma exported by uio_pdrv_genirq.
+// The first map of the UIO device is the registers and the second one is the DMA memory, which must be
+// a physically contiguous region reserved from Linux (mapped uncached by UIO).
+class UioBackend : public Backend
+{
+	int fd;
+	volatile std::uint32_t* registers;
+	std::size_t registers_size;
+	std::uint8_t* dma_memory;
+	std::size_t dma_memory_size;
+	std::uint32_t dma_memory_address;
+
+public:
+	// device is a path like /dev/uio0. Throws std::system_error on failure.
+	explicit UioBackend(const std::string& device);
+	~UioBackend() override;
+	UioBackend(const UioBackend&) = delete;
+	UioBackend& operator=(const UioBackend&) = delete;
+
+	std::uint32_t read_register(std::uint32_t offset) override;
+	void write_register(std::uint32_t offset, std::uint32_t value) override;
+	std::uint8_t* memory() override { return this->dma_memory; }
+	std::uint32_t memory_address() const override { return this->dma_memory_address; }
+	std::size_t memory_size() const override { return this->dma_memory_size; }
+	bool wait_interrupt(int timeout_ms) override;
+};
+
+// Software model of frame_dma on host memory, to run the software without the hardware.
+// The DMA runs whenever a register is written or a frame is received, until it has nothing to do.
+// The DMA memory is at memory_address() and any other address returns an error response like an unmapped one.
+class MockBackend : public Backend
+{
+	std::vector<std::uint8_t> dma_memory;
+	std::uint32_t dma_memory_address;
+	std::size_t max_frame_bytes;
+	std::size_t rx_fifo_frames;
+	std::uint32_t registers[16];
+	std::deque<std::vector<std::uint8_t>> rx_fifo;
+
+	bool access(std::uint32_t address, std::size_t bytes);
+	std::uint32_t read_word(std::uint32_t address);
+	void write_word(std::uint32_t address, std::uint32_t value);
+	bool process_tx();
+	bool process_rx();
+	void process();
+
+public:
+	// rx_fifo_frames is the frames the RX FIFO holds while there is no RX descriptor.
+	MockBackend(std::size_t memory_size, std::uint32_t memory_address = 0x10000000, std::size_t max_frame_bytes = 1522, std::size_t rx_fifo_frames = 4);
+
+	std::uint32_t read_register(std::uint32_t offset) override;
+	void write_register(std::uint32_t offset, std::uint32_t value) override;
+	std::uint8_t* memory() override { return this->dma_memory.data(); }
+	std::uint32_t memory_address() const override { return this->dma_memory_address; }
+	std::size_t memory_size() const override { return this->dma_memory.size(); }
+	// Returns immediately, as the DMA has already done everything it can.
+	bool wait_interrupt(int timeout_ms) override;
+
+	// Frame on rx_saxis. Returns false if the RX FIFO is full, which stalls rx_saxis on the hardware.
+	bool receive(const std::vector<std::uint8_t>& frame, bool error = false);
+	bool interrupt() const;
+
+	// Frames output on tx_maxis
+	std::vector<std::vector<std::uint8_t>> transmitted;
+	// Writes to TX_TAIL and RX_TAIL
+	std::size_t tail_writes = 0;
+};
+
+// Received frame in an RX buffer, valid until it is released.
+struct Frame {
+	const std::uint8_t* data;
+	std::size_t length;		// Bytes in the buffer
+	std::size_t frame_bytes;	// Bytes of the frame on rx_saxis
+	bool truncated;
+	bool error;		// The DMA got an error response writing the frame
+};
+
+struct Config {
+	std::size_t tx_ring_size = 64;		// Descriptors in the TX ring, one of which is always left unused
+	std::size_t rx_ring_size = 64;
+	std::size_t buffer_size = 2048;		// Bytes of each buffer, multiple of 64
+	bool interrupt = true;			// Enables the interrupt for wait()
+};
+
+// Rings and buffers of a frame_dma, laid out at the start of the DMA memory.
+// Each descriptor has a fixed buffer, so a buffer is owned by whoever owns its descriptor.
+class FrameDma
+{
+	Backend& backend;
+	Config config;
+	volatile Descriptor* tx_ring;
+	volatile Descriptor* rx_ring;
+	std::uint8_t* tx_buffers;
+	std::uint8_t* rx_buffers;
+	std::uint32_t tx_buffers_address;
+	std::uint32_t rx_buffers_address;
+
+	std::size_t tx_head = 0;	// Oldest descriptor submitted and not completed
+	std::size_t tx_tail = 0;	// Next descriptor to submit
+	std::size_t rx_head = 0;	// Oldest descriptor polled and not released
+	std::size_t rx_next = 0;	// Next descriptor to poll
+	std::size_t rx_tail = 0;	// Descriptor after the last one given to the DMA
+
+	std::uint64_t tx_error_count = 0;
+
+	void arm_rx(std::size_t index);
+	bool tx_done() const;
+	bool rx_done() const;
+
+public:
+	// Throws std::invalid_argument if the rings do not fit in the DMA memory.
+	FrameDma(Backend& backend, const Config& config = Config());
+	// Stops the DMA.
+	~FrameDma();
+	FrameDma(const FrameDma&) = delete;
+	FrameDma& operator=(const FrameDma&) = delete;
+
+	// Bytes of the DMA memory used by config.
+	static std::size_t memory_bytes(const Config& config);
+
+	// Descriptors that can be submitted to the TX ring.
+	std::size_t tx_available() const;
+	// Buffer of the index-th descriptor to be submitted (index < tx_available()), to build the frame in place.
+	std::uint8_t* tx_buffer(std::size_t index);
+	std::size_t buffer_size() const { return this->config.buffer_size; }
+	// Submits count frames built in the buffers from tx_buffer(0), with one TAIL write.
+	// Throws std::invalid_argument if a length is 0 or longer than the buffer, or count is more than available.
+	void tx_submit(const std::size_t* lengths, std::size_t count);
+	// Reaps the submitted frames the DMA has done and returns how many. Their buffers can be reused.
+	std::size_t tx_complete();
+	// Frames submitted and not reaped yet.
+	std::size_t tx_pending() const;
+	std::uint64_t tx_errors() const { return this->tx_error_count; }
+
+	// Returns up to max frames received since the last poll. The frames are valid until they are released.
+	std::size_t rx_poll(Frame* frames, std::size_t max);
+	// Releases the oldest count polled frames, giving their buffers back to the DMA with one TAIL write.
+	void rx_release(std::size_t count);
+
+	// Waits for a frame done on the RX ring, or on the TX ring if tx is set. Returns false on timeout.
+	// Returns immediately if there is already one to poll or reap.
+	bool wait(int timeout_ms, bool tx = false);
+};
+
+}
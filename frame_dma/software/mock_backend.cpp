@@ -0,0 +1,169 @@
+#include "frame_dma.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace frame_dma {
+
+MockBackend::MockBackend(std::size_t memory_size, std::uint32_t memory_address, std::size_t max_frame_bytes, std::size_t rx_fifo_frames)
+	: dma_memory(memory_size), dma_memory_address(memory_address), max_frame_bytes(max_frame_bytes), rx_fifo_frames(rx_fifo_frames)
+{
+	std::fill(std::begin(this->registers), std::end(this->registers), 0);
+	this->registers[REG_TX_SIZE / 4] = 1;
+	this->registers[REG_RX_SIZE / 4] = 1;
+}
+
+bool MockBackend::access(std::uint32_t address, std::size_t bytes)
+{
+	if( address % 4 != 0 || address < this->dma_memory_address || address - this->dma_memory_address + bytes > this->dma_memory.size() ) {
+		this->registers[REG_BUS_ERRORS / 4]++;
+		return false;
+	}
+	return true;
+}
+
+std::uint32_t MockBackend::read_word(std::uint32_t address)
+{
+	std::uint32_t value;
+	std::memcpy(&value, this->dma_memory.data() + (address - this->dma_memory_address), sizeof(value));
+	return value;
+}
+
+void MockBackend::write_word(std::uint32_t address, std::uint32_t value)
+{
+	std::memcpy(this->dma_memory.data() + (address - this->dma_memory_address), &value, sizeof(value));
+}
+
+std::uint32_t MockBackend::read_register(std::uint32_t offset)
+{
+	return this->registers[(offset / 4) % 16];
+}
+
+void MockBackend::write_register(std::uint32_t offset, std::uint32_t value)
+{
+	auto& reg = this->registers[(offset / 4) % 16];
+	switch(offset) {
+	case REG_CONTROL:
+		reg = value & (CONTROL_TX_ENABLE | CONTROL_RX_ENABLE);
+		if( !(reg & CONTROL_TX_ENABLE) ) {
+			this->registers[REG_TX_HEAD / 4] = 0;
+		}
+		if( !(reg & CONTROL_RX_ENABLE) ) {
+			this->registers[REG_RX_HEAD / 4] = 0;
+			this->registers[REG_RX_DROPS / 4] += this->rx_fifo.size();
+			this->rx_fifo.clear();
+		}
+		break;
+	case REG_STATUS:
+		reg &= ~(value & (STATUS_TX_DONE | STATUS_RX_DONE));
+		break;
+	case REG_IRQ_ENABLE:
+		reg = value & (STATUS_TX_DONE | STATUS_RX_DONE);
+		break;
+	case REG_TX_BASE:
+	case REG_RX_BASE:
+		reg = value & ~0xfu;
+		break;
+	case REG_TX_SIZE:
+	case REG_RX_SIZE:
+		reg = value == 0 ? 1 : value;
+		break;
+	case REG_TX_TAIL:
+	case REG_RX_TAIL:
+		reg = value;
+		this->tail_writes++;
+		break;
+	default:
+		break;
+	}
+	this->process();
+}
+
+bool MockBackend::process_tx()
+{
+	auto& head = this->registers[REG_TX_HEAD / 4];
+	if( !(this->registers[REG_CONTROL / 4] & CONTROL_TX_ENABLE) || head == this->registers[REG_TX_TAIL / 4] ) {
+		return false;
+	}
+	auto descriptor = this->registers[REG_TX_BASE / 4] + head * 16;
+	if( this->access(descriptor, 16) ) {
+		auto buffer = this->read_word(descriptor);
+		auto length = this->read_word(descriptor + 4) & DESCRIPTOR_LENGTH_MASK;
+		std::uint32_t status = DESCRIPTOR_DONE | length;
+		if( length == 0 || length > this->max_frame_bytes || !this->access(buffer, (length + 3) & ~3u) ) {
+			status |= DESCRIPTOR_ERROR;
+		}
+		else {
+			auto data = this->dma_memory.data() + (buffer - this->dma_memory_address);
+			this->transmitted.emplace_back(data, data + length);
+		}
+		this->write_word(descriptor + 8, status);
+	}
+	head = (head + 1) % this->registers[REG_TX_SIZE / 4];
+	this->registers[REG_TX_FRAMES / 4]++;
+	this->registers[REG_STATUS / 4] |= STATUS_TX_DONE;
+	return true;
+}
+
+bool MockBackend::process_rx()
+{
+	auto& head = this->registers[REG_RX_HEAD / 4];
+	if( this->rx_fifo.empty() || head == this->registers[REG_RX_TAIL / 4] ) {
+		return false;
+	}
+	const auto& frame = this->rx_fifo.front();
+	auto descriptor = this->registers[REG_RX_BASE / 4] + head * 16;
+	if( this->access(descriptor, 16) ) {
+		auto buffer = this->read_word(descriptor);
+		auto length = this->read_word(descriptor + 4) & DESCRIPTOR_LENGTH_MASK;
+		auto bytes = std::min<std::size_t>(frame.size(), length);
+		std::uint32_t status = DESCRIPTOR_DONE | static_cast<std::uint32_t>(frame.size());
+		if( frame.size() > length ) {
+			status |= DESCRIPTOR_TRUNCATED;
+		}
+		if( !this->access(buffer, (bytes + 3) & ~3u) ) {
+			status |= DESCRIPTOR_ERROR;
+		}
+		else {
+			std::copy(frame.begin(), frame.begin() + bytes, this->dma_memory.begin() + (buffer - this->dma_memory_address));
+		}
+		this->write_word(descriptor + 8, status);
+	}
+	this->rx_fifo.pop_front();
+	head = (head + 1) % this->registers[REG_RX_SIZE / 4];
+	this->registers[REG_RX_FRAMES / 4]++;
+	this->registers[REG_STATUS / 4] |= STATUS_RX_DONE;
+	return true;
+}
+
+void MockBackend::process()
+{
+	// RX is preferred like the hardware.
+	while( this->process_rx() || this->process_tx() ) {
+	}
+}
+
+bool MockBackend::wait_interrupt(int)
+{
+	return this->interrupt();
+}
+
+bool MockBackend::interrupt() const
+{
+	return (this->registers[REG_STATUS / 4] & this->registers[REG_IRQ_ENABLE / 4]) != 0;
+}
+
+bool MockBackend::receive(const std::vector<std::uint8_t>& frame, bool error)
+{
+	if( !(this->registers[REG_CONTROL / 4] & CONTROL_RX_ENABLE) || error || frame.size() > this->max_frame_bytes ) {
+		this->registers[REG_RX_DROPS / 4]++;
+		return true;
+	}
+	if( this->rx_fifo.size() >= this->rx_fifo_frames ) {
+		return false;
+	}
+	this->rx_fifo.push_back(frame);
+	this->process();
+	return true;
+}
+
+}
@@ -0,0 +1,208 @@
+#include "frame_dma.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+using namespace frame_dma;
+
+static int errors = 0;
+
+#define CHECK(condition) do { \
+	if( !(condition) ) { \
+		std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+		errors++; \
+	} \
+} while(0)
+
+static std::vector<std::uint8_t> make_frame(std::size_t length, std::uint8_t seed)
+{
+	std::vector<std::uint8_t> frame(length);
+	for(std::size_t i = 0; i < length; i++) {
+		frame[i] = static_cast<std::uint8_t>(seed + i);
+	}
+	return frame;
+}
+
+static Config small_config()
+{
+	Config config;
+	config.tx_ring_size = 8;
+	config.rx_ring_size = 8;
+	config.buffer_size = 256;
+	return config;
+}
+
+// Submits frames in place in batches, with one TAIL write each, and wraps the ring many times.
+static void test_tx()
+{
+	MockBackend backend(0x10000);
+	FrameDma dma(backend, small_config());
+	CHECK(dma.tx_available() == 7);
+
+	std::vector<std::vector<std::uint8_t>> expected;
+	std::size_t completed = 0;
+	for(std::size_t batch = 0; batch < 20; batch++) {
+		std::size_t count = 1 + batch % 7;
+		CHECK(dma.tx_available() == 7);
+		std::vector<std::size_t> lengths;
+		for(std::size_t i = 0; i < count; i++) {
+			auto frame = make_frame(60 + (batch * 7 + i) % 197, static_cast<std::uint8_t>(batch * 16 + i));
+			std::copy(frame.begin(), frame.end(), dma.tx_buffer(i));
+			lengths.push_back(frame.size());
+			expected.push_back(frame);
+		}
+		auto tail_writes = backend.tail_writes;
+		dma.tx_submit(lengths.data(), count);
+		CHECK(backend.tail_writes == tail_writes + 1);
+		CHECK(dma.wait(0, true));
+		completed += dma.tx_complete();
+		CHECK(dma.tx_pending() == 0);
+	}
+	CHECK(completed == expected.size());
+	CHECK(backend.transmitted == expected);
+	CHECK(dma.tx_errors() == 0);
+	CHECK(backend.read_register(REG_TX_FRAMES) == expected.size());
+
+	std::size_t too_long = 257;
+	bool thrown = false;
+	try {
+		dma.tx_submit(&too_long, 1);
+	}
+	catch(const std::invalid_argument&) {
+		thrown = true;
+	}
+	CHECK(thrown);
+}
+
+// Frames the DMA has not done stay pending, and a frame the DMA rejects is counted as an error.
+static void test_tx_pending()
+{
+	MockBackend backend(0x10000, 0x10000000, 200);
+	FrameDma dma(backend, small_config());
+	backend.write_register(REG_CONTROL, CONTROL_RX_ENABLE);
+	std::size_t lengths[] = { 100, 201, 64 };
+	dma.tx_submit(lengths, 3);
+	CHECK(dma.tx_pending() == 3);
+	CHECK(dma.tx_available() == 4);
+	CHECK(!dma.wait(0, true));
+	CHECK(dma.tx_complete() == 0);
+
+	backend.write_register(REG_CONTROL, CONTROL_TX_ENABLE | CONTROL_RX_ENABLE);
+	CHECK(dma.tx_complete() == 3);
+	CHECK(dma.tx_errors() == 1);
+	CHECK(backend.transmitted.size() == 2);
+}
+
+// Receives frames into the buffers, and gives them back in batches.
+static void test_rx()
+{
+	MockBackend backend(0x10000);
+	FrameDma dma(backend, small_config());
+	CHECK(!dma.wait(0));
+
+	Frame frames[8];
+	std::size_t received = 0;
+	for(std::size_t round = 0; round < 30; round++) {
+		std::vector<std::vector<std::uint8_t>> expected;
+		std::size_t count = 1 + round % 5;
+		for(std::size_t i = 0; i < count; i++) {
+			expected.push_back(make_frame(60 + (round * 5 + i) * 13 % 196, static_cast<std::uint8_t>(round + i)));
+			CHECK(backend.receive(expected.back()));
+		}
+		CHECK(backend.interrupt());
+		CHECK(dma.wait(0));
+		// Poll in two steps and release all at once.
+		auto first = dma.rx_poll(frames, 2);
+		auto polled = first + dma.rx_poll(frames + first, 8 - first);
+		CHECK(polled == count);
+		for(std::size_t i = 0; i < polled && i < count; i++) {
+			CHECK(!frames[i].truncated && !frames[i].error);
+			CHECK(std::vector<std::uint8_t>(frames[i].data, frames[i].data + frames[i].length) == expected[i]);
+		}
+		auto tail_writes = backend.tail_writes;
+		dma.rx_release(polled);
+		CHECK(backend.tail_writes == tail_writes + 1);
+		received += polled;
+		CHECK(!dma.wait(0));
+	}
+	CHECK(backend.read_register(REG_RX_FRAMES) == received);
+
+	// Longer than the buffer
+	auto frame = make_frame(300, 1);
+	CHECK(backend.receive(frame));
+	CHECK(dma.rx_poll(frames, 8) == 1);
+	CHECK(frames[0].truncated && frames[0].length == 256 && frames[0].frame_bytes == 300);
+	CHECK(std::vector<std::uint8_t>(frames[0].data, frames[0].data + 256) == make_frame(256, 1));
+	dma.rx_release(1);
+
+	// Dropped by the MAC
+	CHECK(backend.receive(make_frame(64, 0), true));
+	CHECK(dma.rx_poll(frames, 8) == 0);
+	CHECK(backend.read_register(REG_RX_DROPS) == 1);
+}
+
+// Frames wait in the RX FIFO while the software holds all the buffers.
+static void test_rx_hold()
+{
+	MockBackend backend(0x10000, 0x10000000, 1522, 2);
+	FrameDma dma(backend, small_config());
+	Frame frames[16];
+
+	for(std::size_t i = 0; i < 9; i++) {
+		CHECK(backend.receive(make_frame(64, static_cast<std::uint8_t>(i))));
+	}
+	CHECK(!backend.receive(make_frame(64, 9)));
+	CHECK(dma.rx_poll(frames, 16) == 7);
+	CHECK(dma.rx_poll(frames + 7, 9) == 0);
+
+	// Releasing 3 frames lets the 2 waiting frames in.
+	dma.rx_release(3);
+	CHECK(dma.rx_poll(frames + 7, 9) == 2);
+	CHECK(frames[7].data[0] == 7 && frames[8].data[0] == 8);
+	CHECK(frames[3].data[0] == 3);
+	dma.rx_release(6);
+	CHECK(backend.receive(make_frame(64, 9)));
+	CHECK(dma.rx_poll(frames, 16) == 1);
+	CHECK(frames[0].data[0] == 9);
+	dma.rx_release(1);
+
+	bool thrown = false;
+	try {
+		dma.rx_release(1);
+	}
+	catch(const std::invalid_argument&) {
+		thrown = true;
+	}
+	CHECK(thrown);
+}
+
+// The rings must fit in the DMA memory.
+static void test_config()
+{
+	MockBackend backend(0x1000);
+	bool thrown = false;
+	try {
+		FrameDma dma(backend);
+	}
+	catch(const std::invalid_argument&) {
+		thrown = true;
+	}
+	CHECK(thrown);
+	CHECK(FrameDma::memory_bytes(small_config()) == 128 + 128 + 16 * 256);
+}
+
+int main()
+{
+	test_tx();
+	test_tx_pending();
+	test_rx();
+	test_rx_hold();
+	test_config();
+	if( errors > 0 ) {
+		std::fprintf(stderr, "%d checks failed\n", errors);
+		return EXIT_FAILURE;
+	}
+	std::printf("All tests passed\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,494 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+
+    localparam int MAX_FRAME_BYTES = 400;
+    localparam bit [31:0] ERROR_ADDRESS = 32'hf000_0000;   // The memory responds SLVERR from here.
+
+    typedef bit [7:0] frame_t[$];
+
+    logic [7:0] tx_maxis_tdata;
+    logic       tx_maxis_tvalid;
+    logic       tx_maxis_tready = 1;
+    logic       tx_maxis_tlast;
+    logic [7:0] rx_saxis_tdata = 0;
+    logic       rx_saxis_tvalid = 0;
+    logic       rx_saxis_tready;
+    logic       rx_saxis_tuser = 0;
+    logic       rx_saxis_tlast = 0;
+    logic       interrupt;
+
+    logic [31:0] m_axi_awaddr;
+    logic  [7:0] m_axi_awlen;
+    logic  [2:0] m_axi_awsize;
+    logic  [1:0] m_axi_awburst;
+    logic  [3:0] m_axi_awcache;
+    logic  [2:0] m_axi_awprot;
+    logic        m_axi_awvalid;
+    logic        m_axi_awready = 0;
+    logic [31:0] m_axi_wdata;
+    logic  [3:0] m_axi_wstrb;
+    logic        m_axi_wlast;
+    logic        m_axi_wvalid;
+    logic        m_axi_wready = 0;
+    logic  [1:0] m_axi_bresp = 0;
+    logic        m_axi_bvalid = 0;
+    logic        m_axi_bready;
+    logic [31:0] m_axi_araddr;
+    logic  [7:0] m_axi_arlen;
+    logic  [2:0] m_axi_arsize;
+    logic  [1:0] m_axi_arburst;
+    logic  [3:0] m_axi_arcache;
+    logic  [2:0] m_axi_arprot;
+    logic        m_axi_arvalid;
+    logic        m_axi_arready = 0;
+    logic [31:0] m_axi_rdata = 0;
+    logic  [1:0] m_axi_rresp = 0;
+    logic        m_axi_rlast = 0;
+    logic        m_axi_rvalid = 0;
+    logic        m_axi_rready;
+
+    logic [7:0]  s_axi_awaddr;
+    logic        s_axi_awvalid = 0;
+    logic        s_axi_awready;
+    logic [31:0] s_axi_wdata;
+    logic [3:0]  s_axi_wstrb;
+    logic        s_axi_wvalid = 0;
+    logic        s_axi_wready;
+    logic [1:0]  s_axi_bresp;
+    logic        s_axi_bvalid;
+    logic        s_axi_bready = 0;
+    logic [7:0]  s_axi_araddr;
+    logic        s_axi_arvalid = 0;
+    logic        s_axi_arready;
+    logic [31:0] s_axi_rdata;
+    logic [1:0]  s_axi_rresp;
+    logic        s_axi_rvalid;
+    logic        s_axi_rready = 0;
+
+    frame_dma #(
+        .FIFO_DEPTH_BITS(7),
+        .MAX_FRAME_BYTES(MAX_FRAME_BYTES)
+    ) dut (
+        .*
+    );
+
+    initial begin
+        clock = 0;
+    end
+    always #(5) begin
+        clock = ~clock;
+    end
+
+    localparam bit [7:0] REG_CONTROL = 8'h00;
+    localparam bit [7:0] REG_STATUS = 8'h04;
+    localparam bit [7:0] REG_IRQ_ENABLE = 8'h08;
+    localparam bit [7:0] REG_TX_BASE = 8'h10;
+    localparam bit [7:0] REG_TX_SIZE = 8'h14;
+    localparam bit [7:0] REG_TX_HEAD = 8'h18;
+    localparam bit [7:0] REG_TX_TAIL = 8'h1c;
+    localparam bit [7:0] REG_RX_BASE = 8'h20;
+    localparam bit [7:0] REG_RX_SIZE = 8'h24;
+    localparam bit [7:0] REG_RX_HEAD = 8'h28;
+    localparam bit [7:0] REG_RX_TAIL = 8'h2c;
+    localparam bit [7:0] REG_TX_FRAMES = 8'h30;
+    localparam bit [7:0] REG_RX_FRAMES = 8'h34;
+    localparam bit [7:0] REG_RX_DROPS = 8'h38;
+    localparam bit [7:0] REG_BUS_ERRORS = 8'h3c;
+
+    localparam bit [31:0] STATUS_DONE = 32'h8000_0000;
+    localparam bit [31:0] STATUS_TRUNCATED = 32'h4000_0000;
+    localparam bit [31:0] STATUS_ERROR = 32'h2000_0000;
+
+    // Memory on the AXI4 master. Each channel is stalled at random.
+    bit [7:0] memory[bit [31:0]];
+
+    function automatic bit [7:0] memory_read(input bit [31:0] address);
+        return memory.exists(address) ? memory[address] : 8'h00;
+    endfunction
+    function automatic bit [31:0] memory_read32(input bit [31:0] address);
+        return {memory_read(address + 3), memory_read(address + 2), memory_read(address + 1), memory_read(address)};
+    endfunction
+    function automatic void memory_write32(input bit [31:0] address, input bit [31:0] value);
+        for(int i = 0; i < 4; i++) memory[address + i] = value[8*i +: 8];
+    endfunction
+
+    function automatic void check_burst(input string name, input bit [31:0] address, input bit [7:0] length, input bit [2:0] size, input bit [1:0] burst);
+        bit [31:0] last_address = address + 4*length;
+        if( size != 3'b010 || burst != 2'b01 ) $error("%s: size %0d, burst %0d", name, size, burst);
+        if( address[1:0] != 0 ) $error("%s: unaligned address %08x", name, address);
+        if( length >= 16 ) $error("%s: %0d beats at %08x", name, length + 1, address);
+        if( address[31:12] != last_address[31:12] ) $error("%s: burst of %0d beats at %08x crosses a 4KB boundary", name, length + 1, address);
+    endfunction
+
+    always begin
+        bit [31:0] address;
+        bit [7:0] length;
+        @(posedge clock);
+        if( m_axi_arvalid ) begin
+            repeat($urandom_range(0, 3)) @(posedge clock);
+            m_axi_arready <= 1;
+            address = m_axi_araddr;
+            length = m_axi_arlen;
+            check_burst("read", address, length, m_axi_arsize, m_axi_arburst);
+            @(posedge clock);
+            m_axi_arready <= 0;
+            repeat($urandom_range(0, 8)) @(posedge clock);
+            for(int i = 0; i <= length; i++) begin
+                m_axi_rdata <= memory_read32(address + 4*i);
+                m_axi_rresp <= address >= ERROR_ADDRESS ? 2'b10 : 2'b00;
+                m_axi_rlast <= i == length;
+                m_axi_rvalid <= 1;
+                do @(posedge clock); while(!m_axi_rready);
+                m_axi_rvalid <= 0;
+                repeat($urandom_range(0, 1)) @(posedge clock);
+            end
+        end
+    end
+
+    typedef struct {
+        bit [31:0] address;
+        bit [7:0]  length;
+    } burst_t;
+    burst_t write_bursts[$];
+    bit [36:0] write_beats[$];      // {last, strobe, data}
+
+    always @(posedge clock) begin
+        if( m_axi_awvalid && m_axi_awready ) begin
+            check_burst("write", m_axi_awaddr, m_axi_awlen, m_axi_awsize, m_axi_awburst);
+            write_bursts.push_back('{m_axi_awaddr, m_axi_awlen});
+        end
+        if( m_axi_wvalid && m_axi_wready ) begin
+            write_beats.push_back({m_axi_wlast, m_axi_wstrb, m_axi_wdata});
+        end
+        m_axi_awready <= $urandom_range(0, 2) == 0;
+        m_axi_wready <= $urandom_range(0, 2) != 0;
+    end
+
+    always begin
+        burst_t burst;
+        bit [36:0] beat;
+        bit error;
+        while(write_bursts.size() == 0) @(posedge clock);
+        burst = write_bursts.pop_front();
+        error = burst.address >= ERROR_ADDRESS;
+        for(int i = 0; i <= burst.length; i++) begin
+            while(write_beats.size() == 0) @(posedge clock);
+            beat = write_beats.pop_front();
+            if( beat[36] != (i == burst.length) ) $error("wlast %0d at beat %0d of %0d", beat[36], i, burst.length + 1);
+            for(int b = 0; b < 4; b++) begin
+                if( beat[32 + b] && !error ) memory[burst.address + 4*i + b] = beat[8*b +: 8];
+            end
+        end
+        @(posedge clock);
+        repeat($urandom_range(0, 4)) @(posedge clock);
+        m_axi_bresp <= error ? 2'b10 : 2'b00;
+        m_axi_bvalid <= 1;
+        do @(posedge clock); while(!m_axi_bready);
+        m_axi_bvalid <= 0;
+    end
+
+    // Frames output on tx_maxis
+    frame_t tx_frames[$];
+    frame_t tx_receiving;
+    always @(posedge clock) begin
+        if( tx_maxis_tvalid && tx_maxis_tready ) begin
+            tx_receiving.push_back(tx_maxis_tdata);
+            if( tx_maxis_tlast ) begin
+                tx_frames.push_back(tx_receiving);
+                tx_receiving = {};
+            end
+        end
+        if( tx_receiving.size() != 0 && tx_maxis_tready && !tx_maxis_tvalid ) $error("gap in a TX frame");
+    end
+
+    function automatic frame_t make_frame(input int length, input int seed);
+        frame_t frame;
+        for(int i = 0; i < length; i++) frame.push_back(8'(seed * 31 + i * 7));
+        return frame;
+    endfunction
+
+    task automatic send(input frame_t frame, input bit user = 0, input bit gaps = 0);
+        foreach(frame[i]) begin
+            rx_saxis_tdata <= frame[i];
+            rx_saxis_tvalid <= 1;
+            rx_saxis_tuser <= user && i == frame.size() - 1;
+            rx_saxis_tlast <= i == frame.size() - 1;
+            do @(posedge clock); while(!rx_saxis_tready);
+            rx_saxis_tvalid <= 0;
+            if( gaps ) repeat($urandom_range(0, 2)) @(posedge clock);
+        end
+    endtask
+
+    // The register accesses are serialized for the threads.
+    semaphore axi_lock = new(1);
+
+    task automatic axi_write(input logic [7:0] address, input logic [31:0] data);
+        axi_lock.get();
+        s_axi_awaddr <= address;
+        s_axi_awvalid <= 1;
+        s_axi_wdata <= data;
+        s_axi_wstrb <= 4'hf;
+        s_axi_wvalid <= 1;
+        s_axi_bready <= 1;
+        do @(posedge clock); while(!(s_axi_awready && s_axi_wready));
+        s_axi_awvalid <= 0;
+        s_axi_wvalid <= 0;
+        do @(posedge clock); while(!s_axi_bvalid);
+        s_axi_bready <= 0;
+        axi_lock.put();
+    endtask
+
+    task automatic axi_read(input logic [7:0] address, output logic [31:0] data);
+        axi_lock.get();
+        s_axi_araddr <= address;
+        s_axi_arvalid <= 1;
+        s_axi_rready <= 1;
+        do @(posedge clock); while(!s_axi_arready);
+        s_axi_arvalid <= 0;
+        do @(posedge clock); while(!s_axi_rvalid);
+        data = s_axi_rdata;
+        s_axi_rready <= 0;
+        axi_lock.put();
+    endtask
+
+    task automatic check_register(input logic [7:0] address, input logic [31:0] expected, input string name);
+        logic [31:0] value;
+        axi_read(address, value);
+        if( value != expected ) $error("%s expected: %0d, actual: %0d", name, expected, value);
+    endtask
+
+    task automatic wait_register(input logic [7:0] address, input logic [31:0] expected, input string name);
+        logic [31:0] value;
+        for(int i = 0; i < 1000; i++) begin
+            axi_read(address, value);
+            if( value == expected ) return;
+            repeat(10) @(posedge clock);
+        end
+        $error("%s: timeout, expected: %0d, actual: %0d", name, expected, value);
+    endtask
+
+    localparam bit [31:0] TX_RING = 32'h0000_1000;
+    localparam bit [31:0] RX_RING = 32'h0000_2000;
+    localparam int TX_RING_SIZE = 4;
+    localparam int RX_RING_SIZE = 4;
+
+    function automatic void set_descriptor(input bit [31:0] ring, input int index, input bit [31:0] buffer, input int length);
+        memory_write32(ring + 16*index, buffer);
+        memory_write32(ring + 16*index + 4, length);
+        memory_write32(ring + 16*index + 8, 0);
+    endfunction
+
+    function automatic void check_status(input string name, input bit [31:0] ring, input int index, input bit [31:0] expected);
+        bit [31:0] status = memory_read32(ring + 16*index + 8);
+        if( status != expected ) $error("%s: STATUS %08x, expected %08x", name, status, expected);
+    endfunction
+
+    function automatic void write_buffer(input bit [31:0] address, input frame_t frame);
+        foreach(frame[i]) memory[address + i] = frame[i];
+    endfunction
+
+    function automatic void fill_buffer(input bit [31:0] address, input int length);
+        for(int i = 0; i < length; i++) memory[address + i] = 8'hee;
+    endfunction
+
+    function automatic void check_buffer(input string name, input bit [31:0] address, input frame_t frame, input int written, input int size);
+        for(int i = 0; i < size; i++) begin
+            bit [7:0] expected = i < written ? frame[i] : 8'hee;
+            if( memory_read(address + i) != expected ) begin
+                $error("%s: byte %0d of the buffer is %02x, expected %02x", name, i, memory_read(address + i), expected);
+                return;
+            end
+        end
+    endfunction
+
+    task automatic check_tx_frame(input string name, input frame_t expected);
+        if( tx_frames.size() == 0 ) begin
+            $error("%s: no TX frame", name);
+            return;
+        end
+        if( tx_frames.pop_front() != expected ) $error("%s: TX frame mismatch", name);
+    endtask
+
+    frame_t frames[$];
+    int     tx_index;
+    int     rx_index;
+    bit [31:0] rx_buffers[$];
+
+    initial begin
+        aresetn <= 0;
+        repeat(4) @(posedge clock);
+        aresetn <= 1;
+        repeat(4) @(posedge clock);
+
+        axi_write(REG_TX_BASE, TX_RING);
+        axi_write(REG_TX_SIZE, TX_RING_SIZE);
+        axi_write(REG_RX_BASE, RX_RING);
+        axi_write(REG_RX_SIZE, RX_RING_SIZE);
+        axi_write(REG_IRQ_ENABLE, 3);
+        axi_write(REG_CONTROL, 3);
+
+        // A batch of TX frames is given with a write of TAIL.
+        frames = '{make_frame(60, 1), make_frame(63, 2), make_frame(MAX_FRAME_BYTES, 3)};
+        for(int i = 0; i < 3; i++) begin
+            write_buffer(32'h0001_0000 + 32'h800*i, frames[i]);
+            set_descriptor(TX_RING, i, 32'h0001_0000 + 32'h800*i, frames[i].size());
+        end
+        if( interrupt ) $error("interrupt before TX");
+        axi_write(REG_TX_TAIL, 3);
+        wait_register(REG_TX_HEAD, 3, "TX_HEAD of the batch");
+        for(int i = 0; i < 3; i++) begin
+            check_tx_frame("batch", frames[i]);
+            check_status("batch", TX_RING, i, STATUS_DONE | frames[i].size());
+        end
+        check_register(REG_TX_FRAMES, 3, "TX_FRAMES of the batch");
+        check_register(REG_STATUS, 1, "STATUS after TX");
+        if( !interrupt ) $error("no interrupt after TX");
+        axi_write(REG_STATUS, 1);
+        if( interrupt ) $error("interrupt after clearing");
+
+        // The ring wraps around, and bursts do not cross 4KB boundaries.
+        frames = '{make_frame(100, 4), make_frame(77, 5), make_frame(15, 6)};
+        tx_index = 3;
+        for(int i = 0; i < 3; i++) begin
+            automatic bit [31:0] buffer = 32'h0001_0ff0 + 32'h1000*i + 4*i;
+            write_buffer(buffer, frames[i]);
+            set_descriptor(TX_RING, tx_index, buffer, frames[i].size());
+            tx_index = (tx_index + 1) % TX_RING_SIZE;
+        end
+        axi_write(REG_TX_TAIL, tx_index);
+        wait_register(REG_TX_HEAD, tx_index, "TX_HEAD after wrapping");
+        for(int i = 0; i < 3; i++) begin
+            check_tx_frame("wrap", frames[i]);
+            check_status("wrap", TX_RING, (3 + i) % TX_RING_SIZE, STATUS_DONE | frames[i].size());
+        end
+
+        // Bad lengths and bus errors end the descriptors with the error bit, and nothing is output.
+        set_descriptor(TX_RING, 2, 32'h0001_0000, 0);
+        set_descriptor(TX_RING, 3, 32'h0001_0000, MAX_FRAME_BYTES + 1);
+        set_descriptor(TX_RING, 0, ERROR_ADDRESS, 100);
+        axi_write(REG_TX_TAIL, 1);
+        wait_register(REG_TX_HEAD, 1, "TX_HEAD after errors");
+        check_status("length 0", TX_RING, 2, STATUS_DONE | STATUS_ERROR);
+        check_status("too long", TX_RING, 3, STATUS_DONE | STATUS_ERROR | (MAX_FRAME_BYTES + 1));
+        check_status("bus error", TX_RING, 0, STATUS_DONE | STATUS_ERROR | 100);
+        repeat(100) @(posedge clock);
+        if( tx_frames.size() != 0 ) $error("%0d TX frames output by the errors", tx_frames.size());
+        check_register(REG_BUS_ERRORS, 25, "BUS_ERRORS of the 25 words");
+        check_register(REG_TX_FRAMES, 9, "TX_FRAMES after errors");
+
+        // RX frames are written to the buffers, and truncated to the size of the buffer.
+        frames = '{make_frame(60, 7), make_frame(255, 8), make_frame(300, 9)};
+        for(int i = 0; i < 3; i++) begin
+            fill_buffer(32'h0002_0000 + 32'h200*i, 320);
+            set_descriptor(RX_RING, i, 32'h0002_0000 + 32'h200*i, i == 2 ? 254 : 256);
+        end
+        axi_write(REG_RX_TAIL, 3);
+        for(int i = 0; i < 3; i++) send(frames[i], 0, i == 1);
+        wait_register(REG_RX_HEAD, 3, "RX_HEAD");
+        check_status("short", RX_RING, 0, STATUS_DONE | 60);
+        check_status("odd", RX_RING, 1, STATUS_DONE | 255);
+        check_status("truncated", RX_RING, 2, STATUS_DONE | STATUS_TRUNCATED | 300);
+        check_buffer("short", 32'h0002_0000, frames[0], 60, 320);
+        check_buffer("odd", 32'h0002_0200, frames[1], 255, 320);
+        check_buffer("truncated", 32'h0002_0400, frames[2], 254, 320);
+        check_register(REG_STATUS, 2, "STATUS after RX");
+        if( !interrupt ) $error("no interrupt after RX");
+        axi_write(REG_STATUS, 2);
+
+        // Frames with tuser and longer than MAX_FRAME_BYTES are dropped without descriptors.
+        send(make_frame(100, 10), 1);
+        send(make_frame(MAX_FRAME_BYTES + 1, 11));
+        repeat(100) @(posedge clock);
+        check_register(REG_RX_DROPS, 2, "RX_DROPS");
+        check_register(REG_RX_HEAD, 3, "RX_HEAD after drops");
+
+        // Frames wait for descriptors.
+        frames = '{make_frame(64, 12), make_frame(MAX_FRAME_BYTES, 13)};
+        foreach(frames[i]) send(frames[i]);
+        repeat(100) @(posedge clock);
+        check_register(REG_RX_HEAD, 3, "RX_HEAD without descriptors");
+        rx_index = 3;
+        for(int i = 0; i < 2; i++) begin
+            fill_buffer(32'h0003_0000 + 32'h200*i, 512);
+            set_descriptor(RX_RING, rx_index, 32'h0003_0000 + 32'h200*i, 512);
+            rx_index = (rx_index + 1) % RX_RING_SIZE;
+        end
+        axi_write(REG_RX_TAIL, rx_index);
+        wait_register(REG_RX_HEAD, rx_index, "RX_HEAD after giving descriptors");
+        for(int i = 0; i < 2; i++) begin
+            check_status("waited", RX_RING, (3 + i) % RX_RING_SIZE, STATUS_DONE | frames[i].size());
+            check_buffer("waited", 32'h0003_0000 + 32'h200*i, frames[i], frames[i].size(), 512);
+        end
+
+        // While RX is disabled, the frames are dropped and HEAD is reset.
+        axi_write(REG_CONTROL, 1);
+        send(make_frame(80, 14));
+        repeat(100) @(posedge clock);
+        check_register(REG_RX_DROPS, 3, "RX_DROPS while disabled");
+        check_register(REG_RX_HEAD, 0, "RX_HEAD while disabled");
+        check_register(REG_RX_FRAMES, 5, "RX_FRAMES");
+
+        // TX and RX at once with the TX output stalled at random. The rings start from 0 again.
+        axi_write(REG_CONTROL, 0);
+        axi_write(REG_TX_TAIL, 0);
+        axi_write(REG_RX_TAIL, 0);
+        wait_register(REG_TX_HEAD, 0, "TX_HEAD while disabled");
+        axi_write(REG_CONTROL, 3);
+        fork
+            begin
+                frame_t tx_expected[$];
+                for(int n = 0; n < 12; n++) begin
+                    automatic int index = n % TX_RING_SIZE;
+                    automatic bit [31:0] buffer = 32'h0004_0000 + 32'h800*index;
+                    automatic frame_t frame = make_frame(20 + 29*n, 20 + n);
+                    // Up to RING_SIZE - 1 descriptors are given, so the frame RING_SIZE - 1 before must be done.
+                    if( n >= TX_RING_SIZE - 1 ) begin
+                        automatic bit [31:0] status;
+                        do begin
+                            @(posedge clock);
+                            status = memory_read32(TX_RING + 16*((n + 1) % TX_RING_SIZE) + 8);
+                        end while(!status[31]);
+                    end
+                    write_buffer(buffer, frame);
+                    set_descriptor(TX_RING, index, buffer, frame.size());
+                    tx_expected.push_back(frame);
+                    axi_write(REG_TX_TAIL, (n + 1) % TX_RING_SIZE);
+                end
+                wait_register(REG_TX_HEAD, 12 % TX_RING_SIZE, "TX_HEAD after the stress");
+                repeat(2*MAX_FRAME_BYTES) @(posedge clock);
+                foreach(tx_expected[i]) check_tx_frame("stress", tx_expected[i]);
+            end
+            begin
+                for(int n = 0; n < 12; n++) send(make_frame(30 + 31*n, 40 + n), 0, 1);
+            end
+            begin
+                for(int n = 0; n < 12; n++) begin
+                    automatic int index = n % RX_RING_SIZE;
+                    automatic bit [31:0] buffer = 32'h0005_0000 + 32'h800*index;
+                    automatic frame_t frame = make_frame(30 + 31*n, 40 + n);
+                    fill_buffer(buffer, 512);
+                    set_descriptor(RX_RING, index, buffer, 512);
+                    axi_write(REG_RX_TAIL, (n + 1) % RX_RING_SIZE);
+                    wait_register(REG_RX_HEAD, (n + 1) % RX_RING_SIZE, "RX_HEAD in the stress");
+                    check_status("stress", RX_RING, index, STATUS_DONE | frame.size());
+                    check_buffer("stress", buffer, frame, frame.size(), 512);
+                end
+            end
+            begin
+                for(int i = 0; i < 20000; i++) begin
+                    tx_maxis_tready <= $urandom_range(0, 3) != 0;
+                    @(posedge clock);
+                end
+                tx_maxis_tready <= 1;
+            end
+        join
+        check_register(REG_TX_FRAMES, 21, "TX_FRAMES after the stress");
+        check_register(REG_RX_FRAMES, 17, "RX_FRAMES after the stress");
+        check_register(REG_RX_DROPS, 3, "RX_DROPS after the stress");
+
+        $finish;
+    end
+endmodule
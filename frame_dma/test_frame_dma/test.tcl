@@ -0,0 +1,2 @@
+add_wave -recursive *
+run all
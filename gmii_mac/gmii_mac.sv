@@ -0,0 +1,278 @@
+`default_nettype none
+
+module gmii_mac #(
+    parameter int TX_FIFO_DEPTH_BITS = 11,      // Cut-through FIFO on tx_saxis. 0 removes the FIFO.
+    parameter int TX_START_THRESHOLD = 256,     // Bytes buffered before a frame is started
+    parameter int TX_MUX_POLICY = 1,            // Arbitration between tx_saxis and tx_saxis_bypass. 0: strict priority, 1: round-robin, 2: DWRR
+    parameter int TX_MUX_QUANTUM = 1514,        // DWRR bytes per round of tx_saxis
+    parameter int TX_MUX_QUANTUM_BYPASS = 1514, // DWRR bytes per round of tx_saxis_bypass
+    parameter int RX_FIFO_DEPTH_BITS = 11       // RX FIFO, which drops the frames when rx_maxis is stalled longer than it holds
+) (
+    input wire tx_clock,                        // 125MHz
+    input wire tx_reset,
+
+    output wire [7:0] tx_gmii_d,
+    output wire       tx_gmii_en,
+    output wire       tx_gmii_er,
+
+    input  wire [7:0] tx_saxis_tdata,
+    input  wire       tx_saxis_tvalid,
+    output wire       tx_saxis_tready,
+    input  wire       tx_saxis_tlast,
+
+    // Ethernet bypass input
+    input  wire [7:0] tx_saxis_bypass_tdata,
+    input  wire       tx_saxis_bypass_tvalid,
+    output wire       tx_saxis_bypass_tready,
+    input  wire       tx_saxis_bypass_tlast,
+
+    input wire rx_clock,                        // 125MHz
+    input wire rx_reset,
+
+    input wire [7:0] rx_gmii_d,
+    input wire       rx_gmii_dv,
+    input wire       rx_gmii_er,
+
+    output wire  [7:0] rx_maxis_tdata,
+    output wire        rx_maxis_tvalid,
+    input  wire        rx_maxis_tready,
+    output wire        rx_maxis_tuser,
+    output wire        rx_maxis_tlast,
+
+    // Time base (tx_clock domain)
+    input  wire [47:0] time_seconds,
+    input  wire [31:0] time_nanoseconds,
+    input  wire        time_locked,
+
+    // SFD timestamps of the frames on rx_maxis (tx_clock domain)
+    output wire [95:0] rx_timestamp_maxis_tdata,
+    output wire        rx_timestamp_maxis_tvalid,
+    input  wire        rx_timestamp_maxis_tready,
+
+    // PTP event records of received and transmitted frames (tx_clock domain)
+    input  wire          ptp_one_step,
+    output wire [127:0]  ptp_rx_event_maxis_tdata,
+    output wire          ptp_rx_event_maxis_tvalid,
+    input  wire          ptp_rx_event_maxis_tready,
+    output wire [127:0]  ptp_tx_event_maxis_tdata,
+    output wire          ptp_tx_event_maxis_tvalid,
+    input  wire          ptp_tx_event_maxis_tready,
+
+    // IEEE 802.3x flow control (tx_clock domain)
+    input  wire [47:0] pause_source_address,    // Source address of the PAUSE frames. The first byte on the wire at [47:40]
+    input  wire        pause_request,           // Asynchronous. Sends XOFF while asserted and XON when deasserted.
+    output wire        tx_paused,               // Transmission is paused by the link partner.
+
+    // Frames on tx_saxis aborted by underruns of the TX FIFO (tx_clock domain)
+    output wire [31:0] tx_underrun_count,
+
+    // Arbitration counters of tx_saxis and tx_saxis_bypass (tx_clock domain, see axis_mux)
+    output wire [31:0] tx_grant_count,
+    output wire [31:0] tx_bypass_grant_count,
+    output wire [31:0] tx_wait_cycles,
+    output wire [31:0] tx_bypass_wait_cycles,
+    output wire [31:0] tx_starvation_count,
+    output wire [31:0] tx_bypass_starvation_count,
+
+    // Received frames dropped or aborted by the reasons (rx_clock domain, see mii_mac_rx)
+    output wire [31:0] rx_overflow_drop_count,
+    output wire [31:0] rx_overflow_abort_count,
+    output wire [31:0] rx_fcs_error_count
+);
+
+// GMII sends a byte every clock, so a frame must not wait for the bytes in the middle of it.
+// The TX FIFO starts a frame after TX_START_THRESHOLD bytes and aborts it on underruns.
+logic [7:0] tx_fifo_out_tdata;
+logic       tx_fifo_out_tvalid;
+logic       tx_fifo_out_tready;
+logic       tx_fifo_out_tuser;
+logic       tx_fifo_out_tlast;
+
+if( TX_FIFO_DEPTH_BITS > 0 ) begin :tx_fifo_block
+    tx_cut_through_fifo #(
+        .DEPTH_BITS(TX_FIFO_DEPTH_BITS),
+        .START_THRESHOLD(TX_START_THRESHOLD)
+    ) tx_cut_through_fifo_inst (
+        .clock(tx_clock),
+        .aresetn(!tx_reset),
+        .saxis_tdata(tx_saxis_tdata),
+        .saxis_tvalid(tx_saxis_tvalid),
+        .saxis_tready(tx_saxis_tready),
+        .saxis_tlast(tx_saxis_tlast),
+        .maxis_tdata(tx_fifo_out_tdata),
+        .maxis_tvalid(tx_fifo_out_tvalid),
+        .maxis_tready(tx_fifo_out_tready),
+        .maxis_tuser(tx_fifo_out_tuser),
+        .maxis_tlast(tx_fifo_out_tlast),
+        .level(),
+        .underrun_count(tx_underrun_count));
+end
+else begin :no_tx_fifo_block
+    assign tx_fifo_out_tdata = tx_saxis_tdata;
+    assign tx_fifo_out_tvalid = tx_saxis_tvalid;
+    assign tx_saxis_tready = tx_fifo_out_tready;
+    assign tx_fifo_out_tuser = 0;
+    assign tx_fifo_out_tlast = tx_saxis_tlast;
+    assign tx_underrun_count = 0;
+end
+
+logic rx_sfd;
+logic rx_frame_stored;
+logic        rx_ptp_event;
+logic [1:0]  rx_ptp_transport;
+logic [3:0]  rx_ptp_message_type;
+logic [7:0]  rx_ptp_domain_number;
+logic [15:0] rx_ptp_sequence_id;
+logic        rx_pause_valid;
+logic [15:0] rx_pause_quanta;
+logic [7:0]  pause_frame_tdata;
+logic        pause_frame_tvalid;
+logic        pause_frame_tready;
+logic        pause_frame_tlast;
+
+mii_mac_tx #(
+    .USE_GMII(1),
+    .MUX_POLICY(TX_MUX_POLICY),
+    .MUX_QUANTUM_PAYLOAD(TX_MUX_QUANTUM),
+    .MUX_QUANTUM_BYPASS(TX_MUX_QUANTUM_BYPASS)
+) mii_mac_tx_inst (
+    .clock(tx_clock),
+    .aresetn(!tx_reset),
+    .mii_d(tx_gmii_d),
+    .mii_en(tx_gmii_en),
+    .mii_er(tx_gmii_er),
+    .saxis_tdata(tx_fifo_out_tdata),
+    .saxis_tvalid(tx_fifo_out_tvalid),
+    .saxis_tready(tx_fifo_out_tready),
+    .saxis_tuser(tx_fifo_out_tuser),
+    .saxis_tlast(tx_fifo_out_tlast),
+    .saxis_bypass_tdata(tx_saxis_bypass_tdata),
+    .saxis_bypass_tvalid(tx_saxis_bypass_tvalid),
+    .saxis_bypass_tready(tx_saxis_bypass_tready),
+    .saxis_bypass_tuser(1'b0),
+    .saxis_bypass_tlast(tx_saxis_bypass_tlast),
+    .saxis_control_tdata(pause_frame_tdata),
+    .saxis_control_tvalid(pause_frame_tvalid),
+    .saxis_control_tready(pause_frame_tready),
+    .saxis_control_tlast(pause_frame_tlast),
+    .pause(tx_paused),
+    .gate_hold_payload(1'b0),
+    .gate_hold_bypass(1'b0),
+    .time_seconds(time_seconds),
+    .time_nanoseconds(time_nanoseconds),
+    .ptp_one_step(ptp_one_step),
+    .ptp_event_maxis_tdata(ptp_tx_event_maxis_tdata),
+    .ptp_event_maxis_tvalid(ptp_tx_event_maxis_tvalid),
+    .ptp_event_maxis_tready(ptp_tx_event_maxis_tready),
+    .payload_grant_count(tx_grant_count),
+    .bypass_grant_count(tx_bypass_grant_count),
+    .payload_wait_cycles(tx_wait_cycles),
+    .bypass_wait_cycles(tx_bypass_wait_cycles),
+    .payload_starvation_count(tx_starvation_count),
+    .bypass_starvation_count(tx_bypass_starvation_count),
+    .macsec_s_axi_awaddr(8'h00),
+    .macsec_s_axi_awvalid(1'b0),
+    .macsec_s_axi_awready(),
+    .macsec_s_axi_wdata(32'h0),
+    .macsec_s_axi_wstrb(4'h0),
+    .macsec_s_axi_wvalid(1'b0),
+    .macsec_s_axi_wready(),
+    .macsec_s_axi_bresp(),
+    .macsec_s_axi_bvalid(),
+    .macsec_s_axi_bready(1'b0),
+    .macsec_s_axi_araddr(8'h00),
+    .macsec_s_axi_arvalid(1'b0),
+    .macsec_s_axi_arready(),
+    .macsec_s_axi_rdata(),
+    .macsec_s_axi_rresp(),
+    .macsec_s_axi_rvalid(),
+    .macsec_s_axi_rready(1'b0));
+
+mii_mac_rx #(
+    .USE_GMII(1),
+    .FIFO_DEPTH_BITS(RX_FIFO_DEPTH_BITS)
+) mii_mac_rx_inst (
+    .clock(rx_clock),
+    .aresetn(!rx_reset),
+    .mii_d(rx_gmii_d),
+    .mii_dv(rx_gmii_dv),
+    .mii_er(rx_gmii_er),
+    .maxis_tdata(rx_maxis_tdata),
+    .maxis_tvalid(rx_maxis_tvalid),
+    .maxis_tready(rx_maxis_tready),
+    .maxis_tuser(rx_maxis_tuser),
+    .maxis_tlast(rx_maxis_tlast),
+    .sfd(rx_sfd),
+    .frame_stored(rx_frame_stored),
+    .overflow_drop_count(rx_overflow_drop_count),
+    .overflow_abort_count(rx_overflow_abort_count),
+    .fcs_error_count(rx_fcs_error_count),
+    .ptp_event(rx_ptp_event),
+    .ptp_transport(rx_ptp_transport),
+    .ptp_message_type(rx_ptp_message_type),
+    .ptp_domain_number(rx_ptp_domain_number),
+    .ptp_sequence_id(rx_ptp_sequence_id),
+    .pause_valid(rx_pause_valid),
+    .pause_quanta(rx_pause_quanta),
+    .macsec_s_axi_awaddr(8'h00),
+    .macsec_s_axi_awvalid(1'b0),
+    .macsec_s_axi_awready(),
+    .macsec_s_axi_wdata(32'h0),
+    .macsec_s_axi_wstrb(4'h0),
+    .macsec_s_axi_wvalid(1'b0),
+    .macsec_s_axi_wready(),
+    .macsec_s_axi_bresp(),
+    .macsec_s_axi_bvalid(),
+    .macsec_s_axi_bready(1'b0),
+    .macsec_s_axi_araddr(8'h00),
+    .macsec_s_axi_arvalid(1'b0),
+    .macsec_s_axi_arready(),
+    .macsec_s_axi_rdata(),
+    .macsec_s_axi_rresp(),
+    .macsec_s_axi_rvalid(),
+    .macsec_s_axi_rready(1'b0));
+
+pause_control #(
+    .CLOCKS_PER_QUANTUM(64)
+) pause_control_inst (
+    .rx_clock(rx_clock),
+    .rx_aresetn(!rx_reset),
+    .rx_pause_valid(rx_pause_valid),
+    .rx_pause_quanta(rx_pause_quanta),
+    .clock(tx_clock),
+    .aresetn(!tx_reset),
+    .source_address(pause_source_address),
+    .pause_request(pause_request),
+    .paused(tx_paused),
+    .maxis_tdata(pause_frame_tdata),
+    .maxis_tvalid(pause_frame_tvalid),
+    .maxis_tready(pause_frame_tready),
+    .maxis_tlast(pause_frame_tlast));
+
+rx_timestamp #(
+    .LATENCY_NANOSECONDS(36)    // 2 RX clocks + 2.5 time base clocks at 125MHz
+) rx_timestamp_inst (
+    .rx_clock(rx_clock),
+    .rx_aresetn(!rx_reset),
+    .rx_sfd(rx_sfd),
+    .rx_frame_stored(rx_frame_stored),
+    .rx_ptp_event(rx_ptp_event),
+    .rx_ptp_transport(rx_ptp_transport),
+    .rx_ptp_message_type(rx_ptp_message_type),
+    .rx_ptp_domain_number(rx_ptp_domain_number),
+    .rx_ptp_sequence_id(rx_ptp_sequence_id),
+    .clock(tx_clock),
+    .aresetn(!tx_reset),
+    .time_seconds(time_seconds),
+    .time_nanoseconds(time_nanoseconds),
+    .time_locked(time_locked),
+    .maxis_tdata(rx_timestamp_maxis_tdata),
+    .maxis_tvalid(rx_timestamp_maxis_tvalid),
+    .maxis_tready(rx_timestamp_maxis_tready),
+    .ptp_maxis_tdata(ptp_rx_event_maxis_tdata),
+    .ptp_maxis_tvalid(ptp_rx_event_maxis_tvalid),
+    .ptp_maxis_tready(ptp_rx_event_maxis_tready));
+
+endmodule
+
+`default_nettype wire
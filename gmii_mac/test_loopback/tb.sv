@@ -0,0 +1,224 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+
+    axis_if #(.DATA_WIDTH(1)) tb_maxis_if(.clock(clock), .aresetn(aresetn));
+    axis_if #(.DATA_WIDTH(1)) tb_saxis_if(.clock(clock), .aresetn(aresetn));
+
+    localparam [31:0] POLYNOMIAL = 32'b1110_1101_1011_1000_1000_0011_0010_0000;
+
+    logic [7:0] mii_d;
+    logic       mii_en;
+    logic       mii_er;
+
+    logic [7:0] saxis_bypass_tdata = 0;
+    logic       saxis_bypass_tvalid = 0;
+    logic       saxis_bypass_tready;
+    logic       saxis_bypass_tuser = 0;
+    logic       saxis_bypass_tlast = 0;
+
+    logic [47:0] time_seconds = 0;
+    logic [31:0] time_nanoseconds = 0;
+    logic        sfd;
+
+    logic         ptp_one_step = 0;
+    logic [127:0] ptp_event_maxis_tdata;
+    logic         ptp_event_maxis_tvalid;
+    logic         ptp_event_maxis_tready = 1;
+    logic         ptp_event;
+    logic [1:0]   ptp_transport;
+    logic [3:0]   ptp_message_type;
+    logic [7:0]   ptp_domain_number;
+    logic [15:0]  ptp_sequence_id;
+
+    logic [7:0]   saxis_control_tdata = 0;
+    logic         saxis_control_tvalid = 0;
+    logic         saxis_control_tready;
+    logic         saxis_control_tlast = 0;
+    logic         pause = 0;
+    logic         gate_hold_payload = 0;
+    logic         gate_hold_bypass = 0;
+    logic         pause_valid;
+    logic [15:0]  pause_quanta;
+
+    logic [31:0]  payload_grant_count;
+    logic [31:0]  bypass_grant_count;
+    logic [31:0]  payload_wait_cycles;
+    logic [31:0]  bypass_wait_cycles;
+    logic [31:0]  payload_starvation_count;
+    logic [31:0]  bypass_starvation_count;
+
+    logic         frame_stored;
+    logic [31:0]  overflow_drop_count;
+    logic [31:0]  overflow_abort_count;
+    logic [31:0]  fcs_error_count;
+
+    // MACsec registers of both, which do not respond without USE_MACSEC
+    logic  [7:0]  macsec_s_axi_awaddr = 0;
+    logic         macsec_s_axi_awvalid = 0;
+    wire          macsec_s_axi_awready;
+    logic [31:0]  macsec_s_axi_wdata = 0;
+    logic  [3:0]  macsec_s_axi_wstrb = 0;
+    logic         macsec_s_axi_wvalid = 0;
+    wire          macsec_s_axi_wready;
+    wire   [1:0]  macsec_s_axi_bresp;
+    wire          macsec_s_axi_bvalid;
+    logic         macsec_s_axi_bready = 0;
+    logic  [7:0]  macsec_s_axi_araddr = 0;
+    logic         macsec_s_axi_arvalid = 0;
+    wire          macsec_s_axi_arready;
+    wire  [31:0]  macsec_s_axi_rdata;
+    wire   [1:0]  macsec_s_axi_rresp;
+    wire          macsec_s_axi_rvalid;
+    logic         macsec_s_axi_rready = 0;
+
+    mii_mac_tx #(.USE_GMII(1)) dut_tx(
+        .saxis_tdata (tb_maxis_if.tdata ),
+        .saxis_tvalid(tb_maxis_if.tvalid),
+        .saxis_tready(tb_maxis_if.tready),
+        .saxis_tuser (tb_maxis_if.tuser ),
+        .saxis_tlast (tb_maxis_if.tlast ),
+        .*
+    );
+
+    mii_mac_rx #(.USE_GMII(1)) dut_rx(
+        .maxis_tdata (tb_saxis_if.tdata ),
+        .maxis_tvalid(tb_saxis_if.tvalid),
+        .maxis_tready(tb_saxis_if.tready),
+        .maxis_tuser (tb_saxis_if.tuser ),
+        .maxis_tlast (tb_saxis_if.tlast ),
+        .mii_dv(mii_en),
+        .*
+    );
+
+    localparam NUMBER_OF_INPUTS = 1000;
+    
+    initial begin
+        clock = 0;
+    end 
+    always #(4) begin
+        clock = ~clock;
+    end
+    
+    typedef struct {
+        bit [7:0] tdata;
+        bit       tlast;
+        bit       tuser;
+    } tv_axis;
+
+    localparam int MIN_BYTES = 1;
+    localparam int MAX_BYTES = 1500;
+    localparam int MIN_FRAME_BYTES = 60;    // Shorter frames are padded by the MAC.
+
+    module stimuli (
+        input logic clock,
+        output logic aresetn,
+        axis_if.master tb_maxis,
+        axis_if.slave tb_saxis
+    );
+        initial begin
+            tv_axis axis_in[$];
+            tv_axis axis_out[$];
+            bit     tusers[];
+            int data_counter;
+            
+            data_counter = 0;
+            // Generate test inputs
+            for(int i = 0; i < NUMBER_OF_INPUTS; i++ ) begin
+                int length;
+                bit [7:0] data [MAX_BYTES+8-1:0];
+
+                length = $urandom_range(MIN_BYTES, MAX_BYTES);
+                for(int data_index = 0; data_index < length; data_index ++) begin
+                    int value;
+                    value = $urandom();
+                    data[data_index] = data_counter; //value[8*0 +: 8];
+                    data_counter += 1;
+                end
+
+                // input and output must be identical except the padding.
+                for(int data_index = 0; data_index < length; data_index++ ) begin
+                    tv_axis row;
+                    int remaining;
+                    remaining = length - data_index;
+                    row.tdata= data[data_index];
+                    row.tlast = remaining == 1;
+                    row.tuser = !row.tlast;
+                    axis_in.push_back(row);
+                    row.tlast = row.tlast && length >= MIN_FRAME_BYTES;
+                    row.tuser = !row.tlast;
+                    axis_out.push_back(row);
+                    //$display("input #%04d: tdata=%02x, tlast=%d", i, row.tdata, row.tlast);
+                end
+                for(int data_index = length; data_index < MIN_FRAME_BYTES; data_index++ ) begin
+                    tv_axis row;
+                    row.tdata = 0;
+                    row.tlast = data_index == MIN_FRAME_BYTES - 1;
+                    row.tuser = !row.tlast;
+                    axis_out.push_back(row);
+                end
+            end
+            
+            // Reset 
+            aresetn <= 0;
+            tb_maxis.master_init;
+            tb_saxis.slave_init;
+            repeat(4) @(posedge clock);
+            aresetn <= 1;
+            @(posedge clock);
+            
+            fork
+                fork
+                    begin
+                        while(axis_in.size() > 0) begin
+                            while(axis_in.size() > 0) begin
+                                tv_axis row;
+                                
+                                row = axis_in.pop_front();
+                                tb_maxis.master_send(row.tdata, 1'b1, row.tlast, row.tuser);
+                                if( row.tlast ) break;
+                            end
+                            repeat($urandom_range(0, 2)) @(posedge clock);
+                        end
+                    end
+                    begin
+                        for(int i = 0; axis_out.size() > 0; i++ ) begin
+                            while(axis_out.size() > 0) begin
+                                tv_axis row;
+                                bit [7: 0] tdata;
+                                bit        tkeep;
+                                bit        tuser;
+                                bit        tlast;
+
+                                row = axis_out.pop_front();
+
+                                tb_saxis.slave_receive(tdata, tkeep, tlast, tuser, 0);
+
+                                if( row.tdata != tdata )              $error("#%02d tdata mismatch, expected=%02h, actual=%02h", i, row.tdata, tdata);
+                                if( row.tlast != tlast )              $error("#%02d tlast mismatch, expected=%d, actual=%d"    , i, row.tlast, tlast);
+                                if( row.tlast && row.tuser != tuser ) $error("#%02d tuser mismatch, expected=%d, actual=%d"    , i, row.tuser, tuser);
+                                if( row.tlast ) begin
+                                    break;
+                                end
+                            end
+                        end
+                    end
+                join
+                begin
+                    repeat(NUMBER_OF_INPUTS*MAX_BYTES*20) @(posedge clock);
+                    $error("timed out");
+                end
+            join_any
+            disable fork;
+            $finish;
+        end
+    endmodule
+
+    stimuli stimuli_inst (
+        .tb_maxis(tb_maxis_if),
+        .tb_saxis(tb_saxis_if),
+        .*
+    );
+endmodule
@@ -0,0 +1,94 @@
+`default_nettype none
+
+// Merges the frames of INPUTS streams into one, a frame at a time, taking the inputs round-robin.
+// maxis_tdest tells the input of the frame.
+// saxis_tmeta of a frame is output on meta_maxis before the frame, so the frame waits while meta_maxis is stalled.
+module axis_frame_merge #(
+    parameter int INPUTS = 2,
+    parameter int META_BITS = 1,
+    parameter int DEST_BITS = 4
+) (
+    input wire clock,
+    input wire aresetn,
+
+    input  wire [INPUTS-1:0][7:0]           saxis_tdata,
+    input  wire [INPUTS-1:0]                saxis_tvalid,
+    output logic [INPUTS-1:0]               saxis_tready,
+    input  wire [INPUTS-1:0]                saxis_tlast,
+    input  wire [INPUTS-1:0][META_BITS-1:0] saxis_tmeta,
+
+    output wire [7:0]           maxis_tdata,
+    output wire                 maxis_tvalid,
+    input  wire                 maxis_tready,
+    output wire                 maxis_tlast,
+    output wire [DEST_BITS-1:0] maxis_tdest,
+
+    output wire [META_BITS-1:0] meta_maxis_tdata,
+    output wire [DEST_BITS-1:0] meta_maxis_tdest,
+    output wire                 meta_maxis_tvalid,
+    input  wire                 meta_maxis_tready
+);
+
+localparam int INPUT_BITS = INPUTS > 1 ? $clog2(INPUTS) : 1;
+
+logic [INPUT_BITS-1:0] selected;
+logic                  in_frame;
+logic                  meta_pending;    // meta_maxis of the selected frame is not accepted yet.
+
+// The next input with a frame after the last one
+logic                  next_valid;
+logic [INPUT_BITS-1:0] next_selected;
+always_comb begin
+    next_valid = 0;
+    next_selected = selected;
+    for(int k = INPUTS; k >= 1; k--) begin
+        if( saxis_tvalid[(selected + k) % INPUTS] ) begin
+            next_valid = 1;
+            next_selected = INPUT_BITS'((selected + k) % INPUTS);
+        end
+    end
+end
+
+wire pass = in_frame && !meta_pending;
+
+assign maxis_tdata = saxis_tdata[selected];
+assign maxis_tvalid = pass && saxis_tvalid[selected];
+assign maxis_tlast = saxis_tlast[selected];
+assign maxis_tdest = DEST_BITS'(selected);
+
+assign meta_maxis_tdata = saxis_tmeta[selected];
+assign meta_maxis_tdest = DEST_BITS'(selected);
+assign meta_maxis_tvalid = in_frame && meta_pending && saxis_tvalid[selected];
+
+always_comb begin
+    for(int i = 0; i < INPUTS; i++) begin
+        saxis_tready[i] = i == selected && pass && maxis_tready;
+    end
+end
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        selected <= 0;
+        in_frame <= 0;
+        meta_pending <= 0;
+    end
+    else if( !in_frame ) begin
+        if( next_valid ) begin
+            selected <= next_selected;
+            in_frame <= 1;
+            meta_pending <= 1;
+        end
+    end
+    else begin
+        if( meta_maxis_tvalid && meta_maxis_tready ) begin
+            meta_pending <= 0;
+        end
+        if( maxis_tvalid && maxis_tready && maxis_tlast ) begin
+            in_frame <= 0;
+        end
+    end
+end
+
+endmodule
+
+`default_nettype wire
@@ -0,0 +1,456 @@
+`default_nettype none
+
+// Learning switch fabric of PORTS ports on byte streams of frames without the preamble and the FCS.
+// The ingress ports cannot be stalled. Each of them stores the frames in an rx_frame_fifo in the packet mode,
+// which drops the frames with tuser at tlast, shorter than MIN_FRAME_BYTES or longer than MAX_FRAME_BYTES,
+// and the frames overflowing it.
+// The stored frames are forwarded one at a time, taking the ingress ports round-robin.
+// The source address of a frame is learned for its ingress port and the destination address is looked up in mac_table.
+// Broadcast, multicast and unknown unicast frames are flooded to all ports but the ingress port,
+// and frames to the ingress port itself are filtered.
+// A frame is written to an egress port only if its FIFO has room for MAX_FRAME_BYTES, and dropped for the port otherwise,
+// so a stalled port does not hold the others. The egress FIFOs are also in the packet mode, so a frame is output without gaps.
+// The fabric moves a byte per clock for all the ports, and a frame takes 14 clocks more than its length.
+// saxis_tmeta at tlast is passed with the frame to maxis_tmeta of the egress ports, together with the ingress port on maxis_tid.
+// Both are valid through the frame on the egress port.
+// ingress_room tells that the ingress FIFO of the port can take a frame of MAX_FRAME_BYTES, so that a source which can wait
+// starts a frame only while it is set and none of its frames is dropped by overflow.
+//
+// Registers (32bit access only)
+//   0x00 CONTROL          W   bit0: flush the MAC table
+//   0x04 AGING_TIME       RW  seconds before a learned address is forgotten. 0 disables the aging. (default 300)
+//   0x08 ENTRIES          R   learned addresses
+//   0x0c FLOOD_COUNT      R   frames flooded
+//   0x10 FILTER_COUNT     R   frames filtered because the destination is on the ingress port
+//   0x40 + 16*n RX_FRAMES R   frames forwarded, flooded or filtered from port n
+//   0x44 + 16*n TX_FRAMES R   frames written to port n
+//   0x48 + 16*n RX_DROPS  R   frames of port n dropped at the ingress
+//   0x4c + 16*n TX_DROPS  R   frames to port n dropped because its FIFO was full
+module l2_switch #(
+    parameter int PORTS = 3,                        // 2 to 12
+    parameter int INGRESS_DEPTH_BITS = 11,
+    parameter int EGRESS_DEPTH_BITS = 12,           // Must hold MAX_FRAME_BYTES. 2 frames or more are recommended.
+    parameter int FRAME_DEPTH_BITS = 5,             // Frames in each FIFO. Frames more than that are dropped.
+    parameter int MIN_FRAME_BYTES = 14,             // 13 or more
+    parameter int MAX_FRAME_BYTES = 1518,
+    parameter int META_BITS = 1,
+    parameter int TABLE_BITS = 8,
+    parameter int AGING_TICK_CLOCKS = 25000000,     // Clocks per second of AGING_TIME
+    parameter int ADDR_BITS = 8
+) (
+    input wire clock,
+    input wire aresetn,
+
+    input  wire [PORTS-1:0][7:0]           saxis_tdata,
+    input  wire [PORTS-1:0]                saxis_tvalid,
+    input  wire [PORTS-1:0]                saxis_tuser,
+    input  wire [PORTS-1:0]                saxis_tlast,
+    input  wire [PORTS-1:0][META_BITS-1:0] saxis_tmeta,
+    output wire [PORTS-1:0]                ingress_room,
+
+    output wire [PORTS-1:0][7:0]           maxis_tdata,
+    output wire [PORTS-1:0]                maxis_tvalid,
+    input  wire [PORTS-1:0]                maxis_tready,
+    output wire [PORTS-1:0]                maxis_tlast,
+    output wire [PORTS-1:0][META_BITS-1:0] maxis_tmeta,
+    output wire [PORTS-1:0][$clog2(PORTS)-1:0] maxis_tid,
+
+    input  wire  [ADDR_BITS-1:0] s_axi_awaddr,
+    input  wire                  s_axi_awvalid,
+    output logic                 s_axi_awready,
+    input  wire  [31:0]          s_axi_wdata,
+    input  wire  [3:0]           s_axi_wstrb,
+    input  wire                  s_axi_wvalid,
+    output logic                 s_axi_wready,
+    output logic [1:0]           s_axi_bresp,
+    output logic                 s_axi_bvalid,
+    input  wire                  s_axi_bready,
+    input  wire  [ADDR_BITS-1:0] s_axi_araddr,
+    input  wire                  s_axi_arvalid,
+    output logic                 s_axi_arready,
+    output logic [31:0]          s_axi_rdata,
+    output logic [1:0]           s_axi_rresp,
+    output logic                 s_axi_rvalid,
+    input  wire                  s_axi_rready
+);
+
+localparam int PORT_BITS = $clog2(PORTS);
+localparam int LENGTH_BITS = $clog2(MAX_FRAME_BYTES + 2);
+localparam int EGRESS_ROOM_LEVEL = 2**EGRESS_DEPTH_BITS - 1 - MAX_FRAME_BYTES;
+localparam int INGRESS_ROOM_LEVEL = 2**INGRESS_DEPTH_BITS - 1 - MAX_FRAME_BYTES;
+
+localparam int REG_CONTROL = 0;
+localparam int REG_AGING_TIME = 1;
+localparam int REG_ENTRIES = 2;
+localparam int REG_FLOOD_COUNT = 3;
+localparam int REG_FILTER_COUNT = 4;
+localparam int REG_PORT = 16;
+localparam int REG_PORT_RX_FRAMES = 0;
+localparam int REG_PORT_TX_FRAMES = 1;
+localparam int REG_PORT_RX_DROPS = 2;
+localparam int REG_PORT_TX_DROPS = 3;
+
+logic        flush;
+logic [15:0] aging_time;
+logic [TABLE_BITS:0] entries;
+logic [31:0] flood_count;
+logic [31:0] filter_count;
+logic [31:0] rx_frame_count[PORTS-1:0];
+logic [31:0] tx_frame_count[PORTS-1:0];
+logic [31:0] rx_drop_count[PORTS-1:0];
+logic [31:0] tx_drop_count[PORTS-1:0];
+
+// AXI4-Lite write
+logic write_enable;
+logic [ADDR_BITS-3:0] write_index;
+assign write_enable = s_axi_awvalid && s_axi_wvalid && !s_axi_bvalid;
+assign write_index = s_axi_awaddr[ADDR_BITS-1:2];
+assign s_axi_awready = write_enable;
+assign s_axi_wready = write_enable;
+assign s_axi_bresp = 2'b00;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        s_axi_bvalid <= 0;
+        flush <= 0;
+        aging_time <= 300;
+    end
+    else begin
+        flush <= 0;
+        if( s_axi_bvalid && s_axi_bready ) begin
+            s_axi_bvalid <= 0;
+        end
+        if( write_enable ) begin
+            s_axi_bvalid <= 1;
+            case(write_index)
+            REG_CONTROL: flush <= s_axi_wdata[0];
+            REG_AGING_TIME: aging_time <= s_axi_wdata[15:0];
+            default: ;
+            endcase
+        end
+    end
+end
+
+// AXI4-Lite read
+logic [ADDR_BITS-3:0] read_index;
+assign read_index = s_axi_araddr[ADDR_BITS-1:2];
+assign s_axi_arready = !s_axi_rvalid;
+assign s_axi_rresp = 2'b00;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        s_axi_rvalid <= 0;
+        s_axi_rdata <= 0;
+    end
+    else begin
+        if( s_axi_rvalid && s_axi_rready ) begin
+            s_axi_rvalid <= 0;
+        end
+        if( s_axi_arvalid && s_axi_arready ) begin
+            s_axi_rvalid <= 1;
+            case(read_index)
+            REG_AGING_TIME: s_axi_rdata <= {16'b0, aging_time};
+            REG_ENTRIES: s_axi_rdata <= 32'(entries);
+            REG_FLOOD_COUNT: s_axi_rdata <= flood_count;
+            REG_FILTER_COUNT: s_axi_rdata <= filter_count;
+            default: begin
+                s_axi_rdata <= 0;
+                for(int i = 0; i < PORTS; i++) begin
+                    if( read_index == REG_PORT + i*4 + REG_PORT_RX_FRAMES ) s_axi_rdata <= rx_frame_count[i];
+                    if( read_index == REG_PORT + i*4 + REG_PORT_TX_FRAMES ) s_axi_rdata <= tx_frame_count[i];
+                    if( read_index == REG_PORT + i*4 + REG_PORT_RX_DROPS ) s_axi_rdata <= rx_drop_count[i];
+                    if( read_index == REG_PORT + i*4 + REG_PORT_TX_DROPS ) s_axi_rdata <= tx_drop_count[i];
+                end
+            end
+            endcase
+        end
+    end
+end
+
+// Frames stored in the ingress FIFOs
+logic [PORTS-1:0][7:0]           ingress_tdata;
+logic [PORTS-1:0]                ingress_tvalid;
+logic [PORTS-1:0]                ingress_tready;
+logic [PORTS-1:0]                ingress_tlast;
+logic [PORTS-1:0][META_BITS-1:0] ingress_tmeta;
+logic [PORTS-1:0]                ingress_done;      // The frame at the head is read out.
+
+// Frames to the egress FIFOs
+logic [7:0]                      egress_tdata;
+logic [PORTS-1:0]                egress_tvalid;
+logic                            egress_tlast;
+logic [PORT_BITS-1:0]            egress_tid;
+logic [META_BITS-1:0]            egress_tmeta;
+logic [PORTS-1:0]                egress_room;       // The egress FIFO can take a frame.
+
+for(genvar i = 0; i < PORTS; i++) begin :port_block
+    // Ingress
+    logic [LENGTH_BITS-1:0] length;                 // Bytes before the current one, saturated
+    logic [FRAME_DEPTH_BITS:0] stored_frames;
+    logic                   frame_stored;
+    logic                   frame_ended;
+    logic [META_BITS-1:0]   frame_meta;
+    logic [INGRESS_DEPTH_BITS:0] ingress_level;
+
+    // One frame may have ended without being counted in stored_frames yet.
+    assign ingress_room[i] = ingress_level <= INGRESS_ROOM_LEVEL && stored_frames + frame_stored < 2**FRAME_DEPTH_BITS - 1;
+
+    wire [LENGTH_BITS-1:0] frame_bytes = length + 1;
+    wire no_frame_room = stored_frames + frame_stored >= 2**FRAME_DEPTH_BITS;
+    wire reject = saxis_tlast[i] && (frame_bytes < MIN_FRAME_BYTES || frame_bytes > MAX_FRAME_BYTES || no_frame_room);
+
+    always_ff @(posedge clock) begin
+        if( !aresetn ) begin
+            length <= 0;
+            stored_frames <= 0;
+            frame_ended <= 0;
+            frame_meta <= 0;
+            rx_drop_count[i] <= 0;
+        end
+        else begin
+            frame_ended <= saxis_tvalid[i] && saxis_tlast[i];
+            if( saxis_tvalid[i] ) begin
+                length <= saxis_tlast[i] ? 0 : frame_bytes > MAX_FRAME_BYTES ? length : frame_bytes;
+                if( saxis_tlast[i] ) begin
+                    frame_meta <= saxis_tmeta[i];
+                end
+            end
+            stored_frames <= stored_frames + frame_stored - ingress_done[i];
+            // Every frame which is not stored is dropped.
+            if( frame_ended && !frame_stored ) begin
+                rx_drop_count[i] <= rx_drop_count[i] + 1;
+            end
+        end
+    end
+
+    rx_frame_fifo #(
+        .DEPTH_BITS(INGRESS_DEPTH_BITS),
+        .PACKET_MODE(1)
+    ) ingress_fifo_inst (
+        .clock(clock),
+        .aresetn(aresetn),
+        .saxis_tdata(saxis_tdata[i]),
+        .saxis_tvalid(saxis_tvalid[i]),
+        .saxis_tuser(saxis_tuser[i] || reject),
+        .saxis_tlast(saxis_tlast[i]),
+        .maxis_tdata(ingress_tdata[i]),
+        .maxis_tvalid(ingress_tvalid[i]),
+        .maxis_tready(ingress_tready[i]),
+        .maxis_tuser(),
+        .maxis_tlast(ingress_tlast[i]),
+        .level(ingress_level),
+        .frame_stored(frame_stored),
+        .drop_count(),
+        .abort_count());
+
+    simple_fifo #(
+        .DATA_BITS(META_BITS),
+        .DEPTH_BITS(FRAME_DEPTH_BITS)
+    ) ingress_meta_fifo_inst (
+        .clock(clock),
+        .aresetn(aresetn),
+        .saxis_tdata(frame_meta),
+        .saxis_tvalid(frame_stored),
+        .saxis_tready(),
+        .maxis_tdata(ingress_tmeta[i]),
+        .maxis_tvalid(),
+        .maxis_tready(ingress_done[i]));
+
+    // Egress
+    logic [EGRESS_DEPTH_BITS:0] egress_level;
+    logic                       egress_meta_tready;
+    logic                       output_tvalid;
+    logic                       output_tlast;
+
+    assign egress_room[i] = egress_level <= EGRESS_ROOM_LEVEL && egress_meta_tready;
+
+    rx_frame_fifo #(
+        .DEPTH_BITS(EGRESS_DEPTH_BITS),
+        .PACKET_MODE(1)
+    ) egress_fifo_inst (
+        .clock(clock),
+        .aresetn(aresetn),
+        .saxis_tdata(egress_tdata),
+        .saxis_tvalid(egress_tvalid[i]),
+        .saxis_tuser(1'b0),
+        .saxis_tlast(egress_tlast),
+        .maxis_tdata(maxis_tdata[i]),
+        .maxis_tvalid(output_tvalid),
+        .maxis_tready(maxis_tready[i]),
+        .maxis_tuser(),
+        .maxis_tlast(output_tlast),
+        .level(egress_level),
+        .frame_stored(),
+        .drop_count(),
+        .abort_count());
+
+    assign maxis_tvalid[i] = output_tvalid;
+    assign maxis_tlast[i] = output_tlast;
+
+    // The side information is written with the last byte, so it is ready when the frame is output.
+    simple_fifo #(
+        .DATA_BITS(PORT_BITS + META_BITS),
+        .DEPTH_BITS(FRAME_DEPTH_BITS)
+    ) egress_meta_fifo_inst (
+        .clock(clock),
+        .aresetn(aresetn),
+        .saxis_tdata({egress_tid, egress_tmeta}),
+        .saxis_tvalid(egress_tvalid[i] && egress_tlast),
+        .saxis_tready(egress_meta_tready),
+        .maxis_tdata({maxis_tid[i], maxis_tmeta[i]}),
+        .maxis_tvalid(),
+        .maxis_tready(output_tvalid && maxis_tready[i] && output_tlast));
+end
+
+// Forwarding
+typedef enum logic [2:0] {
+    S_IDLE,
+    S_HEADER,
+    S_LOOKUP,
+    S_FORWARD_HEADER,
+    S_FORWARD,
+    S_DISCARD
+} state_t;
+
+state_t state;
+logic [PORT_BITS-1:0] source;           // Ingress port of the frame
+logic [PORTS-1:0]     forward_mask;
+logic [7:0]           header[11:0];     // Destination and source addresses
+logic [3:0]           header_index;
+
+wire [7:0] in_tdata  = ingress_tdata[source];
+wire       in_tvalid = ingress_tvalid[source];
+wire       in_tlast  = ingress_tlast[source];
+
+// The next ingress port with a frame after the last one
+logic                 next_valid;
+logic [PORT_BITS-1:0] next_source;
+always_comb begin
+    next_valid = 0;
+    next_source = source;
+    for(int k = PORTS; k >= 1; k--) begin
+        if( ingress_tvalid[(source + k) % PORTS] ) begin
+            next_valid = 1;
+            next_source = PORT_BITS'((source + k) % PORTS);
+        end
+    end
+end
+
+wire [47:0] destination_address = {header[0], header[1], header[2], header[3], header[4], header[5]};
+wire [47:0] source_address = {header[6], header[7], header[8], header[9], header[10], header[11]};
+logic                 lookup_hit;
+logic [PORT_BITS-1:0] lookup_port;
+
+// The I/G bit is the LSB of the first byte.
+wire flood = destination_address[40] || !lookup_hit;
+wire filter = !flood && lookup_port == source;
+wire [PORTS-1:0] candidate_mask = flood ? ~(PORTS'(1) << source) : filter ? '0 : PORTS'(1) << lookup_port;
+
+mac_table #(
+    .TABLE_BITS(TABLE_BITS),
+    .PORT_BITS(PORT_BITS),
+    .TICK_CLOCKS(AGING_TICK_CLOCKS),
+    .EPOCH_BITS(16)
+) mac_table_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .lookup_address(destination_address),
+    .lookup_hit(lookup_hit),
+    .lookup_port(lookup_port),
+    .learn(state == S_LOOKUP && !source_address[40]),
+    .learn_address(source_address),
+    .learn_port(source),
+    .flush(flush),
+    .aging_time(aging_time),
+    .entries(entries));
+
+wire frame_done = (state == S_FORWARD || state == S_DISCARD) && in_tvalid && in_tlast;
+
+always_comb begin
+    for(int i = 0; i < PORTS; i++) begin
+        ingress_tready[i] = i == source && (state == S_HEADER || state == S_FORWARD || state == S_DISCARD);
+        ingress_done[i] = i == source && frame_done;
+        egress_tvalid[i] = forward_mask[i] && (state == S_FORWARD_HEADER || state == S_FORWARD && in_tvalid);
+    end
+end
+
+assign egress_tdata = state == S_FORWARD_HEADER ? header[header_index] : in_tdata;
+assign egress_tlast = state == S_FORWARD && in_tlast;
+assign egress_tid = source;
+assign egress_tmeta = ingress_tmeta[source];
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        state <= S_IDLE;
+        source <= 0;
+        forward_mask <= 0;
+        header_index <= 0;
+        flood_count <= 0;
+        filter_count <= 0;
+        for(int i = 0; i < PORTS; i++) begin
+            rx_frame_count[i] <= 0;
+            tx_frame_count[i] <= 0;
+            tx_drop_count[i] <= 0;
+        end
+    end
+    else begin
+        case(state)
+        S_IDLE: begin
+            forward_mask <= 0;
+            header_index <= 0;
+            if( next_valid ) begin
+                source <= next_source;
+                state <= S_HEADER;
+            end
+        end
+        S_HEADER: begin
+            if( in_tvalid ) begin
+                header[header_index] <= in_tdata;
+                header_index <= header_index + 1;
+                if( header_index == 11 ) begin
+                    state <= S_LOOKUP;
+                end
+            end
+        end
+        S_LOOKUP: begin
+            forward_mask <= candidate_mask & egress_room;
+            header_index <= 0;
+            rx_frame_count[source] <= rx_frame_count[source] + 1;
+            flood_count <= flood_count + flood;
+            filter_count <= filter_count + filter;
+            for(int i = 0; i < PORTS; i++) begin
+                if( candidate_mask[i] && !egress_room[i] ) begin
+                    tx_drop_count[i] <= tx_drop_count[i] + 1;
+                end
+            end
+            state <= (candidate_mask & egress_room) != 0 ? S_FORWARD_HEADER : S_DISCARD;
+        end
+        S_FORWARD_HEADER: begin
+            header_index <= header_index + 1;
+            if( header_index == 11 ) begin
+                state <= S_FORWARD;
+            end
+        end
+        S_FORWARD: begin
+            if( frame_done ) begin
+                for(int i = 0; i < PORTS; i++) begin
+                    if( forward_mask[i] ) begin
+                        tx_frame_count[i] <= tx_frame_count[i] + 1;
+                    end
+                end
+                state <= S_IDLE;
+            end
+        end
+        S_DISCARD: begin
+            if( frame_done ) begin
+                state <= S_IDLE;
+            end
+        end
+        default: state <= S_IDLE;
+        endcase
+    end
+end
+
+endmodule
+
+`default_nettype wire
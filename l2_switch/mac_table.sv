@@ -0,0 +1,115 @@
+`default_nettype none
+
+// Hashed MAC address table of l2_switch with aging.
+// An address is stored at the entry given by XOR folding its 48 bits into TABLE_BITS bits.
+// Learning an address overwrites its entry, so colliding addresses replace each other and the last one learned is kept.
+// Each entry holds the epoch of its last learning. The epoch counts up every TICK_CLOCKS clocks.
+// An entry older than aging_time epochs is not hit any more, and a scan visiting an entry every clock invalidates it.
+// aging_time 0 disables the aging.
+// The lookup is combinational from the distributed RAM.
+module mac_table #(
+    parameter int TABLE_BITS = 8,
+    parameter int PORT_BITS = 2,
+    parameter int TICK_CLOCKS = 25000000,   // Clocks per epoch (1s at 25MHz)
+    parameter int EPOCH_BITS = 16
+) (
+    input wire clock,
+    input wire aresetn,
+
+    input  wire  [47:0]           lookup_address,
+    output logic                  lookup_hit,
+    output logic [PORT_BITS-1:0]  lookup_port,
+
+    input  wire                   learn,
+    input  wire  [47:0]           learn_address,
+    input  wire  [PORT_BITS-1:0]  learn_port,
+
+    input  wire                   flush,            // Invalidates all entries
+    input  wire  [EPOCH_BITS-1:0] aging_time,       // Epochs. 0 disables the aging.
+    output logic [TABLE_BITS:0]   entries           // Valid entries
+);
+
+localparam int ENTRIES = 2**TABLE_BITS;
+
+function automatic logic [TABLE_BITS-1:0] hash_index(input logic [47:0] address);
+    logic [TABLE_BITS-1:0] value;
+    value = 0;
+    for(int i = 0; i < 48; i++) begin
+        value[i % TABLE_BITS] ^= address[i];
+    end
+    return value;
+endfunction
+
+logic [EPOCH_BITS-1:0] epoch;
+logic [$clog2(TICK_CLOCKS)-1:0] tick_count;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        epoch <= 0;
+        tick_count <= 0;
+    end
+    else if( tick_count == TICK_CLOCKS - 1 ) begin
+        epoch <= epoch + 1;
+        tick_count <= 0;
+    end
+    else begin
+        tick_count <= tick_count + 1;
+    end
+end
+
+// {address, port, epoch}
+logic [47+PORT_BITS+EPOCH_BITS:0] memory[ENTRIES-1:0];
+logic [ENTRIES-1:0] valid;
+
+function automatic logic expired(input logic [EPOCH_BITS-1:0] learned_epoch, input logic [EPOCH_BITS-1:0] current_epoch, input logic [EPOCH_BITS-1:0] limit);
+    logic [EPOCH_BITS-1:0] age;
+    age = current_epoch - learned_epoch;
+    return limit != 0 && age >= limit;
+endfunction
+
+// Lookup
+wire [TABLE_BITS-1:0] lookup_index = hash_index(lookup_address);
+wire [47:0]           lookup_entry_address;
+wire [PORT_BITS-1:0]  lookup_entry_port;
+wire [EPOCH_BITS-1:0] lookup_entry_epoch;
+assign {lookup_entry_address, lookup_entry_port, lookup_entry_epoch} = memory[lookup_index];
+
+assign lookup_hit = valid[lookup_index] && lookup_entry_address == lookup_address && !expired(lookup_entry_epoch, epoch, aging_time);
+assign lookup_port = lookup_entry_port;
+
+// Learning
+wire [TABLE_BITS-1:0] learn_index = hash_index(learn_address);
+
+always_ff @(posedge clock) begin
+    if( learn ) begin
+        memory[learn_index] <= {learn_address, learn_port, epoch};
+    end
+end
+
+// Aging scan. Learning at the scanned entry in the same clock takes precedence.
+logic [TABLE_BITS-1:0] scan_index;
+wire [EPOCH_BITS-1:0] scan_entry_epoch = memory[scan_index][EPOCH_BITS-1:0];
+wire scan_expire = valid[scan_index] && expired(scan_entry_epoch, epoch, aging_time) && !(learn && learn_index == scan_index);
+wire learn_new = learn && !valid[learn_index];
+
+always_ff @(posedge clock) begin
+    if( !aresetn || flush ) begin
+        valid <= 0;
+        entries <= 0;
+        scan_index <= 0;
+    end
+    else begin
+        scan_index <= scan_index + 1;
+        if( learn ) begin
+            valid[learn_index] <= 1;
+        end
+        if( scan_expire ) begin
+            valid[scan_index] <= 0;
+        end
+        entries <= entries + learn_new - scan_expire;
+    end
+end
+
+endmodule
+
+`default_nettype wire
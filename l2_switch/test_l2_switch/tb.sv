@@ -0,0 +1,339 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+
+    localparam int PORTS = 4;
+    localparam int MAX_FRAME_BYTES = 200;
+    localparam int META_BITS = 16;
+    localparam int TICK_CLOCKS = 100;
+
+    typedef bit [7:0] frame_t[$];
+
+    logic [PORTS-1:0][7:0]           saxis_tdata = 0;
+    logic [PORTS-1:0]                saxis_tvalid = 0;
+    logic [PORTS-1:0]                saxis_tuser = 0;
+    logic [PORTS-1:0]                saxis_tlast = 0;
+    logic [PORTS-1:0][META_BITS-1:0] saxis_tmeta = 0;
+    logic [PORTS-1:0]                ingress_room;
+
+    logic [PORTS-1:0][7:0]           maxis_tdata;
+    logic [PORTS-1:0]                maxis_tvalid;
+    logic [PORTS-1:0]                maxis_tready = '1;
+    logic [PORTS-1:0]                maxis_tlast;
+    logic [PORTS-1:0][META_BITS-1:0] maxis_tmeta;
+    logic [PORTS-1:0][1:0]           maxis_tid;
+
+    logic [7:0]  s_axi_awaddr;
+    logic        s_axi_awvalid = 0;
+    logic        s_axi_awready;
+    logic [31:0] s_axi_wdata;
+    logic [3:0]  s_axi_wstrb;
+    logic        s_axi_wvalid = 0;
+    logic        s_axi_wready;
+    logic [1:0]  s_axi_bresp;
+    logic        s_axi_bvalid;
+    logic        s_axi_bready = 0;
+    logic [7:0]  s_axi_araddr;
+    logic        s_axi_arvalid = 0;
+    logic        s_axi_arready;
+    logic [31:0] s_axi_rdata;
+    logic [1:0]  s_axi_rresp;
+    logic        s_axi_rvalid;
+    logic        s_axi_rready = 0;
+
+    l2_switch #(
+        .PORTS(PORTS),
+        .INGRESS_DEPTH_BITS(8),
+        .EGRESS_DEPTH_BITS(9),
+        .FRAME_DEPTH_BITS(3),
+        .MAX_FRAME_BYTES(MAX_FRAME_BYTES),
+        .META_BITS(META_BITS),
+        .TABLE_BITS(4),
+        .AGING_TICK_CLOCKS(TICK_CLOCKS)
+    ) dut (
+        .*
+    );
+
+    initial begin
+        clock = 0;
+    end
+    always #(20) begin
+        clock = ~clock;
+    end
+
+    localparam bit [7:0] REG_CONTROL = 8'h00;
+    localparam bit [7:0] REG_AGING_TIME = 8'h04;
+    localparam bit [7:0] REG_ENTRIES = 8'h08;
+    localparam bit [7:0] REG_FLOOD_COUNT = 8'h0c;
+    localparam bit [7:0] REG_FILTER_COUNT = 8'h10;
+    function automatic bit [7:0] port_register(input int port, input int offset);
+        return 8'h40 + 16*port + offset;
+    endfunction
+
+    localparam bit [47:0] BROADCAST = 48'hffffffffffff;
+    localparam bit [47:0] MULTICAST = 48'h01005e000001;
+    localparam bit [47:0] HOST_A = 48'h02000000000a;   // on port 0
+    localparam bit [47:0] HOST_B = 48'h02000000000b;   // on port 1
+    localparam bit [47:0] HOST_C = 48'h02000000000c;   // on port 0
+    localparam bit [47:0] HOST_D = 48'h02000000000d;   // on port 2
+    localparam bit [47:0] HOST_E = 48'h02000000000e;   // on port 3
+
+    // A frame tells its source port and sequence number after the EtherType.
+    function automatic frame_t make_frame(input bit [47:0] destination, input bit [47:0] source, input int port, input int sequence, input int length);
+        frame_t frame;
+        for(int i = 0; i < 6; i++) frame.push_back(destination[47 - 8*i -: 8]);
+        for(int i = 0; i < 6; i++) frame.push_back(source[47 - 8*i -: 8]);
+        frame.push_back(8'h88);
+        frame.push_back(8'hb5);
+        frame.push_back(8'(port));
+        frame.push_back(8'(sequence));
+        while( frame.size() < length ) frame.push_back(8'(frame.size() + sequence));
+        while( frame.size() > length ) void'(frame.pop_back());
+        return frame;
+    endfunction
+
+    function automatic bit [META_BITS-1:0] frame_meta(input int port, input frame_t frame);
+        return {8'(port), frame.size() > 15 ? frame[15] : 8'h00};
+    endfunction
+
+    // Frames output on each port with their tid and tmeta
+    frame_t received[PORTS][$];
+    int     received_tid[PORTS][$];
+    int     received_meta[PORTS][$];
+    frame_t receiving[PORTS];
+
+    for(genvar p = 0; p < PORTS; p++) begin :receiver_block
+        always @(posedge clock) begin
+            if( maxis_tvalid[p] && maxis_tready[p] ) begin
+                receiving[p].push_back(maxis_tdata[p]);
+                if( maxis_tlast[p] ) begin
+                    received[p].push_back(receiving[p]);
+                    received_tid[p].push_back(maxis_tid[p]);
+                    received_meta[p].push_back(maxis_tmeta[p]);
+                    receiving[p] = {};
+                end
+            end
+            // The egress FIFO outputs a frame without gaps.
+            if( receiving[p].size() != 0 && maxis_tready[p] && !maxis_tvalid[p] ) $error("port %0d: gap in a frame", p);
+        end
+    end
+
+    // Frames started while ingress_room is set, which must not be dropped at the ingress by overflow
+    int admitted[PORTS];
+
+    for(genvar p = 0; p < PORTS; p++) begin :admitted_block
+        bit in_frame = 0;
+        initial admitted[p] = 0;
+        always @(posedge clock) begin
+            if( saxis_tvalid[p] ) begin
+                if( !in_frame && ingress_room[p] ) admitted[p]++;
+                in_frame = !saxis_tlast[p];
+            end
+        end
+    end
+
+    // Sends a frame a byte every two clocks like MII, with tmeta {port, sequence}.
+    task automatic send(input int port, input frame_t frame, input bit user = 0);
+        foreach(frame[i]) begin
+            saxis_tdata[port] <= frame[i];
+            saxis_tvalid[port] <= 1;
+            saxis_tuser[port] <= user && i == frame.size() - 1;
+            saxis_tlast[port] <= i == frame.size() - 1;
+            saxis_tmeta[port] <= i == frame.size() - 1 ? frame_meta(port, frame) : 16'hxxxx;
+            @(posedge clock);
+            saxis_tvalid[port] <= 0;
+            saxis_tlast[port] <= 0;
+            saxis_tuser[port] <= 0;
+            @(posedge clock);
+        end
+        repeat(24) @(posedge clock);    // IFG and preamble
+    endtask
+
+    task automatic axi_write(input logic [7:0] address, input logic [31:0] data);
+        s_axi_awaddr <= address;
+        s_axi_awvalid <= 1;
+        s_axi_wdata <= data;
+        s_axi_wstrb <= 4'hf;
+        s_axi_wvalid <= 1;
+        s_axi_bready <= 1;
+        do @(posedge clock); while(!(s_axi_awready && s_axi_wready));
+        s_axi_awvalid <= 0;
+        s_axi_wvalid <= 0;
+        do @(posedge clock); while(!s_axi_bvalid);
+        s_axi_bready <= 0;
+    endtask
+
+    task automatic axi_read(input logic [7:0] address, output logic [31:0] data);
+        s_axi_araddr <= address;
+        s_axi_arvalid <= 1;
+        s_axi_rready <= 1;
+        do @(posedge clock); while(!s_axi_arready);
+        s_axi_arvalid <= 0;
+        do @(posedge clock); while(!s_axi_rvalid);
+        data = s_axi_rdata;
+        s_axi_rready <= 0;
+    endtask
+
+    task automatic check_register(input logic [7:0] address, input logic [31:0] expected, input string name);
+        logic [31:0] value;
+        axi_read(address, value);
+        if( value != expected ) $error("%s expected: %0d, actual: %0d", name, expected, value);
+    endtask
+
+    // Checks that the frame sent from the port arrives on the ports in mask and nowhere else.
+    int expected_count[PORTS];
+    task automatic expect_frame(input string name, input frame_t frame, input int port, input bit [PORTS-1:0] mask);
+        repeat(2*MAX_FRAME_BYTES) @(posedge clock);
+        for(int p = 0; p < PORTS; p++) begin
+            if( mask[p] ) expected_count[p]++;
+            if( received[p].size() != expected_count[p] ) begin
+                $error("%s: %0d frames on port %0d, expected %0d", name, received[p].size(), p, expected_count[p]);
+                expected_count[p] = received[p].size();
+            end
+            else if( mask[p] ) begin
+                if( received[p][$] != frame ) $error("%s: frame mismatch on port %0d", name, p);
+                if( received_tid[p][$] != port ) $error("%s: tid %0d on port %0d, expected %0d", name, received_tid[p][$], p, port);
+                if( received_meta[p][$] != frame_meta(port, frame) ) $error("%s: tmeta %04x on port %0d", name, received_meta[p][$], p);
+            end
+        end
+    endtask
+
+    task automatic send_and_expect(input string name, input int port, input frame_t frame, input bit [PORTS-1:0] mask);
+        send(port, frame);
+        expect_frame(name, frame, port, mask);
+    endtask
+
+    bit [47:0] hosts[PORTS] = '{HOST_A, HOST_B, HOST_D, HOST_E};
+    int sent[PORTS];
+    int forwarded[PORTS];
+    int first_admitted[PORTS];
+    int first[PORTS];
+    int last_sequence[PORTS];
+    int sequence;
+
+    initial begin
+        for(int p = 0; p < PORTS; p++) expected_count[p] = 0;
+        sequence = 0;
+        aresetn <= 0;
+        repeat(4) @(posedge clock);
+        aresetn <= 1;
+        repeat(4) @(posedge clock);
+
+        check_register(REG_AGING_TIME, 300, "default AGING_TIME");
+        if( ingress_room != '1 ) $error("no ingress_room after reset");
+
+        // Unknown unicast is flooded, and the reply and the next frame go only to the learned ports.
+        send_and_expect("unknown unicast", 0, make_frame(HOST_B, HOST_A, 0, sequence++, 64), 4'b1110);
+        send_and_expect("reply", 1, make_frame(HOST_A, HOST_B, 1, sequence++, 64), 4'b0001);
+        send_and_expect("known unicast", 0, make_frame(HOST_B, HOST_A, 0, sequence++, 100), 4'b0010);
+        check_register(REG_ENTRIES, 2, "ENTRIES after learning");
+
+        // Broadcast and multicast are flooded.
+        send_and_expect("broadcast", 2, make_frame(BROADCAST, HOST_D, 2, sequence++, 60), 4'b1011);
+        send_and_expect("multicast", 3, make_frame(MULTICAST, HOST_E, 3, sequence++, 80), 4'b0111);
+        send_and_expect("to port 2", 1, make_frame(HOST_D, HOST_B, 1, sequence++, 60), 4'b0100);
+        send_and_expect("to port 3", 2, make_frame(HOST_E, HOST_D, 2, sequence++, 60), 4'b1000);
+        check_register(REG_ENTRIES, 4, "ENTRIES after all hosts");
+
+        // A frame to the ingress port itself is filtered.
+        send_and_expect("host C", 0, make_frame(BROADCAST, HOST_C, 0, sequence++, 60), 4'b1110);
+        send_and_expect("filtered", 0, make_frame(HOST_C, HOST_A, 0, sequence++, 60), 4'b0000);
+        check_register(REG_FILTER_COUNT, 1, "FILTER_COUNT");
+        check_register(REG_FLOOD_COUNT, 4, "FLOOD_COUNT");
+
+        // A host moved to another port is learned again.
+        send_and_expect("moved host", 3, make_frame(HOST_B, HOST_C, 3, sequence++, 60), 4'b0010);
+        send_and_expect("to moved host", 1, make_frame(HOST_C, HOST_B, 1, sequence++, 60), 4'b1000);
+
+        // Frames with tuser, runts and frames longer than MAX_FRAME_BYTES are dropped at the ingress.
+        send(1, make_frame(HOST_A, HOST_B, 1, sequence++, 60), 1);
+        expect_frame("error", {}, 1, 4'b0000);
+        send(2, make_frame(HOST_A, HOST_D, 2, sequence++, 13));
+        expect_frame("runt", {}, 2, 4'b0000);
+        send(3, make_frame(HOST_A, HOST_E, 3, sequence++, MAX_FRAME_BYTES + 1));
+        expect_frame("too long", {}, 3, 4'b0000);
+        send_and_expect("longest", 3, make_frame(HOST_A, HOST_E, 3, sequence++, MAX_FRAME_BYTES), 4'b0001);
+        send_and_expect("shortest", 2, make_frame(HOST_A, HOST_D, 2, sequence++, 14), 4'b0001);
+        check_register(port_register(1, 8), 1, "RX_DROPS of port 1");
+        check_register(port_register(2, 8), 1, "RX_DROPS of port 2");
+        check_register(port_register(3, 8), 1, "RX_DROPS of port 3");
+
+        // While port 3 is stalled, the broadcast frames which may not fit in its FIFO are dropped for it.
+        // The FIFO of 511 bytes takes a frame while it has MAX_FRAME_BYTES free, which is 3 frames of 150 bytes.
+        maxis_tready[3] <= 0;
+        for(int i = 0; i < 5; i++) begin
+            send_and_expect("stalled port", 0, make_frame(BROADCAST, HOST_A, 0, sequence++, 150), 4'b0110);
+        end
+        maxis_tready[3] <= 1;
+        repeat(4*150) @(posedge clock);
+        if( received[3].size() != expected_count[3] + 3 ) $error("%0d frames on the stalled port, expected %0d", received[3].size(), expected_count[3] + 3);
+        expected_count[3] = received[3].size();
+        check_register(port_register(3, 12), 2, "TX_DROPS of port 3");
+
+        // The entries are forgotten after AGING_TIME seconds.
+        axi_write(REG_AGING_TIME, 2);
+        repeat(3*TICK_CLOCKS) @(posedge clock);
+        check_register(REG_ENTRIES, 0, "ENTRIES after aging");
+        axi_write(REG_AGING_TIME, 0);
+        send_and_expect("aged out", 0, make_frame(HOST_B, HOST_A, 0, sequence++, 60), 4'b1110);
+        send_and_expect("learned again", 1, make_frame(HOST_A, HOST_B, 1, sequence++, 60), 4'b0001);
+        repeat(3*TICK_CLOCKS) @(posedge clock);
+        check_register(REG_ENTRIES, 2, "ENTRIES without aging");
+
+        // Flushing forgets all entries.
+        axi_write(REG_CONTROL, 1);
+        check_register(REG_ENTRIES, 0, "ENTRIES after flush");
+        send_and_expect("flushed", 1, make_frame(HOST_A, HOST_B, 1, sequence++, 60), 4'b1101);
+
+        // Known hosts on all ports send at once, more than the fabric moves. Each frame is forwarded or dropped
+        // at the ingress, and the frames from a port keep their order.
+        send_and_expect("learn D", 2, make_frame(HOST_B, HOST_D, 2, sequence++, 60), 4'b0010);
+        send_and_expect("learn E", 3, make_frame(HOST_B, HOST_E, 3, sequence++, 60), 4'b0010);
+        send_and_expect("learn A", 0, make_frame(HOST_B, HOST_A, 0, sequence++, 60), 4'b0010);
+        for(int p = 0; p < PORTS; p++) begin
+            logic [31:0] rx_frames;
+            logic [31:0] rx_drops;
+            axi_read(port_register(p, 0), rx_frames);
+            axi_read(port_register(p, 8), rx_drops);
+            sent[p] = rx_frames + rx_drops;
+            forwarded[p] = rx_frames;
+        end
+        for(int p = 0; p < PORTS; p++) first[p] = received[p].size();
+        for(int p = 0; p < PORTS; p++) first_admitted[p] = admitted[p];
+        for(int p = 0; p < PORTS; p++) begin
+            automatic int port = p;
+            fork
+                for(int i = 0; i < 20; i++) begin
+                    send(port, make_frame(hosts[(port + 1 + i % 3) % PORTS], hosts[port], port, i, 40 + 7*i));
+                end
+            join_none
+        end
+        wait fork;
+        repeat(16*MAX_FRAME_BYTES) @(posedge clock);
+        for(int p = 0; p < PORTS; p++) begin
+            for(int q = 0; q < PORTS; q++) last_sequence[q] = -1;
+            for(int i = first[p]; i < received[p].size(); i++) begin
+                automatic int source = received_tid[p][i];
+                automatic int number = received[p][i][15];
+                if( received[p][i] != make_frame(hosts[p], hosts[source], source, number, 40 + 7*number) ) $error("port %0d: frame #%0d from port %0d mismatch", p, number, source);
+                if( number <= last_sequence[source] ) $error("port %0d: frame #%0d from port %0d out of order", p, number, source);
+                last_sequence[source] = number;
+            end
+        end
+        for(int p = 0; p < PORTS; p++) begin
+            logic [31:0] rx_frames;
+            logic [31:0] rx_drops;
+            logic [31:0] tx_frames;
+            axi_read(port_register(p, 0), rx_frames);
+            axi_read(port_register(p, 8), rx_drops);
+            axi_read(port_register(p, 4), tx_frames);
+            if( rx_frames + rx_drops != sent[p] + 20 ) $error("port %0d: RX_FRAMES %0d and RX_DROPS %0d for %0d frames", p, rx_frames, rx_drops, sent[p] + 20);
+            if( rx_frames - forwarded[p] < admitted[p] - first_admitted[p] ) $error("port %0d: %0d frames forwarded, %0d started with ingress_room", p, rx_frames - forwarded[p], admitted[p] - first_admitted[p]);
+            if( tx_frames != received[p].size() ) $error("port %0d: TX_FRAMES %0d for %0d frames", p, tx_frames, received[p].size());
+        end
+
+        $finish;
+    end
+endmodule
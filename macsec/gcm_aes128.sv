@@ -0,0 +1,298 @@
+`default_nettype none
+
+// AES-GCM-128 (NIST SP 800-38D) on a byte stream with a 96-bit IV.
+// A message is started with the IV while ready, then the bytes of the AAD (tuser asserted) and the text follow
+// on saxis, the AAD first. tlast ends the message, which has at least a byte. The bytes come out on maxis
+// in the same cycle, the text encrypted or decrypted by the keystream and the AAD as is.
+// The tag is output with tag_valid for a cycle after the last byte. The caller compares it when decrypting.
+// key_load takes the key and computes the hash key while ready, before the first message.
+//
+// AES computes the hash key, the encrypted initial counter block and the keystream blocks ahead of the text.
+// GHASH multiplies a block in 128/DIGIT_BITS clocks while the next block is gathered,
+// so the bytes are accepted at a byte per clock except for the flush of a partial AAD block.
+// The tag follows the last byte in about 3*(128/DIGIT_BITS + 2) clocks.
+module gcm_aes128 #(
+    parameter int DIGIT_BITS = 32   // Bits per clock of the GHASH multiplier (see ghash_multiplier)
+) (
+    input wire clock,
+    input wire aresetn,
+
+    input  wire [127:0] key,
+    input  wire         key_load,
+    input  wire [95:0]  iv,
+    input  wire         decrypt,        // Sampled with start
+    input  wire         start,
+    output wire         ready,
+
+    input  wire [7:0] saxis_tdata,
+    input  wire       saxis_tvalid,
+    output wire       saxis_tready,
+    input  wire       saxis_tuser,      // AAD
+    input  wire       saxis_tlast,
+
+    output wire [7:0] maxis_tdata,
+    output wire       maxis_tvalid,
+    input  wire       maxis_tready,
+    output wire       maxis_tuser,
+    output wire       maxis_tlast,
+
+    output logic [127:0] tag,
+    output logic         tag_valid
+);
+
+typedef enum {
+    S_IDLE,
+    S_KEY_START,
+    S_KEY_WAIT,
+    S_DATA,
+    S_FINAL
+} state_t;
+
+typedef enum {
+    JOB_HASH_KEY,
+    JOB_EK0,
+    JOB_KEYSTREAM
+} job_t;
+
+state_t state;
+
+logic [127:0] key_reg;
+logic [127:0] hash_key;
+logic [95:0]  iv_reg;
+logic [31:0]  counter;
+logic         decrypt_reg;
+logic [127:0] ek0;              // Encrypted initial counter block
+logic         ek0_valid;
+
+// AES
+job_t         aes_job;
+logic         aes_start;
+logic [127:0] aes_block;
+logic         aes_busy;
+logic         aes_done;
+logic [127:0] aes_result;
+
+aes128_encrypt aes128_encrypt_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .key(key_reg),
+    .block(aes_block),
+    .start(aes_start),
+    .busy(aes_busy),
+    .done(aes_done),
+    .result(aes_result)
+);
+
+// Keystream blocks, the current one and the next one
+logic [127:0] keystream;
+logic         keystream_valid;
+logic [127:0] keystream_next;
+logic         keystream_next_valid;
+logic [3:0]   keystream_position;
+
+// GHASH
+logic [127:0] x;
+logic [127:0] block;            // Block being gathered, zero above block_bytes
+logic [4:0]   block_bytes;
+logic         in_text;
+logic [15:0]  aad_bytes;
+logic [15:0]  text_bytes;
+logic         length_started;
+
+logic         mul_start;
+logic [127:0] mul_x;
+logic         mul_busy;
+logic         mul_done;
+logic [127:0] mul_result;
+
+ghash_multiplier #(
+    .DIGIT_BITS(DIGIT_BITS)
+) ghash_multiplier_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .x(mul_x),
+    .h(hash_key),
+    .start(mul_start),
+    .busy(mul_busy),
+    .done(mul_done),
+    .result(mul_result)
+);
+
+assign ready = state == S_IDLE && !aes_busy;
+
+wire input_aad = saxis_tuser;
+// The partial AAD block is multiplied before the first byte of the text.
+wire switch_pending = state == S_DATA && saxis_tvalid && !input_aad && !in_text && block_bytes != 0;
+wire byte_ok = state == S_DATA && block_bytes != 16 && (input_aad ? !in_text : keystream_valid && !switch_pending);
+
+assign saxis_tready = byte_ok && maxis_tready;
+assign maxis_tvalid = saxis_tvalid && byte_ok;
+assign maxis_tdata = input_aad ? saxis_tdata : saxis_tdata ^ keystream[127 - 8*keystream_position -: 8];
+assign maxis_tuser = saxis_tuser;
+assign maxis_tlast = saxis_tlast;
+
+wire accept = saxis_tvalid && saxis_tready;
+wire [7:0] hash_byte = input_aad || decrypt_reg ? saxis_tdata : maxis_tdata;
+wire keystream_pop = accept && !input_aad && keystream_position == 15;
+wire keystream_push = aes_done && aes_job == JOB_KEYSTREAM && state == S_DATA;
+
+// The multiplier is idle after its result is taken into x.
+wire mul_idle = !mul_busy && !mul_done;
+wire block_handoff = mul_idle && (block_bytes == 16 || block_bytes != 0 && (switch_pending || state == S_FINAL));
+wire length_handoff = mul_idle && state == S_FINAL && block_bytes == 0 && !length_started && ek0_valid;
+assign mul_start = block_handoff || length_handoff;
+assign mul_x = x ^ (block_handoff ? block : {64'(aad_bytes) << 3, 64'(text_bytes) << 3});
+
+always_comb begin
+    aes_start = 0;
+    aes_block = {iv_reg, counter};
+    if( state == S_KEY_START ) begin
+        aes_start = 1;
+        aes_block = 0;
+    end
+    else if( ready && start && !key_load ) begin
+        aes_start = 1;
+        aes_block = {iv, 32'd1};
+    end
+    else if( state == S_DATA && !aes_busy && !aes_done && !(keystream_valid && keystream_next_valid) ) begin
+        aes_start = 1;
+    end
+end
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        state <= S_IDLE;
+        key_reg <= 0;
+        hash_key <= 0;
+        iv_reg <= 0;
+        counter <= 0;
+        decrypt_reg <= 0;
+        ek0 <= 0;
+        ek0_valid <= 0;
+        aes_job <= JOB_HASH_KEY;
+        keystream <= 0;
+        keystream_valid <= 0;
+        keystream_next <= 0;
+        keystream_next_valid <= 0;
+        keystream_position <= 0;
+        x <= 0;
+        block <= 0;
+        block_bytes <= 0;
+        in_text <= 0;
+        aad_bytes <= 0;
+        text_bytes <= 0;
+        length_started <= 0;
+        tag <= 0;
+        tag_valid <= 0;
+    end
+    else begin
+        tag_valid <= 0;
+
+        if( aes_done ) begin
+            case( aes_job )
+            JOB_HASH_KEY: hash_key <= aes_result;
+            JOB_EK0: begin
+                ek0 <= aes_result;
+                ek0_valid <= 1;
+            end
+            default: ;
+            endcase
+        end
+
+        if( keystream_pop ) begin
+            keystream <= keystream_next;
+            keystream_valid <= keystream_next_valid;
+            keystream_next_valid <= 0;
+        end
+        if( keystream_push ) begin
+            if( keystream_pop ? !keystream_next_valid : !keystream_valid ) begin
+                keystream <= aes_result;
+                keystream_valid <= 1;
+            end
+            else begin
+                keystream_next <= aes_result;
+                keystream_next_valid <= 1;
+            end
+        end
+
+        if( mul_done ) begin
+            x <= mul_result;
+        end
+        if( block_handoff ) begin
+            block <= 0;
+            block_bytes <= 0;
+        end
+        if( length_handoff ) begin
+            length_started <= 1;
+        end
+
+        if( accept ) begin
+            block[127 - 8*block_bytes -: 8] <= hash_byte;
+            block_bytes <= block_bytes + 1;
+            if( input_aad ) begin
+                aad_bytes <= aad_bytes + 1;
+            end
+            else begin
+                text_bytes <= text_bytes + 1;
+                keystream_position <= keystream_position + 1;
+                in_text <= 1;
+            end
+        end
+
+        case( state )
+        S_IDLE: begin
+            if( ready && key_load ) begin
+                key_reg <= key;
+                state <= S_KEY_START;
+            end
+            else if( ready && start ) begin
+                iv_reg <= iv;
+                counter <= 2;
+                decrypt_reg <= decrypt;
+                ek0_valid <= 0;
+                aes_job <= JOB_EK0;
+                keystream_valid <= 0;
+                keystream_next_valid <= 0;
+                keystream_position <= 0;
+                x <= 0;
+                block <= 0;
+                block_bytes <= 0;
+                in_text <= 0;
+                aad_bytes <= 0;
+                text_bytes <= 0;
+                length_started <= 0;
+                state <= S_DATA;
+            end
+        end
+        S_KEY_START: begin
+            aes_job <= JOB_HASH_KEY;
+            state <= S_KEY_WAIT;
+        end
+        S_KEY_WAIT: begin
+            if( aes_done ) begin
+                state <= S_IDLE;
+            end
+        end
+        S_DATA: begin
+            if( aes_start ) begin
+                aes_job <= JOB_KEYSTREAM;
+                counter <= counter + 1;
+            end
+            if( accept && saxis_tlast ) begin
+                state <= S_FINAL;
+            end
+        end
+        S_FINAL: begin
+            if( mul_done && length_started ) begin
+                tag <= mul_result ^ ek0;
+                tag_valid <= 1;
+                state <= S_IDLE;
+            end
+        end
+        endcase
+    end
+end
+
+endmodule
+
+`default_nettype wire
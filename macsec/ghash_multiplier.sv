@@ -0,0 +1,75 @@
+`default_nettype none
+
+// Multiplier in GF(2^128) of GHASH (NIST SP 800-38D), taking DIGIT_BITS bits of x per clock.
+// The bits are in the order of GCM, the coefficient of x^0 at [127].
+// The result is valid from done, which is asserted for a cycle 128/DIGIT_BITS clocks after start,
+// until the next start. h must be stable while busy.
+module ghash_multiplier #(
+    parameter int DIGIT_BITS = 32   // 1, 2, 4, 8, 16, 32 or 64
+) (
+    input wire clock,
+    input wire aresetn,
+
+    input  wire [127:0] x,
+    input  wire [127:0] h,
+    input  wire         start,
+
+    output logic         busy,
+    output logic         done,
+    output logic [127:0] result
+);
+
+localparam int STEPS = 128 / DIGIT_BITS;
+localparam int STEP_BITS = STEPS > 1 ? $clog2(STEPS) : 1;
+localparam bit [127:0] R = {8'he1, 120'h0};
+
+logic [127:0] x_remaining;
+logic [127:0] v;
+logic [STEP_BITS-1:0] step;
+
+// Processes the digit at the top of x_remaining.
+logic [127:0] next_result;
+logic [127:0] next_v;
+always_comb begin
+    next_result = result;
+    next_v = v;
+    for(int i = 0; i < DIGIT_BITS; i++) begin
+        if( x_remaining[127 - i] ) next_result ^= next_v;
+        next_v = (next_v >> 1) ^ (next_v[0] ? R : 128'h0);
+    end
+end
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        x_remaining <= 0;
+        v <= 0;
+        step <= 0;
+        result <= 0;
+        busy <= 0;
+        done <= 0;
+    end
+    else begin
+        done <= 0;
+        if( busy ) begin
+            result <= next_result;
+            v <= next_v;
+            x_remaining <= x_remaining << DIGIT_BITS;
+            step <= step + 1;
+            if( step == STEPS - 1 ) begin
+                busy <= 0;
+                done <= 1;
+            end
+        end
+        else if( start ) begin
+            x_remaining <= x;
+            v <= h;
+            step <= 0;
+            result <= 0;
+            busy <= 1;
+        end
+    end
+end
+
+endmodule
+
+`default_nettype wire
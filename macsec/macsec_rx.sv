@@ -0,0 +1,658 @@
+`default_nettype none
+
+// MACsec (IEEE 802.1AE) validation of the received frames with GCM-AES-128 and a single SA.
+// The frames on saxis come from the line without the FCS and cannot be stalled. tuser with tlast tells an error.
+// The frames with the SecTAG of the SA are decrypted (or only authenticated) and output without the SecTAG and the ICV.
+// Frames with a bad SecTAG, of another SA, replayed or without the SecTAG in the strict mode are discarded
+// before anything is output. The ICV is checked after the rest of the frame is output, so a frame failing it
+// is ended with tuser and must be dropped by a packet mode FIFO (see rx_frame_fifo).
+// Frames with an error on saxis are ended with tuser and not counted.
+// Frames without the SecTAG are output as is, and so are all frames while disabled.
+//
+// The input is buffered in a FIFO while the GCM is started for a frame. The last 17 bytes of a frame are held back,
+// so that the last byte of the secure data is known when the ICV ends. With a short length (SL) in the SecTAG,
+// the secure data is counted and the padding after the ICV is discarded instead.
+// The frame is ended about 3*(128/DIGIT_BITS + 2) clocks after its last byte on saxis.
+//
+// Registers (32bit access only)
+//   0x00 CONTROL                RW  bit0: enable, bit1: strict (discard frames without the SecTAG except MAC control,
+//                                   EAPOL and EXEMPT_ETHERTYPE), bit2: replay protection, bit5-4: AN.
+//                                   Writing this register loads KEY at the next frame boundary.
+//   0x04 STATUS                 R   bit0: key loaded, bit1: input FIFO overflowed (cleared by writing CONTROL)
+//   0x08 SCI_HI                 RW  SCI[63:32] of the transmitter
+//   0x0c SCI_LO                 RW  SCI[31:0]. Frames without the SCI in the SecTAG are of this SCI unless ES is set.
+//   0x10 NEXT_PN                RW  PN after the highest valid one. Frames with a PN lower than NEXT_PN - REPLAY_WINDOW are late.
+//   0x14 REPLAY_WINDOW          RW
+//   0x18 EXEMPT_ETHERTYPE       RW  bit16: enable, bit15-0: EtherType passed in the strict mode
+//   0x20-0x2c KEY               W   SAK, the first byte at bit31-24 of 0x20
+//   0x30 OK_COUNT               R   frames validated
+//   0x34 UNTAGGED_COUNT         R   frames without the SecTAG output while enabled
+//   0x38 NO_TAG_COUNT           R   frames without the SecTAG discarded in the strict mode
+//   0x3c BAD_TAG_COUNT          R   frames with an invalid or unsupported SecTAG (including the PN of 0 and too short ones)
+//   0x40 NOT_USING_SA_COUNT     R   frames of another SCI or AN, or before the key is loaded
+//   0x44 LATE_COUNT             R   frames discarded by the replay protection
+//   0x48 NOT_VALID_COUNT        R   frames failing the ICV
+module macsec_rx #(
+    parameter int ADDR_BITS = 8,
+    parameter int DIGIT_BITS = 32,      // GHASH multiplier (see gcm_aes128)
+    parameter int FIFO_DEPTH_BITS = 6
+) (
+    input wire clock,
+    input wire aresetn,
+
+    input  wire [7:0] saxis_tdata,
+    input  wire       saxis_tvalid,
+    input  wire       saxis_tuser,
+    input  wire       saxis_tlast,
+
+    output logic [7:0] maxis_tdata,
+    output logic       maxis_tvalid,
+    output logic       maxis_tuser,
+    output logic       maxis_tlast,
+
+    input  wire  [ADDR_BITS-1:0] s_axi_awaddr,
+    input  wire                  s_axi_awvalid,
+    output logic                 s_axi_awready,
+    input  wire  [31:0]          s_axi_wdata,
+    input  wire  [3:0]           s_axi_wstrb,
+    input  wire                  s_axi_wvalid,
+    output logic                 s_axi_wready,
+    output logic [1:0]           s_axi_bresp,
+    output logic                 s_axi_bvalid,
+    input  wire                  s_axi_bready,
+    input  wire  [ADDR_BITS-1:0] s_axi_araddr,
+    input  wire                  s_axi_arvalid,
+    output logic                 s_axi_arready,
+    output logic [31:0]          s_axi_rdata,
+    output logic [1:0]           s_axi_rresp,
+    output logic                 s_axi_rvalid,
+    input  wire                  s_axi_rready
+);
+
+localparam bit [15:0] ETHERTYPE_MACSEC = 16'h88e5;
+localparam bit [15:0] ETHERTYPE_MAC_CONTROL = 16'h8808;
+localparam bit [15:0] ETHERTYPE_EAPOL = 16'h888e;
+
+localparam int REG_CONTROL = 0;
+localparam int REG_STATUS = 1;
+localparam int REG_SCI_HI = 2;
+localparam int REG_SCI_LO = 3;
+localparam int REG_NEXT_PN = 4;
+localparam int REG_REPLAY_WINDOW = 5;
+localparam int REG_EXEMPT_ETHERTYPE = 6;
+localparam int REG_KEY = 8;
+localparam int REG_OK_COUNT = 12;
+localparam int REG_UNTAGGED_COUNT = 13;
+localparam int REG_NO_TAG_COUNT = 14;
+localparam int REG_BAD_TAG_COUNT = 15;
+localparam int REG_NOT_USING_SA_COUNT = 16;
+localparam int REG_LATE_COUNT = 17;
+localparam int REG_NOT_VALID_COUNT = 18;
+
+logic         enable;
+logic         strict;
+logic         replay_protect;
+logic [1:0]   an;
+logic [63:0]  sci;
+logic [32:0]  next_pn;
+logic [31:0]  replay_window;
+logic         exempt_enable;
+logic [15:0]  exempt_ethertype;
+logic [127:0] key;
+logic         key_pending;
+logic         key_loaded;
+logic         overflow;
+
+typedef enum {
+    R_NONE,
+    R_UNTAGGED,
+    R_NO_TAG,
+    R_BAD_TAG,
+    R_NOT_USING_SA,
+    R_LATE,
+    R_OK,
+    R_NOT_VALID
+} result_t;
+
+// Result of a frame, counted unless the frame has an error
+logic    finish;
+result_t finish_result;
+logic    finish_error;
+
+logic [31:0] ok_count;
+logic [31:0] untagged_count;
+logic [31:0] no_tag_count;
+logic [31:0] bad_tag_count;
+logic [31:0] not_using_sa_count;
+logic [31:0] late_count;
+logic [31:0] not_valid_count;
+
+// Input FIFO
+typedef struct packed {
+    bit [7:0] tdata;
+    bit       tuser;
+    bit       tlast;
+} fifo_data_t;
+
+fifo_data_t fifo_in;
+fifo_data_t fifo_out;
+logic       fifo_in_ready;
+logic       input_valid;
+logic       input_ready;
+
+simple_fifo #(.DATA_BITS($bits(fifo_data_t)), .DEPTH_BITS(FIFO_DEPTH_BITS)) fifo_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .saxis_tdata(fifo_in),
+    .saxis_tvalid(saxis_tvalid),
+    .saxis_tready(fifo_in_ready),
+    .maxis_tdata(fifo_out),
+    .maxis_tvalid(input_valid),
+    .maxis_tready(input_ready)
+);
+
+assign fifo_in = '{tdata: saxis_tdata, tuser: saxis_tuser, tlast: saxis_tlast};
+
+// GCM
+logic        gcm_key_load;
+logic        gcm_start;
+logic        gcm_ready;
+logic [7:0]  gcm_in_tdata;
+logic        gcm_in_tvalid;
+logic        gcm_in_tready;
+logic        gcm_in_tuser;
+logic        gcm_in_tlast;
+logic [7:0]  gcm_out_tdata;
+logic        gcm_out_tvalid;
+logic        gcm_out_tlast;
+logic [127:0] gcm_tag;
+logic        gcm_tag_valid;
+
+logic [63:0] frame_sci;
+logic [31:0] frame_pn;
+
+gcm_aes128 #(
+    .DIGIT_BITS(DIGIT_BITS)
+) gcm_aes128_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .key(key),
+    .key_load(gcm_key_load),
+    .iv({frame_sci, frame_pn}),
+    .decrypt(1'b1),
+    .start(gcm_start),
+    .ready(gcm_ready),
+    .saxis_tdata(gcm_in_tdata),
+    .saxis_tvalid(gcm_in_tvalid),
+    .saxis_tready(gcm_in_tready),
+    .saxis_tuser(gcm_in_tuser),
+    .saxis_tlast(gcm_in_tlast),
+    .maxis_tdata(gcm_out_tdata),
+    .maxis_tvalid(gcm_out_tvalid),
+    .maxis_tready(1'b1),
+    .maxis_tuser(),
+    .maxis_tlast(gcm_out_tlast),
+    .tag(gcm_tag),
+    .tag_valid(gcm_tag_valid)
+);
+
+// AXI4-Lite write
+logic write_enable;
+logic [ADDR_BITS-3:0] write_index;
+assign write_enable = s_axi_awvalid && s_axi_wvalid && !s_axi_bvalid;
+assign write_index = s_axi_awaddr[ADDR_BITS-1:2];
+assign s_axi_awready = write_enable;
+assign s_axi_wready = write_enable;
+assign s_axi_bresp = 2'b00;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        s_axi_bvalid <= 0;
+        enable <= 0;
+        strict <= 0;
+        replay_protect <= 1;
+        an <= 0;
+        sci <= 0;
+        next_pn <= 1;
+        replay_window <= 0;
+        exempt_enable <= 0;
+        exempt_ethertype <= 0;
+        key <= 0;
+        key_pending <= 0;
+        overflow <= 0;
+    end
+    else begin
+        if( s_axi_bvalid && s_axi_bready ) begin
+            s_axi_bvalid <= 0;
+        end
+        if( gcm_key_load ) begin
+            key_pending <= 0;
+        end
+        if( saxis_tvalid && !fifo_in_ready ) begin
+            overflow <= 1;
+        end
+        if( finish && finish_result == R_OK && !finish_error && frame_pn >= next_pn ) begin
+            next_pn <= frame_pn + 33'd1;
+        end
+        if( write_enable ) begin
+            s_axi_bvalid <= 1;
+            case(write_index)
+            REG_CONTROL: begin
+                enable <= s_axi_wdata[0];
+                strict <= s_axi_wdata[1];
+                replay_protect <= s_axi_wdata[2];
+                an <= s_axi_wdata[5:4];
+                key_pending <= 1;
+                overflow <= 0;
+            end
+            REG_SCI_HI: sci[63:32] <= s_axi_wdata;
+            REG_SCI_LO: sci[31:0] <= s_axi_wdata;
+            REG_NEXT_PN: next_pn <= {1'b0, s_axi_wdata};
+            REG_REPLAY_WINDOW: replay_window <= s_axi_wdata;
+            REG_EXEMPT_ETHERTYPE: begin
+                exempt_enable <= s_axi_wdata[16];
+                exempt_ethertype <= s_axi_wdata[15:0];
+            end
+            REG_KEY + 0: key[127:96] <= s_axi_wdata;
+            REG_KEY + 1: key[95:64] <= s_axi_wdata;
+            REG_KEY + 2: key[63:32] <= s_axi_wdata;
+            REG_KEY + 3: key[31:0] <= s_axi_wdata;
+            default: ;
+            endcase
+        end
+    end
+end
+
+// AXI4-Lite read
+logic [ADDR_BITS-3:0] read_index;
+assign read_index = s_axi_araddr[ADDR_BITS-1:2];
+assign s_axi_arready = !s_axi_rvalid;
+assign s_axi_rresp = 2'b00;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        s_axi_rvalid <= 0;
+        s_axi_rdata <= 0;
+    end
+    else begin
+        if( s_axi_rvalid && s_axi_rready ) begin
+            s_axi_rvalid <= 0;
+        end
+        if( s_axi_arvalid && s_axi_arready ) begin
+            s_axi_rvalid <= 1;
+            case(read_index)
+            REG_CONTROL: s_axi_rdata <= {26'b0, an, 1'b0, replay_protect, strict, enable};
+            REG_STATUS: s_axi_rdata <= {30'b0, overflow, key_loaded};
+            REG_SCI_HI: s_axi_rdata <= sci[63:32];
+            REG_SCI_LO: s_axi_rdata <= sci[31:0];
+            REG_NEXT_PN: s_axi_rdata <= next_pn[31:0];
+            REG_REPLAY_WINDOW: s_axi_rdata <= replay_window;
+            REG_EXEMPT_ETHERTYPE: s_axi_rdata <= {15'b0, exempt_enable, exempt_ethertype};
+            REG_OK_COUNT: s_axi_rdata <= ok_count;
+            REG_UNTAGGED_COUNT: s_axi_rdata <= untagged_count;
+            REG_NO_TAG_COUNT: s_axi_rdata <= no_tag_count;
+            REG_BAD_TAG_COUNT: s_axi_rdata <= bad_tag_count;
+            REG_NOT_USING_SA_COUNT: s_axi_rdata <= not_using_sa_count;
+            REG_LATE_COUNT: s_axi_rdata <= late_count;
+            REG_NOT_VALID_COUNT: s_axi_rdata <= not_valid_count;
+            default: s_axi_rdata <= 0;
+            endcase
+        end
+    end
+end
+
+// Frame
+typedef enum {
+    S_HEADER,       // Destination and source addresses and EtherType
+    S_TAG,          // SecTAG
+    S_CHECK,
+    S_PASS_HEADER,
+    S_PASS,
+    S_DISCARD,
+    S_START,
+    S_AAD,
+    S_BODY,
+    S_LAST,
+    S_VERDICT
+} state_t;
+
+state_t state;
+
+logic [223:0] header;           // Addresses and SecTAG, which are the AAD
+logic [4:0]   header_bytes;
+logic [4:0]   tag_end;          // Bytes of the addresses and the SecTAG
+logic [4:0]   output_index;
+logic         frame_confidential;
+logic [5:0]   frame_short_length;
+logic         frame_error;
+logic         frame_short;      // Shorter than the secure data and the ICV
+logic         message_ended;
+logic [135:0] hold;             // The last bytes of the frame, the ICV at [135:8] after the secure data
+logic [4:0]   hold_bytes;
+logic [10:0]  body_bytes;
+logic [7:0]   last_byte;        // The last byte of the secure data, output with the result of the ICV
+logic [127:0] tag;
+logic         tag_ready;
+
+wire [15:0] ethertype = {header[127:120], fifo_out.tdata};   // With the 14th byte
+wire exempt = ethertype == ETHERTYPE_MAC_CONTROL || ethertype == ETHERTYPE_EAPOL || exempt_enable && ethertype == exempt_ethertype;
+
+// SecTAG
+wire [7:0]  tci = header[111:104];
+wire [7:0]  short_length = header[103:96];
+wire [31:0] pn = header[95:64];
+wire        tci_es = tci[6];
+wire        tci_sc = tci[5];
+wire        tci_scb = tci[4];
+wire        tci_e = tci[3];
+wire        tci_c = tci[2];
+wire [63:0] tag_sci = tci_sc ? header[63:0] : tci_es ? {header[175:128], 16'h0001} : sci;
+wire [32:0] lowest_pn = next_pn > replay_window ? next_pn - replay_window : 33'd0;
+wire bad_tag = tci[7] || tci_es && tci_sc || tci_scb || tci_e != tci_c || short_length >= 48 || pn == 0;
+wire not_using_sa = !key_loaded || tci[1:0] != an || tag_sci != sci;
+wire late = replay_protect && pn < lowest_pn;
+
+// The key is loaded between frames while the GCM is idle.
+assign gcm_key_load = state == S_HEADER && header_bytes == 0 && key_pending && gcm_ready;
+assign gcm_start = state == S_START && gcm_ready;
+
+wire counted = frame_short_length != 0;
+wire gcm_input = gcm_in_tvalid && gcm_in_tready;
+
+always_comb begin
+    input_ready = 0;
+    gcm_in_tdata = hold[135:128];
+    gcm_in_tvalid = 0;
+    gcm_in_tuser = !frame_confidential;
+    gcm_in_tlast = 0;
+
+    case( state )
+    S_HEADER, S_TAG, S_PASS, S_DISCARD: begin
+        input_ready = 1;
+    end
+    S_AAD: begin
+        gcm_in_tdata = header[223:216];
+        gcm_in_tvalid = 1;
+        gcm_in_tuser = 1;
+    end
+    S_BODY: begin
+        if( counted ) begin
+            // The secure data goes to the GCM and the ICV to the hold buffer.
+            gcm_in_tdata = fifo_out.tdata;
+            gcm_in_tvalid = input_valid && body_bytes < frame_short_length;
+            gcm_in_tlast = body_bytes == frame_short_length - 1;
+            input_ready = body_bytes < frame_short_length ? gcm_in_tready : 1;
+        end
+        else begin
+            // A byte is released from the full hold buffer for each byte coming in.
+            gcm_in_tvalid = input_valid && hold_bytes == 17;
+            input_ready = hold_bytes != 17 || gcm_in_tready;
+        end
+    end
+    S_LAST: begin
+        // The last byte of the secure data, or a dummy one to end the message of a short frame.
+        gcm_in_tvalid = !message_ended;
+        gcm_in_tlast = 1;
+    end
+    default: ;
+    endcase
+end
+
+// Bytes from the GCM are output except the SecTAG and the last byte.
+wire forward = gcm_out_tvalid && !gcm_out_tlast && (state != S_AAD || output_index < 12);
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        state <= S_HEADER;
+        header <= 0;
+        header_bytes <= 0;
+        tag_end <= 0;
+        output_index <= 0;
+        frame_sci <= 0;
+        frame_pn <= 0;
+        frame_confidential <= 0;
+        frame_short_length <= 0;
+        frame_error <= 0;
+        frame_short <= 0;
+        message_ended <= 0;
+        hold <= 0;
+        hold_bytes <= 0;
+        body_bytes <= 0;
+        last_byte <= 0;
+        tag <= 0;
+        tag_ready <= 0;
+        key_loaded <= 0;
+        finish <= 0;
+        finish_result <= R_NONE;
+        finish_error <= 0;
+        maxis_tdata <= 0;
+        maxis_tvalid <= 0;
+        maxis_tuser <= 0;
+        maxis_tlast <= 0;
+    end
+    else begin
+        finish <= 0;
+        maxis_tvalid <= 0;
+        maxis_tuser <= 0;
+        maxis_tlast <= 0;
+
+        if( gcm_key_load ) begin
+            key_loaded <= 1;
+        end
+        if( gcm_tag_valid ) begin
+            tag <= gcm_tag;
+            tag_ready <= 1;
+        end
+        if( gcm_input && gcm_in_tlast ) begin
+            message_ended <= 1;
+        end
+        if( forward ) begin
+            maxis_tdata <= gcm_out_tdata;
+            maxis_tvalid <= 1;
+        end
+        if( gcm_out_tvalid && gcm_out_tlast ) begin
+            last_byte <= gcm_out_tdata;
+        end
+
+        case( state )
+        S_HEADER: begin
+            if( input_valid ) begin
+                header[223 - 8*header_bytes -: 8] <= fifo_out.tdata;
+                header_bytes <= header_bytes + 1;
+                output_index <= 0;
+                if( header_bytes == 13 || fifo_out.tlast ) begin
+                    if( header_bytes == 13 && ethertype == ETHERTYPE_MACSEC && enable ) begin
+                        if( fifo_out.tlast ) begin
+                            finish <= 1;
+                            finish_result <= R_BAD_TAG;
+                            finish_error <= fifo_out.tuser;
+                            header_bytes <= 0;
+                        end
+                        else begin
+                            state <= S_TAG;
+                        end
+                    end
+                    else if( enable && strict && !(header_bytes == 13 && exempt) ) begin
+                        finish_result <= R_NO_TAG;
+                        if( fifo_out.tlast ) begin
+                            finish <= 1;
+                            finish_error <= fifo_out.tuser;
+                            header_bytes <= 0;
+                        end
+                        else begin
+                            state <= S_DISCARD;
+                        end
+                    end
+                    else begin
+                        finish_result <= enable ? R_UNTAGGED : R_NONE;
+                        frame_error <= fifo_out.tuser;
+                        message_ended <= fifo_out.tlast;    // The frame ended in the header.
+                        state <= S_PASS_HEADER;
+                    end
+                end
+            end
+        end
+        S_TAG: begin
+            if( input_valid ) begin
+                header[223 - 8*header_bytes -: 8] <= fifo_out.tdata;
+                header_bytes <= header_bytes + 1;
+                if( header_bytes == 14 ) begin
+                    tag_end <= fifo_out.tdata[5] ? 28 : 20;
+                end
+                if( fifo_out.tlast ) begin
+                    finish <= 1;
+                    finish_result <= R_BAD_TAG;
+                    finish_error <= fifo_out.tuser;
+                    header_bytes <= 0;
+                    state <= S_HEADER;
+                end
+                else if( header_bytes > 14 && header_bytes == tag_end - 1 ) begin
+                    state <= S_CHECK;
+                end
+            end
+        end
+        S_CHECK: begin
+            frame_sci <= tag_sci;
+            frame_pn <= pn;
+            frame_confidential <= tci_e;
+            frame_short_length <= short_length[5:0];
+            finish_result <= bad_tag ? R_BAD_TAG : not_using_sa ? R_NOT_USING_SA : late ? R_LATE : R_OK;
+            state <= bad_tag || not_using_sa || late ? S_DISCARD : S_START;
+        end
+        S_PASS_HEADER: begin
+            maxis_tdata <= header[223 - 8*output_index -: 8];
+            maxis_tvalid <= 1;
+            output_index <= output_index + 1;
+            if( output_index == header_bytes - 1 ) begin
+                maxis_tlast <= message_ended;
+                maxis_tuser <= message_ended && frame_error;
+                header_bytes <= 0;
+                if( message_ended ) begin
+                    finish <= 1;
+                    finish_error <= frame_error;
+                    message_ended <= 0;
+                    state <= S_HEADER;
+                end
+                else begin
+                    state <= S_PASS;
+                end
+            end
+        end
+        S_PASS: begin
+            if( input_valid ) begin
+                maxis_tdata <= fifo_out.tdata;
+                maxis_tvalid <= 1;
+                maxis_tlast <= fifo_out.tlast;
+                maxis_tuser <= fifo_out.tuser;
+                if( fifo_out.tlast ) begin
+                    finish <= 1;
+                    finish_error <= fifo_out.tuser;
+                    state <= S_HEADER;
+                end
+            end
+        end
+        S_DISCARD: begin
+            header_bytes <= 0;
+            if( input_valid && fifo_out.tlast ) begin
+                finish <= 1;
+                finish_error <= fifo_out.tuser;
+                state <= S_HEADER;
+            end
+        end
+        S_START: begin
+            if( gcm_ready ) begin
+                output_index <= 0;
+                message_ended <= 0;
+                tag_ready <= 0;
+                hold_bytes <= 0;
+                body_bytes <= 0;
+                state <= S_AAD;
+            end
+        end
+        S_AAD: begin
+            if( gcm_in_tready ) begin
+                header <= header << 8;
+                output_index <= output_index + 1;
+                if( output_index == tag_end - 1 ) begin
+                    state <= S_BODY;
+                end
+            end
+        end
+        S_BODY: begin
+            if( input_valid && input_ready ) begin
+                body_bytes <= body_bytes + 1;
+                if( counted ) begin
+                    if( body_bytes >= frame_short_length && hold_bytes < 16 ) begin
+                        hold[135 - 8*hold_bytes -: 8] <= fifo_out.tdata;
+                        hold_bytes <= hold_bytes + 1;
+                    end
+                end
+                else if( hold_bytes == 17 ) begin
+                    hold <= {hold[127:0], fifo_out.tdata};
+                end
+                else begin
+                    hold[135 - 8*hold_bytes -: 8] <= fifo_out.tdata;
+                    hold_bytes <= hold_bytes + 1;
+                end
+                if( fifo_out.tlast ) begin
+                    frame_error <= fifo_out.tuser;
+                    state <= S_LAST;
+                end
+            end
+        end
+        S_LAST: begin
+            if( gcm_input || message_ended ) begin
+                if( counted ) begin
+                    frame_short <= hold_bytes != 16 || !message_ended;
+                end
+                else begin
+                    hold <= hold << 8;
+                    frame_short <= hold_bytes != 17;
+                end
+                state <= S_VERDICT;
+            end
+        end
+        S_VERDICT: begin
+            if( tag_ready ) begin
+                maxis_tdata <= last_byte;
+                maxis_tvalid <= 1;
+                maxis_tlast <= 1;
+                maxis_tuser <= frame_error || frame_short || tag != hold[135:8];
+                finish <= 1;
+                finish_result <= frame_short || tag != hold[135:8] ? R_NOT_VALID : R_OK;
+                finish_error <= frame_error;
+                header_bytes <= 0;
+                state <= S_HEADER;
+            end
+        end
+        endcase
+    end
+end
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        ok_count <= 0;
+        untagged_count <= 0;
+        no_tag_count <= 0;
+        bad_tag_count <= 0;
+        not_using_sa_count <= 0;
+        late_count <= 0;
+        not_valid_count <= 0;
+    end
+    else if( finish && !finish_error ) begin
+        case( finish_result )
+        R_OK: ok_count <= ok_count + 1;
+        R_UNTAGGED: untagged_count <= untagged_count + 1;
+        R_NO_TAG: no_tag_count <= no_tag_count + 1;
+        R_BAD_TAG: bad_tag_count <= bad_tag_count + 1;
+        R_NOT_USING_SA: not_using_sa_count <= not_using_sa_count + 1;
+        R_LATE: late_count <= late_count + 1;
+        R_NOT_VALID: not_valid_count <= not_valid_count + 1;
+        default: ;
+        endcase
+    end
+end
+
+endmodule
+
+`default_nettype wire
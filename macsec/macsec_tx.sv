@@ -0,0 +1,456 @@
+`default_nettype none
+
+// MACsec (IEEE 802.1AE) protection of the transmitted frames with GCM-AES-128 and a single SA.
+// The frames on saxis and maxis have no preamble and no FCS. The SecTAG is inserted after the source address,
+// and the rest of the frame from the EtherType is encrypted (or only authenticated) and followed by the ICV.
+// The IV is the SCI and the PN. The PN is taken from NEXT_PN for each protected frame.
+// MAC control (0x8808), EAPOL (0x888e) and EXEMPT_ETHERTYPE frames are sent as is.
+// While enabled, frames are dropped before the key is loaded and after the PN is exhausted.
+// SL of the SecTAG is always 0, so the frames must be padded to 60 bytes before. (The MAC pads the frames from both inputs.)
+// tuser with tlast aborts the frame, which is ended with tuser after the ICV.
+// The first bytes of a frame wait for the EtherType and the ICV follows the last byte after the GCM tag is computed.
+//
+// Registers (32bit access only)
+//   0x00 CONTROL            RW  bit0: enable, bit1: confidentiality (E and C of the TCI, integrity only if 0),
+//                               bit2: include the SCI in the SecTAG, bit5-4: AN.
+//                               Writing this register loads KEY at the next frame boundary.
+//   0x04 STATUS             R   bit0: key loaded, bit1: PN exhausted
+//   0x08 SCI_HI             RW  SCI[63:32], the first 4 bytes of the MAC address
+//   0x0c SCI_LO             RW  SCI[31:0], the last 2 bytes of the MAC address and the port identifier
+//   0x10 NEXT_PN            RW  PN of the next protected frame (1 or more). Writing it clears the exhaustion.
+//   0x14 EXEMPT_ETHERTYPE   RW  bit16: enable, bit15-0: EtherType sent without protection
+//   0x20-0x2c KEY           W   SAK, the first byte at bit31-24 of 0x20
+//   0x30 PROTECTED_COUNT    R   frames sent with the SecTAG
+//   0x34 UNTAGGED_COUNT     R   frames sent without the SecTAG while enabled
+//   0x38 DROP_COUNT         R   frames dropped while enabled as the key is not loaded or the PN is exhausted
+module macsec_tx #(
+    parameter int ADDR_BITS = 8,
+    parameter int DIGIT_BITS = 32       // GHASH multiplier (see gcm_aes128)
+) (
+    input wire clock,
+    input wire aresetn,
+
+    input  wire [7:0] saxis_tdata,
+    input  wire       saxis_tvalid,
+    output logic      saxis_tready,
+    input  wire       saxis_tuser,
+    input  wire       saxis_tlast,
+
+    output logic [7:0] maxis_tdata,
+    output logic       maxis_tvalid,
+    input  wire        maxis_tready,
+    output logic       maxis_tuser,
+    output logic       maxis_tlast,
+
+    input  wire  [ADDR_BITS-1:0] s_axi_awaddr,
+    input  wire                  s_axi_awvalid,
+    output logic                 s_axi_awready,
+    input  wire  [31:0]          s_axi_wdata,
+    input  wire  [3:0]           s_axi_wstrb,
+    input  wire                  s_axi_wvalid,
+    output logic                 s_axi_wready,
+    output logic [1:0]           s_axi_bresp,
+    output logic                 s_axi_bvalid,
+    input  wire                  s_axi_bready,
+    input  wire  [ADDR_BITS-1:0] s_axi_araddr,
+    input  wire                  s_axi_arvalid,
+    output logic                 s_axi_arready,
+    output logic [31:0]          s_axi_rdata,
+    output logic [1:0]           s_axi_rresp,
+    output logic                 s_axi_rvalid,
+    input  wire                  s_axi_rready
+);
+
+localparam bit [15:0] ETHERTYPE_MACSEC = 16'h88e5;
+localparam bit [15:0] ETHERTYPE_MAC_CONTROL = 16'h8808;
+localparam bit [15:0] ETHERTYPE_EAPOL = 16'h888e;
+
+localparam int REG_CONTROL = 0;
+localparam int REG_STATUS = 1;
+localparam int REG_SCI_HI = 2;
+localparam int REG_SCI_LO = 3;
+localparam int REG_NEXT_PN = 4;
+localparam int REG_EXEMPT_ETHERTYPE = 5;
+localparam int REG_KEY = 8;
+localparam int REG_PROTECTED_COUNT = 12;
+localparam int REG_UNTAGGED_COUNT = 13;
+localparam int REG_DROP_COUNT = 14;
+
+logic         enable;
+logic         confidentiality;
+logic         include_sci;
+logic [1:0]   an;
+logic [63:0]  sci;
+logic [32:0]  next_pn;          // bit32: exhausted
+logic         exempt_enable;
+logic [15:0]  exempt_ethertype;
+logic [127:0] key;
+logic         key_pending;      // Loaded at the next frame boundary
+logic         key_loaded;
+logic [31:0]  protected_count;
+logic [31:0]  untagged_count;
+logic [31:0]  drop_count;
+
+// Frame
+typedef enum {
+    S_HEADER,
+    S_PASS_HEADER,
+    S_PASS,
+    S_DROP,
+    S_START,
+    S_AAD,
+    S_TEXT_TYPE,
+    S_TEXT,
+    S_ICV_WAIT,
+    S_ICV
+} state_t;
+
+state_t state;
+
+logic [111:0] header;           // Destination and source addresses and EtherType
+logic [3:0]   header_bytes;
+logic         header_last;      // The frame ended in the header.
+logic         header_user;
+logic [3:0]   output_index;
+logic [223:0] aad;              // Addresses and SecTAG
+logic [4:0]   aad_remaining;
+logic         frame_confidential;
+logic         frame_user;
+logic [127:0] icv;
+
+// GCM
+logic        gcm_key_load;
+logic        gcm_start;
+logic        gcm_ready;
+logic [7:0]  gcm_in_tdata;
+logic        gcm_in_tvalid;
+logic        gcm_in_tready;
+logic        gcm_in_tuser;
+logic        gcm_in_tlast;
+logic [7:0]  gcm_out_tdata;
+logic        gcm_out_tvalid;
+logic        gcm_out_tready;
+logic [127:0] gcm_tag;
+logic        gcm_tag_valid;
+
+gcm_aes128 #(
+    .DIGIT_BITS(DIGIT_BITS)
+) gcm_aes128_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .key(key),
+    .key_load(gcm_key_load),
+    .iv({sci, next_pn[31:0]}),
+    .decrypt(1'b0),
+    .start(gcm_start),
+    .ready(gcm_ready),
+    .saxis_tdata(gcm_in_tdata),
+    .saxis_tvalid(gcm_in_tvalid),
+    .saxis_tready(gcm_in_tready),
+    .saxis_tuser(gcm_in_tuser),
+    .saxis_tlast(gcm_in_tlast),
+    .maxis_tdata(gcm_out_tdata),
+    .maxis_tvalid(gcm_out_tvalid),
+    .maxis_tready(gcm_out_tready),
+    .maxis_tuser(),
+    .maxis_tlast(),
+    .tag(gcm_tag),
+    .tag_valid(gcm_tag_valid)
+);
+
+// AXI4-Lite write
+logic write_enable;
+logic [ADDR_BITS-3:0] write_index;
+assign write_enable = s_axi_awvalid && s_axi_wvalid && !s_axi_bvalid;
+assign write_index = s_axi_awaddr[ADDR_BITS-1:2];
+assign s_axi_awready = write_enable;
+assign s_axi_wready = write_enable;
+assign s_axi_bresp = 2'b00;
+
+// The PN is taken when the GCM is started.
+wire pn_taken = state == S_START && gcm_ready;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        s_axi_bvalid <= 0;
+        enable <= 0;
+        confidentiality <= 1;
+        include_sci <= 1;
+        an <= 0;
+        sci <= 0;
+        next_pn <= 1;
+        exempt_enable <= 0;
+        exempt_ethertype <= 0;
+        key <= 0;
+        key_pending <= 0;
+    end
+    else begin
+        if( s_axi_bvalid && s_axi_bready ) begin
+            s_axi_bvalid <= 0;
+        end
+        if( gcm_key_load ) begin
+            key_pending <= 0;
+        end
+        if( pn_taken ) begin
+            next_pn <= next_pn + 1;
+        end
+        if( write_enable ) begin
+            s_axi_bvalid <= 1;
+            case(write_index)
+            REG_CONTROL: begin
+                enable <= s_axi_wdata[0];
+                confidentiality <= s_axi_wdata[1];
+                include_sci <= s_axi_wdata[2];
+                an <= s_axi_wdata[5:4];
+                key_pending <= 1;
+            end
+            REG_SCI_HI: sci[63:32] <= s_axi_wdata;
+            REG_SCI_LO: sci[31:0] <= s_axi_wdata;
+            REG_NEXT_PN: next_pn <= {1'b0, s_axi_wdata};
+            REG_EXEMPT_ETHERTYPE: begin
+                exempt_enable <= s_axi_wdata[16];
+                exempt_ethertype <= s_axi_wdata[15:0];
+            end
+            REG_KEY + 0: key[127:96] <= s_axi_wdata;
+            REG_KEY + 1: key[95:64] <= s_axi_wdata;
+            REG_KEY + 2: key[63:32] <= s_axi_wdata;
+            REG_KEY + 3: key[31:0] <= s_axi_wdata;
+            default: ;
+            endcase
+        end
+    end
+end
+
+// AXI4-Lite read
+logic [ADDR_BITS-3:0] read_index;
+assign read_index = s_axi_araddr[ADDR_BITS-1:2];
+assign s_axi_arready = !s_axi_rvalid;
+assign s_axi_rresp = 2'b00;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        s_axi_rvalid <= 0;
+        s_axi_rdata <= 0;
+    end
+    else begin
+        if( s_axi_rvalid && s_axi_rready ) begin
+            s_axi_rvalid <= 0;
+        end
+        if( s_axi_arvalid && s_axi_arready ) begin
+            s_axi_rvalid <= 1;
+            case(read_index)
+            REG_CONTROL: s_axi_rdata <= {26'b0, an, 1'b0, include_sci, confidentiality, enable};
+            REG_STATUS: s_axi_rdata <= {30'b0, next_pn[32], key_loaded};
+            REG_SCI_HI: s_axi_rdata <= sci[63:32];
+            REG_SCI_LO: s_axi_rdata <= sci[31:0];
+            REG_NEXT_PN: s_axi_rdata <= next_pn[31:0];
+            REG_EXEMPT_ETHERTYPE: s_axi_rdata <= {15'b0, exempt_enable, exempt_ethertype};
+            REG_PROTECTED_COUNT: s_axi_rdata <= protected_count;
+            REG_UNTAGGED_COUNT: s_axi_rdata <= untagged_count;
+            REG_DROP_COUNT: s_axi_rdata <= drop_count;
+            default: s_axi_rdata <= 0;
+            endcase
+        end
+    end
+end
+
+// Frame
+wire input_valid = saxis_tvalid && saxis_tready;
+wire [15:0] ethertype = {header[15:8], saxis_tdata};    // With the 14th byte
+wire exempt = ethertype == ETHERTYPE_MAC_CONTROL || ethertype == ETHERTYPE_EAPOL || exempt_enable && ethertype == exempt_ethertype;
+wire [7:0] tci = {1'b0, 1'b0, include_sci, 1'b0, confidentiality, confidentiality, an};
+
+// The key is loaded between frames while the GCM is idle.
+assign gcm_key_load = state == S_HEADER && header_bytes == 0 && key_pending && gcm_ready;
+assign gcm_start = pn_taken;
+
+always_comb begin
+    saxis_tready = 0;
+    maxis_tdata = gcm_out_tdata;
+    maxis_tvalid = 0;
+    maxis_tuser = 0;
+    maxis_tlast = 0;
+    gcm_in_tdata = saxis_tdata;
+    gcm_in_tvalid = 0;
+    gcm_in_tuser = !frame_confidential;
+    gcm_in_tlast = 0;
+    gcm_out_tready = maxis_tready;
+
+    case( state )
+    S_HEADER: begin
+        saxis_tready = 1;
+    end
+    S_PASS_HEADER: begin
+        maxis_tdata = header[111 - 8*output_index -: 8];
+        maxis_tvalid = 1;
+        maxis_tlast = header_last && output_index == header_bytes - 1;
+        maxis_tuser = header_user && maxis_tlast;
+    end
+    S_PASS: begin
+        saxis_tready = maxis_tready;
+        maxis_tdata = saxis_tdata;
+        maxis_tvalid = saxis_tvalid;
+        maxis_tuser = saxis_tuser;
+        maxis_tlast = saxis_tlast;
+    end
+    S_DROP: begin
+        saxis_tready = 1;
+    end
+    S_AAD: begin
+        gcm_in_tdata = aad[223:216];
+        gcm_in_tvalid = 1;
+        gcm_in_tuser = 1;
+        maxis_tvalid = gcm_out_tvalid;
+    end
+    S_TEXT_TYPE: begin
+        gcm_in_tdata = output_index == 0 ? header[15:8] : header[7:0];
+        gcm_in_tvalid = 1;
+        gcm_in_tlast = header_last && output_index == 1;
+        maxis_tvalid = gcm_out_tvalid;
+    end
+    S_TEXT: begin
+        saxis_tready = gcm_in_tready;
+        gcm_in_tvalid = saxis_tvalid;
+        gcm_in_tlast = saxis_tlast;
+        maxis_tvalid = gcm_out_tvalid;
+    end
+    S_ICV: begin
+        maxis_tdata = icv[127 - 8*output_index -: 8];
+        maxis_tvalid = 1;
+        maxis_tlast = output_index == 15;
+        maxis_tuser = frame_user && maxis_tlast;
+    end
+    default: ;
+    endcase
+end
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        state <= S_HEADER;
+        header <= 0;
+        header_bytes <= 0;
+        header_last <= 0;
+        header_user <= 0;
+        output_index <= 0;
+        aad <= 0;
+        aad_remaining <= 0;
+        frame_confidential <= 0;
+        frame_user <= 0;
+        icv <= 0;
+        key_loaded <= 0;
+        protected_count <= 0;
+        untagged_count <= 0;
+        drop_count <= 0;
+    end
+    else begin
+        if( gcm_key_load ) begin
+            key_loaded <= 1;
+        end
+        if( gcm_tag_valid ) begin
+            icv <= gcm_tag;
+        end
+
+        case( state )
+        S_HEADER: begin
+            if( input_valid ) begin
+                header[111 - 8*header_bytes -: 8] <= saxis_tdata;
+                header_bytes <= header_bytes + 1;
+                header_last <= saxis_tlast;
+                header_user <= saxis_tuser;
+                output_index <= 0;
+                if( header_bytes == 13 ) begin
+                    if( !enable || exempt ) begin
+                        if( enable ) untagged_count <= untagged_count + 1;
+                        state <= S_PASS_HEADER;
+                    end
+                    else if( !key_loaded || next_pn[32] ) begin
+                        drop_count <= drop_count + 1;
+                        header_bytes <= 0;
+                        if( !saxis_tlast ) state <= S_DROP;
+                    end
+                    else begin
+                        frame_user <= saxis_tuser;
+                        state <= S_START;
+                    end
+                end
+                else if( saxis_tlast ) begin
+                    // Shorter than the header, sent as is.
+                    state <= S_PASS_HEADER;
+                end
+            end
+        end
+        S_PASS_HEADER: begin
+            if( maxis_tready ) begin
+                output_index <= output_index + 1;
+                if( output_index == header_bytes - 1 ) begin
+                    header_bytes <= 0;
+                    state <= header_last ? S_HEADER : S_PASS;
+                end
+            end
+        end
+        S_PASS: begin
+            if( input_valid && saxis_tlast ) begin
+                state <= S_HEADER;
+            end
+        end
+        S_DROP: begin
+            if( input_valid && saxis_tlast ) begin
+                state <= S_HEADER;
+            end
+        end
+        S_START: begin
+            if( gcm_ready ) begin
+                aad <= {header[111:16], ETHERTYPE_MACSEC, tci, 8'h00, next_pn[31:0], sci};
+                aad_remaining <= include_sci ? 28 : 20;
+                frame_confidential <= confidentiality;
+                protected_count <= protected_count + 1;
+                state <= S_AAD;
+            end
+        end
+        S_AAD: begin
+            if( gcm_in_tready ) begin
+                aad <= aad << 8;
+                aad_remaining <= aad_remaining - 1;
+                if( aad_remaining == 1 ) begin
+                    output_index <= 0;
+                    state <= S_TEXT_TYPE;
+                end
+            end
+        end
+        S_TEXT_TYPE: begin
+            if( gcm_in_tready ) begin
+                output_index <= output_index + 1;
+                if( output_index == 1 ) begin
+                    output_index <= 0;
+                    state <= header_last ? S_ICV_WAIT : S_TEXT;
+                end
+            end
+        end
+        S_TEXT: begin
+            if( input_valid && saxis_tlast ) begin
+                frame_user <= saxis_tuser;
+                state <= S_ICV_WAIT;
+            end
+        end
+        S_ICV_WAIT: begin
+            if( gcm_tag_valid ) begin
+                output_index <= 0;
+                state <= S_ICV;
+            end
+        end
+        S_ICV: begin
+            if( maxis_tready ) begin
+                output_index <= output_index + 1;
+                if( output_index == 15 ) begin
+                    header_bytes <= 0;
+                    state <= S_HEADER;
+                end
+            end
+        end
+        endcase
+    end
+end
+
+endmodule
+
+`default_nettype wire
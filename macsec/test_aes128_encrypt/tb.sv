@@ -0,0 +1,80 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+
+    logic [127:0] key = 0;
+    logic [127:0] block = 0;
+    logic         start = 0;
+    logic         busy;
+    logic         done;
+    logic [127:0] result;
+
+    aes128_encrypt dut (
+        .*
+    );
+
+    initial begin
+        clock = 0;
+    end
+    always #(5) begin
+        clock = ~clock;
+    end
+
+    typedef struct {
+        bit [127:0] key;
+        bit [127:0] plaintext;
+        bit [127:0] ciphertext;
+    } vector_t;
+
+    // FIPS-197 Appendix B and C.1, SP 800-38A F.1.1 (the first block)
+    localparam int NUMBER_OF_VECTORS = 3;
+    vector_t vectors[NUMBER_OF_VECTORS] = '{
+        '{128'h2b7e151628aed2a6abf7158809cf4f3c, 128'h3243f6a8885a308d313198a2e0370734, 128'h3925841d02dc09fbdc118597196a0b32},
+        '{128'h000102030405060708090a0b0c0d0e0f, 128'h00112233445566778899aabbccddeeff, 128'h69c4e0d86a7b0430d8cdb78070b4c55a},
+        '{128'h2b7e151628aed2a6abf7158809cf4f3c, 128'h6bc1bee22e409f96e93d7e117393172a, 128'h3ad77bb40d7a3660a89ecaf32466ef97}
+    };
+
+    initial begin
+        int cycles;
+
+        aresetn <= 0;
+        repeat(4) @(posedge clock);
+        aresetn <= 1;
+        @(posedge clock);
+
+        for(int i = 0; i < NUMBER_OF_VECTORS; i++) begin
+            key <= vectors[i].key;
+            block <= vectors[i].plaintext;
+            start <= 1;
+            @(posedge clock);
+            start <= 0;
+            key <= 0;
+            block <= 0;
+            cycles = 0;
+            while( !done ) begin
+                @(posedge clock);
+                cycles++;
+            end
+            if( cycles != 11 ) $error("vector #%0d took %0d clocks", i, cycles);
+            if( result != vectors[i].ciphertext ) $error("vector #%0d mismatch, expected: %032x, actual: %032x", i, vectors[i].ciphertext, result);
+        end
+
+        // The next block is started in the cycle of done.
+        key <= vectors[0].key;
+        block <= vectors[0].plaintext;
+        start <= 1;
+        @(posedge clock);
+        block <= vectors[1].plaintext;
+        key <= vectors[1].key;
+        while( !done ) @(posedge clock);
+        if( result != vectors[0].ciphertext ) $error("back-to-back #0 mismatch, actual: %032x", result);
+        @(posedge clock);
+        start <= 0;
+        while( !done ) @(posedge clock);
+        if( result != vectors[1].ciphertext ) $error("back-to-back #1 mismatch, actual: %032x", result);
+
+        $finish;
+    end
+endmodule
@@ -0,0 +1,197 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+
+    initial begin
+        clock = 0;
+    end
+    always #(5) begin
+        clock = ~clock;
+    end
+
+    typedef bit [7:0] bytes_t[$];
+
+    function automatic bytes_t hex(input string s);
+        bytes_t result;
+        for(int i = 0; i + 1 < s.len(); i += 2) result.push_back(s.substr(i, i + 1).atohex());
+        return result;
+    endfunction
+
+    function automatic bit [127:0] hex128(input string s);
+        bytes_t b = hex(s);
+        bit [127:0] result = 0;
+        foreach(b[i]) result[127 - 8*i -: 8] = b[i];
+        return result;
+    endfunction
+
+    typedef struct {
+        string name;
+        string key;
+        string iv;
+        string aad;
+        string input_text;
+        string output_text;
+        string tag;
+        bit    decrypt;
+    } vector_t;
+
+    localparam string K3 = "feffe9928665731c6d6a8f9467308308";
+    localparam string IV3 = "cafebabefacedbaddecaf888";
+    localparam string P3 = "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255";
+    localparam string C3 = "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985";
+    localparam string A4 = "feedfacedeadbeeffeedfacedeadbeefabaddad2";
+    localparam string P4 = "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39";
+    localparam string C4 = "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091";
+
+    // Test Cases 2, 3 and 4 of the GCM specification (McGrew and Viega), and GMAC over the AAD and the text of Test Case 4.
+    localparam int NUMBER_OF_VECTORS = 6;
+    vector_t vectors[NUMBER_OF_VECTORS] = '{
+        '{"TC2", "00000000000000000000000000000000", "000000000000000000000000", "", "00000000000000000000000000000000", "0388dace60b6a392f328c2b971b2fe78", "ab6e47d42cec13bdf53a67b21257bddf", 0},
+        '{"TC3", K3, IV3, "", P3, C3, "4d5c2af327cd64a62cf35abd2ba6fab4", 0},
+        '{"TC4", K3, IV3, A4, P4, C4, "5bc94fbc3221a5db94fae95ae7121a47", 0},
+        '{"TC4 decrypt", K3, IV3, A4, C4, P4, "5bc94fbc3221a5db94fae95ae7121a47", 1},
+        '{"GMAC", K3, IV3, {A4, P4}, "", "", "4b28357f198fc8344618fa46306b827f", 0},
+        '{"TC2 again", "00000000000000000000000000000000", "000000000000000000000000", "", "00000000000000000000000000000000", "0388dace60b6a392f328c2b971b2fe78", "ab6e47d42cec13bdf53a67b21257bddf", 0}
+    };
+
+    // Runs the vectors with the GHASH multiplier of DIGIT_BITS, with random stalls on both sides.
+    module gcm_lane #(
+        parameter int DIGIT_BITS = 32
+    ) (
+        input  logic clock,
+        input  logic aresetn,
+        output bit   done
+    );
+        logic [127:0] key = 0;
+        logic         key_load = 0;
+        logic [95:0]  iv = 0;
+        logic         decrypt = 0;
+        logic         start = 0;
+        logic         ready;
+
+        logic [7:0] saxis_tdata = 0;
+        logic       saxis_tvalid = 0;
+        logic       saxis_tready;
+        logic       saxis_tuser = 0;
+        logic       saxis_tlast = 0;
+
+        logic [7:0] maxis_tdata;
+        logic       maxis_tvalid;
+        logic       maxis_tready = 0;
+        logic       maxis_tuser;
+        logic       maxis_tlast;
+
+        logic [127:0] tag;
+        logic         tag_valid;
+
+        gcm_aes128 #(.DIGIT_BITS(DIGIT_BITS)) dut (
+            .*
+        );
+
+        bytes_t expected_data;
+        bit     expected_user[$];
+        int     received = 0;
+
+        always @(posedge clock) begin
+            maxis_tready <= $urandom_range(0, 3) != 0;
+            if( maxis_tvalid && maxis_tready ) begin
+                if( expected_data.size() == 0 ) begin
+                    $error("DIGIT_BITS=%0d: unexpected byte", DIGIT_BITS);
+                end
+                else begin
+                    bit [7:0] expected = expected_data.pop_front();
+                    bit       user = expected_user.pop_front();
+                    if( maxis_tdata != expected ) $error("DIGIT_BITS=%0d: byte #%0d mismatch, expected: %02x, actual: %02x", DIGIT_BITS, received, expected, maxis_tdata);
+                    if( maxis_tuser != user ) $error("DIGIT_BITS=%0d: tuser mismatch at #%0d", DIGIT_BITS, received);
+                    if( maxis_tlast != (expected_data.size() == 0) ) $error("DIGIT_BITS=%0d: tlast mismatch at #%0d", DIGIT_BITS, received);
+                end
+                received++;
+            end
+        end
+
+        task automatic run(input vector_t vector);
+            bytes_t aad = hex(vector.aad);
+            bytes_t text = hex(vector.input_text);
+            bytes_t expected_text = hex(vector.output_text);
+            bit [127:0] expected_tag = hex128(vector.tag);
+            bit [127:0] actual_tag;
+            bit         tag_seen = 0;
+            int         length = aad.size() + text.size();
+
+            foreach(aad[i]) begin
+                expected_data.push_back(aad[i]);
+                expected_user.push_back(1);
+            end
+            foreach(expected_text[i]) begin
+                expected_data.push_back(expected_text[i]);
+                expected_user.push_back(0);
+            end
+
+            while( !ready ) @(posedge clock);
+            key <= hex128(vector.key);
+            key_load <= 1;
+            @(posedge clock);
+            key_load <= 0;
+            key <= 0;
+            @(posedge clock);
+            while( !ready ) @(posedge clock);
+            iv <= hex128({vector.iv, "00000000"}) >> 32;
+            decrypt <= vector.decrypt;
+            start <= 1;
+            @(posedge clock);
+            start <= 0;
+            iv <= 0;
+            decrypt <= 0;
+
+            fork
+                for(int i = 0; i < length; i++) begin
+                    repeat($urandom_range(0, 1)) @(posedge clock);
+                    saxis_tdata <= i < aad.size() ? aad[i] : text[i - aad.size()];
+                    saxis_tuser <= i < aad.size();
+                    saxis_tlast <= i == length - 1;
+                    saxis_tvalid <= 1;
+                    @(posedge clock);
+                    while( !saxis_tready ) @(posedge clock);
+                    saxis_tvalid <= 0;
+                    saxis_tlast <= 0;
+                end
+                begin
+                    while( !tag_valid ) @(posedge clock);
+                    actual_tag = tag;
+                    tag_seen = 1;
+                end
+            join
+
+            if( !tag_seen ) $error("DIGIT_BITS=%0d, %s: no tag", DIGIT_BITS, vector.name);
+            if( actual_tag != expected_tag ) $error("DIGIT_BITS=%0d, %s: tag mismatch, expected: %032x, actual: %032x", DIGIT_BITS, vector.name, expected_tag, actual_tag);
+            repeat(4) @(posedge clock);
+            if( expected_data.size() != 0 ) $error("DIGIT_BITS=%0d, %s: %0d bytes are missing", DIGIT_BITS, vector.name, expected_data.size());
+            expected_data.delete();
+            expected_user.delete();
+        endtask
+
+        initial begin
+            done = 0;
+            @(posedge aresetn);
+            @(posedge clock);
+            foreach(vectors[i]) run(vectors[i]);
+            done = 1;
+        end
+    endmodule
+
+    bit done_8;
+    bit done_32;
+
+    gcm_lane #(.DIGIT_BITS(8))  lane_8  (.clock(clock), .aresetn(aresetn), .done(done_8));
+    gcm_lane #(.DIGIT_BITS(32)) lane_32 (.clock(clock), .aresetn(aresetn), .done(done_32));
+
+    initial begin
+        aresetn <= 0;
+        repeat(4) @(posedge clock);
+        aresetn <= 1;
+        wait( done_8 && done_32 );
+        $finish;
+    end
+endmodule
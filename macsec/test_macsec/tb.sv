@@ -0,0 +1,410 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+
+    typedef bit [7:0] frame_t[$];
+
+    // Frames to macsec_tx
+    logic [7:0] tx_saxis_tdata = 0;
+    logic       tx_saxis_tvalid = 0;
+    logic       tx_saxis_tready;
+    logic       tx_saxis_tuser = 0;
+    logic       tx_saxis_tlast = 0;
+
+    logic [7:0] tx_maxis_tdata;
+    logic       tx_maxis_tvalid;
+    logic       tx_maxis_tready = 0;
+    logic       tx_maxis_tuser;
+    logic       tx_maxis_tlast;
+
+    // Frames from the line to macsec_rx
+    logic [7:0] rx_saxis_tdata = 0;
+    logic       rx_saxis_tvalid = 0;
+    logic       rx_saxis_tuser = 0;
+    logic       rx_saxis_tlast = 0;
+
+    logic [7:0] rx_maxis_tdata;
+    logic       rx_maxis_tvalid;
+    logic       rx_maxis_tuser;
+    logic       rx_maxis_tlast;
+
+    // The registers of macsec_tx at 0x000 and macsec_rx at 0x100
+    logic [8:0]  s_axi_awaddr;
+    logic        s_axi_awvalid;
+    logic        s_axi_awready;
+    logic [31:0] s_axi_wdata;
+    logic [3:0]  s_axi_wstrb;
+    logic        s_axi_wvalid;
+    logic        s_axi_wready;
+    logic        s_axi_bvalid;
+    logic        s_axi_bready;
+    logic [8:0]  s_axi_araddr;
+    logic        s_axi_arvalid;
+    logic        s_axi_arready;
+    logic [31:0] s_axi_rdata;
+    logic        s_axi_rvalid;
+    logic        s_axi_rready;
+
+    logic        tx_awready, tx_wready, tx_bvalid, tx_arready, tx_rvalid;
+    logic        rx_awready, rx_wready, rx_bvalid, rx_arready, rx_rvalid;
+    logic [31:0] tx_rdata, rx_rdata;
+
+    assign s_axi_awready = s_axi_awaddr[8] ? rx_awready : tx_awready;
+    assign s_axi_wready = s_axi_awaddr[8] ? rx_wready : tx_wready;
+    assign s_axi_bvalid = tx_bvalid || rx_bvalid;
+    assign s_axi_arready = s_axi_araddr[8] ? rx_arready : tx_arready;
+    assign s_axi_rvalid = tx_rvalid || rx_rvalid;
+    assign s_axi_rdata = rx_rvalid ? rx_rdata : tx_rdata;
+
+    macsec_tx tx_inst (
+        .clock(clock),
+        .aresetn(aresetn),
+        .saxis_tdata(tx_saxis_tdata),
+        .saxis_tvalid(tx_saxis_tvalid),
+        .saxis_tready(tx_saxis_tready),
+        .saxis_tuser(tx_saxis_tuser),
+        .saxis_tlast(tx_saxis_tlast),
+        .maxis_tdata(tx_maxis_tdata),
+        .maxis_tvalid(tx_maxis_tvalid),
+        .maxis_tready(tx_maxis_tready),
+        .maxis_tuser(tx_maxis_tuser),
+        .maxis_tlast(tx_maxis_tlast),
+        .s_axi_awaddr(s_axi_awaddr[7:0]),
+        .s_axi_awvalid(s_axi_awvalid && !s_axi_awaddr[8]),
+        .s_axi_awready(tx_awready),
+        .s_axi_wdata(s_axi_wdata),
+        .s_axi_wstrb(s_axi_wstrb),
+        .s_axi_wvalid(s_axi_wvalid && !s_axi_awaddr[8]),
+        .s_axi_wready(tx_wready),
+        .s_axi_bresp(),
+        .s_axi_bvalid(tx_bvalid),
+        .s_axi_bready(s_axi_bready),
+        .s_axi_araddr(s_axi_araddr[7:0]),
+        .s_axi_arvalid(s_axi_arvalid && !s_axi_araddr[8]),
+        .s_axi_arready(tx_arready),
+        .s_axi_rdata(tx_rdata),
+        .s_axi_rresp(),
+        .s_axi_rvalid(tx_rvalid),
+        .s_axi_rready(s_axi_rready)
+    );
+
+    macsec_rx rx_inst (
+        .clock(clock),
+        .aresetn(aresetn),
+        .saxis_tdata(rx_saxis_tdata),
+        .saxis_tvalid(rx_saxis_tvalid),
+        .saxis_tuser(rx_saxis_tuser),
+        .saxis_tlast(rx_saxis_tlast),
+        .maxis_tdata(rx_maxis_tdata),
+        .maxis_tvalid(rx_maxis_tvalid),
+        .maxis_tuser(rx_maxis_tuser),
+        .maxis_tlast(rx_maxis_tlast),
+        .s_axi_awaddr(s_axi_awaddr[7:0]),
+        .s_axi_awvalid(s_axi_awvalid && s_axi_awaddr[8]),
+        .s_axi_awready(rx_awready),
+        .s_axi_wdata(s_axi_wdata),
+        .s_axi_wstrb(s_axi_wstrb),
+        .s_axi_wvalid(s_axi_wvalid && s_axi_awaddr[8]),
+        .s_axi_wready(rx_wready),
+        .s_axi_bresp(),
+        .s_axi_bvalid(rx_bvalid),
+        .s_axi_bready(s_axi_bready),
+        .s_axi_araddr(s_axi_araddr[7:0]),
+        .s_axi_arvalid(s_axi_arvalid && s_axi_araddr[8]),
+        .s_axi_arready(rx_arready),
+        .s_axi_rdata(rx_rdata),
+        .s_axi_rresp(),
+        .s_axi_rvalid(rx_rvalid),
+        .s_axi_rready(s_axi_rready)
+    );
+
+    initial begin
+        clock = 0;
+    end
+    always #(20) begin
+        clock = ~clock;
+    end
+
+    localparam bit [8:0] TX = 9'h000;
+    localparam bit [8:0] RX = 9'h100;
+    localparam bit [127:0] KEY = 128'hfeffe9928665731c6d6a8f9467308308;
+    localparam bit [63:0] SCI = 64'h0011223344550001;
+
+    // The frame of PN 1 from make_frame(16'h0800, 60), protected with KEY and SCI by a reference model.
+    localparam string PROTECTED_FRAME = {
+        "ffffffffffff02030405060788e52c000000000100112233445500019d10fa1efce52f8514a426af0fed180262cb1d599c8b42f8",
+        "0511434e341db85b35ebe2ab67203f5926c2e5c275d666a0edb6a8734a99fa567e82f2bebbb44022"
+    };
+
+    function automatic frame_t hex(input string s);
+        frame_t result;
+        for(int i = 0; i + 1 < s.len(); i += 2) result.push_back(s.substr(i, i + 1).atohex());
+        return result;
+    endfunction
+
+    function automatic frame_t make_frame(input bit [15:0] ethertype, input int length);
+        frame_t frame;
+        for(int i = 0; i < 6; i++) frame.push_back(8'hff);
+        for(int i = 0; i < 6; i++) frame.push_back(8'h02 + i);
+        frame.push_back(ethertype[15:8]);
+        frame.push_back(ethertype[7:0]);
+        while( frame.size() < length ) frame.push_back(8'h10 + frame.size());
+        return frame;
+    endfunction
+
+    // The MAC takes a byte every two clocks like MII.
+    always @(posedge clock) begin
+        tx_maxis_tready <= !tx_maxis_tready;
+    end
+
+    frame_t tx_frames[$];
+    bit     tx_aborted[$];
+    frame_t tx_receiving;
+    always @(posedge clock) begin
+        if( tx_maxis_tvalid && tx_maxis_tready ) begin
+            tx_receiving.push_back(tx_maxis_tdata);
+            if( tx_maxis_tlast ) begin
+                tx_frames.push_back(tx_receiving);
+                tx_aborted.push_back(tx_maxis_tuser);
+                tx_receiving = {};
+            end
+        end
+    end
+
+    frame_t rx_frames[$];
+    bit     rx_errors[$];
+    frame_t rx_receiving;
+    always @(posedge clock) begin
+        if( rx_maxis_tvalid ) begin
+            rx_receiving.push_back(rx_maxis_tdata);
+            if( rx_maxis_tlast ) begin
+                rx_frames.push_back(rx_receiving);
+                rx_errors.push_back(rx_maxis_tuser);
+                rx_receiving = {};
+            end
+        end
+    end
+
+    task automatic axi_write(input logic [8:0] address, input logic [31:0] data);
+        s_axi_awaddr <= address;
+        s_axi_awvalid <= 1;
+        s_axi_wdata <= data;
+        s_axi_wstrb <= 4'hf;
+        s_axi_wvalid <= 1;
+        s_axi_bready <= 1;
+        do @(posedge clock); while(!(s_axi_awready && s_axi_wready));
+        s_axi_awvalid <= 0;
+        s_axi_wvalid <= 0;
+        do @(posedge clock); while(!s_axi_bvalid);
+        s_axi_bready <= 0;
+    endtask
+
+    task automatic axi_read(input logic [8:0] address, output logic [31:0] data);
+        s_axi_araddr <= address;
+        s_axi_arvalid <= 1;
+        s_axi_rready <= 1;
+        do @(posedge clock); while(!s_axi_arready);
+        s_axi_arvalid <= 0;
+        do @(posedge clock); while(!s_axi_rvalid);
+        data = s_axi_rdata;
+        s_axi_rready <= 0;
+    endtask
+
+    task automatic check_register(input logic [8:0] address, input logic [31:0] expected, input string name);
+        logic [31:0] value;
+        axi_read(address, value);
+        if( value != expected ) $error("%s expected: %0d, actual: %0d", name, expected, value);
+    endtask
+
+    // Sends a frame to macsec_tx, aborted with tuser if abort.
+    task automatic send_tx(input frame_t frame, input bit abort = 0);
+        foreach(frame[i]) begin
+            tx_saxis_tdata <= frame[i];
+            tx_saxis_tvalid <= 1;
+            tx_saxis_tlast <= i == frame.size() - 1;
+            tx_saxis_tuser <= abort && i == frame.size() - 1;
+            do @(posedge clock); while(!tx_saxis_tready);
+            tx_saxis_tvalid <= 0;
+            tx_saxis_tlast <= 0;
+            tx_saxis_tuser <= 0;
+        end
+    endtask
+
+    // Sends a frame from the line to macsec_rx, a byte every two clocks followed by the IFG and the preamble.
+    task automatic send_rx(input frame_t frame, input bit error = 0);
+        foreach(frame[i]) begin
+            rx_saxis_tdata <= frame[i];
+            rx_saxis_tvalid <= 1;
+            rx_saxis_tlast <= i == frame.size() - 1;
+            rx_saxis_tuser <= error && i == frame.size() - 1;
+            @(posedge clock);
+            rx_saxis_tvalid <= 0;
+            rx_saxis_tlast <= 0;
+            rx_saxis_tuser <= 0;
+            @(posedge clock);
+        end
+        repeat(2*20) @(posedge clock);
+    endtask
+
+    task automatic wait_tx(input int count);
+        fork
+            wait(tx_frames.size() >= count);
+            begin
+                repeat(10000) @(posedge clock);
+                $error("timed out waiting for %0d frames from macsec_tx (%0d received)", count, tx_frames.size());
+            end
+        join_any
+        disable fork;
+    endtask
+
+    // Waits for the frames from macsec_rx for a while, as the discarded frames are not output.
+    task automatic settle_rx();
+        repeat(200) @(posedge clock);
+    endtask
+
+    // Sends a frame through macsec_tx and then macsec_rx, and returns the frame on the line.
+    task automatic send_through(input frame_t frame, output frame_t line);
+        int index = tx_frames.size();
+        send_tx(frame);
+        wait_tx(index + 1);
+        line = tx_frames[index];
+        if( tx_aborted[index] ) $error("tx frame #%0d is aborted", index);
+        send_rx(line);
+        settle_rx();
+    endtask
+
+    task automatic check_rx(input int index, input frame_t expected, input bit error = 0);
+        if( rx_frames.size() <= index ) begin
+            $error("rx frame #%0d is not received", index);
+        end
+        else begin
+            if( rx_frames[index] != expected ) $error("rx frame #%0d mismatch, size expected: %0d, actual: %0d", index, expected.size(), rx_frames[index].size());
+            if( rx_errors[index] != error ) $error("rx frame #%0d error expected: %0d, actual: %0d", index, error, rx_errors[index]);
+        end
+    endtask
+
+    initial begin
+        frame_t ipv4 = make_frame(16'h0800, 60);
+        frame_t long_frame = make_frame(16'h86dd, 200);
+        frame_t eapol = make_frame(16'h888e, 60);
+        frame_t line;
+        frame_t tampered;
+
+        s_axi_awvalid <= 0;
+        s_axi_wvalid <= 0;
+        s_axi_bready <= 0;
+        s_axi_arvalid <= 0;
+        s_axi_rready <= 0;
+        aresetn <= 0;
+        repeat(4) @(posedge clock);
+        aresetn <= 1;
+        repeat(4) @(posedge clock);
+
+        // Disabled, the frames pass through as is.
+        send_through(ipv4, line);
+        if( line != ipv4 ) $error("disabled tx modified the frame");
+        check_rx(0, ipv4);
+
+        axi_write(TX + 8'h08, SCI[63:32]);
+        axi_write(TX + 8'h0c, SCI[31:0]);
+        axi_write(RX + 8'h08, SCI[63:32]);
+        axi_write(RX + 8'h0c, SCI[31:0]);
+        for(int i = 0; i < 4; i++) begin
+            axi_write(TX + 8'h20 + 4*i, KEY[127 - 32*i -: 32]);
+            axi_write(RX + 8'h20 + 4*i, KEY[127 - 32*i -: 32]);
+        end
+        axi_write(TX + 8'h00, 32'h0000_0007);   // Enable, confidentiality and SCI, AN 0
+        axi_write(RX + 8'h00, 32'h0000_0005);   // Enable and replay protection, AN 0
+        repeat(20) @(posedge clock);
+        check_register(TX + 8'h04, 1, "tx STATUS");
+        check_register(RX + 8'h04, 1, "rx STATUS");
+
+        // Protected with PN 1 and validated.
+        send_through(ipv4, line);
+        if( line != hex(PROTECTED_FRAME) ) $error("protected frame mismatch");
+        check_rx(1, ipv4);
+        check_register(RX + 8'h10, 2, "rx NEXT_PN");
+
+        // A replayed frame is discarded.
+        send_rx(line);
+        settle_rx();
+        if( rx_frames.size() != 2 ) $error("replayed frame is output");
+
+        // A longer frame with PN 2.
+        send_through(long_frame, line);
+        if( line.size() != long_frame.size() + 16 + 16 ) $error("protected long frame has %0d bytes", line.size());
+        check_rx(2, long_frame);
+
+        // A modified frame fails the ICV and ends with tuser.
+        send_tx(ipv4);
+        wait_tx(4);
+        tampered = tx_frames[3];
+        tampered[40] ^= 8'h01;
+        send_rx(tampered);
+        settle_rx();
+        if( rx_frames.size() != 4 ) $error("tampered frame is not output");
+        else if( !rx_errors[3] ) $error("tampered frame is not ended with tuser");
+
+        // EAPOL is sent without protection and received as is.
+        send_through(eapol, line);
+        if( line != eapol ) $error("EAPOL frame is modified");
+        check_rx(4, eapol);
+
+        // An aborted frame is ended with tuser after the ICV.
+        send_tx(ipv4, 1);
+        wait_tx(6);
+        if( !tx_aborted[5] ) $error("aborted frame is not ended with tuser");
+        if( tx_frames[5].size() != ipv4.size() + 16 + 16 ) $error("aborted frame has %0d bytes", tx_frames[5].size());
+
+        // A frame with an error on the line is ended with tuser and not counted.
+        send_tx(ipv4);
+        wait_tx(7);
+        send_rx(tx_frames[6], 1);
+        settle_rx();
+        if( rx_frames.size() != 6 ) $error("frame with an error is not output");
+        else if( !rx_errors[5] ) $error("frame with an error is not ended with tuser");
+
+        // The strict mode discards untagged frames except EAPOL.
+        axi_write(RX + 8'h00, 32'h0000_0007);
+        send_rx(ipv4);
+        send_rx(eapol);
+        settle_rx();
+        if( rx_frames.size() != 7 ) $error("%0d frames are output in the strict mode, expected 7", rx_frames.size());
+        else check_rx(6, eapol);
+
+        // Integrity only without the SCI in the SecTAG, with AN 1.
+        axi_write(TX + 8'h00, 32'h0000_0011);
+        axi_write(RX + 8'h00, 32'h0000_0015);
+        send_through(ipv4, line);
+        if( line.size() != ipv4.size() + 8 + 16 ) $error("integrity only frame has %0d bytes", line.size());
+        else begin
+            if( line[14] != 8'h01 ) $error("TCI expected: 01, actual: %02x", line[14]);
+            for(int i = 12; i < ipv4.size(); i++) begin
+                if( line[i + 8] != ipv4[i] ) $error("integrity only frame is modified at #%0d", i);
+            end
+        end
+        check_rx(7, ipv4);
+
+        // A frame of another AN is not of the SA.
+        axi_write(RX + 8'h00, 32'h0000_0005);
+        send_through(ipv4, line);
+        if( rx_frames.size() != 8 ) $error("frame of another AN is output");
+
+        check_register(TX + 8'h30, 7, "tx PROTECTED_COUNT");
+        check_register(TX + 8'h34, 1, "tx UNTAGGED_COUNT");
+        check_register(TX + 8'h38, 0, "tx DROP_COUNT");
+        check_register(TX + 8'h10, 8, "tx NEXT_PN");
+        check_register(RX + 8'h30, 3, "rx OK_COUNT");
+        check_register(RX + 8'h34, 2, "rx UNTAGGED_COUNT");
+        check_register(RX + 8'h38, 1, "rx NO_TAG_COUNT");
+        check_register(RX + 8'h3c, 0, "rx BAD_TAG_COUNT");
+        check_register(RX + 8'h40, 1, "rx NOT_USING_SA_COUNT");
+        check_register(RX + 8'h44, 1, "rx LATE_COUNT");
+        check_register(RX + 8'h48, 1, "rx NOT_VALID_COUNT");
+        check_register(RX + 8'h04, 1, "rx STATUS");
+
+        $finish;
+    end
+endmodule
@@ -0,0 +1,102 @@
+`default_nettype none
+
+// Outputs the frames with the preamble on GMII, a byte per clock.
+// The frame must not be interrupted. If tvalid is deasserted in the middle of a frame,
+// gmii_er is asserted until the next byte so that the receiver discards the frame.
+module axis_to_gmii (
+    input wire clock,
+    input wire aresetn,
+
+    output reg [7:0] gmii_d,
+    output reg       gmii_en,
+    output reg       gmii_er,
+
+    input wire  [7:0]  saxis_tdata,
+    input wire         saxis_tvalid,
+    output reg         saxis_tready,
+    input wire         saxis_tlast,
+
+    output reg         sfd      // Asserted for a cycle when the SFD is transmitted.
+);
+
+localparam PREAMBLE = 8'h55;
+localparam INTERFRAME_BYTES = 12;
+
+logic       in_preamble;
+
+typedef enum  {
+    S_RESET,
+    S_IDLE,
+    S_DATA,
+    S_INTERFRAME
+} state_t;
+
+state_t state = S_RESET;
+
+always_comb begin
+    case(state)
+    S_IDLE: saxis_tready <= 1;
+    S_DATA: saxis_tready <= 1;
+    default: saxis_tready <= 0;
+    endcase
+end
+
+logic [$clog2(INTERFRAME_BYTES)-1:0] interframe = 0;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        state <= S_RESET;
+        gmii_d <= 0;
+        gmii_en <= 0;
+        gmii_er <= 0;
+        in_preamble <= 0;
+        sfd <= 0;
+    end
+    else begin
+        sfd <= 0;
+        case(state)
+        S_RESET: begin
+            state <= S_IDLE;
+        end
+        S_IDLE: begin
+            gmii_en <= 0;
+            gmii_er <= 0;
+            if( saxis_tvalid ) begin
+                gmii_d <= saxis_tdata;
+                gmii_en <= 1;
+                in_preamble <= saxis_tdata == PREAMBLE;
+                sfd <= saxis_tdata != PREAMBLE;
+                state <= saxis_tlast ? S_INTERFRAME : S_DATA;
+                interframe <= INTERFRAME_BYTES - 2;     // and a cycle in S_IDLE
+            end
+        end
+        S_DATA: begin
+            gmii_en <= 1;
+            gmii_er <= !saxis_tvalid;
+            if( saxis_tvalid ) begin
+                gmii_d <= saxis_tdata;
+                // The first octet other than the preamble is the SFD.
+                if( in_preamble && saxis_tdata != PREAMBLE ) begin
+                    sfd <= 1;
+                    in_preamble <= 0;
+                end
+                if( saxis_tlast ) begin
+                    state <= S_INTERFRAME;
+                end
+            end
+        end
+        S_INTERFRAME: begin
+            gmii_en <= 0;
+            gmii_er <= 0;
+            interframe <= interframe - 1;
+            if( interframe == 0 ) begin
+                state <= S_IDLE;
+            end
+        end
+        endcase
+    end
+end
+
+endmodule
+
+`default_nettype wire
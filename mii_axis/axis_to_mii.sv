@@ -11,11 +11,16 @@ module axis_to_mii (
     input wire  [7:0]  saxis_tdata,
     input wire         saxis_tvalid,
     output reg         saxis_tready,
-    input wire         saxis_tlast
+    input wire         saxis_tlast,
+
+    output reg         sfd      // Asserted for a cycle when the SFD is transmitted.
 );
 
+localparam PREAMBLE = 8'h55;
+
 logic [7:0] tdata;
 logic       tlast;
+logic       in_preamble;
 
 typedef enum  {
     S_RESET,
@@ -44,14 +49,18 @@ always_ff @(posedge clock) begin
         mii_d <= 0;
         mii_en <= 0;
         mii_er <= 0;
+        in_preamble <= 0;
+        sfd <= 0;
     end
     else begin
+        sfd <= 0;
         case(state)
         S_RESET: begin
             state <= S_IDLE;
             tlast <= 0;
         end
         S_IDLE: begin
+            in_preamble <= 1;
             if( saxis_tvalid ) begin
                 tdata <= saxis_tdata;
                 tlast <= saxis_tlast;
@@ -66,6 +75,11 @@ always_ff @(posedge clock) begin
         S_PHASE_1: begin
             mii_d <= tdata[7:4];
             mii_en <= 1;
+            // The first octet other than the preamble is the SFD.
+            if( in_preamble && tdata != PREAMBLE ) begin
+                sfd <= 1;
+                in_preamble <= 0;
+            end
             if( !tlast && saxis_tvalid ) begin
                 tdata <= saxis_tdata;
                 tlast <= saxis_tlast;
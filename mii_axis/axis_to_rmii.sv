@@ -10,11 +10,16 @@ module axis_to_rmii (
     input wire  [7:0]  saxis_tdata,
     input wire         saxis_tvalid,
     output logic       saxis_tready,
-    input wire         saxis_tlast
+    input wire         saxis_tlast,
+
+    output logic       sfd      // Asserted for a cycle when the SFD is transmitted.
 );
 
+localparam PREAMBLE = 8'h55;
+
 logic [7:0] tdata;
 logic       tlast;
+logic       in_preamble;
 
 typedef enum  {
     S_RESET,
@@ -44,14 +49,18 @@ always_ff @(posedge clock) begin
         tlast <= 0;
         rmii_d <= 0;
         rmii_en <= 0;
+        in_preamble <= 0;
+        sfd <= 0;
     end
     else begin
+        sfd <= 0;
         case(state)
         S_RESET: begin
             state <= S_IDLE;
             tlast <= 0;
         end
         S_IDLE: begin
+            in_preamble <= 1;
             if( saxis_tvalid ) begin
                 tdata <= saxis_tdata;
                 tlast <= saxis_tlast;
@@ -76,6 +85,11 @@ always_ff @(posedge clock) begin
         S_PHASE_3: begin
             rmii_d <= tdata[7:6];
             rmii_en <= 1;
+            // The first octet other than the preamble is the SFD.
+            if( in_preamble && tdata != PREAMBLE ) begin
+                sfd <= 1;
+                in_preamble <= 0;
+            end
             if( !tlast && saxis_tvalid ) begin
                 tdata <= saxis_tdata;
                 tlast <= saxis_tlast;
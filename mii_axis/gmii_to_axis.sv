@@ -0,0 +1,82 @@
+`default_nettype none
+
+// Receives the frames after the SFD on GMII, a byte per clock.
+// Each byte is output a clock later, so that tlast is asserted with the last byte when gmii_dv is deasserted.
+// tuser is asserted with tlast if gmii_er is asserted during the frame.
+module gmii_to_axis (
+    input wire clock,
+    input wire aresetn,
+
+    input wire [7:0] gmii_d,
+    input wire       gmii_dv,
+    input wire       gmii_er,
+
+    output reg  [7:0]  maxis_tdata,
+    output reg         maxis_tvalid,
+    output reg         maxis_tuser,
+    output reg         maxis_tlast,
+
+    output reg         sfd     // Asserted for a cycle when the SFD is received.
+);
+
+localparam PREAMBLE = 8'h55;
+localparam SFD = 8'hd5;
+
+logic in_frame;
+logic prev_is_preamble;
+logic held;         // A byte of the frame is held in tdata.
+logic [7:0] tdata;
+logic error;
+
+wire sfd_detected = prev_is_preamble && gmii_dv && gmii_d == SFD && !in_frame;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        in_frame <= 0;
+        prev_is_preamble <= 0;
+        held <= 0;
+        tdata <= 0;
+        error <= 0;
+        sfd <= 0;
+        maxis_tdata <= 0;
+        maxis_tvalid <= 0;
+        maxis_tuser <= 0;
+        maxis_tlast <= 0;
+    end
+    else begin
+        sfd <= sfd_detected;
+        prev_is_preamble <= gmii_dv && gmii_d == PREAMBLE;
+        maxis_tvalid <= 0;
+        maxis_tlast <= 0;
+        maxis_tuser <= 0;
+
+        if( sfd_detected ) begin
+            in_frame <= 1;
+            held <= 0;
+            error <= 0;
+        end
+        else if( in_frame ) begin
+            if( gmii_dv ) begin
+                // Output the held byte and hold the new one.
+                maxis_tdata <= tdata;
+                maxis_tvalid <= held;
+                tdata <= gmii_d;
+                held <= 1;
+                error <= error || gmii_er;
+            end
+            else begin
+                // End of the frame. The held byte is the last one.
+                maxis_tdata <= tdata;
+                maxis_tvalid <= held;
+                maxis_tlast <= held;
+                maxis_tuser <= error;
+                in_frame <= 0;
+                held <= 0;
+            end
+        end
+    end
+end
+
+endmodule
+
+`default_nettype wire
@@ -0,0 +1,67 @@
+`default_nettype none
+
+// Converts GMII to RGMII with the DDR output registers of 7 series.
+// TXD[3:0] and TXD[7:4] are sent on the rising and falling edges, and TX_CTL carries TX_EN and TX_EN xor TX_ER.
+// TXC is forwarded from clock90, which is the clock shifted by 90 degrees,
+// or the clock itself if the PHY delays TXC internally (RGMII-ID).
+module gmii_to_rgmii (
+    input wire clock,
+    input wire clock90,
+    input wire aresetn,
+
+    input wire [7:0] gmii_d,
+    input wire       gmii_en,
+    input wire       gmii_er,
+
+    output wire [3:0] rgmii_d,
+    output wire       rgmii_ctl,
+    output wire       rgmii_c
+);
+
+for(genvar i = 0; i < 4; i++) begin :data_block
+    ODDR #(
+        .DDR_CLK_EDGE("SAME_EDGE"),
+        .INIT(1'b0),
+        .SRTYPE("SYNC")
+    ) oddr_inst (
+        .C(clock),
+        .CE(1'b1),
+        .D1(gmii_d[i]),
+        .D2(gmii_d[i+4]),
+        .R(!aresetn),
+        .S(1'b0),
+        .Q(rgmii_d[i])
+    );
+end
+
+ODDR #(
+    .DDR_CLK_EDGE("SAME_EDGE"),
+    .INIT(1'b0),
+    .SRTYPE("SYNC")
+) oddr_ctl_inst (
+    .C(clock),
+    .CE(1'b1),
+    .D1(gmii_en),
+    .D2(gmii_en ^ gmii_er),
+    .R(!aresetn),
+    .S(1'b0),
+    .Q(rgmii_ctl)
+);
+
+ODDR #(
+    .DDR_CLK_EDGE("SAME_EDGE"),
+    .INIT(1'b0),
+    .SRTYPE("SYNC")
+) oddr_clock_inst (
+    .C(clock90),
+    .CE(1'b1),
+    .D1(1'b1),
+    .D2(1'b0),
+    .R(1'b0),
+    .S(1'b0),
+    .Q(rgmii_c)
+);
+
+endmodule
+
+`default_nettype wire
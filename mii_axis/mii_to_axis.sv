@@ -11,7 +11,9 @@ module mii_to_axis (
     output reg  [7:0]  maxis_tdata,
     output reg         maxis_tvalid,
     output reg         maxis_tuser,
-    output reg         maxis_tlast
+    output reg         maxis_tlast,
+
+    output reg         sfd     // Asserted for a cycle when the SFD is received.
 );
 
 localparam SFD = 8'hd5;
@@ -31,8 +33,10 @@ always_ff @(posedge clock) begin
         phase <= 0;
         in_frame <= 0;
         prev_in_frame <= 0;
+        sfd <= 0;
     end
     else begin
+        sfd <= sfd_detected;
         prev_is_sfd_lower <= mii_dv && mii_d == SFD[3:0];
         prev_in_frame <= in_frame;
         phase <= sfd_detected ? 0 : !phase;
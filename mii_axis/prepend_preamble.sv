@@ -11,11 +11,13 @@ module prepend_preamble #(
     input  wire  [7:0]  saxis_tdata,
     input  wire         saxis_tvalid,
     output reg          saxis_tready,
+    input  wire         saxis_tuser,
     input  wire         saxis_tlast,
 
     output reg   [7:0]  maxis_tdata,
     output reg          maxis_tvalid,
     input  wire         maxis_tready,
+    output reg          maxis_tuser,
     output reg          maxis_tlast
 );
 
@@ -48,6 +50,7 @@ always_ff @(posedge clock) begin
     if( !aresetn ) begin
         maxis_tdata <= 0;
         maxis_tvalid <= 0;
+        maxis_tuser <= 0;
         maxis_tlast <= 0;
     end
     else begin
@@ -61,6 +64,7 @@ always_ff @(posedge clock) begin
                 preamble_count <= PREAMBLE_LENGTH - 1;
                 maxis_tdata <= PREAMBLE;
                 maxis_tvalid <= 1;
+                maxis_tuser <= 0;
                 maxis_tlast <= 0;
                 state <= S_PREAMBLE;
             end
@@ -77,6 +81,7 @@ always_ff @(posedge clock) begin
         S_SFD: begin
             if( maxis_tready ) begin
                 maxis_tdata <= saxis_tdata;
+                maxis_tuser <= saxis_tuser;
                 maxis_tlast <= saxis_tlast;
                 state <= S_DATA;
             end
@@ -90,12 +95,14 @@ always_ff @(posedge clock) begin
                 else begin
                     maxis_tvalid <= saxis_tvalid;
                     maxis_tdata <= saxis_tdata;
+                    maxis_tuser <= saxis_tuser;
                     maxis_tlast <= saxis_tlast;
                 end
             end
             else if( saxis_tvalid && saxis_tready ) begin
                 maxis_tvalid <= saxis_tvalid;
                 maxis_tdata <= saxis_tdata;
+                maxis_tuser <= saxis_tuser;
                 maxis_tlast <= saxis_tlast;
             end
         end
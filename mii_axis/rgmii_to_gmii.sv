@@ -0,0 +1,59 @@
+`default_nettype none
+
+// Converts RGMII to GMII with the DDR input registers of 7 series.
+// RXD[3:0] and RXD[7:4] are taken on the rising and falling edges of clock (RXC),
+// and RX_CTL carries RX_DV and RX_DV xor RX_ER.
+// RXC must be delayed against the data by the PHY (RGMII-ID) or by the clock buffer.
+module rgmii_to_gmii (
+    input wire clock,
+    input wire aresetn,
+
+    input wire [3:0] rgmii_d,
+    input wire       rgmii_ctl,
+
+    output wire [7:0] gmii_d,
+    output wire       gmii_dv,
+    output wire       gmii_er
+);
+
+logic ctl_rising;
+logic ctl_falling;
+
+for(genvar i = 0; i < 4; i++) begin :data_block
+    IDDR #(
+        .DDR_CLK_EDGE("SAME_EDGE_PIPELINED"),
+        .INIT_Q1(1'b0),
+        .INIT_Q2(1'b0),
+        .SRTYPE("SYNC")
+    ) iddr_inst (
+        .C(clock),
+        .CE(1'b1),
+        .D(rgmii_d[i]),
+        .R(!aresetn),
+        .S(1'b0),
+        .Q1(gmii_d[i]),
+        .Q2(gmii_d[i+4])
+    );
+end
+
+IDDR #(
+    .DDR_CLK_EDGE("SAME_EDGE_PIPELINED"),
+    .INIT_Q1(1'b0),
+    .INIT_Q2(1'b0),
+    .SRTYPE("SYNC")
+) iddr_ctl_inst (
+    .C(clock),
+    .CE(1'b1),
+    .D(rgmii_ctl),
+    .R(!aresetn),
+    .S(1'b0),
+    .Q1(ctl_rising),
+    .Q2(ctl_falling)
+);
+
+assign gmii_dv = ctl_rising;
+assign gmii_er = ctl_rising ^ ctl_falling;
+
+endmodule
+
+`default_nettype wire
@@ -10,7 +10,9 @@ module rmii_to_axis (
     output logic  [7:0]  maxis_tdata,
     output logic         maxis_tvalid,
     output logic         maxis_tuser,
-    output logic         maxis_tlast
+    output logic         maxis_tlast,
+
+    output logic         sfd     // Asserted for a cycle when the SFD is received.
 );
 
 localparam SFD = 8'hd5;
@@ -54,8 +56,10 @@ always_ff @(posedge clock) begin
         phase <= 0;
         in_frame <= 0;
         prev_in_frame <= 0;
+        sfd <= 0;
     end
     else begin
+        sfd <= sfd_detected;
         prev_in_frame <= in_frame;
         phase <= (sfd_detected || phase == 2'd3) ? 0 : phase + 1;
         in_frame <=   sfd_detected ? 1
@@ -31,6 +31,8 @@ module tb;
         .maxis_tready(preamble_axis_tready),
         .maxis_tdata (preamble_axis_tdata ),
         .maxis_tlast (preamble_axis_tlast ),
+        .saxis_tuser (1'b0),
+        .maxis_tuser (),
         .*
     );
     axis_to_mii dut_axis_to_mii(
@@ -41,6 +43,7 @@ module tb;
         .saxis_tready(preamble_axis_tready),
         .saxis_tdata (preamble_axis_tdata ),
         .saxis_tlast (preamble_axis_tlast ),
+        .sfd(),
         .*
     );
 
@@ -48,6 +51,7 @@ module tb;
         .mii_d (mii_to_axis_mii_d),
         .mii_dv(mii_to_axis_mii_dv),
         .mii_er(mii_to_axis_mii_er),
+        .sfd(),
         .*
     );
 
@@ -29,6 +29,8 @@ module tb;
         .maxis_tready(preamble_axis_tready),
         .maxis_tdata (preamble_axis_tdata ),
         .maxis_tlast (preamble_axis_tlast ),
+        .saxis_tuser (1'b0),
+        .maxis_tuser (),
         .*
     );
     axis_to_rmii dut_axis_to_rmii(
@@ -38,12 +40,14 @@ module tb;
         .saxis_tready(preamble_axis_tready),
         .saxis_tdata (preamble_axis_tdata ),
         .saxis_tlast (preamble_axis_tlast ),
+        .sfd(),
         .*
     );
 
     rmii_to_axis dut_rmii_to_axis(
         .rmii_d (rmii_to_axis_rmii_d),
         .rmii_dv(rmii_to_axis_rmii_dv),
+        .sfd(),
         .*
     );
 
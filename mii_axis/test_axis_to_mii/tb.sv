@@ -14,6 +14,7 @@ module tb();
     logic        saxis_tlast;
 
     axis_to_mii dut(
+        .sfd(),
         .*
     );
     initial begin
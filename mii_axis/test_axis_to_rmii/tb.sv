@@ -14,6 +14,7 @@ module tb();
     logic        saxis_tlast;
 
     axis_to_rmii dut(
+        .sfd(),
         .*
     );
     initial begin
@@ -14,6 +14,7 @@ module tb();
     reg        maxis_tlast;
 
     mii_to_axis dut(
+        .sfd(),
         .*
     );
     initial begin
@@ -1,83 +1,146 @@
 `default_nettype none
 
-module append_crc (
+// Appends the FCS to the frames.
+// The last beat of a frame and the FCS are merged into a tail buffer and output with tkeep,
+// so the FCS starts right after the last valid byte for any DATA_BYTES.
+// Frames shorter than MIN_FRAME_BYTES are padded with zeros before the FCS.
+// Frames with a VLAN tag (TPID 0x8100 or 0x88a8 after the source address) are padded to MIN_TAGGED_FRAME_BYTES,
+// so that they are still long enough after a bridge removes the tag.
+// The padding is added to the tail buffer and fed to the CRC engine at DATA_BYTES per cycle.
+// With ABORT_ON_TUSER, the FCS of a frame with tuser on the last beat is inverted, so that the receivers drop it.
+module append_crc #(
+    parameter int DATA_BYTES = 1,           // 1, 2, 4 or 8
+    parameter int CRC_PIPELINE_STAGES = 0,  // PIPELINE_STAGES of crc32_parallel
+    parameter int MIN_FRAME_BYTES = 60,     // Minimum frame length without the FCS. 0 disables padding.
+    parameter int MIN_TAGGED_FRAME_BYTES = 64,  // Minimum length of the tagged frames without the FCS.
+    parameter bit ABORT_ON_TUSER = 0
+) (
     input wire clock,
     input wire aresetn,
-    
-    input  wire [7:0]  saxis_tdata,
-    input  wire        saxis_tvalid,
-    output wire        saxis_tready,
-    input  wire        saxis_tlast,
-    input  wire        saxis_tuser,
-
-    output wire [7:0]  maxis_tdata,
-    output wire        maxis_tvalid,
-    input  wire        maxis_tready,
-    output wire        maxis_tlast,
-    output wire        maxis_tuser
+
+    input  wire [DATA_BYTES*8-1:0] saxis_tdata,
+    input  wire                    saxis_tvalid,
+    output wire                    saxis_tready,
+    input  wire [DATA_BYTES-1:0]   saxis_tkeep,
+    input  wire                    saxis_tlast,
+    input  wire                    saxis_tuser,
+
+    output wire [DATA_BYTES*8-1:0] maxis_tdata,
+    output wire                    maxis_tvalid,
+    input  wire                    maxis_tready,
+    output wire [DATA_BYTES-1:0]   maxis_tkeep,
+    output wire                    maxis_tlast,
+    output wire                    maxis_tuser
 );
 
-logic [31:0] crc_out;
+localparam int TAIL_BYTES = DATA_BYTES + 4;
+localparam int COUNT_BITS = $clog2(2*DATA_BYTES + 4 + 1);  // The padding is counted before a beat is shifted out.
+localparam int TAGGED_MIN_FRAME_BYTES = MIN_FRAME_BYTES == 0 ? 0 : MIN_TAGGED_FRAME_BYTES;
+localparam int MAX_MIN_FRAME_BYTES = TAGGED_MIN_FRAME_BYTES > MIN_FRAME_BYTES ? TAGGED_MIN_FRAME_BYTES : MIN_FRAME_BYTES;
+localparam int FRAME_COUNT_BITS = $clog2(MAX_MIN_FRAME_BYTES + DATA_BYTES + 1);
+
+logic [31:0] crc;
+logic        crc_valid;
 
-crc_mac crc_mac_inst(
+logic [DATA_BYTES*8-1:0] crc_data;
+logic [DATA_BYTES-1:0]   crc_keep;
+logic                    crc_input_valid;
+logic                    crc_last;
+
+crc32_parallel #(.DATA_WIDTH(DATA_BYTES*8), .PIPELINE_STAGES(CRC_PIPELINE_STAGES)) crc32_parallel_inst (
     .clock(clock),
     .aresetn(aresetn),
+    .data(crc_data),
+    .keep(crc_keep),
+    .valid(crc_input_valid),
+    .last(crc_last),
+    .crc(crc),
+    .crc_valid(crc_valid),
+    .residue_ok()
+);
 
-    .saxis_tdata (saxis_tdata),
-    .saxis_tvalid(saxis_tvalid),
-    .saxis_tready(saxis_tready),
-    .saxis_tlast (saxis_tlast),
-    .saxis_tuser (saxis_tuser),
+function automatic logic [COUNT_BITS-1:0] keep_count(input logic [DATA_BYTES-1:0] value);
+    keep_count = 0;
+    for(int i = 0; i < DATA_BYTES; i++ ) begin
+        if( value[i] ) keep_count = i + 1;
+    end
+endfunction
 
-    .maxis_tdata (input_tdata),
-    .maxis_tvalid(input_tvalid),
-    .maxis_tready(input_tready),
-    .maxis_tlast (input_tlast),
-    .maxis_tuser (input_tuser),
+function automatic logic [31:0] fcs(input logic [31:0] value, input logic user);
+    return ABORT_ON_TUSER && user ? ~value : value;
+endfunction
 
-    .crc_out(crc_out)
-);
+logic [DATA_BYTES*8-1:0] output_tdata;
+logic                    output_tvalid;
+logic [DATA_BYTES-1:0]   output_tkeep;
+logic                    output_tlast;
+logic                    output_tuser;
 
-logic [7:0] input_tdata;
-logic input_tvalid;
-logic input_tready;
-logic input_tlast;
-logic input_tuser;
+logic [TAIL_BYTES*8-1:0] tail_data;
+logic [COUNT_BITS-1:0]   tail_count;
+logic                    tail_user;
 
-logic [7:0] output_tdata;
-logic       output_tvalid;
-logic       output_tready;
-logic       output_tlast;
-logic       output_tuser;
+logic [FRAME_COUNT_BITS-1:0] frame_bytes;     // Saturates at the minimum length of the frame
+logic [FRAME_COUNT_BITS-1:0] pad_remaining;
+logic [15:0]                 tpid;            // Octets 12 and 13 of the frame
 
 typedef enum {
     S_RESET,
-    S_IDLE,
     S_DATA,
-    S_CRC_0,
-    S_CRC_1,
-    S_CRC_2,
-    S_CRC_3
+    S_PAD,
+    S_WAIT_CRC,
+    S_TAIL
 } state_t;
 
 state_t state = S_RESET;
 
 assign maxis_tdata  = output_tdata;
 assign maxis_tvalid = output_tvalid;
-assign output_tready = maxis_tready;
-assign maxis_tlast  = output_tlast && state == S_CRC_3;
+assign maxis_tkeep  = output_tkeep;
+assign maxis_tlast  = output_tlast;
 assign maxis_tuser  = output_tuser;
 
+wire output_ready = !output_tvalid || maxis_tready;
+assign saxis_tready = state == S_DATA && output_ready;
+
+wire [COUNT_BITS-1:0] input_count = keep_count(saxis_tkeep);
+wire [TAIL_BYTES*8-1:0] input_tail = (TAIL_BYTES*8)'(saxis_tdata & ({DATA_BYTES*8 {1'b1}} >> 8*(DATA_BYTES - input_count)));
+wire [FRAME_COUNT_BITS-1:0] input_frame_bytes = frame_bytes + input_count;
+
+// The TPID is taken before frame_bytes saturates, as the minimum length is at least 14 when padding is enabled.
+logic [15:0] input_tpid;
 always_comb begin
-    case(state)
-    S_IDLE: begin
-        input_tready <= 1;
+    input_tpid = tpid;
+    for(int i = 0; i < DATA_BYTES; i++) begin
+        if( frame_bytes + i == 12 ) input_tpid[15:8] = saxis_tdata[8*i +: 8];
+        if( frame_bytes + i == 13 ) input_tpid[7:0] = saxis_tdata[8*i +: 8];
     end
-    S_DATA: begin
-        input_tready <= !output_tvalid || output_tvalid && output_tready && !output_tlast;
+end
+wire input_tagged = input_tpid == 16'h8100 || input_tpid == 16'h88a8;
+wire [FRAME_COUNT_BITS-1:0] min_frame_bytes = input_tagged ? FRAME_COUNT_BITS'(TAGGED_MIN_FRAME_BYTES) : FRAME_COUNT_BITS'(MIN_FRAME_BYTES);
+wire input_short = input_frame_bytes < min_frame_bytes;
+
+// Padding. The tail buffer is zero above tail_count, so the padding only increases the count.
+wire [COUNT_BITS-1:0] pad_chunk = pad_remaining >= DATA_BYTES ? COUNT_BITS'(DATA_BYTES) : COUNT_BITS'(pad_remaining);
+wire [COUNT_BITS-1:0] pad_sum = tail_count + pad_chunk;
+wire pad_emit = pad_sum >= DATA_BYTES;
+wire pad_final = pad_chunk == pad_remaining;
+wire [TAIL_BYTES*8-1:0] pad_tail_data = pad_emit ? tail_data >> 8*DATA_BYTES : tail_data;
+wire [COUNT_BITS-1:0] pad_tail_count = pad_emit ? pad_sum - DATA_BYTES : pad_sum;
+
+always_comb begin
+    if( state == S_PAD ) begin
+        crc_data = 0;
+        crc_keep = {DATA_BYTES {1'b1}} >> (DATA_BYTES - pad_chunk);
+        crc_input_valid = output_ready;
+        crc_last = pad_final;
+    end
+    else begin
+        crc_data = saxis_tdata;
+        crc_keep = saxis_tkeep;
+        crc_input_valid = saxis_tvalid && saxis_tready;
+        crc_last = saxis_tlast && !input_short;
     end
-    default: input_tready <= 0;
-    endcase
 end
 
 always_ff @(posedge clock) begin
@@ -85,71 +148,101 @@ always_ff @(posedge clock) begin
         state <= S_RESET;
         output_tvalid <= 0;
         output_tdata <= 0;
+        output_tkeep <= 0;
         output_tuser <= 0;
         output_tlast <= 0;
+        tail_data <= 0;
+        tail_count <= 0;
+        tail_user <= 0;
+        frame_bytes <= 0;
+        pad_remaining <= 0;
+        tpid <= 0;
     end
     else begin
-        case( state )
-        S_RESET: begin
-            state <= S_IDLE;
+        if( output_tvalid && maxis_tready ) begin
             output_tvalid <= 0;
-            output_tdata <= 0;
-            output_tuser <= 0;
-            output_tlast <= 0;
         end
-        S_IDLE: begin
-            if( input_tvalid ) begin
-                output_tvalid <= 1;
-                output_tdata <= input_tdata;
-                output_tlast <= input_tlast;
-                output_tuser <= input_tuser;
-                state <= S_DATA;
-            end
+
+        case( state )
+        S_RESET: begin
+            state <= S_DATA;
         end
         S_DATA: begin
-            if( output_tvalid && output_tready ) begin
-                if( output_tlast ) begin
-                    output_tdata <= crc_out[7:0];
-                    state <= S_CRC_0;
+            if( saxis_tvalid && saxis_tready ) begin
+                frame_bytes <= saxis_tlast ? 0 : input_short ? input_frame_bytes : min_frame_bytes;
+                tpid <= saxis_tlast ? 16'h0000 : input_tpid;
+                if( saxis_tlast ) begin
+                    tail_user <= saxis_tuser;
+                    if( input_short ) begin
+                        tail_data <= input_tail;
+                        tail_count <= input_count;
+                        pad_remaining <= min_frame_bytes - input_frame_bytes;
+                        state <= S_PAD;
+                    end
+                    else if( crc_valid ) begin
+                        tail_data <= input_tail | (TAIL_BYTES*8)'(fcs(crc, saxis_tuser)) << 8*input_count;
+                        tail_count <= input_count + 4;
+                        state <= S_TAIL;
+                    end
+                    else begin
+                        tail_data <= input_tail;
+                        tail_count <= input_count;
+                        state <= S_WAIT_CRC;
+                    end
                 end
                 else begin
-                    output_tvalid <= input_tvalid;
-                    output_tdata <= input_tdata;
-                    output_tuser <= input_tuser;
-                    output_tlast <= input_tlast;
+                    output_tvalid <= 1;
+                    output_tdata <= saxis_tdata;
+                    output_tkeep <= '1;
+                    output_tuser <= saxis_tuser;
+                    output_tlast <= 0;
                 end
             end
-            else if( input_tvalid && input_tready ) begin
-                output_tvalid <= input_tvalid;
-                output_tdata <= input_tdata;
-                output_tuser <= input_tuser;
-                output_tlast <= input_tlast;
-            end
-        end
-        S_CRC_0: begin
-            if( output_tready ) begin
-                output_tdata <= crc_out[15:8];
-                state <= S_CRC_1;
-            end
         end
-        S_CRC_1: begin
-            if( output_tready ) begin
-                output_tdata <= crc_out[23:16];
-                state <= S_CRC_2;
+        S_PAD: begin
+            if( output_ready ) begin
+                if( pad_emit ) begin
+                    output_tvalid <= 1;
+                    output_tdata <= tail_data[DATA_BYTES*8-1:0];
+                    output_tkeep <= '1;
+                    output_tuser <= tail_user;
+                    output_tlast <= 0;
+                end
+                pad_remaining <= pad_remaining - pad_chunk;
+                if( pad_final && crc_valid ) begin
+                    tail_data <= pad_tail_data | (TAIL_BYTES*8)'(fcs(crc, tail_user)) << 8*pad_tail_count;
+                    tail_count <= pad_tail_count + 4;
+                    state <= S_TAIL;
+                end
+                else begin
+                    tail_data <= pad_tail_data;
+                    tail_count <= pad_tail_count;
+                    if( pad_final ) state <= S_WAIT_CRC;
+                end
             end
         end
-        S_CRC_2: begin
-            if( output_tready ) begin
-                output_tdata <= crc_out[31:24];
-                state <= S_CRC_3;
+        S_WAIT_CRC: begin
+            if( crc_valid ) begin
+                tail_data <= tail_data | (TAIL_BYTES*8)'(fcs(crc, tail_user)) << 8*tail_count;
+                tail_count <= tail_count + 4;
+                state <= S_TAIL;
             end
         end
-        S_CRC_3: begin
-            if( output_tready ) begin
-                output_tdata <= 0;
-                output_tvalid <= 0;
-                output_tlast <= 0;
-                state <= S_IDLE;
+        S_TAIL: begin
+            if( output_ready ) begin
+                output_tvalid <= 1;
+                output_tdata <= tail_data[DATA_BYTES*8-1:0];
+                output_tkeep <= tail_count >= DATA_BYTES ? {DATA_BYTES {1'b1}} : {DATA_BYTES {1'b1}} >> (DATA_BYTES - tail_count);
+                output_tuser <= tail_user;
+                output_tlast <= tail_count <= DATA_BYTES;
+                tail_data <= tail_data >> 8*DATA_BYTES;
+                if( tail_count <= DATA_BYTES ) begin
+                    tail_count <= 0;
+                    state <= S_DATA;
+                end
+                else begin
+                    tail_count <= tail_count - DATA_BYTES;
+                end
             end
         end
         endcase
@@ -0,0 +1,44 @@
+`default_nettype none
+
+// Holds the stream at the frame boundary while hold is asserted.
+// A frame already started passes to its end.
+module axis_frame_gate (
+    input wire clock,
+    input wire aresetn,
+
+    input wire hold,
+
+    input  wire [7:0] saxis_tdata,
+    input  wire       saxis_tvalid,
+    output wire       saxis_tready,
+    input  wire       saxis_tuser,
+    input  wire       saxis_tlast,
+
+    output wire [7:0] maxis_tdata,
+    output wire       maxis_tvalid,
+    input  wire       maxis_tready,
+    output wire       maxis_tuser,
+    output wire       maxis_tlast
+);
+
+logic in_frame;
+wire  pass = in_frame || !hold;
+
+assign maxis_tdata  = saxis_tdata;
+assign maxis_tvalid = saxis_tvalid && pass;
+assign saxis_tready = maxis_tready && pass;
+assign maxis_tuser  = saxis_tuser;
+assign maxis_tlast  = saxis_tlast;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        in_frame <= 0;
+    end
+    else if( maxis_tvalid && maxis_tready ) begin
+        in_frame <= !saxis_tlast;
+    end
+end
+
+endmodule
+
+`default_nettype wire
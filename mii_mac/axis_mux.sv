@@ -1,6 +1,25 @@
 `default_nettype none
 
-module axis_mux (
+// Two input frame multiplexer.
+// The next frame is granted combinationally while no frame is in progress,
+// so a frame can start in the cycle after the last beat of the previous one.
+//
+// POLICY:
+//   0: Strict priority. Stream 0 is always preferred.
+//   1: Round-robin. The stream not granted last is preferred.
+//   2: Deficit-weighted round-robin. Each stream earns QUANTUM_n bytes per round and spends the bytes it sends.
+//      A stream with credit left is preferred, and both are replenished when no waiting stream has credit.
+//
+// Counters:
+//   grant_count_n:      frames granted to stream n
+//   wait_cycles_n:      cycles stream n has a frame waiting while the other stream is selected
+//   starvation_count_n: times stream n waited for STARVATION_CYCLES cycles without a grant
+module axis_mux #(
+    parameter int POLICY = 0,
+    parameter int QUANTUM_0 = 1514,
+    parameter int QUANTUM_1 = 1514,
+    parameter int STARVATION_CYCLES = 65536
+) (
     input wire clock,
     input wire aresetn,
 
@@ -20,77 +39,168 @@ module axis_mux (
     input  wire       saxis_1_tvalid,
     output reg        saxis_1_tready,
     input  wire       saxis_1_tuser,
-    input  wire       saxis_1_tlast
+    input  wire       saxis_1_tlast,
+
+    output logic [31:0] grant_count_0,
+    output logic [31:0] grant_count_1,
+    output logic [31:0] wait_cycles_0,
+    output logic [31:0] wait_cycles_1,
+    output logic [31:0] starvation_count_0,
+    output logic [31:0] starvation_count_1
 );
 
-typedef enum {
-    IDLE,       // No operation
-    OUTPUT0,    // Output stream 0
-    OUTPUT1     // Output stream 1
-} state_t;
+localparam int POLICY_STRICT = 0;
+localparam int POLICY_ROUND_ROBIN = 1;
+localparam int POLICY_DWRR = 2;
+localparam int STARVATION_BITS = $clog2(STARVATION_CYCLES + 1);
 
-state_t state = IDLE;
+logic in_frame;         // A frame is in progress on current
+logic current;          // Stream of the frame in progress
+logic last_granted;     // Stream granted last
+
+logic signed [23:0] deficit_0;
+logic signed [23:0] deficit_1;
+
+logic [STARVATION_BITS-1:0] waiting_0;
+logic [STARVATION_BITS-1:0] waiting_1;
+
+// Arbitration for the next frame
+wire eligible_0 = saxis_0_tvalid && deficit_0 > 0;
+wire eligible_1 = saxis_1_tvalid && deficit_1 > 0;
+logic selected;
+logic selected_valid;
+logic replenish;
 
-// TREADY
 always_comb begin
-    case(state)
-    IDLE: begin 
-        saxis_0_tready <= 0;
-        saxis_1_tready <= 0;
+    replenish = 0;
+    case( POLICY )
+    POLICY_ROUND_ROBIN: begin
+        selected = saxis_0_tvalid && saxis_1_tvalid ? !last_granted : saxis_1_tvalid;
     end
-    OUTPUT0: begin
-        saxis_0_tready <= !maxis_tvalid || maxis_tready;
-        saxis_1_tready <= 0;
+    POLICY_DWRR: begin
+        if( eligible_0 || eligible_1 ) begin
+            selected = eligible_0 && eligible_1 ? !last_granted : eligible_1;
+        end
+        else begin
+            replenish = saxis_0_tvalid || saxis_1_tvalid;
+            selected = saxis_0_tvalid && saxis_1_tvalid ? !last_granted : saxis_1_tvalid;
+        end
     end
-    OUTPUT1: begin
-        saxis_0_tready <= 0;
-        saxis_1_tready <= !maxis_tvalid || maxis_tready;
+    default: begin
+        selected = !saxis_0_tvalid;
     end
     endcase
+    selected_valid = saxis_0_tvalid || saxis_1_tvalid;
 end
 
+wire port = in_frame ? current : selected;
+wire output_ready = !maxis_tvalid || maxis_tready;
+
+// TREADY
+always_comb begin
+    saxis_0_tready <= output_ready && (in_frame || selected_valid) && port == 0;
+    saxis_1_tready <= output_ready && (in_frame || selected_valid) && port == 1;
+end
+
+wire accepted_0 = saxis_0_tvalid && saxis_0_tready;
+wire accepted_1 = saxis_1_tvalid && saxis_1_tready;
+wire frame_start = !in_frame && (accepted_0 || accepted_1);
+
+// Streams with a frame waiting while the other stream is selected.
+wire waiting_now_0 = saxis_0_tvalid && port == 1;
+wire waiting_now_1 = saxis_1_tvalid && port == 0;
+
 always_ff @(posedge clock) begin
     if( !aresetn ) begin
-        state <= IDLE;
         maxis_tvalid <= 0;
+        maxis_tdata <= 0;
+        maxis_tuser <= 0;
+        maxis_tlast <= 0;
+        in_frame <= 0;
+        current <= 0;
+        last_granted <= 1;
     end
     else begin
         if( maxis_tvalid && maxis_tready ) begin
             maxis_tvalid <= 0;
         end
 
-        case(state)
-        IDLE: begin
-            if( saxis_0_tvalid ) begin
-                state <= OUTPUT0;
-            end
-            else if( saxis_1_tvalid ) begin
-                state <= OUTPUT1;
-            end
+        if( accepted_0 || accepted_1 ) begin
+            maxis_tvalid <= 1;
+            maxis_tdata <= accepted_0 ? saxis_0_tdata : saxis_1_tdata;
+            maxis_tuser <= accepted_0 ? saxis_0_tuser : saxis_1_tuser;
+            maxis_tlast <= accepted_0 ? saxis_0_tlast : saxis_1_tlast;
+            in_frame <= !(accepted_0 ? saxis_0_tlast : saxis_1_tlast);
+            current <= accepted_1;
+        end
+        if( frame_start ) begin
+            last_granted <= accepted_1;
+        end
+    end
+end
+
+// Deficit counters of the DWRR policy. A stream without a waiting frame does not keep its credit.
+logic signed [23:0] deficit_next_0;
+logic signed [23:0] deficit_next_1;
+
+always_comb begin
+    deficit_next_0 = deficit_0;
+    deficit_next_1 = deficit_1;
+    if( frame_start ) begin
+        if( replenish ) begin
+            if( saxis_0_tvalid ) deficit_next_0 = deficit_next_0 + QUANTUM_0;
+            if( saxis_1_tvalid ) deficit_next_1 = deficit_next_1 + QUANTUM_1;
+        end
+        if( !saxis_0_tvalid && deficit_next_0 > 0 ) deficit_next_0 = 0;
+        if( !saxis_1_tvalid && deficit_next_1 > 0 ) deficit_next_1 = 0;
+    end
+    if( accepted_0 ) deficit_next_0 = deficit_next_0 - 1;
+    if( accepted_1 ) deficit_next_1 = deficit_next_1 - 1;
+end
+
+always_ff @(posedge clock) begin
+    if( !aresetn || POLICY != POLICY_DWRR ) begin
+        deficit_0 <= 0;
+        deficit_1 <= 0;
+    end
+    else begin
+        deficit_0 <= deficit_next_0;
+        deficit_1 <= deficit_next_1;
+    end
+end
+
+// Counters
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        grant_count_0 <= 0;
+        grant_count_1 <= 0;
+        wait_cycles_0 <= 0;
+        wait_cycles_1 <= 0;
+        starvation_count_0 <= 0;
+        starvation_count_1 <= 0;
+        waiting_0 <= 0;
+        waiting_1 <= 0;
+    end
+    else begin
+        if( frame_start && accepted_0 ) grant_count_0 <= grant_count_0 + 1;
+        if( frame_start && accepted_1 ) grant_count_1 <= grant_count_1 + 1;
+        if( waiting_now_0 ) wait_cycles_0 <= wait_cycles_0 + 1;
+        if( waiting_now_1 ) wait_cycles_1 <= wait_cycles_1 + 1;
+
+        if( frame_start && accepted_0 ) begin
+            waiting_0 <= 0;
+        end
+        else if( waiting_now_0 && waiting_0 != STARVATION_CYCLES ) begin
+            waiting_0 <= waiting_0 + 1;
+            if( waiting_0 == STARVATION_CYCLES - 1 ) starvation_count_0 <= starvation_count_0 + 1;
         end
-        OUTPUT0: begin
-            if(saxis_0_tvalid && saxis_0_tready) begin
-                maxis_tvalid <= 1;
-                maxis_tdata <= saxis_0_tdata;
-                maxis_tuser <= saxis_0_tuser;
-                maxis_tlast <= saxis_0_tlast;
-                if( saxis_0_tlast ) begin
-                    state <= IDLE;
-                end
-            end
+        if( frame_start && accepted_1 ) begin
+            waiting_1 <= 0;
         end
-        OUTPUT1: begin
-            if(saxis_1_tvalid && saxis_1_tready) begin
-                maxis_tvalid <= 1;
-                maxis_tdata <= saxis_1_tdata;
-                maxis_tuser <= saxis_1_tuser;
-                maxis_tlast <= saxis_1_tlast;
-                if( saxis_1_tlast ) begin
-                    state <= IDLE;
-                end
-            end
+        else if( waiting_now_1 && waiting_1 != STARVATION_CYCLES ) begin
+            waiting_1 <= waiting_1 + 1;
+            if( waiting_1 == STARVATION_CYCLES - 1 ) starvation_count_1 <= starvation_count_1 + 1;
         end
-        endcase
     end
 end
 
@@ -0,0 +1,183 @@
+`default_nettype none
+
+// Parallel CRC-32 of Ethernet frames. (IEEE 802.3, reflected, initial value and final XOR all ones)
+// The next remainder for an input of n bytes is the XOR of two matrix products, A_n * remainder and B_n * data.
+// The matrices are derived at elaboration from the bit-serial definition, so each output bit is a single XOR tree.
+// Bytes are processed from the LSB of data, which is the first byte on the wire.
+//
+// PIPELINE_STAGES:
+//   0: crc is output combinationally in the cycle of the last input.
+//   1: B_n * data is registered. The feedback loop is reduced to A_n * remainder and one XOR.
+//      crc is output one cycle after the last input.
+//   2: crc is also registered and output two cycles after the last input.
+module crc32_parallel #(
+    parameter int DATA_WIDTH = 8,       // 8, 16, 32 or 64
+    parameter int PIPELINE_STAGES = 0   // 0, 1 or 2
+) (
+    input wire clock,
+    input wire aresetn,
+
+    input wire [DATA_WIDTH-1:0]   data,
+    input wire [DATA_WIDTH/8-1:0] keep,     // Valid bytes from the LSB. Any input may have null bytes at the MSB side.
+    input wire                    valid,
+    input wire                    last,
+
+    output logic [31:0] crc,        // FCS of the frame, the first byte on the wire at the LSB. Holds until the next frame.
+    output logic        crc_valid,  // Asserted for a cycle when crc of a frame is output.
+    output logic        residue_ok  // The frame ends with a correct FCS. Updated with crc.
+);
+
+localparam int DATA_BYTES = DATA_WIDTH / 8;
+localparam bit [31:0] POLYNOMIAL = 32'b1110_1101_1011_1000_1000_0011_0010_0000;
+localparam bit [31:0] RESIDUE = 32'hdebb20e3;
+
+typedef logic [31:0][31:0]           state_matrix_t;    // [output bit][remainder bit]
+typedef logic [31:0][DATA_WIDTH-1:0] data_matrix_t;     // [output bit][data bit]
+
+function automatic logic [31:0] crc_serial(input logic [31:0] remainder, input logic [DATA_WIDTH-1:0] value, input int bytes);
+    logic [31:0] result;
+    result = remainder;
+    for(int i = 0; i < bytes; i++ ) begin
+        result[7:0] = result[7:0] ^ value[8*i +: 8];
+        for(int bit_index = 0; bit_index < 8; bit_index++ ) begin
+            result = {1'b0, result[31:1]} ^ (result[0] ? POLYNOMIAL : 32'b0);
+        end
+    end
+    return result;
+endfunction
+
+function automatic state_matrix_t state_matrix(input int bytes);
+    state_matrix_t matrix;
+    for(int column = 0; column < 32; column++ ) begin
+        logic [31:0] response;
+        response = crc_serial(32'b1 << column, '0, bytes);
+        for(int row = 0; row < 32; row++ ) begin
+            matrix[row][column] = response[row];
+        end
+    end
+    return matrix;
+endfunction
+
+function automatic data_matrix_t data_matrix(input int bytes);
+    data_matrix_t matrix;
+    for(int column = 0; column < DATA_WIDTH; column++ ) begin
+        logic [31:0] response;
+        logic [DATA_WIDTH-1:0] value;
+        value = '0;
+        value[column] = 1'b1;
+        response = crc_serial(32'b0, value, bytes);
+        for(int row = 0; row < 32; row++ ) begin
+            matrix[row][column] = response[row];
+        end
+    end
+    return matrix;
+endfunction
+
+// Number of valid bytes in keep.
+function automatic logic [$clog2(DATA_BYTES+1)-1:0] keep_count(input logic [DATA_BYTES-1:0] value);
+    keep_count = 0;
+    for(int i = 0; i < DATA_BYTES; i++ ) begin
+        if( value[i] ) keep_count = i + 1;
+    end
+endfunction
+
+// Data terms for each number of bytes. Index 0 (no valid bytes) is not used.
+logic [31:0] data_term [DATA_BYTES+1];
+assign data_term[0] = 0;
+for(genvar bytes = 1; bytes <= DATA_BYTES; bytes++ ) begin: data_term_block
+    localparam data_matrix_t B = data_matrix(bytes);
+    for(genvar row = 0; row < 32; row++ ) begin: row_block
+        assign data_term[bytes][row] = ^(B[row] & data);
+    end
+end
+
+// Stage 1: registers the data terms if pipelined.
+logic [31:0] stage_data_term [DATA_BYTES+1];
+logic [$clog2(DATA_BYTES+1)-1:0] stage_bytes;
+logic stage_valid;
+logic stage_last;
+
+if( PIPELINE_STAGES > 0 ) begin: data_term_register_block
+    always_ff @(posedge clock) begin
+        if( !aresetn ) begin
+            stage_valid <= 0;
+            stage_last <= 0;
+            stage_bytes <= 0;
+            for(int i = 0; i <= DATA_BYTES; i++ ) stage_data_term[i] <= 0;
+        end
+        else begin
+            stage_valid <= valid;
+            stage_last <= last;
+            stage_bytes <= keep_count(keep);
+            for(int i = 0; i <= DATA_BYTES; i++ ) stage_data_term[i] <= data_term[i];
+        end
+    end
+end
+else begin: data_term_through_block
+    assign stage_valid = valid;
+    assign stage_last = last;
+    assign stage_bytes = keep_count(keep);
+    for(genvar i = 0; i <= DATA_BYTES; i++ ) begin: data_term_assign_block
+        assign stage_data_term[i] = data_term[i];
+    end
+end
+
+// Stage 2: updates the remainder.
+logic [31:0] remainder;
+logic [31:0] state_term [DATA_BYTES+1];
+assign state_term[0] = remainder;
+for(genvar bytes = 1; bytes <= DATA_BYTES; bytes++ ) begin: state_term_block
+    localparam state_matrix_t A = state_matrix(bytes);
+    for(genvar row = 0; row < 32; row++ ) begin: row_block
+        assign state_term[bytes][row] = ^(A[row] & remainder);
+    end
+end
+
+logic [31:0] remainder_next;
+assign remainder_next = state_term[stage_bytes] ^ stage_data_term[stage_bytes];
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        remainder <= '1;
+    end
+    else if( stage_valid ) begin
+        remainder <= stage_last ? '1 : remainder_next;
+    end
+end
+
+logic [31:0] crc_reg;
+logic        residue_ok_reg;
+wire         frame_end = stage_valid && stage_last;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        crc_reg <= 0;
+        residue_ok_reg <= 0;
+    end
+    else if( frame_end ) begin
+        crc_reg <= ~remainder_next;
+        residue_ok_reg <= remainder_next == RESIDUE;
+    end
+end
+
+if( PIPELINE_STAGES > 1 ) begin: output_register_block
+    always_ff @(posedge clock) begin
+        if( !aresetn ) begin
+            crc_valid <= 0;
+        end
+        else begin
+            crc_valid <= frame_end;
+        end
+    end
+    assign crc = crc_reg;
+    assign residue_ok = residue_ok_reg;
+end
+else begin: output_through_block
+    assign crc_valid = frame_end;
+    assign crc = frame_end ? ~remainder_next : crc_reg;
+    assign residue_ok = frame_end ? remainder_next == RESIDUE : residue_ok_reg;
+end
+
+endmodule
+
+`default_nettype wire
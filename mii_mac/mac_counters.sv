@@ -0,0 +1,179 @@
+`default_nettype none
+
+// Statistics counters of the MAC on AXI4-Lite.
+// The counters wrap around. Writes are accepted and ignored.
+// The RX counters are in the rx_clock domain. They are copied to the clock domain by a request/acknowledge
+// handshake repeated continuously, so a read returns a value a few cycles old.
+//
+// Registers (32bit access only)
+//   0x00 TX_UNDERRUN            R   frames on tx_saxis aborted by underruns of the TX FIFO
+//   0x04 PS_TX_UNDERRUN         R   frames from ps_tx_mii aborted by underruns of the PS TX FIFO
+//   0x08 TX_GRANT               R   frames granted to tx_saxis by the arbiter (see axis_mux)
+//   0x0c TX_BYPASS_GRANT        R   frames granted to the bypass (PS) frames
+//   0x10 TX_WAIT                R   cycles tx_saxis waited for the grant
+//   0x14 TX_BYPASS_WAIT         R   cycles the bypass frames waited for the grant
+//   0x18 TX_STARVATION          R   waits of tx_saxis reaching 65536 cycles
+//   0x1c TX_BYPASS_STARVATION   R   waits of the bypass frames reaching 65536 cycles
+//   0x20 RX_OVERFLOW_DROP       R   received frames dropped by overflows of the RX FIFO (see mii_mac_rx)
+//   0x24 RX_OVERFLOW_ABORT      R   received frames aborted by overflows of the RX FIFO
+//   0x28 RX_FCS_ERROR           R   received frames with FCS errors
+module mac_counters #(
+    parameter int ADDR_BITS = 8
+) (
+    input wire clock,
+    input wire aresetn,
+
+    input wire [31:0] tx_underrun_count,
+    input wire [31:0] ps_tx_underrun_count,
+    input wire [31:0] tx_grant_count,
+    input wire [31:0] tx_bypass_grant_count,
+    input wire [31:0] tx_wait_cycles,
+    input wire [31:0] tx_bypass_wait_cycles,
+    input wire [31:0] tx_starvation_count,
+    input wire [31:0] tx_bypass_starvation_count,
+
+    input wire        rx_clock,
+    input wire        rx_aresetn,
+    input wire [31:0] rx_overflow_drop_count,
+    input wire [31:0] rx_overflow_abort_count,
+    input wire [31:0] rx_fcs_error_count,
+
+    input  wire  [ADDR_BITS-1:0] s_axi_awaddr,
+    input  wire                  s_axi_awvalid,
+    output logic                 s_axi_awready,
+    input  wire  [31:0]          s_axi_wdata,
+    input  wire  [3:0]           s_axi_wstrb,
+    input  wire                  s_axi_wvalid,
+    output logic                 s_axi_wready,
+    output logic [1:0]           s_axi_bresp,
+    output logic                 s_axi_bvalid,
+    input  wire                  s_axi_bready,
+    input  wire  [ADDR_BITS-1:0] s_axi_araddr,
+    input  wire                  s_axi_arvalid,
+    output logic                 s_axi_arready,
+    output logic [31:0]          s_axi_rdata,
+    output logic [1:0]           s_axi_rresp,
+    output logic                 s_axi_rvalid,
+    input  wire                  s_axi_rready
+);
+
+localparam int REG_TX_UNDERRUN = 0;
+localparam int REG_PS_TX_UNDERRUN = 1;
+localparam int REG_TX_GRANT = 2;
+localparam int REG_TX_BYPASS_GRANT = 3;
+localparam int REG_TX_WAIT = 4;
+localparam int REG_TX_BYPASS_WAIT = 5;
+localparam int REG_TX_STARVATION = 6;
+localparam int REG_TX_BYPASS_STARVATION = 7;
+localparam int REG_RX_OVERFLOW_DROP = 8;
+localparam int REG_RX_OVERFLOW_ABORT = 9;
+localparam int REG_RX_FCS_ERROR = 10;
+
+typedef struct packed {
+    logic [31:0] overflow_drop;
+    logic [31:0] overflow_abort;
+    logic [31:0] fcs_error;
+} rx_counts_t;
+
+// RX clock domain
+// The snapshot is taken when the request changes and is held until the next request.
+(* ASYNC_REG = "TRUE" *) logic [1:0] rx_request_sync;
+logic       rx_acknowledge;
+rx_counts_t rx_snapshot;
+
+logic       request;
+
+always_ff @(posedge rx_clock) begin
+    if( !rx_aresetn ) begin
+        rx_request_sync <= 0;
+        rx_acknowledge <= 0;
+        rx_snapshot <= 0;
+    end
+    else begin
+        rx_request_sync <= {rx_request_sync[0], request};
+        if( rx_request_sync[1] != rx_acknowledge ) begin
+            rx_snapshot <= '{overflow_drop: rx_overflow_drop_count, overflow_abort: rx_overflow_abort_count, fcs_error: rx_fcs_error_count};
+            rx_acknowledge <= rx_request_sync[1];
+        end
+    end
+end
+
+// Clock domain of the registers
+// rx_snapshot is stable once the acknowledge matches the request.
+(* ASYNC_REG = "TRUE" *) logic [1:0] acknowledge_sync;
+rx_counts_t rx_counts;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        acknowledge_sync <= 0;
+        request <= 0;
+        rx_counts <= 0;
+    end
+    else begin
+        acknowledge_sync <= {acknowledge_sync[0], rx_acknowledge};
+        if( acknowledge_sync[1] == request ) begin
+            rx_counts <= rx_snapshot;
+            request <= !request;
+        end
+    end
+end
+
+// AXI4-Lite write
+logic write_enable;
+assign write_enable = s_axi_awvalid && s_axi_wvalid && !s_axi_bvalid;
+assign s_axi_awready = write_enable;
+assign s_axi_wready = write_enable;
+assign s_axi_bresp = 2'b00;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        s_axi_bvalid <= 0;
+    end
+    else begin
+        if( s_axi_bvalid && s_axi_bready ) begin
+            s_axi_bvalid <= 0;
+        end
+        if( write_enable ) begin
+            s_axi_bvalid <= 1;
+        end
+    end
+end
+
+// AXI4-Lite read
+logic [ADDR_BITS-3:0] read_index;
+assign read_index = s_axi_araddr[ADDR_BITS-1:2];
+assign s_axi_arready = !s_axi_rvalid;
+assign s_axi_rresp = 2'b00;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        s_axi_rvalid <= 0;
+        s_axi_rdata <= 0;
+    end
+    else begin
+        if( s_axi_rvalid && s_axi_rready ) begin
+            s_axi_rvalid <= 0;
+        end
+        if( s_axi_arvalid && s_axi_arready ) begin
+            s_axi_rvalid <= 1;
+            case(read_index)
+            REG_TX_UNDERRUN: s_axi_rdata <= tx_underrun_count;
+            REG_PS_TX_UNDERRUN: s_axi_rdata <= ps_tx_underrun_count;
+            REG_TX_GRANT: s_axi_rdata <= tx_grant_count;
+            REG_TX_BYPASS_GRANT: s_axi_rdata <= tx_bypass_grant_count;
+            REG_TX_WAIT: s_axi_rdata <= tx_wait_cycles;
+            REG_TX_BYPASS_WAIT: s_axi_rdata <= tx_bypass_wait_cycles;
+            REG_TX_STARVATION: s_axi_rdata <= tx_starvation_count;
+            REG_TX_BYPASS_STARVATION: s_axi_rdata <= tx_bypass_starvation_count;
+            REG_RX_OVERFLOW_DROP: s_axi_rdata <= rx_counts.overflow_drop;
+            REG_RX_OVERFLOW_ABORT: s_axi_rdata <= rx_counts.overflow_abort;
+            REG_RX_FCS_ERROR: s_axi_rdata <= rx_counts.fcs_error;
+            default: s_axi_rdata <= 0;
+            endcase
+        end
+    end
+end
+
+endmodule
+
+`default_nettype wire
@@ -1,6 +1,20 @@
 `default_nettype none
 
-module mii_mac (
+module mii_mac #(
+    parameter int TX_FIFO_DEPTH_BITS = 11,      // Cut-through FIFO on tx_saxis. 0 removes the FIFO.
+    parameter int TX_START_THRESHOLD = 64,      // Bytes buffered before a frame is started
+    parameter int PS_TX_FIFO_DEPTH_BITS = 0,    // Takes the bypass frames from ps_tx_mii through a cut-through FIFO instead of tx_saxis_bypass. 0 uses tx_saxis_bypass.
+    parameter int PS_TX_SHAPER_CLASSES = 4,     // Classes of the token bucket shaper on the ps_tx_mii FIFO (see tx_bypass_shaper). 0 removes the shaper.
+    parameter int TX_MUX_POLICY = 1,            // Arbitration between tx_saxis and the bypass frames. 0: strict priority, 1: round-robin, 2: DWRR
+    parameter int TX_MUX_QUANTUM = 1514,        // DWRR bytes per round of tx_saxis
+    parameter int TX_MUX_QUANTUM_BYPASS = 1514, // DWRR bytes per round of the bypass frames
+    parameter int RX_FIFO_DEPTH_BITS = 11,      // RX FIFO, which drops the frames when rx_maxis is stalled longer than it holds
+    parameter int TAS_ENTRIES = 8,              // Entries of the gate control list (see tx_gate_control)
+    parameter bit USE_MACSEC = 0,               // MACsec on the frames of tx_mii and rx_maxis (see macsec_tx and macsec_rx)
+    parameter bit USE_BRIDGE = 0,               // Learning switch between the PHY, the PS GEM and the PL ports (see bridge_block)
+    parameter int BRIDGE_PL_PORTS = 1,          // PL ports of the bridge on tx_saxis and rx_maxis, told by tid and tdest (1 to 10)
+    parameter int BRIDGE_TABLE_BITS = 8         // MAC table of the bridge with 2**BRIDGE_TABLE_BITS entries
+) (
     input wire tx_clock,
     input wire tx_reset,
     
@@ -12,6 +26,7 @@ module mii_mac (
     input  wire       tx_saxis_tvalid,
     output wire       tx_saxis_tready,
     input  wire       tx_saxis_tlast,
+    input  wire [3:0] tx_saxis_tid,             // PL port of the bridge
 
     // Ethernet bypass input
     input  wire [7:0] tx_saxis_bypass_tdata,
@@ -19,6 +34,10 @@ module mii_mac (
     output wire       tx_saxis_bypass_tready,
     input  wire       tx_saxis_bypass_tlast,
 
+    // Transmitted MII from the PS GEM, used instead of tx_saxis_bypass when PS_TX_FIFO_DEPTH_BITS > 0 (tx_clock domain)
+    input  wire [3:0] ps_tx_mii_d,
+    input  wire       ps_tx_mii_en,
+
     input wire rx_clock,
     input wire rx_reset,
     
@@ -28,35 +47,988 @@ module mii_mac (
 
     output wire  [7:0] rx_maxis_tdata,
     output wire        rx_maxis_tvalid,
+    input  wire        rx_maxis_tready,
     output wire        rx_maxis_tuser,
-    output wire        rx_maxis_tlast
+    output wire        rx_maxis_tlast,
+    output wire  [3:0] rx_maxis_tdest,          // PL port of the bridge
+
+    // Received MII to the PS GEM with the IPv4 multicast frames filtered by multicast_hash (rx_clock domain)
+    // multicast_hash is in the multicast_hash_clock domain. (see mii_multicast_filter)
+    input  wire        multicast_hash_clock,
+    input  wire [63:0] multicast_hash,
+    output wire  [3:0] ps_rx_mii_d,
+    output wire        ps_rx_mii_dv,
+
+    // Time base (tx_clock domain)
+    input  wire [47:0] time_seconds,
+    input  wire [31:0] time_nanoseconds,
+    input  wire        time_locked,
+
+    // SFD timestamps of the frames on rx_maxis (tx_clock domain)
+    // With USE_BRIDGE, frames from the GEM and the PL ports are timestamped when they enter the bridge.
+    output wire [95:0] rx_timestamp_maxis_tdata,
+    output wire        rx_timestamp_maxis_tvalid,
+    input  wire        rx_timestamp_maxis_tready,
+    output wire  [3:0] rx_timestamp_maxis_tdest,
+
+    // PTP event records of received and transmitted frames (tx_clock domain)
+    input  wire          ptp_one_step,
+    output wire [127:0]  ptp_rx_event_maxis_tdata,
+    output wire          ptp_rx_event_maxis_tvalid,
+    input  wire          ptp_rx_event_maxis_tready,
+    output wire [127:0]  ptp_tx_event_maxis_tdata,
+    output wire          ptp_tx_event_maxis_tvalid,
+    input  wire          ptp_tx_event_maxis_tready,
+
+    // IEEE 802.3x flow control (tx_clock domain)
+    input  wire [47:0] pause_source_address,    // Source address of the PAUSE frames. The first byte on the wire at [47:40]
+    input  wire        pause_request,           // Asynchronous. Sends XOFF while asserted and XON when deasserted.
+    output wire        tx_paused,               // Transmission is paused by the link partner.
+
+    // Gate control list of the time-aware shaper (tx_clock domain, see tx_gate_control)
+    input  wire  [7:0] tas_s_axi_awaddr,
+    input  wire        tas_s_axi_awvalid,
+    output wire        tas_s_axi_awready,
+    input  wire [31:0] tas_s_axi_wdata,
+    input  wire  [3:0] tas_s_axi_wstrb,
+    input  wire        tas_s_axi_wvalid,
+    output wire        tas_s_axi_wready,
+    output wire  [1:0] tas_s_axi_bresp,
+    output wire        tas_s_axi_bvalid,
+    input  wire        tas_s_axi_bready,
+    input  wire  [7:0] tas_s_axi_araddr,
+    input  wire        tas_s_axi_arvalid,
+    output wire        tas_s_axi_arready,
+    output wire [31:0] tas_s_axi_rdata,
+    output wire  [1:0] tas_s_axi_rresp,
+    output wire        tas_s_axi_rvalid,
+    input  wire        tas_s_axi_rready,
+
+    // Token bucket shaper of the frames from ps_tx_mii (tx_clock domain, see tx_bypass_shaper)
+    input  wire  [7:0] shaper_s_axi_awaddr,
+    input  wire        shaper_s_axi_awvalid,
+    output wire        shaper_s_axi_awready,
+    input  wire [31:0] shaper_s_axi_wdata,
+    input  wire  [3:0] shaper_s_axi_wstrb,
+    input  wire        shaper_s_axi_wvalid,
+    output wire        shaper_s_axi_wready,
+    output wire  [1:0] shaper_s_axi_bresp,
+    output wire        shaper_s_axi_bvalid,
+    input  wire        shaper_s_axi_bready,
+    input  wire  [7:0] shaper_s_axi_araddr,
+    input  wire        shaper_s_axi_arvalid,
+    output wire        shaper_s_axi_arready,
+    output wire [31:0] shaper_s_axi_rdata,
+    output wire  [1:0] shaper_s_axi_rresp,
+    output wire        shaper_s_axi_rvalid,
+    input  wire        shaper_s_axi_rready,
+
+    // MACsec protection of the transmitted frames (tx_clock domain, see macsec_tx)
+    input  wire  [7:0] macsec_tx_s_axi_awaddr,
+    input  wire        macsec_tx_s_axi_awvalid,
+    output wire        macsec_tx_s_axi_awready,
+    input  wire [31:0] macsec_tx_s_axi_wdata,
+    input  wire  [3:0] macsec_tx_s_axi_wstrb,
+    input  wire        macsec_tx_s_axi_wvalid,
+    output wire        macsec_tx_s_axi_wready,
+    output wire  [1:0] macsec_tx_s_axi_bresp,
+    output wire        macsec_tx_s_axi_bvalid,
+    input  wire        macsec_tx_s_axi_bready,
+    input  wire  [7:0] macsec_tx_s_axi_araddr,
+    input  wire        macsec_tx_s_axi_arvalid,
+    output wire        macsec_tx_s_axi_arready,
+    output wire [31:0] macsec_tx_s_axi_rdata,
+    output wire  [1:0] macsec_tx_s_axi_rresp,
+    output wire        macsec_tx_s_axi_rvalid,
+    input  wire        macsec_tx_s_axi_rready,
+
+    // MACsec validation of the received frames (rx_clock domain, see macsec_rx)
+    input  wire  [7:0] macsec_rx_s_axi_awaddr,
+    input  wire        macsec_rx_s_axi_awvalid,
+    output wire        macsec_rx_s_axi_awready,
+    input  wire [31:0] macsec_rx_s_axi_wdata,
+    input  wire  [3:0] macsec_rx_s_axi_wstrb,
+    input  wire        macsec_rx_s_axi_wvalid,
+    output wire        macsec_rx_s_axi_wready,
+    output wire  [1:0] macsec_rx_s_axi_bresp,
+    output wire        macsec_rx_s_axi_bvalid,
+    input  wire        macsec_rx_s_axi_bready,
+    input  wire  [7:0] macsec_rx_s_axi_araddr,
+    input  wire        macsec_rx_s_axi_arvalid,
+    output wire        macsec_rx_s_axi_arready,
+    output wire [31:0] macsec_rx_s_axi_rdata,
+    output wire  [1:0] macsec_rx_s_axi_rresp,
+    output wire        macsec_rx_s_axi_rvalid,
+    input  wire        macsec_rx_s_axi_rready,
+
+    // Registers of the bridge (tx_clock domain, see l2_switch)
+    input  wire  [7:0] bridge_s_axi_awaddr,
+    input  wire        bridge_s_axi_awvalid,
+    output wire        bridge_s_axi_awready,
+    input  wire [31:0] bridge_s_axi_wdata,
+    input  wire  [3:0] bridge_s_axi_wstrb,
+    input  wire        bridge_s_axi_wvalid,
+    output wire        bridge_s_axi_wready,
+    output wire  [1:0] bridge_s_axi_bresp,
+    output wire        bridge_s_axi_bvalid,
+    input  wire        bridge_s_axi_bready,
+    input  wire  [7:0] bridge_s_axi_araddr,
+    input  wire        bridge_s_axi_arvalid,
+    output wire        bridge_s_axi_arready,
+    output wire [31:0] bridge_s_axi_rdata,
+    output wire  [1:0] bridge_s_axi_rresp,
+    output wire        bridge_s_axi_rvalid,
+    input  wire        bridge_s_axi_rready,
+
+    // Statistics counters (tx_clock domain, see mac_counters)
+    input  wire  [7:0] counters_s_axi_awaddr,
+    input  wire        counters_s_axi_awvalid,
+    output wire        counters_s_axi_awready,
+    input  wire [31:0] counters_s_axi_wdata,
+    input  wire  [3:0] counters_s_axi_wstrb,
+    input  wire        counters_s_axi_wvalid,
+    output wire        counters_s_axi_wready,
+    output wire  [1:0] counters_s_axi_bresp,
+    output wire        counters_s_axi_bvalid,
+    input  wire        counters_s_axi_bready,
+    input  wire  [7:0] counters_s_axi_araddr,
+    input  wire        counters_s_axi_arvalid,
+    output wire        counters_s_axi_arready,
+    output wire [31:0] counters_s_axi_rdata,
+    output wire  [1:0] counters_s_axi_rresp,
+    output wire        counters_s_axi_rvalid,
+    input  wire        counters_s_axi_rready,
+
+    // Frames on tx_saxis and ps_tx_mii aborted by underruns of the TX FIFOs (tx_clock domain, also on counters_s_axi)
+    output wire [31:0] tx_underrun_count,
+    output wire [31:0] ps_tx_underrun_count,
+
+    // Arbitration counters of tx_saxis and the bypass frames (tx_clock domain, see axis_mux, also on counters_s_axi)
+    output wire [31:0] tx_grant_count,
+    output wire [31:0] tx_bypass_grant_count,
+    output wire [31:0] tx_wait_cycles,
+    output wire [31:0] tx_bypass_wait_cycles,
+    output wire [31:0] tx_starvation_count,
+    output wire [31:0] tx_bypass_starvation_count,
+
+    // Received frames dropped or aborted by the reasons (rx_clock domain, see mii_mac_rx, also on counters_s_axi)
+    output wire [31:0] rx_overflow_drop_count,
+    output wire [31:0] rx_overflow_abort_count,
+    output wire [31:0] rx_fcs_error_count
 );
 
-mii_mac_tx mii_mac_tx_inst (
+// Frames to the payload input, from tx_saxis or through the bridge
+logic [7:0] tx_payload_tdata;
+logic       tx_payload_tvalid;
+logic       tx_payload_tready;
+logic       tx_payload_tlast;
+
+logic [7:0] tx_fifo_out_tdata;
+logic       tx_fifo_out_tvalid;
+logic       tx_fifo_out_tready;
+logic       tx_fifo_out_tuser;
+logic       tx_fifo_out_tlast;
+
+if( TX_FIFO_DEPTH_BITS > 0 ) begin :tx_fifo_block
+    tx_cut_through_fifo #(
+        .DEPTH_BITS(TX_FIFO_DEPTH_BITS),
+        .START_THRESHOLD(TX_START_THRESHOLD)
+    ) tx_cut_through_fifo_inst (
+        .clock(tx_clock),
+        .aresetn(!tx_reset),
+        .saxis_tdata(tx_payload_tdata),
+        .saxis_tvalid(tx_payload_tvalid),
+        .saxis_tready(tx_payload_tready),
+        .saxis_tlast(tx_payload_tlast),
+        .maxis_tdata(tx_fifo_out_tdata),
+        .maxis_tvalid(tx_fifo_out_tvalid),
+        .maxis_tready(tx_fifo_out_tready),
+        .maxis_tuser(tx_fifo_out_tuser),
+        .maxis_tlast(tx_fifo_out_tlast),
+        .level(),
+        .underrun_count(tx_underrun_count));
+end
+else begin :no_tx_fifo_block
+    assign tx_fifo_out_tdata = tx_payload_tdata;
+    assign tx_fifo_out_tvalid = tx_payload_tvalid;
+    assign tx_payload_tready = tx_fifo_out_tready;
+    assign tx_fifo_out_tuser = 0;
+    assign tx_fifo_out_tlast = tx_payload_tlast;
+    assign tx_underrun_count = 0;
+end
+
+// The frames from the GEM are forwarded as soon as the bypass input is granted,
+// and buffered only while the other frames are transmitted.
+// The GEM sends at the line rate, so the FIFO does not underrun once a frame is started.
+localparam bit PS_TX_SHAPER = PS_TX_FIFO_DEPTH_BITS > 0 && PS_TX_SHAPER_CLASSES > 0;
+
+// Frames from ps_tx_mii with the FCS
+logic [7:0] ps_tx_mii_tdata;
+logic       ps_tx_mii_tvalid;
+logic       ps_tx_mii_tlast;
+
+mii_to_axis mii_to_axis_inst (
+    .clock(tx_clock),
+    .aresetn(!tx_reset),
+    .mii_d(ps_tx_mii_d),
+    .mii_dv(ps_tx_mii_en),
+    .mii_er(1'b0),
+    .maxis_tdata(ps_tx_mii_tdata),
+    .maxis_tvalid(ps_tx_mii_tvalid),
+    .maxis_tuser(),
+    .maxis_tlast(ps_tx_mii_tlast),
+    .sfd());
+
+// Frames of the GEM to the PHY with the FCS, from ps_tx_mii or through the bridge.
+// ps_tx_mii cannot be stalled and ignores ps_tx_tready. The bridge waits for it.
+logic [7:0] ps_tx_tdata;
+logic       ps_tx_tvalid;
+logic       ps_tx_tready;
+logic       ps_tx_tlast;
+
+logic [7:0] bypass_tdata;
+logic       bypass_tvalid;
+logic       bypass_tready;
+logic       bypass_tuser;
+logic       bypass_tlast;
+
+if( PS_TX_FIFO_DEPTH_BITS > 0 ) begin :ps_tx_block
+    logic [7:0] ps_tx_fifo_in_tdata;
+    logic       ps_tx_fifo_in_tvalid;
+    logic       ps_tx_fifo_in_tready;
+    logic       ps_tx_fifo_in_tlast;
+    logic [PS_TX_FIFO_DEPTH_BITS+1:0] ps_tx_fifo_level;
+    logic [7:0] ps_tx_fifo_out_tdata;
+    logic       ps_tx_fifo_out_tvalid;
+    logic       ps_tx_fifo_out_tready;
+    logic       ps_tx_fifo_out_tuser;
+    logic       ps_tx_fifo_out_tlast;
+    logic [7:0] ps_tx_shaper_out_tdata;
+    logic       ps_tx_shaper_out_tvalid;
+    logic       ps_tx_shaper_out_tready;
+    logic       ps_tx_shaper_out_tuser;
+    logic       ps_tx_shaper_out_tlast;
+
+    tx_cut_through_fifo #(
+        .DEPTH_BITS(PS_TX_FIFO_DEPTH_BITS),
+        .START_THRESHOLD(1)
+    ) ps_tx_fifo_inst (
+        .clock(tx_clock),
+        .aresetn(!tx_reset),
+        .saxis_tdata(ps_tx_fifo_in_tdata),
+        .saxis_tvalid(ps_tx_fifo_in_tvalid),
+        .saxis_tready(ps_tx_fifo_in_tready),
+        .saxis_tlast(ps_tx_fifo_in_tlast),
+        .maxis_tdata(ps_tx_fifo_out_tdata),
+        .maxis_tvalid(ps_tx_fifo_out_tvalid),
+        .maxis_tready(ps_tx_fifo_out_tready),
+        .maxis_tuser(ps_tx_fifo_out_tuser),
+        .maxis_tlast(ps_tx_fifo_out_tlast),
+        .level(ps_tx_fifo_level),
+        .underrun_count(ps_tx_underrun_count));
+
+    if( PS_TX_SHAPER ) begin :ps_tx_shaper_block
+        tx_bypass_shaper #(
+            .CLASSES(PS_TX_SHAPER_CLASSES),
+            .FIFO_LEVEL_BITS(PS_TX_FIFO_DEPTH_BITS + 2),
+            .FIFO_BYTES(2**PS_TX_FIFO_DEPTH_BITS),
+            .CLASS_FIFO_DEPTH_BITS(PS_TX_FIFO_DEPTH_BITS > 10 ? PS_TX_FIFO_DEPTH_BITS - 5 : 5),
+            .BACKPRESSURE(USE_BRIDGE),
+            .ADDR_BITS(8)
+        ) tx_bypass_shaper_inst (
+            .clock(tx_clock),
+            .aresetn(!tx_reset),
+            .saxis_tdata(ps_tx_tdata),
+            .saxis_tvalid(ps_tx_tvalid),
+            .saxis_tready(ps_tx_tready),
+            .saxis_tlast(ps_tx_tlast),
+            .fifo_saxis_tdata(ps_tx_fifo_in_tdata),
+            .fifo_saxis_tvalid(ps_tx_fifo_in_tvalid),
+            .fifo_saxis_tlast(ps_tx_fifo_in_tlast),
+            .fifo_level(ps_tx_fifo_level),
+            .fifo_maxis_tdata(ps_tx_fifo_out_tdata),
+            .fifo_maxis_tvalid(ps_tx_fifo_out_tvalid),
+            .fifo_maxis_tready(ps_tx_fifo_out_tready),
+            .fifo_maxis_tuser(ps_tx_fifo_out_tuser),
+            .fifo_maxis_tlast(ps_tx_fifo_out_tlast),
+            .maxis_tdata(ps_tx_shaper_out_tdata),
+            .maxis_tvalid(ps_tx_shaper_out_tvalid),
+            .maxis_tready(ps_tx_shaper_out_tready),
+            .maxis_tuser(ps_tx_shaper_out_tuser),
+            .maxis_tlast(ps_tx_shaper_out_tlast),
+            .s_axi_awaddr(shaper_s_axi_awaddr),
+            .s_axi_awvalid(shaper_s_axi_awvalid),
+            .s_axi_awready(shaper_s_axi_awready),
+            .s_axi_wdata(shaper_s_axi_wdata),
+            .s_axi_wstrb(shaper_s_axi_wstrb),
+            .s_axi_wvalid(shaper_s_axi_wvalid),
+            .s_axi_wready(shaper_s_axi_wready),
+            .s_axi_bresp(shaper_s_axi_bresp),
+            .s_axi_bvalid(shaper_s_axi_bvalid),
+            .s_axi_bready(shaper_s_axi_bready),
+            .s_axi_araddr(shaper_s_axi_araddr),
+            .s_axi_arvalid(shaper_s_axi_arvalid),
+            .s_axi_arready(shaper_s_axi_arready),
+            .s_axi_rdata(shaper_s_axi_rdata),
+            .s_axi_rresp(shaper_s_axi_rresp),
+            .s_axi_rvalid(shaper_s_axi_rvalid),
+            .s_axi_rready(shaper_s_axi_rready));
+    end
+    else begin :no_ps_tx_shaper_block
+        assign ps_tx_fifo_in_tdata = ps_tx_tdata;
+        assign ps_tx_fifo_in_tvalid = ps_tx_tvalid;
+        assign ps_tx_tready = ps_tx_fifo_in_tready;
+        assign ps_tx_fifo_in_tlast = ps_tx_tlast;
+        assign ps_tx_shaper_out_tdata = ps_tx_fifo_out_tdata;
+        assign ps_tx_shaper_out_tvalid = ps_tx_fifo_out_tvalid;
+        assign ps_tx_fifo_out_tready = ps_tx_shaper_out_tready;
+        assign ps_tx_shaper_out_tuser = ps_tx_fifo_out_tuser;
+        assign ps_tx_shaper_out_tlast = ps_tx_fifo_out_tlast;
+    end
+
+    // The frames aborted by underruns of the FIFO carry tuser to mii_mac_tx, which sends them with a bad FCS.
+    prepend_preamble prepend_preamble_inst (
+        .clock(tx_clock),
+        .aresetn(!tx_reset),
+        .saxis_tdata(ps_tx_shaper_out_tdata),
+        .saxis_tvalid(ps_tx_shaper_out_tvalid),
+        .saxis_tready(ps_tx_shaper_out_tready),
+        .saxis_tuser(ps_tx_shaper_out_tuser),
+        .saxis_tlast(ps_tx_shaper_out_tlast),
+        .maxis_tdata(bypass_tdata),
+        .maxis_tvalid(bypass_tvalid),
+        .maxis_tready(bypass_tready),
+        .maxis_tuser(bypass_tuser),
+        .maxis_tlast(bypass_tlast));
+
+    assign tx_saxis_bypass_tready = 0;
+end
+else begin :no_ps_tx_block
+    assign bypass_tdata = tx_saxis_bypass_tdata;
+    assign bypass_tvalid = tx_saxis_bypass_tvalid;
+    assign tx_saxis_bypass_tready = bypass_tready;
+    assign bypass_tuser = 0;
+    assign bypass_tlast = tx_saxis_bypass_tlast;
+    assign ps_tx_tready = 1;
+    assign ps_tx_underrun_count = 0;
+end
+
+if( !PS_TX_SHAPER ) begin :no_shaper_axi_block
+    // The registers of the shaper do not respond.
+    assign shaper_s_axi_awready = 0;
+    assign shaper_s_axi_wready = 0;
+    assign shaper_s_axi_bresp = 2'b00;
+    assign shaper_s_axi_bvalid = 0;
+    assign shaper_s_axi_arready = 0;
+    assign shaper_s_axi_rdata = 0;
+    assign shaper_s_axi_rresp = 2'b00;
+    assign shaper_s_axi_rvalid = 0;
+end
+
+// Frames from mii_mac_rx
+logic [7:0] rx_frame_tdata;
+logic       rx_frame_tvalid;
+logic       rx_frame_tready;
+logic       rx_frame_tuser;
+logic       rx_frame_tlast;
+// Timestamps of them
+logic [95:0] rx_sfd_timestamp_tdata;
+logic        rx_sfd_timestamp_tvalid;
+logic        rx_sfd_timestamp_tready;
+// MII to the GEM before the multicast filter
+logic [3:0] ps_rx_source_mii_d;
+logic       ps_rx_source_mii_dv;
+
+logic rx_sfd;
+logic rx_frame_stored;
+logic        rx_ptp_event;
+logic [1:0]  rx_ptp_transport;
+logic [3:0]  rx_ptp_message_type;
+logic [7:0]  rx_ptp_domain_number;
+logic [15:0] rx_ptp_sequence_id;
+logic        rx_pause_valid;
+logic [15:0] rx_pause_quanta;
+logic [7:0]  pause_frame_tdata;
+logic        pause_frame_tvalid;
+logic        pause_frame_tready;
+logic        pause_frame_tlast;
+logic        gate_hold_payload;
+logic        gate_hold_bypass;
+
+// The gate holds a frame from the time of the longest frame on the line before it closes.
+// With MACsec, the frame grows by the SecTAG with the SCI and the ICV (32 bytes) and leaves the cut-through FIFO
+// of macsec_tx only after MACSEC_START_THRESHOLD bytes, so the guard band must cover both.
+// Keep these in step with mii_mac_tx and macsec_tx. The driver can still override GUARD_BAND.
+localparam int TX_MACSEC_START_THRESHOLD = 48;
+localparam int TAS_GUARD_BAND_BYTES = 8 + 1522 + 12 + (USE_MACSEC ? 32 + TX_MACSEC_START_THRESHOLD : 0);
+localparam int TAS_GUARD_BAND = TAS_GUARD_BAND_BYTES * 80;      // nanoseconds at 100Mbps
+
+tx_gate_control #(
+    .ENTRIES(TAS_ENTRIES),
+    .ADDR_BITS(8),
+    .DEFAULT_GUARD_BAND(TAS_GUARD_BAND)
+) tx_gate_control_inst (
+    .clock(tx_clock),
+    .aresetn(!tx_reset),
+    .time_seconds(time_seconds),
+    .time_nanoseconds(time_nanoseconds),
+    .hold_payload(gate_hold_payload),
+    .hold_bypass(gate_hold_bypass),
+    .s_axi_awaddr(tas_s_axi_awaddr),
+    .s_axi_awvalid(tas_s_axi_awvalid),
+    .s_axi_awready(tas_s_axi_awready),
+    .s_axi_wdata(tas_s_axi_wdata),
+    .s_axi_wstrb(tas_s_axi_wstrb),
+    .s_axi_wvalid(tas_s_axi_wvalid),
+    .s_axi_wready(tas_s_axi_wready),
+    .s_axi_bresp(tas_s_axi_bresp),
+    .s_axi_bvalid(tas_s_axi_bvalid),
+    .s_axi_bready(tas_s_axi_bready),
+    .s_axi_araddr(tas_s_axi_araddr),
+    .s_axi_arvalid(tas_s_axi_arvalid),
+    .s_axi_arready(tas_s_axi_arready),
+    .s_axi_rdata(tas_s_axi_rdata),
+    .s_axi_rresp(tas_s_axi_rresp),
+    .s_axi_rvalid(tas_s_axi_rvalid),
+    .s_axi_rready(tas_s_axi_rready));
+
+mii_mac_tx #(
+    .MUX_POLICY(TX_MUX_POLICY),
+    .MUX_QUANTUM_PAYLOAD(TX_MUX_QUANTUM),
+    .MUX_QUANTUM_BYPASS(TX_MUX_QUANTUM_BYPASS),
+    .USE_MACSEC(USE_MACSEC),
+    .MACSEC_START_THRESHOLD(TX_MACSEC_START_THRESHOLD)
+) mii_mac_tx_inst (
     .clock(tx_clock),
     .aresetn(!tx_reset),
     .mii_d(tx_mii_d),
     .mii_en(tx_mii_en),
     .mii_er(),
-    .saxis_tdata(tx_saxis_tdata),
-    .saxis_tvalid(tx_saxis_tvalid),
-    .saxis_tready(tx_saxis_tready),
-    .saxis_tlast(tx_saxis_tlast),
-    .saxis_bypass_tdata(tx_saxis_bypass_tdata),
-    .saxis_bypass_tvalid(tx_saxis_bypass_tvalid),
-    .saxis_bypass_tready(tx_saxis_bypass_tready),
-    .saxis_bypass_tlast(tx_saxis_bypass_tlast));
-
-mii_mac_rx mii_mac_rx_inst (
+    .saxis_tdata(tx_fifo_out_tdata),
+    .saxis_tvalid(tx_fifo_out_tvalid),
+    .saxis_tready(tx_fifo_out_tready),
+    .saxis_tuser(tx_fifo_out_tuser),
+    .saxis_tlast(tx_fifo_out_tlast),
+    .saxis_bypass_tdata(bypass_tdata),
+    .saxis_bypass_tvalid(bypass_tvalid),
+    .saxis_bypass_tready(bypass_tready),
+    .saxis_bypass_tuser(bypass_tuser),
+    .saxis_bypass_tlast(bypass_tlast),
+    .saxis_control_tdata(pause_frame_tdata),
+    .saxis_control_tvalid(pause_frame_tvalid),
+    .saxis_control_tready(pause_frame_tready),
+    .saxis_control_tlast(pause_frame_tlast),
+    .pause(tx_paused),
+    .gate_hold_payload(gate_hold_payload),
+    .gate_hold_bypass(gate_hold_bypass),
+    .time_seconds(time_seconds),
+    .time_nanoseconds(time_nanoseconds),
+    .ptp_one_step(ptp_one_step),
+    .ptp_event_maxis_tdata(ptp_tx_event_maxis_tdata),
+    .ptp_event_maxis_tvalid(ptp_tx_event_maxis_tvalid),
+    .ptp_event_maxis_tready(ptp_tx_event_maxis_tready),
+    .payload_grant_count(tx_grant_count),
+    .bypass_grant_count(tx_bypass_grant_count),
+    .payload_wait_cycles(tx_wait_cycles),
+    .bypass_wait_cycles(tx_bypass_wait_cycles),
+    .payload_starvation_count(tx_starvation_count),
+    .bypass_starvation_count(tx_bypass_starvation_count),
+    .macsec_s_axi_awaddr(macsec_tx_s_axi_awaddr),
+    .macsec_s_axi_awvalid(macsec_tx_s_axi_awvalid),
+    .macsec_s_axi_awready(macsec_tx_s_axi_awready),
+    .macsec_s_axi_wdata(macsec_tx_s_axi_wdata),
+    .macsec_s_axi_wstrb(macsec_tx_s_axi_wstrb),
+    .macsec_s_axi_wvalid(macsec_tx_s_axi_wvalid),
+    .macsec_s_axi_wready(macsec_tx_s_axi_wready),
+    .macsec_s_axi_bresp(macsec_tx_s_axi_bresp),
+    .macsec_s_axi_bvalid(macsec_tx_s_axi_bvalid),
+    .macsec_s_axi_bready(macsec_tx_s_axi_bready),
+    .macsec_s_axi_araddr(macsec_tx_s_axi_araddr),
+    .macsec_s_axi_arvalid(macsec_tx_s_axi_arvalid),
+    .macsec_s_axi_arready(macsec_tx_s_axi_arready),
+    .macsec_s_axi_rdata(macsec_tx_s_axi_rdata),
+    .macsec_s_axi_rresp(macsec_tx_s_axi_rresp),
+    .macsec_s_axi_rvalid(macsec_tx_s_axi_rvalid),
+    .macsec_s_axi_rready(macsec_tx_s_axi_rready));
+
+mii_mac_rx #(
+    .FIFO_DEPTH_BITS(RX_FIFO_DEPTH_BITS),
+    .USE_MACSEC(USE_MACSEC)
+) mii_mac_rx_inst (
     .clock(rx_clock),
     .aresetn(!rx_reset),
     .mii_d(rx_mii_d),
     .mii_dv(rx_mii_dv),
     .mii_er(0),
-    .maxis_tdata(rx_maxis_tdata),
-    .maxis_tvalid(rx_maxis_tvalid),
-    .maxis_tuser(rx_maxis_tuser),
-    .maxis_tlast(rx_maxis_tlast));
+    .maxis_tdata(rx_frame_tdata),
+    .maxis_tvalid(rx_frame_tvalid),
+    .maxis_tready(rx_frame_tready),
+    .maxis_tuser(rx_frame_tuser),
+    .maxis_tlast(rx_frame_tlast),
+    .sfd(rx_sfd),
+    .frame_stored(rx_frame_stored),
+    .overflow_drop_count(rx_overflow_drop_count),
+    .overflow_abort_count(rx_overflow_abort_count),
+    .fcs_error_count(rx_fcs_error_count),
+    .ptp_event(rx_ptp_event),
+    .ptp_transport(rx_ptp_transport),
+    .ptp_message_type(rx_ptp_message_type),
+    .ptp_domain_number(rx_ptp_domain_number),
+    .ptp_sequence_id(rx_ptp_sequence_id),
+    .pause_valid(rx_pause_valid),
+    .pause_quanta(rx_pause_quanta),
+    .macsec_s_axi_awaddr(macsec_rx_s_axi_awaddr),
+    .macsec_s_axi_awvalid(macsec_rx_s_axi_awvalid),
+    .macsec_s_axi_awready(macsec_rx_s_axi_awready),
+    .macsec_s_axi_wdata(macsec_rx_s_axi_wdata),
+    .macsec_s_axi_wstrb(macsec_rx_s_axi_wstrb),
+    .macsec_s_axi_wvalid(macsec_rx_s_axi_wvalid),
+    .macsec_s_axi_wready(macsec_rx_s_axi_wready),
+    .macsec_s_axi_bresp(macsec_rx_s_axi_bresp),
+    .macsec_s_axi_bvalid(macsec_rx_s_axi_bvalid),
+    .macsec_s_axi_bready(macsec_rx_s_axi_bready),
+    .macsec_s_axi_araddr(macsec_rx_s_axi_araddr),
+    .macsec_s_axi_arvalid(macsec_rx_s_axi_arvalid),
+    .macsec_s_axi_arready(macsec_rx_s_axi_arready),
+    .macsec_s_axi_rdata(macsec_rx_s_axi_rdata),
+    .macsec_s_axi_rresp(macsec_rx_s_axi_rresp),
+    .macsec_s_axi_rvalid(macsec_rx_s_axi_rvalid),
+    .macsec_s_axi_rready(macsec_rx_s_axi_rready));
+
+pause_control #(
+    .CLOCKS_PER_QUANTUM(128)
+) pause_control_inst (
+    .rx_clock(rx_clock),
+    .rx_aresetn(!rx_reset),
+    .rx_pause_valid(rx_pause_valid),
+    .rx_pause_quanta(rx_pause_quanta),
+    .clock(tx_clock),
+    .aresetn(!tx_reset),
+    .source_address(pause_source_address),
+    .pause_request(pause_request),
+    .paused(tx_paused),
+    .maxis_tdata(pause_frame_tdata),
+    .maxis_tvalid(pause_frame_tvalid),
+    .maxis_tready(pause_frame_tready),
+    .maxis_tlast(pause_frame_tlast));
+
+mii_multicast_filter mii_multicast_filter_inst (
+    .clock(rx_clock),
+    .aresetn(!rx_reset),
+    .hash_clock(multicast_hash_clock),
+    .hash_table(multicast_hash),
+    .mii_d(ps_rx_source_mii_d),
+    .mii_dv(ps_rx_source_mii_dv),
+    .filtered_mii_d(ps_rx_mii_d),
+    .filtered_mii_dv(ps_rx_mii_dv));
+
+rx_timestamp rx_timestamp_inst (
+    .rx_clock(rx_clock),
+    .rx_aresetn(!rx_reset),
+    .rx_sfd(rx_sfd),
+    .rx_frame_stored(rx_frame_stored),
+    .rx_ptp_event(rx_ptp_event),
+    .rx_ptp_transport(rx_ptp_transport),
+    .rx_ptp_message_type(rx_ptp_message_type),
+    .rx_ptp_domain_number(rx_ptp_domain_number),
+    .rx_ptp_sequence_id(rx_ptp_sequence_id),
+    .clock(tx_clock),
+    .aresetn(!tx_reset),
+    .time_seconds(time_seconds),
+    .time_nanoseconds(time_nanoseconds),
+    .time_locked(time_locked),
+    .maxis_tdata(rx_sfd_timestamp_tdata),
+    .maxis_tvalid(rx_sfd_timestamp_tvalid),
+    .maxis_tready(rx_sfd_timestamp_tready),
+    .ptp_maxis_tdata(ptp_rx_event_maxis_tdata),
+    .ptp_maxis_tvalid(ptp_rx_event_maxis_tvalid),
+    .ptp_maxis_tready(ptp_rx_event_maxis_tready));
+
+mac_counters #(
+    .ADDR_BITS(8)
+) mac_counters_inst (
+    .clock(tx_clock),
+    .aresetn(!tx_reset),
+    .tx_underrun_count(tx_underrun_count),
+    .ps_tx_underrun_count(ps_tx_underrun_count),
+    .tx_grant_count(tx_grant_count),
+    .tx_bypass_grant_count(tx_bypass_grant_count),
+    .tx_wait_cycles(tx_wait_cycles),
+    .tx_bypass_wait_cycles(tx_bypass_wait_cycles),
+    .tx_starvation_count(tx_starvation_count),
+    .tx_bypass_starvation_count(tx_bypass_starvation_count),
+    .rx_clock(rx_clock),
+    .rx_aresetn(!rx_reset),
+    .rx_overflow_drop_count(rx_overflow_drop_count),
+    .rx_overflow_abort_count(rx_overflow_abort_count),
+    .rx_fcs_error_count(rx_fcs_error_count),
+    .s_axi_awaddr(counters_s_axi_awaddr),
+    .s_axi_awvalid(counters_s_axi_awvalid),
+    .s_axi_awready(counters_s_axi_awready),
+    .s_axi_wdata(counters_s_axi_wdata),
+    .s_axi_wstrb(counters_s_axi_wstrb),
+    .s_axi_wvalid(counters_s_axi_wvalid),
+    .s_axi_wready(counters_s_axi_wready),
+    .s_axi_bresp(counters_s_axi_bresp),
+    .s_axi_bvalid(counters_s_axi_bvalid),
+    .s_axi_bready(counters_s_axi_bready),
+    .s_axi_araddr(counters_s_axi_araddr),
+    .s_axi_arvalid(counters_s_axi_arvalid),
+    .s_axi_arready(counters_s_axi_arready),
+    .s_axi_rdata(counters_s_axi_rdata),
+    .s_axi_rresp(counters_s_axi_rresp),
+    .s_axi_rvalid(counters_s_axi_rvalid),
+    .s_axi_rready(counters_s_axi_rready));
+
+// Local time of the frames entering the bridge from the GEM and the PL ports, in the layout of rx_timestamp
+wire [95:0] bridge_local_time = {15'b0, time_locked, time_seconds, time_nanoseconds};
+
+if( USE_BRIDGE ) begin :bridge_block
+    // Port 0 is the PHY, port 1 is the GEM and the PL ports follow. The switch runs in the tx_clock domain
+    // and moves a byte per clock for all the ports. The frames have no preamble nor FCS in it.
+    // The frames from the GEM to the PHY take the bypass input through the shaper if PS_TX_FIFO_DEPTH_BITS > 0,
+    // and the others take the payload input. tx_saxis is stalled at the frame boundary while the ingress FIFO
+    // of the PL port told by tx_saxis_tid has no room for a frame, instead of dropping the frames when the switch is congested.
+    localparam int PORTS = 2 + BRIDGE_PL_PORTS;
+    localparam int PORT_BITS = $clog2(PORTS);
+    localparam int PORT_PHY = 0;
+    localparam int PORT_PS = 1;
+    localparam int PORT_PL = 2;
+
+    logic [PORTS-1:0][7:0]  switch_in_tdata;
+    logic [PORTS-1:0]       switch_in_tvalid;
+    logic [PORTS-1:0]       switch_in_tuser;
+    logic [PORTS-1:0]       switch_in_tlast;
+    logic [PORTS-1:0][95:0] switch_in_tmeta;
+    logic [PORTS-1:0]       switch_in_room;
+    logic [PORTS-1:0][7:0]  switch_out_tdata;
+    logic [PORTS-1:0]       switch_out_tvalid;
+    logic [PORTS-1:0]       switch_out_tready;
+    logic [PORTS-1:0]       switch_out_tlast;
+    logic [PORTS-1:0][95:0] switch_out_tmeta;
+    logic [PORTS-1:0][PORT_BITS-1:0] switch_out_tid;
+
+    l2_switch #(
+        .PORTS(PORTS),
+        .INGRESS_DEPTH_BITS(11),
+        .EGRESS_DEPTH_BITS(12),
+        .META_BITS(96),
+        .TABLE_BITS(BRIDGE_TABLE_BITS),
+        .AGING_TICK_CLOCKS(25000000),
+        .ADDR_BITS(8)
+    ) l2_switch_inst (
+        .clock(tx_clock),
+        .aresetn(!tx_reset),
+        .saxis_tdata(switch_in_tdata),
+        .saxis_tvalid(switch_in_tvalid),
+        .saxis_tuser(switch_in_tuser),
+        .saxis_tlast(switch_in_tlast),
+        .saxis_tmeta(switch_in_tmeta),
+        .ingress_room(switch_in_room),
+        .maxis_tdata(switch_out_tdata),
+        .maxis_tvalid(switch_out_tvalid),
+        .maxis_tready(switch_out_tready),
+        .maxis_tlast(switch_out_tlast),
+        .maxis_tmeta(switch_out_tmeta),
+        .maxis_tid(switch_out_tid),
+        .s_axi_awaddr(bridge_s_axi_awaddr),
+        .s_axi_awvalid(bridge_s_axi_awvalid),
+        .s_axi_awready(bridge_s_axi_awready),
+        .s_axi_wdata(bridge_s_axi_wdata),
+        .s_axi_wstrb(bridge_s_axi_wstrb),
+        .s_axi_wvalid(bridge_s_axi_wvalid),
+        .s_axi_wready(bridge_s_axi_wready),
+        .s_axi_bresp(bridge_s_axi_bresp),
+        .s_axi_bvalid(bridge_s_axi_bvalid),
+        .s_axi_bready(bridge_s_axi_bready),
+        .s_axi_araddr(bridge_s_axi_araddr),
+        .s_axi_arvalid(bridge_s_axi_arvalid),
+        .s_axi_arready(bridge_s_axi_arready),
+        .s_axi_rdata(bridge_s_axi_rdata),
+        .s_axi_rresp(bridge_s_axi_rresp),
+        .s_axi_rvalid(bridge_s_axi_rvalid),
+        .s_axi_rready(bridge_s_axi_rready));
+
+    // PHY to the switch. The received frames cross to tx_clock, and the last byte of a frame waits for its SFD timestamp,
+    // which rx_timestamp emits for each frame from mii_mac_rx.
+    logic [7:0] phy_rx_tdata;
+    logic       phy_rx_tvalid;
+    logic       phy_rx_tready;
+    logic       phy_rx_tuser;
+    logic       phy_rx_tlast;
+
+    async_fifo #(
+        .DATA_BITS(10),
+        .DEPTH_BITS(4)
+    ) phy_rx_fifo_inst (
+        .s_clock(rx_clock),
+        .s_aresetn(!rx_reset),
+        .saxis_tdata({rx_frame_tuser, rx_frame_tlast, rx_frame_tdata}),
+        .saxis_tvalid(rx_frame_tvalid),
+        .saxis_tready(rx_frame_tready),
+        .s_level(),
+        .almost_full(),
+        .m_clock(tx_clock),
+        .m_aresetn(!tx_reset),
+        .maxis_tdata({phy_rx_tuser, phy_rx_tlast, phy_rx_tdata}),
+        .maxis_tvalid(phy_rx_tvalid),
+        .maxis_tready(phy_rx_tready));
+
+    assign phy_rx_tready = !phy_rx_tlast || rx_sfd_timestamp_tvalid;
+    assign rx_sfd_timestamp_tready = phy_rx_tvalid && phy_rx_tlast;
+
+    assign switch_in_tdata[PORT_PHY] = phy_rx_tdata;
+    assign switch_in_tvalid[PORT_PHY] = phy_rx_tvalid && phy_rx_tready;
+    assign switch_in_tuser[PORT_PHY] = phy_rx_tuser;
+    assign switch_in_tlast[PORT_PHY] = phy_rx_tlast;
+    assign switch_in_tmeta[PORT_PHY] = rx_sfd_timestamp_tdata;
+
+    // Switch to the PHY
+    localparam bit PS_TO_BYPASS = PS_TX_FIFO_DEPTH_BITS > 0;
+    wire phy_tx_from_ps = PS_TO_BYPASS && switch_out_tid[PORT_PHY] == PORT_PS;
+    logic ps_append_crc_tready;
+
+    assign tx_payload_tdata = switch_out_tdata[PORT_PHY];
+    assign tx_payload_tvalid = switch_out_tvalid[PORT_PHY] && !phy_tx_from_ps;
+    assign tx_payload_tlast = switch_out_tlast[PORT_PHY];
+    assign switch_out_tready[PORT_PHY] = phy_tx_from_ps ? ps_append_crc_tready : tx_payload_tready;
+
+    if( PS_TO_BYPASS ) begin :ps_to_bypass_block
+        append_crc ps_append_crc_inst (
+            .clock(tx_clock),
+            .aresetn(!tx_reset),
+            .saxis_tdata(switch_out_tdata[PORT_PHY]),
+            .saxis_tvalid(switch_out_tvalid[PORT_PHY] && phy_tx_from_ps),
+            .saxis_tready(ps_append_crc_tready),
+            .saxis_tkeep(1'b1),
+            .saxis_tuser(1'b0),
+            .saxis_tlast(switch_out_tlast[PORT_PHY]),
+            .maxis_tdata(ps_tx_tdata),
+            .maxis_tvalid(ps_tx_tvalid),
+            .maxis_tready(ps_tx_tready),
+            .maxis_tkeep(),
+            .maxis_tuser(),
+            .maxis_tlast(ps_tx_tlast));
+    end
+    else begin :no_ps_to_bypass_block
+        assign ps_append_crc_tready = 0;
+        assign ps_tx_tdata = 0;
+        assign ps_tx_tvalid = 0;
+        assign ps_tx_tlast = 0;
+    end
+
+    // GEM to the switch
+    logic [7:0] ps_remove_crc_tdata;
+    logic       ps_remove_crc_tvalid;
+    logic       ps_remove_crc_tuser;
+    logic       ps_remove_crc_tlast;
+    logic       ps_fcs_ok;
+
+    remove_crc ps_remove_crc_inst (
+        .clock(tx_clock),
+        .aresetn(!tx_reset),
+        .saxis_tdata(ps_tx_mii_tdata),
+        .saxis_tvalid(ps_tx_mii_tvalid),
+        .saxis_tready(),
+        .saxis_tkeep(1'b1),
+        .saxis_tlast(ps_tx_mii_tlast),
+        .saxis_tuser(1'b0),
+        .maxis_tdata(ps_remove_crc_tdata),
+        .maxis_tvalid(ps_remove_crc_tvalid),
+        .maxis_tready(1'b1),
+        .maxis_tkeep(),
+        .maxis_tlast(ps_remove_crc_tlast),
+        .maxis_tuser(ps_remove_crc_tuser),
+        .crc(),
+        .fcs_ok(ps_fcs_ok));
+
+    assign switch_in_tdata[PORT_PS] = ps_remove_crc_tdata;
+    assign switch_in_tvalid[PORT_PS] = ps_remove_crc_tvalid;
+    assign switch_in_tuser[PORT_PS] = ps_remove_crc_tuser || ps_remove_crc_tlast && !ps_fcs_ok;
+    assign switch_in_tlast[PORT_PS] = ps_remove_crc_tlast;
+    assign switch_in_tmeta[PORT_PS] = bridge_local_time;
+
+    // Switch to the GEM. The frames cross to rx_clock and are sent on MII like the ones from the PHY.
+    logic [7:0] ps_rx_tdata;
+    logic       ps_rx_tvalid;
+    logic       ps_rx_tready;
+    logic       ps_rx_tlast;
+    logic [7:0] ps_rx_crc_tdata;
+    logic       ps_rx_crc_tvalid;
+    logic       ps_rx_crc_tready;
+    logic       ps_rx_crc_tlast;
+    logic [7:0] ps_rx_preamble_tdata;
+    logic       ps_rx_preamble_tvalid;
+    logic       ps_rx_preamble_tready;
+    logic       ps_rx_preamble_tlast;
+
+    async_fifo #(
+        .DATA_BITS(9),
+        .DEPTH_BITS(4)
+    ) ps_rx_fifo_inst (
+        .s_clock(tx_clock),
+        .s_aresetn(!tx_reset),
+        .saxis_tdata({switch_out_tlast[PORT_PS], switch_out_tdata[PORT_PS]}),
+        .saxis_tvalid(switch_out_tvalid[PORT_PS]),
+        .saxis_tready(switch_out_tready[PORT_PS]),
+        .s_level(),
+        .almost_full(),
+        .m_clock(rx_clock),
+        .m_aresetn(!rx_reset),
+        .maxis_tdata({ps_rx_tlast, ps_rx_tdata}),
+        .maxis_tvalid(ps_rx_tvalid),
+        .maxis_tready(ps_rx_tready));
+
+    append_crc ps_rx_append_crc_inst (
+        .clock(rx_clock),
+        .aresetn(!rx_reset),
+        .saxis_tdata(ps_rx_tdata),
+        .saxis_tvalid(ps_rx_tvalid),
+        .saxis_tready(ps_rx_tready),
+        .saxis_tkeep(1'b1),
+        .saxis_tuser(1'b0),
+        .saxis_tlast(ps_rx_tlast),
+        .maxis_tdata(ps_rx_crc_tdata),
+        .maxis_tvalid(ps_rx_crc_tvalid),
+        .maxis_tready(ps_rx_crc_tready),
+        .maxis_tkeep(),
+        .maxis_tuser(),
+        .maxis_tlast(ps_rx_crc_tlast));
+
+    prepend_preamble ps_rx_prepend_preamble_inst (
+        .clock(rx_clock),
+        .aresetn(!rx_reset),
+        .saxis_tdata(ps_rx_crc_tdata),
+        .saxis_tvalid(ps_rx_crc_tvalid),
+        .saxis_tready(ps_rx_crc_tready),
+        .saxis_tuser(1'b0),
+        .saxis_tlast(ps_rx_crc_tlast),
+        .maxis_tdata(ps_rx_preamble_tdata),
+        .maxis_tvalid(ps_rx_preamble_tvalid),
+        .maxis_tready(ps_rx_preamble_tready),
+        .maxis_tuser(),
+        .maxis_tlast(ps_rx_preamble_tlast));
+
+    axis_to_mii ps_rx_axis_to_mii_inst (
+        .clock(rx_clock),
+        .aresetn(!rx_reset),
+        .mii_d(ps_rx_source_mii_d),
+        .mii_en(ps_rx_source_mii_dv),
+        .mii_er(),
+        .saxis_tdata(ps_rx_preamble_tdata),
+        .saxis_tvalid(ps_rx_preamble_tvalid),
+        .saxis_tready(ps_rx_preamble_tready),
+        .saxis_tlast(ps_rx_preamble_tlast),
+        .sfd());
+
+    // PL ports to the switch, told by tx_saxis_tid. A frame starts only while the ingress FIFO of its port has room for it,
+    // and it is not stalled after that, since the FIFO outputs a frame only after its end. Frames to a port which does not exist are discarded.
+    logic pl_in_frame;
+    wire  pl_admit = tx_saxis_tid >= BRIDGE_PL_PORTS || switch_in_room[PORT_PL + tx_saxis_tid];
+
+    always_ff @(posedge tx_clock) begin
+        if( tx_reset ) begin
+            pl_in_frame <= 0;
+        end
+        else if( tx_saxis_tvalid && tx_saxis_tready ) begin
+            pl_in_frame <= !tx_saxis_tlast;
+        end
+    end
+
+    assign tx_saxis_tready = pl_in_frame || pl_admit;
+
+    for(genvar i = 0; i < BRIDGE_PL_PORTS; i++) begin :pl_in_block
+        assign switch_in_tdata[PORT_PL + i] = tx_saxis_tdata;
+        assign switch_in_tvalid[PORT_PL + i] = tx_saxis_tvalid && tx_saxis_tready && tx_saxis_tid == i;
+        assign switch_in_tuser[PORT_PL + i] = 0;
+        assign switch_in_tlast[PORT_PL + i] = tx_saxis_tlast;
+        assign switch_in_tmeta[PORT_PL + i] = bridge_local_time;
+    end
+
+    // Switch to the PL ports. The frames are merged with tdest, and their timestamps are output with the same tdest
+    // before them. The frames cross to rx_clock.
+    logic [7:0] pl_out_tdata;
+    logic       pl_out_tvalid;
+    logic       pl_out_tready;
+    logic       pl_out_tlast;
+    logic [3:0] pl_out_tdest;
+
+    axis_frame_merge #(
+        .INPUTS(BRIDGE_PL_PORTS),
+        .META_BITS(96),
+        .DEST_BITS(4)
+    ) pl_merge_inst (
+        .clock(tx_clock),
+        .aresetn(!tx_reset),
+        .saxis_tdata(switch_out_tdata[PORTS-1:PORT_PL]),
+        .saxis_tvalid(switch_out_tvalid[PORTS-1:PORT_PL]),
+        .saxis_tready(switch_out_tready[PORTS-1:PORT_PL]),
+        .saxis_tlast(switch_out_tlast[PORTS-1:PORT_PL]),
+        .saxis_tmeta(switch_out_tmeta[PORTS-1:PORT_PL]),
+        .maxis_tdata(pl_out_tdata),
+        .maxis_tvalid(pl_out_tvalid),
+        .maxis_tready(pl_out_tready),
+        .maxis_tlast(pl_out_tlast),
+        .maxis_tdest(pl_out_tdest),
+        .meta_maxis_tdata(rx_timestamp_maxis_tdata),
+        .meta_maxis_tdest(rx_timestamp_maxis_tdest),
+        .meta_maxis_tvalid(rx_timestamp_maxis_tvalid),
+        .meta_maxis_tready(rx_timestamp_maxis_tready));
+
+    async_fifo #(
+        .DATA_BITS(13),
+        .DEPTH_BITS(4)
+    ) pl_rx_fifo_inst (
+        .s_clock(tx_clock),
+        .s_aresetn(!tx_reset),
+        .saxis_tdata({pl_out_tdest, pl_out_tlast, pl_out_tdata}),
+        .saxis_tvalid(pl_out_tvalid),
+        .saxis_tready(pl_out_tready),
+        .s_level(),
+        .almost_full(),
+        .m_clock(rx_clock),
+        .m_aresetn(!rx_reset),
+        .maxis_tdata({rx_maxis_tdest, rx_maxis_tlast, rx_maxis_tdata}),
+        .maxis_tvalid(rx_maxis_tvalid),
+        .maxis_tready(rx_maxis_tready));
+
+    assign rx_maxis_tuser = 0;
+end
+else begin :no_bridge_block
+    assign tx_payload_tdata = tx_saxis_tdata;
+    assign tx_payload_tvalid = tx_saxis_tvalid;
+    assign tx_saxis_tready = tx_payload_tready;
+    assign tx_payload_tlast = tx_saxis_tlast;
+
+    assign ps_tx_tdata = ps_tx_mii_tdata;
+    assign ps_tx_tvalid = ps_tx_mii_tvalid;
+    assign ps_tx_tlast = ps_tx_mii_tlast;
+
+    assign rx_maxis_tdata = rx_frame_tdata;
+    assign rx_maxis_tvalid = rx_frame_tvalid;
+    assign rx_frame_tready = rx_maxis_tready;
+    assign rx_maxis_tuser = rx_frame_tuser;
+    assign rx_maxis_tlast = rx_frame_tlast;
+    assign rx_maxis_tdest = 0;
+
+    assign rx_timestamp_maxis_tdata = rx_sfd_timestamp_tdata;
+    assign rx_timestamp_maxis_tvalid = rx_sfd_timestamp_tvalid;
+    assign rx_sfd_timestamp_tready = rx_timestamp_maxis_tready;
+    assign rx_timestamp_maxis_tdest = 0;
+
+    assign ps_rx_source_mii_d = rx_mii_d;
+    assign ps_rx_source_mii_dv = rx_mii_dv;
+
+    // The registers of the bridge do not respond.
+    assign bridge_s_axi_awready = 0;
+    assign bridge_s_axi_wready = 0;
+    assign bridge_s_axi_bresp = 2'b00;
+    assign bridge_s_axi_bvalid = 0;
+    assign bridge_s_axi_arready = 0;
+    assign bridge_s_axi_rdata = 0;
+    assign bridge_s_axi_rresp = 2'b00;
+    assign bridge_s_axi_rvalid = 0;
+end
 
 endmodule
 
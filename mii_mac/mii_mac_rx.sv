@@ -1,19 +1,62 @@
 `default_nettype none
 
 module mii_mac_rx #(
-    parameter USE_RMII = 0
+    parameter USE_RMII = 0,
+    parameter USE_GMII = 0,             // mii_d is GMII RXD[7:0]
+    parameter int FIFO_DEPTH_BITS = 11, // Frames are dropped when the output is stalled longer than the FIFO holds.
+    // Validates the frames with MACsec before the FIFO, which drops the frames failing the ICV. (see macsec_rx)
+    parameter bit USE_MACSEC = 0
 )(
     input wire clock,
     input wire aresetn,
     
-    input wire [3:0] mii_d,
+    input wire [(USE_GMII ? 8 : 4)-1:0] mii_d,
     input wire       mii_dv,
     input wire       mii_er,
 
     output wire [7:0] maxis_tdata,
     output wire       maxis_tvalid,
+    input  wire       maxis_tready,
     output wire       maxis_tuser,
-    output wire       maxis_tlast
+    output wire       maxis_tlast,
+
+    output wire       sfd,      // Asserted for a cycle when the SFD is received.
+    output wire       frame_stored, // Asserted for a cycle when a frame to be output on maxis is stored.
+
+    // Received frames dropped or aborted by the reasons
+    output wire [31:0] overflow_drop_count,     // Dropped as the output is stalled
+    output wire [31:0] overflow_abort_count,    // Ended with tuser as the output is stalled after the frame is started
+    output logic [31:0] fcs_error_count,        // Output with tuser by FCS errors
+
+    // PTP event message. The fields hold until the next frame is output.
+    output logic        ptp_event,  // Asserted for a cycle after a PTP event message without errors is stored.
+    output wire  [1:0]  ptp_transport,
+    output wire  [3:0]  ptp_message_type,
+    output wire  [7:0]  ptp_domain_number,
+    output wire  [15:0] ptp_sequence_id,
+
+    // IEEE 802.3x PAUSE
+    output logic        pause_valid,    // Asserted for a cycle after a PAUSE frame without errors.
+    output logic [15:0] pause_quanta,
+
+    // MACsec registers (see macsec_rx). They do not respond unless USE_MACSEC.
+    input  wire  [7:0]  macsec_s_axi_awaddr,
+    input  wire         macsec_s_axi_awvalid,
+    output wire         macsec_s_axi_awready,
+    input  wire  [31:0] macsec_s_axi_wdata,
+    input  wire  [3:0]  macsec_s_axi_wstrb,
+    input  wire         macsec_s_axi_wvalid,
+    output wire         macsec_s_axi_wready,
+    output wire  [1:0]  macsec_s_axi_bresp,
+    output wire         macsec_s_axi_bvalid,
+    input  wire         macsec_s_axi_bready,
+    input  wire  [7:0]  macsec_s_axi_araddr,
+    input  wire         macsec_s_axi_arvalid,
+    output wire         macsec_s_axi_arready,
+    output wire  [31:0] macsec_s_axi_rdata,
+    output wire  [1:0]  macsec_s_axi_rresp,
+    output wire         macsec_s_axi_rvalid,
+    input  wire         macsec_s_axi_rready
 );
 
 logic [7:0] mii_to_axis_out_tdata;
@@ -33,7 +76,26 @@ if( USE_RMII ) begin :use_rmii_block
         .maxis_tdata (mii_to_axis_out_tdata),
         .maxis_tvalid(mii_to_axis_out_tvalid),
         .maxis_tuser (mii_to_axis_out_tuser),
-        .maxis_tlast (mii_to_axis_out_tlast)
+        .maxis_tlast (mii_to_axis_out_tlast),
+
+        .sfd(sfd)
+    );
+end
+else if( USE_GMII ) begin :use_gmii_block
+    gmii_to_axis gmii_to_axis_inst (
+        .clock(clock),
+        .aresetn(aresetn),
+
+        .gmii_d(mii_d),
+        .gmii_dv(mii_dv),
+        .gmii_er(mii_er),
+
+        .maxis_tdata (mii_to_axis_out_tdata),
+        .maxis_tvalid(mii_to_axis_out_tvalid),
+        .maxis_tuser (mii_to_axis_out_tuser),
+        .maxis_tlast (mii_to_axis_out_tlast),
+
+        .sfd(sfd)
     );
 end
 else begin :use_mii_block
@@ -48,7 +110,9 @@ else begin :use_mii_block
         .maxis_tdata (mii_to_axis_out_tdata),
         .maxis_tvalid(mii_to_axis_out_tvalid),
         .maxis_tuser (mii_to_axis_out_tuser),
-        .maxis_tlast (mii_to_axis_out_tlast)
+        .maxis_tlast (mii_to_axis_out_tlast),
+
+        .sfd(sfd)
     );
 end
 
@@ -79,12 +143,12 @@ simple_fifo #(.DATA_BITS($bits(fifo_data_t)), .DEPTH_BITS(4)) fifo_inst (
 assign fifo_in_tdata = '{tdata: mii_to_axis_out_tdata, tuser: mii_to_axis_out_tuser, tlast: mii_to_axis_out_tlast};
 assign fifo_in_tvalid = mii_to_axis_out_tvalid;
 
-logic [31:0] fcs;
 logic [7:0] remove_crc_out_tdata;
 logic       remove_crc_out_tvalid;
 logic       remove_crc_out_tready;
 logic       remove_crc_out_tuser;
 logic       remove_crc_out_tlast;
+logic       fcs_ok;
 
 remove_crc remove_crc_inst (
     .clock(clock),
@@ -93,66 +157,159 @@ remove_crc remove_crc_inst (
     .saxis_tdata (fifo_out_tdata.tdata),
     .saxis_tvalid(fifo_out_tvalid),
     .saxis_tready(fifo_out_tready),
+    .saxis_tkeep (1'b1),
     .saxis_tuser (fifo_out_tdata.tuser),
     .saxis_tlast (fifo_out_tdata.tlast),
     
     .maxis_tdata (remove_crc_out_tdata),
     .maxis_tvalid(remove_crc_out_tvalid),
     .maxis_tready(remove_crc_out_tready),
+    .maxis_tkeep (),
     .maxis_tuser (remove_crc_out_tuser),
     .maxis_tlast (remove_crc_out_tlast),
 
-    .crc(fcs)
+    .crc(),
+    .fcs_ok(fcs_ok)
 );
 
+// The frames are checked before the output FIFO, so that the PAUSE frames are processed
+// and the events are detected at the line rate even if the output is stalled.
+wire frame_error = !(remove_crc_out_tlast && fcs_ok && !remove_crc_out_tuser);
+assign remove_crc_out_tready = 1;
 
-logic [31:0] crc;
-logic [7:0] crc_mac_out_tdata;
-logic       crc_mac_out_tvalid;
-logic       crc_mac_out_tready;
-logic       crc_mac_out_tuser;
-logic       crc_mac_out_tlast;
+// Frames to the FIFO, validated by MACsec if enabled
+logic [7:0] frame_tdata;
+logic       frame_tvalid;
+logic       frame_tuser;
+logic       frame_tlast;
 
-crc_mac crc_mac_inst(
+if( USE_MACSEC ) begin :macsec_block
+    // macsec_rx ends a frame failing the ICV with tuser after the rest of it, which is dropped by the FIFO in the packet mode.
+    macsec_rx macsec_rx_inst (
+        .clock(clock),
+        .aresetn(aresetn),
+
+        .saxis_tdata (remove_crc_out_tdata),
+        .saxis_tvalid(remove_crc_out_tvalid),
+        .saxis_tuser (remove_crc_out_tlast && frame_error),
+        .saxis_tlast (remove_crc_out_tlast),
+
+        .maxis_tdata (frame_tdata),
+        .maxis_tvalid(frame_tvalid),
+        .maxis_tuser (frame_tuser),
+        .maxis_tlast (frame_tlast),
+
+        .s_axi_awaddr(macsec_s_axi_awaddr),
+        .s_axi_awvalid(macsec_s_axi_awvalid),
+        .s_axi_awready(macsec_s_axi_awready),
+        .s_axi_wdata(macsec_s_axi_wdata),
+        .s_axi_wstrb(macsec_s_axi_wstrb),
+        .s_axi_wvalid(macsec_s_axi_wvalid),
+        .s_axi_wready(macsec_s_axi_wready),
+        .s_axi_bresp(macsec_s_axi_bresp),
+        .s_axi_bvalid(macsec_s_axi_bvalid),
+        .s_axi_bready(macsec_s_axi_bready),
+        .s_axi_araddr(macsec_s_axi_araddr),
+        .s_axi_arvalid(macsec_s_axi_arvalid),
+        .s_axi_arready(macsec_s_axi_arready),
+        .s_axi_rdata(macsec_s_axi_rdata),
+        .s_axi_rresp(macsec_s_axi_rresp),
+        .s_axi_rvalid(macsec_s_axi_rvalid),
+        .s_axi_rready(macsec_s_axi_rready)
+    );
+end
+else begin :no_macsec_block
+    assign frame_tdata = remove_crc_out_tdata;
+    assign frame_tvalid = remove_crc_out_tvalid;
+    assign frame_tuser = frame_error;
+    assign frame_tlast = remove_crc_out_tlast;
+
+    // The registers of MACsec do not respond.
+    assign macsec_s_axi_awready = 0;
+    assign macsec_s_axi_wready = 0;
+    assign macsec_s_axi_bresp = 2'b00;
+    assign macsec_s_axi_bvalid = 0;
+    assign macsec_s_axi_arready = 0;
+    assign macsec_s_axi_rdata = 0;
+    assign macsec_s_axi_rresp = 2'b00;
+    assign macsec_s_axi_rvalid = 0;
+end
+
+rx_frame_fifo #(
+    .DEPTH_BITS(FIFO_DEPTH_BITS),
+    .PACKET_MODE(USE_MACSEC)
+) rx_frame_fifo_inst (
     .clock(clock),
     .aresetn(aresetn),
+    .saxis_tdata (frame_tdata),
+    .saxis_tvalid(frame_tvalid),
+    .saxis_tuser (frame_tuser),
+    .saxis_tlast (frame_tlast),
+    .maxis_tdata (maxis_tdata),
+    .maxis_tvalid(maxis_tvalid),
+    .maxis_tready(maxis_tready),
+    .maxis_tuser (maxis_tuser),
+    .maxis_tlast (maxis_tlast),
+    .level(),
+    .frame_stored(frame_stored),
+    .drop_count(overflow_drop_count),
+    .abort_count(overflow_abort_count)
+);
 
-    .saxis_tdata (remove_crc_out_tdata),
-    .saxis_tvalid(remove_crc_out_tvalid),
-    .saxis_tready(remove_crc_out_tready),
-    .saxis_tuser (remove_crc_out_tuser),
-    .saxis_tlast (remove_crc_out_tlast),
+pause_parser pause_parser_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .tdata (remove_crc_out_tdata),
+    .tvalid(remove_crc_out_tvalid),
+    .tuser (frame_error),
+    .tlast (remove_crc_out_tlast),
+    .pause_valid(pause_valid),
+    .pause_quanta(pause_quanta)
+);
 
-    .maxis_tdata (crc_mac_out_tdata),
-    .maxis_tvalid(crc_mac_out_tvalid),
-    .maxis_tready(crc_mac_out_tready),
-    .maxis_tuser (crc_mac_out_tuser),
-    .maxis_tlast (crc_mac_out_tlast),
+logic ptp_is_event;
 
-    .crc_out(crc)
+ptp_parser ptp_parser_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .tdata (frame_tdata),
+    .tvalid(frame_tvalid),
+    .tlast (frame_tlast),
+    .offset(),
+    .not_event(),
+    .is_event(ptp_is_event),
+    .transport(ptp_transport),
+    .udp_offset(),
+    .ptp_offset(),
+    .udp_checksum(),
+    .message_type(ptp_message_type),
+    .domain_number(ptp_domain_number),
+    .two_step(),
+    .correction(),
+    .sequence_id(ptp_sequence_id),
+    .origin_valid(),
+    .origin_seconds(),
+    .origin_nanoseconds()
 );
 
-logic is_crc_valid_reg;
-logic is_crc_valid;
-assign is_crc_valid = crc_mac_out_tvalid && crc_mac_out_tready && crc_mac_out_tlast ? crc == fcs : is_crc_valid_reg;
+// Events of dropped frames are suppressed. frame_stored is asserted in the cycle after the last byte.
+// The PTP messages are parsed after MACsec, so that the events of the protected frames are detected.
+logic ptp_event_candidate;
+assign ptp_event = ptp_event_candidate && frame_stored;
 
-always @(posedge clock) begin
+always_ff @(posedge clock) begin
     if( !aresetn ) begin
-        is_crc_valid_reg <= 0;
+        ptp_event_candidate <= 0;
+        fcs_error_count <= 0;
     end
     else begin
-        is_crc_valid_reg <= !(crc_mac_out_tvalid && crc_mac_out_tready) ? is_crc_valid_reg
-                          : crc_mac_out_tlast ? crc == fcs
-                          : 0;
+        ptp_event_candidate <= frame_tvalid && frame_tlast && !frame_tuser && ptp_is_event;
+        if( remove_crc_out_tvalid && remove_crc_out_tlast && frame_error ) begin
+            fcs_error_count <= fcs_error_count + 1;
+        end
     end
 end
 
-assign maxis_tdata  = crc_mac_out_tdata;
-assign maxis_tvalid = crc_mac_out_tvalid;
-assign crc_mac_out_tready = 1;
-assign maxis_tuser  = !(is_crc_valid && !crc_mac_out_tuser);
-assign maxis_tlast  = crc_mac_out_tlast;
-
 endmodule
 
 `default_nettype wire
@@ -3,17 +3,26 @@
 module mii_mac_tx #(
     parameter PREAMBLE_CHARACTER = 8'h55,
     parameter SFD_CHARACTER = 8'hd5,
-    parameter bit USE_RMII = 0
+    parameter bit USE_RMII = 0,
+    parameter bit USE_GMII = 0,     // mii_d is GMII TXD[7:0]
+    // Arbitration between the payload and the bypass frames. (see axis_mux)
+    parameter int MUX_POLICY = 1,
+    parameter int MUX_QUANTUM_PAYLOAD = 1514,
+    parameter int MUX_QUANTUM_BYPASS = 1514,
+    // Protects the frames from both inputs with MACsec after the arbiter. (see macsec_tx)
+    parameter bit USE_MACSEC = 0,
+    parameter int MACSEC_FIFO_DEPTH_BITS = 7,
+    parameter int MACSEC_START_THRESHOLD = 48
 ) (
     input wire clock,
     input wire aresetn,
     
     // MII output
-    output reg [3:0] mii_d,
+    output reg [(USE_GMII ? 8 : 4)-1:0] mii_d,
     output reg       mii_en,
     output reg       mii_er,
 
-    // Ethernet payload input
+    // Ethernet payload input. tuser with tlast aborts the frame with a bad FCS.
     input  wire [7:0] saxis_tdata,
     input  wire       saxis_tvalid,
     output wire       saxis_tready,
@@ -21,32 +30,229 @@ module mii_mac_tx #(
     input  wire       saxis_tlast,
 
     // Ethernet bypass input (without prepending preamble and appending FCS)
+    // tuser with tlast aborts the frame with a bad FCS. (see tx_ptp_event)
     input  wire [7:0] saxis_bypass_tdata,
     input  wire       saxis_bypass_tvalid,
     output wire       saxis_bypass_tready,
     input  wire       saxis_bypass_tuser,
-    input  wire       saxis_bypass_tlast
+    input  wire       saxis_bypass_tlast,
+
+    // MAC control frames (prepending preamble and appending FCS). Sent even while paused.
+    input  wire [7:0] saxis_control_tdata,
+    input  wire       saxis_control_tvalid,
+    output wire       saxis_control_tready,
+    input  wire       saxis_control_tlast,
+
+    // Holds the frames on the payload and bypass inputs at the frame boundary. (IEEE 802.3x PAUSE)
+    input  wire       pause,
+
+    // Holds the frames of the payload (including MAC control) and the bypass in front of the arbiter
+    // at the frame boundary. (IEEE 802.1Qbv gates, see tx_gate_control)
+    input  wire       gate_hold_payload,
+    input  wire       gate_hold_bypass,
+
+    // Time base
+    input  wire [47:0] time_seconds,
+    input  wire [31:0] time_nanoseconds,
+
+    // PTP event messages from the bypass input (from both inputs with USE_MACSEC, see tx_ptp_event_inst)
+    input  wire          ptp_one_step,
+    output wire [127:0]  ptp_event_maxis_tdata,
+    output wire          ptp_event_maxis_tvalid,
+    input  wire          ptp_event_maxis_tready,
+
+    // Arbitration counters of the payload (including MAC control) and the bypass frames
+    output wire [31:0]   payload_grant_count,
+    output wire [31:0]   bypass_grant_count,
+    output wire [31:0]   payload_wait_cycles,
+    output wire [31:0]   bypass_wait_cycles,
+    output wire [31:0]   payload_starvation_count,
+    output wire [31:0]   bypass_starvation_count,
+
+    // MACsec registers (see macsec_tx). They do not respond unless USE_MACSEC.
+    input  wire  [7:0]   macsec_s_axi_awaddr,
+    input  wire          macsec_s_axi_awvalid,
+    output wire          macsec_s_axi_awready,
+    input  wire  [31:0]  macsec_s_axi_wdata,
+    input  wire  [3:0]   macsec_s_axi_wstrb,
+    input  wire          macsec_s_axi_wvalid,
+    output wire          macsec_s_axi_wready,
+    output wire  [1:0]   macsec_s_axi_bresp,
+    output wire          macsec_s_axi_bvalid,
+    input  wire          macsec_s_axi_bready,
+    input  wire  [7:0]   macsec_s_axi_araddr,
+    input  wire          macsec_s_axi_arvalid,
+    output wire          macsec_s_axi_arready,
+    output wire  [31:0]  macsec_s_axi_rdata,
+    output wire  [1:0]   macsec_s_axi_rresp,
+    output wire          macsec_s_axi_rvalid,
+    input  wire          macsec_s_axi_rready
 );
 
-logic [7:0] append_crc_out_tdata;
-logic       append_crc_out_tvalid;
-logic       append_crc_out_tready;
-logic       append_crc_out_tuser = 0;
-logic       append_crc_out_tlast;
+// Time of the last transmitted SFD.
+logic        sfd;
+logic [47:0] sfd_seconds;
+logic [31:0] sfd_nanoseconds;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        sfd_seconds <= 0;
+        sfd_nanoseconds <= 0;
+    end
+    else if( sfd ) begin
+        sfd_seconds <= time_seconds;
+        sfd_nanoseconds <= time_nanoseconds;
+    end
+end
 
-append_crc append_crc_inst (
+logic [7:0] payload_gate_out_tdata;
+logic       payload_gate_out_tvalid;
+logic       payload_gate_out_tready;
+logic       payload_gate_out_tuser;
+logic       payload_gate_out_tlast;
+
+axis_frame_gate payload_gate_inst (
     .clock(clock),
     .aresetn(aresetn),
 
+    .hold(pause),
+
     .saxis_tdata(saxis_tdata),
     .saxis_tvalid(saxis_tvalid),
     .saxis_tready(saxis_tready),
     .saxis_tuser(saxis_tuser),
     .saxis_tlast(saxis_tlast),
 
+    .maxis_tdata(payload_gate_out_tdata),
+    .maxis_tvalid(payload_gate_out_tvalid),
+    .maxis_tready(payload_gate_out_tready),
+    .maxis_tuser(payload_gate_out_tuser),
+    .maxis_tlast(payload_gate_out_tlast)
+);
+
+// The transmit timestamp of NTP replies is written on the payload path. With MACsec, the frames are buffered
+// after the arbiter, so it is just before the line instead (see macsec_block).
+logic [7:0] timestamp_insert_in_tdata;
+logic       timestamp_insert_in_tvalid;
+logic       timestamp_insert_in_tready;
+logic       timestamp_insert_in_tuser;
+logic       timestamp_insert_in_tlast;
+
+logic [7:0] timestamp_insert_out_tdata;
+logic       timestamp_insert_out_tvalid;
+logic       timestamp_insert_out_tready;
+logic       timestamp_insert_out_tuser;
+logic       timestamp_insert_out_tlast;
+
+tx_timestamp_insert #(
+    .LINE_SIDE(USE_MACSEC)
+) tx_timestamp_insert_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+
+    .timestamp_seconds(sfd_seconds),
+    .timestamp_nanoseconds(sfd_nanoseconds),
+
+    .saxis_tdata(timestamp_insert_in_tdata),
+    .saxis_tvalid(timestamp_insert_in_tvalid),
+    .saxis_tready(timestamp_insert_in_tready),
+    .saxis_tuser(timestamp_insert_in_tuser),
+    .saxis_tlast(timestamp_insert_in_tlast),
+
+    .maxis_tdata(timestamp_insert_out_tdata),
+    .maxis_tvalid(timestamp_insert_out_tvalid),
+    .maxis_tready(timestamp_insert_out_tready),
+    .maxis_tuser(timestamp_insert_out_tuser),
+    .maxis_tlast(timestamp_insert_out_tlast)
+);
+
+logic [7:0] payload_timestamp_out_tdata;
+logic       payload_timestamp_out_tvalid;
+logic       payload_timestamp_out_tready;
+logic       payload_timestamp_out_tuser;
+logic       payload_timestamp_out_tlast;
+
+if( !USE_MACSEC ) begin :payload_timestamp_insert_block
+    assign timestamp_insert_in_tdata = payload_gate_out_tdata;
+    assign timestamp_insert_in_tvalid = payload_gate_out_tvalid;
+    assign payload_gate_out_tready = timestamp_insert_in_tready;
+    assign timestamp_insert_in_tuser = payload_gate_out_tuser;
+    assign timestamp_insert_in_tlast = payload_gate_out_tlast;
+
+    assign payload_timestamp_out_tdata = timestamp_insert_out_tdata;
+    assign payload_timestamp_out_tvalid = timestamp_insert_out_tvalid;
+    assign timestamp_insert_out_tready = payload_timestamp_out_tready;
+    assign payload_timestamp_out_tuser = timestamp_insert_out_tuser;
+    assign payload_timestamp_out_tlast = timestamp_insert_out_tlast;
+end
+else begin :no_payload_timestamp_insert_block
+    assign payload_timestamp_out_tdata = payload_gate_out_tdata;
+    assign payload_timestamp_out_tvalid = payload_gate_out_tvalid;
+    assign payload_gate_out_tready = payload_timestamp_out_tready;
+    assign payload_timestamp_out_tuser = payload_gate_out_tuser;
+    assign payload_timestamp_out_tlast = payload_gate_out_tlast;
+end
+
+// MAC control frames take precedence over the payload.
+logic [7:0] control_mux_out_tdata;
+logic       control_mux_out_tvalid;
+logic       control_mux_out_tready;
+logic       control_mux_out_tuser;
+logic       control_mux_out_tlast;
+
+axis_mux control_mux_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+
+    .saxis_0_tdata(saxis_control_tdata),
+    .saxis_0_tvalid(saxis_control_tvalid),
+    .saxis_0_tready(saxis_control_tready),
+    .saxis_0_tuser(1'b0),
+    .saxis_0_tlast(saxis_control_tlast),
+
+    .saxis_1_tdata(payload_timestamp_out_tdata),
+    .saxis_1_tvalid(payload_timestamp_out_tvalid),
+    .saxis_1_tready(payload_timestamp_out_tready),
+    .saxis_1_tuser(payload_timestamp_out_tuser),
+    .saxis_1_tlast(payload_timestamp_out_tlast),
+
+    .maxis_tdata(control_mux_out_tdata),
+    .maxis_tvalid(control_mux_out_tvalid),
+    .maxis_tready(control_mux_out_tready),
+    .maxis_tuser(control_mux_out_tuser),
+    .maxis_tlast(control_mux_out_tlast),
+
+    .grant_count_0(),
+    .grant_count_1(),
+    .wait_cycles_0(),
+    .wait_cycles_1(),
+    .starvation_count_0(),
+    .starvation_count_1()
+);
+
+logic [7:0] append_crc_out_tdata;
+logic       append_crc_out_tvalid;
+logic       append_crc_out_tready;
+logic       append_crc_out_tuser;
+logic       append_crc_out_tlast;
+
+append_crc #(
+    .ABORT_ON_TUSER(1)
+) append_crc_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+
+    .saxis_tdata(control_mux_out_tdata),
+    .saxis_tvalid(control_mux_out_tvalid),
+    .saxis_tready(control_mux_out_tready),
+    .saxis_tkeep(1'b1),
+    .saxis_tuser(control_mux_out_tuser),
+    .saxis_tlast(control_mux_out_tlast),
+
     .maxis_tdata(append_crc_out_tdata),
     .maxis_tvalid(append_crc_out_tvalid),
     .maxis_tready(append_crc_out_tready),
+    .maxis_tkeep(),
     .maxis_tuser(append_crc_out_tuser),
     .maxis_tlast(append_crc_out_tlast)
 );
@@ -54,7 +260,7 @@ append_crc append_crc_inst (
 logic [7:0] prepend_preamble_out_tdata;
 logic       prepend_preamble_out_tvalid;
 logic       prepend_preamble_out_tready;
-logic       prepend_preamble_out_tuser = 0;
+logic       prepend_preamble_out_tuser;
 logic       prepend_preamble_out_tlast;
 
 prepend_preamble #(
@@ -66,72 +272,459 @@ prepend_preamble #(
     .saxis_tdata(append_crc_out_tdata),
     .saxis_tvalid(append_crc_out_tvalid),
     .saxis_tready(append_crc_out_tready),
+    .saxis_tuser(append_crc_out_tuser),
     .saxis_tlast(append_crc_out_tlast),
 
     .maxis_tdata(prepend_preamble_out_tdata),
     .maxis_tvalid(prepend_preamble_out_tvalid),
     .maxis_tready(prepend_preamble_out_tready),
+    .maxis_tuser(prepend_preamble_out_tuser),
     .maxis_tlast(prepend_preamble_out_tlast)
 );
 
+logic [7:0] bypass_gate_out_tdata;
+logic       bypass_gate_out_tvalid;
+logic       bypass_gate_out_tready;
+logic       bypass_gate_out_tuser;
+logic       bypass_gate_out_tlast;
+
+axis_frame_gate bypass_gate_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+
+    .hold(pause),
+
+    .saxis_tdata(saxis_bypass_tdata),
+    .saxis_tvalid(saxis_bypass_tvalid),
+    .saxis_tready(saxis_bypass_tready),
+    .saxis_tuser(saxis_bypass_tuser),
+    .saxis_tlast(saxis_bypass_tlast),
+
+    .maxis_tdata(bypass_gate_out_tdata),
+    .maxis_tvalid(bypass_gate_out_tvalid),
+    .maxis_tready(bypass_gate_out_tready),
+    .maxis_tuser(bypass_gate_out_tuser),
+    .maxis_tlast(bypass_gate_out_tlast)
+);
+
+// PTP event messages are timestamped and one-step Sync messages are updated where the bytes on the wire are final.
+// Without MACsec, it is on the bypass path. With MACsec, the arbitrated frames are rewritten and buffered,
+// so it is just before the line instead (see macsec_block). Only the frames sent without the SecTAG can be parsed there,
+// and they come from both inputs.
+logic [7:0] ptp_event_in_tdata;
+logic       ptp_event_in_tvalid;
+logic       ptp_event_in_tready;
+logic       ptp_event_in_tuser;
+logic       ptp_event_in_tlast;
+
+logic [7:0] ptp_event_out_tdata;
+logic       ptp_event_out_tvalid;
+logic       ptp_event_out_tready;
+logic       ptp_event_out_tuser;
+logic       ptp_event_out_tlast;
+
+tx_ptp_event tx_ptp_event_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+
+    .one_step(ptp_one_step),
+    .timestamp_seconds(sfd_seconds),
+    .timestamp_nanoseconds(sfd_nanoseconds),
+
+    .saxis_tdata(ptp_event_in_tdata),
+    .saxis_tvalid(ptp_event_in_tvalid),
+    .saxis_tready(ptp_event_in_tready),
+    .saxis_tuser(ptp_event_in_tuser),
+    .saxis_tlast(ptp_event_in_tlast),
+
+    .maxis_tdata(ptp_event_out_tdata),
+    .maxis_tvalid(ptp_event_out_tvalid),
+    .maxis_tready(ptp_event_out_tready),
+    .maxis_tuser(ptp_event_out_tuser),
+    .maxis_tlast(ptp_event_out_tlast),
+
+    .event_maxis_tdata(ptp_event_maxis_tdata),
+    .event_maxis_tvalid(ptp_event_maxis_tvalid),
+    .event_maxis_tready(ptp_event_maxis_tready)
+);
+
+logic [7:0] bypass_ptp_out_tdata;
+logic       bypass_ptp_out_tvalid;
+logic       bypass_ptp_out_tready;
+logic       bypass_ptp_out_tuser;
+logic       bypass_ptp_out_tlast;
+
+if( !USE_MACSEC ) begin :bypass_ptp_event_block
+    assign ptp_event_in_tdata = bypass_gate_out_tdata;
+    assign ptp_event_in_tvalid = bypass_gate_out_tvalid;
+    assign bypass_gate_out_tready = ptp_event_in_tready;
+    assign ptp_event_in_tuser = bypass_gate_out_tuser;
+    assign ptp_event_in_tlast = bypass_gate_out_tlast;
+
+    assign bypass_ptp_out_tdata = ptp_event_out_tdata;
+    assign bypass_ptp_out_tvalid = ptp_event_out_tvalid;
+    assign ptp_event_out_tready = bypass_ptp_out_tready;
+    assign bypass_ptp_out_tuser = ptp_event_out_tuser;
+    assign bypass_ptp_out_tlast = ptp_event_out_tlast;
+end
+else begin :no_bypass_ptp_event_block
+    assign bypass_ptp_out_tdata = bypass_gate_out_tdata;
+    assign bypass_ptp_out_tvalid = bypass_gate_out_tvalid;
+    assign bypass_gate_out_tready = bypass_ptp_out_tready;
+    assign bypass_ptp_out_tuser = bypass_gate_out_tuser;
+    assign bypass_ptp_out_tlast = bypass_gate_out_tlast;
+end
+
+// The scheduled gates are just in front of the arbiter, so that a frame passes them when its transmission starts.
+logic [7:0] payload_schedule_out_tdata;
+logic       payload_schedule_out_tvalid;
+logic       payload_schedule_out_tready;
+logic       payload_schedule_out_tuser;
+logic       payload_schedule_out_tlast;
+
+axis_frame_gate payload_schedule_gate_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+
+    .hold(gate_hold_payload),
+
+    .saxis_tdata(prepend_preamble_out_tdata),
+    .saxis_tvalid(prepend_preamble_out_tvalid),
+    .saxis_tready(prepend_preamble_out_tready),
+    .saxis_tuser(prepend_preamble_out_tuser),
+    .saxis_tlast(prepend_preamble_out_tlast),
+
+    .maxis_tdata(payload_schedule_out_tdata),
+    .maxis_tvalid(payload_schedule_out_tvalid),
+    .maxis_tready(payload_schedule_out_tready),
+    .maxis_tuser(payload_schedule_out_tuser),
+    .maxis_tlast(payload_schedule_out_tlast)
+);
+
+logic [7:0] bypass_schedule_out_tdata;
+logic       bypass_schedule_out_tvalid;
+logic       bypass_schedule_out_tready;
+logic       bypass_schedule_out_tuser;
+logic       bypass_schedule_out_tlast;
+
+axis_frame_gate bypass_schedule_gate_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+
+    .hold(gate_hold_bypass),
+
+    .saxis_tdata(bypass_ptp_out_tdata),
+    .saxis_tvalid(bypass_ptp_out_tvalid),
+    .saxis_tready(bypass_ptp_out_tready),
+    .saxis_tuser(bypass_ptp_out_tuser),
+    .saxis_tlast(bypass_ptp_out_tlast),
+
+    .maxis_tdata(bypass_schedule_out_tdata),
+    .maxis_tvalid(bypass_schedule_out_tvalid),
+    .maxis_tready(bypass_schedule_out_tready),
+    .maxis_tuser(bypass_schedule_out_tuser),
+    .maxis_tlast(bypass_schedule_out_tlast)
+);
+
 logic [7:0] mux_out_tdata;
 logic       mux_out_tvalid;
 logic       mux_out_tready;
 logic       mux_out_tuser;
 logic       mux_out_tlast;
 
-axis_mux axis_mux_inst (
+axis_mux #(
+    .POLICY(MUX_POLICY),
+    .QUANTUM_0(MUX_QUANTUM_PAYLOAD),
+    .QUANTUM_1(MUX_QUANTUM_BYPASS)
+) axis_mux_inst (
     .clock(clock),
     .aresetn(aresetn),
 
-    .saxis_0_tdata(prepend_preamble_out_tdata),
-    .saxis_0_tvalid(prepend_preamble_out_tvalid),
-    .saxis_0_tready(prepend_preamble_out_tready),
-    .saxis_0_tuser(prepend_preamble_out_tuser),
-    .saxis_0_tlast(prepend_preamble_out_tlast),
+    .saxis_0_tdata(payload_schedule_out_tdata),
+    .saxis_0_tvalid(payload_schedule_out_tvalid),
+    .saxis_0_tready(payload_schedule_out_tready),
+    .saxis_0_tuser(payload_schedule_out_tuser),
+    .saxis_0_tlast(payload_schedule_out_tlast),
 
-    .saxis_1_tdata(saxis_bypass_tdata),
-    .saxis_1_tvalid(saxis_bypass_tvalid),
-    .saxis_1_tready(saxis_bypass_tready),
-    .saxis_1_tuser(saxis_bypass_tuser),
-    .saxis_1_tlast(saxis_bypass_tlast),
+    .saxis_1_tdata(bypass_schedule_out_tdata),
+    .saxis_1_tvalid(bypass_schedule_out_tvalid),
+    .saxis_1_tready(bypass_schedule_out_tready),
+    .saxis_1_tuser(bypass_schedule_out_tuser),
+    .saxis_1_tlast(bypass_schedule_out_tlast),
 
     .maxis_tdata(mux_out_tdata),
     .maxis_tvalid(mux_out_tvalid),
     .maxis_tready(mux_out_tready),
     .maxis_tuser(mux_out_tuser),
-    .maxis_tlast(mux_out_tlast)
+    .maxis_tlast(mux_out_tlast),
+
+    .grant_count_0(payload_grant_count),
+    .grant_count_1(bypass_grant_count),
+    .wait_cycles_0(payload_wait_cycles),
+    .wait_cycles_1(bypass_wait_cycles),
+    .starvation_count_0(payload_starvation_count),
+    .starvation_count_1(bypass_starvation_count)
 );
 
+// Frames to the PHY
+logic [7:0] line_tdata;
+logic       line_tvalid;
+logic       line_tready;
+logic       line_tlast;
+
+if( USE_MACSEC ) begin :macsec_block
+    // The preamble and the FCS of the arbitrated frames are removed, and added back after the protection.
+    // The SecTAG is inserted after the first bytes of a frame and the ICV follows its end after the tag is computed,
+    // so the protected frames are buffered in a cut-through FIFO to be sent without gaps.
+    logic [3:0] preamble_bytes;
+    wire in_preamble = preamble_bytes != 8;
+
+    logic [7:0] strip_out_tdata;
+    logic       strip_out_tvalid;
+    logic       strip_out_tready;
+
+    assign strip_out_tdata = mux_out_tdata;
+    assign strip_out_tvalid = mux_out_tvalid && !in_preamble;
+    assign mux_out_tready = in_preamble || strip_out_tready;
+
+    always_ff @(posedge clock) begin
+        if( !aresetn ) begin
+            preamble_bytes <= 0;
+        end
+        else if( mux_out_tvalid && mux_out_tready ) begin
+            if( mux_out_tlast ) begin
+                preamble_bytes <= 0;
+            end
+            else if( in_preamble ) begin
+                preamble_bytes <= preamble_bytes + 1;
+            end
+        end
+    end
+
+    logic [7:0] remove_crc_out_tdata;
+    logic       remove_crc_out_tvalid;
+    logic       remove_crc_out_tready;
+    logic       remove_crc_out_tuser;
+    logic       remove_crc_out_tlast;
+    logic       fcs_ok;
+
+    remove_crc remove_crc_inst (
+        .clock(clock),
+        .aresetn(aresetn),
+
+        .saxis_tdata (strip_out_tdata),
+        .saxis_tvalid(strip_out_tvalid),
+        .saxis_tready(strip_out_tready),
+        .saxis_tkeep (1'b1),
+        .saxis_tuser (mux_out_tuser),
+        .saxis_tlast (mux_out_tlast),
+
+        .maxis_tdata (remove_crc_out_tdata),
+        .maxis_tvalid(remove_crc_out_tvalid),
+        .maxis_tready(remove_crc_out_tready),
+        .maxis_tkeep (),
+        .maxis_tuser (remove_crc_out_tuser),
+        .maxis_tlast (remove_crc_out_tlast),
+
+        .crc(),
+        .fcs_ok(fcs_ok)
+    );
+
+    logic [7:0] macsec_out_tdata;
+    logic       macsec_out_tvalid;
+    logic       macsec_out_tready;
+    logic       macsec_out_tuser;
+    logic       macsec_out_tlast;
+
+    // Aborted frames keep being aborted with a bad FCS after the protection.
+    macsec_tx macsec_tx_inst (
+        .clock(clock),
+        .aresetn(aresetn),
+
+        .saxis_tdata (remove_crc_out_tdata),
+        .saxis_tvalid(remove_crc_out_tvalid),
+        .saxis_tready(remove_crc_out_tready),
+        .saxis_tuser (remove_crc_out_tuser || remove_crc_out_tlast && !fcs_ok),
+        .saxis_tlast (remove_crc_out_tlast),
+
+        .maxis_tdata (macsec_out_tdata),
+        .maxis_tvalid(macsec_out_tvalid),
+        .maxis_tready(macsec_out_tready),
+        .maxis_tuser (macsec_out_tuser),
+        .maxis_tlast (macsec_out_tlast),
+
+        .s_axi_awaddr(macsec_s_axi_awaddr),
+        .s_axi_awvalid(macsec_s_axi_awvalid),
+        .s_axi_awready(macsec_s_axi_awready),
+        .s_axi_wdata(macsec_s_axi_wdata),
+        .s_axi_wstrb(macsec_s_axi_wstrb),
+        .s_axi_wvalid(macsec_s_axi_wvalid),
+        .s_axi_wready(macsec_s_axi_wready),
+        .s_axi_bresp(macsec_s_axi_bresp),
+        .s_axi_bvalid(macsec_s_axi_bvalid),
+        .s_axi_bready(macsec_s_axi_bready),
+        .s_axi_araddr(macsec_s_axi_araddr),
+        .s_axi_arvalid(macsec_s_axi_arvalid),
+        .s_axi_arready(macsec_s_axi_arready),
+        .s_axi_rdata(macsec_s_axi_rdata),
+        .s_axi_rresp(macsec_s_axi_rresp),
+        .s_axi_rvalid(macsec_s_axi_rvalid),
+        .s_axi_rready(macsec_s_axi_rready)
+    );
+
+    logic [7:0] macsec_crc_out_tdata;
+    logic       macsec_crc_out_tvalid;
+    logic       macsec_crc_out_tready;
+    logic       macsec_crc_out_tlast;
+
+    append_crc #(
+        .ABORT_ON_TUSER(1)
+    ) macsec_append_crc_inst (
+        .clock(clock),
+        .aresetn(aresetn),
+
+        .saxis_tdata(macsec_out_tdata),
+        .saxis_tvalid(macsec_out_tvalid),
+        .saxis_tready(macsec_out_tready),
+        .saxis_tkeep(1'b1),
+        .saxis_tuser(macsec_out_tuser),
+        .saxis_tlast(macsec_out_tlast),
+
+        .maxis_tdata(macsec_crc_out_tdata),
+        .maxis_tvalid(macsec_crc_out_tvalid),
+        .maxis_tready(macsec_crc_out_tready),
+        .maxis_tkeep(),
+        .maxis_tuser(),
+        .maxis_tlast(macsec_crc_out_tlast)
+    );
+
+    logic [7:0] macsec_preamble_out_tdata;
+    logic       macsec_preamble_out_tvalid;
+    logic       macsec_preamble_out_tready;
+    logic       macsec_preamble_out_tlast;
+
+    prepend_preamble #(
+        .PREAMBLE(PREAMBLE_CHARACTER), .SFD(SFD_CHARACTER)
+    ) macsec_prepend_preamble_inst (
+        .clock(clock),
+        .aresetn(aresetn),
+
+        .saxis_tdata(macsec_crc_out_tdata),
+        .saxis_tvalid(macsec_crc_out_tvalid),
+        .saxis_tready(macsec_crc_out_tready),
+        .saxis_tuser(1'b0),
+        .saxis_tlast(macsec_crc_out_tlast),
+
+        .maxis_tdata(macsec_preamble_out_tdata),
+        .maxis_tvalid(macsec_preamble_out_tvalid),
+        .maxis_tready(macsec_preamble_out_tready),
+        .maxis_tuser(),
+        .maxis_tlast(macsec_preamble_out_tlast)
+    );
+
+    tx_cut_through_fifo #(
+        .DEPTH_BITS(MACSEC_FIFO_DEPTH_BITS),
+        .START_THRESHOLD(MACSEC_START_THRESHOLD)
+    ) macsec_fifo_inst (
+        .clock(clock),
+        .aresetn(aresetn),
+
+        .saxis_tdata(macsec_preamble_out_tdata),
+        .saxis_tvalid(macsec_preamble_out_tvalid),
+        .saxis_tready(macsec_preamble_out_tready),
+        .saxis_tlast(macsec_preamble_out_tlast),
+
+        .maxis_tdata(timestamp_insert_in_tdata),
+        .maxis_tvalid(timestamp_insert_in_tvalid),
+        .maxis_tready(timestamp_insert_in_tready),
+        .maxis_tuser(timestamp_insert_in_tuser),
+        .maxis_tlast(timestamp_insert_in_tlast),
+
+        .level(),
+        .underrun_count()
+    );
+
+    // NTP replies sent without the SecTAG get the transmit timestamp, then PTP event messages are processed.
+    // tx_ptp_event holds fewer octets than the offset of the transmit timestamp, so the SFD of the reply is already
+    // on the line when the timestamp passes. It also keeps aborted frames from getting a good FCS.
+    assign ptp_event_in_tdata = timestamp_insert_out_tdata;
+    assign ptp_event_in_tvalid = timestamp_insert_out_tvalid;
+    assign timestamp_insert_out_tready = ptp_event_in_tready;
+    assign ptp_event_in_tuser = timestamp_insert_out_tuser;
+    assign ptp_event_in_tlast = timestamp_insert_out_tlast;
+
+    assign line_tdata = ptp_event_out_tdata;
+    assign line_tvalid = ptp_event_out_tvalid;
+    assign ptp_event_out_tready = line_tready;
+    assign line_tlast = ptp_event_out_tlast;
+end
+else begin :no_macsec_block
+    assign line_tdata = mux_out_tdata;
+    assign line_tvalid = mux_out_tvalid;
+    assign mux_out_tready = line_tready;
+    assign line_tlast = mux_out_tlast;
+
+    // The registers of MACsec do not respond.
+    assign macsec_s_axi_awready = 0;
+    assign macsec_s_axi_wready = 0;
+    assign macsec_s_axi_bresp = 2'b00;
+    assign macsec_s_axi_bvalid = 0;
+    assign macsec_s_axi_arready = 0;
+    assign macsec_s_axi_rdata = 0;
+    assign macsec_s_axi_rresp = 2'b00;
+    assign macsec_s_axi_rvalid = 0;
+end
+
 if( USE_RMII ) begin :use_rmii_block
     axis_to_rmii axis_to_rmii_inst (
         .clock(clock),
         .aresetn(aresetn),
 
-        .saxis_tdata(mux_out_tdata),
-        .saxis_tvalid(mux_out_tvalid),
-        .saxis_tready(mux_out_tready),
-        .saxis_tlast(mux_out_tlast),
+        .saxis_tdata(line_tdata),
+        .saxis_tvalid(line_tvalid),
+        .saxis_tready(line_tready),
+        .saxis_tlast(line_tlast),
 
         .rmii_d(mii_d[1:0]),
-        .rmii_en(mii_en)
+        .rmii_en(mii_en),
+
+        .sfd(sfd)
     );
     assign mii_d[3:2] = 0;
     assign mii_er = 0;
 end
+else if( USE_GMII ) begin :use_gmii_block
+    axis_to_gmii axis_to_gmii_inst (
+        .clock(clock),
+        .aresetn(aresetn),
+
+        .saxis_tdata(line_tdata),
+        .saxis_tvalid(line_tvalid),
+        .saxis_tready(line_tready),
+        .saxis_tlast(line_tlast),
+
+        .gmii_d(mii_d),
+        .gmii_en(mii_en),
+        .gmii_er(mii_er),
+
+        .sfd(sfd)
+    );
+end
 else begin :use_mii_block
     axis_to_mii axis_to_mii_inst (
         .clock(clock),
         .aresetn(aresetn),
 
-        .saxis_tdata(mux_out_tdata),
-        .saxis_tvalid(mux_out_tvalid),
-        .saxis_tready(mux_out_tready),
-        .saxis_tlast(mux_out_tlast),
+        .saxis_tdata(line_tdata),
+        .saxis_tvalid(line_tvalid),
+        .saxis_tready(line_tready),
+        .saxis_tlast(line_tlast),
 
         .mii_d(mii_d),
         .mii_en(mii_en),
-        .mii_er(mii_er)
+        .mii_er(mii_er),
+
+        .sfd(sfd)
     );
 end
 
@@ -0,0 +1,176 @@
+`default_nettype none
+
+// Filters IPv4 multicast frames on the MII to the PS GEM.
+// The GEM receives the MII directly, so the frames are delayed by DELAY nibbles to decide
+// whether to pass the frame before its first nibble is output.
+// IPv4 multicast frames (01:00:5e:0x:xx:xx) are passed only if the bit of hash_table indexed by the hash of
+// the lower 23 bits of the group is set. The hash is the same as the one of ethernet_service.
+// Frames to 224.0.0.x (IGMP queries etc.) and the other frames are always passed.
+// hash_table is in the hash_clock domain. A change is held there and passed to clock by a request/acknowledge
+// handshake, so the filter never sees a mix of the old and the new table.
+module mii_multicast_filter #(
+    parameter int DELAY = 32    // Must be longer than the preamble, the SFD and the destination address. (28 nibbles)
+) (
+    input wire clock,
+    input wire aresetn,
+
+    input wire        hash_clock,
+    input wire [63:0] hash_table,   // hash_clock domain
+
+    input wire [3:0] mii_d,
+    input wire       mii_dv,
+
+    output logic [3:0] filtered_mii_d,
+    output logic       filtered_mii_dv
+);
+
+logic        request = 0;
+logic        acknowledge;
+logic [63:0] hash_table_hold = 0;
+logic [63:0] hash_table_sync = 0;
+
+// hash_clock domain. hash_table_hold is stable while the request is pending.
+(* ASYNC_REG = "TRUE" *) logic [1:0] acknowledge_sync = 0;
+
+always_ff @(posedge hash_clock) begin
+    acknowledge_sync <= {acknowledge_sync[0], acknowledge};
+    if( acknowledge_sync[1] == request && hash_table != hash_table_hold ) begin
+        hash_table_hold <= hash_table;
+        request <= !request;
+    end
+end
+
+// clock domain
+(* ASYNC_REG = "TRUE" *) logic [1:0] request_sync;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        request_sync <= 0;
+        acknowledge <= 0;
+    end
+    else begin
+        request_sync <= {request_sync[0], request};
+        if( request_sync[1] != acknowledge ) begin
+            hash_table_sync <= hash_table_hold;
+            acknowledge <= request_sync[1];
+        end
+    end
+end
+
+function automatic logic [5:0] hash_index(input logic [22:0] group);
+    logic [22:0] value;
+    value = group ^ (group >> 6) ^ (group >> 12) ^ (group >> 18);
+    return value[5:0];
+endfunction
+
+// Input side. Parses the destination address.
+typedef enum logic [1:0] {
+    PARSE_IDLE,
+    PARSE_PREAMBLE,
+    PARSE_DESTINATION,
+    PARSE_DONE
+} parse_state_t;
+
+parse_state_t parse_state;
+logic [47:0] destination;
+logic [3:0]  destination_count;
+logic        drop;
+logic        mii_dv_prev;
+
+wire [7:0]  destination_byte0 = destination[7:0];
+wire [7:0]  destination_byte1 = destination[15:8];
+wire [7:0]  destination_byte2 = destination[23:16];
+wire [22:0] destination_group = {destination[30:24], destination[39:32], destination[47:40]};
+wire is_ipv4_multicast = destination_byte0 == 8'h01 && destination_byte1 == 8'h00 && destination_byte2 == 8'h5e && !destination[31];
+wire is_local_group = destination_group[22:8] == 0;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        parse_state <= PARSE_IDLE;
+        destination <= 0;
+        destination_count <= 0;
+        drop <= 0;
+        mii_dv_prev <= 0;
+    end
+    else begin
+        mii_dv_prev <= mii_dv;
+        if( !mii_dv ) begin
+            parse_state <= PARSE_IDLE;
+        end
+        else begin
+            case(parse_state)
+                PARSE_IDLE: begin
+                    if( !mii_dv_prev ) begin
+                        drop <= 0;
+                        destination_count <= 0;
+                        parse_state <= mii_d == 4'hd ? PARSE_DESTINATION : PARSE_PREAMBLE;
+                    end
+                end
+                PARSE_PREAMBLE: begin
+                    if( mii_d == 4'hd ) begin
+                        parse_state <= PARSE_DESTINATION;
+                    end
+                end
+                PARSE_DESTINATION: begin
+                    destination <= {mii_d, destination[47:4]};
+                    destination_count <= destination_count + 1;
+                    if( destination_count == 11 ) begin
+                        parse_state <= PARSE_DONE;
+                    end
+                end
+                PARSE_DONE: begin
+                    if( destination_count == 12 ) begin
+                        destination_count <= 0;
+                        drop <= is_ipv4_multicast && !is_local_group && !hash_table_sync[hash_index(destination_group)];
+                    end
+                end
+                default: parse_state <= PARSE_IDLE;
+            endcase
+        end
+    end
+end
+
+// Output side. Delays the MII and latches the decision at the start of the delayed frame.
+logic [3:0] delay_d [DELAY];
+logic       delay_dv [DELAY];
+logic       output_drop;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        for(int i = 0; i < DELAY; i++ ) begin
+            delay_d[i] <= 0;
+            delay_dv[i] <= 0;
+        end
+        output_drop <= 0;
+        filtered_mii_d <= 0;
+        filtered_mii_dv <= 0;
+    end
+    else begin
+        delay_d[0] <= mii_d;
+        delay_dv[0] <= mii_dv;
+        for(int i = 1; i < DELAY; i++ ) begin
+            delay_d[i] <= delay_d[i-1];
+            delay_dv[i] <= delay_dv[i-1];
+        end
+
+        if( delay_dv[DELAY-1] && !filtered_mii_dv && !output_drop ) begin
+            // Start of a delayed frame
+            output_drop <= drop;
+            filtered_mii_dv <= !drop;
+            filtered_mii_d <= drop ? 4'h0 : delay_d[DELAY-1];
+        end
+        else if( delay_dv[DELAY-1] ) begin
+            filtered_mii_dv <= !output_drop;
+            filtered_mii_d <= output_drop ? 4'h0 : delay_d[DELAY-1];
+        end
+        else begin
+            output_drop <= 0;
+            filtered_mii_dv <= 0;
+            filtered_mii_d <= 0;
+        end
+    end
+end
+
+endmodule
+
+`default_nettype wire
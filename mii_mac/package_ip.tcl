@@ -34,12 +34,35 @@ lappend source_files {../mii_axis/axis_to_mii.sv}
 lappend source_files {../mii_axis/prepend_preamble.sv}
 lappend source_files {../mii_axis/mii_to_axis.sv}
 lappend source_files {../util/simple_fifo.v}
+lappend source_files {../util/async_fifo.v}
+lappend source_files {crc32_parallel.sv}
 lappend source_files {crc_mac.sv}
 lappend source_files {append_crc.sv}
 lappend source_files {remove_crc.sv}
+lappend source_files {rx_frame_fifo.sv}
 lappend source_files {axis_mux.sv}
 lappend source_files {mii_mac_tx.sv}
 lappend source_files {mii_mac_rx.sv}
+lappend source_files {tx_timestamp_insert.sv}
+lappend source_files {rx_timestamp.sv}
+lappend source_files {ptp_parser.sv}
+lappend source_files {tx_ptp_event.sv}
+lappend source_files {pause_parser.sv}
+lappend source_files {pause_control.sv}
+lappend source_files {axis_frame_gate.sv}
+lappend source_files {tx_gate_control.sv}
+lappend source_files {tx_bypass_shaper.sv}
+lappend source_files {mii_multicast_filter.sv}
+lappend source_files {tx_cut_through_fifo.sv}
+lappend source_files {mac_counters.sv}
+lappend source_files {../macsec/aes128_encrypt.sv}
+lappend source_files {../macsec/ghash_multiplier.sv}
+lappend source_files {../macsec/gcm_aes128.sv}
+lappend source_files {../macsec/macsec_tx.sv}
+lappend source_files {../macsec/macsec_rx.sv}
+lappend source_files {../l2_switch/mac_table.sv}
+lappend source_files {../l2_switch/l2_switch.sv}
+lappend source_files {../l2_switch/axis_frame_merge.sv}
 lappend source_files {mii_mac.sv}
 
 set constraint_files {}
@@ -93,8 +116,9 @@ set_property CORE_REVISION $core_revision $ipcore
 
 ### Add clock interfaces
 ## master
-add_clock_if tx_clock slave 25000000 {tx_xgmii:tx_saxis:tx_saxis_bypass}
-add_clock_if rx_clock slave 25000000 {rx_xgmii:rx_maxis}
+add_clock_if tx_clock slave 25000000 {tx_xgmii:tx_saxis:tx_saxis_bypass:rx_timestamp_maxis:ptp_rx_event_maxis:ptp_tx_event_maxis:tas_s_axi:shaper_s_axi:macsec_tx_s_axi:bridge_s_axi:counters_s_axi}
+add_clock_if rx_clock slave 25000000 {rx_xgmii:rx_maxis:macsec_rx_s_axi}
+add_clock_if multicast_hash_clock slave 100000000 {}
 
 ### Add reset interfaces
 # tx_reset
@@ -0,0 +1,171 @@
+`default_nettype none
+
+// IEEE 802.3x flow control.
+// PAUSE frames detected in the RX clock domain are passed to the TX clock domain by a toggle synchronizer
+// and load the pause timer. paused holds the frames of the MAC client while the timer is running.
+// While pause_request (e.g. the almost full flag of the RX FIFO) is asserted, PAUSE frames with XOFF_QUANTA are sent
+// and refreshed before the quanta expire. A PAUSE frame with zero quanta (XON) is sent when it is deasserted.
+// The generated frames on maxis have no FCS.
+module pause_control #(
+    parameter int CLOCKS_PER_QUANTUM = 128,     // 512 bit times. 128 for MII (4 bits/clock), 256 for RMII (2 bits/clock)
+    parameter bit [15:0] XOFF_QUANTA = 16'hffff
+) (
+    input wire rx_clock,
+    input wire rx_aresetn,
+
+    input wire        rx_pause_valid,
+    input wire [15:0] rx_pause_quanta,
+
+    input wire clock,
+    input wire aresetn,
+
+    input  wire [47:0] source_address,      // The first byte on the wire at [47:40]
+    input  wire        pause_request,       // Asynchronous
+
+    output logic       paused,
+
+    output logic [7:0] maxis_tdata,
+    output logic       maxis_tvalid,
+    input  wire        maxis_tready,
+    output logic       maxis_tlast
+);
+
+localparam bit [47:0] PAUSE_DESTINATION = 48'h0180c2000001;
+localparam int FRAME_BYTES = 60;
+localparam int QUANTUM_COUNTER_BITS = $clog2(CLOCKS_PER_QUANTUM);
+localparam bit [15:0] REFRESH_QUANTA = XOFF_QUANTA / 2;
+
+// RX clock domain
+logic rx_pause_toggle;
+logic [15:0] rx_quanta;
+
+always_ff @(posedge rx_clock) begin
+    if( !rx_aresetn ) begin
+        rx_pause_toggle <= 0;
+        rx_quanta <= 0;
+    end
+    else if( rx_pause_valid ) begin
+        rx_pause_toggle <= !rx_pause_toggle;
+        rx_quanta <= rx_pause_quanta;
+    end
+end
+
+// TX clock domain
+logic [2:0] pause_toggle_sync;
+logic [1:0] pause_request_sync;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        pause_toggle_sync <= 0;
+        pause_request_sync <= 0;
+    end
+    else begin
+        pause_toggle_sync <= {pause_toggle_sync[1:0], rx_pause_toggle};
+        pause_request_sync <= {pause_request_sync[0], pause_request};
+    end
+end
+
+wire pause_received = pause_toggle_sync[2] != pause_toggle_sync[1];
+
+// Pause timer. rx_quanta is stable while the toggle is synchronized.
+logic [15:0] pause_quanta;
+logic [QUANTUM_COUNTER_BITS-1:0] pause_quantum_counter;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        pause_quanta <= 0;
+        pause_quantum_counter <= 0;
+    end
+    else if( pause_received ) begin
+        pause_quanta <= rx_quanta;
+        pause_quantum_counter <= 0;
+    end
+    else if( pause_quanta != 0 ) begin
+        if( pause_quantum_counter == CLOCKS_PER_QUANTUM - 1 ) begin
+            pause_quantum_counter <= 0;
+            pause_quanta <= pause_quanta - 1;
+        end
+        else begin
+            pause_quantum_counter <= pause_quantum_counter + 1;
+        end
+    end
+end
+
+assign paused = pause_quanta != 0;
+
+// PAUSE frame generation
+logic        xoff;
+logic [15:0] refresh_quanta;
+logic [QUANTUM_COUNTER_BITS-1:0] refresh_quantum_counter;
+logic        sending;
+logic [5:0]  byte_index;
+logic [15:0] frame_quanta;
+
+function automatic logic [7:0] frame_byte(input logic [5:0] index, input logic [47:0] source, input logic [15:0] quanta);
+    if( index < 6 ) return PAUSE_DESTINATION[8*(5 - index) +: 8];
+    if( index < 12 ) return source[8*(11 - index) +: 8];
+    case(index)
+        12: return 8'h88;
+        13: return 8'h08;
+        14: return 8'h00;
+        15: return 8'h01;
+        16: return quanta[15:8];
+        17: return quanta[7:0];
+        default: return 8'h00;
+    endcase
+endfunction
+
+assign maxis_tdata = frame_byte(byte_index, source_address, frame_quanta);
+assign maxis_tvalid = sending;
+assign maxis_tlast = byte_index == FRAME_BYTES - 1;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        xoff <= 0;
+        refresh_quanta <= 0;
+        refresh_quantum_counter <= 0;
+        sending <= 0;
+        byte_index <= 0;
+        frame_quanta <= 0;
+    end
+    else begin
+        if( refresh_quanta != 0 ) begin
+            if( refresh_quantum_counter == CLOCKS_PER_QUANTUM - 1 ) begin
+                refresh_quantum_counter <= 0;
+                refresh_quanta <= refresh_quanta - 1;
+            end
+            else begin
+                refresh_quantum_counter <= refresh_quantum_counter + 1;
+            end
+        end
+
+        if( sending ) begin
+            if( maxis_tready ) begin
+                byte_index <= byte_index + 1;
+                if( maxis_tlast ) begin
+                    sending <= 0;
+                    byte_index <= 0;
+                end
+            end
+        end
+        else if( pause_request_sync[1] && (!xoff || refresh_quanta == 0) ) begin
+            // XOFF, or refresh it before the link partner resumes.
+            xoff <= 1;
+            sending <= 1;
+            frame_quanta <= XOFF_QUANTA;
+            refresh_quanta <= REFRESH_QUANTA;
+            refresh_quantum_counter <= 0;
+        end
+        else if( !pause_request_sync[1] && xoff ) begin
+            // XON
+            xoff <= 0;
+            sending <= 1;
+            frame_quanta <= 0;
+            refresh_quanta <= 0;
+        end
+    end
+end
+
+endmodule
+
+`default_nettype wire
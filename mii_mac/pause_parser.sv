@@ -0,0 +1,72 @@
+`default_nettype none
+
+// Detects IEEE 802.3x PAUSE frames in the received frames without the FCS.
+// pause_valid is asserted for a cycle after the last byte of a PAUSE frame without errors,
+// and pause_quanta holds the requested pause time until the next PAUSE frame.
+module pause_parser (
+    input wire clock,
+    input wire aresetn,
+
+    input wire [7:0] tdata,
+    input wire       tvalid,
+    input wire       tuser,     // Error. Valid with tlast.
+    input wire       tlast,
+
+    output logic        pause_valid,
+    output logic [15:0] pause_quanta
+);
+
+localparam bit [47:0] PAUSE_DESTINATION = 48'h0180c2000001;
+localparam bit [15:0] MAC_CONTROL_TYPE = 16'h8808;
+localparam bit [15:0] PAUSE_OPCODE = 16'h0001;
+
+logic [4:0]  offset;
+logic        is_pause;
+logic [15:0] quanta;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        offset <= 0;
+        is_pause <= 1;
+        quanta <= 0;
+        pause_valid <= 0;
+        pause_quanta <= 0;
+    end
+    else begin
+        pause_valid <= 0;
+        if( tvalid ) begin
+            if( offset < 6 ) begin
+                if( tdata != PAUSE_DESTINATION[8*(5 - offset) +: 8] ) is_pause <= 0;
+            end
+            else if( offset == 12 || offset == 13 ) begin
+                if( tdata != MAC_CONTROL_TYPE[8*(13 - offset) +: 8] ) is_pause <= 0;
+            end
+            else if( offset == 14 || offset == 15 ) begin
+                if( tdata != PAUSE_OPCODE[8*(15 - offset) +: 8] ) is_pause <= 0;
+            end
+            else if( offset == 16 ) begin
+                quanta[15:8] <= tdata;
+            end
+            else if( offset == 17 ) begin
+                quanta[7:0] <= tdata;
+            end
+
+            if( tlast ) begin
+                // The parameters of a PAUSE frame end at offset 17.
+                if( is_pause && offset > 17 && !tuser ) begin
+                    pause_valid <= 1;
+                    pause_quanta <= quanta;
+                end
+                offset <= 0;
+                is_pause <= 1;
+            end
+            else if( offset != 5'h1f ) begin
+                offset <= offset + 1;
+            end
+        end
+    end
+end
+
+endmodule
+
+`default_nettype wire
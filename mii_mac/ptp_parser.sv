@@ -0,0 +1,203 @@
+`default_nettype none
+
+// Recognizes IEEE 1588 (PTPv2) event messages in a frame passing through.
+// Supported encapsulations are Ethernet (EtherType 0x88f7), UDP over IPv4 and UDP over IPv6 (destination port 319),
+// with up to two VLAN tags. The frame starts from the destination MAC address.
+//
+// The fields are updated while the frame passes and hold their values after the last octet of the frame
+// until the first octet of the next frame, so they can be sampled at tlast.
+module ptp_parser (
+    input wire clock,
+    input wire aresetn,
+
+    // Octet of the frame. tvalid must be qualified with tready.
+    input wire [7:0] tdata,
+    input wire       tvalid,
+    input wire       tlast,
+
+    output logic [10:0] offset,             // Offset of the next octet from the beginning of the frame.
+
+    output wire         not_event,          // The frame has been found not to be a PTP event message.
+    output logic        is_event,           // The frame is a PTP event message. Asserted after the sequenceId.
+    output logic [1:0]  transport,          // 0: none, 1: Ethernet, 2: UDP/IPv4, 3: UDP/IPv6
+    output logic [10:0] udp_offset,         // Offset of the UDP header.
+    output logic [10:0] ptp_offset,         // Offset of the PTP header.
+    output logic [15:0] udp_checksum,
+    output logic [3:0]  message_type,
+    output logic [7:0]  domain_number,
+    output logic        two_step,
+    output logic [63:0] correction,
+    output logic [15:0] sequence_id,
+    output logic        origin_valid,       // originTimestamp has been received.
+    output logic [47:0] origin_seconds,
+    output logic [31:0] origin_nanoseconds
+);
+
+localparam bit [1:0] TRANSPORT_NONE  = 2'd0;
+localparam bit [1:0] TRANSPORT_L2    = 2'd1;
+localparam bit [1:0] TRANSPORT_UDPV4 = 2'd2;
+localparam bit [1:0] TRANSPORT_UDPV6 = 2'd3;
+
+localparam bit [15:0] PTP_EVENT_PORT = 16'd319;
+
+typedef enum {
+    S_ETHERNET,
+    S_IPV4,
+    S_IPV6,
+    S_UDP,
+    S_PTP,
+    S_OTHER
+} stage_t;
+
+stage_t stage = S_ETHERNET;
+
+logic [10:0] base;                  // Offset of the header being parsed.
+logic [10:0] relative_offset;
+logic [10:0] ethertype_offset;      // Offset of the second octet of the EtherType.
+logic [5:0]  ipv4_header_length;
+logic [7:0]  prev_tdata;
+
+assign relative_offset = offset - base;
+assign not_event = stage == S_OTHER;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        stage <= S_ETHERNET;
+        offset <= 0;
+        base <= 0;
+        ethertype_offset <= 13;
+        ipv4_header_length <= 0;
+        prev_tdata <= 0;
+        is_event <= 0;
+        transport <= TRANSPORT_NONE;
+        udp_offset <= 0;
+        ptp_offset <= 0;
+        udp_checksum <= 0;
+        message_type <= 0;
+        domain_number <= 0;
+        two_step <= 0;
+        correction <= 0;
+        sequence_id <= 0;
+        origin_valid <= 0;
+        origin_seconds <= 0;
+        origin_nanoseconds <= 0;
+    end
+    else if( tvalid ) begin
+        prev_tdata <= tdata;
+        if( tlast ) begin
+            offset <= 0;
+        end
+        else if( offset != '1 ) begin
+            offset <= offset + 1;
+        end
+
+        if( offset == 0 ) begin
+            stage <= S_ETHERNET;
+            ethertype_offset <= 13;
+            ipv4_header_length <= 0;
+            is_event <= 0;
+            transport <= TRANSPORT_NONE;
+            origin_valid <= 0;
+        end
+        else begin
+            case(stage)
+            S_ETHERNET: begin
+                if( offset == ethertype_offset ) begin
+                    base <= offset + 1;
+                    case({prev_tdata, tdata})
+                    16'h8100, 16'h88a8: begin
+                        if( ethertype_offset < 21 ) begin
+                            ethertype_offset <= ethertype_offset + 4;
+                        end
+                        else begin
+                            stage <= S_OTHER;
+                        end
+                    end
+                    16'h88f7: begin
+                        stage <= S_PTP;
+                        transport <= TRANSPORT_L2;
+                        ptp_offset <= offset + 1;
+                    end
+                    16'h0800: stage <= S_IPV4;
+                    16'h86dd: stage <= S_IPV6;
+                    default:  stage <= S_OTHER;
+                    endcase
+                end
+            end
+            S_IPV4: begin
+                case(relative_offset)
+                0: begin
+                    ipv4_header_length <= {tdata[3:0], 2'b00};
+                    if( tdata[7:4] != 4 || tdata[3:0] < 5 ) stage <= S_OTHER;
+                end
+                6: if( tdata[5:0] != 0 ) stage <= S_OTHER;     // Fragmented
+                7: if( tdata != 0 ) stage <= S_OTHER;
+                9: if( tdata != 8'h11 ) stage <= S_OTHER;      // UDP
+                default: ;
+                endcase
+                if( relative_offset == ipv4_header_length - 1 ) begin
+                    stage <= S_UDP;
+                    transport <= TRANSPORT_UDPV4;
+                    base <= offset + 1;
+                    udp_offset <= offset + 1;
+                end
+            end
+            S_IPV6: begin
+                case(relative_offset)
+                0:  if( tdata[7:4] != 6 ) stage <= S_OTHER;
+                6:  if( tdata != 8'h11 ) stage <= S_OTHER;     // Next header: UDP
+                39: begin
+                    stage <= S_UDP;
+                    transport <= TRANSPORT_UDPV6;
+                    base <= offset + 1;
+                    udp_offset <= offset + 1;
+                end
+                default: ;
+                endcase
+            end
+            S_UDP: begin
+                case(relative_offset)
+                2: if( tdata != PTP_EVENT_PORT[15:8] ) stage <= S_OTHER;   // Destination port
+                3: if( tdata != PTP_EVENT_PORT[7:0] ) stage <= S_OTHER;
+                6: udp_checksum[15:8] <= tdata;
+                7: begin
+                    udp_checksum[7:0] <= tdata;
+                    stage <= S_PTP;
+                    base <= offset + 1;
+                    ptp_offset <= offset + 1;
+                end
+                default: ;
+                endcase
+            end
+            S_PTP: begin
+                case(relative_offset)
+                0: begin
+                    message_type <= tdata[3:0];
+                    if( tdata[3:2] != 0 ) stage <= S_OTHER;    // Not an event message
+                end
+                1: if( tdata[3:0] != 2 ) stage <= S_OTHER;     // versionPTP
+                4: domain_number <= tdata;
+                6: two_step <= tdata[1];
+                8, 9, 10, 11, 12, 13, 14, 15: correction <= {correction[55:0], tdata};
+                30: sequence_id[15:8] <= tdata;
+                31: begin
+                    sequence_id[7:0] <= tdata;
+                    is_event <= 1;
+                end
+                34, 35, 36, 37, 38, 39: origin_seconds <= {origin_seconds[39:0], tdata};
+                40, 41, 42, 43: origin_nanoseconds <= {origin_nanoseconds[23:0], tdata};
+                default: ;
+                endcase
+                if( relative_offset == 43 ) begin
+                    origin_valid <= 1;
+                end
+            end
+            default: ;
+            endcase
+        end
+    end
+end
+
+endmodule
+
+`default_nettype wire
@@ -1,141 +1,163 @@
 `default_nettype none
 
-module remove_crc (
+// Removes the FCS from the frames and checks it.
+// The last 4 bytes are held back in a buffer, so the FCS is removed at any position in the last beats.
+// crc holds the removed FCS and fcs_ok tells whether it matches, both valid with the last output beat.
+// Frames not longer than the FCS are dropped.
+module remove_crc #(
+    parameter int DATA_BYTES = 1,           // 1, 2, 4 or 8
+    parameter int CRC_PIPELINE_STAGES = 0   // PIPELINE_STAGES of crc32_parallel
+) (
     input wire clock,
     input wire aresetn,
-    
-    input  wire [7:0] saxis_tdata,
-    input  wire       saxis_tvalid,
-    output reg       saxis_tready,
-    input  wire       saxis_tlast,
-    input  wire       saxis_tuser,
-
-    output reg   [7:0]  maxis_tdata,
-    output reg          maxis_tvalid,
-    input  wire         maxis_tready,
-    output reg          maxis_tlast,
-    output reg          maxis_tuser,
-
-    output reg [31:0] crc
+
+    input  wire [DATA_BYTES*8-1:0] saxis_tdata,
+    input  wire                    saxis_tvalid,
+    output wire                    saxis_tready,
+    input  wire [DATA_BYTES-1:0]   saxis_tkeep,
+    input  wire                    saxis_tlast,
+    input  wire                    saxis_tuser,
+
+    output logic [DATA_BYTES*8-1:0] maxis_tdata,
+    output logic                    maxis_tvalid,
+    input  wire                     maxis_tready,
+    output logic [DATA_BYTES-1:0]   maxis_tkeep,
+    output logic                    maxis_tlast,
+    output logic                    maxis_tuser,
+
+    output logic [31:0] crc,
+    output logic        fcs_ok
+);
+
+localparam int HOLD_BYTES = 2*DATA_BYTES + 3;
+localparam int COUNT_BITS = $clog2(HOLD_BYTES + 1);
+
+logic residue_ok;
+logic crc_valid;
+
+crc32_parallel #(.DATA_WIDTH(DATA_BYTES*8), .PIPELINE_STAGES(CRC_PIPELINE_STAGES)) crc32_parallel_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .data(saxis_tdata),
+    .keep(saxis_tkeep),
+    .valid(saxis_tvalid && saxis_tready),
+    .last(saxis_tlast),
+    .crc(),
+    .crc_valid(crc_valid),
+    .residue_ok(residue_ok)
 );
 
-logic [31:0] buffer;
+function automatic logic [COUNT_BITS-1:0] keep_count(input logic [DATA_BYTES-1:0] value);
+    keep_count = 0;
+    for(int i = 0; i < DATA_BYTES; i++ ) begin
+        if( value[i] ) keep_count = i + 1;
+    end
+endfunction
+
+logic [HOLD_BYTES*8-1:0] hold_data;
+logic [COUNT_BITS-1:0]   hold_count;
+logic                    hold_user;
 
 typedef enum {
     S_RESET,
-    S_FILL_0,
-    S_FILL_1,
-    S_FILL_2,
-    S_FILL_3,
-    S_DATA
+    S_DATA,
+    S_WAIT_CRC,
+    S_FLUSH
 } state_t;
 
 state_t state = S_RESET;
 
-always_comb begin
-    case(state)
-    S_FILL_0: saxis_tready <= 1;
-    S_FILL_1: saxis_tready <= 1;
-    S_FILL_2: saxis_tready <= 1;
-    S_FILL_3: saxis_tready <= 1;
-    S_DATA: begin
-        saxis_tready <= !maxis_tvalid || maxis_tvalid && maxis_tready && !maxis_tlast;
-    end
-    default: saxis_tready <= 0;
-    endcase
-end
+wire output_ready = !maxis_tvalid || maxis_tready;
+assign saxis_tready = state == S_DATA && output_ready;
 
+wire [COUNT_BITS-1:0]   input_count = keep_count(saxis_tkeep);
+wire [HOLD_BYTES*8-1:0] input_data = (HOLD_BYTES*8)'(saxis_tdata & ({DATA_BYTES*8 {1'b1}} >> 8*(DATA_BYTES - input_count)));
+wire [HOLD_BYTES*8-1:0] next_data = hold_data | input_data << 8*hold_count;
+wire [COUNT_BITS-1:0]   next_count = hold_count + input_count;
 
 always_ff @(posedge clock) begin
     if( !aresetn ) begin
         state <= S_RESET;
-    end 
+        maxis_tdata <= 0;
+        maxis_tvalid <= 0;
+        maxis_tkeep <= 0;
+        maxis_tlast <= 0;
+        maxis_tuser <= 0;
+        hold_data <= 0;
+        hold_count <= 0;
+        hold_user <= 0;
+        crc <= 0;
+        fcs_ok <= 0;
+    end
     else begin
+        if( maxis_tvalid && maxis_tready ) begin
+            maxis_tvalid <= 0;
+        end
+
         case( state )
         S_RESET: begin
-            state <= S_FILL_0;
-            maxis_tvalid <= 0;
-            maxis_tlast <= 0;
-            crc <= 0;
+            state <= S_DATA;
         end
-        S_FILL_0: begin
-            if( saxis_tvalid ) begin
-                buffer[7:0] <= saxis_tdata;
+        S_DATA: begin
+            if( saxis_tvalid && saxis_tready ) begin
                 if( saxis_tlast ) begin
-                    state <= S_FILL_0;
+                    // Keep the payload bytes and extract the FCS.
+                    crc <= 32'(next_data >> 8*(next_count - 4));
+                    hold_data <= next_data & ~({HOLD_BYTES*8 {1'b1}} << 8*(next_count - 4));
+                    hold_count <= next_count > 4 ? next_count - 4 : 0;
+                    hold_user <= saxis_tuser;
+                    if( crc_valid ) begin
+                        fcs_ok <= residue_ok;
+                        state <= S_FLUSH;
+                    end
+                    else begin
+                        state <= S_WAIT_CRC;
+                    end
                 end
-                else begin
-                    state <= S_FILL_1;
-                end
-            end
-        end
-        S_FILL_1: begin
-            if( saxis_tvalid ) begin
-                buffer[15:8] <= saxis_tdata;
-                if( saxis_tlast ) begin
-                    state <= S_FILL_0;
+                else if( next_count >= DATA_BYTES + 4 ) begin
+                    maxis_tvalid <= 1;
+                    maxis_tdata <= next_data[DATA_BYTES*8-1:0];
+                    maxis_tkeep <= '1;
+                    maxis_tlast <= 0;
+                    maxis_tuser <= saxis_tuser;
+                    hold_data <= next_data >> 8*DATA_BYTES;
+                    hold_count <= next_count - DATA_BYTES;
                 end
                 else begin
-                    state <= S_FILL_2;
+                    hold_data <= next_data;
+                    hold_count <= next_count;
                 end
             end
         end
-        S_FILL_2: begin
-            if( saxis_tvalid ) begin
-                buffer[23:16] <= saxis_tdata;
-                if( saxis_tlast ) begin
-                    state <= S_FILL_0;
-                end
-                else begin
-                    state <= S_FILL_3;
-                end
+        S_WAIT_CRC: begin
+            if( crc_valid ) begin
+                fcs_ok <= residue_ok;
+                state <= S_FLUSH;
             end
         end
-        S_FILL_3: begin
-            if( saxis_tvalid ) begin
-                buffer[31:24] <= saxis_tdata;
-                if( saxis_tlast ) begin
-                    state <= S_FILL_0;
-                end
-                else begin
-                    state <= S_DATA;
-                end
+        S_FLUSH: begin
+            if( hold_count == 0 ) begin
+                // Frame not longer than the FCS
+                hold_data <= 0;
+                state <= S_DATA;
             end
-        end
-        S_DATA: begin
-            if( maxis_tvalid && maxis_tready ) begin
-                if( maxis_tlast ) begin
-                    maxis_tvalid <= 0;
-                    maxis_tlast <= 0;
-                    state <= S_FILL_0;
-                end
-                else if( saxis_tvalid && saxis_tready ) begin
-                    maxis_tdata <= buffer[7:0];
-                    maxis_tvalid <= 1;
-                    maxis_tlast <= saxis_tlast;
-                    maxis_tuser <= saxis_tuser;
-                    buffer[23:0] <= buffer[31:8];
-                    buffer[31:24] <= saxis_tdata;
+            else if( output_ready ) begin
+                maxis_tvalid <= 1;
+                maxis_tdata <= hold_data[DATA_BYTES*8-1:0];
+                maxis_tkeep <= hold_count >= DATA_BYTES ? {DATA_BYTES {1'b1}} : {DATA_BYTES {1'b1}} >> (DATA_BYTES - hold_count);
+                maxis_tlast <= hold_count <= DATA_BYTES;
+                maxis_tuser <= hold_user;
+                hold_data <= hold_data >> 8*DATA_BYTES;
+                if( hold_count <= DATA_BYTES ) begin
+                    hold_count <= 0;
+                    state <= S_DATA;
                 end
                 else begin
-                    maxis_tvalid <= 0;
+                    hold_count <= hold_count - DATA_BYTES;
                 end
             end
-            else if( saxis_tvalid && saxis_tready ) begin
-                maxis_tdata <= buffer[7:0];
-                maxis_tvalid <= 1;
-                maxis_tlast <= saxis_tlast;
-                maxis_tuser <= saxis_tuser;
-                buffer[23:0] <= buffer[31:8];
-                buffer[31:24] <= saxis_tdata;
-            end
-
-            if( saxis_tvalid && saxis_tready && saxis_tlast ) begin
-                crc <= {saxis_tdata, buffer[31:8]};
-            end
         end
         endcase
-        
     end
 end
 
@@ -0,0 +1,133 @@
+`default_nettype none
+
+// Cut-through RX FIFO which drops whole frames on overflow.
+// The input comes from the line and cannot be stalled. If the FIFO is full,
+// the rest of the input frame is discarded and the bytes of it already written are removed,
+// so the frame is dropped without affecting the next frame.
+// If the output of the frame is already started (frames longer than the FIFO),
+// the frame is ended with a dummy byte with tuser asserted instead. One entry is kept free for the dummy byte.
+// frame_stored is asserted for a cycle after the end of each frame which will be output.
+// In the packet mode, a frame is output after its last byte is stored, and frames ended with tuser are dropped,
+// so that a frame found bad at its end (e.g. by the ICV of MACsec) is not output at all.
+// Frames longer than the FIFO are always dropped in the packet mode.
+module rx_frame_fifo #(
+    parameter int DEPTH_BITS = 11,
+    parameter bit PACKET_MODE = 0
+) (
+    input wire clock,
+    input wire aresetn,
+
+    input  wire [7:0] saxis_tdata,
+    input  wire       saxis_tvalid,
+    input  wire       saxis_tuser,
+    input  wire       saxis_tlast,
+
+    output wire [7:0] maxis_tdata,
+    output wire       maxis_tvalid,
+    input  wire       maxis_tready,
+    output wire       maxis_tuser,
+    output wire       maxis_tlast,
+
+    output wire  [DEPTH_BITS:0] level,  // Bytes in the FIFO including the frame being written
+    output logic        frame_stored,
+    output logic [31:0] drop_count,     // Frames dropped by overflow (not including the frames with tuser in the packet mode)
+    output logic [31:0] abort_count     // Frames ended with tuser by overflow after their output is started
+);
+
+logic [DEPTH_BITS:0] index_r;
+logic [DEPTH_BITS:0] index_w;
+logic [DEPTH_BITS:0] index_frame;   // Start of the frame being written
+logic [9:0] memory[2**DEPTH_BITS-1:0];
+
+// Output register. Read from the memory, so that the memory is inferred as a block RAM.
+logic [9:0] output_data;
+logic       output_valid;
+
+logic discarding;   // The rest of an overflowed frame is discarded
+
+wire [DEPTH_BITS:0] memory_level = index_w - index_r;
+wire memory_empty = index_r == index_w;
+wire memory_full = memory_level >= 2**DEPTH_BITS - 1;
+assign level = memory_level;
+
+assign maxis_tvalid = output_valid;
+assign maxis_tdata  = output_data[7:0];
+assign maxis_tuser  = output_data[8];
+assign maxis_tlast  = output_data[9];
+
+// In the packet mode, only the stored frames before index_frame are read.
+wire read_enable = !memory_empty && (!PACKET_MODE || index_r != index_frame) && (!output_valid || maxis_tready);
+
+// Whether the output of the frame being written is started, including the read in this cycle.
+wire [DEPTH_BITS:0] read_offset = index_r - index_frame;
+wire [DEPTH_BITS:0] frame_level = index_w - index_frame;
+wire output_started = read_offset != 0 && read_offset <= frame_level || read_enable && index_r == index_frame;
+
+wire overflow = saxis_tvalid && !discarding && memory_full;
+wire write_data = saxis_tvalid && !discarding && !memory_full;
+wire write_abort = overflow && output_started;
+wire drop = overflow && !output_started;
+wire reject = PACKET_MODE && write_data && saxis_tlast && saxis_tuser;
+wire write_enable = write_data || write_abort;
+wire [9:0] write_value = write_abort ? {1'b1, 1'b1, 8'h00} : {saxis_tlast, saxis_tuser, saxis_tdata};
+
+always_ff @(posedge clock) begin
+    if( write_enable ) begin
+        memory[index_w[DEPTH_BITS-1:0]] <= write_value;
+    end
+    if( read_enable ) begin
+        output_data <= memory[index_r[DEPTH_BITS-1:0]];
+    end
+end
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        index_r <= 0;
+        index_w <= 0;
+        index_frame <= 0;
+        output_valid <= 0;
+        discarding <= 0;
+        frame_stored <= 0;
+        drop_count <= 0;
+        abort_count <= 0;
+    end
+    else begin
+        if( read_enable ) begin
+            index_r <= index_r + 1;
+            output_valid <= 1;
+        end
+        else if( maxis_tready ) begin
+            output_valid <= 0;
+        end
+
+        frame_stored <= 0;
+        if( drop ) begin
+            index_w <= index_frame;
+            drop_count <= drop_count + 1;
+        end
+        else if( reject ) begin
+            index_w <= index_frame;
+        end
+        else if( write_enable ) begin
+            index_w <= index_w + 1;
+            if( write_value[9] ) begin
+                index_frame <= index_w + 1;
+                frame_stored <= 1;
+            end
+        end
+        if( write_abort ) begin
+            abort_count <= abort_count + 1;
+        end
+
+        if( overflow ) begin
+            discarding <= !saxis_tlast;
+        end
+        else if( discarding && saxis_tvalid && saxis_tlast ) begin
+            discarding <= 0;
+        end
+    end
+end
+
+endmodule
+
+`default_nettype wire
@@ -0,0 +1,140 @@
+`default_nettype none
+
+// Timestamps received frames at the SFD with the time base.
+// The SFD and frame_stored of mii_mac_rx are passed from the RX clock domain
+// to the time base clock domain by toggle synchronizers. The SFD captures the time and frame_stored emits it,
+// so frames dropped inside mii_mac_rx (shorter than the FCS or by overflow) emit no timestamp and
+// exactly one timestamp is emitted for each frame output from mii_mac_rx.
+// frame_stored comes at the end of the frame before the next SFD, even if the output of mii_mac_rx is stalled.
+// PTP event messages detected by mii_mac_rx also emit an event record with the SFD time of the frame on ptp_maxis.
+// The record has the same layout as the one of tx_ptp_event.
+module rx_timestamp #(
+    parameter int LATENCY_NANOSECONDS = 180     // Latency from the SFD on the MII to the capture. (2 RX clocks + 2.5 time base clocks at 25MHz)
+) (
+    input wire rx_clock,
+    input wire rx_aresetn,
+
+    input wire rx_sfd,
+    input wire rx_frame_stored,
+
+    input wire        rx_ptp_event,
+    input wire [1:0]  rx_ptp_transport,
+    input wire [3:0]  rx_ptp_message_type,
+    input wire [7:0]  rx_ptp_domain_number,
+    input wire [15:0] rx_ptp_sequence_id,
+
+    input wire clock,
+    input wire aresetn,
+
+    input wire [47:0] time_seconds,
+    input wire [31:0] time_nanoseconds,
+    input wire        time_locked,
+
+    // {15'b0, locked, seconds[47:0], nanoseconds[31:0]}
+    output logic [95:0] maxis_tdata,
+    output logic        maxis_tvalid,
+    input  wire         maxis_tready,
+
+    output logic [127:0] ptp_maxis_tdata,
+    output logic         ptp_maxis_tvalid,
+    input  wire          ptp_maxis_tready
+);
+
+localparam bit [31:0] NANOSECONDS_PER_SECOND = 32'd1000000000;
+
+// RX clock domain
+logic rx_sfd_toggle;
+logic rx_stored_toggle;
+logic rx_ptp_toggle;
+
+always_ff @(posedge rx_clock) begin
+    if( !rx_aresetn ) begin
+        rx_sfd_toggle <= 0;
+        rx_stored_toggle <= 0;
+        rx_ptp_toggle <= 0;
+    end
+    else begin
+        if( rx_sfd ) begin
+            rx_sfd_toggle <= !rx_sfd_toggle;
+        end
+        if( rx_ptp_event ) begin
+            rx_ptp_toggle <= !rx_ptp_toggle;
+        end
+        if( rx_frame_stored ) begin
+            rx_stored_toggle <= !rx_stored_toggle;
+        end
+    end
+end
+
+// Time base clock domain
+(* ASYNC_REG = "TRUE" *) logic [1:0] sfd_sync;
+(* ASYNC_REG = "TRUE" *) logic [1:0] stored_sync;
+(* ASYNC_REG = "TRUE" *) logic [1:0] ptp_sync;
+logic sfd_prev;
+logic stored_prev;
+logic ptp_prev;
+
+logic [47:0] captured_seconds;
+logic [31:0] captured_nanoseconds;
+logic        captured_locked;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        sfd_sync <= 0;
+        stored_sync <= 0;
+        ptp_sync <= 0;
+        sfd_prev <= 0;
+        stored_prev <= 0;
+        ptp_prev <= 0;
+        captured_seconds <= 0;
+        captured_nanoseconds <= 0;
+        captured_locked <= 0;
+        maxis_tdata <= 0;
+        maxis_tvalid <= 0;
+        ptp_maxis_tdata <= 0;
+        ptp_maxis_tvalid <= 0;
+    end
+    else begin
+        sfd_sync <= {sfd_sync[0], rx_sfd_toggle};
+        stored_sync <= {stored_sync[0], rx_stored_toggle};
+        sfd_prev <= sfd_sync[1];
+        stored_prev <= stored_sync[1];
+        ptp_sync <= {ptp_sync[0], rx_ptp_toggle};
+        ptp_prev <= ptp_sync[1];
+
+        if( sfd_sync[1] != sfd_prev ) begin
+            // Compensate the latency of the synchronizer.
+            if( time_nanoseconds < LATENCY_NANOSECONDS ) begin
+                captured_seconds <= time_seconds - 1;
+                captured_nanoseconds <= time_nanoseconds + NANOSECONDS_PER_SECOND - LATENCY_NANOSECONDS;
+            end
+            else begin
+                captured_seconds <= time_seconds;
+                captured_nanoseconds <= time_nanoseconds - LATENCY_NANOSECONDS;
+            end
+            captured_locked <= time_locked;
+        end
+
+        if( maxis_tvalid && maxis_tready ) begin
+            maxis_tvalid <= 0;
+        end
+        if( stored_sync[1] != stored_prev ) begin
+            maxis_tdata <= {15'b0, captured_locked, captured_seconds, captured_nanoseconds};
+            maxis_tvalid <= 1;
+        end
+
+        // The fields from the RX clock domain are stable until the next frame, which comes long after the toggle.
+        // The next SFD also comes after it, so the captured time is the one of this frame.
+        if( ptp_maxis_tvalid && ptp_maxis_tready ) begin
+            ptp_maxis_tvalid <= 0;
+        end
+        if( ptp_sync[1] != ptp_prev ) begin
+            ptp_maxis_tdata <= {18'b0, rx_ptp_transport, rx_ptp_message_type, rx_ptp_domain_number, rx_ptp_sequence_id, captured_seconds, captured_nanoseconds};
+            ptp_maxis_tvalid <= 1;
+        end
+    end
+end
+
+endmodule
+
+`default_nettype wire
@@ -15,16 +15,19 @@ module tb();
     logic        crc_appended_tuser ;
     logic        crc_appended_tlast ;
     logic [31:0] crc;
+    logic        fcs_ok;
 
-    append_crc dut_append(
+    append_crc #(.MIN_FRAME_BYTES(0)) dut_append(
         .saxis_tdata (tb_maxis_if.tdata ),
         .saxis_tvalid(tb_maxis_if.tvalid),
         .saxis_tready(tb_maxis_if.tready),
+        .saxis_tkeep (tb_maxis_if.tkeep ),
         .saxis_tuser (tb_maxis_if.tuser ),
         .saxis_tlast (tb_maxis_if.tlast ),
         .maxis_tdata (crc_appended_tdata ),
         .maxis_tvalid(crc_appended_tvalid),
         .maxis_tready(crc_appended_tready),
+        .maxis_tkeep (),
         .maxis_tuser (crc_appended_tuser ),
         .maxis_tlast (crc_appended_tlast ),
         .*
@@ -34,14 +37,17 @@ module tb();
         .saxis_tdata (crc_appended_tdata ),
         .saxis_tvalid(crc_appended_tvalid),
         .saxis_tready(crc_appended_tready),
+        .saxis_tkeep (1'b1),
         .saxis_tuser (crc_appended_tuser ),
         .saxis_tlast (crc_appended_tlast ),
         .maxis_tdata (tb_saxis_if.tdata ),
         .maxis_tvalid(tb_saxis_if.tvalid),
         .maxis_tready(tb_saxis_if.tready),
+        .maxis_tkeep (tb_saxis_if.tkeep ),
         .maxis_tuser (tb_saxis_if.tuser ),
         .maxis_tlast (tb_saxis_if.tlast ),
         .crc(crc),
+        .fcs_ok(fcs_ok),
         .*
     );
     
@@ -165,6 +171,7 @@ module tb();
                                     end else begin
                                         $info("#%02d CRC matched.", i);
                                     end
+                                    if( !fcs_ok ) $error("#%02d FCS check failed", i);
                                     if( tusers[tusers_index] != tuser ) $error("#%02d TUSER mismatch, expected: %d, actual: %d", i, tusers[tusers_index], tuser);
                                     remainder = '1;
                                     tusers_index++;
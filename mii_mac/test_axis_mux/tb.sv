@@ -0,0 +1,154 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+
+    initial begin
+        clock = 0;
+    end
+    always #(5) begin
+        clock = ~clock;
+    end
+
+    localparam int RUN_CYCLES = 20000;
+
+    // Both streams always have frames. The stream is marked in tdata[7].
+    module mux_lane #(
+        parameter int POLICY = 0,
+        parameter int QUANTUM_0 = 1514,
+        parameter int QUANTUM_1 = 1514,
+        parameter int LENGTH_0 = 50,
+        parameter int LENGTH_1 = 50
+    ) (
+        input  logic clock,
+        input  logic aresetn,
+        output bit   done
+    );
+        logic [7:0]  maxis_tdata;
+        logic        maxis_tvalid;
+        logic        maxis_tready = 1;
+        logic        maxis_tuser;
+        logic        maxis_tlast;
+        logic [7:0]  saxis_0_tdata;
+        logic        saxis_0_tvalid = 0;
+        logic        saxis_0_tready;
+        logic        saxis_0_tlast;
+        logic [7:0]  saxis_1_tdata;
+        logic        saxis_1_tvalid = 0;
+        logic        saxis_1_tready;
+        logic        saxis_1_tlast;
+        logic [31:0] grant_count_0;
+        logic [31:0] grant_count_1;
+        logic [31:0] wait_cycles_0;
+        logic [31:0] wait_cycles_1;
+        logic [31:0] starvation_count_0;
+        logic [31:0] starvation_count_1;
+
+        axis_mux #(
+            .POLICY(POLICY),
+            .QUANTUM_0(QUANTUM_0),
+            .QUANTUM_1(QUANTUM_1),
+            .STARVATION_CYCLES(1000)
+        ) dut (
+            .saxis_0_tuser(1'b0),
+            .saxis_1_tuser(1'b0),
+            .*
+        );
+
+        int index_0 = 0;
+        int index_1 = 0;
+        assign saxis_0_tdata = {1'b0, 7'(index_0)};
+        assign saxis_0_tlast = index_0 == LENGTH_0 - 1;
+        assign saxis_1_tdata = {1'b1, 7'(index_1)};
+        assign saxis_1_tlast = index_1 == LENGTH_1 - 1;
+
+        // The streams stop at their frame boundaries after stop is set.
+        bit stop = 0;
+        always @(posedge clock) begin
+            if( saxis_0_tvalid && saxis_0_tready ) begin
+                index_0 <= saxis_0_tlast ? 0 : index_0 + 1;
+                if( saxis_0_tlast && stop ) saxis_0_tvalid <= 0;
+            end
+            if( saxis_1_tvalid && saxis_1_tready ) begin
+                index_1 <= saxis_1_tlast ? 0 : index_1 + 1;
+                if( saxis_1_tlast && stop ) saxis_1_tvalid <= 0;
+            end
+        end
+
+        int  frames[2] = '{0, 0};
+        int  bytes[2] = '{0, 0};
+        int  bubbles = 0;
+        bit  sequence_ok = 1;
+        bit  started = 0;
+        bit  in_frame = 0;
+        bit  frame_port;
+        bit  last_port;
+        int  last_frame_port = -1;
+        always @(posedge clock) begin
+            if( started && !stop && !maxis_tvalid ) bubbles++;
+            if( maxis_tvalid && maxis_tready ) begin
+                started = 1;
+                if( !in_frame ) begin
+                    frame_port = maxis_tdata[7];
+                    // Round-robin alternates the streams.
+                    if( POLICY == 1 && last_frame_port == frame_port ) sequence_ok = 0;
+                    last_frame_port = frame_port;
+                end
+                if( maxis_tdata[7] != frame_port ) sequence_ok = 0;
+                bytes[frame_port]++;
+                in_frame = !maxis_tlast;
+                if( maxis_tlast ) frames[frame_port]++;
+            end
+        end
+
+        initial begin
+            done = 0;
+            @(posedge aresetn);
+            @(posedge clock);
+            saxis_0_tvalid <= 1;
+            saxis_1_tvalid <= 1;
+            repeat(RUN_CYCLES) @(posedge clock);
+            stop = 1;
+            // The stream not granted in strict priority never reaches its frame boundary.
+            if( POLICY == 0 ) saxis_1_tvalid <= 0;
+            wait(!saxis_0_tvalid && !saxis_1_tvalid);
+            repeat(4) @(posedge clock);
+
+            if( bubbles > 2 ) $error("POLICY=%0d: %0d idle cycles between frames", POLICY, bubbles);
+            if( !sequence_ok ) $error("POLICY=%0d: unexpected frame sequence", POLICY);
+            if( grant_count_0 != frames[0] || grant_count_1 != frames[1] ) $error("POLICY=%0d: grant counts %0d/%0d, frames %0d/%0d", POLICY, grant_count_0, grant_count_1, frames[0], frames[1]);
+            case( POLICY )
+            0: begin
+                if( frames[1] != 0 ) $error("strict priority: stream 1 is granted");
+                if( starvation_count_1 == 0 ) $error("strict priority: starvation of stream 1 is not counted");
+                if( wait_cycles_1 < RUN_CYCLES - 4 ) $error("strict priority: stream 1 waited for %0d cycles", wait_cycles_1);
+            end
+            1: begin
+                if( frames[0] - frames[1] > 1 || frames[1] - frames[0] > 1 ) $error("round-robin: %0d/%0d frames", frames[0], frames[1]);
+                if( starvation_count_0 != 0 || starvation_count_1 != 0 ) $error("round-robin: starvation is counted");
+            end
+            2: begin
+                real ratio = real'(bytes[0]) / real'(bytes[1]);
+                real expected = real'(QUANTUM_0) / real'(QUANTUM_1);
+                if( ratio < expected * 0.9 || ratio > expected * 1.1 ) $error("DWRR: byte ratio %f, expected %f", ratio, expected);
+            end
+            endcase
+            done = 1;
+        end
+    endmodule
+
+    bit done[3];
+
+    mux_lane #(.POLICY(0)) strict_lane (.done(done[0]), .*);
+    mux_lane #(.POLICY(1), .LENGTH_0(60), .LENGTH_1(100)) round_robin_lane (.done(done[1]), .*);
+    mux_lane #(.POLICY(2), .QUANTUM_0(300), .QUANTUM_1(100), .LENGTH_0(64), .LENGTH_1(90)) dwrr_lane (.done(done[2]), .*);
+
+    initial begin
+        aresetn <= 0;
+        repeat(4) @(posedge clock);
+        aresetn <= 1;
+        wait(done.and() == 1);
+        $finish;
+    end
+endmodule
@@ -0,0 +1,266 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+
+    localparam [31:0] POLYNOMIAL = 32'b1110_1101_1011_1000_1000_0011_0010_0000;
+    localparam int NUMBER_OF_FRAMES = 200;
+    localparam int MIN_BYTES = 1;
+    localparam int MAX_BYTES = 80;
+
+    initial begin
+        clock = 0;
+    end
+    always #(5) begin
+        clock = ~clock;
+    end
+
+    typedef bit [7:0] frame_t[$];
+
+    function automatic bit [31:0] crc32(input frame_t data);
+        bit [31:0] remainder = '1;
+        foreach(data[i]) begin
+            remainder[7:0] ^= data[i];
+            for(int bit_index = 0; bit_index < 8; bit_index++) begin
+                remainder = remainder[0] ? (remainder >> 1) ^ POLYNOMIAL : remainder >> 1;
+            end
+        end
+        return ~remainder;
+    endfunction
+
+    function automatic frame_t random_frame();
+        frame_t frame;
+        int length = $urandom_range(MIN_BYTES, MAX_BYTES);
+        for(int i = 0; i < length; i++) frame.push_back($urandom_range(0, 255));
+        return frame;
+    endfunction
+
+    // Checks crc32_parallel with the frames with and without the FCS.
+    module crc_lane #(
+        parameter int DATA_BYTES = 1,
+        parameter int PIPELINE_STAGES = 0
+    ) (
+        input  logic clock,
+        input  logic aresetn,
+        output bit   done
+    );
+        logic [DATA_BYTES*8-1:0] data = 0;
+        logic [DATA_BYTES-1:0]   keep = 0;
+        logic                    valid = 0;
+        logic                    last = 0;
+        logic [31:0]             crc;
+        logic                    crc_valid;
+        logic                    residue_ok;
+
+        crc32_parallel #(.DATA_WIDTH(DATA_BYTES*8), .PIPELINE_STAGES(PIPELINE_STAGES)) dut (
+            .*
+        );
+
+        bit [31:0] expected_crcs[$];
+        bit        expected_residues[$];
+        int        checked = 0;
+
+        always @(posedge clock) begin
+            if( crc_valid ) begin
+                if( expected_crcs.size() == 0 ) begin
+                    $error("DATA_BYTES=%0d, PIPELINE_STAGES=%0d: unexpected crc_valid", DATA_BYTES, PIPELINE_STAGES);
+                end
+                else begin
+                    bit [31:0] expected_crc = expected_crcs.pop_front();
+                    bit        expected_residue = expected_residues.pop_front();
+                    if( crc != expected_crc ) $error("DATA_BYTES=%0d, PIPELINE_STAGES=%0d: CRC mismatch at #%0d, expected: %08x, actual: %08x", DATA_BYTES, PIPELINE_STAGES, checked, expected_crc, crc);
+                    if( residue_ok != expected_residue ) $error("DATA_BYTES=%0d, PIPELINE_STAGES=%0d: residue mismatch at #%0d", DATA_BYTES, PIPELINE_STAGES, checked);
+                    checked++;
+                end
+            end
+        end
+
+        task automatic send(input frame_t frame);
+            for(int offset = 0; offset < frame.size(); offset += DATA_BYTES) begin
+                data <= 0;
+                keep <= 0;
+                for(int i = 0; i < DATA_BYTES && offset + i < frame.size(); i++) begin
+                    data[8*i +: 8] <= frame[offset + i];
+                    keep[i] <= 1;
+                end
+                valid <= 1;
+                last <= offset + DATA_BYTES >= frame.size();
+                @(posedge clock);
+                valid <= 0;
+                repeat($urandom_range(0, 1)) @(posedge clock);
+            end
+        endtask
+
+        initial begin
+            done = 0;
+            @(posedge aresetn);
+            @(posedge clock);
+            for(int i = 0; i < NUMBER_OF_FRAMES; i++) begin
+                frame_t frame = random_frame();
+                bit [31:0] fcs = crc32(frame);
+                expected_crcs.push_back(fcs);
+                expected_residues.push_back(0);
+                send(frame);
+                for(int j = 0; j < 4; j++) frame.push_back(fcs[8*j +: 8]);
+                expected_crcs.push_back(crc32(frame));
+                expected_residues.push_back(1);
+                send(frame);
+            end
+            repeat(4) @(posedge clock);
+            if( checked != 2*NUMBER_OF_FRAMES ) $error("DATA_BYTES=%0d, PIPELINE_STAGES=%0d: %0d CRCs are output, expected %0d", DATA_BYTES, PIPELINE_STAGES, checked, 2*NUMBER_OF_FRAMES);
+            done = 1;
+        end
+    endmodule
+
+    // Appends and removes the FCS on a multi-byte datapath.
+    // Frames shorter than MIN_FRAME_BYTES (64 with a VLAN tag) are expected to be padded with zeros.
+    module append_remove_lane #(
+        parameter int DATA_BYTES = 8,
+        parameter int PIPELINE_STAGES = 1,
+        parameter int MIN_FRAME_BYTES = 0
+    ) (
+        input  logic clock,
+        input  logic aresetn,
+        output bit   done
+    );
+        logic [DATA_BYTES*8-1:0] in_tdata = 0;
+        logic                    in_tvalid = 0;
+        logic                    in_tready;
+        logic [DATA_BYTES-1:0]   in_tkeep = 0;
+        logic                    in_tlast = 0;
+        logic                    in_tuser = 0;
+        logic [DATA_BYTES*8-1:0] fcs_tdata;
+        logic                    fcs_tvalid;
+        logic                    fcs_tready;
+        logic [DATA_BYTES-1:0]   fcs_tkeep;
+        logic                    fcs_tlast;
+        logic                    fcs_tuser;
+        logic [DATA_BYTES*8-1:0] out_tdata;
+        logic                    out_tvalid;
+        logic                    out_tready = 0;
+        logic [DATA_BYTES-1:0]   out_tkeep;
+        logic                    out_tlast;
+        logic                    out_tuser;
+        logic [31:0]             crc;
+        logic                    fcs_ok;
+
+        append_crc #(.DATA_BYTES(DATA_BYTES), .CRC_PIPELINE_STAGES(PIPELINE_STAGES), .MIN_FRAME_BYTES(MIN_FRAME_BYTES)) dut_append (
+            .clock(clock), .aresetn(aresetn),
+            .saxis_tdata(in_tdata), .saxis_tvalid(in_tvalid), .saxis_tready(in_tready), .saxis_tkeep(in_tkeep), .saxis_tlast(in_tlast), .saxis_tuser(in_tuser),
+            .maxis_tdata(fcs_tdata), .maxis_tvalid(fcs_tvalid), .maxis_tready(fcs_tready), .maxis_tkeep(fcs_tkeep), .maxis_tlast(fcs_tlast), .maxis_tuser(fcs_tuser)
+        );
+
+        remove_crc #(.DATA_BYTES(DATA_BYTES), .CRC_PIPELINE_STAGES(PIPELINE_STAGES)) dut_remove (
+            .clock(clock), .aresetn(aresetn),
+            .saxis_tdata(fcs_tdata), .saxis_tvalid(fcs_tvalid), .saxis_tready(fcs_tready), .saxis_tkeep(fcs_tkeep), .saxis_tlast(fcs_tlast), .saxis_tuser(fcs_tuser),
+            .maxis_tdata(out_tdata), .maxis_tvalid(out_tvalid), .maxis_tready(out_tready), .maxis_tkeep(out_tkeep), .maxis_tlast(out_tlast), .maxis_tuser(out_tuser),
+            .crc(crc), .fcs_ok(fcs_ok)
+        );
+
+        frame_t sent_frames[$];
+        frame_t expected_frames[$];
+        bit     sent_users[$];
+        frame_t with_fcs;
+        int     appended = 0;
+        int     received = 0;
+
+        // The frames between the two modules must have the FCS right after the payload.
+        always @(posedge clock) begin
+            if( fcs_tvalid && fcs_tready ) begin
+                for(int i = 0; i < DATA_BYTES; i++) begin
+                    if( fcs_tkeep[i] ) with_fcs.push_back(fcs_tdata[8*i +: 8]);
+                end
+                if( fcs_tlast ) begin
+                    frame_t payload = expected_frames[appended];
+                    bit [31:0] fcs = crc32(payload);
+                    for(int j = 0; j < 4; j++) payload.push_back(fcs[8*j +: 8]);
+                    if( with_fcs != payload ) $error("DATA_BYTES=%0d: frame #%0d with the FCS mismatch", DATA_BYTES, appended);
+                    with_fcs = {};
+                    appended++;
+                end
+            end
+        end
+
+        initial begin
+            frame_t receiving;
+            done = 0;
+            for(int i = 0; i < NUMBER_OF_FRAMES; i++) begin
+                frame_t frame = random_frame();
+                bit tagged = frame.size() >= 14 && i % 3 == 0;
+                if( tagged ) begin
+                    frame[12] = 8'h81;
+                    frame[13] = 8'h00;
+                end
+                sent_frames.push_back(frame);
+                while( frame.size() < (tagged && MIN_FRAME_BYTES != 0 ? 64 : MIN_FRAME_BYTES) ) frame.push_back(8'h00);
+                expected_frames.push_back(frame);
+                sent_users.push_back($urandom_range(0, 1));
+            end
+            @(posedge aresetn);
+            @(posedge clock);
+            fork
+                foreach(sent_frames[frame_index]) begin
+                    frame_t frame = sent_frames[frame_index];
+                    for(int offset = 0; offset < frame.size(); offset += DATA_BYTES) begin
+                        in_tdata <= 0;
+                        in_tkeep <= 0;
+                        for(int i = 0; i < DATA_BYTES && offset + i < frame.size(); i++) begin
+                            in_tdata[8*i +: 8] <= frame[offset + i];
+                            in_tkeep[i] <= 1;
+                        end
+                        in_tvalid <= 1;
+                        in_tlast <= offset + DATA_BYTES >= frame.size();
+                        in_tuser <= sent_users[frame_index];
+                        do @(posedge clock); while(!in_tready);
+                        in_tvalid <= 0;
+                        repeat($urandom_range(0, 1)) @(posedge clock);
+                    end
+                end
+                while(received < NUMBER_OF_FRAMES) begin
+                    out_tready <= $urandom_range(0, 3) != 0;
+                    @(posedge clock);
+                    if( out_tvalid && out_tready ) begin
+                        for(int i = 0; i < DATA_BYTES; i++) begin
+                            if( out_tkeep[i] ) receiving.push_back(out_tdata[8*i +: 8]);
+                        end
+                        if( out_tlast ) begin
+                            if( receiving != expected_frames[received] ) $error("DATA_BYTES=%0d: frame #%0d mismatch", DATA_BYTES, received);
+                            if( !fcs_ok ) $error("DATA_BYTES=%0d: frame #%0d FCS check failed", DATA_BYTES, received);
+                            if( crc != crc32(expected_frames[received]) ) $error("DATA_BYTES=%0d: frame #%0d removed FCS mismatch", DATA_BYTES, received);
+                            if( out_tuser != sent_users[received] ) $error("DATA_BYTES=%0d: frame #%0d TUSER mismatch", DATA_BYTES, received);
+                            receiving = {};
+                            received++;
+                        end
+                    end
+                end
+            join
+            done = 1;
+        end
+    endmodule
+
+    bit done [13];
+
+    crc_lane #(.DATA_BYTES(1), .PIPELINE_STAGES(0)) lane_8_0  (.done(done[0]), .*);
+    crc_lane #(.DATA_BYTES(2), .PIPELINE_STAGES(0)) lane_16_0 (.done(done[1]), .*);
+    crc_lane #(.DATA_BYTES(4), .PIPELINE_STAGES(1)) lane_32_1 (.done(done[2]), .*);
+    crc_lane #(.DATA_BYTES(8), .PIPELINE_STAGES(0)) lane_64_0 (.done(done[3]), .*);
+    crc_lane #(.DATA_BYTES(8), .PIPELINE_STAGES(1)) lane_64_1 (.done(done[4]), .*);
+    crc_lane #(.DATA_BYTES(8), .PIPELINE_STAGES(2)) lane_64_2 (.done(done[5]), .*);
+    append_remove_lane #(.DATA_BYTES(1), .PIPELINE_STAGES(2)) append_remove_8_2  (.done(done[6]), .*);
+    append_remove_lane #(.DATA_BYTES(2), .PIPELINE_STAGES(0)) append_remove_16_0 (.done(done[7]), .*);
+    append_remove_lane #(.DATA_BYTES(4), .PIPELINE_STAGES(1)) append_remove_32_1 (.done(done[8]), .*);
+    append_remove_lane #(.DATA_BYTES(8), .PIPELINE_STAGES(1)) append_remove_64_1 (.done(done[9]), .*);
+    append_remove_lane #(.DATA_BYTES(1), .PIPELINE_STAGES(0), .MIN_FRAME_BYTES(60)) pad_8_0  (.done(done[10]), .*);
+    append_remove_lane #(.DATA_BYTES(4), .PIPELINE_STAGES(2), .MIN_FRAME_BYTES(60)) pad_32_2 (.done(done[11]), .*);
+    append_remove_lane #(.DATA_BYTES(8), .PIPELINE_STAGES(1), .MIN_FRAME_BYTES(60)) pad_64_1 (.done(done[12]), .*);
+
+    initial begin
+        aresetn <= 0;
+        repeat(4) @(posedge clock);
+        aresetn <= 1;
+        wait(done.and() == 1);
+        repeat(4) @(posedge clock);
+        $finish;
+    end
+endmodule
@@ -13,6 +13,67 @@ module tb();
     logic       mii_en;
     logic       mii_er;
 
+    logic [7:0] saxis_bypass_tdata = 0;
+    logic       saxis_bypass_tvalid = 0;
+    logic       saxis_bypass_tready;
+    logic       saxis_bypass_tuser = 0;
+    logic       saxis_bypass_tlast = 0;
+
+    logic [47:0] time_seconds = 0;
+    logic [31:0] time_nanoseconds = 0;
+    logic        sfd;
+
+    logic         ptp_one_step = 0;
+    logic [127:0] ptp_event_maxis_tdata;
+    logic         ptp_event_maxis_tvalid;
+    logic         ptp_event_maxis_tready = 1;
+    logic         ptp_event;
+    logic [1:0]   ptp_transport;
+    logic [3:0]   ptp_message_type;
+    logic [7:0]   ptp_domain_number;
+    logic [15:0]  ptp_sequence_id;
+
+    logic [7:0]   saxis_control_tdata = 0;
+    logic         saxis_control_tvalid = 0;
+    logic         saxis_control_tready;
+    logic         saxis_control_tlast = 0;
+    logic         pause = 0;
+    logic         gate_hold_payload = 0;
+    logic         gate_hold_bypass = 0;
+    logic         pause_valid;
+    logic [15:0]  pause_quanta;
+
+    logic [31:0]  payload_grant_count;
+    logic [31:0]  bypass_grant_count;
+    logic [31:0]  payload_wait_cycles;
+    logic [31:0]  bypass_wait_cycles;
+    logic [31:0]  payload_starvation_count;
+    logic [31:0]  bypass_starvation_count;
+
+    logic         frame_stored;
+    logic [31:0]  overflow_drop_count;
+    logic [31:0]  overflow_abort_count;
+    logic [31:0]  fcs_error_count;
+
+    // MACsec registers of both, which do not respond without USE_MACSEC
+    logic  [7:0]  macsec_s_axi_awaddr = 0;
+    logic         macsec_s_axi_awvalid = 0;
+    wire          macsec_s_axi_awready;
+    logic [31:0]  macsec_s_axi_wdata = 0;
+    logic  [3:0]  macsec_s_axi_wstrb = 0;
+    logic         macsec_s_axi_wvalid = 0;
+    wire          macsec_s_axi_wready;
+    wire   [1:0]  macsec_s_axi_bresp;
+    wire          macsec_s_axi_bvalid;
+    logic         macsec_s_axi_bready = 0;
+    logic  [7:0]  macsec_s_axi_araddr = 0;
+    logic         macsec_s_axi_arvalid = 0;
+    wire          macsec_s_axi_arready;
+    wire  [31:0]  macsec_s_axi_rdata;
+    wire   [1:0]  macsec_s_axi_rresp;
+    wire          macsec_s_axi_rvalid;
+    logic         macsec_s_axi_rready = 0;
+
     mii_mac_tx dut_tx(
         .saxis_tdata (tb_maxis_if.tdata ),
         .saxis_tvalid(tb_maxis_if.tvalid),
@@ -25,6 +86,7 @@ module tb();
     mii_mac_rx dut_rx(
         .maxis_tdata (tb_saxis_if.tdata ),
         .maxis_tvalid(tb_saxis_if.tvalid),
+        .maxis_tready(tb_saxis_if.tready),
         .maxis_tuser (tb_saxis_if.tuser ),
         .maxis_tlast (tb_saxis_if.tlast ),
         .mii_dv(mii_en),
@@ -46,8 +108,9 @@ module tb();
         bit       tuser;
     } tv_axis;
 
-    localparam int MIN_BYTES = 60;
+    localparam int MIN_BYTES = 1;
     localparam int MAX_BYTES = 1500;
+    localparam int MIN_FRAME_BYTES = 60;    // Shorter frames are padded by the MAC.
 
     module stimuli (
         input logic clock,
@@ -75,7 +138,7 @@ module tb();
                     data_counter += 1;
                 end
 
-                // input and output must be identical.
+                // input and output must be identical except the padding.
                 for(int data_index = 0; data_index < length; data_index++ ) begin
                     tv_axis row;
                     int remaining;
@@ -84,9 +147,18 @@ module tb();
                     row.tlast = remaining == 1;
                     row.tuser = !row.tlast;
                     axis_in.push_back(row);
+                    row.tlast = row.tlast && length >= MIN_FRAME_BYTES;
+                    row.tuser = !row.tlast;
                     axis_out.push_back(row);
                     //$display("input #%04d: tdata=%02x, tlast=%d", i, row.tdata, row.tlast);
                 end
+                for(int data_index = length; data_index < MIN_FRAME_BYTES; data_index++ ) begin
+                    tv_axis row;
+                    row.tdata = 0;
+                    row.tlast = data_index == MIN_FRAME_BYTES - 1;
+                    row.tuser = !row.tlast;
+                    axis_out.push_back(row);
+                end
             end
             
             // Reset 
@@ -0,0 +1,151 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+
+    logic        hash_clock;
+    logic [63:0] hash_table;
+    logic [3:0]  mii_d = 0;
+    logic        mii_dv = 0;
+    logic [3:0]  filtered_mii_d;
+    logic        filtered_mii_dv;
+
+    mii_multicast_filter dut(
+        .*
+    );
+
+    initial begin
+        clock = 0;
+    end
+    always #(20) begin
+        clock = ~clock;
+    end
+    initial begin
+        hash_clock = 0;
+    end
+    always #(7) begin
+        hash_clock = ~hash_clock;
+    end
+
+    typedef bit [7:0] frame_t[$];
+
+    function automatic bit [5:0] hash_index(input bit [31:0] group);
+        bit [22:0] value;
+        value = group[22:0];
+        value = value ^ (value >> 6) ^ (value >> 12) ^ (value >> 18);
+        return value[5:0];
+    endfunction
+
+    // Build a frame with the preamble and the SFD. The FCS is not checked by the filter.
+    function automatic frame_t build_frame(input bit [47:0] destination, input int length);
+        frame_t frame;
+        for(int i = 0; i < 7; i++) frame.push_back(8'h55);
+        frame.push_back(8'hd5);
+        for(int i = 0; i < 6; i++) frame.push_back(destination[8*(5 - i) +: 8]);
+        for(int i = 0; i < 6; i++) frame.push_back(8'h02);
+        frame.push_back(8'h08);
+        frame.push_back(8'h00);
+        for(int i = 14; i < length; i++) frame.push_back($urandom_range(0, 255));
+        return frame;
+    endfunction
+
+    function automatic bit [47:0] multicast_mac(input bit [31:0] group);
+        return {24'h01005e, 1'b0, group[22:0]};
+    endfunction
+
+    frame_t received_frames[$];
+    frame_t receiving;
+    bit     nibble_high = 0;
+    bit [3:0] low_nibble;
+    always @(posedge clock) begin
+        if( filtered_mii_dv ) begin
+            if( nibble_high ) receiving.push_back({filtered_mii_d, low_nibble});
+            else low_nibble = filtered_mii_d;
+            nibble_high = !nibble_high;
+        end
+        else if( receiving.size() > 0 ) begin
+            received_frames.push_back(receiving);
+            receiving = {};
+            nibble_high = 0;
+        end
+    end
+
+    initial begin
+        frame_t frames[$];
+        frame_t expected_frames[$];
+        bit [31:0] ps_group = 32'hefc00102;          // 239.192.1.2, left to the PS
+        bit [31:0] other_group = 32'hefc00103;       // 239.192.1.3, not joined
+
+        hash_table = 64'b1 << hash_index(ps_group);
+        if( hash_index(ps_group) == hash_index(other_group) ) $error("test groups have the same hash");
+
+        // Unicast
+        frames.push_back(build_frame(48'h02_00_00_00_00_02, 64));
+        expected_frames.push_back(frames[$]);
+        // Joined group
+        frames.push_back(build_frame(multicast_mac(ps_group), 100));
+        expected_frames.push_back(frames[$]);
+        // Group not joined is dropped.
+        frames.push_back(build_frame(multicast_mac(other_group), 64));
+        // Local network control block (224.0.0.1) is always passed.
+        frames.push_back(build_frame(multicast_mac(32'he0000001), 64));
+        expected_frames.push_back(frames[$]);
+        // Broadcast
+        frames.push_back(build_frame(48'hff_ff_ff_ff_ff_ff, 64));
+        expected_frames.push_back(frames[$]);
+        // Not joined, back to back with the minimum IFG
+        frames.push_back(build_frame(multicast_mac(other_group), 64));
+        // IPv6 multicast is not filtered.
+        frames.push_back(build_frame(48'h33_33_00_00_00_01, 64));
+        expected_frames.push_back(frames[$]);
+
+        aresetn <= 0;
+        repeat(4) @(posedge clock);
+        aresetn <= 1;
+        repeat(4) @(posedge clock);
+
+        foreach(frames[frame_index]) begin
+            frame_t frame;
+            frame = frames[frame_index];
+            foreach(frame[i]) begin
+                for(int n = 0; n < 2; n++) begin
+                    mii_d <= frame[i][4*n +: 4];
+                    mii_dv <= 1;
+                    @(posedge clock);
+                end
+            end
+            mii_d <= 0;
+            mii_dv <= 0;
+            repeat(24) @(posedge clock);    // IFG
+        end
+        repeat(64) @(posedge clock);
+
+        if( received_frames.size() != expected_frames.size() ) $error("%0d frames are received, expected %0d", received_frames.size(), expected_frames.size());
+        foreach(expected_frames[frame_index]) begin
+            if( frame_index < received_frames.size() ) begin
+                if( received_frames[frame_index] != expected_frames[frame_index] ) $error("frame #%0d mismatch", frame_index);
+            end
+        end
+
+        // All multicast frames are passed with the all-ones table.
+        hash_table = '1;
+        received_frames = {};
+        repeat(8) @(posedge clock);
+        frames = {};
+        frames.push_back(build_frame(multicast_mac(other_group), 64));
+        foreach(frames[0][i]) begin
+            for(int n = 0; n < 2; n++) begin
+                mii_d <= frames[0][i][4*n +: 4];
+                mii_dv <= 1;
+                @(posedge clock);
+            end
+        end
+        mii_d <= 0;
+        mii_dv <= 0;
+        repeat(64) @(posedge clock);
+        if( received_frames.size() != 1 || received_frames[0] != frames[0] ) $error("frame with the all-ones table is not passed");
+
+        $finish;
+    end
+endmodule
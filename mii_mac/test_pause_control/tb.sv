@@ -0,0 +1,174 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+
+    localparam int CLOCKS_PER_QUANTUM = 4;
+    localparam bit [15:0] XOFF_QUANTA = 16'd16;
+    localparam bit [47:0] SOURCE_ADDRESS = 48'haabbccddeeff;
+
+    // PAUSE frames generated by pause_control are looped back to pause_parser.
+    logic [7:0]  pause_tdata;
+    logic        pause_tvalid;
+    logic        pause_tready = 1;
+    logic        pause_tlast;
+    logic        pause_valid;
+    logic [15:0] pause_quanta;
+    logic        pause_request = 0;
+    logic        paused;
+
+    pause_control #(
+        .CLOCKS_PER_QUANTUM(CLOCKS_PER_QUANTUM),
+        .XOFF_QUANTA(XOFF_QUANTA)
+    ) dut_control (
+        .rx_clock(clock),
+        .rx_aresetn(aresetn),
+        .rx_pause_valid(pause_valid),
+        .rx_pause_quanta(pause_quanta),
+        .clock(clock),
+        .aresetn(aresetn),
+        .source_address(SOURCE_ADDRESS),
+        .pause_request(pause_request),
+        .paused(paused),
+        .maxis_tdata(pause_tdata),
+        .maxis_tvalid(pause_tvalid),
+        .maxis_tready(pause_tready),
+        .maxis_tlast(pause_tlast)
+    );
+
+    pause_parser dut_parser (
+        .clock(clock),
+        .aresetn(aresetn),
+        .tdata(pause_tdata),
+        .tvalid(pause_tvalid && pause_tready),
+        .tuser(1'b0),
+        .tlast(pause_tlast),
+        .pause_valid(pause_valid),
+        .pause_quanta(pause_quanta)
+    );
+
+    // Payload frames held by the gate while paused.
+    logic [7:0] gate_in_tdata = 0;
+    logic       gate_in_tvalid = 0;
+    logic       gate_in_tready;
+    logic       gate_in_tlast = 0;
+    logic [7:0] gate_out_tdata;
+    logic       gate_out_tvalid;
+    logic       gate_out_tlast;
+
+    axis_frame_gate dut_gate (
+        .clock(clock),
+        .aresetn(aresetn),
+        .hold(paused),
+        .saxis_tdata(gate_in_tdata),
+        .saxis_tvalid(gate_in_tvalid),
+        .saxis_tready(gate_in_tready),
+        .saxis_tuser(1'b0),
+        .saxis_tlast(gate_in_tlast),
+        .maxis_tdata(gate_out_tdata),
+        .maxis_tvalid(gate_out_tvalid),
+        .maxis_tready(1'b1),
+        .maxis_tuser(),
+        .maxis_tlast(gate_out_tlast)
+    );
+
+    initial begin
+        clock = 0;
+    end
+    always #(20) begin
+        clock = ~clock;
+    end
+
+    typedef bit [7:0] frame_t[$];
+
+    frame_t sent_frames[$];
+    frame_t sending;
+    always @(posedge clock) begin
+        if( pause_tvalid && pause_tready ) begin
+            sending.push_back(pause_tdata);
+            if( pause_tlast ) begin
+                sent_frames.push_back(sending);
+                sending = {};
+            end
+        end
+    end
+
+    // Frame starts on the gate output while paused are errors.
+    bit gate_in_frame = 0;
+    always @(posedge clock) begin
+        if( gate_out_tvalid ) begin
+            if( !gate_in_frame && paused ) $error("frame started while paused");
+            gate_in_frame <= !gate_out_tlast;
+        end
+    end
+
+    function automatic frame_t pause_frame(input bit [15:0] quanta);
+        frame_t frame;
+        bit [7:0] header[18] = '{8'h01, 8'h80, 8'hc2, 8'h00, 8'h00, 8'h01,
+                                 SOURCE_ADDRESS[47:40], SOURCE_ADDRESS[39:32], SOURCE_ADDRESS[31:24], SOURCE_ADDRESS[23:16], SOURCE_ADDRESS[15:8], SOURCE_ADDRESS[7:0],
+                                 8'h88, 8'h08, 8'h00, 8'h01, quanta[15:8], quanta[7:0]};
+        foreach(header[i]) frame.push_back(header[i]);
+        while( frame.size() < 60 ) frame.push_back(8'h00);
+        return frame;
+    endfunction
+
+    task automatic send_payload(input int length);
+        for(int i = 0; i < length; i++) begin
+            gate_in_tdata <= i;
+            gate_in_tvalid <= 1;
+            gate_in_tlast <= i == length - 1;
+            do @(posedge clock); while(!gate_in_tready);
+        end
+        gate_in_tvalid <= 0;
+        gate_in_tlast <= 0;
+    endtask
+
+    initial begin
+        int paused_clocks;
+
+        aresetn <= 0;
+        repeat(4) @(posedge clock);
+        aresetn <= 1;
+        repeat(4) @(posedge clock);
+
+        // XOFF
+        pause_request <= 1;
+        wait(paused);
+        if( sent_frames.size() != 1 || sent_frames[0] != pause_frame(XOFF_QUANTA) ) $error("XOFF frame mismatch");
+
+        // The next frame is held until XON.
+        fork
+            send_payload(8);
+        join_none
+        // Refreshed while requested.
+        repeat(XOFF_QUANTA * CLOCKS_PER_QUANTUM * 2) @(posedge clock);
+        if( sent_frames.size() < 3 ) $error("XOFF is not refreshed, %0d frames are sent", sent_frames.size());
+        if( !paused ) $error("not paused while XOFF is refreshed");
+        if( !gate_in_tvalid ) $error("frame is not held while paused");
+
+        // XON
+        pause_request <= 0;
+        wait(!paused);
+        repeat(4) @(posedge clock);
+        if( sent_frames[$] != pause_frame(0) ) $error("XON frame mismatch");
+        wait(!gate_in_tvalid);
+
+        // The pause timer expires. XON is blocked.
+        pause_request <= 1;
+        wait(paused);
+        pause_tready <= 0;
+        pause_request <= 0;
+        paused_clocks = 0;
+        while( paused ) begin
+            @(posedge clock);
+            paused_clocks++;
+        end
+        if( paused_clocks < XOFF_QUANTA * CLOCKS_PER_QUANTUM - 1 || paused_clocks > XOFF_QUANTA * CLOCKS_PER_QUANTUM + 1 ) $error("paused for %0d clocks, expected %0d", paused_clocks, XOFF_QUANTA * CLOCKS_PER_QUANTUM);
+        pause_tready <= 1;
+
+        send_payload(8);
+        repeat(8) @(posedge clock);
+        $finish;
+    end
+endmodule
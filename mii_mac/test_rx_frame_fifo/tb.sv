@@ -0,0 +1,197 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+
+    localparam int DEPTH_BITS = 6;
+
+    logic [7:0]  saxis_tdata = 0;
+    logic        saxis_tvalid = 0;
+    logic        saxis_tuser = 0;
+    logic        saxis_tlast = 0;
+    logic [7:0]  maxis_tdata;
+    logic        maxis_tvalid;
+    logic        maxis_tready = 0;
+    logic        maxis_tuser;
+    logic        maxis_tlast;
+    logic [DEPTH_BITS:0] level;
+    logic        frame_stored;
+    logic [31:0] drop_count;
+    logic [31:0] abort_count;
+
+    rx_frame_fifo #(
+        .DEPTH_BITS(DEPTH_BITS)
+    ) dut (
+        .*
+    );
+
+    // The same input to the packet mode, whose output is not stalled.
+    logic [7:0]  packet_maxis_tdata;
+    logic        packet_maxis_tvalid;
+    logic        packet_maxis_tuser;
+    logic        packet_maxis_tlast;
+    logic        packet_frame_stored;
+    logic [31:0] packet_drop_count;
+
+    rx_frame_fifo #(
+        .DEPTH_BITS(DEPTH_BITS),
+        .PACKET_MODE(1)
+    ) packet_dut (
+        .clock(clock),
+        .aresetn(aresetn),
+        .saxis_tdata(saxis_tdata),
+        .saxis_tvalid(saxis_tvalid),
+        .saxis_tuser(saxis_tuser),
+        .saxis_tlast(saxis_tlast),
+        .maxis_tdata(packet_maxis_tdata),
+        .maxis_tvalid(packet_maxis_tvalid),
+        .maxis_tready(1'b1),
+        .maxis_tuser(packet_maxis_tuser),
+        .maxis_tlast(packet_maxis_tlast),
+        .level(),
+        .frame_stored(packet_frame_stored),
+        .drop_count(packet_drop_count),
+        .abort_count()
+    );
+
+    initial begin
+        clock = 0;
+    end
+    always #(20) begin
+        clock = ~clock;
+    end
+
+    typedef bit [7:0] frame_t[$];
+
+    frame_t received_frames[$];
+    bit     received_users[$];
+    frame_t receiving;
+    bit     input_last_written = 0;
+    bit     started_before_last[$];
+    int     stored_frames = 0;
+    always @(posedge clock) begin
+        if( maxis_tvalid && maxis_tready ) begin
+            if( receiving.size() == 0 ) started_before_last.push_back(!input_last_written);
+            receiving.push_back(maxis_tdata);
+            if( maxis_tlast ) begin
+                received_frames.push_back(receiving);
+                received_users.push_back(maxis_tuser);
+                receiving = {};
+            end
+        end
+        if( frame_stored ) stored_frames++;
+    end
+
+    frame_t packet_frames[$];
+    frame_t packet_receiving;
+    always @(posedge clock) begin
+        if( packet_maxis_tvalid ) begin
+            if( packet_receiving.size() == 0 && !input_last_written ) $error("packet mode frame #%0d is started before its last byte", packet_frames.size());
+            packet_receiving.push_back(packet_maxis_tdata);
+            if( packet_maxis_tlast ) begin
+                if( packet_maxis_tuser ) $error("packet mode frame #%0d is output with tuser", packet_frames.size());
+                packet_frames.push_back(packet_receiving);
+                packet_receiving = {};
+            end
+        end
+    end
+
+    function automatic frame_t make_frame(input int length, input int seed);
+        frame_t frame;
+        for(int i = 0; i < length; i++) frame.push_back(seed + i);
+        return frame;
+    endfunction
+
+    // Sends a frame a byte every two clocks like MII. The input cannot be stalled.
+    task automatic send(input frame_t frame, input bit user = 0);
+        input_last_written = 0;
+        foreach(frame[i]) begin
+            saxis_tdata <= frame[i];
+            saxis_tvalid <= 1;
+            saxis_tuser <= user && i == frame.size() - 1;
+            saxis_tlast <= i == frame.size() - 1;
+            @(posedge clock);
+            saxis_tvalid <= 0;
+            @(posedge clock);
+        end
+        saxis_tlast <= 0;
+        input_last_written = 1;
+        repeat(24) @(posedge clock);    // IFG and preamble
+    endtask
+
+    initial begin
+        frame_t first_frame = make_frame(40, 8'h10);
+        frame_t error_frame = make_frame(20, 8'h20);
+        frame_t held_frames[3];
+        frame_t next_frame = make_frame(20, 8'h80);
+        frame_t long_frame = make_frame(100, 8'h00);
+        frame_t last_frame = make_frame(60, 8'hc0);
+
+        foreach(held_frames[i]) held_frames[i] = make_frame(30, 8'h40 + 8'h40*i);
+
+        aresetn <= 0;
+        repeat(4) @(posedge clock);
+        aresetn <= 1;
+        repeat(4) @(posedge clock);
+
+        // Frames are output as they are received.
+        maxis_tready <= 1;
+        send(first_frame);
+        wait(received_frames.size() == 1);
+        if( received_frames[0] != first_frame || received_users[0] ) $error("first frame mismatch");
+        if( !started_before_last[0] ) $error("first frame is not started before its last byte");
+
+        // Errors are passed with tuser.
+        send(error_frame, 1);
+        wait(received_frames.size() == 2);
+        if( received_frames[1] != error_frame || !received_users[1] ) $error("error frame mismatch");
+
+        // While the output is stalled, the frame which does not fit is dropped and the next frame is kept.
+        maxis_tready <= 0;
+        foreach(held_frames[i]) send(held_frames[i]);
+        maxis_tready <= 1;
+        send(next_frame);
+        wait(received_frames.size() == 5);
+        if( received_frames[2] != held_frames[0] || received_users[2] ) $error("held frame 0 mismatch");
+        if( received_frames[3] != held_frames[1] || received_users[3] ) $error("held frame 1 mismatch");
+        if( received_frames[4] != next_frame || received_users[4] ) $error("frame after drop mismatch");
+        if( drop_count != 1 ) $error("drop_count is %0d, expected 1", drop_count);
+
+        // A frame already started is ended with tuser when the output is stalled until it overflows.
+        fork
+            send(long_frame);
+            begin
+                wait(receiving.size() == 4);
+                maxis_tready <= 0;
+                wait(input_last_written);
+                maxis_tready <= 1;
+            end
+        join
+        send(last_frame);
+        wait(received_frames.size() == 7);
+        if( !received_users[5] || received_frames[5].size() > 2**DEPTH_BITS + 4 ) $error("overflowed frame is not aborted");
+        if( received_frames[5][0:3] != long_frame[0:3] ) $error("aborted frame mismatch");
+        if( received_frames[6] != last_frame || received_users[6] ) $error("frame after abort mismatch");
+        if( abort_count != 1 ) $error("abort_count is %0d, expected 1", abort_count);
+        if( drop_count != 1 ) $error("drop_count is %0d after abort, expected 1", drop_count);
+
+        repeat(8) @(posedge clock);
+        if( receiving.size() != 0 || received_frames.size() != 7 ) $error("unexpected output");
+        if( stored_frames != 7 ) $error("frame_stored is asserted %0d times, expected 7", stored_frames);
+        if( level != 0 ) $error("level is %0d after all frames are output", level);
+
+        // The packet mode drops the error frame and the frame longer than the FIFO.
+        if( packet_frames.size() != 6 ) $error("%0d frames are output in the packet mode, expected 6", packet_frames.size());
+        else begin
+            if( packet_frames[0] != first_frame ) $error("packet mode first frame mismatch");
+            foreach(held_frames[i]) begin
+                if( packet_frames[1 + i] != held_frames[i] ) $error("packet mode held frame %0d mismatch", i);
+            end
+            if( packet_frames[4] != next_frame ) $error("packet mode next frame mismatch");
+            if( packet_frames[5] != last_frame ) $error("packet mode last frame mismatch");
+        end
+        if( packet_drop_count != 1 ) $error("packet mode drop_count is %0d, expected 1", packet_drop_count);
+        $finish;
+    end
+endmodule
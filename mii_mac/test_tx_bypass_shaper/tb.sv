@@ -0,0 +1,282 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+
+    localparam int DEPTH_BITS = 12;
+    localparam int MAX_FRAME_BYTES = 1522;
+
+    typedef bit [7:0] frame_t[$];
+
+    // Frames from the GEM, which cannot be stalled
+    logic [7:0] saxis_tdata = 0;
+    logic       saxis_tvalid = 0;
+    logic       saxis_tready;
+    logic       saxis_tlast = 0;
+
+    logic [7:0] fifo_saxis_tdata;
+    logic       fifo_saxis_tvalid;
+    logic       fifo_saxis_tlast;
+    logic [DEPTH_BITS+1:0] fifo_level;
+    logic [7:0] fifo_maxis_tdata;
+    logic       fifo_maxis_tvalid;
+    logic       fifo_maxis_tready;
+    logic       fifo_maxis_tuser;
+    logic       fifo_maxis_tlast;
+    logic [31:0] underrun_count;
+
+    logic [7:0] maxis_tdata;
+    logic       maxis_tvalid;
+    logic       maxis_tready = 0;
+    logic       maxis_tuser;
+    logic       maxis_tlast;
+
+    logic [7:0]  s_axi_awaddr;
+    logic        s_axi_awvalid;
+    logic        s_axi_awready;
+    logic [31:0] s_axi_wdata;
+    logic [3:0]  s_axi_wstrb;
+    logic        s_axi_wvalid;
+    logic        s_axi_wready;
+    logic [1:0]  s_axi_bresp;
+    logic        s_axi_bvalid;
+    logic        s_axi_bready;
+    logic [7:0]  s_axi_araddr;
+    logic        s_axi_arvalid;
+    logic        s_axi_arready;
+    logic [31:0] s_axi_rdata;
+    logic [1:0]  s_axi_rresp;
+    logic        s_axi_rvalid;
+    logic        s_axi_rready;
+
+    tx_cut_through_fifo #(
+        .DEPTH_BITS(DEPTH_BITS),
+        .START_THRESHOLD(1)
+    ) fifo_inst (
+        .clock(clock),
+        .aresetn(aresetn),
+        .saxis_tdata(fifo_saxis_tdata),
+        .saxis_tvalid(fifo_saxis_tvalid),
+        .saxis_tready(),
+        .saxis_tlast(fifo_saxis_tlast),
+        .maxis_tdata(fifo_maxis_tdata),
+        .maxis_tvalid(fifo_maxis_tvalid),
+        .maxis_tready(fifo_maxis_tready),
+        .maxis_tuser(fifo_maxis_tuser),
+        .maxis_tlast(fifo_maxis_tlast),
+        .level(fifo_level),
+        .underrun_count(underrun_count)
+    );
+
+    tx_bypass_shaper #(
+        .CLASSES(4),
+        .FIFO_LEVEL_BITS(DEPTH_BITS + 2),
+        .FIFO_BYTES(2**DEPTH_BITS),
+        .MAX_FRAME_BYTES(MAX_FRAME_BYTES),
+        .CLASS_FIFO_DEPTH_BITS(DEPTH_BITS - 5)
+    ) dut (
+        .*
+    );
+
+    initial begin
+        clock = 0;
+    end
+    always #(20) begin
+        clock = ~clock;
+    end
+
+    longint cycles = 0;
+    always @(posedge clock) begin
+        cycles++;
+    end
+
+    // The MAC takes a byte every two clocks like MII.
+    always @(posedge clock) begin
+        maxis_tready <= !maxis_tready;
+    end
+
+    frame_t received_frames[$];
+    longint received_starts[$];
+    frame_t receiving;
+    always @(posedge clock) begin
+        if( maxis_tvalid && maxis_tready ) begin
+            if( receiving.size() == 0 ) received_starts.push_back(cycles);
+            receiving.push_back(maxis_tdata);
+            if( maxis_tlast ) begin
+                if( maxis_tuser ) $error("frame #%0d is aborted", received_frames.size());
+                received_frames.push_back(receiving);
+                receiving = {};
+            end
+        end
+    end
+
+    task automatic axi_write(input logic [7:0] address, input logic [31:0] data);
+        s_axi_awaddr <= address;
+        s_axi_awvalid <= 1;
+        s_axi_wdata <= data;
+        s_axi_wstrb <= 4'hf;
+        s_axi_wvalid <= 1;
+        s_axi_bready <= 1;
+        do @(posedge clock); while(!(s_axi_awready && s_axi_wready));
+        s_axi_awvalid <= 0;
+        s_axi_wvalid <= 0;
+        do @(posedge clock); while(!s_axi_bvalid);
+        s_axi_bready <= 0;
+    endtask
+
+    task automatic axi_read(input logic [7:0] address, output logic [31:0] data);
+        s_axi_araddr <= address;
+        s_axi_arvalid <= 1;
+        s_axi_rready <= 1;
+        do @(posedge clock); while(!s_axi_arready);
+        s_axi_arvalid <= 0;
+        do @(posedge clock); while(!s_axi_rvalid);
+        data = s_axi_rdata;
+        s_axi_rready <= 0;
+    endtask
+
+    // Frame with the EtherType, optionally after a VLAN tag, and the DSCP of IPv4/IPv6.
+    function automatic frame_t make_frame(input bit [15:0] ethertype, input bit tagged, input bit [5:0] dscp, input int length, input bit [7:0] seed);
+        frame_t frame;
+        for(int i = 0; i < 6; i++) frame.push_back(8'hff);
+        for(int i = 0; i < 6; i++) frame.push_back(8'h02 + i);
+        if( tagged ) begin
+            frame.push_back(8'h81); frame.push_back(8'h00); frame.push_back(8'h00); frame.push_back(8'h01);
+        end
+        frame.push_back(ethertype[15:8]); frame.push_back(ethertype[7:0]);
+        if( ethertype == 16'h0800 ) begin
+            frame.push_back(8'h45); frame.push_back({dscp, 2'b00});
+        end
+        else if( ethertype == 16'h86dd ) begin
+            frame.push_back({4'h6, dscp[5:2]}); frame.push_back({dscp[1:0], 6'h00});
+        end
+        while( frame.size() < length ) frame.push_back(seed + frame.size());
+        return frame;
+    endfunction
+
+    // Sends the frames like the GEM, a byte every two clocks with the IFG and the preamble.
+    frame_t sending[$];
+    always begin
+        frame_t frame;
+        wait(sending.size() > 0);
+        frame = sending.pop_front();
+        foreach(frame[i]) begin
+            saxis_tdata <= frame[i];
+            saxis_tvalid <= 1;
+            saxis_tlast <= i == frame.size() - 1;
+            @(posedge clock);
+            saxis_tvalid <= 0;
+            saxis_tlast <= 0;
+            @(posedge clock);
+        end
+        repeat(2*20) @(posedge clock);
+    end
+
+    task automatic wait_received(input int count);
+        fork
+            wait(received_frames.size() >= count);
+            begin
+                repeat(200000) @(posedge clock);
+                $error("timed out waiting for %0d frames (%0d received)", count, received_frames.size());
+            end
+        join_any
+        disable fork;
+    endtask
+
+    task automatic check_received(input int index, input frame_t expected);
+        if( received_frames[index] != expected ) $error("frame #%0d mismatch, size expected: %0d, actual: %0d", index, expected.size(), received_frames[index].size());
+    endtask
+
+    initial begin
+        logic [31:0] value;
+        frame_t frames[$];
+        int base;
+        int dropped;
+
+        s_axi_awvalid <= 0;
+        s_axi_wvalid <= 0;
+        s_axi_bready <= 0;
+        s_axi_arvalid <= 0;
+        s_axi_rready <= 0;
+        aresetn <= 0;
+        repeat(4) @(posedge clock);
+        aresetn <= 1;
+        repeat(4) @(posedge clock);
+
+        // Class 0 at 1/8 bytes per clock without a burst.
+        // A 100 byte frame takes 120 bytes with the overhead, so the frames start every 960 clocks.
+        axi_write(8'h44, 32'h0000_2000);
+        axi_write(8'h48, 32'd0);
+        axi_write(8'h00, 32'h0000_0001);
+        for(int i = 0; i < 10; i++) begin
+            frames.push_back(make_frame(16'h0800, 0, 0, 100, i));
+            sending.push_back(frames[i]);
+        end
+        wait_received(10);
+        for(int i = 0; i < 10; i++) check_received(i, frames[i]);
+        for(int i = 2; i < 10; i++) begin
+            longint interval;
+            interval = received_starts[i] - received_starts[i - 1];
+            if( interval < 958 || interval > 964 ) $error("frame #%0d started %0d clocks after the previous one", i, interval);
+        end
+
+        // Class 1: PTP without tokens, class 2: DSCP EF (46).
+        axi_write(8'h44, 32'h0001_0000);
+        axi_write(8'h48, 32'd2048);
+        axi_write(8'h50, 32'h8000_88f7);
+        axi_write(8'h54, 32'h0000_0000);
+        axi_write(8'h58, 32'd0);
+        axi_write(8'h60, 32'h402e_0000);
+        axi_write(8'h00, 32'h0000_0001);
+        base = received_frames.size();
+        frames = {};
+        frames.push_back(make_frame(16'h88f7, 0, 0, 60, 8'h10));
+        frames.push_back(make_frame(16'h0800, 0, 46, 80, 8'h20));
+        frames.push_back(make_frame(16'h86dd, 1, 46, 90, 8'h30));
+        frames.push_back(make_frame(16'h88f7, 1, 0, 70, 8'h40));
+        frames.push_back(make_frame(16'h0800, 0, 0, 64, 8'h50));
+        foreach(frames[i]) sending.push_back(frames[i]);
+        wait_received(base + 3);
+        repeat(2000) @(posedge clock);
+        if( received_frames.size() != base + 3 ) $error("%0d frames passed the empty bucket", received_frames.size() - base - 3);
+        axi_read(8'h04, value);
+        if( value != 32'h0000_0101 ) $error("unexpected status %08x", value);
+        axi_read(8'h5c, value);
+        if( value != -32'sd80 ) $error("unexpected tokens of class 1 %0d", $signed(value));
+        axi_write(8'h54, 32'h0001_0000);
+        wait_received(base + 5);
+        foreach(frames[i]) check_received(base + i, frames[i]);
+
+        // Frames which may not fit in the FIFO are dropped as a whole while the head frame is held.
+        axi_write(8'h54, 32'h0000_0000);
+        axi_write(8'h00, 32'h0000_0001);
+        base = received_frames.size();
+        frames = {};
+        for(int i = 0; i < 31; i++) begin
+            frames.push_back(make_frame(16'h88f7, 0, 0, 200, i));
+            sending.push_back(frames[i]);
+        end
+        wait(sending.size() == 0);
+        repeat(1000) @(posedge clock);
+        axi_read(8'h08, value);
+        dropped = value;
+        // The first frame is sent, the next one is held and the others are buffered while the FIFO has room for a frame.
+        if( dropped != 31 - 1 - ((2**DEPTH_BITS - MAX_FRAME_BYTES) / 200 + 1) ) $error("unexpected drop count %0d", dropped);
+        if( underrun_count != 0 ) $error("FIFO underruns %0d", underrun_count);
+        axi_write(8'h54, 32'h0001_0000);
+        wait_received(base + 31 - dropped);
+        repeat(1000) @(posedge clock);
+        if( received_frames.size() != base + 31 - dropped ) $error("unexpected number of frames %0d", received_frames.size() - base);
+        for(int i = 0; i < 31 - dropped; i++) check_received(base + i, frames[i]);
+
+        // While disabled, the frames are not held.
+        axi_write(8'h54, 32'h0000_0000);
+        axi_write(8'h00, 32'h0000_0000);
+        base = received_frames.size();
+        for(int i = 0; i < 3; i++) sending.push_back(make_frame(16'h88f7, 0, 0, 100, i));
+        wait_received(base + 3);
+
+        $finish;
+    end
+endmodule
@@ -0,0 +1,213 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+
+    localparam int DEPTH_BITS = 6;
+    localparam int START_THRESHOLD = 16;
+
+    logic [7:0]  saxis_tdata = 0;
+    logic        saxis_tvalid = 0;
+    logic        saxis_tready;
+    logic        saxis_tlast = 0;
+    logic [7:0]  maxis_tdata;
+    logic        maxis_tvalid;
+    logic        maxis_tready = 0;
+    logic        maxis_tuser;
+    logic        maxis_tlast;
+    logic [DEPTH_BITS+1:0] level;
+    logic [31:0] underrun_count;
+
+    tx_cut_through_fifo #(
+        .DEPTH_BITS(DEPTH_BITS),
+        .START_THRESHOLD(START_THRESHOLD)
+    ) dut (
+        .*
+    );
+
+    // Frames from the PS GEM at the line rate with the threshold of a byte.
+    logic [7:0]  line_tdata = 0;
+    logic        line_tvalid = 0;
+    logic        line_tlast = 0;
+    logic [7:0]  line_out_tdata;
+    logic        line_out_tvalid;
+    logic        line_out_tready = 0;
+    logic        line_follow_valid = 0;    // The sink is ready only while the output is valid.
+    logic        line_out_tuser;
+    logic        line_out_tlast;
+    logic [31:0] line_underrun_count;
+    wire         line_sink_ready = line_out_tready || line_follow_valid && line_out_tvalid;
+
+    tx_cut_through_fifo #(
+        .DEPTH_BITS(DEPTH_BITS),
+        .START_THRESHOLD(1)
+    ) dut_line_rate (
+        .clock(clock),
+        .aresetn(aresetn),
+        .saxis_tdata(line_tdata),
+        .saxis_tvalid(line_tvalid),
+        .saxis_tready(),
+        .saxis_tlast(line_tlast),
+        .maxis_tdata(line_out_tdata),
+        .maxis_tvalid(line_out_tvalid),
+        .maxis_tready(line_sink_ready),
+        .maxis_tuser(line_out_tuser),
+        .maxis_tlast(line_out_tlast),
+        .level(),
+        .underrun_count(line_underrun_count)
+    );
+
+    frame_t line_received;
+    bit     line_received_user;
+    bit     line_done = 0;
+    always @(posedge clock) begin
+        if( line_out_tvalid && line_sink_ready ) begin
+            line_received.push_back(line_out_tdata);
+            if( line_out_tlast ) begin
+                line_received_user = line_out_tuser;
+                line_done = 1;
+            end
+        end
+    end
+
+    initial begin
+        clock = 0;
+    end
+    always #(20) begin
+        clock = ~clock;
+    end
+
+    // The MAC takes a byte every two clocks like MII.
+    always @(posedge clock) begin
+        maxis_tready <= !maxis_tready;
+    end
+
+    typedef bit [7:0] frame_t[$];
+
+    frame_t received_frames[$];
+    bit     received_users[$];
+    frame_t receiving;
+    bit     input_last_written = 0;
+    bit     started_before_last[$];
+    always @(posedge clock) begin
+        if( maxis_tvalid && maxis_tready ) begin
+            if( receiving.size() == 0 ) started_before_last.push_back(!input_last_written);
+            receiving.push_back(maxis_tdata);
+            if( maxis_tlast ) begin
+                received_frames.push_back(receiving);
+                received_users.push_back(maxis_tuser);
+                receiving = {};
+            end
+        end
+    end
+
+    function automatic frame_t make_frame(input int length, input int seed);
+        frame_t frame;
+        for(int i = 0; i < length; i++) frame.push_back(seed + i);
+        return frame;
+    endfunction
+
+    // Sends a frame a byte per clock, stalling for stall_clocks after stall_at bytes.
+    task automatic send(input frame_t frame, input int stall_at = -1, input int stall_clocks = 0);
+        input_last_written = 0;
+        foreach(frame[i]) begin
+            if( i == stall_at ) begin
+                saxis_tvalid <= 0;
+                repeat(stall_clocks) @(posedge clock);
+            end
+            saxis_tdata <= frame[i];
+            saxis_tvalid <= 1;
+            saxis_tlast <= i == frame.size() - 1;
+            do @(posedge clock); while(!saxis_tready);
+        end
+        saxis_tvalid <= 0;
+        saxis_tlast <= 0;
+        input_last_written = 1;
+    endtask
+
+    initial begin
+        frame_t long_frame = make_frame(48, 8'h10);
+        frame_t short_frame = make_frame(8, 8'h80);
+        frame_t aborted_frame = make_frame(40, 8'h40);
+        frame_t next_frame = make_frame(60, 8'hc0);
+
+        aresetn <= 0;
+        repeat(4) @(posedge clock);
+        aresetn <= 1;
+        repeat(4) @(posedge clock);
+
+        // A long frame starts at the threshold before its last byte is written.
+        send(long_frame);
+        wait(received_frames.size() == 1);
+        if( received_frames[0] != long_frame || received_users[0] ) $error("long frame mismatch");
+        if( !started_before_last[0] ) $error("long frame is not started before its last byte");
+
+        // A frame shorter than the threshold starts when it is complete.
+        send(short_frame);
+        wait(received_frames.size() == 2);
+        if( received_frames[1] != short_frame || received_users[1] ) $error("short frame mismatch");
+        if( started_before_last[1] ) $error("short frame is started before its last byte");
+
+        // A frame at the line rate is forwarded after the first byte without underruns.
+        fork
+            begin
+                foreach(long_frame[i]) begin
+                    line_tdata <= long_frame[i];
+                    line_tvalid <= 1;
+                    line_tlast <= i == long_frame.size() - 1;
+                    @(posedge clock);
+                    line_tvalid <= 0;
+                    @(posedge clock);
+                end
+            end
+            begin
+                int first_output_clocks = 0;
+                while( !line_out_tvalid ) begin
+                    @(posedge clock);
+                    first_output_clocks++;
+                end
+                if( first_output_clocks > 3 ) $error("line rate frame is started after %0d clocks", first_output_clocks);
+                // The preamble is output while the first bytes wait, then a byte every two clocks.
+                repeat(16) @(posedge clock);
+                while( !line_done ) begin
+                    line_out_tready <= !line_out_tready;
+                    @(posedge clock);
+                end
+                line_out_tready <= 0;
+                if( line_received != long_frame || line_received_user ) $error("line rate frame mismatch");
+                if( line_underrun_count != 0 ) $error("line rate frame underruns");
+            end
+        join
+
+        // Underrun aborts the frame and the rest of it is discarded.
+        send(aborted_frame, 24, 200);
+        send(next_frame);
+        wait(received_frames.size() == 4);
+        if( !received_users[2] || received_frames[2].size() > 25 ) $error("underrun frame is not aborted");
+        if( received_frames[2][0] != aborted_frame[0] ) $error("aborted frame mismatch");
+        if( received_frames[3] != next_frame || received_users[3] ) $error("frame after underrun mismatch");
+        if( underrun_count != 1 ) $error("underrun_count is %0d, expected 1", underrun_count);
+
+        // The FIFO runs empty in the middle of a frame while the sink is not ready. It is not an underrun.
+        line_received = {};
+        line_done = 0;
+        line_follow_valid <= 1;
+        foreach(long_frame[i]) begin
+            if( i == 8 ) repeat(20) @(posedge clock);
+            line_tdata <= long_frame[i];
+            line_tvalid <= 1;
+            line_tlast <= i == long_frame.size() - 1;
+            @(posedge clock);
+            line_tvalid <= 0;
+        end
+        wait(line_done);
+        line_follow_valid <= 0;
+        if( line_received != long_frame || line_received_user ) $error("frame stalled at the sink mismatch");
+        if( line_underrun_count != 0 ) $error("empty FIFO with the sink not ready is counted as an underrun");
+
+        repeat(8) @(posedge clock);
+        if( receiving.size() != 0 || received_frames.size() != 4 ) $error("unexpected output");
+        $finish;
+    end
+endmodule
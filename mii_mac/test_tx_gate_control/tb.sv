@@ -0,0 +1,177 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+
+    logic [47:0] time_seconds;
+    logic [31:0] time_nanoseconds;
+
+    logic hold_payload;
+    logic hold_bypass;
+
+    logic [7:0]  s_axi_awaddr;
+    logic        s_axi_awvalid;
+    logic        s_axi_awready;
+    logic [31:0] s_axi_wdata;
+    logic [3:0]  s_axi_wstrb;
+    logic        s_axi_wvalid;
+    logic        s_axi_wready;
+    logic [1:0]  s_axi_bresp;
+    logic        s_axi_bvalid;
+    logic        s_axi_bready;
+    logic [7:0]  s_axi_araddr;
+    logic        s_axi_arvalid;
+    logic        s_axi_arready;
+    logic [31:0] s_axi_rdata;
+    logic [1:0]  s_axi_rresp;
+    logic        s_axi_rvalid;
+    logic        s_axi_rready;
+
+    tx_gate_control #(
+        .ENTRIES(4)
+    ) dut (
+        .*
+    );
+
+    initial begin
+        clock = 0;
+    end
+    always #(20) begin
+        clock = ~clock;
+    end
+
+    // The time base advances 40[ns] per clock from just before a second boundary.
+    localparam longint START_TIME = 64'd5999960000;
+    longint now;
+    always_ff @(posedge clock) begin
+        if( !aresetn ) begin
+            now <= START_TIME;
+        end
+        else begin
+            now <= now + 40;
+        end
+    end
+    assign time_seconds = 48'(now / 1000000000);
+    assign time_nanoseconds = 32'(now % 1000000000);
+
+    task automatic axi_write(input logic [7:0] address, input logic [31:0] data);
+        s_axi_awaddr <= address;
+        s_axi_awvalid <= 1;
+        s_axi_wdata <= data;
+        s_axi_wstrb <= 4'hf;
+        s_axi_wvalid <= 1;
+        s_axi_bready <= 1;
+        do @(posedge clock); while(!(s_axi_awready && s_axi_wready));
+        s_axi_awvalid <= 0;
+        s_axi_wvalid <= 0;
+        do @(posedge clock); while(!s_axi_bvalid);
+        s_axi_bready <= 0;
+    endtask
+
+    task automatic axi_read(input logic [7:0] address, output logic [31:0] data);
+        s_axi_araddr <= address;
+        s_axi_arvalid <= 1;
+        s_axi_rready <= 1;
+        do @(posedge clock); while(!s_axi_arready);
+        s_axi_arvalid <= 0;
+        do @(posedge clock); while(!s_axi_rvalid);
+        data = s_axi_rdata;
+        s_axi_rready <= 0;
+    endtask
+
+    // Waits until the time reaches base + offset and checks the holds.
+    task automatic expect_holds(input longint base, input longint offset, input bit payload, input bit bypass);
+        while( now < base + offset ) @(posedge clock);
+        if( hold_payload != payload || hold_bypass != bypass ) begin
+            $error("at %0d[ns] from BASE, expected holds: %b %b, actual: %b %b", offset, payload, bypass, hold_payload, hold_bypass);
+        end
+    endtask
+
+    initial begin
+        logic [31:0] value;
+        longint base;
+
+        s_axi_awvalid <= 0;
+        s_axi_wvalid <= 0;
+        s_axi_bready <= 0;
+        s_axi_arvalid <= 0;
+        s_axi_rready <= 0;
+        aresetn <= 0;
+        repeat(4) @(posedge clock);
+        aresetn <= 1;
+        @(posedge clock);
+
+        // Disabled: both gates are open.
+        repeat(10) @(posedge clock);
+        if( hold_payload || hold_bypass ) $error("held while disabled");
+        axi_read(8'h14, value);
+        if( value != 1 ) $error("unexpected default list length %0d", value);
+        axi_write(8'h14, 32'd100);
+        axi_read(8'h14, value);
+        if( value != 4 ) $error("list length is not clamped to the entries (%0d)", value);
+
+        // Entry 0: payload only for 200[us], entry 1: bypass only for 300[us], with the guard band of 10[us].
+        // BASE is just after the second boundary, so that the guard band before BASE crosses it.
+        base = 64'd6000010000;
+        axi_write(8'h08, 32'(base / 1000000000 >> 32));
+        axi_write(8'h0c, 32'(base / 1000000000));
+        axi_write(8'h10, 32'(base % 1000000000));
+        axi_write(8'h14, 32'd2);
+        axi_write(8'h18, 32'd10000);
+        axi_write(8'h80, 32'b01);
+        axi_write(8'h84, 32'd200000);
+        axi_write(8'h88, 32'b10);
+        axi_write(8'h8c, 32'd300000);
+        axi_write(8'h00, 32'h0000_0001);
+
+        expect_holds(base, -25000, 0, 0);
+        axi_read(8'h04, value);
+        if( value != 32'h0000_0006 ) $error("unexpected status before BASE %08x", value);
+        expect_holds(base, -5000, 0, 1);        // Guard band of the first entry, which closes the bypass gate
+        expect_holds(base, 1000, 0, 1);
+        axi_read(8'h04, value);
+        if( value != 32'h0000_0013 ) $error("unexpected status in entry 0 %08x", value);
+        expect_holds(base, 185000, 0, 1);
+        expect_holds(base, 195000, 1, 1);       // Guard band of entry 1, which closes the payload gate
+        expect_holds(base, 201000, 1, 0);
+        axi_read(8'h04, value);
+        if( value != 32'h0000_010d ) $error("unexpected status in entry 1 %08x", value);
+        expect_holds(base, 485000, 1, 0);
+        expect_holds(base, 495000, 1, 1);
+        expect_holds(base, 501000, 0, 1);
+        axi_read(8'h1c, value);
+        if( value != 1 ) $error("unexpected cycle count %0d", value);
+        expect_holds(base, 1001000, 0, 1);
+        axi_read(8'h1c, value);
+        if( value != 2 ) $error("unexpected cycle count %0d", value);
+
+        // A gate open in the next entry is not held at the boundary.
+        axi_write(8'h80, 32'b11);
+        axi_write(8'h84, 32'd50000);
+        axi_write(8'h14, 32'd1);
+        base = now + 20000;
+        axi_write(8'h08, 32'(base / 1000000000 >> 32));
+        axi_write(8'h0c, 32'(base / 1000000000));
+        axi_write(8'h10, 32'(base % 1000000000));
+        axi_write(8'h00, 32'h0000_0001);
+        axi_read(8'h1c, value);
+        if( value != 0 ) $error("cycle count is not cleared by the restart (%0d)", value);
+        while( now < base + 200000 ) begin
+            @(posedge clock);
+            if( hold_payload || hold_bypass ) $error("held at %0d[ns] from BASE with both gates open", now - base);
+        end
+        axi_read(8'h1c, value);
+        if( value < 3 ) $error("unexpected cycle count %0d", value);
+
+        // Closing both gates holds them until the schedule is disabled.
+        axi_write(8'h80, 32'b00);
+        repeat(4) @(posedge clock);
+        if( !hold_payload || !hold_bypass ) $error("not held with both gates closed");
+        axi_write(8'h00, 32'h0000_0000);
+        repeat(2) @(posedge clock);
+        if( hold_payload || hold_bypass ) $error("held after disabled");
+
+        $finish;
+    end
+endmodule
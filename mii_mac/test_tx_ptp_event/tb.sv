@@ -0,0 +1,355 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+
+    axis_if #(.DATA_WIDTH(1)) tb_maxis_if(.clock(clock), .aresetn(aresetn));
+    axis_if #(.DATA_WIDTH(1)) tb_saxis_if(.clock(clock), .aresetn(aresetn));
+
+    localparam [31:0] POLYNOMIAL = 32'b1110_1101_1011_1000_1000_0011_0010_0000;
+
+    // SFD time of the frames
+    localparam bit [47:0] SFD_SECONDS = 48'd1000;
+    localparam bit [31:0] SFD_NANOSECONDS = 32'd250000000;
+
+    logic         one_step = 1;
+    logic [47:0]  timestamp_seconds = SFD_SECONDS;
+    logic [31:0]  timestamp_nanoseconds = SFD_NANOSECONDS;
+    logic [127:0] event_maxis_tdata;
+    logic         event_maxis_tvalid;
+    logic         event_maxis_tready = 1;
+
+    tx_ptp_event dut(
+        .saxis_tdata (tb_maxis_if.tdata ),
+        .saxis_tvalid(tb_maxis_if.tvalid),
+        .saxis_tready(tb_maxis_if.tready),
+        .saxis_tuser (tb_maxis_if.tuser ),
+        .saxis_tlast (tb_maxis_if.tlast ),
+        .maxis_tdata (tb_saxis_if.tdata ),
+        .maxis_tvalid(tb_saxis_if.tvalid),
+        .maxis_tready(tb_saxis_if.tready),
+        .maxis_tuser (tb_saxis_if.tuser ),
+        .maxis_tlast (tb_saxis_if.tlast ),
+        .*
+    );
+
+    initial begin
+        clock = 0;
+    end
+    always #(20) begin
+        clock = ~clock;
+    end
+
+    bit [127:0] events[$];
+    always @(posedge clock) begin
+        if( event_maxis_tvalid && event_maxis_tready ) begin
+            events.push_back(event_maxis_tdata);
+        end
+    end
+
+    typedef bit [7:0] frame_t[$];
+
+    typedef enum {
+        L2,
+        L2_VLAN,
+        UDPV4,
+        UDPV4_NO_CHECKSUM,
+        UDPV6,
+        ARP
+    } encapsulation_t;
+
+    function automatic bit [31:0] crc32(input frame_t data);
+        bit [31:0] remainder = '1;
+        foreach(data[i]) begin
+            remainder[7:0] ^= data[i];
+            for(int bit_index = 0; bit_index < 8; bit_index++) begin
+                remainder = remainder[0] ? (remainder >> 1) ^ POLYNOMIAL : remainder >> 1;
+            end
+        end
+        return ~remainder;
+    endfunction
+
+    function automatic bit [15:0] checksum(input frame_t data);
+        bit [31:0] sum = 0;
+        for(int i = 0; i < data.size(); i += 2) begin
+            sum += {data[i], i + 1 < data.size() ? data[i + 1] : 8'h00};
+        end
+        while( sum[31:16] != 0 ) sum = sum[15:0] + sum[31:16];
+        return ~sum[15:0];
+    endfunction
+
+    function automatic frame_t build_ptp(input bit [3:0] message_type, input bit two_step, input bit [63:0] correction, input bit [15:0] sequence_id, input bit [47:0] origin_seconds, input bit [31:0] origin_nanoseconds);
+        frame_t message;
+        bit [7:0] source_port_identity[10] = '{8'h02, 8'h00, 8'h00, 8'hff, 8'hfe, 8'h00, 8'h00, 8'h01, 8'h00, 8'h01};
+        message.push_back({4'h0, message_type});
+        message.push_back(8'h02);               // versionPTP
+        message.push_back(8'h00);               // messageLength
+        message.push_back(8'd44);
+        message.push_back(8'h00);               // domainNumber
+        message.push_back(8'h00);
+        message.push_back(two_step ? 8'h02 : 8'h00);
+        message.push_back(8'h00);
+        for(int i = 0; i < 8; i++) message.push_back(correction[8*(7 - i) +: 8]);
+        for(int i = 0; i < 4; i++) message.push_back(8'h00);
+        foreach(source_port_identity[i]) message.push_back(source_port_identity[i]);
+        message.push_back(sequence_id[15:8]);
+        message.push_back(sequence_id[7:0]);
+        message.push_back(message_type == 0 ? 8'h00 : 8'h01);   // controlField
+        message.push_back(8'h00);               // logMessageInterval
+        for(int i = 0; i < 6; i++) message.push_back(origin_seconds[8*(5 - i) +: 8]);
+        for(int i = 0; i < 4; i++) message.push_back(origin_nanoseconds[8*(3 - i) +: 8]);
+        return message;
+    endfunction
+
+    // Build a frame with the preamble, the SFD and the FCS.
+    function automatic frame_t build_frame(input encapsulation_t encapsulation, input frame_t payload, input bit [15:0] port);
+        frame_t frame;
+        frame_t stream;
+        bit [7:0] source_mac[6] = '{8'h02, 8'h00, 8'h00, 8'h00, 8'h00, 8'h01};
+        bit [31:0] fcs;
+
+        case(encapsulation)
+        L2, L2_VLAN, ARP: begin
+            bit [7:0] destination_mac[6] = '{8'h01, 8'h1b, 8'h19, 8'h00, 8'h00, 8'h00};
+            foreach(destination_mac[i]) frame.push_back(destination_mac[i]);
+            foreach(source_mac[i]) frame.push_back(source_mac[i]);
+            if( encapsulation == L2_VLAN ) begin
+                frame.push_back(8'h81);
+                frame.push_back(8'h00);
+                frame.push_back(8'h00);
+                frame.push_back(8'h0a);
+            end
+            frame.push_back(encapsulation == ARP ? 8'h08 : 8'h88);
+            frame.push_back(encapsulation == ARP ? 8'h06 : 8'hf7);
+            foreach(payload[i]) frame.push_back(payload[i]);
+        end
+        UDPV4, UDPV4_NO_CHECKSUM: begin
+            bit [7:0] destination_mac[6] = '{8'h01, 8'h00, 8'h5e, 8'h00, 8'h01, 8'h81};
+            bit [15:0] udp_length = 8 + payload.size();
+            bit [15:0] ip_length = 20 + udp_length;
+            bit [7:0] ip[20] = '{8'h45, 8'h00, ip_length[15:8], ip_length[7:0], 8'h00, 8'h00, 8'h40, 8'h00, 8'h01, 8'h11, 8'h00, 8'h00,
+                                 8'hc0, 8'ha8, 8'h04, 8'h03, 8'he0, 8'h00, 8'h01, 8'h81};
+            frame_t header;
+            frame_t udp;
+            bit [15:0] ip_checksum;
+            bit [15:0] udp_checksum;
+
+            foreach(ip[i]) header.push_back(ip[i]);
+            ip_checksum = checksum(header);
+            ip[10] = ip_checksum[15:8];
+            ip[11] = ip_checksum[7:0];
+
+            // Pseudo header
+            for(int i = 12; i < 20; i++) udp.push_back(ip[i]);
+            udp.push_back(8'h00);
+            udp.push_back(8'h11);
+            udp.push_back(udp_length[15:8]);
+            udp.push_back(udp_length[7:0]);
+            udp.push_back(8'h01);
+            udp.push_back(8'h3f);
+            udp.push_back(port[15:8]);
+            udp.push_back(port[7:0]);
+            udp.push_back(udp_length[15:8]);
+            udp.push_back(udp_length[7:0]);
+            udp.push_back(8'h00);
+            udp.push_back(8'h00);
+            foreach(payload[i]) udp.push_back(payload[i]);
+            udp_checksum = encapsulation == UDPV4_NO_CHECKSUM ? 16'h0000 : checksum(udp) == 0 ? 16'hffff : checksum(udp);
+            udp[12 + 6] = udp_checksum[15:8];
+            udp[12 + 7] = udp_checksum[7:0];
+
+            foreach(destination_mac[i]) frame.push_back(destination_mac[i]);
+            foreach(source_mac[i]) frame.push_back(source_mac[i]);
+            frame.push_back(8'h08);
+            frame.push_back(8'h00);
+            foreach(ip[i]) frame.push_back(ip[i]);
+            for(int i = 12; i < udp.size(); i++) frame.push_back(udp[i]);
+        end
+        UDPV6: begin
+            bit [7:0] destination_mac[6] = '{8'h33, 8'h33, 8'h00, 8'h00, 8'h01, 8'h81};
+            bit [15:0] udp_length = 8 + payload.size();
+            bit [7:0] addresses[32] = '{8'hfe, 8'h80, 8'h00, 8'h00, 8'h00, 8'h00, 8'h00, 8'h00, 8'h00, 8'h00, 8'h00, 8'h00, 8'h00, 8'h00, 8'h00, 8'h01,
+                                        8'hff, 8'h0e, 8'h00, 8'h00, 8'h00, 8'h00, 8'h00, 8'h00, 8'h00, 8'h00, 8'h00, 8'h00, 8'h00, 8'h00, 8'h01, 8'h81};
+            frame_t udp;
+            bit [15:0] udp_checksum;
+
+            // Pseudo header
+            foreach(addresses[i]) udp.push_back(addresses[i]);
+            udp.push_back(8'h00);
+            udp.push_back(8'h00);
+            udp.push_back(udp_length[15:8]);
+            udp.push_back(udp_length[7:0]);
+            udp.push_back(8'h00);
+            udp.push_back(8'h00);
+            udp.push_back(8'h00);
+            udp.push_back(8'h11);
+            udp.push_back(8'h01);
+            udp.push_back(8'h3f);
+            udp.push_back(port[15:8]);
+            udp.push_back(port[7:0]);
+            udp.push_back(udp_length[15:8]);
+            udp.push_back(udp_length[7:0]);
+            udp.push_back(8'h00);
+            udp.push_back(8'h00);
+            foreach(payload[i]) udp.push_back(payload[i]);
+            udp_checksum = checksum(udp) == 0 ? 16'hffff : checksum(udp);
+            udp[40 + 6] = udp_checksum[15:8];
+            udp[40 + 7] = udp_checksum[7:0];
+
+            foreach(destination_mac[i]) frame.push_back(destination_mac[i]);
+            foreach(source_mac[i]) frame.push_back(source_mac[i]);
+            frame.push_back(8'h86);
+            frame.push_back(8'hdd);
+            frame.push_back(8'h60);
+            frame.push_back(8'h00);
+            frame.push_back(8'h00);
+            frame.push_back(8'h00);
+            frame.push_back(udp_length[15:8]);
+            frame.push_back(udp_length[7:0]);
+            frame.push_back(8'h11);
+            frame.push_back(8'h01);
+            foreach(addresses[i]) frame.push_back(addresses[i]);
+            for(int i = 40; i < udp.size(); i++) frame.push_back(udp[i]);
+        end
+        endcase
+
+        while( frame.size() < 60 ) frame.push_back(8'h00);
+        fcs = crc32(frame);
+        for(int i = 0; i < 4; i++) frame.push_back(fcs[8*i +: 8]);
+
+        for(int i = 0; i < 7; i++) stream.push_back(8'h55);
+        stream.push_back(8'hd5);
+        foreach(frame[i]) stream.push_back(frame[i]);
+        return stream;
+    endfunction
+
+    function automatic bit [63:0] corrected(input bit [63:0] correction, input bit [47:0] origin_seconds, input bit [31:0] origin_nanoseconds);
+        longint residence;
+        residence = longint'(SFD_SECONDS - origin_seconds) * 1000000000 + longint'(SFD_NANOSECONDS) - longint'(origin_nanoseconds);
+        return correction + (residence << 16);
+    endfunction
+
+    function automatic bit [127:0] event_record(input bit one_step, input bit [1:0] transport, input bit [3:0] message_type, input bit [15:0] sequence_id);
+        return {17'b0, one_step, transport, message_type, 8'h00, sequence_id, SFD_SECONDS, SFD_NANOSECONDS};
+    endfunction
+
+    module stimuli (
+        input logic clock,
+        output logic aresetn,
+        axis_if.master tb_maxis,
+        axis_if.slave tb_saxis
+    );
+        initial begin
+            frame_t frames[$];
+            frame_t expected_frames[$];
+            int aborted_index;
+            bit [127:0] expected_events[$];
+            bit [63:0] correction;
+            frame_t frame;
+
+            // One-step Sync on Ethernet
+            correction = 64'h0000_0000_0001_8000;
+            frames.push_back(build_frame(L2, build_ptp(0, 0, correction, 16'h0001, 48'd1000, 32'd249999000), 0));
+            expected_frames.push_back(build_frame(L2, build_ptp(0, 0, corrected(correction, 48'd1000, 32'd249999000), 16'h0001, 48'd1000, 32'd249999000), 0));
+            expected_events.push_back(event_record(1, 2'd1, 4'd0, 16'h0001));
+            // One-step Sync with a VLAN tag, originTimestamp in the previous second
+            correction = 64'h0;
+            frames.push_back(build_frame(L2_VLAN, build_ptp(0, 0, correction, 16'h0002, 48'd999, 32'd750000000), 0));
+            expected_frames.push_back(build_frame(L2_VLAN, build_ptp(0, 0, corrected(correction, 48'd999, 32'd750000000), 16'h0002, 48'd999, 32'd750000000), 0));
+            expected_events.push_back(event_record(1, 2'd1, 4'd0, 16'h0002));
+            // One-step Sync on UDP/IPv4. The UDP checksum is updated.
+            correction = 64'h0000_0123_4567_89ab;
+            frames.push_back(build_frame(UDPV4, build_ptp(0, 0, correction, 16'h0003, 48'd1000, 32'd200000000), 16'd319));
+            expected_frames.push_back(build_frame(UDPV4, build_ptp(0, 0, corrected(correction, 48'd1000, 32'd200000000), 16'h0003, 48'd1000, 32'd200000000), 16'd319));
+            expected_events.push_back(event_record(1, 2'd2, 4'd0, 16'h0003));
+            // One-step Sync on UDP/IPv4 without the checksum
+            frames.push_back(build_frame(UDPV4_NO_CHECKSUM, build_ptp(0, 0, correction, 16'h0004, 48'd1000, 32'd249000000), 16'd319));
+            expected_frames.push_back(build_frame(UDPV4_NO_CHECKSUM, build_ptp(0, 0, corrected(correction, 48'd1000, 32'd249000000), 16'h0004, 48'd1000, 32'd249000000), 16'd319));
+            expected_events.push_back(event_record(1, 2'd2, 4'd0, 16'h0004));
+            // One-step Sync on UDP/IPv6
+            correction = 64'hffff_ffff_ffff_0000;   // -1[ns]
+            frames.push_back(build_frame(UDPV6, build_ptp(0, 0, correction, 16'h0005, 48'd1000, 32'd100), 16'd319));
+            expected_frames.push_back(build_frame(UDPV6, build_ptp(0, 0, corrected(correction, 48'd1000, 32'd100), 16'h0005, 48'd1000, 32'd100), 16'd319));
+            expected_events.push_back(event_record(1, 2'd3, 4'd0, 16'h0005));
+            // Two-step Sync is only timestamped.
+            frames.push_back(build_frame(L2, build_ptp(0, 1, 64'h0, 16'h0006, 48'd0, 32'd0), 0));
+            expected_frames.push_back(build_frame(L2, build_ptp(0, 1, 64'h0, 16'h0006, 48'd0, 32'd0), 0));
+            expected_events.push_back(event_record(0, 2'd1, 4'd0, 16'h0006));
+            // Delay_Req
+            frames.push_back(build_frame(UDPV4, build_ptp(1, 0, 64'h0, 16'h0007, 48'd0, 32'd0), 16'd319));
+            expected_frames.push_back(build_frame(UDPV4, build_ptp(1, 0, 64'h0, 16'h0007, 48'd0, 32'd0), 16'd319));
+            expected_events.push_back(event_record(0, 2'd2, 4'd1, 16'h0007));
+            // originTimestamp too old to correct
+            frames.push_back(build_frame(L2, build_ptp(0, 0, 64'h0, 16'h0008, 48'd990, 32'd0), 0));
+            expected_frames.push_back(build_frame(L2, build_ptp(0, 0, 64'h0, 16'h0008, 48'd990, 32'd0), 0));
+            expected_events.push_back(event_record(0, 2'd1, 4'd0, 16'h0008));
+            // Follow_Up to the general port is not an event message.
+            frames.push_back(build_frame(UDPV4, build_ptp(8, 0, 64'h0, 16'h0009, 48'd1000, 32'd0), 16'd320));
+            expected_frames.push_back(build_frame(UDPV4, build_ptp(8, 0, 64'h0, 16'h0009, 48'd1000, 32'd0), 16'd320));
+            // Not PTP
+            frames.push_back(build_frame(ARP, build_ptp(0, 0, 64'h0, 16'h000a, 48'd1000, 32'd0), 0));
+            expected_frames.push_back(build_frame(ARP, build_ptp(0, 0, 64'h0, 16'h000a, 48'd1000, 32'd0), 0));
+            // Aborted Delay_Req. The last octet of the correct FCS is inverted and no event is recorded.
+            frame = build_frame(UDPV4, build_ptp(1, 0, 64'h0, 16'h000b, 48'd0, 32'd0), 16'd319);
+            frames.push_back(frame);
+            frame[frame.size() - 1] = ~frame[frame.size() - 1];
+            expected_frames.push_back(frame);
+            aborted_index = frames.size() - 1;
+            // The frame after the aborted one
+            frames.push_back(build_frame(L2, build_ptp(1, 0, 64'h0, 16'h000c, 48'd0, 32'd0), 0));
+            expected_frames.push_back(build_frame(L2, build_ptp(1, 0, 64'h0, 16'h000c, 48'd0, 32'd0), 0));
+            expected_events.push_back(event_record(0, 2'd1, 4'd1, 16'h000c));
+
+            aresetn <= 0;
+            tb_maxis.master_init;
+            tb_saxis.slave_init;
+            repeat(4) @(posedge clock);
+            aresetn <= 1;
+            @(posedge clock);
+
+            fork
+                begin
+                    foreach(frames[frame_index]) begin
+                        frame_t frame;
+                        frame = frames[frame_index];
+                        foreach(frame[i]) begin
+                            tb_maxis.master_send(frame[i], 1'b1, i == frame.size() - 1, i == frame.size() - 1 && frame_index == aborted_index);
+                        end
+                        repeat($urandom_range(0, 2)) @(posedge clock);
+                    end
+                end
+                begin
+                    foreach(expected_frames[frame_index]) begin
+                        frame_t frame;
+                        frame = expected_frames[frame_index];
+                        foreach(frame[i]) begin
+                            bit [7:0] tdata;
+                            bit       tkeep;
+                            bit       tlast;
+                            bit       tuser;
+                            tb_saxis.slave_receive(tdata, tkeep, tlast, tuser, 32'h3fffffff);
+                            if( tdata != frame[i] ) $error("frame #%0d tdata mismatch at %0d, expected: %02x, actual: %02x", frame_index, i, frame[i], tdata);
+                            if( tlast != (i == frame.size() - 1) ) $error("frame #%0d tlast mismatch at %0d", frame_index, i);
+                            if( tlast && tuser != (frame_index == aborted_index) ) $error("frame #%0d tuser mismatch", frame_index);
+                        end
+                    end
+                end
+            join
+            repeat(4) @(posedge clock);
+
+            if( events.size() != expected_events.size() ) $error("%0d events are recorded, expected %0d", events.size(), expected_events.size());
+            foreach(expected_events[i]) begin
+                if( i < events.size() && events[i] != expected_events[i] ) $error("event #%0d mismatch, expected: %032x, actual: %032x", i, expected_events[i], events[i]);
+            end
+
+            $finish;
+        end
+    endmodule
+
+    stimuli stimuli_inst (
+        .tb_maxis(tb_maxis_if),
+        .tb_saxis(tb_saxis_if),
+        .*
+    );
+endmodule
@@ -0,0 +1,364 @@
+`timescale 1ns/1ps
+
+// One-step Sync messages through mii_mac_tx with USE_MACSEC.
+// The frames are rewritten and buffered after the arbiter, so correctionField must be updated with the time of the SFD
+// actually transmitted on the MII.
+module tb();
+    logic clock;
+    logic aresetn;
+
+    localparam [31:0] POLYNOMIAL = 32'b1110_1101_1011_1000_1000_0011_0010_0000;
+    localparam [127:0] KEY = 128'h000102030405060708090a0b0c0d0e0f;
+    localparam [63:0]  SCI = 64'h0200_0000_0001_0001;
+
+    logic [3:0] mii_d;
+    logic       mii_en;
+    logic       mii_er;
+
+    logic [7:0] saxis_tdata = 0;
+    logic       saxis_tvalid = 0;
+    logic       saxis_tready;
+    logic       saxis_tuser = 0;
+    logic       saxis_tlast = 0;
+
+    logic [7:0] saxis_bypass_tdata = 0;
+    logic       saxis_bypass_tvalid = 0;
+    logic       saxis_bypass_tready;
+    logic       saxis_bypass_tuser = 0;
+    logic       saxis_bypass_tlast = 0;
+
+    logic [7:0] saxis_control_tdata = 0;
+    logic       saxis_control_tvalid = 0;
+    logic       saxis_control_tready;
+    logic       saxis_control_tlast = 0;
+
+    logic pause = 0;
+    logic gate_hold_payload = 0;
+    logic gate_hold_bypass = 0;
+
+    // The time base crosses a second while the frames are sent.
+    logic [47:0] time_seconds = 48'd999;
+    logic [31:0] time_nanoseconds = 32'd999980000;
+
+    logic         ptp_one_step = 1;
+    logic [127:0] ptp_event_maxis_tdata;
+    logic         ptp_event_maxis_tvalid;
+    logic         ptp_event_maxis_tready = 1;
+
+    logic [31:0] payload_grant_count;
+    logic [31:0] bypass_grant_count;
+    logic [31:0] payload_wait_cycles;
+    logic [31:0] bypass_wait_cycles;
+    logic [31:0] payload_starvation_count;
+    logic [31:0] bypass_starvation_count;
+
+    logic  [7:0] macsec_s_axi_awaddr = 0;
+    logic        macsec_s_axi_awvalid = 0;
+    logic        macsec_s_axi_awready;
+    logic [31:0] macsec_s_axi_wdata = 0;
+    logic  [3:0] macsec_s_axi_wstrb = 0;
+    logic        macsec_s_axi_wvalid = 0;
+    logic        macsec_s_axi_wready;
+    logic  [1:0] macsec_s_axi_bresp;
+    logic        macsec_s_axi_bvalid;
+    logic        macsec_s_axi_bready = 0;
+    logic  [7:0] macsec_s_axi_araddr = 0;
+    logic        macsec_s_axi_arvalid = 0;
+    logic        macsec_s_axi_arready;
+    logic [31:0] macsec_s_axi_rdata;
+    logic  [1:0] macsec_s_axi_rresp;
+    logic        macsec_s_axi_rvalid;
+    logic        macsec_s_axi_rready = 0;
+
+    mii_mac_tx #(
+        .USE_MACSEC(1)
+    ) dut (
+        .*
+    );
+
+    initial begin
+        clock = 0;
+    end
+    always #(20) begin
+        clock = ~clock;
+    end
+
+    always @(posedge clock) begin
+        if( time_nanoseconds + 40 >= 1000000000 ) begin
+            time_seconds <= time_seconds + 1;
+            time_nanoseconds <= time_nanoseconds + 40 - 1000000000;
+        end
+        else begin
+            time_nanoseconds <= time_nanoseconds + 40;
+        end
+    end
+
+    // Time of the SFDs on the MII, sampled like the MAC does.
+    bit [79:0] sfd_times[$];
+    always @(posedge clock) begin
+        if( dut.sfd ) begin
+            sfd_times.push_back({time_seconds, time_nanoseconds});
+        end
+    end
+
+    bit [127:0] events[$];
+    always @(posedge clock) begin
+        if( ptp_event_maxis_tvalid && ptp_event_maxis_tready ) begin
+            events.push_back(ptp_event_maxis_tdata);
+        end
+    end
+
+    typedef bit [7:0] frame_t[$];
+
+    // Frames on the MII with the preamble and the SFD
+    frame_t received_frames[$];
+    frame_t receiving;
+    bit [3:0] low_nibble;
+    bit       nibble_high = 0;
+    always @(posedge clock) begin
+        if( mii_en ) begin
+            if( nibble_high ) begin
+                receiving.push_back({mii_d, low_nibble});
+            end
+            else begin
+                low_nibble = mii_d;
+            end
+            nibble_high = !nibble_high;
+        end
+        else if( receiving.size() > 0 ) begin
+            received_frames.push_back(receiving);
+            receiving = {};
+            nibble_high = 0;
+        end
+    end
+
+    typedef enum {
+        L2,
+        UDPV4
+    } encapsulation_t;
+
+    function automatic bit [31:0] crc32(input frame_t data);
+        bit [31:0] remainder = '1;
+        foreach(data[i]) begin
+            remainder[7:0] ^= data[i];
+            for(int bit_index = 0; bit_index < 8; bit_index++) begin
+                remainder = remainder[0] ? (remainder >> 1) ^ POLYNOMIAL : remainder >> 1;
+            end
+        end
+        return ~remainder;
+    endfunction
+
+    function automatic bit [15:0] checksum(input frame_t data);
+        bit [31:0] sum = 0;
+        for(int i = 0; i < data.size(); i += 2) begin
+            sum += {data[i], i + 1 < data.size() ? data[i + 1] : 8'h00};
+        end
+        while( sum[31:16] != 0 ) sum = sum[15:0] + sum[31:16];
+        return ~sum[15:0];
+    endfunction
+
+    function automatic frame_t build_ptp(input bit two_step, input bit [63:0] correction, input bit [15:0] sequence_id, input bit [47:0] origin_seconds, input bit [31:0] origin_nanoseconds);
+        frame_t message;
+        bit [7:0] source_port_identity[10] = '{8'h02, 8'h00, 8'h00, 8'hff, 8'hfe, 8'h00, 8'h00, 8'h01, 8'h00, 8'h01};
+        message.push_back(8'h00);               // Sync
+        message.push_back(8'h02);               // versionPTP
+        message.push_back(8'h00);               // messageLength
+        message.push_back(8'd44);
+        message.push_back(8'h00);               // domainNumber
+        message.push_back(8'h00);
+        message.push_back(two_step ? 8'h02 : 8'h00);
+        message.push_back(8'h00);
+        for(int i = 0; i < 8; i++) message.push_back(correction[8*(7 - i) +: 8]);
+        for(int i = 0; i < 4; i++) message.push_back(8'h00);
+        foreach(source_port_identity[i]) message.push_back(source_port_identity[i]);
+        message.push_back(sequence_id[15:8]);
+        message.push_back(sequence_id[7:0]);
+        message.push_back(8'h00);               // controlField
+        message.push_back(8'h00);               // logMessageInterval
+        for(int i = 0; i < 6; i++) message.push_back(origin_seconds[8*(5 - i) +: 8]);
+        for(int i = 0; i < 4; i++) message.push_back(origin_nanoseconds[8*(3 - i) +: 8]);
+        return message;
+    endfunction
+
+    // Build a frame with the preamble, the SFD and the FCS.
+    function automatic frame_t build_frame(input encapsulation_t encapsulation, input frame_t payload);
+        frame_t frame;
+        frame_t stream;
+        bit [7:0] source_mac[6] = '{8'h02, 8'h00, 8'h00, 8'h00, 8'h00, 8'h01};
+        bit [31:0] fcs;
+
+        case(encapsulation)
+        L2: begin
+            bit [7:0] destination_mac[6] = '{8'h01, 8'h1b, 8'h19, 8'h00, 8'h00, 8'h00};
+            foreach(destination_mac[i]) frame.push_back(destination_mac[i]);
+            foreach(source_mac[i]) frame.push_back(source_mac[i]);
+            frame.push_back(8'h88);
+            frame.push_back(8'hf7);
+            foreach(payload[i]) frame.push_back(payload[i]);
+        end
+        UDPV4: begin
+            bit [7:0] destination_mac[6] = '{8'h01, 8'h00, 8'h5e, 8'h00, 8'h01, 8'h81};
+            bit [15:0] udp_length = 8 + payload.size();
+            bit [15:0] ip_length = 20 + udp_length;
+            bit [7:0] ip[20] = '{8'h45, 8'h00, ip_length[15:8], ip_length[7:0], 8'h00, 8'h00, 8'h40, 8'h00, 8'h01, 8'h11, 8'h00, 8'h00,
+                                 8'hc0, 8'ha8, 8'h04, 8'h03, 8'he0, 8'h00, 8'h01, 8'h81};
+            frame_t header;
+            frame_t udp;
+            bit [15:0] ip_checksum;
+            bit [15:0] udp_checksum;
+
+            foreach(ip[i]) header.push_back(ip[i]);
+            ip_checksum = checksum(header);
+            ip[10] = ip_checksum[15:8];
+            ip[11] = ip_checksum[7:0];
+
+            // Pseudo header
+            for(int i = 12; i < 20; i++) udp.push_back(ip[i]);
+            udp.push_back(8'h00);
+            udp.push_back(8'h11);
+            udp.push_back(udp_length[15:8]);
+            udp.push_back(udp_length[7:0]);
+            udp.push_back(8'h01);
+            udp.push_back(8'h3f);
+            udp.push_back(8'h01);
+            udp.push_back(8'h3f);
+            udp.push_back(udp_length[15:8]);
+            udp.push_back(udp_length[7:0]);
+            udp.push_back(8'h00);
+            udp.push_back(8'h00);
+            foreach(payload[i]) udp.push_back(payload[i]);
+            udp_checksum = checksum(udp) == 0 ? 16'hffff : checksum(udp);
+            udp[12 + 6] = udp_checksum[15:8];
+            udp[12 + 7] = udp_checksum[7:0];
+
+            foreach(destination_mac[i]) frame.push_back(destination_mac[i]);
+            foreach(source_mac[i]) frame.push_back(source_mac[i]);
+            frame.push_back(8'h08);
+            frame.push_back(8'h00);
+            foreach(ip[i]) frame.push_back(ip[i]);
+            for(int i = 12; i < udp.size(); i++) frame.push_back(udp[i]);
+        end
+        endcase
+
+        while( frame.size() < 60 ) frame.push_back(8'h00);
+        fcs = crc32(frame);
+        for(int i = 0; i < 4; i++) frame.push_back(fcs[8*i +: 8]);
+
+        for(int i = 0; i < 7; i++) stream.push_back(8'h55);
+        stream.push_back(8'hd5);
+        foreach(frame[i]) stream.push_back(frame[i]);
+        return stream;
+    endfunction
+
+    function automatic bit [63:0] corrected(input bit [63:0] correction, input bit [79:0] sfd_time, input bit [47:0] origin_seconds, input bit [31:0] origin_nanoseconds);
+        longint residence;
+        residence = longint'(sfd_time[79:32] - origin_seconds) * 1000000000 + longint'(sfd_time[31:0]) - longint'(origin_nanoseconds);
+        return correction + (residence << 16);
+    endfunction
+
+    function automatic bit [127:0] event_record(input bit one_step, input bit [1:0] transport, input bit [15:0] sequence_id, input bit [79:0] sfd_time);
+        return {17'b0, one_step, transport, 4'd0, 8'h00, sequence_id, sfd_time};
+    endfunction
+
+    task automatic axi_write(input logic [7:0] address, input logic [31:0] data);
+        macsec_s_axi_awaddr <= address;
+        macsec_s_axi_awvalid <= 1;
+        macsec_s_axi_wdata <= data;
+        macsec_s_axi_wstrb <= 4'hf;
+        macsec_s_axi_wvalid <= 1;
+        macsec_s_axi_bready <= 1;
+        do @(posedge clock); while(!(macsec_s_axi_awready && macsec_s_axi_wready));
+        macsec_s_axi_awvalid <= 0;
+        macsec_s_axi_wvalid <= 0;
+        do @(posedge clock); while(!macsec_s_axi_bvalid);
+        macsec_s_axi_bready <= 0;
+    endtask
+
+    task automatic send_bypass(input frame_t frame);
+        foreach(frame[i]) begin
+            saxis_bypass_tdata <= frame[i];
+            saxis_bypass_tvalid <= 1;
+            saxis_bypass_tlast <= i == frame.size() - 1;
+            do @(posedge clock); while(!saxis_bypass_tready);
+        end
+        saxis_bypass_tvalid <= 0;
+        saxis_bypass_tlast <= 0;
+    endtask
+
+    task automatic wait_frames(input int count);
+        int timeout = 100000;
+        while( received_frames.size() < count && timeout > 0 ) begin
+            @(posedge clock);
+            timeout--;
+        end
+        if( timeout == 0 ) $error("timed out waiting for frame #%0d", count - 1);
+        repeat(8) @(posedge clock);
+    endtask
+
+    initial begin
+        localparam bit [63:0] CORRECTION_L2 = 64'h0000_0000_0001_8000;
+        localparam bit [63:0] CORRECTION_UDP = 64'h0000_0123_4567_89ab;
+        bit [127:0] expected_events[$];
+        frame_t expected;
+
+        aresetn <= 0;
+        repeat(4) @(posedge clock);
+        aresetn <= 1;
+        repeat(4) @(posedge clock);
+
+        // MACsec disabled. The frames pass the MACsec path as is.
+        send_bypass(build_frame(L2, build_ptp(0, CORRECTION_L2, 16'h0001, 48'd999, 32'd999900000)));
+        send_bypass(build_frame(UDPV4, build_ptp(0, CORRECTION_UDP, 16'h0002, 48'd999, 32'd999950000)));
+        send_bypass(build_frame(L2, build_ptp(1, 64'h0, 16'h0003, 48'd0, 32'd0)));     // Two-step, only timestamped
+        wait_frames(3);
+
+        // MACsec enabled with 0x88f7 exempted. The UDP frame is protected and not updated.
+        axi_write(8'h08, SCI[63:32]);
+        axi_write(8'h0c, SCI[31:0]);
+        for(int i = 0; i < 4; i++) begin
+            axi_write(8'h20 + 4*i, KEY[127 - 32*i -: 32]);
+        end
+        axi_write(8'h14, 32'h0001_88f7);
+        axi_write(8'h00, 32'h0000_0001);        // Enable, integrity only, AN 0
+        repeat(20) @(posedge clock);
+        send_bypass(build_frame(L2, build_ptp(0, CORRECTION_L2, 16'h0004, 48'd1000, 32'd0)));
+        send_bypass(build_frame(UDPV4, build_ptp(0, CORRECTION_UDP, 16'h0005, 48'd1000, 32'd0)));
+        wait_frames(5);
+
+        if( sfd_times.size() != 5 ) $error("%0d SFDs are transmitted, expected 5", sfd_times.size());
+
+        if( received_frames.size() == 5 && sfd_times.size() == 5 ) begin
+            expected = build_frame(L2, build_ptp(0, corrected(CORRECTION_L2, sfd_times[0], 48'd999, 32'd999900000), 16'h0001, 48'd999, 32'd999900000));
+            if( received_frames[0] != expected ) $error("frame #0 mismatch");
+            expected_events.push_back(event_record(1, 2'd1, 16'h0001, sfd_times[0]));
+
+            expected = build_frame(UDPV4, build_ptp(0, corrected(CORRECTION_UDP, sfd_times[1], 48'd999, 32'd999950000), 16'h0002, 48'd999, 32'd999950000));
+            if( received_frames[1] != expected ) $error("frame #1 mismatch");
+            expected_events.push_back(event_record(1, 2'd2, 16'h0002, sfd_times[1]));
+
+            expected = build_frame(L2, build_ptp(1, 64'h0, 16'h0003, 48'd0, 32'd0));
+            if( received_frames[2] != expected ) $error("frame #2 mismatch");
+            expected_events.push_back(event_record(0, 2'd1, 16'h0003, sfd_times[2]));
+
+            expected = build_frame(L2, build_ptp(0, corrected(CORRECTION_L2, sfd_times[3], 48'd1000, 32'd0), 16'h0004, 48'd1000, 32'd0));
+            if( received_frames[3] != expected ) $error("frame #3 mismatch");
+            expected_events.push_back(event_record(1, 2'd1, 16'h0004, sfd_times[3]));
+
+            // The protected frame has the SecTAG and a correct FCS, and no event is recorded.
+            expected = received_frames[4];
+            if( expected[8 + 12] != 8'h88 || expected[8 + 13] != 8'he5 ) $error("frame #4 is not protected");
+            expected = expected[8:$];
+            if( crc32(expected[0:$-4]) != {expected[$], expected[$-1], expected[$-2], expected[$-3]} ) $error("frame #4 FCS mismatch");
+        end
+        else begin
+            $error("%0d frames are received, expected 5", received_frames.size());
+        end
+
+        if( events.size() != expected_events.size() ) $error("%0d events are recorded, expected %0d", events.size(), expected_events.size());
+        foreach(expected_events[i]) begin
+            if( i < events.size() && events[i] != expected_events[i] ) $error("event #%0d mismatch, expected: %032x, actual: %032x", i, expected_events[i], events[i]);
+        end
+
+        $finish;
+    end
+endmodule
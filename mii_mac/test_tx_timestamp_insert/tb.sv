@@ -0,0 +1,215 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+    logic line_aresetn;
+
+    axis_if #(.DATA_WIDTH(1)) tb_maxis_if(.clock(clock), .aresetn(aresetn));
+    axis_if #(.DATA_WIDTH(1)) tb_saxis_if(.clock(clock), .aresetn(aresetn));
+    axis_if #(.DATA_WIDTH(1)) tb_line_maxis_if(.clock(clock), .aresetn(line_aresetn));
+    axis_if #(.DATA_WIDTH(1)) tb_line_saxis_if(.clock(clock), .aresetn(line_aresetn));
+
+    localparam [31:0] POLYNOMIAL = 32'b1110_1101_1011_1000_1000_0011_0010_0000;
+
+    // 2021-01-01T00:00:00.5Z
+    logic [47:0] timestamp_seconds = 48'd1609459200;
+    logic [31:0] timestamp_nanoseconds = 32'd500000000;
+    localparam bit [63:0] EXPECTED_NTP_TIMESTAMP = 64'he398e480_80000000;
+
+    tx_timestamp_insert dut(
+        .saxis_tdata (tb_maxis_if.tdata ),
+        .saxis_tvalid(tb_maxis_if.tvalid),
+        .saxis_tready(tb_maxis_if.tready),
+        .saxis_tuser (tb_maxis_if.tuser ),
+        .saxis_tlast (tb_maxis_if.tlast ),
+        .maxis_tdata (tb_saxis_if.tdata ),
+        .maxis_tvalid(tb_saxis_if.tvalid),
+        .maxis_tready(tb_saxis_if.tready),
+        .maxis_tuser (tb_saxis_if.tuser ),
+        .maxis_tlast (tb_saxis_if.tlast ),
+        .*
+    );
+
+    // With the preamble, the SFD and the FCS (placement with MACsec)
+    tx_timestamp_insert #(
+        .LINE_SIDE(1)
+    ) dut_line(
+        .aresetn(line_aresetn),
+        .saxis_tdata (tb_line_maxis_if.tdata ),
+        .saxis_tvalid(tb_line_maxis_if.tvalid),
+        .saxis_tready(tb_line_maxis_if.tready),
+        .saxis_tuser (tb_line_maxis_if.tuser ),
+        .saxis_tlast (tb_line_maxis_if.tlast ),
+        .maxis_tdata (tb_line_saxis_if.tdata ),
+        .maxis_tvalid(tb_line_saxis_if.tvalid),
+        .maxis_tready(tb_line_saxis_if.tready),
+        .maxis_tuser (tb_line_saxis_if.tuser ),
+        .maxis_tlast (tb_line_saxis_if.tlast ),
+        .*
+    );
+
+    initial begin
+        clock = 0;
+    end
+    always #(5) begin
+        clock = ~clock;
+    end
+
+    typedef bit [7:0] frame_t[$];
+
+    function automatic bit [31:0] crc32(input frame_t data);
+        bit [31:0] remainder = '1;
+        foreach(data[i]) begin
+            remainder[7:0] ^= data[i];
+            for(int bit_index = 0; bit_index < 8; bit_index++) begin
+                remainder = remainder[0] ? (remainder >> 1) ^ POLYNOMIAL : remainder >> 1;
+            end
+        end
+        return ~remainder;
+    endfunction
+
+    // Add the preamble, the SFD and the FCS to a frame.
+    function automatic frame_t to_line(input frame_t frame);
+        frame_t stream;
+        bit [31:0] fcs;
+        fcs = crc32(frame);
+        for(int i = 0; i < 7; i++) stream.push_back(8'h55);
+        stream.push_back(8'hd5);
+        foreach(frame[i]) stream.push_back(frame[i]);
+        for(int i = 0; i < 4; i++) stream.push_back(fcs[8*i +: 8]);
+        return stream;
+    endfunction
+
+    // Build an NTP packet with the given VLAN tags, UDP source port and NTP mode.
+    function automatic frame_t build_ntp_frame(input int tags, input bit [15:0] source_port, input bit [2:0] mode);
+        frame_t frame;
+        bit [7:0] ip[20] = '{8'h45, 8'h00, 8'h00, 8'h4c, 8'h00, 8'h00, 8'h40, 8'h00, 8'h40, 8'h11, 8'h00, 8'h00, 8'hc0, 8'ha8, 8'h04, 8'h02, 8'hc0, 8'ha8, 8'h04, 8'h01};
+        bit [7:0] udp[8] = '{source_port[15:8], source_port[7:0], 8'hd4, 8'h31, 8'h00, 8'h38, 8'h00, 8'h00};
+        frame = '{8'h02, 8'h00, 8'h00, 8'h00, 8'h00, 8'h01, 8'haa, 8'hbb, 8'hcc, 8'hdd, 8'hee, 8'hff};
+        for(int i = 0; i < tags; i++) begin
+            frame.push_back(i == tags - 1 ? 8'h81 : 8'h88);
+            frame.push_back(i == tags - 1 ? 8'h00 : 8'ha8);
+            frame.push_back(8'h00);
+            frame.push_back(8'h0a);
+        end
+        frame.push_back(8'h08);
+        frame.push_back(8'h00);
+        foreach(ip[i]) frame.push_back(ip[i]);
+        foreach(udp[i]) frame.push_back(udp[i]);
+        // NTP
+        frame.push_back({5'b00100, mode});
+        for(int i = 1; i < 48; i++) begin
+            frame.push_back(i);
+        end
+        return frame;
+    endfunction
+
+    module stimuli #(
+        parameter bit LINE_SIDE = 0
+    ) (
+        input logic clock,
+        output logic aresetn,
+        output logic done,
+        axis_if.master tb_maxis,
+        axis_if.slave tb_saxis
+    );
+        initial begin
+            frame_t frames[$];
+            frame_t expected_frames[$];
+
+            for(int tags = 0; tags <= 2; tags++) begin
+                frame_t frame;
+                int transmit_timestamp_offset;
+                frame = build_ntp_frame(tags, 16'd123, 3'd4);
+                frames.push_back(frame);
+                transmit_timestamp_offset = 14 + 4*tags + 20 + 8 + 40;
+                for(int i = 0; i < 8; i++) begin
+                    frame[transmit_timestamp_offset + i] = EXPECTED_NTP_TIMESTAMP[8*(7 - i) +: 8];
+                end
+                expected_frames.push_back(frame);
+            end
+            // Not from the NTP port
+            frames.push_back(build_ntp_frame(0, 16'd124, 3'd4));
+            expected_frames.push_back(build_ntp_frame(0, 16'd124, 3'd4));
+            // NTP client request
+            frames.push_back(build_ntp_frame(1, 16'd123, 3'd3));
+            expected_frames.push_back(build_ntp_frame(1, 16'd123, 3'd3));
+            // With the UDP checksum
+            begin
+                frame_t frame;
+                frame = build_ntp_frame(0, 16'd123, 3'd4);
+                frame[14 + 20 + 7] = 8'h5a;
+                frames.push_back(frame);
+                expected_frames.push_back(frame);
+            end
+
+            if( LINE_SIDE ) begin
+                foreach(frames[i]) frames[i] = to_line(frames[i]);
+                foreach(expected_frames[i]) expected_frames[i] = to_line(expected_frames[i]);
+            end
+
+            done <= 0;
+            aresetn <= 0;
+            tb_maxis.master_init;
+            tb_saxis.slave_init;
+            repeat(4) @(posedge clock);
+            aresetn <= 1;
+            @(posedge clock);
+
+            fork
+                begin
+                    foreach(frames[frame_index]) begin
+                        frame_t frame;
+                        frame = frames[frame_index];
+                        foreach(frame[i]) begin
+                            tb_maxis.master_send(frame[i], 1'b1, i == frame.size() - 1, 0);
+                        end
+                        repeat($urandom_range(0, 2)) @(posedge clock);
+                    end
+                end
+                begin
+                    foreach(expected_frames[frame_index]) begin
+                        frame_t frame;
+                        frame = expected_frames[frame_index];
+                        foreach(frame[i]) begin
+                            bit [7:0] tdata;
+                            bit       tkeep;
+                            bit       tlast;
+                            bit       tuser;
+                            tb_saxis.slave_receive(tdata, tkeep, tlast, tuser, 32'h7fffffff);
+                            if( tdata != frame[i] ) $error("frame #%0d tdata mismatch at %0d, expected: %02x, actual: %02x", frame_index, i, frame[i], tdata);
+                            if( tlast != (i == frame.size() - 1) ) $error("frame #%0d tlast mismatch at %0d", frame_index, i);
+                        end
+                    end
+                end
+            join
+
+            done <= 1;
+        end
+    endmodule
+
+    logic done;
+    logic line_done;
+
+    stimuli stimuli_inst (
+        .tb_maxis(tb_maxis_if),
+        .tb_saxis(tb_saxis_if),
+        .*
+    );
+
+    stimuli #(
+        .LINE_SIDE(1)
+    ) line_stimuli_inst (
+        .aresetn(line_aresetn),
+        .done(line_done),
+        .tb_maxis(tb_line_maxis_if),
+        .tb_saxis(tb_line_saxis_if),
+        .*
+    );
+
+    initial begin
+        wait(done === 1 && line_done === 1);
+        $finish;
+    end
+endmodule
@@ -0,0 +1,323 @@
+`default_nettype none
+
+// Token bucket shaper of the frames from the PS GEM, around the cut-through FIFO on ps_tx_mii.
+// The input side classifies the frames by the EtherType or the DSCP (IPv4/IPv6, after up to one VLAN tag)
+// and writes them into the FIFO. A frame which may not fit in the FIFO is dropped as a whole,
+// because the GEM cannot be stalled. With BACKPRESSURE, saxis_tready holds such a frame at its first byte instead,
+// for a source which can wait (the bridge).
+// The output side starts the frame at the head of the FIFO when the bucket of its class is not negative,
+// and takes the bytes from the bucket as they are transmitted, with the preamble, SFD and IFG (20 bytes) at the end of the frame.
+// The buckets fill by RATE every clock up to BURST. The frames leave in the order written by the GEM,
+// so a frame waits behind the head frame of another class.
+// A frame is started after its class is determined, at the 20th byte.
+//
+// Registers (32bit access only)
+//   0x00 CONTROL          RW  bit0: enable. While disabled, the frames are not held. Writing this register fills the buckets.
+//   0x04 STATUS           R   bit0: the head frame is held, bit15-8: class of the head frame
+//   0x08 DROP_COUNT       R   frames dropped because the FIFO was full
+//   0x40 + 16*n MATCH     RW  class n >= 1 (the first matching class is used, class 0 otherwise)
+//                             bit31: match the EtherType, bit30: match the DSCP, bit21-16: DSCP, bit15-0: EtherType
+//   0x44 + 16*n RATE      RW  bytes per clock, 16bit fraction. 0x8000 is 100Mbps at 25MHz.
+//   0x48 + 16*n BURST     RW  bytes (up to 8388607)
+//   0x4c + 16*n TOKENS    R   bytes in the bucket (signed)
+module tx_bypass_shaper #(
+    parameter int CLASSES = 4,                  // 1 to 4
+    parameter int FIFO_LEVEL_BITS = 13,
+    parameter int FIFO_BYTES = 2048,
+    parameter int MAX_FRAME_BYTES = 1522,       // Without the preamble
+    parameter int CLASS_FIFO_DEPTH_BITS = 6,    // Frames in the FIFO
+    parameter bit BACKPRESSURE = 0,
+    parameter int ADDR_BITS = 8
+) (
+    input wire clock,
+    input wire aresetn,
+
+    // Frames to the FIFO
+    input  wire [7:0] saxis_tdata,
+    input  wire       saxis_tvalid,
+    output wire       saxis_tready,     // Always asserted unless BACKPRESSURE
+    input  wire       saxis_tlast,
+    output wire [7:0] fifo_saxis_tdata,
+    output wire       fifo_saxis_tvalid,
+    output wire       fifo_saxis_tlast,
+    input  wire [FIFO_LEVEL_BITS-1:0] fifo_level,
+
+    // Frames from the FIFO
+    input  wire [7:0] fifo_maxis_tdata,
+    input  wire       fifo_maxis_tvalid,
+    output wire       fifo_maxis_tready,
+    input  wire       fifo_maxis_tuser,
+    input  wire       fifo_maxis_tlast,
+    output wire [7:0] maxis_tdata,
+    output wire       maxis_tvalid,
+    input  wire       maxis_tready,
+    output wire       maxis_tuser,
+    output wire       maxis_tlast,
+
+    input  wire  [ADDR_BITS-1:0] s_axi_awaddr,
+    input  wire                  s_axi_awvalid,
+    output logic                 s_axi_awready,
+    input  wire  [31:0]          s_axi_wdata,
+    input  wire  [3:0]           s_axi_wstrb,
+    input  wire                  s_axi_wvalid,
+    output logic                 s_axi_wready,
+    output logic [1:0]           s_axi_bresp,
+    output logic                 s_axi_bvalid,
+    input  wire                  s_axi_bready,
+    input  wire  [ADDR_BITS-1:0] s_axi_araddr,
+    input  wire                  s_axi_arvalid,
+    output logic                 s_axi_arready,
+    output logic [31:0]          s_axi_rdata,
+    output logic [1:0]           s_axi_rresp,
+    output logic                 s_axi_rvalid,
+    input  wire                  s_axi_rready
+);
+
+localparam int CLASS_BITS = CLASSES > 1 ? $clog2(CLASSES) : 1;
+localparam int OVERHEAD_BYTES = 20;             // Preamble, SFD and IFG
+localparam int CLASSIFY_INDEX = 19;             // Last byte of the DSCP after a VLAN tag
+
+localparam int REG_CONTROL = 0;
+localparam int REG_STATUS = 1;
+localparam int REG_DROP_COUNT = 2;
+localparam int REG_CLASS = 16;
+localparam int REG_CLASS_MATCH = 0;
+localparam int REG_CLASS_RATE = 1;
+localparam int REG_CLASS_BURST = 2;
+localparam int REG_CLASS_TOKENS = 3;
+
+logic        enable;
+logic        refill;
+logic [31:0] drop_count;
+logic [31:0] class_match[CLASSES-1:0];
+logic [31:0] class_rate[CLASSES-1:0];
+logic [22:0] class_burst[CLASSES-1:0];
+logic signed [39:0] tokens[CLASSES-1:0];    // 16bit fraction
+
+logic                  head_held;
+logic [CLASS_BITS-1:0] head_class;
+
+// AXI4-Lite write
+logic write_enable;
+logic [ADDR_BITS-3:0] write_index;
+assign write_enable = s_axi_awvalid && s_axi_wvalid && !s_axi_bvalid;
+assign write_index = s_axi_awaddr[ADDR_BITS-1:2];
+assign s_axi_awready = write_enable;
+assign s_axi_wready = write_enable;
+assign s_axi_bresp = 2'b00;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        s_axi_bvalid <= 0;
+        enable <= 0;
+        refill <= 0;
+        for(int i = 0; i < CLASSES; i++) begin
+            class_match[i] <= 0;
+            class_rate[i] <= 32'h0001_0000;
+            class_burst[i] <= 2048;
+        end
+    end
+    else begin
+        refill <= 0;
+        if( s_axi_bvalid && s_axi_bready ) begin
+            s_axi_bvalid <= 0;
+        end
+        if( write_enable ) begin
+            s_axi_bvalid <= 1;
+            case(write_index)
+            REG_CONTROL: begin
+                enable <= s_axi_wdata[0];
+                refill <= 1;
+            end
+            default: begin
+                for(int i = 0; i < CLASSES; i++) begin
+                    if( write_index == REG_CLASS + i*4 + REG_CLASS_MATCH ) class_match[i] <= s_axi_wdata;
+                    if( write_index == REG_CLASS + i*4 + REG_CLASS_RATE ) class_rate[i] <= s_axi_wdata;
+                    if( write_index == REG_CLASS + i*4 + REG_CLASS_BURST ) class_burst[i] <= s_axi_wdata[31:23] != 0 ? '1 : s_axi_wdata[22:0];
+                end
+            end
+            endcase
+        end
+    end
+end
+
+// AXI4-Lite read
+logic [ADDR_BITS-3:0] read_index;
+assign read_index = s_axi_araddr[ADDR_BITS-1:2];
+assign s_axi_arready = !s_axi_rvalid;
+assign s_axi_rresp = 2'b00;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        s_axi_rvalid <= 0;
+        s_axi_rdata <= 0;
+    end
+    else begin
+        if( s_axi_rvalid && s_axi_rready ) begin
+            s_axi_rvalid <= 0;
+        end
+        if( s_axi_arvalid && s_axi_arready ) begin
+            s_axi_rvalid <= 1;
+            case(read_index)
+            REG_CONTROL: s_axi_rdata <= {31'b0, enable};
+            REG_STATUS: s_axi_rdata <= {16'b0, 8'(head_class), 7'b0, head_held};
+            REG_DROP_COUNT: s_axi_rdata <= drop_count;
+            default: begin
+                s_axi_rdata <= 0;
+                for(int i = 0; i < CLASSES; i++) begin
+                    if( read_index == REG_CLASS + i*4 + REG_CLASS_MATCH ) s_axi_rdata <= class_match[i];
+                    if( read_index == REG_CLASS + i*4 + REG_CLASS_RATE ) s_axi_rdata <= class_rate[i];
+                    if( read_index == REG_CLASS + i*4 + REG_CLASS_BURST ) s_axi_rdata <= 32'(class_burst[i]);
+                    if( read_index == REG_CLASS + i*4 + REG_CLASS_TOKENS ) s_axi_rdata <= {{8{tokens[i][39]}}, tokens[i][39:16]};
+                end
+            end
+            endcase
+        end
+    end
+end
+
+// Classes of the frames in the FIFO
+logic [CLASS_BITS-1:0] class_in_tdata;
+logic                  class_in_tvalid;
+logic                  class_in_tready;
+logic [CLASS_BITS-1:0] class_out_tdata;
+logic                  class_out_tvalid;
+logic                  class_out_tready;
+
+simple_fifo #(
+    .DATA_BITS(CLASS_BITS),
+    .DEPTH_BITS(CLASS_FIFO_DEPTH_BITS)
+) class_fifo_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .saxis_tdata(class_in_tdata),
+    .saxis_tvalid(class_in_tvalid),
+    .saxis_tready(class_in_tready),
+    .maxis_tdata(class_out_tdata),
+    .maxis_tvalid(class_out_tvalid),
+    .maxis_tready(class_out_tready)
+);
+
+// Input side
+logic       in_frame;
+logic       admitted;           // The input frame is written into the FIFO.
+logic [4:0] in_index;           // Index of the next input byte, saturated
+logic [7:0] header[7:0];        // Bytes 12 to 19
+logic       classify;           // The header of the admitted frame is complete.
+
+wire [4:0] byte_index = in_frame ? in_index : 0;
+wire admit = fifo_level <= FIFO_BYTES - MAX_FRAME_BYTES && class_in_tready;
+wire input_valid = saxis_tvalid && saxis_tready;
+wire write = input_valid && (in_frame ? admitted : admit);
+
+assign saxis_tready = !BACKPRESSURE || in_frame || admit;
+
+assign fifo_saxis_tdata = saxis_tdata;
+assign fifo_saxis_tvalid = write;
+assign fifo_saxis_tlast = saxis_tlast;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        in_frame <= 0;
+        admitted <= 0;
+        in_index <= 0;
+        classify <= 0;
+        drop_count <= 0;
+    end
+    else begin
+        classify <= write && (byte_index == CLASSIFY_INDEX || saxis_tlast && byte_index < CLASSIFY_INDEX);
+        if( input_valid ) begin
+            in_frame <= !saxis_tlast;
+            in_index <= byte_index == 5'h1f ? byte_index : byte_index + 1;
+            if( !in_frame ) begin
+                admitted <= admit;
+                if( !admit ) begin
+                    drop_count <= drop_count + 1;
+                end
+            end
+        end
+    end
+end
+
+always_ff @(posedge clock) begin
+    if( input_valid && byte_index >= 12 && byte_index <= CLASSIFY_INDEX ) begin
+        header[3'(byte_index - 12)] <= saxis_tdata;
+    end
+end
+
+wire [15:0] outer_type = {header[0], header[1]};
+wire        tagged = outer_type == 16'h8100 || outer_type == 16'h88a8;
+wire [15:0] ethertype = tagged ? {header[4], header[5]} : outer_type;
+wire [7:0]  l3_byte_0 = tagged ? header[6] : header[2];
+wire [7:0]  l3_byte_1 = tagged ? header[7] : header[3];
+wire        is_ipv4 = ethertype == 16'h0800;
+wire        is_ipv6 = ethertype == 16'h86dd;
+wire [5:0]  dscp = is_ipv4 ? l3_byte_1[7:2] : {l3_byte_0[3:0], l3_byte_1[7:6]};
+
+always_comb begin
+    class_in_tdata = 0;
+    for(int i = CLASSES - 1; i >= 1; i--) begin
+        if( (class_match[i][31] || class_match[i][30])
+            && (!class_match[i][31] || ethertype == class_match[i][15:0])
+            && (!class_match[i][30] || (is_ipv4 || is_ipv6) && dscp == class_match[i][21:16]) ) begin
+            class_in_tdata = CLASS_BITS'(i);
+        end
+    end
+end
+assign class_in_tvalid = classify;
+
+// Output side
+logic                  out_frame;
+logic [CLASS_BITS-1:0] out_class;
+
+assign head_class = class_out_tdata;
+wire head_allowed = !enable || !tokens[head_class][39];
+wire pass = out_frame || class_out_tvalid && head_allowed;
+wire [CLASS_BITS-1:0] current_class = out_frame ? out_class : head_class;
+wire output_accepted = maxis_tvalid && maxis_tready;
+
+assign head_held = !out_frame && class_out_tvalid && !head_allowed;
+
+assign maxis_tdata  = fifo_maxis_tdata;
+assign maxis_tvalid = fifo_maxis_tvalid && pass;
+assign fifo_maxis_tready = maxis_tready && pass;
+assign maxis_tuser  = fifo_maxis_tuser;
+assign maxis_tlast  = fifo_maxis_tlast;
+assign class_out_tready = output_accepted && !out_frame;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        out_frame <= 0;
+        out_class <= 0;
+    end
+    else if( output_accepted ) begin
+        out_frame <= !maxis_tlast;
+        out_class <= current_class;
+    end
+end
+
+// Buckets
+logic signed [40:0] tokens_next[CLASSES-1:0];
+always_comb begin
+    for(int i = 0; i < CLASSES; i++) begin
+        tokens_next[i] = tokens[i] + $signed({9'b0, class_rate[i]});
+        if( output_accepted && current_class == i ) begin
+            tokens_next[i] -= $signed(41'(maxis_tlast ? 1 + OVERHEAD_BYTES : 1) << 16);
+        end
+    end
+end
+
+always_ff @(posedge clock) begin
+    for(int i = 0; i < CLASSES; i++) begin
+        if( !aresetn || refill || tokens_next[i] > $signed({2'b0, class_burst[i], 16'b0}) ) begin
+            tokens[i] <= $signed({1'b0, class_burst[i], 16'b0});
+        end
+        else begin
+            tokens[i] <= tokens_next[i][39:0];
+        end
+    end
+end
+
+endmodule
+
+`default_nettype wire
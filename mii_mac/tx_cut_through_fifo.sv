@@ -0,0 +1,124 @@
+`default_nettype none
+
+// Cut-through TX FIFO.
+// A frame is output once START_THRESHOLD bytes are buffered or its last byte is written,
+// instead of waiting for the whole frame like a packet mode FIFO.
+// If the FIFO runs empty in the middle of an output frame while the output is ready (underrun), the frame is ended
+// with a dummy byte with tuser asserted, so that the MAC aborts it with a bad FCS. Running empty while the output
+// is stalled is not an underrun, since the next byte may arrive before the output takes it.
+// The rest of the aborted frame is discarded on the input and underrun_count is incremented.
+module tx_cut_through_fifo #(
+    parameter int DEPTH_BITS = 11,
+    parameter int START_THRESHOLD = 64  // Bytes
+) (
+    input wire clock,
+    input wire aresetn,
+
+    input  wire [7:0] saxis_tdata,
+    input  wire       saxis_tvalid,
+    output wire       saxis_tready,
+    input  wire       saxis_tlast,
+
+    output wire [7:0] maxis_tdata,
+    output wire       maxis_tvalid,
+    input  wire       maxis_tready,
+    output wire       maxis_tuser,      // Asserted with tlast of an aborted frame
+    output wire       maxis_tlast,
+
+    output wire [DEPTH_BITS+1:0] level, // Bytes in the FIFO
+    output logic [31:0] underrun_count
+);
+
+logic [DEPTH_BITS:0] index_r;
+logic [DEPTH_BITS:0] index_w;
+logic [8:0] memory[2**DEPTH_BITS-1:0];
+
+// Output register. Read from the memory, so that the memory is inferred as a block RAM.
+logic [8:0] output_data;
+logic       output_valid;
+
+logic [DEPTH_BITS:0] frame_count;   // Frames whose last byte is in the FIFO
+logic in_frame;                     // An output frame is started
+logic aborting;                     // The dummy byte of an aborted frame is output
+logic discarding;                   // The rest of an aborted frame is discarded on the input
+
+wire [DEPTH_BITS:0] memory_level = index_w - index_r;
+wire memory_empty = index_r == index_w;
+wire memory_full = memory_level[DEPTH_BITS];
+assign level = memory_level + output_valid;
+
+wire start_ready = frame_count != 0 || level >= START_THRESHOLD;
+wire output_enable = output_valid && (in_frame || start_ready);
+wire underrun = in_frame && maxis_tready && !output_valid && memory_empty && !aborting;
+
+assign maxis_tvalid = aborting || output_enable;
+assign maxis_tdata  = aborting ? 8'h00 : output_data[7:0];
+assign maxis_tlast  = aborting || output_data[8];
+assign maxis_tuser  = aborting;
+
+assign saxis_tready = !memory_full || discarding;
+
+wire input_accepted = saxis_tvalid && saxis_tready;
+wire write_enable = input_accepted && !discarding && !underrun;
+wire output_accepted = maxis_tvalid && maxis_tready;
+wire read_enable = !memory_empty && !aborting && (!output_valid || output_enable && maxis_tready);
+
+always_ff @(posedge clock) begin
+    if( write_enable ) begin
+        memory[index_w[DEPTH_BITS-1:0]] <= {saxis_tlast, saxis_tdata};
+    end
+    if( read_enable ) begin
+        output_data <= memory[index_r[DEPTH_BITS-1:0]];
+    end
+end
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        index_r <= 0;
+        index_w <= 0;
+        output_valid <= 0;
+        frame_count <= 0;
+        in_frame <= 0;
+        aborting <= 0;
+        discarding <= 0;
+        underrun_count <= 0;
+    end
+    else begin
+        if( write_enable ) begin
+            index_w <= index_w + 1;
+        end
+        if( read_enable ) begin
+            index_r <= index_r + 1;
+            output_valid <= 1;
+        end
+        else if( output_enable && maxis_tready ) begin
+            output_valid <= 0;
+        end
+
+        frame_count <= frame_count + (write_enable && saxis_tlast) - (output_enable && maxis_tready && output_data[8]);
+
+        if( output_accepted ) begin
+            in_frame <= !maxis_tlast;
+        end
+
+        if( underrun ) begin
+            aborting <= 1;
+            underrun_count <= underrun_count + 1;
+        end
+        else if( aborting && maxis_tready ) begin
+            aborting <= 0;
+        end
+
+        // The input frame of an underrun is still being written, because its last byte is not output.
+        if( underrun ) begin
+            discarding <= !(input_accepted && saxis_tlast);
+        end
+        else if( discarding && input_accepted && saxis_tlast ) begin
+            discarding <= 0;
+        end
+    end
+end
+
+endmodule
+
+`default_nettype wire
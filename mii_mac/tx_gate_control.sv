@@ -0,0 +1,266 @@
+`default_nettype none
+
+// Gate control list of the transmission (IEEE 802.1Qbv time-aware shaper).
+// The gates of the payload (tx_saxis and the MAC control frames) and the bypass frames are opened and closed
+// by a cyclic list of entries, each of which holds the gate states for its interval, driven by the time base.
+// The schedule starts at BASE time and the entries follow back to back, so the cycle time is the sum of the intervals.
+// A gate is held from GUARD_BAND nanoseconds before it closes, so that a frame started in the window ends in it.
+// The time until the gate closes is looked ahead through the next entry. Beyond it, the gate is assumed to close.
+// The hold outputs go to axis_frame_gate in front of axis_mux, so a frame already started is never cut.
+//
+// Registers (32bit access only)
+//   0x00 CONTROL            RW  bit0: enable. Writing this register (re)starts the schedule at BASE.
+//                               While disabled or before BASE, both gates are open. The guard band applies to the first entry.
+//   0x04 STATUS             R   bit0: running (BASE has been reached), bit1: payload gate open, bit2: bypass gate open,
+//                               bit3: payload held, bit4: bypass held, bit15-8: current entry
+//   0x08 BASE_SECONDS_HI    RW  BASE[47:32]
+//   0x0c BASE_SECONDS_LO    RW  BASE[31:0]
+//   0x10 BASE_NANOSECONDS   RW
+//   0x14 LIST_LENGTH        RW  entries in the cycle (1 to ENTRIES)
+//   0x18 GUARD_BAND         RW  nanoseconds. At least the time of the longest frame with the preamble.
+//                               With MACsec, also the SecTAG, the ICV and the start threshold of its FIFO.
+//   0x1c CYCLE_COUNT        R   cycles completed since the start
+//   0x80 + 8*n ENTRY_GATES    RW  bit0: payload gate open, bit1: bypass gate open
+//   0x84 + 8*n ENTRY_INTERVAL RW  nanoseconds (1 to 999999999). Must be longer than a few clocks.
+module tx_gate_control #(
+    parameter int ENTRIES = 8,                          // 1 to 16
+    parameter int ADDR_BITS = 8,
+    parameter int DEFAULT_GUARD_BAND = 123360           // (8 + 1522 + 12) bytes at 100Mbps, set by mii_mac with MACsec
+) (
+    input wire clock,
+    input wire aresetn,
+
+    // Time base (clock domain)
+    input wire [47:0] time_seconds,
+    input wire [31:0] time_nanoseconds,
+
+    output logic hold_payload,
+    output logic hold_bypass,
+
+    input  wire  [ADDR_BITS-1:0] s_axi_awaddr,
+    input  wire                  s_axi_awvalid,
+    output logic                 s_axi_awready,
+    input  wire  [31:0]          s_axi_wdata,
+    input  wire  [3:0]           s_axi_wstrb,
+    input  wire                  s_axi_wvalid,
+    output logic                 s_axi_wready,
+    output logic [1:0]           s_axi_bresp,
+    output logic                 s_axi_bvalid,
+    input  wire                  s_axi_bready,
+    input  wire  [ADDR_BITS-1:0] s_axi_araddr,
+    input  wire                  s_axi_arvalid,
+    output logic                 s_axi_arready,
+    output logic [31:0]          s_axi_rdata,
+    output logic [1:0]           s_axi_rresp,
+    output logic                 s_axi_rvalid,
+    input  wire                  s_axi_rready
+);
+
+localparam int ENTRY_BITS = ENTRIES > 1 ? $clog2(ENTRIES) : 1;
+localparam bit [31:0] NANOSECONDS_PER_SECOND = 32'd1000000000;
+
+localparam int REG_CONTROL = 0;
+localparam int REG_STATUS = 1;
+localparam int REG_BASE_SECONDS_HI = 2;
+localparam int REG_BASE_SECONDS_LO = 3;
+localparam int REG_BASE_NANOSECONDS = 4;
+localparam int REG_LIST_LENGTH = 5;
+localparam int REG_GUARD_BAND = 6;
+localparam int REG_CYCLE_COUNT = 7;
+localparam int REG_ENTRY = 32;
+
+logic        enable;
+logic        restart;
+logic [47:0] base_seconds;
+logic [31:0] base_nanoseconds;
+logic [ENTRY_BITS:0] list_length;
+logic [31:0] guard_band;
+logic [31:0] cycle_count;
+logic [1:0]  entry_gates[ENTRIES-1:0];
+logic [31:0] entry_intervals[ENTRIES-1:0];
+
+logic        running;
+logic [ENTRY_BITS-1:0] entry;
+logic [1:0]  gates_open;
+
+// AXI4-Lite write
+logic write_enable;
+logic [ADDR_BITS-3:0] write_index;
+assign write_enable = s_axi_awvalid && s_axi_wvalid && !s_axi_bvalid;
+assign write_index = s_axi_awaddr[ADDR_BITS-1:2];
+assign s_axi_awready = write_enable;
+assign s_axi_wready = write_enable;
+assign s_axi_bresp = 2'b00;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        s_axi_bvalid <= 0;
+        enable <= 0;
+        restart <= 0;
+        base_seconds <= 0;
+        base_nanoseconds <= 0;
+        list_length <= 1;
+        guard_band <= DEFAULT_GUARD_BAND;
+        for(int i = 0; i < ENTRIES; i++) begin
+            entry_gates[i] <= 2'b11;
+            entry_intervals[i] <= NANOSECONDS_PER_SECOND - 1;
+        end
+    end
+    else begin
+        restart <= 0;
+        if( s_axi_bvalid && s_axi_bready ) begin
+            s_axi_bvalid <= 0;
+        end
+        if( write_enable ) begin
+            s_axi_bvalid <= 1;
+            case(write_index)
+            REG_CONTROL: begin
+                enable <= s_axi_wdata[0];
+                restart <= 1;
+            end
+            REG_BASE_SECONDS_HI: base_seconds[47:32] <= s_axi_wdata[15:0];
+            REG_BASE_SECONDS_LO: base_seconds[31:0] <= s_axi_wdata;
+            REG_BASE_NANOSECONDS: base_nanoseconds <= s_axi_wdata;
+            REG_LIST_LENGTH: list_length <= s_axi_wdata == 0 ? 1 : s_axi_wdata > ENTRIES ? ENTRIES : s_axi_wdata[ENTRY_BITS:0];
+            REG_GUARD_BAND: guard_band <= s_axi_wdata;
+            default: begin
+                for(int i = 0; i < ENTRIES; i++) begin
+                    if( write_index == REG_ENTRY + i*2 ) entry_gates[i] <= s_axi_wdata[1:0];
+                    if( write_index == REG_ENTRY + i*2 + 1 ) entry_intervals[i] <= s_axi_wdata;
+                end
+            end
+            endcase
+        end
+    end
+end
+
+// AXI4-Lite read
+logic [ADDR_BITS-3:0] read_index;
+assign read_index = s_axi_araddr[ADDR_BITS-1:2];
+assign s_axi_arready = !s_axi_rvalid;
+assign s_axi_rresp = 2'b00;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        s_axi_rvalid <= 0;
+        s_axi_rdata <= 0;
+    end
+    else begin
+        if( s_axi_rvalid && s_axi_rready ) begin
+            s_axi_rvalid <= 0;
+        end
+        if( s_axi_arvalid && s_axi_arready ) begin
+            s_axi_rvalid <= 1;
+            case(read_index)
+            REG_CONTROL: s_axi_rdata <= {31'b0, enable};
+            REG_STATUS: s_axi_rdata <= {16'b0, 8'(entry), 3'b0, hold_bypass, hold_payload, gates_open, running};
+            REG_BASE_SECONDS_HI: s_axi_rdata <= {16'b0, base_seconds[47:32]};
+            REG_BASE_SECONDS_LO: s_axi_rdata <= base_seconds[31:0];
+            REG_BASE_NANOSECONDS: s_axi_rdata <= base_nanoseconds;
+            REG_LIST_LENGTH: s_axi_rdata <= 32'(list_length);
+            REG_GUARD_BAND: s_axi_rdata <= guard_band;
+            REG_CYCLE_COUNT: s_axi_rdata <= cycle_count;
+            default: begin
+                s_axi_rdata <= 0;
+                for(int i = 0; i < ENTRIES; i++) begin
+                    if( read_index == REG_ENTRY + i*2 ) s_axi_rdata <= {30'b0, entry_gates[i]};
+                    if( read_index == REG_ENTRY + i*2 + 1 ) s_axi_rdata <= entry_intervals[i];
+                end
+            end
+            endcase
+        end
+    end
+end
+
+// Schedule
+logic [47:0] end_seconds;       // End of the current entry
+logic [31:0] end_nanoseconds;
+
+wire [ENTRY_BITS-1:0] next_entry = entry >= list_length - 1 ? 0 : entry + 1;
+wire base_reached = {time_seconds, time_nanoseconds} >= {base_seconds, base_nanoseconds};
+wire entry_ended = {time_seconds, time_nanoseconds} >= {end_seconds, end_nanoseconds};
+
+// Adds the interval (less than a second) to the time.
+function automatic logic [79:0] add_interval(input logic [47:0] seconds, input logic [31:0] nanoseconds, input logic [31:0] interval);
+    logic [32:0] sum;
+    sum = nanoseconds + interval;
+    if( sum >= NANOSECONDS_PER_SECOND ) begin
+        return {seconds + 48'd1, 32'(sum - NANOSECONDS_PER_SECOND)};
+    end
+    return {seconds, sum[31:0]};
+endfunction
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        running <= 0;
+        entry <= 0;
+        end_seconds <= 0;
+        end_nanoseconds <= 0;
+        cycle_count <= 0;
+    end
+    else begin
+        if( !enable || restart ) begin
+            running <= 0;
+            entry <= 0;
+            cycle_count <= 0;
+        end
+        else if( !running ) begin
+            if( base_reached ) begin
+                running <= 1;
+                {end_seconds, end_nanoseconds} <= add_interval(base_seconds, base_nanoseconds, entry_intervals[0]);
+            end
+        end
+        else if( entry_ended ) begin
+            entry <= next_entry;
+            {end_seconds, end_nanoseconds} <= add_interval(end_seconds, end_nanoseconds, entry_intervals[next_entry]);
+            if( next_entry == 0 ) begin
+                cycle_count <= cycle_count + 1;
+            end
+        end
+    end
+end
+
+// Nanoseconds until the next change of the entries, saturated.
+// Before BASE, the first entry is ahead, so that the guard band also applies to the start of the schedule.
+wire [47:0] boundary_seconds = running ? end_seconds : base_seconds;
+wire [31:0] boundary_nanoseconds = running ? end_nanoseconds : base_nanoseconds;
+wire [ENTRY_BITS-1:0] upcoming_entry = running ? next_entry : 0;
+logic [33:0] remaining;
+always_comb begin
+    if( running ? entry_ended : base_reached ) begin
+        remaining = 0;
+    end
+    else if( boundary_seconds == time_seconds ) begin
+        remaining = boundary_nanoseconds - time_nanoseconds;
+    end
+    else if( boundary_seconds == time_seconds + 1 ) begin
+        remaining = boundary_nanoseconds + NANOSECONDS_PER_SECOND - time_nanoseconds;
+    end
+    else begin
+        remaining = 34'h1_0000_0000;
+    end
+end
+
+assign gates_open = running ? entry_gates[entry] : 2'b11;
+wire [1:0]  upcoming_gates_open = entry_gates[upcoming_entry];
+wire [33:0] open_payload = remaining + (upcoming_gates_open[0] ? entry_intervals[upcoming_entry] : 0);
+wire [33:0] open_bypass = remaining + (upcoming_gates_open[1] ? entry_intervals[upcoming_entry] : 0);
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        hold_payload <= 0;
+        hold_bypass <= 0;
+    end
+    else if( !enable || restart ) begin
+        hold_payload <= 0;
+        hold_bypass <= 0;
+    end
+    else begin
+        hold_payload <= !gates_open[0] || open_payload < guard_band;
+        hold_bypass <= !gates_open[1] || open_bypass < guard_band;
+    end
+end
+
+endmodule
+
+`default_nettype wire
@@ -0,0 +1,321 @@
+`default_nettype none
+
+// Timestamps PTP event messages sent from the PS through the bypass path and optionally updates one-step Sync messages.
+// The bypass stream contains the preamble, the SFD and the FCS generated by the PS.
+// With MACsec, mii_mac_tx places it just before the line, where it sees the frames without the SecTAG from both inputs.
+//
+// In one-step mode, a frame which may be a Sync message is delayed by DELAY octets so that the fields after
+// the correctionField are known when it is output. The frame is released as soon as the parser finds it is not
+// a PTP event message, and nothing is delayed in two-step mode. Only one frame is held at a time.
+//
+// In one-step mode, Sync messages without twoStepFlag get the time from originTimestamp to the SFD added to correctionField.
+// The software writes the current time into originTimestamp (within 4 seconds before the transmission).
+// The UDP checksum (unless it is zero on IPv4) and the FCS are updated incrementally for the change.
+//
+// A frame with tuser on the last octet is aborted. The last octet is inverted if needed so that the FCS check fails,
+// and no event record is output for it.
+//
+// Event record on event_maxis (one for each PTP event message):
+//   [31:0]    nanoseconds of the SFD
+//   [79:32]   seconds of the SFD
+//   [95:80]   sequenceId
+//   [103:96]  domainNumber
+//   [107:104] messageType
+//   [109:108] transport (1: Ethernet, 2: UDP/IPv4, 3: UDP/IPv6)
+//   [110]     correctionField was updated by one-step
+module tx_ptp_event #(
+    parameter int DELAY = 48
+) (
+    input wire clock,
+    input wire aresetn,
+
+    input  wire        one_step,
+
+    // SFD time of the frame being transmitted.
+    input  wire [47:0] timestamp_seconds,
+    input  wire [31:0] timestamp_nanoseconds,
+
+    input  wire [7:0] saxis_tdata,
+    input  wire       saxis_tvalid,
+    output wire       saxis_tready,
+    input  wire       saxis_tuser,
+    input  wire       saxis_tlast,
+
+    output wire [7:0] maxis_tdata,
+    output wire       maxis_tvalid,
+    input  wire       maxis_tready,
+    output wire       maxis_tuser,
+    output wire       maxis_tlast,
+
+    output logic [127:0] event_maxis_tdata,
+    output logic         event_maxis_tvalid,
+    input  wire          event_maxis_tready
+);
+
+localparam bit [7:0] PREAMBLE = 8'h55;
+localparam bit [1:0] TRANSPORT_UDPV4 = 2'd2;
+localparam bit [31:0] POLYNOMIAL = 32'b1110_1101_1011_1000_1000_0011_0010_0000;
+localparam bit [31:0] NANOSECONDS_PER_SECOND = 32'd1000000000;
+localparam bit [31:0] CRC_RESIDUE = 32'hdebb20e3;     // CRC register after a frame with the correct FCS
+
+typedef struct packed {
+    bit [7:0] tdata;
+    bit       tuser;
+    bit       tlast;
+} fifo_data_t;
+
+fifo_data_t fifo_in_tdata;
+logic       fifo_in_tvalid;
+logic       fifo_in_tready;
+
+fifo_data_t fifo_out_tdata;
+logic       fifo_out_tvalid;
+logic       fifo_out_tready;
+
+simple_fifo #(.DATA_BITS($bits(fifo_data_t)), .DEPTH_BITS($clog2(DELAY + 2))) fifo_inst (
+    .saxis_tdata (fifo_in_tdata ),
+    .saxis_tvalid(fifo_in_tvalid),
+    .saxis_tready(fifo_in_tready),
+    .maxis_tdata (fifo_out_tdata ),
+    .maxis_tvalid(fifo_out_tvalid),
+    .maxis_tready(fifo_out_tready),
+    .*
+);
+
+// Input side
+logic        input_done;        // The whole frame has been input. The next frame waits until the frame is output.
+logic        input_preamble;
+logic [10:0] input_count;       // Octets input including the preamble.
+logic [10:0] frame_length;      // Octets after the SFD including the FCS.
+logic        one_step_enabled;
+logic        candidate;         // The frame may be a one-step Sync message and is delayed.
+
+logic        input_valid;
+assign saxis_tready = fifo_in_tready && !input_done;
+assign input_valid = saxis_tvalid && saxis_tready;
+assign fifo_in_tdata = '{tdata: saxis_tdata, tuser: saxis_tuser, tlast: saxis_tlast};
+assign fifo_in_tvalid = saxis_tvalid && !input_done;
+
+logic [10:0] parser_offset;
+logic        not_event;
+logic        is_event;
+logic [1:0]  transport;
+logic [10:0] udp_offset;
+logic [10:0] ptp_offset;
+logic [15:0] udp_checksum;
+logic [3:0]  message_type;
+logic [7:0]  domain_number;
+logic        two_step;
+logic [63:0] correction;
+logic [15:0] sequence_id;
+logic        origin_valid;
+logic [47:0] origin_seconds;
+logic [31:0] origin_nanoseconds;
+
+ptp_parser parser_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .tdata(saxis_tdata),
+    .tvalid(input_valid && !input_preamble),
+    .tlast(saxis_tlast),
+    .offset(parser_offset),
+    .*
+);
+
+// Output side
+logic        output_enable;
+logic        output_valid;
+logic        output_preamble;
+logic [10:0] output_count;      // Octets output including the preamble.
+logic [10:0] output_offset;     // Offset of the octet after the SFD.
+logic [10:0] ptp_relative_offset;
+logic [10:0] udp_relative_offset;
+logic [10:0] fcs_relative_offset;
+
+assign output_enable = input_done || !candidate || input_count - output_count > DELAY;
+assign output_valid = maxis_tvalid && maxis_tready;
+assign ptp_relative_offset = output_offset - ptp_offset;
+assign udp_relative_offset = output_offset - udp_offset;
+assign fcs_relative_offset = output_offset - (frame_length - 4);
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        input_done <= 0;
+        input_preamble <= 1;
+        input_count <= 0;
+        frame_length <= 0;
+        one_step_enabled <= 0;
+        candidate <= 0;
+        output_preamble <= 1;
+        output_count <= 0;
+        output_offset <= 0;
+    end
+    else begin
+        if( input_valid ) begin
+            input_count <= input_count + 1;
+            if( input_count == 0 ) begin
+                one_step_enabled <= one_step;
+                candidate <= one_step;
+            end
+            if( input_preamble && saxis_tdata != PREAMBLE ) begin
+                input_preamble <= 0;
+            end
+            if( saxis_tlast ) begin
+                input_done <= 1;
+                frame_length <= input_preamble ? 0 : parser_offset + 1;
+            end
+        end
+        // The parser holds the stage of the previous frame until the first octet of the frame.
+        // Once released, the frame is not held again so that the output does not stall within the frame.
+        if( parser_offset != 0 && not_event ) begin
+            candidate <= 0;
+        end
+        if( output_valid ) begin
+            output_count <= output_count + 1;
+            if( output_preamble ) begin
+                if( maxis_tdata != PREAMBLE ) begin
+                    output_preamble <= 0;
+                end
+            end
+            else begin
+                output_offset <= output_offset + 1;
+            end
+            if( maxis_tlast ) begin
+                input_done <= 0;
+                input_preamble <= 1;
+                input_count <= 0;
+                output_preamble <= 1;
+                output_count <= 0;
+                output_offset <= 0;
+            end
+        end
+    end
+end
+
+// One-step correction
+// residence = (SFD time - originTimestamp) in nanoseconds, correctionField is in 2^-16 nanoseconds.
+logic [47:0]        seconds_difference;
+logic signed [32:0] nanoseconds_difference;
+logic signed [47:0] residence;
+logic               residence_in_range;
+logic [63:0]        new_correction;
+logic               update_correction;
+
+always_ff @(posedge clock) begin
+    seconds_difference <= timestamp_seconds - origin_seconds;
+    nanoseconds_difference <= $signed({1'b0, timestamp_nanoseconds}) - $signed({1'b0, origin_nanoseconds});
+    residence <= $signed({46'b0, seconds_difference[1:0]}) * $signed({16'b0, NANOSECONDS_PER_SECOND}) + nanoseconds_difference;
+    residence_in_range <= seconds_difference < 4;
+    new_correction <= correction + {residence, 16'b0};
+end
+
+assign update_correction = one_step_enabled && is_event && message_type == 0 && !two_step && origin_valid && residence_in_range;
+
+// Incremental update of the UDP checksum (RFC 1624): HC' = ~(~HC + ~m + m')
+logic [15:0] checksum_terms[9];
+logic [19:0] checksum_sum;
+logic [16:0] checksum_folded;
+logic [15:0] checksum_result;
+logic [15:0] new_checksum;
+logic        update_checksum;
+
+assign checksum_terms = '{
+    ~udp_checksum,
+    ~correction[63:48], ~correction[47:32], ~correction[31:16], ~correction[15:0],
+    new_correction[63:48], new_correction[47:32], new_correction[31:16], new_correction[15:0]
+};
+assign checksum_result = ~(checksum_folded[15:0] + checksum_folded[16]);
+
+always_ff @(posedge clock) begin
+    checksum_sum <= checksum_terms[0] + checksum_terms[1] + checksum_terms[2] + checksum_terms[3] + checksum_terms[4]
+                  + checksum_terms[5] + checksum_terms[6] + checksum_terms[7] + checksum_terms[8];
+    checksum_folded <= checksum_sum[15:0] + checksum_sum[19:16];
+    // Zero means no checksum in UDP.
+    new_checksum <= checksum_result == 0 ? 16'hffff : checksum_result;
+end
+
+assign update_checksum = update_correction && transport >= TRANSPORT_UDPV4 && !(transport == TRANSPORT_UDPV4 && udp_checksum == 0);
+
+// CRC of the difference from the original frame without the initial value and the final inversion.
+// Since the CRC is linear, the new FCS is the original FCS xor the CRC of the difference.
+function automatic logic [31:0] crc_step(input logic [31:0] remainder, input logic [7:0] data);
+    logic [31:0] value;
+    value = {remainder[31:8], remainder[7:0] ^ data};
+    for(int i = 0; i < 8; i++) begin
+        value = {1'b0, value[31:1]} ^ (value[0] ? POLYNOMIAL : 32'b0);
+    end
+    return value;
+endfunction
+
+logic [31:0] crc_difference;
+logic [31:0] crc_output;        // CRC of the octets output after the SFD
+logic [7:0]  updated_tdata;
+logic [7:0]  output_tdata;
+logic        in_fcs;
+
+assign in_fcs = input_done && output_offset >= frame_length - 4;
+
+always_comb begin
+    updated_tdata = fifo_out_tdata.tdata;
+    if( !output_preamble ) begin
+        if( update_correction && ptp_relative_offset >= 8 && ptp_relative_offset < 16 ) begin
+            updated_tdata = new_correction[8*(15 - ptp_relative_offset) +: 8];
+        end
+        if( update_checksum && udp_relative_offset >= 6 && udp_relative_offset < 8 ) begin
+            updated_tdata = new_checksum[8*(7 - udp_relative_offset) +: 8];
+        end
+        if( in_fcs ) begin
+            updated_tdata = fifo_out_tdata.tdata ^ crc_difference[8*fcs_relative_offset[1:0] +: 8];
+        end
+    end
+end
+
+// The CRC step is a bijection of the octet, so the inverted octet never gives the residue.
+assign output_tdata = fifo_out_tdata.tuser && fifo_out_tdata.tlast && !output_preamble && crc_step(crc_output, updated_tdata) == CRC_RESIDUE
+                    ? ~updated_tdata : updated_tdata;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        crc_difference <= 0;
+        crc_output <= '1;
+    end
+    else if( output_valid ) begin
+        if( maxis_tlast ) begin
+            crc_difference <= 0;
+            crc_output <= '1;
+        end
+        else if( !output_preamble ) begin
+            if( !in_fcs ) begin
+                crc_difference <= crc_step(crc_difference, output_tdata ^ fifo_out_tdata.tdata);
+            end
+            crc_output <= crc_step(crc_output, output_tdata);
+        end
+    end
+end
+
+assign maxis_tdata  = output_tdata;
+assign maxis_tvalid = fifo_out_tvalid && output_enable;
+assign fifo_out_tready = maxis_tready && output_enable;
+assign maxis_tuser  = fifo_out_tdata.tuser;
+assign maxis_tlast  = fifo_out_tdata.tlast;
+
+// Event record
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        event_maxis_tdata <= 0;
+        event_maxis_tvalid <= 0;
+    end
+    else begin
+        if( event_maxis_tvalid && event_maxis_tready ) begin
+            event_maxis_tvalid <= 0;
+        end
+        if( output_valid && maxis_tlast && !maxis_tuser && is_event ) begin
+            event_maxis_tdata <= {17'b0, update_correction, transport, message_type, domain_number, sequence_id, timestamp_seconds, timestamp_nanoseconds};
+            event_maxis_tvalid <= 1;
+        end
+    end
+end
+
+endmodule
+
+`default_nettype wire
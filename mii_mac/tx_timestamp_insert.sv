@@ -0,0 +1,164 @@
+`default_nettype none
+
+// Overwrites the transmit timestamp of NTP server replies with the SFD time of the frame on the fly.
+// The frame is checked while it passes through: IPv4 without options (with up to two VLAN tags), UDP from port 123
+// without checksum (zero) and NTP mode 4 (server). Other frames, including replies with a UDP checksum which would be
+// broken by the change, pass through unchanged.
+// The transmit timestamp is at least 82 octets from the beginning of the frame, and timestamp_seconds and
+// timestamp_nanoseconds must already hold the SFD time of the current frame when it passes here.
+// On the payload path of mii_mac_tx without MACsec, only the FCS and preamble insertion and the arbiter follow
+// this module, which hold far fewer octets than that. With MACsec, the SecTAG and the ICV are inserted and the frames
+// are buffered in the cut-through FIFO after the arbiter, so the previous frame may still be on the line when the
+// timestamp passes the payload path. mii_mac_tx then places this module just before the line with LINE_SIDE,
+// where the stream contains the preamble, the SFD and the FCS, and the FCS is updated for the change.
+// Only the replies sent without the SecTAG can be parsed there, and protected replies keep the timestamp written by the sender.
+module tx_timestamp_insert #(
+    parameter bit LINE_SIDE = 0
+) (
+    input wire clock,
+    input wire aresetn,
+
+    input  wire [47:0] timestamp_seconds,
+    input  wire [31:0] timestamp_nanoseconds,
+
+    input  wire [7:0] saxis_tdata,
+    input  wire       saxis_tvalid,
+    output wire       saxis_tready,
+    input  wire       saxis_tuser,
+    input  wire       saxis_tlast,
+
+    output wire [7:0] maxis_tdata,
+    output wire       maxis_tvalid,
+    input  wire       maxis_tready,
+    output wire       maxis_tuser,
+    output wire       maxis_tlast
+);
+
+localparam bit [7:0] PREAMBLE = 8'h55;
+localparam bit [31:0] POLYNOMIAL = 32'b1110_1101_1011_1000_1000_0011_0010_0000;
+localparam bit [31:0] NTP_UNIX_EPOCH_OFFSET = 32'd2208988800;
+localparam bit [15:0] NTP_PORT = 16'd123;
+localparam int NTP_TRANSMIT_TIMESTAMP_OFFSET = 20 + 8 + 40;  // from the beginning of the IP header
+
+// NTP timestamp of the SFD time.
+// fraction = nanoseconds * 2^32 / 10^9 = nanoseconds * 4 + nanoseconds * 0.294967296
+logic [63:0] fraction_product;
+logic [63:0] ntp_timestamp;
+
+always_ff @(posedge clock) begin
+    fraction_product <= timestamp_nanoseconds * 64'd1266874890;
+    ntp_timestamp <= {timestamp_seconds[31:0] + NTP_UNIX_EPOCH_OFFSET, (timestamp_nanoseconds << 2) + fraction_product[63:32]};
+end
+
+logic        preamble;          // The preamble and the SFD are passing. (LINE_SIDE)
+logic [10:0] offset;            // Offset of the current octet from the beginning of the frame (after the SFD).
+logic [10:0] ip_offset;         // Offset of the IP header.
+logic [10:0] ip_relative_offset;
+logic [10:0] ip_length;         // Total length of the IP packet, all ones until it is parsed.
+logic [11:0] fcs_offset;
+logic [7:0]  prev_tdata;
+logic        is_ntp_reply;      // Cleared when the frame turns out not to be an NTP server reply.
+logic        replace;
+logic        in_fcs;
+
+assign ip_relative_offset = offset - ip_offset;
+assign replace = !preamble && is_ntp_reply && ip_relative_offset >= NTP_TRANSMIT_TIMESTAMP_OFFSET && ip_relative_offset < NTP_TRANSMIT_TIMESTAMP_OFFSET + 8;
+// The reply ends with the IP packet, since it is longer than the minimum frame.
+assign fcs_offset = ip_offset + ip_length;
+assign in_fcs = LINE_SIDE && !preamble && is_ntp_reply && offset >= fcs_offset && offset < fcs_offset + 4;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        preamble <= LINE_SIDE;
+        offset <= 0;
+        ip_offset <= 14;
+        ip_length <= '1;
+        prev_tdata <= 0;
+        is_ntp_reply <= 1;
+    end
+    else if( saxis_tvalid && saxis_tready ) begin
+        prev_tdata <= saxis_tdata;
+        if( saxis_tlast ) begin
+            preamble <= LINE_SIDE;
+            offset <= 0;
+            ip_offset <= 14;
+            ip_length <= '1;
+            is_ntp_reply <= 1;
+        end
+        else if( preamble ) begin
+            if( saxis_tdata != PREAMBLE ) begin
+                preamble <= 0;                                                  // SFD
+            end
+        end
+        else begin
+            if( offset != '1 ) begin
+                offset <= offset + 1;
+            end
+            // EtherType
+            if( offset == ip_offset - 1 ) begin
+                if( ({prev_tdata, saxis_tdata} == 16'h8100 || {prev_tdata, saxis_tdata} == 16'h88a8) && ip_offset < 22 ) begin
+                    ip_offset <= ip_offset + 4;
+                end
+                else if( {prev_tdata, saxis_tdata} != 16'h0800 ) begin
+                    is_ntp_reply <= 0;
+                end
+            end
+            case(ip_relative_offset)
+            0:  if( saxis_tdata != 8'h45 ) is_ntp_reply <= 0;                   // IPv4 without options
+            2:  begin                                                           // Total length
+                ip_length[10:8] <= saxis_tdata[2:0];
+                if( saxis_tdata[7:3] != 0 ) is_ntp_reply <= 0;
+            end
+            3:  ip_length[7:0] <= saxis_tdata;
+            9:  if( saxis_tdata != 8'h11 ) is_ntp_reply <= 0;                   // UDP
+            20: if( saxis_tdata != NTP_PORT[15:8] ) is_ntp_reply <= 0;         // Source port
+            21: if( saxis_tdata != NTP_PORT[7:0] ) is_ntp_reply <= 0;
+            26, 27: if( saxis_tdata != 0 ) is_ntp_reply <= 0;                // UDP checksum
+            28: if( saxis_tdata[2:0] != 3'd4 ) is_ntp_reply <= 0;              // Mode: server
+            default: ;
+            endcase
+        end
+    end
+end
+
+// CRC of the difference from the original frame without the initial value and the final inversion.
+// Since the CRC is linear, the new FCS is the original FCS xor the CRC of the difference. (see tx_ptp_event)
+function automatic logic [31:0] crc_step(input logic [31:0] remainder, input logic [7:0] data);
+    logic [31:0] value;
+    value = {remainder[31:8], remainder[7:0] ^ data};
+    for(int i = 0; i < 8; i++) begin
+        value = {1'b0, value[31:1]} ^ (value[0] ? POLYNOMIAL : 32'b0);
+    end
+    return value;
+endfunction
+
+logic [31:0] crc_difference;
+logic [11:0] fcs_relative_offset;
+
+assign fcs_relative_offset = offset - fcs_offset;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        crc_difference <= 0;
+    end
+    else if( saxis_tvalid && saxis_tready ) begin
+        if( saxis_tlast ) begin
+            crc_difference <= 0;
+        end
+        else if( !preamble && !in_fcs ) begin
+            crc_difference <= crc_step(crc_difference, maxis_tdata ^ saxis_tdata);
+        end
+    end
+end
+
+assign maxis_tdata  = replace ? ntp_timestamp[8*(NTP_TRANSMIT_TIMESTAMP_OFFSET + 7 - ip_relative_offset) +: 8]
+                    : in_fcs ? saxis_tdata ^ crc_difference[8*fcs_relative_offset[1:0] +: 8]
+                    : saxis_tdata;
+assign maxis_tvalid = saxis_tvalid;
+assign saxis_tready = maxis_tready;
+assign maxis_tuser  = saxis_tuser;
+assign maxis_tlast  = saxis_tlast;
+
+endmodule
+
+`default_nettype wire
@@ -0,0 +1,149 @@
+`default_nettype none
+
+// Extracts the fields the capture filters match from a frame passing through.
+// The frame starts from the destination MAC address and may have up to two VLAN tags.
+// The ports are extracted from TCP and UDP over IPv4, except for the non-first fragments.
+//
+// The fields are updated while the frame passes and hold their values after the last octet of the frame
+// until the first octet of the next frame, so they can be sampled at tlast and the cycle after it.
+module capture_parser (
+    input wire clock,
+    input wire aresetn,
+
+    // Octet of the frame. tvalid must be qualified with tready.
+    input wire [7:0] tdata,
+    input wire       tvalid,
+    input wire       tlast,
+
+    output logic [15:0] ethertype,              // EtherType after the VLAN tags
+    output logic        ipv4,                   // The IPv4 header is received up to the destination address.
+    output logic [7:0]  protocol,
+    output logic [31:0] source_address,
+    output logic [31:0] destination_address,
+    output logic        l4,                     // The TCP or UDP header is received up to the destination port.
+    output logic [15:0] source_port,
+    output logic [15:0] destination_port
+);
+
+localparam bit [7:0] PROTOCOL_TCP = 8'd6;
+localparam bit [7:0] PROTOCOL_UDP = 8'd17;
+
+typedef enum {
+    S_ETHERNET,
+    S_IPV4,
+    S_L4,
+    S_OTHER
+} stage_t;
+
+stage_t stage = S_ETHERNET;
+
+logic [10:0] offset;                // Offset of the next octet from the beginning of the frame.
+logic [10:0] base;                  // Offset of the header being parsed.
+logic [10:0] relative_offset;
+logic [10:0] ethertype_offset;      // Offset of the second octet of the EtherType.
+logic [5:0]  ipv4_header_length;
+logic        fragment;              // Not the first fragment
+logic [7:0]  prev_tdata;
+
+assign relative_offset = offset - base;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        stage <= S_ETHERNET;
+        offset <= 0;
+        base <= 0;
+        ethertype_offset <= 13;
+        ipv4_header_length <= 0;
+        fragment <= 0;
+        prev_tdata <= 0;
+        ethertype <= 0;
+        ipv4 <= 0;
+        protocol <= 0;
+        source_address <= 0;
+        destination_address <= 0;
+        l4 <= 0;
+        source_port <= 0;
+        destination_port <= 0;
+    end
+    else if( tvalid ) begin
+        prev_tdata <= tdata;
+        if( tlast ) begin
+            offset <= 0;
+        end
+        else if( offset != '1 ) begin
+            offset <= offset + 1;
+        end
+
+        if( offset == 0 ) begin
+            stage <= S_ETHERNET;
+            ethertype_offset <= 13;
+            ipv4_header_length <= 0;
+            fragment <= 0;
+            ethertype <= 0;
+            ipv4 <= 0;
+            protocol <= 0;
+            l4 <= 0;
+        end
+        else begin
+            case(stage)
+            S_ETHERNET: begin
+                if( offset == ethertype_offset ) begin
+                    base <= offset + 1;
+                    ethertype <= {prev_tdata, tdata};
+                    case({prev_tdata, tdata})
+                    16'h8100, 16'h88a8: begin
+                        if( ethertype_offset < 21 ) begin
+                            ethertype_offset <= ethertype_offset + 4;
+                        end
+                        else begin
+                            stage <= S_OTHER;
+                        end
+                    end
+                    16'h0800: stage <= S_IPV4;
+                    default:  stage <= S_OTHER;
+                    endcase
+                end
+            end
+            S_IPV4: begin
+                case(relative_offset)
+                0: begin
+                    ipv4_header_length <= {tdata[3:0], 2'b00};
+                    if( tdata[7:4] != 4 || tdata[3:0] < 5 ) stage <= S_OTHER;
+                end
+                6:  if( tdata[4:0] != 0 ) fragment <= 1;
+                7:  if( tdata != 0 ) fragment <= 1;
+                9:  protocol <= tdata;
+                12, 13, 14, 15: source_address <= {source_address[23:0], tdata};
+                16, 17, 18:     destination_address <= {destination_address[23:0], tdata};
+                19: begin
+                    destination_address <= {destination_address[23:0], tdata};
+                    ipv4 <= 1;
+                end
+                default: ;
+                endcase
+                if( relative_offset >= 19 && relative_offset == ipv4_header_length - 1 ) begin
+                    base <= offset + 1;
+                    stage <= !fragment && (protocol == PROTOCOL_TCP || protocol == PROTOCOL_UDP) ? S_L4 : S_OTHER;
+                end
+            end
+            S_L4: begin
+                case(relative_offset)
+                0, 1: source_port <= {source_port[7:0], tdata};
+                2:    destination_port <= {destination_port[7:0], tdata};
+                3: begin
+                    destination_port <= {destination_port[7:0], tdata};
+                    l4 <= 1;
+                    stage <= S_OTHER;
+                end
+                default: ;
+                endcase
+            end
+            default: ;
+            endcase
+        end
+    end
+end
+
+endmodule
+
+`default_nettype wire
@@ -0,0 +1,237 @@
+`default_nettype none
+
+// Captures the frames on a tapped stream into a FIFO of 32bit words, the first byte from the LSB.
+// The tap is only monitored and never stalled. Up to snap_length bytes of each frame are stored, and at the end
+// of the frame it is kept if it passes the filters and dropped otherwise, so that a frame found bad at its end
+// is not output at all. A frame is also dropped if the FIFO overflows while it is stored, or if tap_abort comes
+// with its tlast (see capture_tap_cdc). An aborted frame is reported by frame_dropped even if it does not pass the
+// filters, because it may be cut before the fields.
+// The record of each frame stored is output on meta_maxis along with its words on data_maxis:
+//   bit95: error (tuser at tlast), bit94: time locked, bit93-78: frame bytes, bit77-62: captured bytes,
+//   bit61-30: seconds, bit29-0: nanoseconds of the time at the first byte of the frame
+//
+// A frame passes the filters if no filter is enabled, or any enabled filter matches it.
+// A filter matches a frame if all of the fields selected by filter_checks match:
+//   bit0: EtherType after the VLAN tags, bit1: IPv4 protocol,
+//   bit2: source or destination IPv4 address under filter_mask, bit3: source or destination TCP/UDP port,
+//   bit4: error flag equal to bit5
+module capture_tap #(
+    parameter int FIFO_DEPTH_BITS = 10,
+    parameter int META_DEPTH_BITS = 5,
+    parameter int FILTERS = 4
+) (
+    input wire clock,
+    input wire aresetn,
+
+    input wire [7:0] tap_tdata,
+    input wire       tap_tvalid,
+    input wire       tap_tready,
+    input wire       tap_tuser,
+    input wire       tap_tlast,
+    input wire       tap_abort,                 // With tlast, drops the frame.
+
+    input wire        enable,                   // Sampled at the first byte of each frame
+    input wire [15:0] snap_length,              // Bytes stored from each frame. 0 stores whole frames.
+
+    input wire [47:0] time_seconds,
+    input wire [31:0] time_nanoseconds,
+    input wire        time_locked,
+
+    input wire [FILTERS-1:0]       filter_enable,
+    input wire [FILTERS-1:0][5:0]  filter_checks,
+    input wire [FILTERS-1:0][15:0] filter_ethertype,
+    input wire [FILTERS-1:0][7:0]  filter_protocol,
+    input wire [FILTERS-1:0][31:0] filter_address,
+    input wire [FILTERS-1:0][31:0] filter_mask,
+    input wire [FILTERS-1:0][15:0] filter_port,
+
+    output wire [31:0] data_maxis_tdata,
+    output wire        data_maxis_tvalid,
+    input  wire        data_maxis_tready,
+    output wire        data_maxis_tlast,
+
+    output wire [95:0] meta_maxis_tdata,
+    output wire        meta_maxis_tvalid,
+    input  wire        meta_maxis_tready,
+
+    output wire        frame_dropped            // Asserted for a cycle when a frame passing the filters is dropped
+);
+
+localparam int CHECK_ETHERTYPE = 0;
+localparam int CHECK_PROTOCOL = 1;
+localparam int CHECK_ADDRESS = 2;
+localparam int CHECK_PORT = 3;
+localparam int CHECK_ERROR = 4;
+localparam int ERROR_VALUE = 5;
+
+logic [15:0] ethertype;
+logic        ipv4;
+logic [7:0]  protocol;
+logic [31:0] source_address;
+logic [31:0] destination_address;
+logic        l4;
+logic [15:0] source_port;
+logic [15:0] destination_port;
+
+wire beat = tap_tvalid && tap_tready;
+
+capture_parser parser_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .tdata(tap_tdata),
+    .tvalid(beat),
+    .tlast(tap_tlast),
+    .ethertype(ethertype),
+    .ipv4(ipv4),
+    .protocol(protocol),
+    .source_address(source_address),
+    .destination_address(destination_address),
+    .l4(l4),
+    .source_port(source_port),
+    .destination_port(destination_port)
+);
+
+logic [15:0] byte_index;            // Offset of the byte in the frame, saturated
+logic [31:0] pack_data;
+logic [2:0]  pack_count;            // Bytes in pack_data
+logic        flush;                 // pack_data is the last word of the frame, written in this cycle.
+logic        frame_enable;
+logic        overflow;
+logic        aborted;
+logic        frame_error;
+logic [15:0] frame_bytes;
+logic [15:0] captured_bytes;
+logic [31:0] stamp_seconds;
+logic [29:0] stamp_nanoseconds;
+logic        stamp_locked;
+
+// The fields of the frame ended by flush are held by the parser in this cycle.
+logic [FILTERS-1:0] match;
+always_comb begin
+    for(int i = 0; i < FILTERS; i++) begin
+        match[i] = filter_enable[i]
+            && (!filter_checks[i][CHECK_ETHERTYPE] || ethertype == filter_ethertype[i])
+            && (!filter_checks[i][CHECK_PROTOCOL] || ipv4 && protocol == filter_protocol[i])
+            && (!filter_checks[i][CHECK_ADDRESS] || ipv4 && (
+                    (source_address & filter_mask[i]) == (filter_address[i] & filter_mask[i]) ||
+                    (destination_address & filter_mask[i]) == (filter_address[i] & filter_mask[i])))
+            && (!filter_checks[i][CHECK_PORT] || l4 && (source_port == filter_port[i] || destination_port == filter_port[i]))
+            && (!filter_checks[i][CHECK_ERROR] || frame_error == filter_checks[i][ERROR_VALUE]);
+    end
+end
+wire pass = filter_enable == 0 || match != 0;
+
+logic        fifo_in_tready;
+logic        meta_in_tready;
+logic [FIFO_DEPTH_BITS:0] fifo_level;
+
+wire [15:0] snap = snap_length != 0 ? snap_length : 16'hffff;
+wire captured = byte_index < snap;
+// One word of the FIFO is kept for the last word of a frame, which rolls the frame back if needed.
+wire fifo_room = fifo_level < 2**FIFO_DEPTH_BITS - 1;
+wire write_word = beat && captured && pack_count == 4 && !flush && frame_enable && !overflow;
+wire keep = pass && !overflow && meta_in_tready;
+wire fifo_in_tvalid = flush && frame_enable || write_word && fifo_room;
+
+assign frame_dropped = flush && frame_enable && (pass || aborted) && !keep;
+
+packet_fifo #(
+    .DATA_BITS(32),
+    .DEPTH_BITS(FIFO_DEPTH_BITS),
+    .PACKET_MODE(1)
+) fifo_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .saxis_tdata(pack_data),
+    .saxis_tvalid(fifo_in_tvalid),
+    .saxis_tready(fifo_in_tready),
+    .saxis_tuser(flush && !keep),
+    .saxis_tlast(flush),
+    .maxis_tdata(data_maxis_tdata),
+    .maxis_tvalid(data_maxis_tvalid),
+    .maxis_tready(data_maxis_tready),
+    .maxis_tuser(),
+    .maxis_tlast(data_maxis_tlast),
+    .level(fifo_level),
+    .packet_count(),
+    .almost_full(),
+    .almost_empty());
+
+simple_fifo #(
+    .DATA_BITS(96),
+    .DEPTH_BITS(META_DEPTH_BITS)
+) meta_fifo_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .saxis_tdata({frame_error, stamp_locked, frame_bytes, captured_bytes, stamp_seconds, stamp_nanoseconds}),
+    .saxis_tvalid(flush && frame_enable && keep),
+    .saxis_tready(meta_in_tready),
+    .maxis_tdata(meta_maxis_tdata),
+    .maxis_tvalid(meta_maxis_tvalid),
+    .maxis_tready(meta_maxis_tready));
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        byte_index <= 0;
+        pack_data <= 0;
+        pack_count <= 0;
+        flush <= 0;
+        frame_enable <= 0;
+        overflow <= 0;
+        aborted <= 0;
+        frame_error <= 0;
+        frame_bytes <= 0;
+        captured_bytes <= 0;
+        stamp_seconds <= 0;
+        stamp_nanoseconds <= 0;
+        stamp_locked <= 0;
+    end
+    else begin
+        flush <= 0;
+        if( beat && captured ) begin
+            if( flush || pack_count == 4 ) begin
+                pack_data <= {24'h000000, tap_tdata};
+                pack_count <= 1;
+            end
+            else begin
+                pack_data[8*pack_count[1:0] +: 8] <= tap_tdata;
+                pack_count <= pack_count + 3'd1;
+            end
+        end
+        else if( flush ) begin
+            pack_count <= 0;
+        end
+
+        if( write_word && !fifo_room ) begin
+            overflow <= 1;
+        end
+
+        if( beat ) begin
+            if( byte_index == 0 ) begin
+                frame_enable <= enable;
+                overflow <= 0;
+                stamp_seconds <= time_seconds[31:0];
+                stamp_nanoseconds <= time_nanoseconds[29:0];
+                stamp_locked <= time_locked;
+            end
+            if( tap_tlast ) begin
+                byte_index <= 0;
+                flush <= 1;
+                aborted <= tap_abort;
+                if( tap_abort ) begin
+                    overflow <= 1;
+                end
+                frame_error <= tap_tuser;
+                frame_bytes <= byte_index + (byte_index != 16'hffff);
+                captured_bytes <= captured ? byte_index + 16'd1 : snap;
+            end
+            else if( byte_index != 16'hffff ) begin
+                byte_index <= byte_index + 16'd1;
+            end
+        end
+    end
+end
+
+endmodule
+
+`default_nettype wire
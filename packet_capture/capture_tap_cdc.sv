@@ -0,0 +1,73 @@
+`default_nettype none
+
+// Carries a tapped stream from tap_clock to clock through an async_fifo, without stalling the tap.
+// The beats of the tap are written into the FIFO and read out every clock, so maxis has no tready.
+// If the FIFO is full, the rest of the frame is discarded and its tlast is written with maxis_tabort,
+// so that capture_tap drops the frame. If the tlast itself does not fit, the next frame is discarded too
+// and both are dropped as one frame.
+// The beats are taken by capture_tap SYNC_STAGES + 1 clocks after the tap (see async_fifo), which delays
+// the timestamps as much.
+module capture_tap_cdc #(
+    parameter int DEPTH_BITS = 4,
+    parameter int SYNC_STAGES = 2
+) (
+    input wire tap_clock,
+    input wire tap_aresetn,
+
+    input wire [7:0] tap_tdata,
+    input wire       tap_tvalid,
+    input wire       tap_tready,
+    input wire       tap_tuser,
+    input wire       tap_tlast,
+
+    input wire clock,
+    input wire aresetn,
+
+    output wire [7:0] maxis_tdata,
+    output wire       maxis_tvalid,
+    output wire       maxis_tuser,
+    output wire       maxis_tlast,
+    output wire       maxis_tabort          // With tlast, the frame lost beats in the FIFO.
+);
+
+wire beat = tap_tvalid && tap_tready;
+logic fifo_tready;
+logic discard;                              // Beats are discarded until the next tlast which fits.
+
+always_ff @(posedge tap_clock) begin
+    if( !tap_aresetn ) begin
+        discard <= 0;
+    end
+    else begin
+        if( beat ) begin
+            if( !fifo_tready ) begin
+                discard <= 1;
+            end
+            else if( tap_tlast ) begin
+                discard <= 0;
+            end
+        end
+    end
+end
+
+async_fifo #(
+    .DATA_BITS(11),
+    .DEPTH_BITS(DEPTH_BITS),
+    .SYNC_STAGES(SYNC_STAGES)
+) fifo_inst (
+    .s_clock(tap_clock),
+    .s_aresetn(tap_aresetn),
+    .saxis_tdata({discard, tap_tuser, tap_tlast, tap_tdata}),
+    .saxis_tvalid(beat && (!discard || tap_tlast)),
+    .saxis_tready(fifo_tready),
+    .s_level(),
+    .almost_full(),
+    .m_clock(clock),
+    .m_aresetn(aresetn),
+    .maxis_tdata({maxis_tabort, maxis_tuser, maxis_tlast, maxis_tdata}),
+    .maxis_tvalid(maxis_tvalid),
+    .maxis_tready(1'b1));
+
+endmodule
+
+`default_nettype wire
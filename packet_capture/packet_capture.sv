@@ -0,0 +1,561 @@
+`default_nettype none
+
+// Captures the frames on the RX and TX streams into a ring of records in the DDR, through a 32bit AXI4 master
+// (an HP port of the PS). The streams are only monitored and never stalled. See capture_tap for the filters.
+// Each tap is in its own clock domain and crosses to clock through a FIFO which does not stall it either
+// (see capture_tap_cdc). A frame which overflows that FIFO is dropped and counted.
+// Each record is 4 byte aligned and starts with a 16 byte header, followed by the captured bytes padded to 4 bytes:
+//   +0x0  bit15-0: bytes of the record including the header, bit16: TX, bit17: error (tuser at tlast)
+//   +0x4  bit15-0: captured bytes, bit31-16: frame bytes
+//   +0x8  seconds (lower 32 bits) of the time base at the first byte of the frame
+//   +0xc  bit29-0: nanoseconds, bit31: the time base was locked
+// The records are written at HEAD and the software reads them from TAIL, both byte offsets in the ring.
+// A record wraps around the end of the ring. A record is dropped if the ring does not have room for all of it,
+// so there are always 4 bytes or more free and HEAD == TAIL means empty. HEAD is updated after the record is written.
+//
+// Registers (32bit access only)
+//   0x00 CONTROL        RW  bit0: capture RX, bit1: capture TX
+//   0x04 STATUS         RW  bit0: records (write 1 to clear), set when a record is written and the ring holds
+//                           IRQ_THRESHOLD bytes or more. bit1: drops (write 1 to clear), bit8: busy
+//   0x08 IRQ_ENABLE     RW  bit0: records, bit1: drops
+//   0x0c IRQ_THRESHOLD  RW
+//   0x10 RING_BASE      RW  address of the ring (4 byte aligned)
+//   0x14 RING_SIZE      RW  bytes of the ring (multiple of 4). Writing RING_BASE or RING_SIZE resets HEAD and TAIL to 0.
+//   0x18 RING_HEAD      R
+//   0x1c RING_TAIL      RW
+//   0x20 SNAP_LENGTH    RW  bytes captured from each frame. 0 captures whole frames.
+//   0x24 RX_FRAMES      R   records of RX frames written
+//   0x28 TX_FRAMES      R
+//   0x2c RX_DROPS       R   RX frames passing the filters and dropped by the FIFO or the ring,
+//                           and RX frames overflowing the FIFO of the tap
+//   0x30 TX_DROPS       R
+//   0x34 BUS_ERRORS     R   error responses on the AXI4 master
+//   0x80 + 32n          filter n (up to 4)
+//     +0x00 CONTROL     RW  bit0: enable, bit1: RX, bit2: TX, bit4: EtherType, bit5: protocol, bit6: address,
+//                           bit7: port, bit8: error flag equal to bit9
+//     +0x04 ETHERTYPE   RW
+//     +0x08 PROTOCOL    RW
+//     +0x0c ADDRESS     RW  IPv4 address, the first octet at bit31-24
+//     +0x10 MASK        RW
+//     +0x14 PORT        RW
+module packet_capture #(
+    parameter int FIFO_DEPTH_BITS = 10,         // 32bit words in the FIFO of each stream (up to 13)
+    parameter int TAP_FIFO_DEPTH_BITS = 4,      // Bytes in the clock domain crossing FIFO of each tap
+    parameter int FILTERS = 4,
+    parameter int ADDR_BITS = 8
+) (
+    input wire clock,
+    input wire aresetn,
+
+    // Monitored streams, in the rx_tap_clock and tx_tap_clock domains
+    input wire       rx_tap_clock,
+    input wire       rx_tap_aresetn,
+    input wire [7:0] rx_tap_tdata,
+    input wire       rx_tap_tvalid,
+    input wire       rx_tap_tready,
+    input wire       rx_tap_tuser,
+    input wire       rx_tap_tlast,
+
+    input wire       tx_tap_clock,
+    input wire       tx_tap_aresetn,
+    input wire [7:0] tx_tap_tdata,
+    input wire       tx_tap_tvalid,
+    input wire       tx_tap_tready,
+    input wire       tx_tap_tuser,
+    input wire       tx_tap_tlast,
+
+    // Time base, in the clock domain
+    input wire [47:0] time_seconds,
+    input wire [31:0] time_nanoseconds,
+    input wire        time_locked,
+
+    output wire       interrupt,
+
+    output wire [31:0] m_axi_awaddr,
+    output wire  [7:0] m_axi_awlen,
+    output wire  [2:0] m_axi_awsize,
+    output wire  [1:0] m_axi_awburst,
+    output wire  [3:0] m_axi_awcache,
+    output wire  [2:0] m_axi_awprot,
+    output wire        m_axi_awvalid,
+    input  wire        m_axi_awready,
+    output wire [31:0] m_axi_wdata,
+    output wire  [3:0] m_axi_wstrb,
+    output wire        m_axi_wlast,
+    output wire        m_axi_wvalid,
+    input  wire        m_axi_wready,
+    input  wire  [1:0] m_axi_bresp,
+    input  wire        m_axi_bvalid,
+    output wire        m_axi_bready,
+
+    input  wire  [ADDR_BITS-1:0] s_axi_awaddr,
+    input  wire                  s_axi_awvalid,
+    output logic                 s_axi_awready,
+    input  wire  [31:0]          s_axi_wdata,
+    input  wire  [3:0]           s_axi_wstrb,
+    input  wire                  s_axi_wvalid,
+    output logic                 s_axi_wready,
+    output logic [1:0]           s_axi_bresp,
+    output logic                 s_axi_bvalid,
+    input  wire                  s_axi_bready,
+    input  wire  [ADDR_BITS-1:0] s_axi_araddr,
+    input  wire                  s_axi_arvalid,
+    output logic                 s_axi_arready,
+    output logic [31:0]          s_axi_rdata,
+    output logic [1:0]           s_axi_rresp,
+    output logic                 s_axi_rvalid,
+    input  wire                  s_axi_rready
+);
+
+localparam int RX = 0;
+localparam int TX = 1;
+localparam int MAX_BURST_BEATS = 16;
+
+localparam int REG_CONTROL = 0;
+localparam int REG_STATUS = 1;
+localparam int REG_IRQ_ENABLE = 2;
+localparam int REG_IRQ_THRESHOLD = 3;
+localparam int REG_RING_BASE = 4;
+localparam int REG_RING_SIZE = 5;
+localparam int REG_RING_HEAD = 6;
+localparam int REG_RING_TAIL = 7;
+localparam int REG_SNAP_LENGTH = 8;
+localparam int REG_RX_FRAMES = 9;
+localparam int REG_TX_FRAMES = 10;
+localparam int REG_RX_DROPS = 11;
+localparam int REG_TX_DROPS = 12;
+localparam int REG_BUS_ERRORS = 13;
+localparam int REG_FILTER = 32;         // 8 registers for each filter
+
+localparam int FILTER_CONTROL = 0;
+localparam int FILTER_ETHERTYPE = 1;
+localparam int FILTER_PROTOCOL = 2;
+localparam int FILTER_ADDRESS = 3;
+localparam int FILTER_MASK = 4;
+localparam int FILTER_PORT = 5;
+
+logic [1:0]  enable;
+logic [1:0]  irq_status;
+logic [1:0]  irq_enable;
+logic [31:0] irq_threshold;
+logic [31:0] ring_base;
+logic [31:0] ring_size;
+logic [31:0] ring_head;
+logic [31:0] ring_tail;
+logic        ring_reset;
+logic [15:0] snap_length;
+logic [31:0] frame_count[2];
+logic [31:0] drop_count[2];
+logic [31:0] bus_error_count;
+logic        busy;
+
+logic [FILTERS-1:0][9:0]  filter_control;
+logic [FILTERS-1:0][15:0] filter_ethertype;
+logic [FILTERS-1:0][7:0]  filter_protocol;
+logic [FILTERS-1:0][31:0] filter_address;
+logic [FILTERS-1:0][31:0] filter_mask;
+logic [FILTERS-1:0][15:0] filter_port;
+
+assign interrupt = |(irq_status & irq_enable);
+
+// AXI4-Lite write
+logic write_enable;
+logic [ADDR_BITS-3:0] write_index;
+assign write_enable = s_axi_awvalid && s_axi_wvalid && !s_axi_bvalid;
+assign write_index = s_axi_awaddr[ADDR_BITS-1:2];
+assign s_axi_awready = write_enable;
+assign s_axi_wready = write_enable;
+assign s_axi_bresp = 2'b00;
+
+// STATUS is cleared by the transfer side.
+wire [1:0] irq_clear = write_enable && write_index == REG_STATUS ? s_axi_wdata[1:0] : 2'b00;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        s_axi_bvalid <= 0;
+        enable <= 0;
+        irq_enable <= 0;
+        irq_threshold <= 0;
+        ring_base <= 0;
+        ring_size <= 0;
+        ring_tail <= 0;
+        ring_reset <= 0;
+        snap_length <= 0;
+        filter_control <= 0;
+        filter_ethertype <= 0;
+        filter_protocol <= 0;
+        filter_address <= 0;
+        filter_mask <= 0;
+        filter_port <= 0;
+    end
+    else begin
+        ring_reset <= 0;
+        if( s_axi_bvalid && s_axi_bready ) begin
+            s_axi_bvalid <= 0;
+        end
+        if( write_enable ) begin
+            s_axi_bvalid <= 1;
+            case(write_index)
+            REG_CONTROL: enable <= s_axi_wdata[1:0];
+            REG_IRQ_ENABLE: irq_enable <= s_axi_wdata[1:0];
+            REG_IRQ_THRESHOLD: irq_threshold <= s_axi_wdata;
+            REG_RING_BASE: begin
+                ring_base <= {s_axi_wdata[31:2], 2'b00};
+                ring_tail <= 0;
+                ring_reset <= 1;
+            end
+            REG_RING_SIZE: begin
+                ring_size <= {s_axi_wdata[31:2], 2'b00};
+                ring_tail <= 0;
+                ring_reset <= 1;
+            end
+            REG_RING_TAIL: ring_tail <= {s_axi_wdata[31:2], 2'b00};
+            REG_SNAP_LENGTH: snap_length <= s_axi_wdata[15:0];
+            default: ;
+            endcase
+            for(int i = 0; i < FILTERS; i++) begin
+                case(int'(write_index) - (REG_FILTER + 8*i))
+                FILTER_CONTROL: filter_control[i] <= s_axi_wdata[9:0];
+                FILTER_ETHERTYPE: filter_ethertype[i] <= s_axi_wdata[15:0];
+                FILTER_PROTOCOL: filter_protocol[i] <= s_axi_wdata[7:0];
+                FILTER_ADDRESS: filter_address[i] <= s_axi_wdata;
+                FILTER_MASK: filter_mask[i] <= s_axi_wdata;
+                FILTER_PORT: filter_port[i] <= s_axi_wdata[15:0];
+                default: ;
+                endcase
+            end
+        end
+    end
+end
+
+// AXI4-Lite read
+logic [ADDR_BITS-3:0] read_index;
+assign read_index = s_axi_araddr[ADDR_BITS-1:2];
+assign s_axi_arready = !s_axi_rvalid;
+assign s_axi_rresp = 2'b00;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        s_axi_rvalid <= 0;
+        s_axi_rdata <= 0;
+    end
+    else begin
+        if( s_axi_rvalid && s_axi_rready ) begin
+            s_axi_rvalid <= 0;
+        end
+        if( s_axi_arvalid && s_axi_arready ) begin
+            s_axi_rvalid <= 1;
+            case(read_index)
+            REG_CONTROL: s_axi_rdata <= {30'b0, enable};
+            REG_STATUS: s_axi_rdata <= {23'b0, busy, 6'b0, irq_status};
+            REG_IRQ_ENABLE: s_axi_rdata <= {30'b0, irq_enable};
+            REG_IRQ_THRESHOLD: s_axi_rdata <= irq_threshold;
+            REG_RING_BASE: s_axi_rdata <= ring_base;
+            REG_RING_SIZE: s_axi_rdata <= ring_size;
+            REG_RING_HEAD: s_axi_rdata <= ring_head;
+            REG_RING_TAIL: s_axi_rdata <= ring_tail;
+            REG_SNAP_LENGTH: s_axi_rdata <= {16'b0, snap_length};
+            REG_RX_FRAMES: s_axi_rdata <= frame_count[RX];
+            REG_TX_FRAMES: s_axi_rdata <= frame_count[TX];
+            REG_RX_DROPS: s_axi_rdata <= drop_count[RX];
+            REG_TX_DROPS: s_axi_rdata <= drop_count[TX];
+            REG_BUS_ERRORS: s_axi_rdata <= bus_error_count;
+            default: s_axi_rdata <= 0;
+            endcase
+            for(int i = 0; i < FILTERS; i++) begin
+                case(int'(read_index) - (REG_FILTER + 8*i))
+                FILTER_CONTROL: s_axi_rdata <= {22'b0, filter_control[i]};
+                FILTER_ETHERTYPE: s_axi_rdata <= {16'b0, filter_ethertype[i]};
+                FILTER_PROTOCOL: s_axi_rdata <= {24'b0, filter_protocol[i]};
+                FILTER_ADDRESS: s_axi_rdata <= filter_address[i];
+                FILTER_MASK: s_axi_rdata <= filter_mask[i];
+                FILTER_PORT: s_axi_rdata <= {16'b0, filter_port[i]};
+                default: ;
+                endcase
+            end
+        end
+    end
+end
+
+// Taps
+logic        tap_clock[2];
+logic        tap_aresetn[2];
+logic [7:0]  tap_tdata[2];
+logic        tap_tvalid[2];
+logic        tap_tready[2];
+logic        tap_tuser[2];
+logic        tap_tlast[2];
+logic [31:0] data_tdata[2];
+logic        data_tvalid[2];
+logic        data_tready[2];
+logic        data_tlast[2];
+logic [95:0] meta_tdata[2];
+logic        meta_tvalid[2];
+logic        meta_tready[2];
+logic        tap_dropped[2];
+
+assign tap_clock[RX] = rx_tap_clock;
+assign tap_aresetn[RX] = rx_tap_aresetn;
+assign tap_tdata[RX] = rx_tap_tdata;
+assign tap_tvalid[RX] = rx_tap_tvalid;
+assign tap_tready[RX] = rx_tap_tready;
+assign tap_tuser[RX] = rx_tap_tuser;
+assign tap_tlast[RX] = rx_tap_tlast;
+assign tap_clock[TX] = tx_tap_clock;
+assign tap_aresetn[TX] = tx_tap_aresetn;
+assign tap_tdata[TX] = tx_tap_tdata;
+assign tap_tvalid[TX] = tx_tap_tvalid;
+assign tap_tready[TX] = tx_tap_tready;
+assign tap_tuser[TX] = tx_tap_tuser;
+assign tap_tlast[TX] = tx_tap_tlast;
+
+generate
+for(genvar tap_index = 0; tap_index < 2; tap_index++) begin: tap_block
+    logic [FILTERS-1:0]      tap_filter_enable;
+    logic [FILTERS-1:0][5:0] tap_filter_checks;
+    always_comb begin
+        for(int i = 0; i < FILTERS; i++) begin
+            tap_filter_enable[i] = filter_control[i][0] && filter_control[i][1 + tap_index];
+            tap_filter_checks[i] = filter_control[i][9:4];
+        end
+    end
+
+    logic [7:0] cdc_tdata;
+    logic       cdc_tvalid;
+    logic       cdc_tuser;
+    logic       cdc_tlast;
+    logic       cdc_tabort;
+
+    capture_tap_cdc #(
+        .DEPTH_BITS(TAP_FIFO_DEPTH_BITS)
+    ) cdc_inst (
+        .tap_clock(tap_clock[tap_index]),
+        .tap_aresetn(tap_aresetn[tap_index]),
+        .tap_tdata(tap_tdata[tap_index]),
+        .tap_tvalid(tap_tvalid[tap_index]),
+        .tap_tready(tap_tready[tap_index]),
+        .tap_tuser(tap_tuser[tap_index]),
+        .tap_tlast(tap_tlast[tap_index]),
+        .clock(clock),
+        .aresetn(aresetn),
+        .maxis_tdata(cdc_tdata),
+        .maxis_tvalid(cdc_tvalid),
+        .maxis_tuser(cdc_tuser),
+        .maxis_tlast(cdc_tlast),
+        .maxis_tabort(cdc_tabort)
+    );
+
+    capture_tap #(
+        .FIFO_DEPTH_BITS(FIFO_DEPTH_BITS),
+        .FILTERS(FILTERS)
+    ) tap_inst (
+        .clock(clock),
+        .aresetn(aresetn),
+        .tap_tdata(cdc_tdata),
+        .tap_tvalid(cdc_tvalid),
+        .tap_tready(1'b1),
+        .tap_tuser(cdc_tuser),
+        .tap_tlast(cdc_tlast),
+        .tap_abort(cdc_tabort),
+        .enable(enable[tap_index]),
+        .snap_length(snap_length),
+        .time_seconds(time_seconds),
+        .time_nanoseconds(time_nanoseconds),
+        .time_locked(time_locked),
+        .filter_enable(tap_filter_enable),
+        .filter_checks(tap_filter_checks),
+        .filter_ethertype(filter_ethertype),
+        .filter_protocol(filter_protocol),
+        .filter_address(filter_address),
+        .filter_mask(filter_mask),
+        .filter_port(filter_port),
+        .data_maxis_tdata(data_tdata[tap_index]),
+        .data_maxis_tvalid(data_tvalid[tap_index]),
+        .data_maxis_tready(data_tready[tap_index]),
+        .data_maxis_tlast(data_tlast[tap_index]),
+        .meta_maxis_tdata(meta_tdata[tap_index]),
+        .meta_maxis_tvalid(meta_tvalid[tap_index]),
+        .meta_maxis_tready(meta_tready[tap_index]),
+        .frame_dropped(tap_dropped[tap_index])
+    );
+end
+endgenerate
+
+// Records
+typedef enum logic [2:0] {
+    S_IDLE,
+    S_BURST,            // Starts a burst at write_offset
+    S_WRITE,
+    S_RESPONSE,
+    S_DISCARD           // Discards the words of the record which does not fit in the ring
+} state_t;
+
+state_t      state;
+logic        tap;                   // RX or TX
+logic [95:0] meta;
+logic [31:0] write_offset;          // Offset of the next word in the ring
+logic [15:0] record_bytes;
+logic [13:0] words_left;            // Words of the record not written yet
+logic [2:0]  word_index;            // Word of the record, saturated at 4 after the header
+logic [4:0]  burst_beats;
+logic [4:0]  beat;
+logic        address_pending;       // AW of the burst is not accepted yet.
+
+// Bytes in the ring, and the bytes of the records waiting at the taps.
+wire [31:0] ring_used = ring_head >= ring_tail ? ring_head - ring_tail : ring_head + ring_size - ring_tail;
+wire [15:0] meta_record_bytes[2];
+assign meta_record_bytes[RX] = 16'd16 + ((meta_tdata[RX][77:62] + 16'd3) & ~16'd3);
+assign meta_record_bytes[TX] = 16'd16 + ((meta_tdata[TX][77:62] + 16'd3) & ~16'd3);
+
+// The first record from the tap after the last one
+wire next_tap = meta_tvalid[!tap] ? !tap : tap;
+
+// Beats of the next burst, which does not cross a 4KB boundary nor the end of the ring.
+function automatic logic [4:0] burst_length(input logic [31:0] address, input logic [31:0] offset, input logic [13:0] words);
+    logic [10:0] boundary_words;
+    logic [31:0] end_words;
+    logic [13:0] beats;
+    boundary_words = (13'h1000 - 13'(address[11:0])) >> 2;
+    end_words = (ring_size - offset) >> 2;
+    beats = words < MAX_BURST_BEATS ? words : 14'(MAX_BURST_BEATS);
+    if( 14'(boundary_words) < beats ) beats = 14'(boundary_words);
+    if( end_words < 32'(beats) ) beats = 14'(end_words);
+    return 5'(beats);
+endfunction
+
+logic [31:0] header_word;
+always_comb begin
+    case(word_index)
+    0: header_word = {14'b0, meta[95], tap, record_bytes};
+    1: header_word = {meta[93:78], meta[77:62]};
+    2: header_word = meta[61:30];
+    default: header_word = {meta[94], 1'b0, meta[29:0]};
+    endcase
+end
+
+wire header = word_index < 4;
+wire write_data = m_axi_wvalid && m_axi_wready;
+
+assign m_axi_awaddr = ring_base + write_offset;
+assign m_axi_awlen = 8'(burst_beats - 5'd1);
+assign m_axi_awsize = 3'b010;
+assign m_axi_awburst = 2'b01;
+assign m_axi_awcache = 4'b0011;
+assign m_axi_awprot = 3'b000;
+assign m_axi_awvalid = state == S_WRITE && address_pending;
+assign m_axi_wdata = header ? header_word : data_tdata[tap];
+assign m_axi_wstrb = 4'b1111;
+assign m_axi_wlast = beat == burst_beats - 5'd1;
+assign m_axi_wvalid = state == S_WRITE && beat != burst_beats && (header || data_tvalid[tap]);
+assign m_axi_bready = state == S_RESPONSE;
+
+assign data_tready[RX] = tap == RX && (state == S_WRITE && write_data && !header || state == S_DISCARD);
+assign data_tready[TX] = tap == TX && (state == S_WRITE && write_data && !header || state == S_DISCARD);
+assign meta_tready[RX] = state == S_IDLE && next_tap == RX && meta_tvalid[RX];
+assign meta_tready[TX] = state == S_IDLE && next_tap == TX && meta_tvalid[TX];
+
+assign busy = state != S_IDLE;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        state <= S_IDLE;
+        tap <= TX;
+        meta <= 0;
+        write_offset <= 0;
+        record_bytes <= 0;
+        words_left <= 0;
+        word_index <= 0;
+        burst_beats <= 0;
+        beat <= 0;
+        address_pending <= 0;
+        ring_head <= 0;
+        irq_status <= 0;
+        frame_count[RX] <= 0;
+        frame_count[TX] <= 0;
+        drop_count[RX] <= 0;
+        drop_count[TX] <= 0;
+        bus_error_count <= 0;
+    end
+    else begin
+        irq_status <= irq_status & ~irq_clear;
+        bus_error_count <= bus_error_count + (m_axi_bvalid && m_axi_bready && m_axi_bresp != 2'b00);
+        for(int i = 0; i < 2; i++) begin
+            if( tap_dropped[i] ) begin
+                drop_count[i] <= drop_count[i] + 1;
+                irq_status[1] <= 1;
+            end
+        end
+        if( ring_reset ) begin
+            ring_head <= 0;
+        end
+
+        case(state)
+        S_IDLE: begin
+            word_index <= 0;
+            if( meta_tvalid[next_tap] ) begin
+                tap <= next_tap;
+                meta <= meta_tdata[next_tap];
+                record_bytes <= meta_record_bytes[next_tap];
+                words_left <= 14'(meta_record_bytes[next_tap] >> 2);
+                write_offset <= ring_head;
+                if( 33'(ring_used) + meta_record_bytes[next_tap] + 33'd4 <= 33'(ring_size) ) begin
+                    state <= S_BURST;
+                end
+                else begin
+                    // A frame dropped by the tap in the same cycle is counted together.
+                    drop_count[next_tap] <= drop_count[next_tap] + 1 + tap_dropped[next_tap];
+                    irq_status[1] <= 1;
+                    state <= S_DISCARD;
+                end
+            end
+        end
+        S_BURST: begin
+            burst_beats <= burst_length(ring_base + write_offset, write_offset, words_left);
+            beat <= 0;
+            address_pending <= 1;
+            state <= S_WRITE;
+        end
+        S_WRITE: begin
+            if( m_axi_awready ) begin
+                address_pending <= 0;
+            end
+            if( write_data ) begin
+                beat <= beat + 5'd1;
+                words_left <= words_left - 14'd1;
+                write_offset <= write_offset + 32'd4 == ring_size ? 32'd0 : write_offset + 32'd4;
+                if( header ) begin
+                    word_index <= word_index + 3'd1;
+                end
+            end
+            if( (!address_pending || m_axi_awready) && (beat == burst_beats || write_data && m_axi_wlast) ) begin
+                state <= S_RESPONSE;
+            end
+        end
+        S_RESPONSE: begin
+            if( m_axi_bvalid ) begin
+                if( words_left != 0 ) begin
+                    state <= S_BURST;
+                end
+                else begin
+                    ring_head <= write_offset;
+                    frame_count[tap] <= frame_count[tap] + 1;
+                    if( 33'(ring_used) + record_bytes >= 33'(irq_threshold) ) begin
+                        irq_status[0] <= 1;
+                    end
+                    state <= S_IDLE;
+                end
+            end
+        end
+        S_DISCARD: begin
+            if( data_tvalid[tap] && data_tlast[tap] ) begin
+                state <= S_IDLE;
+            end
+        end
+        default: state <= S_IDLE;
+        endcase
+    end
+end
+
+endmodule
+
+`default_nettype wire
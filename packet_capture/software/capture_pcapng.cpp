@@ -0,0 +1,271 @@
+// Drains the ring of packet_capture into a pcapng file.
+//   capture_pcapng -d /dev/uio1 -w capture.pcapng [-s snap_length] [-F filter]... [-c count] [-t seconds] [-i rx|tx|both]
+// The UIO device has the registers at map0 and the memory of the ring at map1.
+// The capture stops at SIGINT, after count records or after the seconds.
+#include "capture_ring.hpp"
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace packet_capture;
+
+// Orders the reads of the ring after the read of HEAD, and the write of TAIL after the reads of the ring.
+static inline void dma_barrier()
+{
+#if defined(__aarch64__) || defined(__arm__)
+	asm volatile("dsb sy" ::: "memory");
+#else
+	__sync_synchronize();
+#endif
+}
+
+static std::size_t read_sysfs(const std::string& path)
+{
+	std::ifstream stream(path);
+	std::string text;
+	if( !(stream >> text) ) {
+		throw std::runtime_error("failed to read " + path);
+	}
+	return std::stoul(text, nullptr, 0);
+}
+
+class UioDevice
+{
+	int fd;
+	volatile std::uint32_t* registers;
+	std::size_t registers_size;
+	volatile std::uint8_t* ring;
+	std::size_t ring_size;
+	std::uint32_t ring_address;
+
+public:
+	explicit UioDevice(const std::string& device)
+	{
+		auto name = device.substr(device.find_last_of('/') + 1);
+		auto maps = "/sys/class/uio/" + name + "/maps/";
+		this->registers_size = read_sysfs(maps + "map0/size");
+		this->ring_size = read_sysfs(maps + "map1/size");
+		this->ring_address = static_cast<std::uint32_t>(read_sysfs(maps + "map1/addr"));
+
+		this->fd = open(device.c_str(), O_RDWR | O_SYNC);
+		if( this->fd < 0 ) {
+			throw std::system_error(errno, std::generic_category(), "failed to open " + device);
+		}
+		// The map N of a UIO device is mapped at the offset of N pages.
+		auto page_size = static_cast<off_t>(sysconf(_SC_PAGESIZE));
+		auto registers = mmap(nullptr, this->registers_size, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+		auto ring = mmap(nullptr, this->ring_size, PROT_READ, MAP_SHARED, this->fd, page_size);
+		if( registers == MAP_FAILED || ring == MAP_FAILED ) {
+			auto error = errno;
+			if( registers != MAP_FAILED ) munmap(registers, this->registers_size);
+			if( ring != MAP_FAILED ) munmap(ring, this->ring_size);
+			close(this->fd);
+			throw std::system_error(error, std::generic_category(), "failed to map " + device);
+		}
+		this->registers = static_cast<volatile std::uint32_t*>(registers);
+		this->ring = static_cast<volatile std::uint8_t*>(ring);
+	}
+	~UioDevice()
+	{
+		munmap(const_cast<std::uint32_t*>(this->registers), this->registers_size);
+		munmap(const_cast<std::uint8_t*>(this->ring), this->ring_size);
+		close(this->fd);
+	}
+	UioDevice(const UioDevice&) = delete;
+	UioDevice& operator=(const UioDevice&) = delete;
+
+	std::uint32_t read_register(std::uint32_t offset) { return this->registers[offset / 4]; }
+	void write_register(std::uint32_t offset, std::uint32_t value) { this->registers[offset / 4] = value; }
+	const volatile std::uint8_t* ring_memory() const { return this->ring; }
+	std::size_t ring_memory_size() const { return this->ring_size; }
+	std::uint32_t ring_memory_address() const { return this->ring_address; }
+
+	// Returns false on timeout or a signal.
+	bool wait_interrupt(int timeout_ms)
+	{
+		// uio_pdrv_genirq masks the interrupt when it fires, and unmasks it by writing 1.
+		std::int32_t value = 1;
+		if( write(this->fd, &value, sizeof(value)) != sizeof(value) ) {
+			throw std::system_error(errno, std::generic_category(), "failed to unmask the interrupt");
+		}
+		struct pollfd pfd = { this->fd, POLLIN, 0 };
+		auto result = poll(&pfd, 1, timeout_ms);
+		if( result < 0 ) {
+			if( errno == EINTR ) return false;
+			throw std::system_error(errno, std::generic_category(), "failed to wait for the interrupt");
+		}
+		if( result == 0 ) {
+			return false;
+		}
+		std::int32_t count;
+		return read(this->fd, &count, sizeof(count)) == sizeof(count);
+	}
+};
+
+static volatile std::sig_atomic_t stop_requested = 0;
+
+static void handle_signal(int)
+{
+	stop_requested = 1;
+}
+
+static void usage(const char* program)
+{
+	std::fprintf(stderr,
+		"usage: %s -d /dev/uioN -w file|- [-s snap_length] [-F filter]... [-c count] [-t seconds] [-i rx|tx|both]\n"
+		"  filter: comma separated terms of rx, tx, ethertype=N, proto=N, ip=a.b.c.d[/n], port=N, error=0|1\n"
+		"          A frame is captured if it matches any of the filters given for its direction.\n",
+		program);
+}
+
+int main(int argc, char* argv[])
+{
+	std::string device;
+	std::string output;
+	std::uint32_t snap_length = 0;
+	std::vector<Filter> filters;
+	std::size_t max_records = 0;
+	unsigned int seconds = 0;
+	std::uint32_t control = CONTROL_RX | CONTROL_TX;
+
+	int option;
+	try {
+		while( (option = getopt(argc, argv, "d:w:s:F:c:t:i:h")) != -1 ) {
+			switch(option) {
+			case 'd': device = optarg; break;
+			case 'w': output = optarg; break;
+			case 's': snap_length = static_cast<std::uint32_t>(std::stoul(optarg, nullptr, 0)); break;
+			case 'F': filters.push_back(parse_filter(optarg)); break;
+			case 'c': max_records = std::stoul(optarg, nullptr, 0); break;
+			case 't': seconds = static_cast<unsigned int>(std::stoul(optarg, nullptr, 0)); break;
+			case 'i': {
+				std::string directions = optarg;
+				if( directions == "rx" ) control = CONTROL_RX;
+				else if( directions == "tx" ) control = CONTROL_TX;
+				else if( directions == "both" ) control = CONTROL_RX | CONTROL_TX;
+				else throw std::invalid_argument("invalid direction: " + directions);
+				break;
+			}
+			default:
+				usage(argv[0]);
+				return option == 'h' ? 0 : 1;
+			}
+		}
+	}
+	catch(const std::exception& e) {
+		std::fprintf(stderr, "%s\n", e.what());
+		return 1;
+	}
+	if( device.empty() || output.empty() || optind != argc || filters.size() > FILTERS || snap_length > 0xffff ) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	try {
+		UioDevice uio(device);
+		auto size = static_cast<std::uint32_t>(uio.ring_memory_size() & ~std::size_t(3));
+		std::FILE* file = output == "-" ? stdout : std::fopen(output.c_str(), "wb");
+		if( file == nullptr ) {
+			throw std::system_error(errno, std::generic_category(), "failed to open " + output);
+		}
+
+		// Stop the capture and wait for the record in progress before moving the ring.
+		uio.write_register(REG_CONTROL, 0);
+		while( uio.read_register(REG_STATUS) & STATUS_BUSY ) {
+		}
+		uio.write_register(REG_RING_BASE, uio.ring_memory_address());
+		uio.write_register(REG_RING_SIZE, size);
+		uio.write_register(REG_SNAP_LENGTH, snap_length);
+		for(std::size_t i = 0; i < FILTERS; i++) {
+			Filter filter = i < filters.size() ? filters[i] : Filter();
+			auto base = REG_FILTER + 0x20 * static_cast<std::uint32_t>(i);
+			uio.write_register(base + FILTER_ETHERTYPE, filter.ethertype);
+			uio.write_register(base + FILTER_PROTOCOL, filter.protocol);
+			uio.write_register(base + FILTER_ADDRESS, filter.address);
+			uio.write_register(base + FILTER_MASK, filter.mask);
+			uio.write_register(base + FILTER_PORT, filter.port);
+			uio.write_register(base + FILTER_CONTROL, filter.control);
+		}
+		// Interrupt at a quarter of the ring, or on a drop. The timeout below picks up the records under it.
+		uio.write_register(REG_IRQ_THRESHOLD, size / 4);
+		uio.write_register(REG_IRQ_ENABLE, STATUS_RECORDS | STATUS_DROPS);
+		uio.write_register(REG_STATUS, STATUS_RECORDS | STATUS_DROPS);
+
+		auto rx_frames = uio.read_register(REG_RX_FRAMES);
+		auto tx_frames = uio.read_register(REG_TX_FRAMES);
+		auto rx_drops = uio.read_register(REG_RX_DROPS);
+		auto tx_drops = uio.read_register(REG_TX_DROPS);
+
+		PcapngWriter writer(file);
+		if( !writer.write_header(snap_length != 0 ? snap_length : 0xffff, "rx", "tx") ) {
+			throw std::runtime_error("failed to write " + output);
+		}
+
+		std::signal(SIGINT, handle_signal);
+		std::signal(SIGTERM, handle_signal);
+		uio.write_register(REG_CONTROL, control);
+
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+		std::size_t records = 0;
+		std::uint32_t tail = 0;
+		bool write_failed = false;
+		while( !stop_requested && !write_failed && (max_records == 0 || records < max_records) ) {
+			if( seconds != 0 && std::chrono::steady_clock::now() >= deadline ) {
+				break;
+			}
+			// Clear STATUS before reading HEAD, so that a record written after it raises the interrupt again.
+			uio.write_register(REG_STATUS, STATUS_RECORDS | STATUS_DROPS);
+			auto head = uio.read_register(REG_RING_HEAD);
+			if( head == tail ) {
+				uio.wait_interrupt(100);
+				continue;
+			}
+			dma_barrier();
+			auto new_tail = read_records(uio.ring_memory(), size, tail, head, [&](const Record& record) {
+				if( write_failed || (max_records != 0 && records >= max_records) ) {
+					return;
+				}
+				write_failed = !writer.write(record);
+				records++;
+			});
+			if( new_tail != head ) {
+				throw std::runtime_error("broken record at " + std::to_string(new_tail));
+			}
+			// Release the whole batch at once, as each write of TAIL is an access across the bus.
+			dma_barrier();
+			uio.write_register(REG_RING_TAIL, new_tail);
+			tail = new_tail;
+		}
+		uio.write_register(REG_CONTROL, 0);
+		uio.write_register(REG_IRQ_ENABLE, 0);
+		if( write_failed ) {
+			throw std::runtime_error("failed to write " + output);
+		}
+		std::fflush(file);
+		if( file != stdout ) {
+			std::fclose(file);
+		}
+
+		std::fprintf(stderr, "%zu records written\n", records);
+		std::fprintf(stderr, "RX: %u frames, %u drops\n", uio.read_register(REG_RX_FRAMES) - rx_frames, uio.read_register(REG_RX_DROPS) - rx_drops);
+		std::fprintf(stderr, "TX: %u frames, %u drops\n", uio.read_register(REG_TX_FRAMES) - tx_frames, uio.read_register(REG_TX_DROPS) - tx_drops);
+		std::fprintf(stderr, "bus errors: %u\n", uio.read_register(REG_BUS_ERRORS));
+	}
+	catch(const std::exception& e) {
+		std::fprintf(stderr, "%s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,193 @@
+#include "capture_ring.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace packet_capture {
+
+static std::uint32_t parse_number(const std::string& text, std::uint32_t max)
+{
+	char* end = nullptr;
+	auto value = std::strtoul(text.c_str(), &end, 0);
+	if( text.empty() || *end != '\0' || value > max ) {
+		throw std::invalid_argument("invalid number: " + text);
+	}
+	return static_cast<std::uint32_t>(value);
+}
+
+// a.b.c.d or a.b.c.d/n
+static void parse_address(const std::string& text, std::uint32_t& address, std::uint32_t& mask)
+{
+	auto slash = text.find('/');
+	auto host = text.substr(0, slash);
+	std::uint32_t prefix = 32;
+	if( slash != std::string::npos ) {
+		prefix = parse_number(text.substr(slash + 1), 32);
+	}
+	address = 0;
+	std::size_t position = 0;
+	for(int i = 0; i < 4; i++) {
+		auto dot = host.find('.', position);
+		if( (i < 3) == (dot == std::string::npos) ) {
+			throw std::invalid_argument("invalid address: " + text);
+		}
+		address = (address << 8) | parse_number(host.substr(position, dot - position), 255);
+		position = dot + 1;
+	}
+	mask = prefix == 0 ? 0 : ~0u << (32 - prefix);
+}
+
+Filter parse_filter(const std::string& text)
+{
+	Filter filter;
+	filter.control = FILTER_ENABLE;
+	std::uint32_t directions = 0;
+	std::size_t position = 0;
+	while( position <= text.size() ) {
+		auto comma = text.find(',', position);
+		if( comma == std::string::npos ) {
+			comma = text.size();
+		}
+		auto term = text.substr(position, comma - position);
+		position = comma + 1;
+		auto equal = term.find('=');
+		auto key = term.substr(0, equal);
+		auto value = equal == std::string::npos ? std::string() : term.substr(equal + 1);
+		if( key.empty() ) {
+			continue;
+		}
+		if( key == "rx" && equal == std::string::npos ) {
+			directions |= FILTER_RX;
+		}
+		else if( key == "tx" && equal == std::string::npos ) {
+			directions |= FILTER_TX;
+		}
+		else if( key == "ethertype" ) {
+			filter.ethertype = parse_number(value, 0xffff);
+			filter.control |= FILTER_CHECK_ETHERTYPE;
+		}
+		else if( key == "proto" ) {
+			filter.protocol = parse_number(value, 0xff);
+			filter.control |= FILTER_CHECK_PROTOCOL;
+		}
+		else if( key == "ip" ) {
+			parse_address(value, filter.address, filter.mask);
+			filter.control |= FILTER_CHECK_ADDRESS;
+		}
+		else if( key == "port" ) {
+			filter.port = parse_number(value, 0xffff);
+			filter.control |= FILTER_CHECK_PORT;
+		}
+		else if( key == "error" ) {
+			filter.control |= FILTER_CHECK_ERROR | (parse_number(value, 1) ? FILTER_ERROR_VALUE : 0);
+		}
+		else {
+			throw std::invalid_argument("unknown filter term: " + term);
+		}
+	}
+	filter.control |= directions != 0 ? directions : FILTER_RX | FILTER_TX;
+	return filter;
+}
+
+
+// pcapng block types and options
+static constexpr const std::uint32_t BLOCK_SECTION_HEADER = 0x0a0d0d0a;
+static constexpr const std::uint32_t BLOCK_INTERFACE_DESCRIPTION = 0x00000001;
+static constexpr const std::uint32_t BLOCK_ENHANCED_PACKET = 0x00000006;
+static constexpr const std::uint32_t BYTE_ORDER_MAGIC = 0x1a2b3c4d;
+static constexpr const std::uint16_t LINKTYPE_ETHERNET = 1;
+static constexpr const std::uint16_t OPTION_END = 0;
+static constexpr const std::uint16_t OPTION_IF_NAME = 2;
+static constexpr const std::uint16_t OPTION_IF_TSRESOL = 9;
+static constexpr const std::uint16_t OPTION_EPB_FLAGS = 2;
+static constexpr const std::uint32_t EPB_FLAGS_INBOUND = 1;
+static constexpr const std::uint32_t EPB_FLAGS_OUTBOUND = 2;
+static constexpr const std::uint32_t EPB_FLAGS_CRC_ERROR = 1u << 24;
+
+// Blocks are written in the byte order of the host, which the section header tells the reader.
+void PcapngWriter::begin_block(std::uint32_t type)
+{
+	this->block.clear();
+	this->put32(type);
+	this->put32(0);		// Length, filled by end_block
+}
+
+void PcapngWriter::put32(std::uint32_t value)
+{
+	this->put_bytes(&value, sizeof(value));
+}
+
+void PcapngWriter::put16(std::uint16_t first, std::uint16_t second)
+{
+	std::uint16_t values[2] = {first, second};
+	this->put_bytes(values, sizeof(values));
+}
+
+void PcapngWriter::put_bytes(const void* data, std::size_t length)
+{
+	auto bytes = static_cast<const std::uint8_t*>(data);
+	this->block.insert(this->block.end(), bytes, bytes + length);
+	while( this->block.size() % 4 != 0 ) {
+		this->block.push_back(0);
+	}
+}
+
+void PcapngWriter::put_option(std::uint16_t code, const void* data, std::size_t length)
+{
+	this->put16(code, static_cast<std::uint16_t>(length));
+	if( length > 0 ) {
+		this->put_bytes(data, length);
+	}
+}
+
+bool PcapngWriter::end_block()
+{
+	std::uint32_t length = static_cast<std::uint32_t>(this->block.size() + 4);
+	std::memcpy(&this->block[4], &length, 4);
+	this->put32(length);
+	return std::fwrite(this->block.data(), 1, this->block.size(), this->file) == this->block.size();
+}
+
+bool PcapngWriter::write_header(std::size_t snap_length, const std::string& rx_name, const std::string& tx_name)
+{
+	this->begin_block(BLOCK_SECTION_HEADER);
+	this->put32(BYTE_ORDER_MAGIC);
+	this->put32(1);				// Version 1.0
+	this->put32(0xffffffff);	// Section length unknown
+	this->put32(0xffffffff);
+	if( !this->end_block() ) {
+		return false;
+	}
+	for(const auto& name : {rx_name, tx_name}) {
+		this->begin_block(BLOCK_INTERFACE_DESCRIPTION);
+		this->put16(LINKTYPE_ETHERNET, 0);	// Link type and reserved
+		this->put32(static_cast<std::uint32_t>(snap_length));
+		this->put_option(OPTION_IF_NAME, name.data(), name.size());
+		std::uint8_t resolution = 9;	// Nanoseconds
+		this->put_option(OPTION_IF_TSRESOL, &resolution, 1);
+		this->put_option(OPTION_END, nullptr, 0);
+		if( !this->end_block() ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool PcapngWriter::write(const Record& record)
+{
+	std::uint64_t timestamp = static_cast<std::uint64_t>(record.seconds) * 1000000000u + record.nanoseconds;
+	this->begin_block(BLOCK_ENHANCED_PACKET);
+	this->put32(record.tx ? 1 : 0);
+	this->put32(static_cast<std::uint32_t>(timestamp >> 32));
+	this->put32(static_cast<std::uint32_t>(timestamp));
+	this->put32(static_cast<std::uint32_t>(record.data.size()));
+	this->put32(static_cast<std::uint32_t>(record.frame_bytes));
+	this->put_bytes(record.data.data(), record.data.size());
+	std::uint32_t flags = (record.tx ? EPB_FLAGS_OUTBOUND : EPB_FLAGS_INBOUND) | (record.error ? EPB_FLAGS_CRC_ERROR : 0);
+	this->put_option(OPTION_EPB_FLAGS, &flags, sizeof(flags));
+	this->put_option(OPTION_END, nullptr, 0);
+	return this->end_block();
+}
+
+}
@@ -0,0 +1,151 @@
+// Records of the packet_capture IP and their conversion to pcapng.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace packet_capture {
+
+// Registers of the IP
+enum Register : std::uint32_t {
+	REG_CONTROL = 0x00,
+	REG_STATUS = 0x04,
+	REG_IRQ_ENABLE = 0x08,
+	REG_IRQ_THRESHOLD = 0x0c,
+	REG_RING_BASE = 0x10,
+	REG_RING_SIZE = 0x14,
+	REG_RING_HEAD = 0x18,
+	REG_RING_TAIL = 0x1c,
+	REG_SNAP_LENGTH = 0x20,
+	REG_RX_FRAMES = 0x24,
+	REG_TX_FRAMES = 0x28,
+	REG_RX_DROPS = 0x2c,
+	REG_TX_DROPS = 0x30,
+	REG_BUS_ERRORS = 0x34,
+	REG_FILTER = 0x80,		// 0x20 bytes for each filter
+};
+
+enum FilterRegister : std::uint32_t {
+	FILTER_CONTROL = 0x00,
+	FILTER_ETHERTYPE = 0x04,
+	FILTER_PROTOCOL = 0x08,
+	FILTER_ADDRESS = 0x0c,
+	FILTER_MASK = 0x10,
+	FILTER_PORT = 0x14,
+};
+
+static constexpr const std::size_t FILTERS = 4;
+
+static constexpr const std::uint32_t CONTROL_RX = 1u << 0;
+static constexpr const std::uint32_t CONTROL_TX = 1u << 1;
+static constexpr const std::uint32_t STATUS_RECORDS = 1u << 0;
+static constexpr const std::uint32_t STATUS_DROPS = 1u << 1;
+static constexpr const std::uint32_t STATUS_BUSY = 1u << 8;
+
+static constexpr const std::uint32_t FILTER_ENABLE = 1u << 0;
+static constexpr const std::uint32_t FILTER_RX = 1u << 1;
+static constexpr const std::uint32_t FILTER_TX = 1u << 2;
+static constexpr const std::uint32_t FILTER_CHECK_ETHERTYPE = 1u << 4;
+static constexpr const std::uint32_t FILTER_CHECK_PROTOCOL = 1u << 5;
+static constexpr const std::uint32_t FILTER_CHECK_ADDRESS = 1u << 6;
+static constexpr const std::uint32_t FILTER_CHECK_PORT = 1u << 7;
+static constexpr const std::uint32_t FILTER_CHECK_ERROR = 1u << 8;
+static constexpr const std::uint32_t FILTER_ERROR_VALUE = 1u << 9;
+
+static constexpr const std::size_t RECORD_HEADER_BYTES = 16;
+
+// Register values of a filter
+struct Filter {
+	std::uint32_t control = 0;
+	std::uint32_t ethertype = 0;
+	std::uint32_t protocol = 0;
+	std::uint32_t address = 0;
+	std::uint32_t mask = 0;
+	std::uint32_t port = 0;
+};
+
+// Parses a filter given as comma separated terms:
+//   rx, tx, ethertype=0x0800, proto=17, ip=192.168.1.0/24, port=319, error=0|1
+// The filter applies to both directions unless rx or tx is given. Throws std::invalid_argument.
+Filter parse_filter(const std::string& text);
+
+// A record in the ring
+struct Record {
+	bool tx;
+	bool error;
+	bool locked;
+	std::size_t frame_bytes;
+	std::uint32_t seconds;		// Lower 32 bits of the seconds
+	std::uint32_t nanoseconds;
+	std::vector<std::uint8_t> data;	// Captured bytes
+};
+
+// Reads the records between tail and head of a ring of size bytes, calling handler for each.
+// Returns the new tail, which is head unless a record is broken, in which case it stops there.
+template<typename Handler>
+std::uint32_t read_records(const volatile std::uint8_t* ring, std::uint32_t size, std::uint32_t tail, std::uint32_t head, Handler handler);
+
+// Writes pcapng with an interface for each direction of the capture.
+class PcapngWriter
+{
+	std::FILE* file;
+	std::vector<std::uint8_t> block;
+
+	void begin_block(std::uint32_t type);
+	void put32(std::uint32_t value);
+	void put16(std::uint16_t first, std::uint16_t second);
+	void put_bytes(const void* data, std::size_t length);
+	void put_option(std::uint16_t code, const void* data, std::size_t length);
+	bool end_block();
+
+public:
+	explicit PcapngWriter(std::FILE* file) : file(file) {}
+	// Section header and the interfaces 0 (RX) and 1 (TX) with nanosecond timestamps.
+	bool write_header(std::size_t snap_length, const std::string& rx_name, const std::string& tx_name);
+	// Enhanced packet block with the direction and the CRC error flag.
+	bool write(const Record& record);
+};
+
+
+template<typename Handler>
+std::uint32_t read_records(const volatile std::uint8_t* ring, std::uint32_t size, std::uint32_t tail, std::uint32_t head, Handler handler)
+{
+	auto read32 = [ring, size](std::uint32_t offset) {
+		std::uint32_t value = 0;
+		for(std::uint32_t i = 0; i < 4; i++) {
+			value |= static_cast<std::uint32_t>(ring[(offset + i) % size]) << (8*i);
+		}
+		return value;
+	};
+	while( tail != head ) {
+		auto used = (head + size - tail) % size;
+		std::uint32_t word0 = read32(tail);
+		std::uint32_t word1 = read32(tail + 4);
+		std::uint32_t record_bytes = word0 & 0xffff;
+		std::uint32_t captured = word1 & 0xffff;
+		if( record_bytes < RECORD_HEADER_BYTES || record_bytes > used || record_bytes != RECORD_HEADER_BYTES + (captured + 3) / 4 * 4 ) {
+			break;
+		}
+		Record record;
+		record.tx = (word0 >> 16) & 1;
+		record.error = (word0 >> 17) & 1;
+		record.frame_bytes = word1 >> 16;
+		record.seconds = read32(tail + 8);
+		std::uint32_t word3 = read32(tail + 12);
+		record.nanoseconds = word3 & 0x3fffffff;
+		record.locked = (word3 >> 31) & 1;
+		record.data.resize(captured);
+		auto data = (tail + RECORD_HEADER_BYTES) % size;
+		for(std::uint32_t i = 0; i < captured; i++) {
+			record.data[i] = ring[(data + i) % size];
+		}
+		handler(record);
+		tail = (tail + record_bytes) % size;
+	}
+	return tail;
+}
+
+}
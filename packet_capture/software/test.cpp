@@ -0,0 +1,271 @@
+#include "capture_ring.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+using namespace packet_capture;
+
+static int errors = 0;
+
+#define CHECK(condition) do { \
+	if( !(condition) ) { \
+		std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+		errors++; \
+	} \
+} while(0)
+
+static std::vector<std::uint8_t> make_frame(std::size_t length, std::uint8_t seed)
+{
+	std::vector<std::uint8_t> frame(length);
+	for(std::size_t i = 0; i < length; i++) {
+		frame[i] = static_cast<std::uint8_t>(seed + i);
+	}
+	return frame;
+}
+
+// Writes records into a ring the way packet_capture does.
+class RingWriter
+{
+	std::vector<std::uint8_t>& ring;
+	void put32(std::uint32_t value)
+	{
+		for(int i = 0; i < 4; i++) {
+			this->ring[this->head] = static_cast<std::uint8_t>(value >> (8*i));
+			this->head = (this->head + 1) % this->ring.size();
+		}
+	}
+public:
+	std::uint32_t head;
+	RingWriter(std::vector<std::uint8_t>& ring, std::uint32_t head) : ring(ring), head(head) {}
+	void write(const Record& record)
+	{
+		auto padded = (record.data.size() + 3) / 4 * 4;
+		this->put32(static_cast<std::uint32_t>(RECORD_HEADER_BYTES + padded) | (record.tx ? 1u << 16 : 0) | (record.error ? 1u << 17 : 0));
+		this->put32(static_cast<std::uint32_t>(record.data.size()) | static_cast<std::uint32_t>(record.frame_bytes) << 16);
+		this->put32(record.seconds);
+		this->put32(record.nanoseconds | (record.locked ? 1u << 31 : 0));
+		for(std::size_t i = 0; i < padded; i += 4) {
+			std::uint32_t word = 0;
+			for(std::size_t j = 0; j < 4 && i + j < record.data.size(); j++) {
+				word |= static_cast<std::uint32_t>(record.data[i + j]) << (8*j);
+			}
+			this->put32(word);
+		}
+	}
+};
+
+static Record make_record(std::size_t index, std::size_t captured, std::size_t frame_bytes)
+{
+	Record record;
+	record.tx = index % 3 == 1;
+	record.error = index % 5 == 4;
+	record.locked = index % 2 == 0;
+	record.frame_bytes = frame_bytes;
+	record.seconds = 1000 + static_cast<std::uint32_t>(index);
+	record.nanoseconds = 999999990 - static_cast<std::uint32_t>(index);
+	record.data = make_frame(captured, static_cast<std::uint8_t>(index));
+	return record;
+}
+
+// Records wrapping around the end of the ring, including their headers, are read back as written.
+static void test_read_records()
+{
+	std::vector<std::uint8_t> ring(256);
+	std::vector<Record> expected;
+	std::uint32_t tail = 200;
+	RingWriter writer(ring, tail);
+	std::size_t index = 0;
+	for(int batch = 0; batch < 20; batch++) {
+		for(int i = 0; i < 2; i++, index++) {
+			auto captured = 1 + (index * 13) % 60;
+			expected.push_back(make_record(index, captured, captured + index % 2 * 100));
+			writer.write(expected.back());
+		}
+		std::vector<Record> records;
+		tail = read_records(ring.data(), static_cast<std::uint32_t>(ring.size()), tail, writer.head, [&](const Record& record) {
+			records.push_back(record);
+		});
+		CHECK(tail == writer.head);
+		CHECK(records.size() == 2);
+		for(std::size_t i = 0; i < records.size() && i < 2; i++) {
+			const auto& e = expected[expected.size() - 2 + i];
+			const auto& r = records[i];
+			CHECK(r.tx == e.tx);
+			CHECK(r.error == e.error);
+			CHECK(r.locked == e.locked);
+			CHECK(r.frame_bytes == e.frame_bytes);
+			CHECK(r.seconds == e.seconds);
+			CHECK(r.nanoseconds == e.nanoseconds);
+			CHECK(r.data == e.data);
+		}
+	}
+}
+
+// Reading stops at a record not consistent with its captured bytes or longer than the written bytes.
+static void test_broken_record()
+{
+	std::vector<std::uint8_t> ring(256);
+	RingWriter writer(ring, 0);
+	writer.write(make_record(0, 10, 10));
+	auto first = writer.head;
+	writer.write(make_record(1, 20, 20));
+	std::size_t count = 0;
+	auto counter = [&](const Record&) { count++; };
+	CHECK(read_records(ring.data(), 256, 0, first + 8, counter) == first);
+	CHECK(count == 1);
+	ring[first + 4] = 30;
+	count = 0;
+	CHECK(read_records(ring.data(), 256, 0, writer.head, counter) == first);
+	CHECK(count == 1);
+}
+
+static void test_parse_filter()
+{
+	auto filter = parse_filter("rx,proto=17,port=319");
+	CHECK(filter.control == (FILTER_ENABLE | FILTER_RX | FILTER_CHECK_PROTOCOL | FILTER_CHECK_PORT));
+	CHECK(filter.protocol == 17);
+	CHECK(filter.port == 319);
+
+	filter = parse_filter("ethertype=0x88f7,ip=192.168.1.0/24");
+	CHECK(filter.control == (FILTER_ENABLE | FILTER_RX | FILTER_TX | FILTER_CHECK_ETHERTYPE | FILTER_CHECK_ADDRESS));
+	CHECK(filter.ethertype == 0x88f7);
+	CHECK(filter.address == 0xc0a80100);
+	CHECK(filter.mask == 0xffffff00);
+
+	filter = parse_filter("tx,error=1,ip=10.0.0.1");
+	CHECK(filter.control == (FILTER_ENABLE | FILTER_TX | FILTER_CHECK_ERROR | FILTER_ERROR_VALUE | FILTER_CHECK_ADDRESS));
+	CHECK(filter.address == 0x0a000001);
+	CHECK(filter.mask == 0xffffffff);
+
+	CHECK(parse_filter("ip=0.0.0.0/0").mask == 0);
+
+	for(const char* text : {"proto=256", "ip=1.2.3", "ip=1.2.3.4.5", "ip=1.2.3.4/33", "port=x", "vlan=1", "rx=1"}) {
+		bool thrown = false;
+		try {
+			parse_filter(text);
+		}
+		catch(const std::invalid_argument&) {
+			thrown = true;
+		}
+		CHECK(thrown);
+	}
+}
+
+static std::uint32_t get32(const std::vector<std::uint8_t>& data, std::size_t offset)
+{
+	std::uint32_t value;
+	std::memcpy(&value, &data[offset], 4);
+	return value;
+}
+
+static std::uint16_t get16(const std::vector<std::uint8_t>& data, std::size_t offset)
+{
+	std::uint16_t value;
+	std::memcpy(&value, &data[offset], 2);
+	return value;
+}
+
+// Finds the option in the options of a block, returning its offset or 0.
+static std::size_t find_option(const std::vector<std::uint8_t>& data, std::size_t offset, std::size_t end, std::uint16_t code)
+{
+	while( offset + 4 <= end ) {
+		auto option = get16(data, offset);
+		auto length = get16(data, offset + 2);
+		if( option == code ) {
+			return offset;
+		}
+		if( option == 0 ) {
+			break;
+		}
+		offset += 4 + (length + 3) / 4 * 4;
+	}
+	return 0;
+}
+
+// The blocks of the pcapng output are well formed, and the packets have the timestamps, lengths and flags of the records.
+static void test_pcapng()
+{
+	auto file = std::tmpfile();
+	CHECK(file != nullptr);
+	if( file == nullptr ) {
+		return;
+	}
+	PcapngWriter writer(file);
+	CHECK(writer.write_header(128, "rx", "tx"));
+	std::vector<Record> records;
+	for(std::size_t i = 0; i < 6; i++) {
+		records.push_back(make_record(i, 60 + i, 60 + i * 50));
+		CHECK(writer.write(records.back()));
+	}
+	std::vector<std::uint8_t> data(static_cast<std::size_t>(std::ftell(file)));
+	std::rewind(file);
+	CHECK(std::fread(data.data(), 1, data.size(), file) == data.size());
+	std::fclose(file);
+
+	std::size_t offset = 0;
+	std::size_t interfaces = 0;
+	std::size_t packets = 0;
+	while( offset + 12 <= data.size() ) {
+		auto type = get32(data, offset);
+		auto length = get32(data, offset + 4);
+		CHECK(length % 4 == 0 && length >= 12 && offset + length <= data.size());
+		if( length % 4 != 0 || length < 12 || offset + length > data.size() ) {
+			break;
+		}
+		CHECK(get32(data, offset + length - 4) == length);
+		if( offset == 0 ) {
+			CHECK(type == 0x0a0d0d0a);
+			CHECK(get32(data, 8) == 0x1a2b3c4d);
+		}
+		else if( type == 1 ) {
+			CHECK(get16(data, offset + 8) == 1);
+			CHECK(get32(data, offset + 12) == 128);
+			auto name = find_option(data, offset + 16, offset + length - 4, 2);
+			CHECK(name != 0 && get16(data, name + 2) == 2);
+			CHECK(name != 0 && std::memcmp(&data[name + 4], interfaces == 0 ? "rx" : "tx", 2) == 0);
+			auto resolution = find_option(data, offset + 16, offset + length - 4, 9);
+			CHECK(resolution != 0 && data[resolution + 4] == 9);
+			interfaces++;
+		}
+		else if( type == 6 ) {
+			CHECK(interfaces == 2);
+			CHECK(packets < records.size());
+			if( packets < records.size() ) {
+				const auto& record = records[packets];
+				std::uint64_t timestamp = static_cast<std::uint64_t>(get32(data, offset + 12)) << 32 | get32(data, offset + 16);
+				auto captured = get32(data, offset + 20);
+				CHECK(get32(data, offset + 8) == (record.tx ? 1u : 0u));
+				CHECK(timestamp == record.seconds * 1000000000ull + record.nanoseconds);
+				CHECK(captured == record.data.size());
+				CHECK(get32(data, offset + 24) == record.frame_bytes);
+				CHECK(std::vector<std::uint8_t>(&data[offset + 28], &data[offset + 28 + captured]) == record.data);
+				auto flags = find_option(data, offset + 28 + (captured + 3) / 4 * 4, offset + length - 4, 2);
+				CHECK(flags != 0 && get32(data, flags + 4) == ((record.tx ? 2u : 1u) | (record.error ? 1u << 24 : 0)));
+			}
+			packets++;
+		}
+		else {
+			CHECK(false);
+		}
+		offset += length;
+	}
+	CHECK(offset == data.size());
+	CHECK(interfaces == 2);
+	CHECK(packets == records.size());
+}
+
+int main()
+{
+	test_read_records();
+	test_broken_record();
+	test_parse_filter();
+	test_pcapng();
+	if( errors > 0 ) {
+		std::fprintf(stderr, "%d checks failed\n", errors);
+		return EXIT_FAILURE;
+	}
+	std::printf("All tests passed\n");
+	return EXIT_SUCCESS;
+}
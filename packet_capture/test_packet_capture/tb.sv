@@ -0,0 +1,546 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+
+    localparam int FIFO_DEPTH_BITS = 7;
+    localparam bit [31:0] ERROR_ADDRESS = 32'hf000_0000;   // The memory responds SLVERR from here.
+    localparam int RX = 0;
+    localparam int TX = 1;
+    localparam int TAP_LATENCY = 3;     // Clocks from the tap to capture_tap through capture_tap_cdc
+
+    typedef bit [7:0] frame_t[$];
+
+    logic        rx_tap_clock;
+    logic        tx_tap_clock;
+    logic        rx_tap_aresetn;
+    logic        tx_tap_aresetn;
+    logic [7:0]  tap_tdata[2];
+    logic        tap_tvalid[2];
+    logic        tap_tready[2];
+    logic        tap_tuser[2];
+    logic        tap_tlast[2];
+    logic [47:0] time_seconds = 48'h0000_6543_2100;
+    logic [31:0] time_nanoseconds = 999_999_000;
+    logic        time_locked = 1;
+    logic        interrupt;
+
+    logic [31:0] m_axi_awaddr;
+    logic  [7:0] m_axi_awlen;
+    logic  [2:0] m_axi_awsize;
+    logic  [1:0] m_axi_awburst;
+    logic  [3:0] m_axi_awcache;
+    logic  [2:0] m_axi_awprot;
+    logic        m_axi_awvalid;
+    logic        m_axi_awready = 0;
+    logic [31:0] m_axi_wdata;
+    logic  [3:0] m_axi_wstrb;
+    logic        m_axi_wlast;
+    logic        m_axi_wvalid;
+    logic        m_axi_wready = 0;
+    logic  [1:0] m_axi_bresp = 0;
+    logic        m_axi_bvalid = 0;
+    logic        m_axi_bready;
+
+    logic [7:0]  s_axi_awaddr;
+    logic        s_axi_awvalid = 0;
+    logic        s_axi_awready;
+    logic [31:0] s_axi_wdata;
+    logic [3:0]  s_axi_wstrb;
+    logic        s_axi_wvalid = 0;
+    logic        s_axi_wready;
+    logic [1:0]  s_axi_bresp;
+    logic        s_axi_bvalid;
+    logic        s_axi_bready = 0;
+    logic [7:0]  s_axi_araddr;
+    logic        s_axi_arvalid = 0;
+    logic        s_axi_arready;
+    logic [31:0] s_axi_rdata;
+    logic [1:0]  s_axi_rresp;
+    logic        s_axi_rvalid;
+    logic        s_axi_rready = 0;
+
+    packet_capture #(
+        .FIFO_DEPTH_BITS(FIFO_DEPTH_BITS)
+    ) dut (
+        .rx_tap_tdata(tap_tdata[RX]),
+        .rx_tap_tvalid(tap_tvalid[RX]),
+        .rx_tap_tready(tap_tready[RX]),
+        .rx_tap_tuser(tap_tuser[RX]),
+        .rx_tap_tlast(tap_tlast[RX]),
+        .tx_tap_tdata(tap_tdata[TX]),
+        .tx_tap_tvalid(tap_tvalid[TX]),
+        .tx_tap_tready(tap_tready[TX]),
+        .tx_tap_tuser(tap_tuser[TX]),
+        .tx_tap_tlast(tap_tlast[TX]),
+        .*
+    );
+
+    initial begin
+        clock = 0;
+        for(int i = 0; i < 2; i++) begin
+            tap_tdata[i] = 0;
+            tap_tvalid[i] = 0;
+            tap_tready[i] = 1;
+            tap_tuser[i] = 0;
+            tap_tlast[i] = 0;
+        end
+    end
+    always #(5) begin
+        clock = ~clock;
+    end
+    // The taps are in the clock domain.
+    assign rx_tap_clock = clock;
+    assign tx_tap_clock = clock;
+    assign rx_tap_aresetn = aresetn;
+    assign tx_tap_aresetn = aresetn;
+
+    // Time base advancing 10ns every clock
+    always @(posedge clock) begin
+        if( time_nanoseconds + 10 >= 1_000_000_000 ) begin
+            time_nanoseconds <= time_nanoseconds + 10 - 1_000_000_000;
+            time_seconds <= time_seconds + 1;
+        end
+        else begin
+            time_nanoseconds <= time_nanoseconds + 10;
+        end
+    end
+
+    localparam bit [7:0] REG_CONTROL = 8'h00;
+    localparam bit [7:0] REG_STATUS = 8'h04;
+    localparam bit [7:0] REG_IRQ_ENABLE = 8'h08;
+    localparam bit [7:0] REG_IRQ_THRESHOLD = 8'h0c;
+    localparam bit [7:0] REG_RING_BASE = 8'h10;
+    localparam bit [7:0] REG_RING_SIZE = 8'h14;
+    localparam bit [7:0] REG_RING_HEAD = 8'h18;
+    localparam bit [7:0] REG_RING_TAIL = 8'h1c;
+    localparam bit [7:0] REG_SNAP_LENGTH = 8'h20;
+    localparam bit [7:0] REG_RX_FRAMES = 8'h24;
+    localparam bit [7:0] REG_TX_FRAMES = 8'h28;
+    localparam bit [7:0] REG_RX_DROPS = 8'h2c;
+    localparam bit [7:0] REG_TX_DROPS = 8'h30;
+    localparam bit [7:0] REG_BUS_ERRORS = 8'h34;
+    localparam bit [7:0] REG_FILTER = 8'h80;
+
+    localparam bit [7:0] FILTER_CONTROL = 8'h00;
+    localparam bit [7:0] FILTER_ETHERTYPE = 8'h04;
+    localparam bit [7:0] FILTER_PROTOCOL = 8'h08;
+    localparam bit [7:0] FILTER_ADDRESS = 8'h0c;
+    localparam bit [7:0] FILTER_MASK = 8'h10;
+    localparam bit [7:0] FILTER_PORT = 8'h14;
+
+    localparam bit [31:0] FILTER_ENABLE = 32'h001;
+    localparam bit [31:0] FILTER_RX = 32'h002;
+    localparam bit [31:0] FILTER_TX = 32'h004;
+    localparam bit [31:0] CHECK_ETHERTYPE = 32'h010;
+    localparam bit [31:0] CHECK_PROTOCOL = 32'h020;
+    localparam bit [31:0] CHECK_ADDRESS = 32'h040;
+    localparam bit [31:0] CHECK_PORT = 32'h080;
+    localparam bit [31:0] CHECK_ERROR = 32'h100;
+    localparam bit [31:0] ERROR_VALUE = 32'h200;
+
+    // Memory on the AXI4 master. Each channel is stalled at random.
+    bit [7:0] memory[bit [31:0]];
+    bit [31:0] ring_base;
+    int        ring_size;
+
+    function automatic bit [7:0] memory_read(input bit [31:0] address);
+        return memory.exists(address) ? memory[address] : 8'h00;
+    endfunction
+
+    typedef struct {
+        bit [31:0] address;
+        bit [7:0]  length;
+    } burst_t;
+    burst_t write_bursts[$];
+    bit [36:0] write_beats[$];      // {last, strobe, data}
+
+    always @(posedge clock) begin
+        if( m_axi_awvalid && m_axi_awready ) begin
+            automatic bit [31:0] last_address = m_axi_awaddr + 4*m_axi_awlen;
+            if( m_axi_awsize != 3'b010 || m_axi_awburst != 2'b01 ) $error("write: size %0d, burst %0d", m_axi_awsize, m_axi_awburst);
+            if( m_axi_awaddr[1:0] != 0 ) $error("write: unaligned address %08x", m_axi_awaddr);
+            if( m_axi_awlen >= 16 ) $error("write: %0d beats at %08x", m_axi_awlen + 1, m_axi_awaddr);
+            if( m_axi_awaddr[31:12] != last_address[31:12] ) $error("write: burst of %0d beats at %08x crosses a 4KB boundary", m_axi_awlen + 1, m_axi_awaddr);
+            if( m_axi_awaddr < ring_base || last_address + 4 > ring_base + ring_size ) $error("write: burst of %0d beats at %08x is out of the ring", m_axi_awlen + 1, m_axi_awaddr);
+            write_bursts.push_back('{m_axi_awaddr, m_axi_awlen});
+        end
+        if( m_axi_wvalid && m_axi_wready ) begin
+            write_beats.push_back({m_axi_wlast, m_axi_wstrb, m_axi_wdata});
+        end
+        m_axi_awready <= $urandom_range(0, 2) == 0;
+        m_axi_wready <= $urandom_range(0, 2) != 0;
+    end
+
+    always begin
+        burst_t burst;
+        bit [36:0] beat;
+        bit error;
+        while(write_bursts.size() == 0) @(posedge clock);
+        burst = write_bursts.pop_front();
+        error = burst.address >= ERROR_ADDRESS;
+        for(int i = 0; i <= burst.length; i++) begin
+            while(write_beats.size() == 0) @(posedge clock);
+            beat = write_beats.pop_front();
+            if( beat[36] != (i == burst.length) ) $error("wlast %0d at beat %0d of %0d", beat[36], i, burst.length + 1);
+            for(int b = 0; b < 4; b++) begin
+                if( beat[32 + b] && !error ) memory[burst.address + 4*i + b] = beat[8*b +: 8];
+            end
+        end
+        @(posedge clock);
+        repeat($urandom_range(0, 4)) @(posedge clock);
+        m_axi_bresp <= error ? 2'b10 : 2'b00;
+        m_axi_bvalid <= 1;
+        do @(posedge clock); while(!m_axi_bready);
+        m_axi_bvalid <= 0;
+    end
+
+    // Records expected for each tap
+    typedef struct {
+        frame_t    data;
+        int        frame_bytes;
+        bit        error;
+        bit [31:0] seconds;
+        bit [29:0] nanoseconds;
+    } record_t;
+    record_t expected[2][$];
+    int      snap_length = 0;
+
+    function automatic frame_t make_frame(input int length, input int seed);
+        frame_t frame;
+        for(int i = 0; i < length; i++) frame.push_back(8'(seed * 31 + i * 7));
+        return frame;
+    endfunction
+
+    // IPv4 frame with up to two VLAN tags. protocol 6 or 17 has the ports.
+    function automatic frame_t make_ipv4(input int length, input bit [7:0] protocol, input bit [31:0] source, input bit [31:0] destination,
+                                         input bit [15:0] source_port = 0, input bit [15:0] destination_port = 0,
+                                         input int tags = 0, input bit [12:0] fragment_offset = 0);
+        frame_t frame = {8'h02, 8'h00, 8'h00, 8'h00, 8'h00, 8'h01, 8'h02, 8'h00, 8'h00, 8'h00, 8'h00, 8'h02};
+        for(int i = 0; i < tags; i++) frame = {frame, i == 0 && tags == 2 ? 8'h88 : 8'h81, i == 0 && tags == 2 ? 8'ha8 : 8'h00, 8'h00, 8'h05};
+        frame = {frame, 8'h08, 8'h00};
+        frame = {frame, 8'h45, 8'h00, 8'h00, 8'h00, 8'h12, 8'h34, {3'b000, fragment_offset[12:8]}, fragment_offset[7:0], 8'h40, protocol, 8'h00, 8'h00};
+        frame = {frame, source[31:24], source[23:16], source[15:8], source[7:0]};
+        frame = {frame, destination[31:24], destination[23:16], destination[15:8], destination[7:0]};
+        frame = {frame, source_port[15:8], source_port[7:0], destination_port[15:8], destination_port[7:0]};
+        while(frame.size() < length) frame.push_back(8'(frame.size()));
+        return frame;
+    endfunction
+
+    function automatic frame_t make_ethertype(input int length, input bit [15:0] ethertype);
+        frame_t frame = make_frame(length, 3);
+        frame[12] = ethertype[15:8];
+        frame[13] = ethertype[7:0];
+        return frame;
+    endfunction
+
+    // Sends a frame on a tap, stalled at random by the consumer. The record is expected if captured is set.
+    task automatic send(input int tap, input frame_t frame, input bit captured, input bit user = 0, input bit gaps = 0);
+        record_t record;
+        foreach(frame[i]) begin
+            tap_tdata[tap] <= frame[i];
+            tap_tvalid[tap] <= 1;
+            tap_tuser[tap] <= user && i == frame.size() - 1;
+            tap_tlast[tap] <= i == frame.size() - 1;
+            do begin
+                @(posedge clock);
+                // The time sampled with the first byte, TAP_LATENCY clocks later
+                if( i == 0 ) begin
+                    automatic int nanoseconds = time_nanoseconds + 10 * TAP_LATENCY;
+                    record.seconds = time_seconds[31:0] + (nanoseconds >= 1_000_000_000);
+                    record.nanoseconds = 30'(nanoseconds % 1_000_000_000);
+                end
+            end while(!tap_tready[tap]);
+            tap_tvalid[tap] <= 0;
+            if( gaps ) repeat($urandom_range(0, 2)) @(posedge clock);
+        end
+        if( captured ) begin
+            for(int i = 0; i < frame.size() && (snap_length == 0 || i < snap_length); i++) record.data.push_back(frame[i]);
+            record.frame_bytes = frame.size();
+            record.error = user;
+            expected[tap].push_back(record);
+        end
+    endtask
+
+    // Consumer of the tap stalling at random
+    bit stall[2] = '{0, 0};
+    always @(posedge clock) begin
+        for(int i = 0; i < 2; i++) tap_tready[i] <= !stall[i] || $urandom_range(0, 2) != 0;
+    end
+
+    // The register accesses are serialized for the threads.
+    semaphore axi_lock = new(1);
+
+    task automatic axi_write(input logic [7:0] address, input logic [31:0] data);
+        axi_lock.get();
+        s_axi_awaddr <= address;
+        s_axi_awvalid <= 1;
+        s_axi_wdata <= data;
+        s_axi_wstrb <= 4'hf;
+        s_axi_wvalid <= 1;
+        s_axi_bready <= 1;
+        do @(posedge clock); while(!(s_axi_awready && s_axi_wready));
+        s_axi_awvalid <= 0;
+        s_axi_wvalid <= 0;
+        do @(posedge clock); while(!s_axi_bvalid);
+        s_axi_bready <= 0;
+        axi_lock.put();
+    endtask
+
+    task automatic axi_read(input logic [7:0] address, output logic [31:0] data);
+        axi_lock.get();
+        s_axi_araddr <= address;
+        s_axi_arvalid <= 1;
+        s_axi_rready <= 1;
+        do @(posedge clock); while(!s_axi_arready);
+        s_axi_arvalid <= 0;
+        do @(posedge clock); while(!s_axi_rvalid);
+        data = s_axi_rdata;
+        s_axi_rready <= 0;
+        axi_lock.put();
+    endtask
+
+    task automatic check_register(input logic [7:0] address, input logic [31:0] expected, input string name);
+        logic [31:0] value;
+        axi_read(address, value);
+        if( value != expected ) $error("%s expected: %0d, actual: %0d", name, expected, value);
+    endtask
+
+    task automatic set_ring(input bit [31:0] base, input int size);
+        ring_base = base;
+        ring_size = size;
+        axi_write(REG_RING_BASE, base);
+        axi_write(REG_RING_SIZE, size);
+    endtask
+
+    task automatic set_filter(input int index, input bit [31:0] control, input bit [15:0] ethertype = 0, input bit [7:0] protocol = 0,
+                              input bit [31:0] address = 0, input bit [31:0] mask = 0, input bit [15:0] port = 0);
+        axi_write(REG_FILTER + 32*index + FILTER_ETHERTYPE, ethertype);
+        axi_write(REG_FILTER + 32*index + FILTER_PROTOCOL, protocol);
+        axi_write(REG_FILTER + 32*index + FILTER_ADDRESS, address);
+        axi_write(REG_FILTER + 32*index + FILTER_MASK, mask);
+        axi_write(REG_FILTER + 32*index + FILTER_PORT, port);
+        axi_write(REG_FILTER + 32*index + FILTER_CONTROL, control);
+    endtask
+
+    // Reads the records between TAIL and HEAD like the software.
+    int tail = 0;
+
+    function automatic bit [31:0] ring_read32(input int offset);
+        bit [31:0] value;
+        for(int i = 0; i < 4; i++) value[8*i +: 8] = memory_read(ring_base + (offset + i) % ring_size);
+        return value;
+    endfunction
+
+    task automatic read_records(input string name, output int count);
+        logic [31:0] head;
+        count = 0;
+        axi_read(REG_RING_HEAD, head);
+        while( tail != head ) begin
+            automatic bit [31:0] word0 = ring_read32(tail);
+            automatic bit [31:0] word1 = ring_read32(tail + 4);
+            automatic bit [31:0] word2 = ring_read32(tail + 8);
+            automatic bit [31:0] word3 = ring_read32(tail + 12);
+            automatic int tap = word0[16];
+            automatic int captured = word1[15:0];
+            automatic record_t record;
+            if( expected[tap].size() == 0 ) begin
+                $error("%s: unexpected record of %s at %0d", name, tap == TX ? "TX" : "RX", tail);
+                $finish;
+            end
+            record = expected[tap].pop_front();
+            if( word0[15:0] != 16 + (captured + 3) / 4 * 4 ) $error("%s: record bytes %0d for %0d captured bytes", name, word0[15:0], captured);
+            if( word0[17] != record.error ) $error("%s: error flag %0d, expected %0d", name, word0[17], record.error);
+            if( captured != record.data.size() ) $error("%s: captured bytes %0d, expected %0d", name, captured, record.data.size());
+            if( word1[31:16] != record.frame_bytes ) $error("%s: frame bytes %0d, expected %0d", name, word1[31:16], record.frame_bytes);
+            if( word2 != record.seconds || word3 != {2'b10, record.nanoseconds} ) begin
+                $error("%s: timestamp %0d.%09d, expected %0d.%09d", name, word2, word3[29:0], record.seconds, record.nanoseconds);
+            end
+            for(int i = 0; i < captured && i < record.data.size(); i++) begin
+                if( memory_read(ring_base + (tail + 16 + i) % ring_size) != record.data[i] ) begin
+                    $error("%s: byte %0d of the record is %02x, expected %02x", name, i, memory_read(ring_base + (tail + 16 + i) % ring_size), record.data[i]);
+                    break;
+                end
+            end
+            tail = (tail + word0[15:0]) % ring_size;
+            count++;
+        end
+        axi_write(REG_RING_TAIL, tail);
+    endtask
+
+    // Reads the records until all the expected ones are read.
+    task automatic drain(input string name);
+        int count;
+        for(int i = 0; i < 2000 && expected[RX].size() + expected[TX].size() != 0; i++) begin
+            read_records(name, count);
+            repeat(20) @(posedge clock);
+        end
+        if( expected[RX].size() + expected[TX].size() != 0 ) begin
+            $error("%s: %0d RX and %0d TX records missing", name, expected[RX].size(), expected[TX].size());
+            expected[RX] = {};
+            expected[TX] = {};
+        end
+        repeat(100) @(posedge clock);
+        read_records(name, count);
+        if( count != 0 ) $error("%s: %0d extra records", name, count);
+    endtask
+
+    initial begin
+        int count;
+        bit sent;
+        logic [31:0] value;
+
+        aresetn <= 0;
+        repeat(4) @(posedge clock);
+        aresetn <= 1;
+        repeat(4) @(posedge clock);
+
+        // The ring crosses a 4KB boundary.
+        set_ring(32'h0001_0e00, 1024);
+        axi_write(REG_CONTROL, 3);
+
+        // Frames on both taps at once, across the end of the second of the time base
+        fork
+            begin
+                send(RX, make_frame(60, 1), 1);
+                send(RX, make_frame(61, 2), 1, 1);
+                send(RX, make_frame(1, 3), 1);
+                send(RX, make_frame(150, 4), 1, 0, 1);
+            end
+            begin
+                send(TX, make_frame(62, 5), 1);
+                send(TX, make_frame(3, 6), 1, 0, 1);
+                send(TX, make_frame(200, 7), 1);
+            end
+        join
+        drain("both taps");
+        check_register(REG_RX_FRAMES, 4, "RX_FRAMES");
+        check_register(REG_TX_FRAMES, 3, "TX_FRAMES");
+
+        // Snap length
+        snap_length = 64;
+        axi_write(REG_SNAP_LENGTH, snap_length);
+        send(RX, make_frame(64, 8), 1);
+        send(RX, make_frame(65, 9), 1);
+        send(TX, make_frame(300, 10), 1);
+        drain("snap length");
+
+        // The ring wraps around many times with the taps stalled by the consumer.
+        stall = '{1, 1};
+        sent = 0;
+        fork
+            begin
+                fork
+                    for(int i = 0; i < 30; i++) send(RX, make_frame(20 + (i * 37) % 180, 20 + i), 1, 0, i % 2);
+                    for(int i = 0; i < 30; i++) send(TX, make_frame(10 + (i * 53) % 200, 60 + i), 1, 0, i % 3 == 0);
+                join
+                sent = 1;
+            end
+            while( !sent ) begin
+                read_records("wrap", count);
+                repeat(20) @(posedge clock);
+            end
+        join
+        drain("wrap");
+        stall = '{0, 0};
+        snap_length = 0;
+        axi_write(REG_SNAP_LENGTH, 0);
+        check_register(REG_RX_FRAMES, 36, "RX_FRAMES after the wrap");
+        check_register(REG_TX_FRAMES, 34, "TX_FRAMES after the wrap");
+        check_register(REG_RX_DROPS, 0, "RX_DROPS after the wrap");
+
+        // Filters. PTP event messages over UDP on both taps, frames from or to 192.168.1.0/24 on RX, and errors.
+        set_filter(0, FILTER_ENABLE | FILTER_RX | FILTER_TX | CHECK_ETHERTYPE | CHECK_PROTOCOL | CHECK_PORT, 16'h0800, 17, 0, 0, 319);
+        set_filter(1, FILTER_ENABLE | FILTER_RX | CHECK_ADDRESS, 0, 0, 32'hc0a8_0100, 32'hffff_ff00);
+        set_filter(3, FILTER_ENABLE | FILTER_RX | FILTER_TX | CHECK_ERROR | ERROR_VALUE);
+        send(RX, make_ipv4(80, 17, 32'h0a00_0001, 32'h0a00_0002, 1000, 319), 1);
+        send(RX, make_ipv4(80, 17, 32'h0a00_0001, 32'h0a00_0002, 319, 1000), 1);
+        send(RX, make_ipv4(80, 17, 32'h0a00_0001, 32'h0a00_0002, 1000, 320), 0);
+        send(RX, make_ipv4(80, 6, 32'h0a00_0001, 32'h0a00_0002, 1000, 319), 0);
+        send(RX, make_ipv4(80, 17, 32'h0a00_0001, 32'h0a00_0002, 1000, 319, 1), 1);
+        send(RX, make_ipv4(80, 17, 32'h0a00_0001, 32'h0a00_0002, 1000, 319, 2), 1);
+        send(RX, make_ipv4(80, 17, 32'h0a00_0001, 32'h0a00_0002, 1000, 319, 0, 100), 0);    // Not the first fragment
+        send(TX, make_ipv4(60, 17, 32'h0a00_0001, 32'h0a00_0002, 319, 319), 1);
+        send(RX, make_ipv4(60, 1, 32'hc0a8_0105, 32'h0a00_0002), 1);
+        send(RX, make_ipv4(60, 1, 32'h0a00_0002, 32'hc0a8_01fe), 1);
+        send(RX, make_ipv4(60, 1, 32'h0a00_0002, 32'hc0a8_0201), 0);
+        send(TX, make_ipv4(60, 1, 32'hc0a8_0105, 32'h0a00_0002), 0);
+        send(RX, make_ethertype(60, 16'h0806), 0);
+        send(RX, make_ethertype(60, 16'h0806), 1, 1);
+        send(TX, make_ethertype(20, 16'h0806), 1, 1);
+        drain("filters");
+        check_register(REG_RX_DROPS, 0, "RX_DROPS after the filters");
+        // EtherType only
+        set_filter(0, FILTER_ENABLE | FILTER_TX | CHECK_ETHERTYPE, 16'h88f7);
+        set_filter(1, 0);
+        set_filter(3, 0);
+        send(TX, make_ethertype(60, 16'h88f7), 1);
+        send(TX, make_ethertype(60, 16'h88f8), 0);
+        send(RX, make_ethertype(60, 16'h88f8), 1);     // No filter is enabled for RX.
+        drain("EtherType filter");
+        set_filter(0, 0);
+
+        // Frames longer than the FIFO are dropped at the tap.
+        send(RX, make_frame(4*2**FIFO_DEPTH_BITS + 1, 11), 0);
+        send(RX, make_frame(60, 12), 1);
+        drain("FIFO overflow");
+        check_register(REG_RX_DROPS, 1, "RX_DROPS after the FIFO overflow");
+        check_register(REG_STATUS, 3, "STATUS after the FIFO overflow");
+        axi_write(REG_STATUS, 3);
+
+        // Records which do not fit in the ring are dropped. 256 bytes hold 3 records of 76 bytes.
+        set_ring(32'h0002_0000, 256);
+        tail = 0;
+        axi_write(REG_IRQ_ENABLE, 2);
+        for(int i = 0; i < 5; i++) send(TX, make_frame(60, 13 + i), i < 3);
+        repeat(100) @(posedge clock);
+        check_register(REG_TX_DROPS, 2, "TX_DROPS after the ring is full");
+        if( !interrupt ) $error("no interrupt for the drops");
+        axi_write(REG_STATUS, 2);
+        if( interrupt ) $error("interrupt after STATUS is cleared");
+        drain("ring full");
+        send(TX, make_frame(60, 18), 1);
+        drain("after the ring is full");
+
+        // The interrupt is raised when the ring holds IRQ_THRESHOLD bytes.
+        set_ring(32'h0003_0000, 1024);
+        tail = 0;
+        axi_write(REG_IRQ_ENABLE, 1);
+        axi_write(REG_IRQ_THRESHOLD, 200);
+        axi_write(REG_STATUS, 1);
+        send(RX, make_frame(60, 19), 1);
+        send(RX, make_frame(60, 20), 1);
+        repeat(100) @(posedge clock);
+        if( interrupt ) $error("interrupt below the threshold");
+        send(RX, make_frame(60, 21), 1);
+        repeat(100) @(posedge clock);
+        if( !interrupt ) $error("no interrupt at the threshold");
+        drain("threshold");
+        axi_write(REG_STATUS, 1);
+        if( interrupt ) $error("interrupt after STATUS is cleared");
+        axi_write(REG_IRQ_ENABLE, 0);
+
+        // Disabled taps capture nothing, starting from the next frame.
+        axi_write(REG_CONTROL, 2);
+        send(RX, make_frame(60, 22), 0);
+        send(TX, make_frame(60, 23), 1);
+        axi_write(REG_CONTROL, 0);
+        send(TX, make_frame(60, 24), 0);
+        drain("disabled");
+        check_register(REG_RX_DROPS, 1, "RX_DROPS while disabled");
+        check_register(REG_STATUS, 0, "STATUS while idle");
+        axi_write(REG_CONTROL, 3);
+
+        // Error responses are counted and the records are lost.
+        set_ring(ERROR_ADDRESS, 1024);
+        tail = 0;
+        send(RX, make_frame(100, 25), 0);
+        repeat(200) @(posedge clock);
+        axi_read(REG_RING_HEAD, value);
+        if( value != 116 ) $error("RING_HEAD after the bus error: %0d", value);
+        check_register(REG_BUS_ERRORS, 2, "BUS_ERRORS");
+
+        $finish;
+    end
+endmodule
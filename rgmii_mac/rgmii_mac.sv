@@ -0,0 +1,171 @@
+`default_nettype none
+
+// gmii_mac with the RGMII interface.
+module rgmii_mac #(
+    parameter int TX_FIFO_DEPTH_BITS = 11,      // Cut-through FIFO on tx_saxis. 0 removes the FIFO.
+    parameter int TX_START_THRESHOLD = 256,     // Bytes buffered before a frame is started
+    parameter int TX_MUX_POLICY = 1,            // Arbitration between tx_saxis and tx_saxis_bypass. 0: strict priority, 1: round-robin, 2: DWRR
+    parameter int TX_MUX_QUANTUM = 1514,        // DWRR bytes per round of tx_saxis
+    parameter int TX_MUX_QUANTUM_BYPASS = 1514, // DWRR bytes per round of tx_saxis_bypass
+    parameter int RX_FIFO_DEPTH_BITS = 11       // RX FIFO, which drops the frames when rx_maxis is stalled longer than it holds
+) (
+    input wire tx_clock,                        // 125MHz
+    input wire tx_clock90,                      // tx_clock shifted by 90 degrees for TXC, or tx_clock if the PHY delays TXC
+    input wire tx_reset,
+
+    output wire [3:0] tx_rgmii_d,
+    output wire       tx_rgmii_ctl,
+    output wire       tx_rgmii_c,
+
+    input  wire [7:0] tx_saxis_tdata,
+    input  wire       tx_saxis_tvalid,
+    output wire       tx_saxis_tready,
+    input  wire       tx_saxis_tlast,
+
+    // Ethernet bypass input
+    input  wire [7:0] tx_saxis_bypass_tdata,
+    input  wire       tx_saxis_bypass_tvalid,
+    output wire       tx_saxis_bypass_tready,
+    input  wire       tx_saxis_bypass_tlast,
+
+    input wire rx_clock,                        // 125MHz RXC
+    input wire rx_reset,
+
+    input wire [3:0] rx_rgmii_d,
+    input wire       rx_rgmii_ctl,
+
+    output wire  [7:0] rx_maxis_tdata,
+    output wire        rx_maxis_tvalid,
+    input  wire        rx_maxis_tready,
+    output wire        rx_maxis_tuser,
+    output wire        rx_maxis_tlast,
+
+    // Time base (tx_clock domain)
+    input  wire [47:0] time_seconds,
+    input  wire [31:0] time_nanoseconds,
+    input  wire        time_locked,
+
+    // SFD timestamps of the frames on rx_maxis (tx_clock domain)
+    output wire [95:0] rx_timestamp_maxis_tdata,
+    output wire        rx_timestamp_maxis_tvalid,
+    input  wire        rx_timestamp_maxis_tready,
+
+    // PTP event records of received and transmitted frames (tx_clock domain)
+    input  wire          ptp_one_step,
+    output wire [127:0]  ptp_rx_event_maxis_tdata,
+    output wire          ptp_rx_event_maxis_tvalid,
+    input  wire          ptp_rx_event_maxis_tready,
+    output wire [127:0]  ptp_tx_event_maxis_tdata,
+    output wire          ptp_tx_event_maxis_tvalid,
+    input  wire          ptp_tx_event_maxis_tready,
+
+    // IEEE 802.3x flow control (tx_clock domain)
+    input  wire [47:0] pause_source_address,    // Source address of the PAUSE frames. The first byte on the wire at [47:40]
+    input  wire        pause_request,           // Asynchronous. Sends XOFF while asserted and XON when deasserted.
+    output wire        tx_paused,               // Transmission is paused by the link partner.
+
+    // Frames on tx_saxis aborted by underruns of the TX FIFO (tx_clock domain)
+    output wire [31:0] tx_underrun_count,
+
+    // Arbitration counters of tx_saxis and tx_saxis_bypass (tx_clock domain, see axis_mux)
+    output wire [31:0] tx_grant_count,
+    output wire [31:0] tx_bypass_grant_count,
+    output wire [31:0] tx_wait_cycles,
+    output wire [31:0] tx_bypass_wait_cycles,
+    output wire [31:0] tx_starvation_count,
+    output wire [31:0] tx_bypass_starvation_count,
+
+    // Received frames dropped or aborted by the reasons (rx_clock domain, see mii_mac_rx)
+    output wire [31:0] rx_overflow_drop_count,
+    output wire [31:0] rx_overflow_abort_count,
+    output wire [31:0] rx_fcs_error_count
+);
+
+logic [7:0] tx_gmii_d;
+logic       tx_gmii_en;
+logic       tx_gmii_er;
+logic [7:0] rx_gmii_d;
+logic       rx_gmii_dv;
+logic       rx_gmii_er;
+
+gmii_to_rgmii gmii_to_rgmii_inst (
+    .clock(tx_clock),
+    .clock90(tx_clock90),
+    .aresetn(!tx_reset),
+    .gmii_d(tx_gmii_d),
+    .gmii_en(tx_gmii_en),
+    .gmii_er(tx_gmii_er),
+    .rgmii_d(tx_rgmii_d),
+    .rgmii_ctl(tx_rgmii_ctl),
+    .rgmii_c(tx_rgmii_c));
+
+rgmii_to_gmii rgmii_to_gmii_inst (
+    .clock(rx_clock),
+    .aresetn(!rx_reset),
+    .rgmii_d(rx_rgmii_d),
+    .rgmii_ctl(rx_rgmii_ctl),
+    .gmii_d(rx_gmii_d),
+    .gmii_dv(rx_gmii_dv),
+    .gmii_er(rx_gmii_er));
+
+gmii_mac #(
+    .TX_FIFO_DEPTH_BITS(TX_FIFO_DEPTH_BITS),
+    .TX_START_THRESHOLD(TX_START_THRESHOLD),
+    .TX_MUX_POLICY(TX_MUX_POLICY),
+    .TX_MUX_QUANTUM(TX_MUX_QUANTUM),
+    .TX_MUX_QUANTUM_BYPASS(TX_MUX_QUANTUM_BYPASS),
+    .RX_FIFO_DEPTH_BITS(RX_FIFO_DEPTH_BITS)
+) gmii_mac_inst (
+    .tx_clock(tx_clock),
+    .tx_reset(tx_reset),
+    .tx_gmii_d(tx_gmii_d),
+    .tx_gmii_en(tx_gmii_en),
+    .tx_gmii_er(tx_gmii_er),
+    .tx_saxis_tdata(tx_saxis_tdata),
+    .tx_saxis_tvalid(tx_saxis_tvalid),
+    .tx_saxis_tready(tx_saxis_tready),
+    .tx_saxis_tlast(tx_saxis_tlast),
+    .tx_saxis_bypass_tdata(tx_saxis_bypass_tdata),
+    .tx_saxis_bypass_tvalid(tx_saxis_bypass_tvalid),
+    .tx_saxis_bypass_tready(tx_saxis_bypass_tready),
+    .tx_saxis_bypass_tlast(tx_saxis_bypass_tlast),
+    .rx_clock(rx_clock),
+    .rx_reset(rx_reset),
+    .rx_gmii_d(rx_gmii_d),
+    .rx_gmii_dv(rx_gmii_dv),
+    .rx_gmii_er(rx_gmii_er),
+    .rx_maxis_tdata(rx_maxis_tdata),
+    .rx_maxis_tvalid(rx_maxis_tvalid),
+    .rx_maxis_tready(rx_maxis_tready),
+    .rx_maxis_tuser(rx_maxis_tuser),
+    .rx_maxis_tlast(rx_maxis_tlast),
+    .time_seconds(time_seconds),
+    .time_nanoseconds(time_nanoseconds),
+    .time_locked(time_locked),
+    .rx_timestamp_maxis_tdata(rx_timestamp_maxis_tdata),
+    .rx_timestamp_maxis_tvalid(rx_timestamp_maxis_tvalid),
+    .rx_timestamp_maxis_tready(rx_timestamp_maxis_tready),
+    .ptp_one_step(ptp_one_step),
+    .ptp_rx_event_maxis_tdata(ptp_rx_event_maxis_tdata),
+    .ptp_rx_event_maxis_tvalid(ptp_rx_event_maxis_tvalid),
+    .ptp_rx_event_maxis_tready(ptp_rx_event_maxis_tready),
+    .ptp_tx_event_maxis_tdata(ptp_tx_event_maxis_tdata),
+    .ptp_tx_event_maxis_tvalid(ptp_tx_event_maxis_tvalid),
+    .ptp_tx_event_maxis_tready(ptp_tx_event_maxis_tready),
+    .pause_source_address(pause_source_address),
+    .pause_request(pause_request),
+    .tx_paused(tx_paused),
+    .tx_underrun_count(tx_underrun_count),
+    .tx_grant_count(tx_grant_count),
+    .tx_bypass_grant_count(tx_bypass_grant_count),
+    .tx_wait_cycles(tx_wait_cycles),
+    .tx_bypass_wait_cycles(tx_bypass_wait_cycles),
+    .tx_starvation_count(tx_starvation_count),
+    .tx_bypass_starvation_count(tx_bypass_starvation_count),
+    .rx_overflow_drop_count(rx_overflow_drop_count),
+    .rx_overflow_abort_count(rx_overflow_abort_count),
+    .rx_fcs_error_count(rx_fcs_error_count));
+
+endmodule
+
+`default_nettype wire
@@ -34,12 +34,21 @@ lappend source_files {../mii_axis/axis_to_rmii.sv}
 lappend source_files {../mii_axis/prepend_preamble.sv}
 lappend source_files {../mii_axis/rmii_to_axis.sv}
 lappend source_files {../util/simple_fifo.v}
+lappend source_files {../mii_mac/crc32_parallel.sv}
 lappend source_files {../mii_mac/crc_mac.sv}
 lappend source_files {../mii_mac/append_crc.sv}
 lappend source_files {../mii_mac/remove_crc.sv}
+lappend source_files {../mii_mac/rx_frame_fifo.sv}
 lappend source_files {../mii_mac/axis_mux.sv}
 lappend source_files {../mii_mac/mii_mac_tx.sv}
 lappend source_files {../mii_mac/mii_mac_rx.sv}
+lappend source_files {../mii_mac/tx_timestamp_insert.sv}
+lappend source_files {../mii_mac/rx_timestamp.sv}
+lappend source_files {../mii_mac/ptp_parser.sv}
+lappend source_files {../mii_mac/tx_ptp_event.sv}
+lappend source_files {../mii_mac/pause_parser.sv}
+lappend source_files {../mii_mac/pause_control.sv}
+lappend source_files {../mii_mac/axis_frame_gate.sv}
 lappend source_files {rmii_mac.sv}
 
 set constraint_files {}
@@ -93,7 +102,7 @@ set_property CORE_REVISION $core_revision $ipcore
 
 ### Add clock interfaces
 ## master
-add_clock_if tx_clock slave 50000000 {tx_xgmii:tx_saxis:tx_saxis_bypass}
+add_clock_if tx_clock slave 50000000 {tx_xgmii:tx_saxis:tx_saxis_bypass:rx_timestamp_maxis:ptp_rx_event_maxis:ptp_tx_event_maxis}
 add_clock_if rx_clock slave 50000000 {rx_xgmii:rx_maxis}
 
 ### Add reset interfaces
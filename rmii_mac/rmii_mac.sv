@@ -26,10 +26,54 @@ module rmii_mac (
 
     output wire  [7:0] rx_maxis_tdata,
     output wire        rx_maxis_tvalid,
+    input  wire        rx_maxis_tready,
     output wire        rx_maxis_tuser,
-    output wire        rx_maxis_tlast
+    output wire        rx_maxis_tlast,
+
+    // Time base (tx_clock domain)
+    input  wire [47:0] time_seconds,
+    input  wire [31:0] time_nanoseconds,
+    input  wire        time_locked,
+
+    // SFD timestamps of the frames on rx_maxis (tx_clock domain)
+    output wire [95:0] rx_timestamp_maxis_tdata,
+    output wire        rx_timestamp_maxis_tvalid,
+    input  wire        rx_timestamp_maxis_tready,
+
+    // PTP event records of received and transmitted frames (tx_clock domain)
+    input  wire          ptp_one_step,
+    output wire [127:0]  ptp_rx_event_maxis_tdata,
+    output wire          ptp_rx_event_maxis_tvalid,
+    input  wire          ptp_rx_event_maxis_tready,
+    output wire [127:0]  ptp_tx_event_maxis_tdata,
+    output wire          ptp_tx_event_maxis_tvalid,
+    input  wire          ptp_tx_event_maxis_tready,
+
+    // IEEE 802.3x flow control (tx_clock domain)
+    input  wire [47:0] pause_source_address,    // Source address of the PAUSE frames. The first byte on the wire at [47:40]
+    input  wire        pause_request,           // Asynchronous. Sends XOFF while asserted and XON when deasserted.
+    output wire        tx_paused,               // Transmission is paused by the link partner.
+
+    // Received frames dropped or aborted by the reasons (rx_clock domain, see mii_mac_rx)
+    output wire [31:0] rx_overflow_drop_count,
+    output wire [31:0] rx_overflow_abort_count,
+    output wire [31:0] rx_fcs_error_count
 );
 
+logic rx_sfd;
+logic rx_frame_stored;
+logic        rx_ptp_event;
+logic [1:0]  rx_ptp_transport;
+logic [3:0]  rx_ptp_message_type;
+logic [7:0]  rx_ptp_domain_number;
+logic [15:0] rx_ptp_sequence_id;
+logic        rx_pause_valid;
+logic [15:0] rx_pause_quanta;
+logic [7:0]  pause_frame_tdata;
+logic        pause_frame_tvalid;
+logic        pause_frame_tready;
+logic        pause_frame_tlast;
+
 mii_mac_tx #(
     .USE_RMII(1)
 ) mii_mac_tx_inst (
@@ -41,11 +85,25 @@ mii_mac_tx #(
     .saxis_tdata(tx_saxis_tdata),
     .saxis_tvalid(tx_saxis_tvalid),
     .saxis_tready(tx_saxis_tready),
+    .saxis_tuser(1'b0),
     .saxis_tlast(tx_saxis_tlast),
     .saxis_bypass_tdata(tx_saxis_bypass_tdata),
     .saxis_bypass_tvalid(tx_saxis_bypass_tvalid),
     .saxis_bypass_tready(tx_saxis_bypass_tready),
-    .saxis_bypass_tlast(tx_saxis_bypass_tlast));
+    .saxis_bypass_tlast(tx_saxis_bypass_tlast),
+    .saxis_control_tdata(pause_frame_tdata),
+    .saxis_control_tvalid(pause_frame_tvalid),
+    .saxis_control_tready(pause_frame_tready),
+    .saxis_control_tlast(pause_frame_tlast),
+    .pause(tx_paused),
+    .gate_hold_payload(1'b0),
+    .gate_hold_bypass(1'b0),
+    .time_seconds(time_seconds),
+    .time_nanoseconds(time_nanoseconds),
+    .ptp_one_step(ptp_one_step),
+    .ptp_event_maxis_tdata(ptp_tx_event_maxis_tdata),
+    .ptp_event_maxis_tvalid(ptp_tx_event_maxis_tvalid),
+    .ptp_event_maxis_tready(ptp_tx_event_maxis_tready));
 
 mii_mac_rx  #(
     .USE_RMII(1)
@@ -57,8 +115,62 @@ mii_mac_rx  #(
     .mii_er(0),
     .maxis_tdata(rx_maxis_tdata),
     .maxis_tvalid(rx_maxis_tvalid),
+    .maxis_tready(rx_maxis_tready),
     .maxis_tuser(rx_maxis_tuser),
-    .maxis_tlast(rx_maxis_tlast));
+    .maxis_tlast(rx_maxis_tlast),
+    .sfd(rx_sfd),
+    .frame_stored(rx_frame_stored),
+    .overflow_drop_count(rx_overflow_drop_count),
+    .overflow_abort_count(rx_overflow_abort_count),
+    .fcs_error_count(rx_fcs_error_count),
+    .ptp_event(rx_ptp_event),
+    .ptp_transport(rx_ptp_transport),
+    .ptp_message_type(rx_ptp_message_type),
+    .ptp_domain_number(rx_ptp_domain_number),
+    .ptp_sequence_id(rx_ptp_sequence_id),
+    .pause_valid(rx_pause_valid),
+    .pause_quanta(rx_pause_quanta));
+
+pause_control #(
+    .CLOCKS_PER_QUANTUM(256)
+) pause_control_inst (
+    .rx_clock(rx_clock),
+    .rx_aresetn(!rx_reset),
+    .rx_pause_valid(rx_pause_valid),
+    .rx_pause_quanta(rx_pause_quanta),
+    .clock(tx_clock),
+    .aresetn(!tx_reset),
+    .source_address(pause_source_address),
+    .pause_request(pause_request),
+    .paused(tx_paused),
+    .maxis_tdata(pause_frame_tdata),
+    .maxis_tvalid(pause_frame_tvalid),
+    .maxis_tready(pause_frame_tready),
+    .maxis_tlast(pause_frame_tlast));
+
+rx_timestamp #(
+    .LATENCY_NANOSECONDS(90)    // 2 RX clocks + 2.5 time base clocks at 50MHz
+) rx_timestamp_inst (
+    .rx_clock(rx_clock),
+    .rx_aresetn(!rx_reset),
+    .rx_sfd(rx_sfd),
+    .rx_frame_stored(rx_frame_stored),
+    .rx_ptp_event(rx_ptp_event),
+    .rx_ptp_transport(rx_ptp_transport),
+    .rx_ptp_message_type(rx_ptp_message_type),
+    .rx_ptp_domain_number(rx_ptp_domain_number),
+    .rx_ptp_sequence_id(rx_ptp_sequence_id),
+    .clock(tx_clock),
+    .aresetn(!tx_reset),
+    .time_seconds(time_seconds),
+    .time_nanoseconds(time_nanoseconds),
+    .time_locked(time_locked),
+    .maxis_tdata(rx_timestamp_maxis_tdata),
+    .maxis_tvalid(rx_timestamp_maxis_tvalid),
+    .maxis_tready(rx_timestamp_maxis_tready),
+    .ptp_maxis_tdata(ptp_rx_event_maxis_tdata),
+    .ptp_maxis_tvalid(ptp_rx_event_maxis_tvalid),
+    .ptp_maxis_tready(ptp_rx_event_maxis_tready));
 
 endmodule
 
@@ -0,0 +1,216 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+
+    logic pps;
+    logic [47:0] time_seconds;
+    logic [31:0] time_nanoseconds;
+    logic        time_locked;
+
+    logic         ptp_one_step;
+    logic [127:0] rx_event_saxis_tdata;
+    logic         rx_event_saxis_tvalid;
+    logic         rx_event_saxis_tready;
+    logic [127:0] tx_event_saxis_tdata;
+    logic         tx_event_saxis_tvalid;
+    logic         tx_event_saxis_tready;
+
+    logic [6:0]  s_axi_awaddr;
+    logic        s_axi_awvalid;
+    logic        s_axi_awready;
+    logic [31:0] s_axi_wdata;
+    logic [3:0]  s_axi_wstrb;
+    logic        s_axi_wvalid;
+    logic        s_axi_wready;
+    logic [1:0]  s_axi_bresp;
+    logic        s_axi_bvalid;
+    logic        s_axi_bready;
+    logic [6:0]  s_axi_araddr;
+    logic        s_axi_arvalid;
+    logic        s_axi_arready;
+    logic [31:0] s_axi_rdata;
+    logic [1:0]  s_axi_rresp;
+    logic        s_axi_rvalid;
+    logic        s_axi_rready;
+
+    time_base #(
+        .CLOCK_HZ(25000000)
+    ) dut (
+        .*
+    );
+
+    initial begin
+        clock = 0;
+    end 
+    always #(20) begin
+        clock = ~clock;
+    end
+
+    task automatic axi_write(input logic [6:0] address, input logic [31:0] data);
+        s_axi_awaddr <= address;
+        s_axi_awvalid <= 1;
+        s_axi_wdata <= data;
+        s_axi_wstrb <= 4'hf;
+        s_axi_wvalid <= 1;
+        s_axi_bready <= 1;
+        do @(posedge clock); while(!(s_axi_awready && s_axi_wready));
+        s_axi_awvalid <= 0;
+        s_axi_wvalid <= 0;
+        do @(posedge clock); while(!s_axi_bvalid);
+        s_axi_bready <= 0;
+    endtask
+
+    task automatic axi_read(input logic [6:0] address, output logic [31:0] data);
+        s_axi_araddr <= address;
+        s_axi_arvalid <= 1;
+        s_axi_rready <= 1;
+        do @(posedge clock); while(!s_axi_arready);
+        s_axi_arvalid <= 0;
+        do @(posedge clock); while(!s_axi_rvalid);
+        data = s_axi_rdata;
+        s_axi_rready <= 0;
+    endtask
+
+    function automatic longint to_nanoseconds(input logic [47:0] seconds, input logic [31:0] nanoseconds);
+        return longint'(seconds) * 1000000000 + nanoseconds;
+    endfunction
+
+    initial begin
+        logic [31:0] value;
+        logic [47:0] seconds;
+        logic [31:0] nanoseconds;
+        longint t0;
+        longint t1;
+
+        pps <= 0;
+        rx_event_saxis_tvalid <= 0;
+        tx_event_saxis_tvalid <= 0;
+        s_axi_awvalid <= 0;
+        s_axi_wvalid <= 0;
+        s_axi_bready <= 0;
+        s_axi_arvalid <= 0;
+        s_axi_rready <= 0;
+        aresetn <= 0;
+        repeat(4) @(posedge clock);
+        aresetn <= 1;
+        @(posedge clock);
+
+        // Nominal increment is 40[ns] per clock.
+        axi_read(7'h14, value);
+        if( value != 32'h2800_0000 ) $error("unexpected nominal increment %08x", value);
+        t0 = to_nanoseconds(time_seconds, time_nanoseconds);
+        repeat(100) @(posedge clock);
+        t1 = to_nanoseconds(time_seconds, time_nanoseconds);
+        if( t1 - t0 != 4000 ) $error("time advanced %0d[ns] in 100 clocks", t1 - t0);
+
+        // Set the time just before the second boundary.
+        axi_write(7'h08, 32'h0000_0001);
+        axi_write(7'h0c, 32'h0000_0005);
+        axi_write(7'h10, 32'd999999000);
+        axi_write(7'h00, 32'h0000_0001);
+        repeat(2) @(posedge clock);
+        if( time_seconds != 48'h0001_0000_0005 || time_nanoseconds < 32'd999999000 || time_nanoseconds > 32'd999999200 ) $error("time is not set %012x.%09d", time_seconds, time_nanoseconds);
+        repeat(30) @(posedge clock);
+        if( time_seconds != 48'h0001_0000_0006 || time_nanoseconds > 32'd400 ) $error("second does not carry %012x.%09d", time_seconds, time_nanoseconds);
+
+        // Snapshot
+        axi_write(7'h00, 32'h0000_0002);
+        t0 = to_nanoseconds(time_seconds, time_nanoseconds);
+        axi_read(7'h08, value); seconds[47:32] = value[15:0];
+        axi_read(7'h0c, value); seconds[31:0] = value;
+        axi_read(7'h10, nanoseconds);
+        t1 = to_nanoseconds(seconds, nanoseconds);
+        if( t1 - t0 > 80 || t0 - t1 > 80 ) $error("snapshot %012x.%09d is not the time at the request", seconds, nanoseconds);
+
+        // Step backward across the second boundary.
+        t0 = to_nanoseconds(time_seconds, time_nanoseconds);
+        axi_write(7'h18, -32'sd500000000);
+        axi_write(7'h00, 32'h0000_0004);
+        t1 = to_nanoseconds(time_seconds, time_nanoseconds);
+        if( t0 - t1 < 500000000 - 1000 || t0 - t1 > 500000000 ) $error("time is not adjusted by -500[ms] (%0d[ns])", t1 - t0);
+
+        // Slow down the time base.
+        axi_write(7'h14, 32'h27ff_0000);
+        t0 = to_nanoseconds(time_seconds, time_nanoseconds);
+        repeat(256) @(posedge clock);
+        t1 = to_nanoseconds(time_seconds, time_nanoseconds);
+        if( t1 - t0 != 256*40 - 1 ) $error("time advanced %0d[ns] in 256 clocks with the slow increment", t1 - t0);
+
+        // PPS capture
+        axi_write(7'h04, 32'h0000_0001);
+        if( !time_locked ) $error("locked is not set");
+        @(posedge clock);
+        pps <= 1;
+        t0 = to_nanoseconds(time_seconds, time_nanoseconds);
+        repeat(10) @(posedge clock);
+        pps <= 0;
+        axi_read(7'h04, value);
+        if( value != 32'h0000_0003 ) $error("unexpected status %08x", value);
+        axi_read(7'h1c, value); seconds[47:32] = value[15:0];
+        axi_read(7'h20, value); seconds[31:0] = value;
+        axi_read(7'h24, nanoseconds);
+        t1 = to_nanoseconds(seconds, nanoseconds);
+        if( t1 - t0 < 0 || t1 - t0 > 200 ) $error("PPS captured %0d[ns] after the edge", t1 - t0);
+        axi_write(7'h04, 32'h0000_0003);
+        axi_read(7'h04, value);
+        if( value != 32'h0000_0001 ) $error("PPS captured flag is not cleared %08x", value);
+
+        // One-step control
+        axi_write(7'h28, 32'h0000_0001);
+        if( !ptp_one_step ) $error("one-step is not enabled");
+        axi_write(7'h28, 32'h0000_0000);
+        if( ptp_one_step ) $error("one-step is not disabled");
+
+        // PTP event queues
+        axi_read(7'h2c, value);
+        if( value != 0 ) $error("event queues are not empty %08x", value);
+        for(int i = 0; i < 2; i++) begin
+            rx_event_saxis_tdata <= {32'h0000_1000 + i, 32'h0000_0100 + i, 32'h0000_0010 + i, 32'h0000_0001 + i};
+            rx_event_saxis_tvalid <= 1;
+            @(posedge clock);
+        end
+        rx_event_saxis_tvalid <= 0;
+        tx_event_saxis_tdata <= {32'h0000_2000, 32'h0000_0200, 32'h0000_0020, 32'h0000_0002};
+        tx_event_saxis_tvalid <= 1;
+        @(posedge clock);
+        tx_event_saxis_tvalid <= 0;
+        axi_read(7'h2c, value);
+        if( value != 32'h0000_0003 ) $error("unexpected event status %08x", value);
+        for(int i = 0; i < 2; i++) begin
+            for(int word = 0; word < 4; word++) begin
+                axi_read(7'h30 + 4*word, value);
+                if( value != (32'h0000_0001 << 4*word) + i ) $error("RX event #%0d word %0d mismatch %08x", i, word, value);
+            end
+            axi_write(7'h2c, 32'h0000_0001);
+        end
+        axi_read(7'h2c, value);
+        if( value != 32'h0000_0002 ) $error("RX event queue is not empty %08x", value);
+        for(int word = 0; word < 4; word++) begin
+            axi_read(7'h40 + 4*word, value);
+            if( value != (32'h0000_0002 << 4*word) ) $error("TX event word %0d mismatch %08x", word, value);
+        end
+        axi_write(7'h2c, 32'h0000_0002);
+
+        // Overflow
+        for(int i = 0; i < 17; i++) begin
+            tx_event_saxis_tdata <= i;
+            tx_event_saxis_tvalid <= 1;
+            @(posedge clock);
+        end
+        tx_event_saxis_tvalid <= 0;
+        axi_read(7'h2c, value);
+        if( value != 32'h0000_000a ) $error("TX event overflow is not detected %08x", value);
+        axi_write(7'h2c, 32'h0000_0008);
+        for(int i = 0; i < 16; i++) begin
+            axi_read(7'h40, value);
+            if( value != i ) $error("TX event #%0d mismatch %08x", i, value);
+            axi_write(7'h2c, 32'h0000_0002);
+        end
+        axi_read(7'h2c, value);
+        if( value != 0 ) $error("event queues are not empty %08x", value);
+
+        $finish;
+    end
+endmodule
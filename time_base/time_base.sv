@@ -0,0 +1,335 @@
+`default_nettype none
+
+// PL time base.
+// Keeps the time in seconds (48bit) and nanoseconds like PTP and advances it by INCREMENT every clock.
+// The discipline loop on the PS steers the rate with INCREMENT and the phase with ADJUST_NANOSECONDS through AXI4-Lite.
+//
+// Registers (32bit access only)
+//   0x00 CONTROL            W   bit0: load SET_SECONDS and SET_NANOSECONDS into the time
+//                               bit1: capture the time into SNAPSHOT_SECONDS and SNAPSHOT_NANOSECONDS
+//                               bit2: add ADJUST_NANOSECONDS to the time
+//   0x04 STATUS             RW  bit0: locked (written by the discipline loop)
+//                               bit1: PPS captured (write 1 to clear)
+//   0x08 SECONDS_HI         W: SET_SECONDS[47:32] R: SNAPSHOT_SECONDS[47:32]
+//   0x0c SECONDS_LO         W: SET_SECONDS[31:0]  R: SNAPSHOT_SECONDS[31:0]
+//   0x10 NANOSECONDS        W: SET_NANOSECONDS    R: SNAPSHOT_NANOSECONDS
+//   0x14 INCREMENT          RW  nanoseconds per clock in 8.24 fixed point
+//   0x18 ADJUST_NANOSECONDS RW  signed nanoseconds within +/-999999999
+//   0x1c PPS_SECONDS_HI     R   time at the last rising edge of pps
+//   0x20 PPS_SECONDS_LO     R
+//   0x24 PPS_NANOSECONDS    R
+//   0x28 PTP_CONTROL        RW  bit0: one-step Sync on the bypass path
+//   0x2c EVENT_STATUS       R   bit0: RX event available, bit1: TX event available,
+//                               bit2: RX event overflow, bit3: TX event overflow
+//                           W   bit0: pop the RX event, bit1: pop the TX event, bit2, bit3: clear the overflow
+//   0x30-0x3c RX_EVENT      R   PTP event record of a received frame at the head of the queue (see tx_ptp_event)
+//   0x40-0x4c TX_EVENT      R   PTP event record of a transmitted frame at the head of the queue
+module time_base #(
+    parameter int CLOCK_HZ = 25000000,
+    parameter int ADDR_BITS = 7,
+    parameter int EVENT_DEPTH_BITS = 4
+) (
+    input wire clock,
+    input wire aresetn,
+
+    input wire pps,
+
+    output logic [47:0] time_seconds,
+    output logic [31:0] time_nanoseconds,
+    output logic        time_locked,
+
+    output logic        ptp_one_step,
+
+    input  wire [127:0] rx_event_saxis_tdata,
+    input  wire         rx_event_saxis_tvalid,
+    output wire         rx_event_saxis_tready,
+    input  wire [127:0] tx_event_saxis_tdata,
+    input  wire         tx_event_saxis_tvalid,
+    output wire         tx_event_saxis_tready,
+
+    input  wire  [ADDR_BITS-1:0] s_axi_awaddr,
+    input  wire                  s_axi_awvalid,
+    output logic                 s_axi_awready,
+    input  wire  [31:0]          s_axi_wdata,
+    input  wire  [3:0]           s_axi_wstrb,
+    input  wire                  s_axi_wvalid,
+    output logic                 s_axi_wready,
+    output logic [1:0]           s_axi_bresp,
+    output logic                 s_axi_bvalid,
+    input  wire                  s_axi_bready,
+    input  wire  [ADDR_BITS-1:0] s_axi_araddr,
+    input  wire                  s_axi_arvalid,
+    output logic                 s_axi_arready,
+    output logic [31:0]          s_axi_rdata,
+    output logic [1:0]           s_axi_rresp,
+    output logic                 s_axi_rvalid,
+    input  wire                  s_axi_rready
+);
+
+localparam int FRACTION_BITS = 24;
+localparam bit [31:0] NANOSECONDS_PER_SECOND = 32'd1000000000;
+localparam bit [31:0] NOMINAL_INCREMENT = (64'd1000000000 << FRACTION_BITS) / CLOCK_HZ;
+
+localparam int REG_CONTROL = 0;
+localparam int REG_STATUS = 1;
+localparam int REG_SECONDS_HI = 2;
+localparam int REG_SECONDS_LO = 3;
+localparam int REG_NANOSECONDS = 4;
+localparam int REG_INCREMENT = 5;
+localparam int REG_ADJUST_NANOSECONDS = 6;
+localparam int REG_PPS_SECONDS_HI = 7;
+localparam int REG_PPS_SECONDS_LO = 8;
+localparam int REG_PPS_NANOSECONDS = 9;
+localparam int REG_PTP_CONTROL = 10;
+localparam int REG_EVENT_STATUS = 11;
+localparam int REG_RX_EVENT = 12;
+localparam int REG_TX_EVENT = 16;
+
+logic [FRACTION_BITS-1:0] time_fraction;
+logic [31:0] increment;
+logic [31:0] adjust_nanoseconds;
+logic [47:0] set_seconds;
+logic [31:0] set_nanoseconds;
+logic [47:0] snapshot_seconds;
+logic [31:0] snapshot_nanoseconds;
+logic [47:0] pps_seconds;
+logic [31:0] pps_nanoseconds;
+logic        pps_captured;
+
+logic set_request;
+logic snapshot_request;
+logic adjust_request;
+
+logic [127:0] rx_event;
+logic         rx_event_valid;
+logic         rx_event_pop;
+logic         rx_event_overflow;
+logic [127:0] tx_event;
+logic         tx_event_valid;
+logic         tx_event_pop;
+logic         tx_event_overflow;
+
+// AXI4-Lite write
+logic write_enable;
+logic [ADDR_BITS-3:0] write_index;
+assign write_enable = s_axi_awvalid && s_axi_wvalid && !s_axi_bvalid;
+assign write_index = s_axi_awaddr[ADDR_BITS-1:2];
+assign s_axi_awready = write_enable;
+assign s_axi_wready = write_enable;
+assign s_axi_bresp = 2'b00;
+assign rx_event_pop = write_enable && write_index == REG_EVENT_STATUS && s_axi_wdata[0];
+assign tx_event_pop = write_enable && write_index == REG_EVENT_STATUS && s_axi_wdata[1];
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        s_axi_bvalid <= 0;
+        increment <= NOMINAL_INCREMENT;
+        adjust_nanoseconds <= 0;
+        set_seconds <= 0;
+        set_nanoseconds <= 0;
+        set_request <= 0;
+        snapshot_request <= 0;
+        adjust_request <= 0;
+        time_locked <= 0;
+        ptp_one_step <= 0;
+    end
+    else begin
+        set_request <= 0;
+        snapshot_request <= 0;
+        adjust_request <= 0;
+        if( s_axi_bvalid && s_axi_bready ) begin
+            s_axi_bvalid <= 0;
+        end
+        if( write_enable ) begin
+            s_axi_bvalid <= 1;
+            case(write_index)
+            REG_CONTROL: begin
+                set_request <= s_axi_wdata[0];
+                snapshot_request <= s_axi_wdata[1];
+                adjust_request <= s_axi_wdata[2];
+            end
+            REG_STATUS: time_locked <= s_axi_wdata[0];
+            REG_SECONDS_HI: set_seconds[47:32] <= s_axi_wdata[15:0];
+            REG_SECONDS_LO: set_seconds[31:0] <= s_axi_wdata;
+            REG_NANOSECONDS: set_nanoseconds <= s_axi_wdata;
+            REG_INCREMENT: increment <= s_axi_wdata;
+            REG_ADJUST_NANOSECONDS: adjust_nanoseconds <= s_axi_wdata;
+            REG_PTP_CONTROL: ptp_one_step <= s_axi_wdata[0];
+            default: ;
+            endcase
+        end
+    end
+end
+
+// AXI4-Lite read
+logic [ADDR_BITS-3:0] read_index;
+assign read_index = s_axi_araddr[ADDR_BITS-1:2];
+assign s_axi_arready = !s_axi_rvalid;
+assign s_axi_rresp = 2'b00;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        s_axi_rvalid <= 0;
+        s_axi_rdata <= 0;
+    end
+    else begin
+        if( s_axi_rvalid && s_axi_rready ) begin
+            s_axi_rvalid <= 0;
+        end
+        if( s_axi_arvalid && s_axi_arready ) begin
+            s_axi_rvalid <= 1;
+            case(read_index)
+            REG_STATUS: s_axi_rdata <= {30'b0, pps_captured, time_locked};
+            REG_SECONDS_HI: s_axi_rdata <= {16'b0, snapshot_seconds[47:32]};
+            REG_SECONDS_LO: s_axi_rdata <= snapshot_seconds[31:0];
+            REG_NANOSECONDS: s_axi_rdata <= snapshot_nanoseconds;
+            REG_INCREMENT: s_axi_rdata <= increment;
+            REG_ADJUST_NANOSECONDS: s_axi_rdata <= adjust_nanoseconds;
+            REG_PPS_SECONDS_HI: s_axi_rdata <= {16'b0, pps_seconds[47:32]};
+            REG_PPS_SECONDS_LO: s_axi_rdata <= pps_seconds[31:0];
+            REG_PPS_NANOSECONDS: s_axi_rdata <= pps_nanoseconds;
+            REG_PTP_CONTROL: s_axi_rdata <= {31'b0, ptp_one_step};
+            REG_EVENT_STATUS: s_axi_rdata <= {28'b0, tx_event_overflow, rx_event_overflow, tx_event_valid, rx_event_valid};
+            REG_RX_EVENT + 0: s_axi_rdata <= rx_event[31:0];
+            REG_RX_EVENT + 1: s_axi_rdata <= rx_event[63:32];
+            REG_RX_EVENT + 2: s_axi_rdata <= rx_event[95:64];
+            REG_RX_EVENT + 3: s_axi_rdata <= rx_event[127:96];
+            REG_TX_EVENT + 0: s_axi_rdata <= tx_event[31:0];
+            REG_TX_EVENT + 1: s_axi_rdata <= tx_event[63:32];
+            REG_TX_EVENT + 2: s_axi_rdata <= tx_event[95:64];
+            REG_TX_EVENT + 3: s_axi_rdata <= tx_event[127:96];
+            default: s_axi_rdata <= 0;
+            endcase
+        end
+    end
+end
+
+// Time counter
+logic [31:0] advanced_nanoseconds;
+logic [FRACTION_BITS-1:0] advanced_fraction;
+logic signed [33:0] next_nanoseconds;
+logic [47:0] next_seconds;
+
+always_comb begin
+    {advanced_nanoseconds, advanced_fraction} = {time_nanoseconds, time_fraction} + increment;
+    next_nanoseconds = $signed({2'b00, advanced_nanoseconds}) + (adjust_request ? $signed({{2{adjust_nanoseconds[31]}}, adjust_nanoseconds}) : 34'sd0);
+    next_seconds = time_seconds;
+    if( next_nanoseconds >= $signed({2'b00, NANOSECONDS_PER_SECOND}) ) begin
+        next_nanoseconds = next_nanoseconds - $signed({2'b00, NANOSECONDS_PER_SECOND});
+        next_seconds = time_seconds + 1;
+    end
+    else if( next_nanoseconds < 0 ) begin
+        next_nanoseconds = next_nanoseconds + $signed({2'b00, NANOSECONDS_PER_SECOND});
+        next_seconds = time_seconds - 1;
+    end
+end
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        time_seconds <= 0;
+        time_nanoseconds <= 0;
+        time_fraction <= 0;
+    end
+    else if( set_request ) begin
+        time_seconds <= set_seconds;
+        time_nanoseconds <= set_nanoseconds;
+        time_fraction <= 0;
+    end
+    else begin
+        time_seconds <= next_seconds;
+        time_nanoseconds <= next_nanoseconds[31:0];
+        time_fraction <= advanced_fraction;
+    end
+end
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        snapshot_seconds <= 0;
+        snapshot_nanoseconds <= 0;
+    end
+    else if( snapshot_request ) begin
+        snapshot_seconds <= time_seconds;
+        snapshot_nanoseconds <= time_nanoseconds;
+    end
+end
+
+// PPS capture
+(* ASYNC_REG = "TRUE" *) logic [1:0] pps_sync;
+logic pps_prev;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        pps_sync <= 0;
+        pps_prev <= 0;
+        pps_seconds <= 0;
+        pps_nanoseconds <= 0;
+        pps_captured <= 0;
+    end
+    else begin
+        pps_sync <= {pps_sync[0], pps};
+        pps_prev <= pps_sync[1];
+        if( pps_sync[1] && !pps_prev ) begin
+            pps_seconds <= time_seconds;
+            pps_nanoseconds <= time_nanoseconds;
+            pps_captured <= 1;
+        end
+        else if( write_enable && write_index == REG_STATUS && s_axi_wdata[1] ) begin
+            pps_captured <= 0;
+        end
+    end
+end
+
+// PTP event queues
+// The records are always accepted. They are dropped and the overflow flag is set while the queue is full.
+logic rx_event_fifo_tready;
+logic tx_event_fifo_tready;
+
+simple_fifo #(.DATA_BITS(128), .DEPTH_BITS(EVENT_DEPTH_BITS)) rx_event_fifo_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .saxis_tdata (rx_event_saxis_tdata),
+    .saxis_tvalid(rx_event_saxis_tvalid),
+    .saxis_tready(rx_event_fifo_tready),
+    .maxis_tdata (rx_event),
+    .maxis_tvalid(rx_event_valid),
+    .maxis_tready(rx_event_pop)
+);
+
+simple_fifo #(.DATA_BITS(128), .DEPTH_BITS(EVENT_DEPTH_BITS)) tx_event_fifo_inst (
+    .clock(clock),
+    .aresetn(aresetn),
+    .saxis_tdata (tx_event_saxis_tdata),
+    .saxis_tvalid(tx_event_saxis_tvalid),
+    .saxis_tready(tx_event_fifo_tready),
+    .maxis_tdata (tx_event),
+    .maxis_tvalid(tx_event_valid),
+    .maxis_tready(tx_event_pop)
+);
+
+assign rx_event_saxis_tready = 1;
+assign tx_event_saxis_tready = 1;
+
+always_ff @(posedge clock) begin
+    if( !aresetn ) begin
+        rx_event_overflow <= 0;
+        tx_event_overflow <= 0;
+    end
+    else begin
+        if( rx_event_saxis_tvalid && !rx_event_fifo_tready ) begin
+            rx_event_overflow <= 1;
+        end
+        else if( write_enable && write_index == REG_EVENT_STATUS && s_axi_wdata[2] ) begin
+            rx_event_overflow <= 0;
+        end
+        if( tx_event_saxis_tvalid && !tx_event_fifo_tready ) begin
+            tx_event_overflow <= 1;
+        end
+        else if( write_enable && write_index == REG_EVENT_STATUS && s_axi_wdata[3] ) begin
+            tx_event_overflow <= 0;
+        end
+    end
+end
+
+endmodule
+
+`default_nettype wire
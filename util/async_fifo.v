@@ -0,0 +1,161 @@
+`default_nettype none
+
+// simple_fifo across two clock domains.
+// The write and read pointers are passed to the other domain in gray code through SYNC_STAGES flip-flops.
+// The output is first-word-fall-through. A word written at a s_clock edge appears on maxis_tvalid
+// SYNC_STAGES m_clock edges later with RAM_STYLE "distributed", and one more m_clock edge later with "block",
+// whose synchronous read is used as the output register.
+// Both resets must be asserted together for a few clocks of the slower domain.
+module async_fifo #(
+    parameter DATA_BITS = 8,
+    parameter DEPTH_BITS = 4,
+    parameter SYNC_STAGES = 2,                  // Flip-flops of the pointer synchronizers (2 or more)
+    parameter RAM_STYLE = "distributed",        // "distributed" for small depths, "block" for large ones
+    parameter ALMOST_FULL_LEVEL = 2**DEPTH_BITS - 1
+) (
+    input wire s_clock,
+    input wire s_aresetn,
+
+    input  wire [DATA_BITS-1:0] saxis_tdata,
+    input  wire                 saxis_tvalid,
+    output wire                 saxis_tready,
+
+    output wire [DEPTH_BITS:0]  s_level,        // Words in the FIFO seen from s_clock. Reads appear SYNC_STAGES s_clocks later.
+    output wire                 almost_full,    // s_level >= ALMOST_FULL_LEVEL
+
+    input wire m_clock,
+    input wire m_aresetn,
+
+    output wire [DATA_BITS-1:0] maxis_tdata,
+    output wire                 maxis_tvalid,
+    input  wire                 maxis_tready
+);
+
+function [DEPTH_BITS:0] gray_to_binary(input [DEPTH_BITS:0] gray);
+    integer i;
+    begin
+        gray_to_binary[DEPTH_BITS] = gray[DEPTH_BITS];
+        for(i = DEPTH_BITS - 1; i >= 0; i = i - 1) begin
+            gray_to_binary[i] = gray_to_binary[i + 1] ^ gray[i];
+        end
+    end
+endfunction
+
+integer stage;
+
+reg [DEPTH_BITS:0] index_w;
+reg [DEPTH_BITS:0] index_w_gray;
+reg [DEPTH_BITS:0] index_r;
+reg [DEPTH_BITS:0] index_r_gray;
+
+// s_clock domain
+(* ASYNC_REG = "TRUE" *) reg [DEPTH_BITS:0] index_r_gray_sync[SYNC_STAGES-1:0];
+
+wire [DEPTH_BITS:0] index_r_synced = gray_to_binary(index_r_gray_sync[SYNC_STAGES-1]);
+wire [DEPTH_BITS:0] index_w_next = index_w + 1;
+
+assign s_level = index_w - index_r_synced;
+assign almost_full = s_level >= ALMOST_FULL_LEVEL;
+assign saxis_tready = !s_level[DEPTH_BITS];
+
+wire write_enable = saxis_tvalid && saxis_tready;
+
+always @(posedge s_clock) begin
+    if( !s_aresetn ) begin
+        index_w <= 0;
+        index_w_gray <= 0;
+        for(stage = 0; stage < SYNC_STAGES; stage = stage + 1) begin
+            index_r_gray_sync[stage] <= 0;
+        end
+    end
+    else begin
+        if( write_enable ) begin
+            index_w <= index_w_next;
+            index_w_gray <= index_w_next ^ (index_w_next >> 1);
+        end
+        index_r_gray_sync[0] <= index_r_gray;
+        for(stage = 1; stage < SYNC_STAGES; stage = stage + 1) begin
+            index_r_gray_sync[stage] <= index_r_gray_sync[stage - 1];
+        end
+    end
+end
+
+// m_clock domain
+(* ASYNC_REG = "TRUE" *) reg [DEPTH_BITS:0] index_w_gray_sync[SYNC_STAGES-1:0];
+
+wire [DEPTH_BITS:0] index_w_synced = gray_to_binary(index_w_gray_sync[SYNC_STAGES-1]);
+wire [DEPTH_BITS:0] index_r_next = index_r + 1;
+wire memory_empty = index_r == index_w_synced;
+wire read_enable;   // Reads a word from the memory.
+
+always @(posedge m_clock) begin
+    if( !m_aresetn ) begin
+        index_r <= 0;
+        index_r_gray <= 0;
+        for(stage = 0; stage < SYNC_STAGES; stage = stage + 1) begin
+            index_w_gray_sync[stage] <= 0;
+        end
+    end
+    else begin
+        if( read_enable ) begin
+            index_r <= index_r_next;
+            index_r_gray <= index_r_next ^ (index_r_next >> 1);
+        end
+        index_w_gray_sync[0] <= index_w_gray;
+        for(stage = 1; stage < SYNC_STAGES; stage = stage + 1) begin
+            index_w_gray_sync[stage] <= index_w_gray_sync[stage - 1];
+        end
+    end
+end
+
+generate
+if( RAM_STYLE == "block" ) begin: block_ram_block
+    (* ram_style = "block" *) reg [DATA_BITS-1:0] memory[2**DEPTH_BITS-1:0];
+    reg [DATA_BITS-1:0] output_tdata;
+    reg                 output_tvalid;
+
+    // The word is read into the output register when it is empty or being read out.
+    assign read_enable = !memory_empty && (!output_tvalid || maxis_tready);
+    assign maxis_tdata = output_tdata;
+    assign maxis_tvalid = output_tvalid;
+
+    always @(posedge s_clock) begin
+        if( write_enable ) begin
+            memory[index_w[DEPTH_BITS-1:0]] <= saxis_tdata;
+        end
+    end
+    always @(posedge m_clock) begin
+        if( !m_aresetn ) begin
+            output_tvalid <= 0;
+        end
+        else begin
+            if( read_enable ) begin
+                output_tvalid <= 1;
+            end
+            else if( maxis_tready ) begin
+                output_tvalid <= 0;
+            end
+        end
+        if( read_enable ) begin
+            output_tdata <= memory[index_r[DEPTH_BITS-1:0]];
+        end
+    end
+end
+else begin: distributed_ram_block
+    (* ram_style = "distributed" *) reg [DATA_BITS-1:0] memory[2**DEPTH_BITS-1:0];
+
+    assign read_enable = maxis_tvalid && maxis_tready;
+    assign maxis_tdata = memory[index_r[DEPTH_BITS-1:0]];
+    assign maxis_tvalid = !memory_empty;
+
+    always @(posedge s_clock) begin
+        if( write_enable ) begin
+            memory[index_w[DEPTH_BITS-1:0]] <= saxis_tdata;
+        end
+    end
+end
+endgenerate
+
+endmodule
+
+`default_nettype wire
@@ -0,0 +1,82 @@
+`default_nettype none
+
+// simple_fifo with packet boundaries.
+// A packet is committed when its tlast is written. A packet whose tlast comes with tuser is rolled back,
+// unless the output of it is already started, in which case it is output with tuser at tlast.
+// With PACKET_MODE, a packet is output only after it is committed, so the packets with tuser never appear on the output.
+// Packets must fit in the FIFO in PACKET_MODE.
+module packet_fifo #(
+    parameter DATA_BITS = 8,
+    parameter DEPTH_BITS = 3,
+    parameter PACKET_MODE = 0,
+    parameter ALMOST_FULL_LEVEL = 2**DEPTH_BITS - 1,
+    parameter ALMOST_EMPTY_LEVEL = 1
+) (
+    input wire clock,
+    input wire aresetn,
+
+    input  wire [DATA_BITS-1:0] saxis_tdata,
+    input  wire                 saxis_tvalid,
+    output wire                 saxis_tready,
+    input  wire                 saxis_tuser,
+    input  wire                 saxis_tlast,
+
+    output wire [DATA_BITS-1:0] maxis_tdata,
+    output wire                 maxis_tvalid,
+    input  wire                 maxis_tready,
+    output wire                 maxis_tuser,
+    output wire                 maxis_tlast,
+
+    output wire [DEPTH_BITS:0]  level,          // Words in the FIFO including the packet being written
+    output reg  [DEPTH_BITS:0]  packet_count,   // Committed packets not read out
+    output wire                 almost_full,    // level >= ALMOST_FULL_LEVEL
+    output wire                 almost_empty    // level <= ALMOST_EMPTY_LEVEL
+);
+
+reg [DEPTH_BITS:0] index_r;
+reg [DEPTH_BITS:0] index_w;
+reg [DEPTH_BITS:0] index_c;     // End of the committed packets
+
+reg [DATA_BITS+1:0] memory[2**DEPTH_BITS-1:0];
+
+assign level = index_w - index_r;
+assign almost_full = level >= ALMOST_FULL_LEVEL;
+assign almost_empty = level <= ALMOST_EMPTY_LEVEL;
+
+assign saxis_tready = !level[DEPTH_BITS];
+assign maxis_tvalid = PACKET_MODE ? index_r != index_c : index_r != index_w;
+assign {maxis_tuser, maxis_tlast, maxis_tdata} = memory[index_r[DEPTH_BITS-1:0]];
+
+wire input_accepted = saxis_tvalid && saxis_tready;
+wire output_accepted = maxis_tvalid && maxis_tready;
+
+// Whether the output of the packet being written is started, including the read in this cycle.
+wire [DEPTH_BITS:0] read_offset = index_r - index_c;
+wire [DEPTH_BITS:0] packet_level = index_w - index_c;
+wire output_started = read_offset != 0 && read_offset <= packet_level || output_accepted && index_r == index_c;
+
+wire rollback = input_accepted && saxis_tlast && saxis_tuser && !output_started;
+wire commit = input_accepted && saxis_tlast && !rollback;
+wire write_enable = input_accepted && !rollback;
+
+always @(posedge clock) begin
+    if( !aresetn ) begin
+        index_r <= 0;
+        index_w <= 0;
+        index_c <= 0;
+        packet_count <= 0;
+    end
+    else begin
+        index_w <= rollback ? index_c : write_enable ? index_w + 1 : index_w;
+        index_c <= commit ? index_w + 1 : index_c;
+        index_r <= output_accepted ? index_r + 1 : index_r;
+        packet_count <= packet_count + commit - (output_accepted && maxis_tlast);
+        if( write_enable ) begin
+            memory[index_w[DEPTH_BITS-1:0]] <= {saxis_tuser, saxis_tlast, saxis_tdata};
+        end
+    end
+end
+
+endmodule
+
+`default_nettype wire
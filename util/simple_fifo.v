@@ -1,16 +1,24 @@
 `default_nettype none
 
+// OPTIMIZE selects the implementation.
+//   "area":  maxis_tdata is read combinationally from the distributed RAM. A word written appears on the output at the next clock.
+//   "speed": The memory is read into a register and the output goes through a skid buffer, so that neither maxis_tdata nor
+//            the read enable of the memory depend on maxis_tready combinationally, and saxis_tready is a register.
+//            A word written appears on the output 2 clocks later, and a word is transferred every clock.
+//            RAM_STYLE "block" infers block RAM for large depths. The FIFO holds 2 more words in the output stage.
 module simple_fifo #(
     parameter DATA_BITS = 8,
-    parameter DEPTH_BITS = 3
+    parameter DEPTH_BITS = 3,
+    parameter OPTIMIZE = "area",                // "area" or "speed"
+    parameter RAM_STYLE = "distributed"         // "distributed" or "block". "block" requires OPTIMIZE "speed".
 ) (
     input wire clock,
     input wire aresetn,
-    
+
     input  wire [DATA_BITS-1:0] saxis_tdata,
     input  wire                 saxis_tvalid,
     output wire                 saxis_tready,
-    
+
     output wire [DATA_BITS-1:0] maxis_tdata,
     output wire                 maxis_tvalid,
     input  wire                 maxis_tready
@@ -19,25 +27,98 @@ module simple_fifo #(
 reg [DEPTH_BITS:0] index_r;
 reg [DEPTH_BITS:0] index_w;
 
-reg [DATA_BITS-1:0] memory[2**DEPTH_BITS-1:0];
+generate
+if( OPTIMIZE == "speed" ) begin: speed_block
+    reg                 not_full;
+    reg [DATA_BITS-1:0] read_tdata;     // Output of the memory
+    reg                 read_tvalid;
+    reg [DATA_BITS-1:0] output_tdata;
+    reg                 output_tvalid;
+    reg [DATA_BITS-1:0] skid_tdata;     // Holds the word read while the output is stalled.
+    reg                 skid_tvalid;
 
-assign saxis_tready = index_r[DEPTH_BITS] == index_w[DEPTH_BITS] || index_r[DEPTH_BITS-1:0] != index_w[DEPTH_BITS-1:0];
-assign maxis_tvalid = index_r != index_w;
-assign maxis_tdata  = memory[index_r[DEPTH_BITS-1:0]];
+    wire write_enable = saxis_tvalid && not_full;
+    wire read_ready = !skid_tvalid;
+    wire read_enable = index_r != index_w && (!read_tvalid || read_ready);
+    wire [DEPTH_BITS:0] level_next = index_w + write_enable - index_r - read_enable;
 
-always @(posedge clock) begin
-    if( !aresetn ) begin
-        index_r <= 0;
-        index_w <= 0;
+    assign saxis_tready = not_full;
+    assign maxis_tdata = output_tdata;
+    assign maxis_tvalid = output_tvalid;
+
+    if( RAM_STYLE == "block" ) begin: block_ram_block
+        (* ram_style = "block" *) reg [DATA_BITS-1:0] memory[2**DEPTH_BITS-1:0];
+        always @(posedge clock) begin
+            if( write_enable ) begin
+                memory[index_w[DEPTH_BITS-1:0]] <= saxis_tdata;
+            end
+            if( read_enable ) begin
+                read_tdata <= memory[index_r[DEPTH_BITS-1:0]];
+            end
+        end
     end
-    else begin
-        index_w <= saxis_tvalid && saxis_tready ? index_w + 1 : index_w;
-        index_r <= maxis_tvalid && maxis_tready ? index_r + 1 : index_r;
-        if( saxis_tvalid && saxis_tready ) begin
-            memory[index_w[DEPTH_BITS-1:0]] <= saxis_tdata;
+    else begin: distributed_ram_block
+        (* ram_style = "distributed" *) reg [DATA_BITS-1:0] memory[2**DEPTH_BITS-1:0];
+        always @(posedge clock) begin
+            if( write_enable ) begin
+                memory[index_w[DEPTH_BITS-1:0]] <= saxis_tdata;
+            end
+            if( read_enable ) begin
+                read_tdata <= memory[index_r[DEPTH_BITS-1:0]];
+            end
+        end
+    end
+
+    always @(posedge clock) begin
+        if( !aresetn ) begin
+            index_r <= 0;
+            index_w <= 0;
+            not_full <= 0;
+            read_tvalid <= 0;
+            output_tvalid <= 0;
+            skid_tvalid <= 0;
+        end
+        else begin
+            index_w <= write_enable ? index_w + 1 : index_w;
+            index_r <= read_enable ? index_r + 1 : index_r;
+            not_full <= !level_next[DEPTH_BITS];
+            read_tvalid <= read_enable || read_tvalid && !read_ready;
+
+            if( !output_tvalid || maxis_tready ) begin
+                // The output is free. The skid buffer goes first.
+                output_tvalid <= skid_tvalid || read_tvalid;
+                output_tdata <= skid_tvalid ? skid_tdata : read_tdata;
+                skid_tvalid <= 0;
+            end
+            else if( read_tvalid && read_ready ) begin
+                skid_tvalid <= 1;
+                skid_tdata <= read_tdata;
+            end
+        end
+    end
+end
+else begin: area_block
+    reg [DATA_BITS-1:0] memory[2**DEPTH_BITS-1:0];
+
+    assign saxis_tready = index_r[DEPTH_BITS] == index_w[DEPTH_BITS] || index_r[DEPTH_BITS-1:0] != index_w[DEPTH_BITS-1:0];
+    assign maxis_tvalid = index_r != index_w;
+    assign maxis_tdata  = memory[index_r[DEPTH_BITS-1:0]];
+
+    always @(posedge clock) begin
+        if( !aresetn ) begin
+            index_r <= 0;
+            index_w <= 0;
+        end
+        else begin
+            index_w <= saxis_tvalid && saxis_tready ? index_w + 1 : index_w;
+            index_r <= maxis_tvalid && maxis_tready ? index_r + 1 : index_r;
+            if( saxis_tvalid && saxis_tready ) begin
+                memory[index_w[DEPTH_BITS-1:0]] <= saxis_tdata;
+            end
         end
     end
 end
+endgenerate
 
 endmodule
 
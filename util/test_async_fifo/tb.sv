@@ -0,0 +1,156 @@
+`timescale 1ns/1ps
+
+// Transfers random words through async_fifo and measures the latency from the s_clock edge
+// which writes a word into the empty FIFO to the first m_clock edge at which the word can be read.
+module async_fifo_bench #(
+    parameter string NAME = "",
+    parameter int    SYNC_STAGES = 2,
+    parameter string RAM_STYLE = "distributed",
+    parameter real   S_PERIOD = 40.0,
+    parameter real   M_PERIOD = 10.0
+) (
+    output bit done
+);
+    localparam int DEPTH_BITS = 4;
+    localparam int NUMBER_OF_MEASUREMENTS = 200;
+    localparam int NUMBER_OF_INPUTS = 2000;
+
+    logic s_clock = 0;
+    logic m_clock = 0;
+    logic aresetn = 0;
+
+    logic [31:0] saxis_tdata = 0;
+    logic        saxis_tvalid = 0;
+    logic        saxis_tready;
+    logic [DEPTH_BITS:0] s_level;
+    logic [31:0] maxis_tdata;
+    logic        maxis_tvalid;
+    logic        maxis_tready = 0;
+
+    async_fifo #(
+        .DATA_BITS(32),
+        .DEPTH_BITS(DEPTH_BITS),
+        .SYNC_STAGES(SYNC_STAGES),
+        .RAM_STYLE(RAM_STYLE)
+    ) dut (
+        .s_clock(s_clock),
+        .s_aresetn(aresetn),
+        .saxis_tdata(saxis_tdata),
+        .saxis_tvalid(saxis_tvalid),
+        .saxis_tready(saxis_tready),
+        .s_level(s_level),
+        .almost_full(),
+        .m_clock(m_clock),
+        .m_aresetn(aresetn),
+        .maxis_tdata(maxis_tdata),
+        .maxis_tvalid(maxis_tvalid),
+        .maxis_tready(maxis_tready)
+    );
+
+    // The m_clock starts at an odd phase so that the edges of the clocks rarely coincide.
+    initial forever #(S_PERIOD / 2) s_clock = ~s_clock;
+    initial begin
+        #(M_PERIOD / 3);
+        forever #(M_PERIOD / 2) m_clock = ~m_clock;
+    end
+
+    // Bound of the latency. The pointer is sampled at the first m_clock edge after the write,
+    // maxis_tvalid is asserted after SYNC_STAGES flip-flops and the word is read at the next edge.
+    // The block RAM adds the output register.
+    localparam real MAX_LATENCY = (SYNC_STAGES + 1 + (RAM_STYLE == "block" ? 1 : 0)) * M_PERIOD;
+
+    realtime written_at;
+    realtime latency_min;
+    realtime latency_max;
+    realtime latency_sum;
+
+    bit [31:0] expected[$];
+
+    initial begin
+        repeat(8) @(posedge s_clock);
+        repeat(8) @(posedge m_clock);
+        aresetn <= 1;
+        repeat(4) @(posedge s_clock);
+
+        // Latency of a word into the empty FIFO, at random phases between the clocks.
+        latency_min = 1.0e9;
+        latency_max = 0;
+        latency_sum = 0;
+        for(int i = 0; i < NUMBER_OF_MEASUREMENTS; i++) begin
+            realtime latency;
+            repeat($urandom_range(0, 3)) @(posedge s_clock);
+            #($urandom_range(0, 99) * M_PERIOD / 100);
+            @(posedge s_clock);
+            saxis_tdata <= i;
+            saxis_tvalid <= 1;
+            @(posedge s_clock);
+            written_at = $realtime;
+            saxis_tvalid <= 0;
+            do @(posedge m_clock); while(!maxis_tvalid);
+            latency = $realtime - written_at;
+            if( maxis_tdata != i ) $error("%s: tdata mismatch, expected: %0d, actual: %0d", NAME, i, maxis_tdata);
+            if( latency > MAX_LATENCY ) $error("%s: latency %0.1fns exceeds %0.1fns", NAME, latency, MAX_LATENCY);
+            if( latency < latency_min ) latency_min = latency;
+            if( latency > latency_max ) latency_max = latency;
+            latency_sum += latency;
+            maxis_tready <= 1;
+            @(posedge m_clock);
+            maxis_tready <= 0;
+        end
+        $display("%s: latency min %0.1fns, max %0.1fns, average %0.1fns (%0.2f m_clock cycles)", NAME,
+            latency_min, latency_max, latency_sum / NUMBER_OF_MEASUREMENTS, latency_sum / NUMBER_OF_MEASUREMENTS / M_PERIOD);
+
+        // Random words with gaps and back pressure on both sides.
+        fork
+            begin
+                for(int i = 0; i < NUMBER_OF_INPUTS; i++) begin
+                    bit [31:0] tdata;
+                    tdata = $urandom();
+                    expected.push_back(tdata);
+                    saxis_tdata <= tdata;
+                    saxis_tvalid <= 1;
+                    do @(posedge s_clock); while(!saxis_tready);
+                    saxis_tvalid <= 0;
+                    repeat($urandom_range(0, 1)) @(posedge s_clock);
+                end
+            end
+            begin
+                for(int i = 0; i < NUMBER_OF_INPUTS; i++) begin
+                    bit [31:0] tdata;
+                    forever begin
+                        bit tready_value;
+                        tready_value = $urandom_range(0, 3) != 0;
+                        maxis_tready <= tready_value;
+                        @(posedge m_clock);
+                        if( tready_value && maxis_tvalid ) break;
+                    end
+                    tdata = expected.pop_front();
+                    if( maxis_tdata != tdata ) $error("%s: #%0d tdata mismatch, expected: %08x, actual: %08x", NAME, i, tdata, maxis_tdata);
+                    maxis_tready <= 0;
+                end
+            end
+        join
+        repeat(SYNC_STAGES + 2) @(posedge s_clock);
+        if( s_level != 0 ) $error("%s: FIFO is not empty, s_level: %0d", NAME, s_level);
+        if( maxis_tvalid ) $error("%s: maxis_tvalid is asserted on the empty FIFO", NAME);
+        done = 1;
+    end
+endmodule
+
+module tb();
+    bit done_rx;
+    bit done_rx_sync3;
+    bit done_rx_block;
+    bit done_tx;
+
+    // MAC RX clock to the service clock, and the service clock to the MAC TX clock.
+    async_fifo_bench #(.NAME("25MHz to 100MHz, distributed, 2 stages"), .SYNC_STAGES(2), .RAM_STYLE("distributed"), .S_PERIOD(40.0), .M_PERIOD(10.0)) bench_rx (.done(done_rx));
+    async_fifo_bench #(.NAME("25MHz to 100MHz, distributed, 3 stages"), .SYNC_STAGES(3), .RAM_STYLE("distributed"), .S_PERIOD(40.0), .M_PERIOD(10.0)) bench_rx_sync3 (.done(done_rx_sync3));
+    async_fifo_bench #(.NAME("25MHz to 100MHz, block, 2 stages"), .SYNC_STAGES(2), .RAM_STYLE("block"), .S_PERIOD(40.0), .M_PERIOD(10.0)) bench_rx_block (.done(done_rx_block));
+    async_fifo_bench #(.NAME("100MHz to 25MHz, distributed, 2 stages"), .SYNC_STAGES(2), .RAM_STYLE("distributed"), .S_PERIOD(10.0), .M_PERIOD(40.0)) bench_tx (.done(done_tx));
+
+    initial begin
+        wait(done_rx && done_rx_sync3 && done_rx_block && done_tx);
+        $finish;
+    end
+endmodule
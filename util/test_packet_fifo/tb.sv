@@ -0,0 +1,215 @@
+`timescale 1ns/1ps
+
+module tb();
+    logic clock;
+    logic aresetn;
+
+    axis_if #(.DATA_WIDTH(1)) tb_maxis_if(.clock(clock), .aresetn(aresetn));
+    axis_if #(.DATA_WIDTH(1)) tb_saxis_if(.clock(clock), .aresetn(aresetn));
+
+    localparam int DEPTH_BITS = 5;
+    localparam int ALMOST_FULL_LEVEL = 24;
+    localparam int ALMOST_EMPTY_LEVEL = 4;
+
+    logic [DEPTH_BITS:0] level;
+    logic [DEPTH_BITS:0] packet_count;
+    logic                almost_full;
+    logic                almost_empty;
+
+    packet_fifo #(
+        .DATA_BITS(8),
+        .DEPTH_BITS(DEPTH_BITS),
+        .PACKET_MODE(1),
+        .ALMOST_FULL_LEVEL(ALMOST_FULL_LEVEL),
+        .ALMOST_EMPTY_LEVEL(ALMOST_EMPTY_LEVEL)
+    ) dut(
+        .saxis_tdata (tb_maxis_if.tdata ),
+        .saxis_tvalid(tb_maxis_if.tvalid),
+        .saxis_tready(tb_maxis_if.tready),
+        .saxis_tuser (tb_maxis_if.tuser ),
+        .saxis_tlast (tb_maxis_if.tlast ),
+        .maxis_tdata (tb_saxis_if.tdata ),
+        .maxis_tvalid(tb_saxis_if.tvalid),
+        .maxis_tready(tb_saxis_if.tready),
+        .maxis_tuser (tb_saxis_if.tuser ),
+        .maxis_tlast (tb_saxis_if.tlast ),
+        .*
+    );
+
+    // Cut-through FIFO for the directed tests of the rollback.
+    logic [7:0]  ct_in_tdata = 0;
+    logic        ct_in_tvalid = 0;
+    logic        ct_in_tready;
+    logic        ct_in_tuser = 0;
+    logic        ct_in_tlast = 0;
+    logic [7:0]  ct_out_tdata;
+    logic        ct_out_tvalid;
+    logic        ct_out_tready = 0;
+    logic        ct_out_tuser;
+    logic        ct_out_tlast;
+    logic [DEPTH_BITS:0] ct_level;
+    logic [DEPTH_BITS:0] ct_packet_count;
+
+    packet_fifo #(
+        .DATA_BITS(8),
+        .DEPTH_BITS(DEPTH_BITS),
+        .PACKET_MODE(0)
+    ) dut_cut_through (
+        .clock(clock),
+        .aresetn(aresetn),
+        .saxis_tdata (ct_in_tdata ),
+        .saxis_tvalid(ct_in_tvalid),
+        .saxis_tready(ct_in_tready),
+        .saxis_tuser (ct_in_tuser ),
+        .saxis_tlast (ct_in_tlast ),
+        .maxis_tdata (ct_out_tdata ),
+        .maxis_tvalid(ct_out_tvalid),
+        .maxis_tready(ct_out_tready),
+        .maxis_tuser (ct_out_tuser ),
+        .maxis_tlast (ct_out_tlast ),
+        .level(ct_level),
+        .packet_count(ct_packet_count),
+        .almost_full(),
+        .almost_empty()
+    );
+
+    localparam NUMBER_OF_PACKETS = 500;
+    localparam MAX_BYTES = 2**DEPTH_BITS;
+
+    initial begin
+        clock = 0;
+    end
+    always #(5) begin
+        clock = ~clock;
+    end
+
+    typedef bit [7:0] packet_t[$];
+
+    // Packets are output only after they are complete, and the flags follow the level.
+    bit out_in_packet = 0;
+    always @(posedge clock) begin
+        if( aresetn ) begin
+            if( tb_saxis_if.tvalid && !out_in_packet && packet_count == 0 ) $error("incomplete packet is output");
+            if( almost_full != (level >= ALMOST_FULL_LEVEL) ) $error("almost_full mismatch at level %0d", level);
+            if( almost_empty != (level <= ALMOST_EMPTY_LEVEL) ) $error("almost_empty mismatch at level %0d", level);
+            if( tb_saxis_if.tvalid && tb_saxis_if.tready ) out_in_packet = !tb_saxis_if.tlast;
+        end
+    end
+
+    packet_t ct_received[$];
+    bit      ct_received_users[$];
+    packet_t ct_receiving;
+    always @(posedge clock) begin
+        if( ct_out_tvalid && ct_out_tready ) begin
+            ct_receiving.push_back(ct_out_tdata);
+            if( ct_out_tlast ) begin
+                ct_received.push_back(ct_receiving);
+                ct_received_users.push_back(ct_out_tuser);
+                ct_receiving = {};
+            end
+        end
+    end
+
+    task automatic ct_send(input packet_t packet, input bit user);
+        foreach(packet[i]) begin
+            ct_in_tdata <= packet[i];
+            ct_in_tvalid <= 1;
+            ct_in_tuser <= user && i == packet.size() - 1;
+            ct_in_tlast <= i == packet.size() - 1;
+            do @(posedge clock); while(!ct_in_tready);
+        end
+        ct_in_tvalid <= 0;
+        ct_in_tuser <= 0;
+        ct_in_tlast <= 0;
+    endtask
+
+    // Cut-through: a packet with tuser is rolled back if its output is not started.
+    bit ct_done = 0;
+    initial begin
+        packet_t first = {8'h10, 8'h11, 8'h12};
+        packet_t rolled_back = {8'h20, 8'h21, 8'h22, 8'h23};
+        packet_t started = {8'h30, 8'h31, 8'h32, 8'h33};
+
+        @(posedge aresetn);
+        @(posedge clock);
+        ct_send(first, 0);
+        ct_send(rolled_back, 1);
+        @(posedge clock);
+        if( ct_level != 3 || ct_packet_count != 1 ) $error("rolled back packet remains, level: %0d, packet_count: %0d", ct_level, ct_packet_count);
+        ct_out_tready <= 1;
+        wait(ct_received.size() == 1);
+        if( ct_received[0] != first || ct_received_users[0] ) $error("packet before rollback mismatch");
+
+        // The packet is output with tuser if its output is started.
+        ct_send(started, 1);
+        wait(ct_received.size() == 2);
+        if( ct_received[1] != started || !ct_received_users[1] ) $error("started packet is not output with tuser");
+        repeat(4) @(posedge clock);
+        if( ct_level != 0 || ct_packet_count != 0 || ct_receiving.size() != 0 ) $error("cut-through FIFO is not empty");
+        ct_done = 1;
+    end
+
+    module stimuli (
+        input logic clock,
+        output logic aresetn,
+        axis_if.master tb_maxis,
+        axis_if.slave tb_saxis
+    );
+        initial begin
+            packet_t packets[NUMBER_OF_PACKETS];
+            bit      errors[NUMBER_OF_PACKETS];
+            packet_t expected[$];
+
+            for(int i = 0; i < NUMBER_OF_PACKETS; i++) begin
+                int length = $urandom_range(1, MAX_BYTES);
+                for(int j = 0; j < length; j++) packets[i].push_back($urandom());
+                errors[i] = $urandom_range(0, 3) == 0;
+                if( !errors[i] ) expected.push_back(packets[i]);
+            end
+
+            aresetn <= 0;
+            tb_maxis.master_init;
+            tb_saxis.slave_init;
+            repeat(4) @(posedge clock);
+            aresetn <= 1;
+            @(posedge clock);
+
+            // Packets with tuser are dropped and the others are output as they are.
+            fork
+                begin
+                    for(int i = 0; i < NUMBER_OF_PACKETS; i++ ) begin
+                        foreach(packets[i][j]) begin
+                            tb_maxis.master_send(packets[i][j], 1'b1, j == packets[i].size() - 1, errors[i] && j == packets[i].size() - 1);
+                            repeat($urandom_range(0, 1)) @(posedge clock);
+                        end
+                    end
+                end
+                begin
+                    foreach(expected[i]) begin
+                        foreach(expected[i][j]) begin
+                            bit [7:0] tdata;
+                            bit       tkeep;
+                            bit       tlast;
+                            bit       tuser;
+                            tb_saxis.slave_receive(tdata, tkeep, tlast, tuser, 32'h7fffffff);
+                            if( tdata != expected[i][j] ) $error("#%0d[%0d] tdata mismatch, expected: %02x, actual: %02x", i, j, expected[i][j], tdata);
+                            if( tlast != (j == expected[i].size() - 1) ) $error("#%0d[%0d] tlast mismatch", i, j);
+                            if( tuser ) $error("#%0d[%0d] tuser is asserted", i, j);
+                        end
+                    end
+                end
+            join
+            @(posedge clock);
+            if( level != 0 || packet_count != 0 ) $error("FIFO is not empty, level: %0d, packet_count: %0d", level, packet_count);
+
+            wait(ct_done);
+            $finish;
+        end
+    endmodule
+
+    stimuli stimuli_inst (
+        .tb_maxis(tb_maxis_if),
+        .tb_saxis(tb_saxis_if),
+        .*
+    );
+endmodule
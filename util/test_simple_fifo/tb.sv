@@ -3,12 +3,13 @@
 module tb();
     logic clock;
     logic aresetn;
+    logic aresetn_speed;
 
     axis_if #(.DATA_WIDTH(4)) tb_maxis_if(.clock(clock), .aresetn(aresetn));
     axis_if #(.DATA_WIDTH(4)) tb_saxis_if(.clock(clock), .aresetn(aresetn));
+    axis_if #(.DATA_WIDTH(4)) tb_maxis_speed_if(.clock(clock), .aresetn(aresetn_speed));
+    axis_if #(.DATA_WIDTH(4)) tb_saxis_speed_if(.clock(clock), .aresetn(aresetn_speed));
 
-
-    
     simple_fifo #(
         .DATA_BITS(32),
         .DEPTH_BITS(4)
@@ -21,16 +22,33 @@ module tb();
         .maxis_tready(tb_saxis_if.tready),
         .*
     );
-    
+
+    simple_fifo #(
+        .DATA_BITS(32),
+        .DEPTH_BITS(4),
+        .OPTIMIZE("speed"),
+        .RAM_STYLE("block")
+    ) dut_speed(
+        .clock(clock),
+        .aresetn(aresetn_speed),
+        .saxis_tdata (tb_maxis_speed_if.tdata ),
+        .saxis_tvalid(tb_maxis_speed_if.tvalid),
+        .saxis_tready(tb_maxis_speed_if.tready),
+        .maxis_tdata (tb_saxis_speed_if.tdata ),
+        .maxis_tvalid(tb_saxis_speed_if.tvalid),
+        .maxis_tready(tb_saxis_speed_if.tready)
+    );
+
     localparam NUMBER_OF_INPUTS = 1000;
+    localparam NUMBER_OF_BURST_INPUTS = 100;
 
     initial begin
         clock = 0;
-    end 
+    end
     always #(5) begin
         clock = ~clock;
     end
-    
+
     typedef struct {
         logic [31:0] tdata;
     } tv_axis;
@@ -39,10 +57,14 @@ module tb();
         input logic clock,
         output logic aresetn,
         axis_if.master tb_maxis,
-        axis_if.slave tb_saxis
+        axis_if.slave tb_saxis,
+        output bit done
     );
         initial begin
             tv_axis axis_in[NUMBER_OF_INPUTS];
+            longint burst_start;
+            longint burst_end;
+            longint cycles = 0;
 
             for(int i = 0; i < NUMBER_OF_INPUTS; i++) begin
                 axis_in[i].tdata = $urandom();
@@ -55,7 +77,7 @@ module tb();
             repeat(4) @(posedge clock);
             aresetn <= 1;
             @(posedge clock);
-            
+
             fork
                 begin
                     for(int i = 0; i < NUMBER_OF_INPUTS; i++ ) begin
@@ -67,21 +89,64 @@ module tb();
                     for(int i = 0; i < NUMBER_OF_INPUTS; i++ ) begin
                         tv_axis row;
                         bit [63:0] tdata;
-                        
+
                         row = axis_in[i];
                         tb_saxis.slave_receive_data(tdata, 32'h7fffffff);
                         if( row.tdata != tdata ) $error("#%02d tdata mismatch, expected: %08x, actual: %08x", i, row.tdata, tdata);
                     end
                 end
             join
-            
-            $finish;
+
+            // Back-to-back words are transferred every clock.
+            fork
+                forever begin
+                    @(posedge clock);
+                    cycles++;
+                end
+                fork
+                    begin
+                        for(int i = 0; i < NUMBER_OF_BURST_INPUTS; i++ ) begin
+                            tb_maxis.master_send_data(i);
+                        end
+                    end
+                    begin
+                        for(int i = 0; i < NUMBER_OF_BURST_INPUTS; i++ ) begin
+                            bit [63:0] tdata;
+                            tb_saxis.slave_receive_data(tdata, 0);
+                            if( tdata != i ) $error("burst #%02d tdata mismatch, actual: %08x", i, tdata);
+                            if( i == 0 ) burst_start = cycles;
+                            burst_end = cycles;
+                        end
+                    end
+                join
+            join_any
+            disable fork;
+            if( burst_end - burst_start != NUMBER_OF_BURST_INPUTS - 1 ) $error("burst took %0d cycles for %0d words", burst_end - burst_start + 1, NUMBER_OF_BURST_INPUTS);
+
+            done = 1;
         end
     endmodule
 
+    bit done;
+    bit done_speed;
+
     stimuli stimuli_inst (
         .tb_maxis(tb_maxis_if),
         .tb_saxis(tb_saxis_if),
+        .done(done),
         .*
     );
+
+    stimuli stimuli_speed_inst (
+        .clock(clock),
+        .aresetn(aresetn_speed),
+        .tb_maxis(tb_maxis_speed_if),
+        .tb_saxis(tb_saxis_speed_if),
+        .done(done_speed)
+    );
+
+    initial begin
+        wait(done && done_speed);
+        $finish;
+    end
 endmodule
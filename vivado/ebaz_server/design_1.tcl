@@ -125,14 +125,21 @@ if { $bCheckIPs == 1 } {
    set list_check_ips "\ 
 fugafuga.org:Network:ethernet_service:1.0\
 xilinx.com:ip:axis_data_fifo:2.0\
+fugafuga.org:fugafuga.org:axis_async_fifo:1.0\
+xilinx.com:ip:axis_subset_converter:1.1\
+xilinx.com:ip:axis_switch:1.1\
+fugafuga.org:fugafuga.org:frame_dma:1.0\
+fugafuga.org:fugafuga.org:packet_capture:1.0\
 fugafuga.org:fugafuga.org:mii_mac:1.0\
-fugafuga.org:fugafuga.org:mii_to_axis:1.0\
-fugafuga.org:fugafuga.org:prepend_preamble:1.0\
+fugafuga.org:fugafuga.org:time_base:1.0\
+xilinx.com:ip:c_counter_binary:12.0\
 xilinx.com:ip:proc_sys_reset:5.0\
 xilinx.com:ip:processing_system7:5.5\
 xilinx.com:ip:system_ila:1.1\
 xilinx.com:ip:vio:3.0\
+xilinx.com:ip:xlconcat:2.1\
 xilinx.com:ip:xlconstant:1.1\
+xilinx.com:ip:xlslice:1.0\
 "
 
    set list_ips_missing ""
@@ -216,41 +223,139 @@ proc create_root_design { parentCell } {
   # Create instance: ethernet_service_0, and set properties
   set ethernet_service_0 [ create_bd_cell -type ip -vlnv fugafuga.org:Network:ethernet_service:1.0 ethernet_service_0 ]
 
-  # Create instance: fifo_ethernet_ps_tx, and set properties
-  set fifo_ethernet_ps_tx [ create_bd_cell -type ip -vlnv xilinx.com:ip:axis_data_fifo:2.0 fifo_ethernet_ps_tx ]
+  # Create instance: axi_mem_intercon, and set properties
+  set axi_mem_intercon [ create_bd_cell -type ip -vlnv xilinx.com:ip:axi_interconnect:2.1 axi_mem_intercon ]
   set_property -dict [ list \
-   CONFIG.FIFO_DEPTH {2048} \
-   CONFIG.FIFO_MODE {2} \
-   CONFIG.IS_ACLK_ASYNC {0} \
- ] $fifo_ethernet_ps_tx
+   CONFIG.NUM_MI {1} \
+   CONFIG.NUM_SI {2} \
+ ] $axi_mem_intercon
+
+  # Create instance: axis_subset_converter_dma_tx, and set properties
+  set axis_subset_converter_dma_tx [ create_bd_cell -type ip -vlnv xilinx.com:ip:axis_subset_converter:1.1 axis_subset_converter_dma_tx ]
+  set_property -dict [ list \
+   CONFIG.M_HAS_TLAST {1} \
+   CONFIG.M_TDATA_NUM_BYTES {1} \
+   CONFIG.M_TID_WIDTH {4} \
+   CONFIG.S_HAS_TLAST {1} \
+   CONFIG.S_TDATA_NUM_BYTES {1} \
+   CONFIG.TID_REMAP {4'd1} \
+ ] $axis_subset_converter_dma_tx
+
+  # Create instance: axis_switch_rx, and set properties
+  set axis_switch_rx [ create_bd_cell -type ip -vlnv xilinx.com:ip:axis_switch:1.1 axis_switch_rx ]
+  set_property -dict [ list \
+   CONFIG.DECODER_REG {1} \
+   CONFIG.HAS_TLAST {1} \
+   CONFIG.M00_AXIS_BASETDEST {0x00000000} \
+   CONFIG.M00_AXIS_HIGHTDEST {0x00000000} \
+   CONFIG.M01_AXIS_BASETDEST {0x00000001} \
+   CONFIG.M01_AXIS_HIGHTDEST {0x00000001} \
+   CONFIG.NUM_MI {2} \
+   CONFIG.NUM_SI {1} \
+   CONFIG.ROUTING_MODE {0} \
+   CONFIG.TDATA_NUM_BYTES {1} \
+   CONFIG.TDEST_WIDTH {4} \
+   CONFIG.TUSER_WIDTH {1} \
+ ] $axis_switch_rx
+
+  # Create instance: axis_switch_rx_timestamp, and set properties
+  set axis_switch_rx_timestamp [ create_bd_cell -type ip -vlnv xilinx.com:ip:axis_switch:1.1 axis_switch_rx_timestamp ]
+  set_property -dict [ list \
+   CONFIG.DECODER_REG {1} \
+   CONFIG.HAS_TLAST {0} \
+   CONFIG.M00_AXIS_BASETDEST {0x00000000} \
+   CONFIG.M00_AXIS_HIGHTDEST {0x00000000} \
+   CONFIG.NUM_MI {1} \
+   CONFIG.NUM_SI {1} \
+   CONFIG.ROUTING_MODE {0} \
+   CONFIG.TDATA_NUM_BYTES {12} \
+   CONFIG.TDEST_WIDTH {4} \
+ ] $axis_switch_rx_timestamp
+
+  # Create instance: axis_switch_tx, and set properties
+  set axis_switch_tx [ create_bd_cell -type ip -vlnv xilinx.com:ip:axis_switch:1.1 axis_switch_tx ]
+  set_property -dict [ list \
+   CONFIG.ARB_ALGORITHM {1} \
+   CONFIG.ARB_ON_MAX_XFERS {0} \
+   CONFIG.ARB_ON_TLAST {1} \
+   CONFIG.HAS_TLAST {1} \
+   CONFIG.NUM_MI {1} \
+   CONFIG.NUM_SI {2} \
+   CONFIG.TDATA_NUM_BYTES {1} \
+   CONFIG.TID_WIDTH {4} \
+ ] $axis_switch_tx
+
+  # Create instance: counter_timer, and set properties
+  set counter_timer [ create_bd_cell -type ip -vlnv xilinx.com:ip:c_counter_binary:12.0 counter_timer ]
+  set_property -dict [ list \
+   CONFIG.Output_Width {34} \
+ ] $counter_timer
+
+  # Create instance: fifo_dma_rx, and set properties
+  set fifo_dma_rx [ create_bd_cell -type ip -vlnv fugafuga.org:fugafuga.org:axis_async_fifo:1.0 fifo_dma_rx ]
+  set_property -dict [ list \
+   CONFIG.DEPTH_BITS {5} \
+ ] $fifo_dma_rx
+
+  # Create instance: fifo_dma_tx, and set properties
+  set fifo_dma_tx [ create_bd_cell -type ip -vlnv fugafuga.org:fugafuga.org:axis_async_fifo:1.0 fifo_dma_tx ]
+  set_property -dict [ list \
+   CONFIG.DEPTH_BITS {5} \
+ ] $fifo_dma_tx
 
   # Create instance: fifo_ethernet_rx, and set properties
-  set fifo_ethernet_rx [ create_bd_cell -type ip -vlnv xilinx.com:ip:axis_data_fifo:2.0 fifo_ethernet_rx ]
+  set fifo_ethernet_rx [ create_bd_cell -type ip -vlnv fugafuga.org:fugafuga.org:axis_async_fifo:1.0 fifo_ethernet_rx ]
   set_property -dict [ list \
-   CONFIG.FIFO_MODE {1} \
-   CONFIG.IS_ACLK_ASYNC {1} \
+   CONFIG.ALMOST_FULL_LEVEL {2048} \
+   CONFIG.DEPTH_BITS {12} \
+   CONFIG.RAM_STYLE {block} \
  ] $fifo_ethernet_rx
 
   # Create instance: fifo_ethernet_tx, and set properties
-  set fifo_ethernet_tx [ create_bd_cell -type ip -vlnv xilinx.com:ip:axis_data_fifo:2.0 fifo_ethernet_tx ]
+  set fifo_ethernet_tx [ create_bd_cell -type ip -vlnv fugafuga.org:fugafuga.org:axis_async_fifo:1.0 fifo_ethernet_tx ]
+  set_property -dict [ list \
+   CONFIG.DEPTH_BITS {5} \
+ ] $fifo_ethernet_tx
+
+  # Create instance: fifo_rx_timestamp, and set properties
+  set fifo_rx_timestamp [ create_bd_cell -type ip -vlnv fugafuga.org:fugafuga.org:axis_async_fifo:1.0 fifo_rx_timestamp ]
+  set_property -dict [ list \
+   CONFIG.DEPTH_BITS {4} \
+   CONFIG.TDATA_BITS {96} \
+ ] $fifo_rx_timestamp
+
+  # Create instance: fifo_tcp_loopback, and set properties
+  set fifo_tcp_loopback [ create_bd_cell -type ip -vlnv xilinx.com:ip:axis_data_fifo:2.0 fifo_tcp_loopback ]
   set_property -dict [ list \
    CONFIG.FIFO_DEPTH {2048} \
-   CONFIG.FIFO_MODE {2} \
    CONFIG.IS_ACLK_ASYNC {0} \
- ] $fifo_ethernet_tx
+ ] $fifo_tcp_loopback
+
+  # Create instance: frame_dma_0, and set properties
+  set frame_dma_0 [ create_bd_cell -type ip -vlnv fugafuga.org:fugafuga.org:frame_dma:1.0 frame_dma_0 ]
 
   # Create instance: mii_mac_0, and set properties
   set mii_mac_0 [ create_bd_cell -type ip -vlnv fugafuga.org:fugafuga.org:mii_mac:1.0 mii_mac_0 ]
-
-  # Create instance: mii_to_axis_ps, and set properties
-  set mii_to_axis_ps [ create_bd_cell -type ip -vlnv fugafuga.org:fugafuga.org:mii_to_axis:1.0 mii_to_axis_ps ]
-
-  # Create instance: prepend_preamble_ps, and set properties
-  set prepend_preamble_ps [ create_bd_cell -type ip -vlnv fugafuga.org:fugafuga.org:prepend_preamble:1.0 prepend_preamble_ps ]
+  set_property -dict [ list \
+   CONFIG.BRIDGE_PL_PORTS {2} \
+   CONFIG.PS_TX_FIFO_DEPTH_BITS {11} \
+   CONFIG.PS_TX_SHAPER_CLASSES {4} \
+   CONFIG.TX_FIFO_DEPTH_BITS {11} \
+   CONFIG.TX_MUX_POLICY {1} \
+   CONFIG.TX_START_THRESHOLD {64} \
+   CONFIG.USE_BRIDGE {1} \
+   CONFIG.USE_MACSEC {1} \
+ ] $mii_mac_0
+
+  # Create instance: packet_capture_0, and set properties
+  set packet_capture_0 [ create_bd_cell -type ip -vlnv fugafuga.org:fugafuga.org:packet_capture:1.0 packet_capture_0 ]
 
   # Create instance: proc_sys_reset_rx, and set properties
   set proc_sys_reset_rx [ create_bd_cell -type ip -vlnv xilinx.com:ip:proc_sys_reset:5.0 proc_sys_reset_rx ]
 
+  # Create instance: proc_sys_reset_service, and set properties
+  set proc_sys_reset_service [ create_bd_cell -type ip -vlnv xilinx.com:ip:proc_sys_reset:5.0 proc_sys_reset_service ]
+
   # Create instance: proc_sys_reset_tx, and set properties
   set proc_sys_reset_tx [ create_bd_cell -type ip -vlnv xilinx.com:ip:proc_sys_reset:5.0 proc_sys_reset_tx ]
 
@@ -263,7 +368,7 @@ proc create_root_design { parentCell } {
    CONFIG.PCW_ACT_ENET0_PERIPHERAL_FREQMHZ {125.000000} \
    CONFIG.PCW_ACT_ENET1_PERIPHERAL_FREQMHZ {10.000000} \
    CONFIG.PCW_ACT_FPGA0_PERIPHERAL_FREQMHZ {50.000000} \
-   CONFIG.PCW_ACT_FPGA1_PERIPHERAL_FREQMHZ {125.000000} \
+   CONFIG.PCW_ACT_FPGA1_PERIPHERAL_FREQMHZ {100.000000} \
    CONFIG.PCW_ACT_FPGA2_PERIPHERAL_FREQMHZ {10.000000} \
    CONFIG.PCW_ACT_FPGA3_PERIPHERAL_FREQMHZ {10.000000} \
    CONFIG.PCW_ACT_PCAP_PERIPHERAL_FREQMHZ {200.000000} \
@@ -319,14 +424,14 @@ proc create_root_design { parentCell } {
    CONFIG.PCW_EN_UART1 {1} \
    CONFIG.PCW_FCLK0_PERIPHERAL_DIVISOR0 {5} \
    CONFIG.PCW_FCLK0_PERIPHERAL_DIVISOR1 {4} \
-   CONFIG.PCW_FCLK1_PERIPHERAL_DIVISOR0 {4} \
+   CONFIG.PCW_FCLK1_PERIPHERAL_DIVISOR0 {5} \
    CONFIG.PCW_FCLK1_PERIPHERAL_DIVISOR1 {2} \
    CONFIG.PCW_FCLK2_PERIPHERAL_DIVISOR0 {1} \
    CONFIG.PCW_FCLK2_PERIPHERAL_DIVISOR1 {1} \
    CONFIG.PCW_FCLK3_PERIPHERAL_DIVISOR0 {1} \
    CONFIG.PCW_FCLK3_PERIPHERAL_DIVISOR1 {1} \
    CONFIG.PCW_FCLK_CLK1_BUF {TRUE} \
-   CONFIG.PCW_FPGA1_PERIPHERAL_FREQMHZ {125} \
+   CONFIG.PCW_FPGA1_PERIPHERAL_FREQMHZ {100} \
    CONFIG.PCW_FPGA_FCLK0_ENABLE {1} \
    CONFIG.PCW_FPGA_FCLK1_ENABLE {1} \
    CONFIG.PCW_FPGA_FCLK2_ENABLE {0} \
@@ -341,6 +446,7 @@ proc create_root_design { parentCell } {
    CONFIG.PCW_I2C_RESET_ENABLE {0} \
    CONFIG.PCW_IOPLL_CTRL_FBDIV {30} \
    CONFIG.PCW_IO_IO_PLL_FREQMHZ {1000.000} \
+   CONFIG.PCW_IRQ_F2P_INTR {1} \
    CONFIG.PCW_MIO_0_DIRECTION {out} \
    CONFIG.PCW_MIO_0_IOTYPE {LVCMOS 3.3V} \
    CONFIG.PCW_MIO_0_PULLUP {enabled} \
@@ -461,6 +567,7 @@ proc create_root_design { parentCell } {
    CONFIG.PCW_SMC_PERIPHERAL_FREQMHZ {100} \
    CONFIG.PCW_SMC_PERIPHERAL_VALID {1} \
    CONFIG.PCW_SPI_PERIPHERAL_DIVISOR0 {1} \
+   CONFIG.PCW_S_AXI_HP0_DATA_WIDTH {32} \
    CONFIG.PCW_TPIU_PERIPHERAL_DIVISOR0 {1} \
    CONFIG.PCW_UART1_GRP_FULL_ENABLE {0} \
    CONFIG.PCW_UART1_PERIPHERAL_ENABLE {1} \
@@ -489,13 +596,15 @@ proc create_root_design { parentCell } {
    CONFIG.PCW_USB1_RESET_ENABLE {0} \
    CONFIG.PCW_USB_RESET_ENABLE {0} \
    CONFIG.PCW_USE_AXI_NONSECURE {1} \
+   CONFIG.PCW_USE_FABRIC_INTERRUPT {1} \
    CONFIG.PCW_USE_S_AXI_GP0 {0} \
+   CONFIG.PCW_USE_S_AXI_HP0 {1} \
  ] $processing_system7_0
 
   # Create instance: ps7_0_axi_periph, and set properties
   set ps7_0_axi_periph [ create_bd_cell -type ip -vlnv xilinx.com:ip:axi_interconnect:2.1 ps7_0_axi_periph ]
   set_property -dict [ list \
-   CONFIG.NUM_MI {1} \
+   CONFIG.NUM_MI {9} \
  ] $ps7_0_axi_periph
 
   # Create instance: rst_ps7_0_50M, and set properties
@@ -531,18 +640,17 @@ proc create_root_design { parentCell } {
    CONFIG.C_BRAM_CNT {6} \
    CONFIG.C_INPUT_PIPE_STAGES {2} \
    CONFIG.C_MON_TYPE {MIX} \
-   CONFIG.C_NUM_MONITOR_SLOTS {2} \
+   CONFIG.C_NUM_MONITOR_SLOTS {1} \
    CONFIG.C_NUM_OF_PROBES {4} \
    CONFIG.C_SLOT_0_APC_EN {0} \
    CONFIG.C_SLOT_0_AXI_DATA_SEL {1} \
    CONFIG.C_SLOT_0_AXI_TRIG_SEL {1} \
    CONFIG.C_SLOT_0_INTF_TYPE {xilinx.com:interface:axis_rtl:1.0} \
-   CONFIG.C_SLOT_1_APC_EN {0} \
-   CONFIG.C_SLOT_1_AXI_DATA_SEL {1} \
-   CONFIG.C_SLOT_1_AXI_TRIG_SEL {1} \
-   CONFIG.C_SLOT_1_INTF_TYPE {xilinx.com:interface:axis_rtl:1.0} \
  ] $system_ila_tx
 
+  # Create instance: time_base_0, and set properties
+  set time_base_0 [ create_bd_cell -type ip -vlnv fugafuga.org:fugafuga.org:time_base:1.0 time_base_0 ]
+
   # Create instance: vio_ethernet_reset, and set properties
   set vio_ethernet_reset [ create_bd_cell -type ip -vlnv xilinx.com:ip:vio:3.0 vio_ethernet_reset ]
   set_property -dict [ list \
@@ -551,26 +659,70 @@ proc create_root_design { parentCell } {
    CONFIG.C_PROBE_OUT0_INIT_VAL {0001} \
  ] $vio_ethernet_reset
 
+  # Create instance: xlconcat_irq, and set properties
+  set xlconcat_irq [ create_bd_cell -type ip -vlnv xilinx.com:ip:xlconcat:2.1 xlconcat_irq ]
+  set_property -dict [ list \
+   CONFIG.NUM_PORTS {2} \
+ ] $xlconcat_irq
+
   # Create instance: xlconstant_config, and set properties
   set xlconstant_config [ create_bd_cell -type ip -vlnv xilinx.com:ip:xlconstant:1.1 xlconstant_config ]
   set_property -dict [ list \
-   CONFIG.CONST_VAL {0x00000000c0a804020000aabbccddeeff} \
-   CONFIG.CONST_WIDTH {128} \
+   CONFIG.CONST_VAL {0x3000000000000000000000000000000000000000000000000000000000000000000000000ffffff00000000015050530000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000fd00000000000004000000000000000200001389c0a804020000aabbccddeeff} \
+   CONFIG.CONST_WIDTH {1216} \
  ] $xlconstant_config
 
+  # Create instance: xlconstant_pps, and set properties
+  set xlconstant_pps [ create_bd_cell -type ip -vlnv xilinx.com:ip:xlconstant:1.1 xlconstant_pps ]
+  set_property -dict [ list \
+   CONFIG.CONST_VAL {0} \
+ ] $xlconstant_pps
+
+  # Create instance: xlslice_mac_address, and set properties
+  set xlslice_mac_address [ create_bd_cell -type ip -vlnv xilinx.com:ip:xlslice:1.0 xlslice_mac_address ]
+  set_property -dict [ list \
+   CONFIG.DIN_FROM {47} \
+   CONFIG.DIN_TO {0} \
+   CONFIG.DIN_WIDTH {1216} \
+   CONFIG.DOUT_WIDTH {48} \
+ ] $xlslice_mac_address
+
+  # Create instance: xlslice_timer, and set properties
+  set xlslice_timer [ create_bd_cell -type ip -vlnv xilinx.com:ip:xlslice:1.0 xlslice_timer ]
+  set_property -dict [ list \
+   CONFIG.DIN_FROM {33} \
+   CONFIG.DIN_TO {2} \
+   CONFIG.DIN_WIDTH {34} \
+   CONFIG.DOUT_WIDTH {32} \
+ ] $xlslice_timer
+
   # Create interface connections
-  connect_bd_intf_net -intf_net arp_0_out_r [get_bd_intf_pins ethernet_service_0/out_r] [get_bd_intf_pins fifo_ethernet_tx/S_AXIS]
-connect_bd_intf_net -intf_net [get_bd_intf_nets arp_0_out_r] [get_bd_intf_pins fifo_ethernet_tx/S_AXIS] [get_bd_intf_pins system_ila_tx/SLOT_0_AXIS]
-  set_property HDL_ATTRIBUTE.DEBUG {true} [get_bd_intf_nets arp_0_out_r]
-  connect_bd_intf_net -intf_net fifo_ethernet_ps_tx_M_AXIS [get_bd_intf_pins fifo_ethernet_ps_tx/M_AXIS] [get_bd_intf_pins prepend_preamble_ps/saxis]
-  connect_bd_intf_net -intf_net fifo_ethernet_rx_M_AXIS [get_bd_intf_pins ethernet_service_0/in_r] [get_bd_intf_pins fifo_ethernet_rx/M_AXIS]
-connect_bd_intf_net -intf_net [get_bd_intf_nets fifo_ethernet_rx_M_AXIS] [get_bd_intf_pins fifo_ethernet_rx/M_AXIS] [get_bd_intf_pins system_ila_tx/SLOT_1_AXIS]
-  set_property HDL_ATTRIBUTE.DEBUG {true} [get_bd_intf_nets fifo_ethernet_rx_M_AXIS]
-  connect_bd_intf_net -intf_net fifo_ethernet_tx_M_AXIS [get_bd_intf_pins fifo_ethernet_tx/M_AXIS] [get_bd_intf_pins mii_mac_0/tx_saxis]
-  connect_bd_intf_net -intf_net mii_mac_0_rx_maxis [get_bd_intf_pins fifo_ethernet_rx/S_AXIS] [get_bd_intf_pins mii_mac_0/rx_maxis]
-connect_bd_intf_net -intf_net [get_bd_intf_nets mii_mac_0_rx_maxis] [get_bd_intf_pins fifo_ethernet_rx/S_AXIS] [get_bd_intf_pins system_ila_rx/SLOT_0_AXIS]
-  connect_bd_intf_net -intf_net mii_to_axis_ps_maxis [get_bd_intf_pins fifo_ethernet_ps_tx/S_AXIS] [get_bd_intf_pins mii_to_axis_ps/maxis]
-  connect_bd_intf_net -intf_net prepend_preamble_0_maxis [get_bd_intf_pins mii_mac_0/tx_saxis_bypass] [get_bd_intf_pins prepend_preamble_ps/maxis]
+  connect_bd_intf_net -intf_net arp_0_out_r [get_bd_intf_pins ethernet_service_0/out_r] [get_bd_intf_pins fifo_ethernet_tx/saxis]
+  connect_bd_intf_net -intf_net axi_mem_intercon_M00_AXI [get_bd_intf_pins axi_mem_intercon/M00_AXI] [get_bd_intf_pins processing_system7_0/S_AXI_HP0]
+  connect_bd_intf_net -intf_net axis_subset_converter_dma_tx_M_AXIS [get_bd_intf_pins axis_subset_converter_dma_tx/M_AXIS] [get_bd_intf_pins axis_switch_tx/S01_AXIS]
+  connect_bd_intf_net -intf_net axis_switch_rx_M00_AXIS [get_bd_intf_pins axis_switch_rx/M00_AXIS] [get_bd_intf_pins fifo_ethernet_rx/saxis]
+  connect_bd_intf_net -intf_net axis_switch_rx_M01_AXIS [get_bd_intf_pins axis_switch_rx/M01_AXIS] [get_bd_intf_pins fifo_dma_rx/saxis]
+  connect_bd_intf_net -intf_net axis_switch_rx_timestamp_M00_AXIS [get_bd_intf_pins axis_switch_rx_timestamp/M00_AXIS] [get_bd_intf_pins fifo_rx_timestamp/saxis]
+  connect_bd_intf_net -intf_net axis_switch_tx_M00_AXIS [get_bd_intf_pins axis_switch_tx/M00_AXIS] [get_bd_intf_pins mii_mac_0/tx_saxis]
+connect_bd_intf_net -intf_net [get_bd_intf_nets axis_switch_tx_M00_AXIS] [get_bd_intf_pins mii_mac_0/tx_saxis] [get_bd_intf_pins system_ila_tx/SLOT_0_AXIS]
+connect_bd_intf_net -intf_net [get_bd_intf_nets axis_switch_tx_M00_AXIS] [get_bd_intf_pins mii_mac_0/tx_saxis] [get_bd_intf_pins packet_capture_0/tx_tap]
+  set_property HDL_ATTRIBUTE.DEBUG {true} [get_bd_intf_nets axis_switch_tx_M00_AXIS]
+  connect_bd_intf_net -intf_net fifo_dma_rx_maxis [get_bd_intf_pins fifo_dma_rx/maxis] [get_bd_intf_pins frame_dma_0/rx_saxis]
+  connect_bd_intf_net -intf_net fifo_dma_tx_maxis [get_bd_intf_pins axis_subset_converter_dma_tx/S_AXIS] [get_bd_intf_pins fifo_dma_tx/maxis]
+  connect_bd_intf_net -intf_net fifo_ethernet_tx_maxis [get_bd_intf_pins axis_switch_tx/S00_AXIS] [get_bd_intf_pins fifo_ethernet_tx/maxis]
+  connect_bd_intf_net -intf_net frame_dma_0_m_axi [get_bd_intf_pins axi_mem_intercon/S00_AXI] [get_bd_intf_pins frame_dma_0/m_axi]
+  connect_bd_intf_net -intf_net frame_dma_0_tx_maxis [get_bd_intf_pins fifo_dma_tx/saxis] [get_bd_intf_pins frame_dma_0/tx_maxis]
+  connect_bd_intf_net -intf_net fifo_ethernet_rx_maxis [get_bd_intf_pins ethernet_service_0/in_r] [get_bd_intf_pins fifo_ethernet_rx/maxis]
+  connect_bd_intf_net -intf_net ethernet_service_0_tcp_rx [get_bd_intf_pins ethernet_service_0/tcp_rx] [get_bd_intf_pins fifo_tcp_loopback/S_AXIS]
+  connect_bd_intf_net -intf_net fifo_rx_timestamp_maxis [get_bd_intf_pins ethernet_service_0/rx_timestamp] [get_bd_intf_pins fifo_rx_timestamp/maxis]
+  connect_bd_intf_net -intf_net fifo_tcp_loopback_M_AXIS [get_bd_intf_pins ethernet_service_0/tcp_tx] [get_bd_intf_pins fifo_tcp_loopback/M_AXIS]
+  connect_bd_intf_net -intf_net mii_mac_0_rx_maxis [get_bd_intf_pins axis_switch_rx/S00_AXIS] [get_bd_intf_pins mii_mac_0/rx_maxis]
+connect_bd_intf_net -intf_net [get_bd_intf_nets mii_mac_0_rx_maxis] [get_bd_intf_pins axis_switch_rx/S00_AXIS] [get_bd_intf_pins system_ila_rx/SLOT_0_AXIS]
+connect_bd_intf_net -intf_net [get_bd_intf_nets mii_mac_0_rx_maxis] [get_bd_intf_pins axis_switch_rx/S00_AXIS] [get_bd_intf_pins packet_capture_0/rx_tap]
+  connect_bd_intf_net -intf_net mii_mac_0_rx_timestamp_maxis [get_bd_intf_pins axis_switch_rx_timestamp/S00_AXIS] [get_bd_intf_pins mii_mac_0/rx_timestamp_maxis]
+  connect_bd_intf_net -intf_net mii_mac_0_ptp_rx_event_maxis [get_bd_intf_pins mii_mac_0/ptp_rx_event_maxis] [get_bd_intf_pins time_base_0/rx_event_saxis]
+  connect_bd_intf_net -intf_net mii_mac_0_ptp_tx_event_maxis [get_bd_intf_pins mii_mac_0/ptp_tx_event_maxis] [get_bd_intf_pins time_base_0/tx_event_saxis]
+  connect_bd_intf_net -intf_net packet_capture_0_m_axi [get_bd_intf_pins axi_mem_intercon/S01_AXI] [get_bd_intf_pins packet_capture_0/m_axi]
   connect_bd_intf_net -intf_net processing_system7_0_DDR [get_bd_intf_ports DDR_0] [get_bd_intf_pins processing_system7_0/DDR]
   connect_bd_intf_net -intf_net processing_system7_0_FIXED_IO [get_bd_intf_ports FIXED_IO_0] [get_bd_intf_pins processing_system7_0/FIXED_IO]
   connect_bd_intf_net -intf_net processing_system7_0_GPIO_0 [get_bd_intf_ports GPIO_0_0] [get_bd_intf_pins processing_system7_0/GPIO_0]
@@ -578,34 +730,70 @@ connect_bd_intf_net -intf_net [get_bd_intf_nets processing_system7_0_GPIO_0] [ge
   set_property HDL_ATTRIBUTE.DEBUG {true} [get_bd_intf_nets processing_system7_0_GPIO_0]
   connect_bd_intf_net -intf_net processing_system7_0_MDIO_ETHERNET_0 [get_bd_intf_ports MDIO_ETHERNET_0_0] [get_bd_intf_pins processing_system7_0/MDIO_ETHERNET_0]
   connect_bd_intf_net -intf_net processing_system7_0_M_AXI_GP0 [get_bd_intf_pins processing_system7_0/M_AXI_GP0] [get_bd_intf_pins ps7_0_axi_periph/S00_AXI]
+  connect_bd_intf_net -intf_net ps7_0_axi_periph_M00_AXI [get_bd_intf_pins ps7_0_axi_periph/M00_AXI] [get_bd_intf_pins time_base_0/s_axi]
+  connect_bd_intf_net -intf_net ps7_0_axi_periph_M01_AXI [get_bd_intf_pins mii_mac_0/tas_s_axi] [get_bd_intf_pins ps7_0_axi_periph/M01_AXI]
+  connect_bd_intf_net -intf_net ps7_0_axi_periph_M02_AXI [get_bd_intf_pins mii_mac_0/shaper_s_axi] [get_bd_intf_pins ps7_0_axi_periph/M02_AXI]
+  connect_bd_intf_net -intf_net ps7_0_axi_periph_M03_AXI [get_bd_intf_pins mii_mac_0/macsec_tx_s_axi] [get_bd_intf_pins ps7_0_axi_periph/M03_AXI]
+  connect_bd_intf_net -intf_net ps7_0_axi_periph_M04_AXI [get_bd_intf_pins mii_mac_0/macsec_rx_s_axi] [get_bd_intf_pins ps7_0_axi_periph/M04_AXI]
+  connect_bd_intf_net -intf_net ps7_0_axi_periph_M05_AXI [get_bd_intf_pins mii_mac_0/bridge_s_axi] [get_bd_intf_pins ps7_0_axi_periph/M05_AXI]
+  connect_bd_intf_net -intf_net ps7_0_axi_periph_M06_AXI [get_bd_intf_pins mii_mac_0/counters_s_axi] [get_bd_intf_pins ps7_0_axi_periph/M06_AXI]
+  connect_bd_intf_net -intf_net ps7_0_axi_periph_M07_AXI [get_bd_intf_pins frame_dma_0/s_axi] [get_bd_intf_pins ps7_0_axi_periph/M07_AXI]
+  connect_bd_intf_net -intf_net ps7_0_axi_periph_M08_AXI [get_bd_intf_pins packet_capture_0/s_axi] [get_bd_intf_pins ps7_0_axi_periph/M08_AXI]
 
   # Create port connections
-  connect_bd_net -net ENET0_GMII_RX_CLK_0_1 [get_bd_ports ENET0_GMII_RX_CLK_0] [get_bd_pins fifo_ethernet_rx/s_axis_aclk] [get_bd_pins mii_mac_0/rx_clock] [get_bd_pins proc_sys_reset_rx/slowest_sync_clk] [get_bd_pins processing_system7_0/ENET0_GMII_RX_CLK] [get_bd_pins system_ila_rx/clk] [get_bd_pins vio_ethernet_reset/clk]
-  connect_bd_net -net ENET0_GMII_RX_DV_0_1 [get_bd_ports ENET0_GMII_RX_DV_0] [get_bd_pins mii_mac_0/rx_mii_dv] [get_bd_pins processing_system7_0/ENET0_GMII_RX_DV] [get_bd_pins system_ila_rx/probe1]
+  connect_bd_net -net ENET0_GMII_RX_CLK_0_1 [get_bd_ports ENET0_GMII_RX_CLK_0] [get_bd_pins axis_switch_rx/aclk] [get_bd_pins fifo_dma_rx/s_clock] [get_bd_pins fifo_ethernet_rx/s_clock] [get_bd_pins mii_mac_0/rx_clock] [get_bd_pins packet_capture_0/rx_tap_clock] [get_bd_pins proc_sys_reset_rx/slowest_sync_clk] [get_bd_pins processing_system7_0/ENET0_GMII_RX_CLK] [get_bd_pins ps7_0_axi_periph/M04_ACLK] [get_bd_pins system_ila_rx/clk] [get_bd_pins vio_ethernet_reset/clk]
+  connect_bd_net -net ENET0_GMII_RX_DV_0_1 [get_bd_ports ENET0_GMII_RX_DV_0] [get_bd_pins mii_mac_0/rx_mii_dv] [get_bd_pins system_ila_rx/probe1]
   set_property HDL_ATTRIBUTE.DEBUG {true} [get_bd_nets ENET0_GMII_RX_DV_0_1]
-  connect_bd_net -net enet0_gmii_rxd_1 [get_bd_ports enet0_gmii_rxd] [get_bd_pins mii_mac_0/rx_mii_d] [get_bd_pins processing_system7_0/ENET0_GMII_RXD] [get_bd_pins system_ila_rx/probe0]
+  connect_bd_net -net counter_timer_Q [get_bd_pins counter_timer/Q] [get_bd_pins xlslice_timer/Din]
+  connect_bd_net -net enet0_gmii_rxd_1 [get_bd_ports enet0_gmii_rxd] [get_bd_pins mii_mac_0/rx_mii_d] [get_bd_pins system_ila_rx/probe0]
   set_property HDL_ATTRIBUTE.DEBUG {true} [get_bd_nets enet0_gmii_rxd_1]
+  connect_bd_net -net frame_dma_0_interrupt [get_bd_pins frame_dma_0/interrupt] [get_bd_pins xlconcat_irq/In0]
+  connect_bd_net -net packet_capture_0_interrupt [get_bd_pins packet_capture_0/interrupt] [get_bd_pins xlconcat_irq/In1]
+  connect_bd_net -net xlconcat_irq_dout [get_bd_pins processing_system7_0/IRQ_F2P] [get_bd_pins xlconcat_irq/dout]
+  connect_bd_net -net ethernet_service_0_multicast_hash [get_bd_pins ethernet_service_0/multicast_hash] [get_bd_pins mii_mac_0/multicast_hash]
+  connect_bd_net -net mii_mac_0_ps_rx_mii_d [get_bd_pins mii_mac_0/ps_rx_mii_d] [get_bd_pins processing_system7_0/ENET0_GMII_RXD]
+  connect_bd_net -net mii_mac_0_ps_rx_mii_dv [get_bd_pins mii_mac_0/ps_rx_mii_dv] [get_bd_pins processing_system7_0/ENET0_GMII_RX_DV]
   connect_bd_net -net mii_mac_0_tx_mii_d [get_bd_ports enet0_gmii_txd] [get_bd_pins mii_mac_0/tx_mii_d] [get_bd_pins system_ila_tx/probe0]
   set_property HDL_ATTRIBUTE.DEBUG {true} [get_bd_nets mii_mac_0_tx_mii_d]
   connect_bd_net -net mii_mac_0_tx_mii_en [get_bd_ports ENET0_GMII_TX_EN_0] [get_bd_pins mii_mac_0/tx_mii_en] [get_bd_pins system_ila_tx/probe1]
   set_property HDL_ATTRIBUTE.DEBUG {true} [get_bd_nets mii_mac_0_tx_mii_en]
-  connect_bd_net -net proc_sys_reset_0_peripheral_aresetn [get_bd_pins fifo_ethernet_rx/s_axis_aresetn] [get_bd_pins proc_sys_reset_rx/peripheral_aresetn] [get_bd_pins system_ila_rx/resetn]
+  connect_bd_net -net proc_sys_reset_0_peripheral_aresetn [get_bd_pins axis_switch_rx/aresetn] [get_bd_pins fifo_dma_rx/s_aresetn] [get_bd_pins fifo_ethernet_rx/s_aresetn] [get_bd_pins packet_capture_0/rx_tap_aresetn] [get_bd_pins proc_sys_reset_rx/peripheral_aresetn] [get_bd_pins ps7_0_axi_periph/M04_ARESETN] [get_bd_pins system_ila_rx/resetn]
   connect_bd_net -net proc_sys_reset_0_peripheral_reset [get_bd_pins mii_mac_0/rx_reset] [get_bd_pins proc_sys_reset_rx/peripheral_reset]
-  connect_bd_net -net proc_sys_reset_1_peripheral_aresetn [get_bd_pins ethernet_service_0/ap_rst_n] [get_bd_pins fifo_ethernet_ps_tx/s_axis_aresetn] [get_bd_pins fifo_ethernet_tx/s_axis_aresetn] [get_bd_pins mii_to_axis_ps/aresetn] [get_bd_pins prepend_preamble_ps/aresetn] [get_bd_pins proc_sys_reset_tx/peripheral_aresetn] [get_bd_pins system_ila_tx/resetn]
+  connect_bd_net -net proc_sys_reset_1_peripheral_aresetn [get_bd_pins axis_subset_converter_dma_tx/aresetn] [get_bd_pins axis_switch_rx_timestamp/aresetn] [get_bd_pins axis_switch_tx/aresetn] [get_bd_pins axi_mem_intercon/S01_ARESETN] [get_bd_pins fifo_dma_tx/m_aresetn] [get_bd_pins fifo_ethernet_tx/m_aresetn] [get_bd_pins fifo_rx_timestamp/s_aresetn] [get_bd_pins packet_capture_0/aresetn] [get_bd_pins packet_capture_0/tx_tap_aresetn] [get_bd_pins proc_sys_reset_tx/peripheral_aresetn] [get_bd_pins ps7_0_axi_periph/M00_ARESETN] [get_bd_pins ps7_0_axi_periph/M01_ARESETN] [get_bd_pins ps7_0_axi_periph/M02_ARESETN] [get_bd_pins ps7_0_axi_periph/M03_ARESETN] [get_bd_pins ps7_0_axi_periph/M05_ARESETN] [get_bd_pins ps7_0_axi_periph/M06_ARESETN] [get_bd_pins ps7_0_axi_periph/M08_ARESETN] [get_bd_pins system_ila_tx/resetn] [get_bd_pins time_base_0/aresetn]
   connect_bd_net -net proc_sys_reset_1_peripheral_reset [get_bd_pins mii_mac_0/tx_reset] [get_bd_pins proc_sys_reset_tx/peripheral_reset]
-  connect_bd_net -net processing_system7_0_ENET0_GMII_TXD [get_bd_pins mii_to_axis_ps/mii_d] [get_bd_pins processing_system7_0/ENET0_GMII_TXD] [get_bd_pins system_ila_tx/probe3]
+  connect_bd_net -net processing_system7_0_ENET0_GMII_TXD [get_bd_pins mii_mac_0/ps_tx_mii_d] [get_bd_pins processing_system7_0/ENET0_GMII_TXD] [get_bd_pins system_ila_tx/probe3]
   set_property HDL_ATTRIBUTE.DEBUG {true} [get_bd_nets processing_system7_0_ENET0_GMII_TXD]
-  connect_bd_net -net processing_system7_0_ENET0_GMII_TX_EN [get_bd_pins mii_to_axis_ps/mii_dv] [get_bd_pins processing_system7_0/ENET0_GMII_TX_EN] [get_bd_pins system_ila_tx/probe2]
+  connect_bd_net -net processing_system7_0_ENET0_GMII_TX_EN [get_bd_pins mii_mac_0/ps_tx_mii_en] [get_bd_pins processing_system7_0/ENET0_GMII_TX_EN] [get_bd_pins system_ila_tx/probe2]
   set_property HDL_ATTRIBUTE.DEBUG {true} [get_bd_nets processing_system7_0_ENET0_GMII_TX_EN]
-  connect_bd_net -net processing_system7_0_ENET0_GMII_TX_ER [get_bd_pins mii_to_axis_ps/mii_er] [get_bd_pins processing_system7_0/ENET0_GMII_TX_ER]
-  connect_bd_net -net processing_system7_0_FCLK_CLK0 [get_bd_pins processing_system7_0/FCLK_CLK0] [get_bd_pins processing_system7_0/M_AXI_GP0_ACLK] [get_bd_pins ps7_0_axi_periph/ACLK] [get_bd_pins ps7_0_axi_periph/M00_ACLK] [get_bd_pins ps7_0_axi_periph/S00_ACLK] [get_bd_pins rst_ps7_0_50M/slowest_sync_clk] [get_bd_pins system_ila_0/clk]
+  connect_bd_net -net proc_sys_reset_service_peripheral_aresetn [get_bd_pins axi_mem_intercon/ARESETN] [get_bd_pins axi_mem_intercon/M00_ARESETN] [get_bd_pins axi_mem_intercon/S00_ARESETN] [get_bd_pins ethernet_service_0/ap_rst_n] [get_bd_pins fifo_dma_rx/m_aresetn] [get_bd_pins fifo_dma_tx/s_aresetn] [get_bd_pins fifo_ethernet_rx/m_aresetn] [get_bd_pins fifo_ethernet_tx/s_aresetn] [get_bd_pins fifo_rx_timestamp/m_aresetn] [get_bd_pins fifo_tcp_loopback/s_axis_aresetn] [get_bd_pins frame_dma_0/aresetn] [get_bd_pins proc_sys_reset_service/peripheral_aresetn] [get_bd_pins ps7_0_axi_periph/M07_ARESETN]
+  connect_bd_net -net processing_system7_0_FCLK_CLK0 [get_bd_pins processing_system7_0/FCLK_CLK0] [get_bd_pins processing_system7_0/M_AXI_GP0_ACLK] [get_bd_pins ps7_0_axi_periph/ACLK] [get_bd_pins ps7_0_axi_periph/S00_ACLK] [get_bd_pins rst_ps7_0_50M/slowest_sync_clk] [get_bd_pins system_ila_0/clk]
+  connect_bd_net -net processing_system7_0_FCLK_CLK1 [get_bd_pins axi_mem_intercon/ACLK] [get_bd_pins axi_mem_intercon/M00_ACLK] [get_bd_pins axi_mem_intercon/S00_ACLK] [get_bd_pins counter_timer/CLK] [get_bd_pins ethernet_service_0/ap_clk] [get_bd_pins fifo_dma_rx/m_clock] [get_bd_pins fifo_dma_tx/s_clock] [get_bd_pins fifo_ethernet_rx/m_clock] [get_bd_pins fifo_ethernet_tx/s_clock] [get_bd_pins fifo_rx_timestamp/m_clock] [get_bd_pins fifo_tcp_loopback/s_axis_aclk] [get_bd_pins frame_dma_0/clock] [get_bd_pins mii_mac_0/multicast_hash_clock] [get_bd_pins proc_sys_reset_service/slowest_sync_clk] [get_bd_pins processing_system7_0/FCLK_CLK1] [get_bd_pins processing_system7_0/S_AXI_HP0_ACLK] [get_bd_pins ps7_0_axi_periph/M07_ACLK]
   connect_bd_net -net processing_system7_0_FCLK_RESET0_N [get_bd_pins processing_system7_0/FCLK_RESET0_N] [get_bd_pins rst_ps7_0_50M/ext_reset_in]
-  connect_bd_net -net rst_ps7_0_50M_peripheral_aresetn [get_bd_pins ps7_0_axi_periph/ARESETN] [get_bd_pins ps7_0_axi_periph/M00_ARESETN] [get_bd_pins ps7_0_axi_periph/S00_ARESETN] [get_bd_pins rst_ps7_0_50M/peripheral_aresetn]
-  connect_bd_net -net tri_mode_ethernet_mac_0_tx_mac_aclk [get_bd_ports ENET0_GMII_TX_CLK_0] [get_bd_pins ethernet_service_0/ap_clk] [get_bd_pins fifo_ethernet_ps_tx/s_axis_aclk] [get_bd_pins fifo_ethernet_rx/m_axis_aclk] [get_bd_pins fifo_ethernet_tx/s_axis_aclk] [get_bd_pins mii_mac_0/tx_clock] [get_bd_pins mii_to_axis_ps/clock] [get_bd_pins prepend_preamble_ps/clock] [get_bd_pins proc_sys_reset_tx/slowest_sync_clk] [get_bd_pins processing_system7_0/ENET0_GMII_TX_CLK] [get_bd_pins system_ila_tx/clk]
-  connect_bd_net -net vio_0_probe_out0 [get_bd_pins proc_sys_reset_rx/ext_reset_in] [get_bd_pins proc_sys_reset_tx/ext_reset_in] [get_bd_pins vio_ethernet_reset/probe_out0]
-  connect_bd_net -net xlconstant_config_dout [get_bd_pins ethernet_service_0/config_r] [get_bd_pins xlconstant_config/dout]
+  connect_bd_net -net rst_ps7_0_50M_peripheral_aresetn [get_bd_pins ps7_0_axi_periph/ARESETN] [get_bd_pins ps7_0_axi_periph/S00_ARESETN] [get_bd_pins rst_ps7_0_50M/peripheral_aresetn]
+  connect_bd_net -net tri_mode_ethernet_mac_0_tx_mac_aclk [get_bd_ports ENET0_GMII_TX_CLK_0] [get_bd_pins axis_subset_converter_dma_tx/aclk] [get_bd_pins axis_switch_rx_timestamp/aclk] [get_bd_pins axis_switch_tx/aclk] [get_bd_pins axi_mem_intercon/S01_ACLK] [get_bd_pins fifo_dma_tx/m_clock] [get_bd_pins fifo_ethernet_tx/m_clock] [get_bd_pins fifo_rx_timestamp/s_clock] [get_bd_pins mii_mac_0/tx_clock] [get_bd_pins packet_capture_0/clock] [get_bd_pins packet_capture_0/tx_tap_clock] [get_bd_pins proc_sys_reset_tx/slowest_sync_clk] [get_bd_pins processing_system7_0/ENET0_GMII_TX_CLK] [get_bd_pins ps7_0_axi_periph/M00_ACLK] [get_bd_pins ps7_0_axi_periph/M01_ACLK] [get_bd_pins ps7_0_axi_periph/M02_ACLK] [get_bd_pins ps7_0_axi_periph/M03_ACLK] [get_bd_pins ps7_0_axi_periph/M05_ACLK] [get_bd_pins ps7_0_axi_periph/M06_ACLK] [get_bd_pins ps7_0_axi_periph/M08_ACLK] [get_bd_pins system_ila_tx/clk] [get_bd_pins time_base_0/clock]
+  connect_bd_net -net time_base_0_ptp_one_step [get_bd_pins mii_mac_0/ptp_one_step] [get_bd_pins time_base_0/ptp_one_step]
+  connect_bd_net -net time_base_0_time_locked [get_bd_pins mii_mac_0/time_locked] [get_bd_pins packet_capture_0/time_locked] [get_bd_pins time_base_0/time_locked]
+  connect_bd_net -net time_base_0_time_nanoseconds [get_bd_pins mii_mac_0/time_nanoseconds] [get_bd_pins packet_capture_0/time_nanoseconds] [get_bd_pins time_base_0/time_nanoseconds]
+  connect_bd_net -net time_base_0_time_seconds [get_bd_pins mii_mac_0/time_seconds] [get_bd_pins packet_capture_0/time_seconds] [get_bd_pins time_base_0/time_seconds]
+  connect_bd_net -net vio_0_probe_out0 [get_bd_pins proc_sys_reset_rx/ext_reset_in] [get_bd_pins proc_sys_reset_service/ext_reset_in] [get_bd_pins proc_sys_reset_tx/ext_reset_in] [get_bd_pins vio_ethernet_reset/probe_out0]
+  connect_bd_net -net xlslice_timer_Dout [get_bd_pins ethernet_service_0/timer] [get_bd_pins xlslice_timer/Dout]
+  connect_bd_net -net xlconstant_config_dout [get_bd_pins ethernet_service_0/config_r] [get_bd_pins xlconstant_config/dout] [get_bd_pins xlslice_mac_address/Din]
+  connect_bd_net -net fifo_ethernet_rx_almost_full [get_bd_pins fifo_ethernet_rx/almost_full] [get_bd_pins mii_mac_0/pause_request]
+  connect_bd_net -net xlslice_mac_address_Dout [get_bd_pins mii_mac_0/pause_source_address] [get_bd_pins xlslice_mac_address/Dout]
+  connect_bd_net -net xlconstant_pps_dout [get_bd_pins time_base_0/pps] [get_bd_pins xlconstant_pps/dout]
 
   # Create address segments
+  assign_bd_address -offset 0x43C00000 -range 0x00010000 -target_address_space [get_bd_addr_spaces processing_system7_0/Data] [get_bd_addr_segs time_base_0/s_axi/reg0] -force
+  assign_bd_address -offset 0x43C10000 -range 0x00010000 -target_address_space [get_bd_addr_spaces processing_system7_0/Data] [get_bd_addr_segs mii_mac_0/tas_s_axi/reg0] -force
+  assign_bd_address -offset 0x43C20000 -range 0x00010000 -target_address_space [get_bd_addr_spaces processing_system7_0/Data] [get_bd_addr_segs mii_mac_0/shaper_s_axi/reg0] -force
+  assign_bd_address -offset 0x43C30000 -range 0x00010000 -target_address_space [get_bd_addr_spaces processing_system7_0/Data] [get_bd_addr_segs mii_mac_0/macsec_tx_s_axi/reg0] -force
+  assign_bd_address -offset 0x43C40000 -range 0x00010000 -target_address_space [get_bd_addr_spaces processing_system7_0/Data] [get_bd_addr_segs mii_mac_0/macsec_rx_s_axi/reg0] -force
+  assign_bd_address -offset 0x43C50000 -range 0x00010000 -target_address_space [get_bd_addr_spaces processing_system7_0/Data] [get_bd_addr_segs mii_mac_0/bridge_s_axi/reg0] -force
+  assign_bd_address -offset 0x43C60000 -range 0x00010000 -target_address_space [get_bd_addr_spaces processing_system7_0/Data] [get_bd_addr_segs mii_mac_0/counters_s_axi/reg0] -force
+  assign_bd_address -offset 0x43C70000 -range 0x00010000 -target_address_space [get_bd_addr_spaces processing_system7_0/Data] [get_bd_addr_segs frame_dma_0/s_axi/reg0] -force
+  assign_bd_address -offset 0x00000000 -range 0x10000000 -target_address_space [get_bd_addr_spaces frame_dma_0/m_axi] [get_bd_addr_segs processing_system7_0/S_AXI_HP0/HP0_DDR_LOWOCM] -force
+  assign_bd_address -offset 0x43C80000 -range 0x00010000 -target_address_space [get_bd_addr_spaces processing_system7_0/Data] [get_bd_addr_segs packet_capture_0/s_axi/reg0] -force
+  assign_bd_address -offset 0x00000000 -range 0x10000000 -target_address_space [get_bd_addr_spaces packet_capture_0/m_axi] [get_bd_addr_segs processing_system7_0/S_AXI_HP0/HP0_DDR_LOWOCM] -force
 
 
   # Restore current instance
@@ -0,0 +1,675 @@
+/*
+* ptp-pl - PTP ordinary clock with the timestamps of the PL MAC
+*
+* The PS GEM on the EMIO has no timestamping unit, so ptp4l on this board only gets software timestamps.
+* The PL MAC timestamps PTP event messages at the SFD with the PL time base and queues them in the time base registers.
+* This adapter sends and receives PTP messages through the sockets of the PS network interface and
+* matches them with the PL timestamps by messageType, domainNumber and sequenceId.
+*
+* Slave (default): follows a master such as ptp4l with the end-to-end delay mechanism and
+*                  disciplines the PL time base. One-step and two-step masters are supported.
+* Master (-m):     sends Announce and Sync and answers Delay_Req, so ptp4l can synchronize to the PL time base.
+*                  With -s, Sync is sent in one-step mode and the PL MAC adds the time to the SFD into correctionField.
+*
+* The PL time base is kept in UTC for the NTP server. The PTP time is the time base + currentUtcOffset.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+
+#include "time_base.h"
+
+#define PTP_EVENT_PORT		319
+#define PTP_GENERAL_PORT	320
+#define PTP_PRIMARY_IPV4	"224.0.1.129"
+
+#define SYNC		0x0
+#define DELAY_REQ	0x1
+#define FOLLOW_UP	0x8
+#define DELAY_RESP	0x9
+#define ANNOUNCE	0xb
+
+#define HEADER_SIZE		34
+#define SYNC_SIZE		44
+#define DELAY_REQ_SIZE		44
+#define FOLLOW_UP_SIZE		44
+#define DELAY_RESP_SIZE		54
+#define ANNOUNCE_SIZE		64
+
+#define FLAG_TWO_STEP		0x0200
+#define FLAG_PTP_TIMESCALE	0x0008
+
+#define DEFAULT_UTC_OFFSET	37
+
+#define STEP_THRESHOLD_NS	1000000
+#define LOCK_THRESHOLD_NS	1000
+#define LOCK_COUNT		4
+#define UNLOCK_THRESHOLD_NS	10000
+#define MAX_FREQUENCY_PPB	500000.0
+#define EVENT_TIMEOUT_MS	10
+#define MASTER_TIMEOUT_S	6
+
+#define KP	0.7
+#define KI	0.3
+
+static const uint8_t ptp_primary_mac[ETH_ALEN] = {0x01, 0x1b, 0x19, 0x00, 0x00, 0x00};
+
+struct port_identity {
+	uint8_t clock_identity[8];
+	uint16_t port_number;
+};
+
+struct transport {
+	int l2;
+	int ifindex;
+	int event_fd;
+	int general_fd;		/* Same as event_fd on L2. */
+	struct sockaddr_in event_address;
+	struct sockaddr_in general_address;
+};
+
+struct clock {
+	struct time_base tb;
+	struct transport transport;
+	struct port_identity identity;
+	uint8_t domain_number;
+	int utc_offset;
+	int verbose;
+
+	/* Slave */
+	int has_master;
+	struct port_identity master;
+	time_t last_announce;
+	uint16_t sync_sequence_id;
+	int64_t t1;
+	int64_t t2;
+	int64_t sync_correction;
+	int waiting_follow_up;
+	uint16_t delay_req_sequence_id;
+	int64_t t3;
+	int waiting_delay_resp;
+	int64_t path_delay;
+	double drift;
+	int lock_count;
+
+	/* Master */
+	uint16_t announce_sequence_id;
+	uint16_t sync_tx_sequence_id;
+};
+
+void usage(char *prog)
+{
+	printf("usage: %s [-i IFACE] [-2] [-m [-s]] [-d DOMAIN] [-u UTC_OFFSET] [-a ADDR] [-f CLOCK_HZ] [-v]\n", prog);
+	printf("\n");
+	printf("  -i IFACE       network interface (default eth0)\n");
+	printf("  -2             IEEE 802.3 transport instead of UDP/IPv4\n");
+	printf("  -m             master mode\n");
+	printf("  -s             send one-step Sync in master mode\n");
+	printf("  -d DOMAIN      domainNumber (default 0)\n");
+	printf("  -u UTC_OFFSET  currentUtcOffset announced in master mode (default %d)\n", DEFAULT_UTC_OFFSET);
+	printf("  -a ADDR        address of the time base registers (default 0x%08x)\n", TIME_BASE_DEFAULT_ADDRESS);
+	printf("  -f CLOCK_HZ    frequency of the time base clock (default %d)\n", TIME_BASE_DEFAULT_CLOCK_HZ);
+	printf("  -v             print every sample\n");
+}
+
+static uint16_t get16(const uint8_t *p)
+{
+	return (p[0] << 8) | p[1];
+}
+
+static void put16(uint8_t *p, uint16_t value)
+{
+	p[0] = value >> 8;
+	p[1] = value;
+}
+
+static uint64_t get_be(const uint8_t *p, int bytes)
+{
+	uint64_t value = 0;
+	while (bytes--)
+		value = (value << 8) | *p++;
+	return value;
+}
+
+static void put_be(uint8_t *p, uint64_t value, int bytes)
+{
+	while (bytes--) {
+		p[bytes] = value;
+		value >>= 8;
+	}
+}
+
+/* Timestamp (48bit seconds and 32bit nanoseconds) to nanoseconds. */
+static int64_t get_timestamp(const uint8_t *p)
+{
+	return (int64_t)get_be(p, 6) * NANOSECONDS_PER_SECOND + get_be(p + 6, 4);
+}
+
+static void put_timestamp(uint8_t *p, int64_t time)
+{
+	put_be(p, time / NANOSECONDS_PER_SECOND, 6);
+	put_be(p + 6, time % NANOSECONDS_PER_SECOND, 4);
+}
+
+/* correctionField in nanoseconds. The fractional nanoseconds are dropped. */
+static int64_t get_correction(const uint8_t *header)
+{
+	return (int64_t)get_be(header + 8, 8) >> 16;
+}
+
+static void get_port_identity(const uint8_t *p, struct port_identity *identity)
+{
+	memcpy(identity->clock_identity, p, 8);
+	identity->port_number = get16(p + 8);
+}
+
+static void put_port_identity(uint8_t *p, const struct port_identity *identity)
+{
+	memcpy(p, identity->clock_identity, 8);
+	put16(p + 8, identity->port_number);
+}
+
+static int same_port_identity(const struct port_identity *a, const struct port_identity *b)
+{
+	return memcmp(a->clock_identity, b->clock_identity, 8) == 0 && a->port_number == b->port_number;
+}
+
+static void build_header(struct clock *c, uint8_t *buffer, int message_type, int length, uint16_t flags, int64_t correction, uint16_t sequence_id, int control, int log_message_interval)
+{
+	memset(buffer, 0, length);
+	buffer[0] = message_type;
+	buffer[1] = 2;
+	put16(buffer + 2, length);
+	buffer[4] = c->domain_number;
+	put16(buffer + 6, flags);
+	put_be(buffer + 8, (uint64_t)correction << 16, 8);
+	put_port_identity(buffer + 20, &c->identity);
+	put16(buffer + 30, sequence_id);
+	buffer[32] = control;
+	buffer[33] = log_message_interval;
+}
+
+static int open_transport(struct transport *t, const char *ifname, int l2, struct port_identity *identity)
+{
+	struct ifreq ifr;
+	uint8_t *mac;
+	int fd;
+
+	memset(t, 0, sizeof(*t));
+	t->l2 = l2;
+	t->ifindex = if_nametoindex(ifname);
+	if (t->ifindex == 0)
+		return -1;
+
+	/* clockIdentity is EUI-64 from the MAC address. */
+	fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd < 0)
+		return -1;
+	memset(&ifr, 0, sizeof(ifr));
+	strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+	if (ioctl(fd, SIOCGIFHWADDR, &ifr) < 0) {
+		close(fd);
+		return -1;
+	}
+	mac = (uint8_t *)ifr.ifr_hwaddr.sa_data;
+	identity->clock_identity[0] = mac[0];
+	identity->clock_identity[1] = mac[1];
+	identity->clock_identity[2] = mac[2];
+	identity->clock_identity[3] = 0xff;
+	identity->clock_identity[4] = 0xfe;
+	identity->clock_identity[5] = mac[3];
+	identity->clock_identity[6] = mac[4];
+	identity->clock_identity[7] = mac[5];
+	identity->port_number = 1;
+
+	if (l2) {
+		struct sockaddr_ll address;
+		struct packet_mreq mreq;
+
+		close(fd);
+		fd = socket(AF_PACKET, SOCK_DGRAM, htons(ETH_P_1588));
+		if (fd < 0)
+			return -1;
+		memset(&address, 0, sizeof(address));
+		address.sll_family = AF_PACKET;
+		address.sll_protocol = htons(ETH_P_1588);
+		address.sll_ifindex = t->ifindex;
+		if (bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0)
+			return -1;
+		memset(&mreq, 0, sizeof(mreq));
+		mreq.mr_ifindex = t->ifindex;
+		mreq.mr_type = PACKET_MR_MULTICAST;
+		mreq.mr_alen = ETH_ALEN;
+		memcpy(mreq.mr_address, ptp_primary_mac, ETH_ALEN);
+		if (setsockopt(fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0)
+			return -1;
+		t->event_fd = fd;
+		t->general_fd = fd;
+	}
+	else {
+		struct ip_mreqn mreq;
+		struct in_addr interface_address;
+		int ports[2] = {PTP_EVENT_PORT, PTP_GENERAL_PORT};
+		int fds[2];
+		int i;
+
+		if (ioctl(fd, SIOCGIFADDR, &ifr) < 0) {
+			close(fd);
+			return -1;
+		}
+		interface_address = ((struct sockaddr_in *)&ifr.ifr_addr)->sin_addr;
+		close(fd);
+
+		for (i = 0; i < 2; i++) {
+			struct sockaddr_in address;
+			int off = 0;
+			int on = 1;
+
+			fds[i] = socket(AF_INET, SOCK_DGRAM, 0);
+			if (fds[i] < 0)
+				return -1;
+			setsockopt(fds[i], SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+			if (setsockopt(fds[i], SOL_SOCKET, SO_BINDTODEVICE, ifname, strlen(ifname)) < 0)
+				return -1;
+			memset(&address, 0, sizeof(address));
+			address.sin_family = AF_INET;
+			address.sin_addr.s_addr = htonl(INADDR_ANY);
+			address.sin_port = htons(ports[i]);
+			if (bind(fds[i], (struct sockaddr *)&address, sizeof(address)) < 0)
+				return -1;
+			memset(&mreq, 0, sizeof(mreq));
+			inet_pton(AF_INET, PTP_PRIMARY_IPV4, &mreq.imr_multiaddr);
+			mreq.imr_address = interface_address;
+			mreq.imr_ifindex = t->ifindex;
+			if (setsockopt(fds[i], IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0)
+				return -1;
+			if (setsockopt(fds[i], IPPROTO_IP, IP_MULTICAST_IF, &mreq, sizeof(mreq)) < 0)
+				return -1;
+			setsockopt(fds[i], IPPROTO_IP, IP_MULTICAST_LOOP, &off, sizeof(off));
+		}
+		t->event_fd = fds[0];
+		t->general_fd = fds[1];
+		t->event_address.sin_family = AF_INET;
+		t->event_address.sin_port = htons(PTP_EVENT_PORT);
+		inet_pton(AF_INET, PTP_PRIMARY_IPV4, &t->event_address.sin_addr);
+		t->general_address = t->event_address;
+		t->general_address.sin_port = htons(PTP_GENERAL_PORT);
+	}
+	return 0;
+}
+
+static int send_message(struct transport *t, int event, const uint8_t *buffer, int length)
+{
+	int sent;
+
+	if (t->l2) {
+		struct sockaddr_ll address;
+
+		memset(&address, 0, sizeof(address));
+		address.sll_family = AF_PACKET;
+		address.sll_protocol = htons(ETH_P_1588);
+		address.sll_ifindex = t->ifindex;
+		address.sll_halen = ETH_ALEN;
+		memcpy(address.sll_addr, ptp_primary_mac, ETH_ALEN);
+		sent = sendto(t->event_fd, buffer, length, 0, (struct sockaddr *)&address, sizeof(address));
+	}
+	else if (event) {
+		sent = sendto(t->event_fd, buffer, length, 0, (struct sockaddr *)&t->event_address, sizeof(t->event_address));
+	}
+	else {
+		sent = sendto(t->general_fd, buffer, length, 0, (struct sockaddr *)&t->general_address, sizeof(t->general_address));
+	}
+	if (sent < 0)
+		perror("sendto");
+	return sent;
+}
+
+/* Wait for the PL timestamp of the event message. Older events in the queue are discarded. */
+static int wait_event(struct clock *c, int tx, int message_type, uint16_t sequence_id, int64_t *time)
+{
+	struct time_base_event event;
+	int elapsed;
+
+	for (elapsed = 0; elapsed < EVENT_TIMEOUT_MS; elapsed++) {
+		while (time_base_pop_event(&c->tb, tx, &event)) {
+			if (event.message_type == message_type && event.sequence_id == sequence_id && event.domain_number == c->domain_number) {
+				*time = event.time;
+				return 0;
+			}
+		}
+		usleep(1000);
+	}
+	fprintf(stderr, "%s timestamp of messageType %d sequenceId %d is not found\n", tx ? "TX" : "RX", message_type, sequence_id);
+	return -1;
+}
+
+/* Offset of the time base to the PTP time, which is ahead of UTC by currentUtcOffset. */
+static int64_t utc_offset_ns(struct clock *c)
+{
+	return (int64_t)c->utc_offset * NANOSECONDS_PER_SECOND;
+}
+
+static void update_servo(struct clock *c, int64_t offset)
+{
+	double frequency;
+
+	if (offset > STEP_THRESHOLD_NS || offset < -STEP_THRESHOLD_NS) {
+		time_base_adjust(&c->tb, -offset);
+		time_base_set_locked(&c->tb, 0);
+		c->lock_count = 0;
+		printf("master offset %lld[ns] step\n", (long long)offset);
+		fflush(stdout);
+		return;
+	}
+
+	/* PI servo with the Sync interval of 1[s]. */
+	c->drift -= KI * offset;
+	if (c->drift > MAX_FREQUENCY_PPB) c->drift = MAX_FREQUENCY_PPB;
+	if (c->drift < -MAX_FREQUENCY_PPB) c->drift = -MAX_FREQUENCY_PPB;
+	frequency = c->drift - KP * offset;
+	if (frequency > MAX_FREQUENCY_PPB) frequency = MAX_FREQUENCY_PPB;
+	if (frequency < -MAX_FREQUENCY_PPB) frequency = -MAX_FREQUENCY_PPB;
+	time_base_set_frequency(&c->tb, frequency);
+
+	if (offset <= LOCK_THRESHOLD_NS && offset >= -LOCK_THRESHOLD_NS) {
+		if (c->lock_count < LOCK_COUNT && ++c->lock_count == LOCK_COUNT)
+			time_base_set_locked(&c->tb, 1);
+	}
+	else if (offset > UNLOCK_THRESHOLD_NS || offset < -UNLOCK_THRESHOLD_NS) {
+		c->lock_count = 0;
+		if (c->tb.locked)
+			time_base_set_locked(&c->tb, 0);
+	}
+	if (c->verbose) {
+		printf("master offset %9lld[ns] freq %+10.3f[ppb] path delay %9lld[ns] %s\n", (long long)offset, frequency, (long long)c->path_delay, c->tb.locked ? "locked" : "");
+		fflush(stdout);
+	}
+}
+
+static void send_delay_req(struct clock *c)
+{
+	uint8_t buffer[DELAY_REQ_SIZE];
+
+	c->delay_req_sequence_id++;
+	build_header(c, buffer, DELAY_REQ, DELAY_REQ_SIZE, 0, 0, c->delay_req_sequence_id, 1, 0x7f);
+	if (send_message(&c->transport, 1, buffer, DELAY_REQ_SIZE) < 0)
+		return;
+	if (wait_event(c, 1, DELAY_REQ, c->delay_req_sequence_id, &c->t3) < 0)
+		return;
+	c->waiting_delay_resp = 1;
+}
+
+/* t1 and t2 of a Sync are complete. */
+static void sync_completed(struct clock *c)
+{
+	int64_t offset;
+
+	if (c->path_delay == 0) {
+		/* No delay measurement yet. */
+		send_delay_req(c);
+		return;
+	}
+	offset = c->t2 - c->t1 - c->path_delay;
+	update_servo(c, offset);
+	send_delay_req(c);
+}
+
+static void slave_receive(struct clock *c, const uint8_t *buffer, int length)
+{
+	struct port_identity source;
+	int message_type;
+	int64_t t4;
+
+	if (length < HEADER_SIZE || (buffer[1] & 0xf) != 2 || buffer[4] != c->domain_number)
+		return;
+	message_type = buffer[0] & 0xf;
+	get_port_identity(buffer + 20, &source);
+
+	if (message_type == ANNOUNCE && length >= ANNOUNCE_SIZE) {
+		if (!c->has_master || time(NULL) - c->last_announce > MASTER_TIMEOUT_S) {
+			c->master = source;
+			c->has_master = 1;
+			c->path_delay = 0;
+			printf("new master %02x%02x%02x.%02x%02x.%02x%02x%02x-%d\n",
+				source.clock_identity[0], source.clock_identity[1], source.clock_identity[2], source.clock_identity[3],
+				source.clock_identity[4], source.clock_identity[5], source.clock_identity[6], source.clock_identity[7], source.port_number);
+		}
+		if (same_port_identity(&source, &c->master)) {
+			c->last_announce = time(NULL);
+			/* currentUtcOffset is valid with the PTP timescale. */
+			c->utc_offset = (get16(buffer + 6) & FLAG_PTP_TIMESCALE) ? (int16_t)get16(buffer + 44) : 0;
+		}
+		return;
+	}
+	if (!c->has_master || !same_port_identity(&source, &c->master))
+		return;
+
+	switch (message_type) {
+	case SYNC:
+		if (length < SYNC_SIZE)
+			return;
+		c->sync_sequence_id = get16(buffer + 30);
+		if (wait_event(c, 0, SYNC, c->sync_sequence_id, &c->t2) < 0)
+			return;
+		c->t2 += utc_offset_ns(c);
+		c->sync_correction = get_correction(buffer);
+		if (get16(buffer + 6) & FLAG_TWO_STEP) {
+			c->waiting_follow_up = 1;
+		}
+		else {
+			c->waiting_follow_up = 0;
+			c->t1 = get_timestamp(buffer + 34) + c->sync_correction;
+			sync_completed(c);
+		}
+		break;
+	case FOLLOW_UP:
+		if (length < FOLLOW_UP_SIZE || !c->waiting_follow_up || get16(buffer + 30) != c->sync_sequence_id)
+			return;
+		c->waiting_follow_up = 0;
+		c->t1 = get_timestamp(buffer + 34) + c->sync_correction + get_correction(buffer);
+		sync_completed(c);
+		break;
+	case DELAY_RESP: {
+		struct port_identity requesting;
+
+		if (length < DELAY_RESP_SIZE || !c->waiting_delay_resp || get16(buffer + 30) != c->delay_req_sequence_id)
+			return;
+		get_port_identity(buffer + 44, &requesting);
+		if (!same_port_identity(&requesting, &c->identity))
+			return;
+		c->waiting_delay_resp = 0;
+		t4 = get_timestamp(buffer + 34) - get_correction(buffer);
+		c->path_delay = ((c->t2 - c->t1) + (t4 - (c->t3 + utc_offset_ns(c)))) / 2;
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+static void master_send_announce(struct clock *c)
+{
+	uint8_t buffer[ANNOUNCE_SIZE];
+
+	build_header(c, buffer, ANNOUNCE, ANNOUNCE_SIZE, FLAG_PTP_TIMESCALE, 0, c->announce_sequence_id++, 5, 1);
+	put16(buffer + 44, c->utc_offset);
+	buffer[47] = 128;			/* grandmasterPriority1 */
+	buffer[48] = c->tb.locked ? 6 : 248;	/* clockClass */
+	buffer[49] = 0xfe;			/* clockAccuracy: unknown */
+	put16(buffer + 50, 0xffff);		/* offsetScaledLogVariance */
+	buffer[52] = 128;			/* grandmasterPriority2 */
+	memcpy(buffer + 53, c->identity.clock_identity, 8);
+	put16(buffer + 61, 0);			/* stepsRemoved */
+	buffer[63] = 0xa0;			/* timeSource: internal oscillator */
+	send_message(&c->transport, 0, buffer, ANNOUNCE_SIZE);
+}
+
+static void master_send_sync(struct clock *c, int one_step)
+{
+	uint8_t buffer[SYNC_SIZE];
+	uint16_t sequence_id = c->sync_tx_sequence_id++;
+	int64_t t1;
+
+	if (one_step) {
+		/*
+		* The PL MAC adds the time from originTimestamp to the SFD into correctionField.
+		* originTimestamp is in the time base (UTC), so the UTC offset is put into correctionField.
+		*/
+		build_header(c, buffer, SYNC, SYNC_SIZE, 0, utc_offset_ns(c), sequence_id, 0, 0);
+		put_timestamp(buffer + 34, time_base_get(&c->tb));
+		send_message(&c->transport, 1, buffer, SYNC_SIZE);
+		wait_event(c, 1, SYNC, sequence_id, &t1);
+		return;
+	}
+
+	build_header(c, buffer, SYNC, SYNC_SIZE, FLAG_TWO_STEP, 0, sequence_id, 0, 0);
+	if (send_message(&c->transport, 1, buffer, SYNC_SIZE) < 0)
+		return;
+	if (wait_event(c, 1, SYNC, sequence_id, &t1) < 0)
+		return;
+	build_header(c, buffer, FOLLOW_UP, FOLLOW_UP_SIZE, 0, 0, sequence_id, 2, 0);
+	put_timestamp(buffer + 34, t1 + utc_offset_ns(c));
+	send_message(&c->transport, 0, buffer, FOLLOW_UP_SIZE);
+}
+
+static void master_receive(struct clock *c, const uint8_t *buffer, int length)
+{
+	uint8_t response[DELAY_RESP_SIZE];
+	uint16_t sequence_id;
+	int64_t t4;
+
+	if (length < DELAY_REQ_SIZE || (buffer[1] & 0xf) != 2 || buffer[4] != c->domain_number || (buffer[0] & 0xf) != DELAY_REQ)
+		return;
+	sequence_id = get16(buffer + 30);
+	if (wait_event(c, 0, DELAY_REQ, sequence_id, &t4) < 0)
+		return;
+	build_header(c, response, DELAY_RESP, DELAY_RESP_SIZE, 0, get_correction(buffer), sequence_id, 3, 0);
+	put_timestamp(response + 34, t4 + utc_offset_ns(c));
+	memcpy(response + 44, buffer + 20, 10);	/* requestingPortIdentity */
+	send_message(&c->transport, 0, response, DELAY_RESP_SIZE);
+}
+
+int main(int argc, char *argv[])
+{
+	static struct clock c;
+	const char *ifname = "eth0";
+	unsigned long address = TIME_BASE_DEFAULT_ADDRESS;
+	unsigned long clock_hz = TIME_BASE_DEFAULT_CLOCK_HZ;
+	int l2 = 0;
+	int master = 0;
+	int one_step = 0;
+	int opt;
+	struct timespec next;
+
+	c.utc_offset = DEFAULT_UTC_OFFSET;
+	while ((opt = getopt(argc, argv, "i:2msd:u:a:f:vh")) != -1) {
+		switch (opt) {
+		case 'i':
+			ifname = optarg;
+			break;
+		case '2':
+			l2 = 1;
+			break;
+		case 'm':
+			master = 1;
+			break;
+		case 's':
+			one_step = 1;
+			break;
+		case 'd':
+			c.domain_number = strtoul(optarg, NULL, 0);
+			break;
+		case 'u':
+			c.utc_offset = strtol(optarg, NULL, 0);
+			break;
+		case 'a':
+			address = strtoul(optarg, NULL, 0);
+			break;
+		case 'f':
+			clock_hz = strtoul(optarg, NULL, 0);
+			break;
+		case 'v':
+			c.verbose = 1;
+			break;
+		default:
+			usage(argv[0]);
+			exit(-1);
+		}
+	}
+
+	if (time_base_open(&c.tb, address, clock_hz) < 0) {
+		perror("time base");
+		exit(-1);
+	}
+	if (open_transport(&c.transport, ifname, l2, &c.identity) < 0) {
+		perror(ifname);
+		exit(-1);
+	}
+	time_base_set_one_step(&c.tb, master && one_step);
+	if (!master) {
+		time_base_set_locked(&c.tb, 0);
+		c.drift = time_base_get_frequency(&c.tb);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &next);
+
+	for (;;) {
+		struct pollfd fds[2];
+		struct timespec now;
+		uint8_t buffer[1500];
+		int timeout;
+		int nfds = c.transport.l2 ? 1 : 2;
+		int i;
+
+		if (master) {
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			if (now.tv_sec > next.tv_sec || (now.tv_sec == next.tv_sec && now.tv_nsec >= next.tv_nsec)) {
+				master_send_announce(&c);
+				master_send_sync(&c, one_step);
+				next.tv_sec++;
+			}
+			timeout = (next.tv_sec - now.tv_sec) * 1000 + (next.tv_nsec - now.tv_nsec) / 1000000;
+			if (timeout < 0)
+				timeout = 0;
+		}
+		else {
+			timeout = 1000;
+		}
+
+		fds[0].fd = c.transport.event_fd;
+		fds[0].events = POLLIN;
+		fds[1].fd = c.transport.general_fd;
+		fds[1].events = POLLIN;
+		if (poll(fds, nfds, timeout) < 0) {
+			if (errno == EINTR)
+				continue;
+			perror("poll");
+			exit(-1);
+		}
+		for (i = 0; i < nfds; i++) {
+			int length;
+
+			if (!(fds[i].revents & POLLIN))
+				continue;
+			length = recv(fds[i].fd, buffer, sizeof(buffer), 0);
+			if (length < 0)
+				continue;
+			if (master)
+				master_receive(&c, buffer, length);
+			else
+				slave_receive(&c, buffer, length);
+		}
+	}
+	return 0;
+}
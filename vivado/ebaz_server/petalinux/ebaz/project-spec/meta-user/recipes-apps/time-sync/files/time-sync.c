@@ -0,0 +1,171 @@
+/*
+* time-sync - discipline loop of the PL time base
+*
+* Steers the rate and the phase of the PL time base, which timestamps the frames in the MAC,
+* to a reference with a PI servo and reports the lock state to the PL.
+*
+* Reference:
+*   default        CLOCK_REALTIME (e.g. disciplined by NTP or by phc2sys from a PTP hardware clock)
+*   -c DEVICE      PTP hardware clock such as /dev/ptp0 (e.g. disciplined by ptp4l)
+*   -p             PPS input of the time base. The seconds are taken from CLOCK_REALTIME.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <errno.h>
+
+#include "time_base.h"
+
+#define CLOCKFD 3
+#define FD_TO_CLOCKID(fd)	((~(clockid_t) (fd) << 3) | CLOCKFD)
+
+#define STEP_THRESHOLD_NS	1000000		/* Step the time when the offset exceeds 1[ms]. */
+#define LOCK_THRESHOLD_NS	1000		/* Locked while the offset is within 1[us] ... */
+#define LOCK_COUNT		4		/* ... for this number of consecutive samples. */
+#define UNLOCK_THRESHOLD_NS	10000
+#define MAX_FREQUENCY_PPB	500000.0
+
+#define KP	0.7
+#define KI	0.3
+
+void usage(char *prog)
+{
+	printf("usage: %s [-a ADDR] [-f CLOCK_HZ] [-c DEVICE | -p] [-v]\n", prog);
+	printf("\n");
+	printf("  -a ADDR      address of the time base registers (default 0x%08x)\n", TIME_BASE_DEFAULT_ADDRESS);
+	printf("  -f CLOCK_HZ  frequency of the time base clock (default %d)\n", TIME_BASE_DEFAULT_CLOCK_HZ);
+	printf("  -c DEVICE    synchronize to the PTP hardware clock DEVICE instead of CLOCK_REALTIME\n");
+	printf("  -p           synchronize to the PPS input of the time base\n");
+	printf("  -v           print the offset of every sample\n");
+}
+
+static int64_t to_nanoseconds(const struct timespec *ts)
+{
+	return (int64_t)ts->tv_sec * NANOSECONDS_PER_SECOND + ts->tv_nsec;
+}
+
+/* Offset of the time base from the reference clock. The time base is sampled between two readings of the reference. */
+static int64_t measure_clock_offset(struct time_base *tb, clockid_t clock, int64_t *reference)
+{
+	struct timespec before, after;
+	int64_t time;
+
+	clock_gettime(clock, &before);
+	time = time_base_get(tb);
+	clock_gettime(clock, &after);
+	*reference = (to_nanoseconds(&before) + to_nanoseconds(&after)) / 2;
+	return time - *reference;
+}
+
+/* Offset of the time base at the PPS edge from the second boundary. Blocks until the next edge. */
+static int64_t measure_pps_offset(struct time_base *tb, int64_t *reference)
+{
+	struct timespec now;
+	int64_t time;
+	int64_t second;
+
+	while ((time = time_base_get_pps(tb)) < 0)
+		usleep(10000);
+
+	/* The edge is the beginning of the second nearest to the system time. */
+	clock_gettime(CLOCK_REALTIME, &now);
+	second = (to_nanoseconds(&now) + NANOSECONDS_PER_SECOND / 2) / NANOSECONDS_PER_SECOND;
+	*reference = second * NANOSECONDS_PER_SECOND;
+	return time - *reference;
+}
+
+int main(int argc, char *argv[])
+{
+	struct time_base tb;
+	unsigned long address = TIME_BASE_DEFAULT_ADDRESS;
+	unsigned long clock_hz = TIME_BASE_DEFAULT_CLOCK_HZ;
+	clockid_t clock = CLOCK_REALTIME;
+	int use_pps = 0;
+	int verbose = 0;
+	int opt;
+	double drift;
+	int lock_count = 0;
+
+	while ((opt = getopt(argc, argv, "a:f:c:pvh")) != -1) {
+		switch (opt) {
+		case 'a':
+			address = strtoul(optarg, NULL, 0);
+			break;
+		case 'f':
+			clock_hz = strtoul(optarg, NULL, 0);
+			break;
+		case 'c': {
+			int fd = open(optarg, O_RDWR);
+			if (fd < 0) {
+				perror(optarg);
+				exit(-1);
+			}
+			clock = FD_TO_CLOCKID(fd);
+			break;
+		}
+		case 'p':
+			use_pps = 1;
+			break;
+		case 'v':
+			verbose = 1;
+			break;
+		default:
+			usage(argv[0]);
+			exit(-1);
+		}
+	}
+
+	if (time_base_open(&tb, address, clock_hz) < 0) {
+		perror(argv[0]);
+		exit(-1);
+	}
+	time_base_set_locked(&tb, 0);
+	drift = time_base_get_frequency(&tb);
+	if (use_pps)
+		time_base_get_pps(&tb);	/* Discard the edge captured before starting. */
+
+	for (;;) {
+		int64_t reference;
+		int64_t offset = use_pps ? measure_pps_offset(&tb, &reference) : measure_clock_offset(&tb, clock, &reference);
+		double frequency;
+
+		if (offset > STEP_THRESHOLD_NS || offset < -STEP_THRESHOLD_NS) {
+			time_base_adjust(&tb, -offset);
+			time_base_set_locked(&tb, 0);
+			lock_count = 0;
+			if (verbose)
+				printf("step %lld[ns]\n", (long long)-offset);
+		}
+		else {
+			/* PI servo with the sample interval of 1[s]. Positive offset means the time base is ahead. */
+			drift -= KI * offset;
+			if (drift > MAX_FREQUENCY_PPB) drift = MAX_FREQUENCY_PPB;
+			if (drift < -MAX_FREQUENCY_PPB) drift = -MAX_FREQUENCY_PPB;
+			frequency = drift - KP * offset;
+			if (frequency > MAX_FREQUENCY_PPB) frequency = MAX_FREQUENCY_PPB;
+			if (frequency < -MAX_FREQUENCY_PPB) frequency = -MAX_FREQUENCY_PPB;
+			time_base_set_frequency(&tb, frequency);
+
+			if (offset <= LOCK_THRESHOLD_NS && offset >= -LOCK_THRESHOLD_NS) {
+				if (lock_count < LOCK_COUNT && ++lock_count == LOCK_COUNT)
+					time_base_set_locked(&tb, 1);
+			}
+			else if (offset > UNLOCK_THRESHOLD_NS || offset < -UNLOCK_THRESHOLD_NS) {
+				lock_count = 0;
+				if (tb.locked)
+					time_base_set_locked(&tb, 0);
+			}
+			if (verbose)
+				printf("offset %9lld[ns] frequency %+10.3f[ppb] %s\n", (long long)offset, frequency, tb.locked ? "locked" : "");
+		}
+		fflush(stdout);
+
+		if (!use_pps)
+			sleep(1);
+	}
+	return 0;
+}
@@ -0,0 +1,196 @@
+/*
+* Access to the PL time base (time_base IP) through /dev/mem.
+*/
+
+#ifndef TIME_BASE_H
+#define TIME_BASE_H
+
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#define TIME_BASE_DEFAULT_ADDRESS	0x43c00000
+#define TIME_BASE_DEFAULT_CLOCK_HZ	25000000
+
+#define TIME_BASE_CONTROL		0x00
+#define TIME_BASE_STATUS		0x04
+#define TIME_BASE_SECONDS_HI		0x08
+#define TIME_BASE_SECONDS_LO		0x0c
+#define TIME_BASE_NANOSECONDS		0x10
+#define TIME_BASE_INCREMENT		0x14
+#define TIME_BASE_ADJUST_NANOSECONDS	0x18
+#define TIME_BASE_PPS_SECONDS_HI	0x1c
+#define TIME_BASE_PPS_SECONDS_LO	0x20
+#define TIME_BASE_PPS_NANOSECONDS	0x24
+#define TIME_BASE_PTP_CONTROL		0x28
+#define TIME_BASE_EVENT_STATUS		0x2c
+#define TIME_BASE_RX_EVENT		0x30
+#define TIME_BASE_TX_EVENT		0x40
+
+#define TIME_BASE_CONTROL_SET		0x1
+#define TIME_BASE_CONTROL_SNAPSHOT	0x2
+#define TIME_BASE_CONTROL_ADJUST	0x4
+
+#define TIME_BASE_STATUS_LOCKED		0x1
+#define TIME_BASE_STATUS_PPS_CAPTURED	0x2
+
+#define TIME_BASE_PTP_CONTROL_ONE_STEP	0x1
+
+#define TIME_BASE_EVENT_RX_VALID	0x1
+#define TIME_BASE_EVENT_TX_VALID	0x2
+#define TIME_BASE_EVENT_RX_OVERFLOW	0x4
+#define TIME_BASE_EVENT_TX_OVERFLOW	0x8
+
+#define TIME_BASE_TRANSPORT_L2		1
+#define TIME_BASE_TRANSPORT_UDPV4	2
+#define TIME_BASE_TRANSPORT_UDPV6	3
+
+#define TIME_BASE_FRACTION_BITS		24
+#define NANOSECONDS_PER_SECOND		1000000000LL
+
+struct time_base {
+	int fd;
+	volatile uint32_t *regs;
+	uint32_t nominal_increment;
+	int locked;
+};
+
+/* SFD timestamp of a PTP event message received or transmitted by the MAC. */
+struct time_base_event {
+	int64_t time;
+	uint16_t sequence_id;
+	uint8_t domain_number;
+	uint8_t message_type;
+	uint8_t transport;
+	uint8_t one_step;	/* correctionField was updated by the one-step Sync. */
+};
+
+static inline uint32_t time_base_read(struct time_base *tb, unsigned offset)
+{
+	return tb->regs[offset / 4];
+}
+
+static inline void time_base_write(struct time_base *tb, unsigned offset, uint32_t value)
+{
+	tb->regs[offset / 4] = value;
+}
+
+static inline int time_base_open(struct time_base *tb, unsigned long address, unsigned long clock_hz)
+{
+	unsigned page_size = sysconf(_SC_PAGESIZE);
+	void *ptr;
+
+	tb->fd = open("/dev/mem", O_RDWR | O_SYNC);
+	if (tb->fd < 0)
+		return -1;
+	ptr = mmap(NULL, page_size, PROT_READ | PROT_WRITE, MAP_SHARED, tb->fd, address & ~(page_size - 1));
+	if (ptr == MAP_FAILED) {
+		close(tb->fd);
+		return -1;
+	}
+	tb->regs = (volatile uint32_t *)((char *)ptr + (address & (page_size - 1)));
+	tb->nominal_increment = (uint32_t)((NANOSECONDS_PER_SECOND << TIME_BASE_FRACTION_BITS) / clock_hz);
+	tb->locked = time_base_read(tb, TIME_BASE_STATUS) & TIME_BASE_STATUS_LOCKED;
+	return 0;
+}
+
+static inline int64_t time_base_to_nanoseconds(uint64_t seconds, uint32_t nanoseconds)
+{
+	return (int64_t)seconds * NANOSECONDS_PER_SECOND + nanoseconds;
+}
+
+/* Time of the time base in nanoseconds. */
+static inline int64_t time_base_get(struct time_base *tb)
+{
+	uint64_t seconds;
+
+	time_base_write(tb, TIME_BASE_CONTROL, TIME_BASE_CONTROL_SNAPSHOT);
+	seconds = (uint64_t)(time_base_read(tb, TIME_BASE_SECONDS_HI) & 0xffff) << 32;
+	seconds |= time_base_read(tb, TIME_BASE_SECONDS_LO);
+	return time_base_to_nanoseconds(seconds, time_base_read(tb, TIME_BASE_NANOSECONDS));
+}
+
+static inline void time_base_set(struct time_base *tb, int64_t time)
+{
+	uint64_t seconds = time / NANOSECONDS_PER_SECOND;
+
+	time_base_write(tb, TIME_BASE_SECONDS_HI, seconds >> 32);
+	time_base_write(tb, TIME_BASE_SECONDS_LO, (uint32_t)seconds);
+	time_base_write(tb, TIME_BASE_NANOSECONDS, time % NANOSECONDS_PER_SECOND);
+	time_base_write(tb, TIME_BASE_CONTROL, TIME_BASE_CONTROL_SET);
+}
+
+/* Step the time base by delta nanoseconds. */
+static inline void time_base_adjust(struct time_base *tb, int64_t delta)
+{
+	if (delta >= NANOSECONDS_PER_SECOND || delta <= -NANOSECONDS_PER_SECOND) {
+		time_base_set(tb, time_base_get(tb) + delta);
+		return;
+	}
+	time_base_write(tb, TIME_BASE_ADJUST_NANOSECONDS, (uint32_t)(int32_t)delta);
+	time_base_write(tb, TIME_BASE_CONTROL, TIME_BASE_CONTROL_ADJUST);
+}
+
+/* Run the time base faster by ppb parts per billion. */
+static inline void time_base_set_frequency(struct time_base *tb, double ppb)
+{
+	double increment = tb->nominal_increment * (1.0 + ppb * 1e-9);
+	time_base_write(tb, TIME_BASE_INCREMENT, (uint32_t)(increment + 0.5));
+}
+
+static inline double time_base_get_frequency(struct time_base *tb)
+{
+	uint32_t increment = time_base_read(tb, TIME_BASE_INCREMENT);
+	return ((double)increment / tb->nominal_increment - 1.0) * 1e9;
+}
+
+static inline void time_base_set_locked(struct time_base *tb, int locked)
+{
+	tb->locked = locked ? 1 : 0;
+	time_base_write(tb, TIME_BASE_STATUS, tb->locked ? TIME_BASE_STATUS_LOCKED : 0);
+}
+
+/* Time of the last PPS edge in nanoseconds, or -1 if no edge has been captured since the last call. */
+static inline int64_t time_base_get_pps(struct time_base *tb)
+{
+	uint64_t seconds;
+	uint32_t nanoseconds;
+
+	if (!(time_base_read(tb, TIME_BASE_STATUS) & TIME_BASE_STATUS_PPS_CAPTURED))
+		return -1;
+	seconds = (uint64_t)(time_base_read(tb, TIME_BASE_PPS_SECONDS_HI) & 0xffff) << 32;
+	seconds |= time_base_read(tb, TIME_BASE_PPS_SECONDS_LO);
+	nanoseconds = time_base_read(tb, TIME_BASE_PPS_NANOSECONDS);
+	time_base_write(tb, TIME_BASE_STATUS, TIME_BASE_STATUS_PPS_CAPTURED | (tb->locked ? TIME_BASE_STATUS_LOCKED : 0));
+	return time_base_to_nanoseconds(seconds, nanoseconds);
+}
+
+static inline void time_base_set_one_step(struct time_base *tb, int enable)
+{
+	time_base_write(tb, TIME_BASE_PTP_CONTROL, enable ? TIME_BASE_PTP_CONTROL_ONE_STEP : 0);
+}
+
+/* Pop the oldest event from the RX (tx = 0) or TX (tx = 1) queue. Returns 0 if the queue is empty. */
+static inline int time_base_pop_event(struct time_base *tb, int tx, struct time_base_event *event)
+{
+	unsigned base = tx ? TIME_BASE_TX_EVENT : TIME_BASE_RX_EVENT;
+	uint32_t words[4];
+	int i;
+
+	if (!(time_base_read(tb, TIME_BASE_EVENT_STATUS) & (tx ? TIME_BASE_EVENT_TX_VALID : TIME_BASE_EVENT_RX_VALID)))
+		return 0;
+	for (i = 0; i < 4; i++)
+		words[i] = time_base_read(tb, base + 4 * i);
+	time_base_write(tb, TIME_BASE_EVENT_STATUS, tx ? TIME_BASE_EVENT_TX_VALID : TIME_BASE_EVENT_RX_VALID);
+
+	event->time = time_base_to_nanoseconds(((uint64_t)(words[2] & 0xffff) << 32) | words[1], words[0]);
+	event->sequence_id = words[2] >> 16;
+	event->domain_number = words[3] & 0xff;
+	event->message_type = (words[3] >> 8) & 0xf;
+	event->transport = (words[3] >> 12) & 0x3;
+	event->one_step = (words[3] >> 14) & 0x1;
+	return 1;
+}
+
+#endif
@@ -14,6 +14,10 @@ set_property PART $part [current_project]
 lappend ip_repo_path_list [file normalize ../../mii_mac]
 lappend ip_repo_path_list [file normalize ../../mii_axis]
 lappend ip_repo_path_list [file normalize ../../ethernet_service]
+lappend ip_repo_path_list [file normalize ../../time_base]
+lappend ip_repo_path_list [file normalize ../../axis_async_fifo]
+lappend ip_repo_path_list [file normalize ../../frame_dma]
+lappend ip_repo_path_list [file normalize ../../packet_capture]
 set_property ip_repo_paths $ip_repo_path_list [get_filesets sources_1]
 update_ip_catalog
 